@@ -8,11 +8,14 @@
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <complex>
+#include <cstring>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <list>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <string>
 #include <sstream>
@@ -278,12 +281,21 @@ namespace c74::min {
         typename enable_if<!is_base_of<ui_operator_base, min_class_type>::value>::type;
 
 
-    enum class threadsafe { undefined, no, yes };
+    // threadsafe::snapshot applies only to attributes: see attribute_snapshot
+    enum class threadsafe { undefined, no, yes, snapshot };
     enum class allow_repetitions { undefined, no, yes };
 
+#if defined(C74_MIN_REALTIME_CHECKS) || defined(C74_MIN_MUTEX_STATISTICS)
+    class checked_mutex;    // reports locking in perform routines and collects statistics, see c74_min_mutex.h
+
+    using mutex = checked_mutex;
+    using guard = std::lock_guard<checked_mutex>;
+    using lock  = std::unique_lock<checked_mutex>;
+#else
     using mutex = std::mutex;
     using guard = std::lock_guard<std::mutex>;
     using lock  = std::unique_lock<std::mutex>;
+#endif
 
 
     template<typename T>
@@ -362,14 +374,22 @@ namespace c74::min {
     }
 }
 
+#include "c74_min_realtime_check.h"  // Detecting allocations and locks in perform routines
+#include "c74_min_denormals.h"        // Flushing denormal numbers to zero in perform routines
+#include "c74_min_mutex.h"           // The instrumented mutex for realtime checks and lock statistics
 #include "c74_min_string.h"     // String helper functions
+#include "c74_min_small_vector.h" // Container with inline storage for short sequences
+#include "c74_min_mpmc_fifo.h"     // Lock-free queue for any number of writing and reading threads
+#include "c74_min_queue_health.h"  // Depth, overflow and latency counters for queues between threads
 #include "c74_min_symbol.h"
 #include "c74_min_atom.h"
 #include "c74_min_dictionary.h"
+#include "c74_min_binary_state.h"       // Binary object state saved with the patcher
 #include "c74_min_limit.h"      // Library of miscellaneous helper functions (e.g. range clipping)
 
 #include "c74_min_notification.h"       // A class representing notifications from attached-to objects
 #include "c74_min_patcher.h"            // Wrapper for interfacing with patchers
+#include "c74_min_dispatch_table.h"     // Lookup of messages and attributes by symbol
 
 #include "c74_min_object_components.h"  // Shared components of Max objects
 #include "c74_jitter.h"
@@ -378,15 +398,25 @@ namespace c74::min {
 #include "c74_min_port.h"               // Inlets and Outlets
 #include "c74_min_threadsafety.h"       // ...
 #include "c74_min_inlet.h"              // ...
+#include "c74_min_float_array.h"        // Arrays of numbers sent between Min objects without atoms
 #include "c74_min_outlet.h"             // ...
 #include "c74_min_argument.h"           // Arguments to objects
 #include "c74_min_message.h"            // Messages to objects
+#include "c74_min_smoothing.h"          // Ramps for smoothing attribute changes in the audio thread
 #include "c74_min_attribute.h"          // Attributes of objects
+#include "c74_min_preset_morph.h"       // Interpolation between presets of numeric attributes
 #include "c74_min_logger.h"             // Console / Max Window output
+#include "c74_min_profiler.h"           // Measuring the time of audio processing
+#include "c74_min_silence.h"            // Skipping the processing of silent input
 #include "c74_min_operator_vector.h"    // Vector-based MSP object add-ins
 #include "c74_min_operator_sample.h"    // Sample-based MSP object add-ins
+#include "c74_min_worker_pool.h"        // Worker threads for parallel audio and matrix processing
+#include "c74_min_task_scheduler.h"     // The worker threads shared by all externals, with real-time and background lanes
 #include "c74_min_operator_mc.h"    	// Vector-based MC object add-ins
+#include "c74_min_reduction.h"          // Reductions across the channels of audio bundles
+#include "c74_min_spectral.h"           // Overlap-add spectral processing for vector operators
 #include "c74_min_operator_matrix.h"    // Jitter MOP add-ins
+#include "c74_min_stencil.h"            // Stencils and convolution for matrix rows
 #include "c74_min_operator_ui.h"		// User Interface add-ins
 #include "c74_min_graphics.h"			// Graphics classes for UI objects
 #include "c74_min_event.h"              // Mouse-event and Touch-event classes
@@ -396,8 +426,14 @@ namespace c74::min {
 
 #include "c74_min_timer.h"              // Wrapper for clocks
 #include "c74_min_queue.h"              // Wrapper for qelems and fifos
+#include "c74_min_timed_events.h"       // Sample-accurate events for audio objects
+#include "c74_min_ring_buffer.h"        // Streaming blocks of items between threads
+#include "c74_min_collector.h"          // Collecting items from many threads without locks
 #include "c74_min_buffer.h"             // Wrapper for MSP buffers
 #include "c74_min_path.h"               // Wrapper class for accessing the Max path system
+#include "c74_min_buffer_loader.h"      // Filling buffers from audio files on a background thread
+#include "c74_min_buffer_swap.h"        // Editing the content of buffers while the audio thread reads it
+#include "c74_min_offline_render.h"     // Processing buffers with the DSP of audio classes faster than real time
 #include "c74_min_texteditor.h"         // Wrapper for text editor window
 #include "c74_min_dataspace.h"          // Unit conversion routines (e.g. db-to-linear or hz-to-midi)
 
@@ -8,6 +8,13 @@
 namespace c74::min {
 
     class event;
+    class atom;
+    class atom_span;
+
+
+    /// The number of atoms that an atoms container holds without allocating memory.
+
+    constexpr size_t k_atoms_inline_capacity { 8 };
 
     class atom : public max::t_atom {
     public:
@@ -18,7 +25,9 @@ namespace c74::min {
         }
 
         /// constructor with generic initializer
-        template<class T, typename enable_if<!std::is_enum<T>::value && !is_same<T, std::vector<atom>>::value, int>::type = 0>
+        template<class T, typename enable_if<!std::is_enum<T>::value && !is_same<T, std::vector<atom>>::value
+                                              && !is_same<T, small_vector<atom, k_atoms_inline_capacity>>::value
+                                              && !is_same<T, atom_span>::value, int>::type = 0>
         atom(const T initial_value) {
             *this = initial_value;
         }
@@ -229,12 +238,13 @@ namespace c74::min {
 
 
     /// The atoms container is the standard means by which zero or more values are passed.
-    /// It is implemented as a std::vector of the atom type, and thus atoms contained in an
-    /// atoms container are 'owned' copies... not simply a reference to some externally owned atoms.
+    /// It is implemented as a small_vector of the atom type, which has the interface of a std::vector,
+    /// and thus atoms contained in an atoms container are 'owned' copies... not simply a reference to some externally owned atoms.
+    /// Up to k_atoms_inline_capacity atoms are stored without allocating memory, which covers most messages.
 
     // TODO: how to document inherited interface, e.g. size(), begin(), etc. ?
 
-    using atoms = std::vector<atom>;
+    using atoms = small_vector<atom, k_atoms_inline_capacity>;
 
 
 #ifdef __APPLE__
@@ -364,6 +374,123 @@ namespace c74::min {
         max::t_atom* m_av;
     };
 
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark AtomSpan
+#endif
+
+
+    /// The atom_span type is a read-only view of a contiguous sequence of atoms that it does not own.
+    /// It is used to pass the atoms of an incoming message to a handler without copying them into an atoms container.
+    /// See #MIN_SPAN_FUNCTION.
+    ///
+    /// An atom_span is only valid for as long as the atoms it refers to.
+    /// If the values are needed beyond the call in which the span was received then copy them into an atoms container,
+    /// e.g. `atoms as(args.begin(), args.end());`
+
+    class atom_span {
+    public:
+        using size_type      = size_t;
+        using value_type     = atom;
+        using const_iterator = const atom*;
+        using iterator       = const_iterator;
+
+        static_assert(sizeof(atom) == sizeof(max::t_atom) && std::is_standard_layout<atom>::value,
+            "atom must remain layout-compatible with t_atom to be viewed in place");
+
+
+        /// Create an empty span.
+
+        atom_span() noexcept
+        {}
+
+
+        /// Create a span viewing a C-style argc/argv pair.
+        /// @param	av	The first atom.
+        /// @param	ac	The number of atoms.
+
+        atom_span(const max::t_atom* av, const long ac) noexcept
+        : m_data { reinterpret_cast<const atom*>(av) }
+        , m_size { av ? static_cast<size_type>(ac) : 0 }
+        {}
+
+
+        /// Create a span viewing a sequence of atoms.
+        /// @param	data	The first atom.
+        /// @param	size	The number of atoms.
+
+        atom_span(const atom* data, const size_type size) noexcept
+        : m_data { data }
+        , m_size { size }
+        {}
+
+
+        /// Create a span viewing the contents of an atoms container.
+        /// This is explicit so that a handler taking an atom_span is never mistaken for one taking atoms.
+        /// @param	as	The container to view.
+
+        explicit atom_span(const atoms& as) noexcept
+        : m_data { as.data() }
+        , m_size { as.size() }
+        {}
+
+
+        const_iterator begin() const noexcept {
+            return m_data;
+        }
+
+        const_iterator end() const noexcept {
+            return m_data + m_size;
+        }
+
+        size_type size() const noexcept {
+            return m_size;
+        }
+
+        bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        const atom* data() const noexcept {
+            return m_data;
+        }
+
+        const atom& operator[](const size_type index) const {
+            return m_data[index];
+        }
+
+        const atom& at(const size_type index) const {
+            if (index >= m_size)
+                throw std::out_of_range("atom_span::at");
+            return m_data[index];
+        }
+
+        const atom& front() const {
+            return m_data[0];
+        }
+
+        const atom& back() const {
+            return m_data[m_size - 1];
+        }
+
+
+        /// Create a span viewing part of this span.
+        /// @param	offset	The index of the first atom to view.
+        /// @param	count	The number of atoms to view, by default all atoms after offset.
+        /// @return			The new span.
+
+        atom_span subspan(const size_type offset, const size_type count = std::numeric_limits<size_type>::max()) const {
+            const auto first { std::min(offset, m_size) };
+            const auto n { std::min(count, m_size - first) };
+            return atom_span { m_data + first, n };
+        }
+
+    private:
+        const atom* m_data { nullptr };
+        size_type   m_size { 0 };
+    };
+
 }    // namespace c74::min
 
 
@@ -410,6 +537,15 @@ namespace std {
 }    // namespace std
 
 
+namespace c74::min {
+
+    // atoms is no longer a std::vector, so the overloads above are not found by argument-dependent lookup
+
+    using std::to_string;
+
+}    // namespace c74::min
+
+
 namespace c74::min {
 
     /// Expose atom for use in std output streams.
@@ -170,6 +170,21 @@ namespace c74::min {
         virtual operator atoms() const = 0;
 
 
+        // Used by the preset_morph to read and write single numbers without converting them to atoms.
+        // Numeric attributes are those of type number, float, int or bool without a custom getter.
+        // Not intended for public use.
+
+        virtual bool numeric() const {
+            return false;
+        }
+
+        virtual double numeric_value() const {
+            return 0.0;
+        }
+
+        virtual void assign_numeric(const double value) {}
+
+
         // All attributes must define what happens when asked for their range of values.
         // The range must be in string format, values separated by spaces.
 
@@ -288,6 +303,15 @@ namespace c74::min {
             max::object_attr_touch(m_owner, m_name);
         }
 
+
+        // DO NOT USE
+        // This is an internal method used to update the length of the smoothing ramp when the dsp chain is compiled.
+        // It is made 'public' due to the trickiness of the SFINAE-enabled templated functions which call this from the wrapper.
+
+        void prepare_smoothing(const double samplerate) {
+            m_smoother.prepare(samplerate);
+        }
+
     protected:
         object_base& m_owner;
         symbol       m_name;
@@ -303,6 +327,7 @@ namespace c74::min {
         symbol       m_category;                // Max inspector category
         int          m_order { 0 };             // Max inspector ordering
 		symbol       m_live_color { k_sym__empty };
+        attribute_smoother m_smoother;          // ramp used by smoothed() in the audio thread
 
         // calculate the offset of the size member as required for array/vector attributes
 
@@ -348,6 +373,8 @@ namespace c74::min {
     ///								If your object has been written specifically and carefully to be threadsafe then
     ///								you may pass the option parameter threadsafe::yes.
     ///								The default is threadsafe::no, which is the correct choice in most cases.
+    ///								Pass threadsafe::snapshot for attributes that are read in the audio thread
+    ///								(e.g. vector-typed attributes read in a perform routine), and read them using snapshot().
     /// @tparam		limit_type		An optional parameter.
     ///								If your attribute is a numeric type (e.g. number or int), and it defines a range,
     ///								the class type you specify here will be used to limit the input values to that range.
@@ -454,6 +481,15 @@ namespace c74::min {
 		}
 
 
+        // constructor utility: handle an argument defining an attribute's smoothing property
+
+        template<typename argument_type>
+        constexpr typename enable_if<is_same<argument_type, smoothing>::value>::type assign_from_argument(const argument_type& arg) noexcept {
+            static_assert(std::is_floating_point<T>::value, "smoothing is only available for attributes with a floating-point type");
+            m_smoother.configure(arg);
+        }
+
+
         // constructor utility: empty argument handling (required for handling recursive variadic templates)
 
         constexpr void handle_arguments() noexcept {
@@ -651,6 +687,77 @@ namespace c74::min {
         }
 
 
+        // Single numbers for the preset_morph, without atoms.
+        // assign_numeric() neither calls the setter nor notifies Max. Integers are rounded.
+
+        bool numeric() const override {
+            return std::is_arithmetic<T>::value && !m_getter;
+        }
+
+        double numeric_value() const override {
+            if constexpr (std::is_arithmetic<T>::value)
+                return static_cast<double>(m_value);
+            else
+                return 0.0;
+        }
+
+        void assign_numeric(const double value) override {
+            if constexpr (std::is_arithmetic<T>::value) {
+                if constexpr (std::is_same<T, bool>::value)
+                    m_value = value >= 0.5;
+                else if constexpr (std::is_integral<T>::value)
+                    m_value = static_cast<T>(std::lround(value));
+                else
+                    m_value = static_cast<T>(value);
+
+                publish();
+            }
+        }
+
+
+        /// Get the attribute value in the native datatype, without any conversion.
+        /// This is a reference to the storage of the attribute, so reading it costs no more than reading a member variable,
+        /// e.g. in paint() or in a loop. It must not be read while the attribute may be set on another thread:
+        /// the audio thread reads attributes declared with threadsafe::snapshot using snapshot() instead.
+        /// Not available for attributes with a getter.
+        /// @return	The value of the attribute.
+
+        const T& value() const {
+            assert(!m_getter);
+            return m_value;
+        }
+
+
+        /// Set the attribute value in the native datatype.
+        /// When the attribute has no setter the value is range-limited and stored without converting it to atoms and back,
+        /// otherwise it is set as by set(). In both cases Max is not notified, as by set() with notify false.
+        /// Off the main thread, attributes that are not threadsafe are set in the main thread, using atoms.
+        /// @param	a_value				The new value to be assigned to the attribute.
+        /// @param	override_readonly	Set the value even if the attribute is readonly.
+
+        void set_value(const T& a_value, const bool override_readonly = false) {
+            if (!writable() && !override_readonly)
+                return;
+
+            if (m_setter || !settable_in_this_thread()) {
+                set(to_atoms(a_value), false, override_readonly);
+                return;
+            }
+
+            const auto constrained { constrain_value(a_value) };
+
+            if (repetitions == allow_repetitions::no && m_value == constrained)
+                return;
+
+            m_value = constrained;
+            publish();
+            m_owner.complete_attributes();
+
+            if (name() == k_sym_value)
+                c74::max::object_notify(owner().maxobj(), k_sym_modified, nullptr);
+        }
+
+
         /// Get the attribute value as a const reference to the native datatype.
         /// We need to return by const reference in cases where the type of the attribute is a class.
         /// For example, a #time_value attribute cannot be copy constructed.
@@ -702,6 +809,46 @@ namespace c74::min {
         }
 
 
+        /// Get a wait-free read of the attribute value from any thread.
+        /// The value cannot change while the returned reader exists, so keep it only for the duration of e.g. one perform call.
+        /// Only available for attributes declared with threadsafe::snapshot.
+        /// @return	A reader which is dereferenced to get a const reference to the value.
+
+        template<threadsafe U = threadsafety, typename enable_if<U == threadsafe::snapshot, int>::type = 0>
+        auto snapshot() const {
+            return m_helper.read();
+        }
+
+
+        /// Get the value of the attribute, ramping towards it over the time given by the smoothing argument.
+        /// Call this once per sample from the audio thread only.
+        /// Without a smoothing argument the value follows changes immediately.
+        /// @return	The next sample of the smoothed value.
+
+        template<class U = T, typename enable_if<std::is_floating_point<U>::value, int>::type = 0>
+        T smoothed() {
+            return static_cast<T>(m_smoother.next());
+        }
+
+
+        /// Is the value returned by smoothed() still ramping towards the value of the attribute?
+        /// Call this from the audio thread only.
+        /// @return	True if the ramp has not yet reached the value of the attribute.
+
+        bool is_ramping() const {
+            return m_smoother.ramping();
+        }
+
+
+        /// Change the time over which smoothed() ramps to a new value.
+        /// @param	milliseconds	The duration of the ramp. Zero disables smoothing.
+
+        template<class U = T, typename enable_if<std::is_floating_point<U>::value, int>::type = 0>
+        void smoothing_time(const double milliseconds) {
+            m_smoother.time(std::max(milliseconds, 0.0));
+        }
+
+
         /// Is the attribute currently disabled?
         /// @return	True if it is disabled. False if it is active.
 
@@ -760,6 +907,40 @@ namespace c74::min {
         }
 
 
+        // Range limiting of a value in the native datatype, for set_value().
+
+        T constrain_value(const T& a_value) const {
+            if constexpr (is_same<limit_type<T>, limit::none<T>>::value)
+                return a_value;
+            else
+                return limit_type<T>::apply(a_value, m_range[0], m_range[1]);
+        }
+
+
+        // Can the value be stored in this thread rather than being deferred to the main thread?
+        // Jitter attributes are never deferred, as in set().
+
+        bool settable_in_this_thread() const {
+            if constexpr (threadsafety == threadsafe::yes)
+                return true;
+            else if constexpr (threadsafety == threadsafe::undefined)
+                return m_owner.is_jitter_class() || m_owner.is_assumed_threadsafe() || max::systhread_ismainthread();
+            else
+                return m_owner.is_jitter_class() || max::systhread_ismainthread();
+        }
+
+
+        // Make a newly stored value available to snapshot() and smoothed().
+
+        void publish() {
+            if constexpr (threadsafety == threadsafe::snapshot)
+                m_helper.publish(m_value);
+
+            if constexpr (std::is_floating_point<T>::value)
+                m_smoother.publish(static_cast<double>(m_value));
+        }
+
+
         // Assign the value to the internal data storage member.
         // Occurs after the limits are constrained, the setter is called, etc.
 
@@ -815,6 +996,107 @@ namespace c74::min {
     // That is what we have in attribute_threadsafe_helper.
 
 
+    /// Storage for an attribute value that is written on one thread and read on any number of others.
+    /// This is the mechanism behind attributes declared with threadsafe::snapshot.
+    ///
+    /// The value is kept in two copies using the left-right technique.
+    /// Readers only increment and decrement a counter, so reading is wait-free and never allocates.
+    /// The writer updates the copy that no reader can see, publishes it, waits for the readers of the
+    /// other copy to finish, and then brings that copy up to date.
+    /// Writes are therefore serialized and may wait briefly, but they happen on the main thread.
+    ///
+    /// @tparam	T	The type of the value, which must be default constructible and copy assignable.
+
+    template<typename T>
+    class attribute_snapshot {
+    public:
+
+        /// A read of the value.
+        /// While the reader exists the value it refers to will not change, and a writer may be waiting for it.
+
+        class reader {
+        public:
+            reader(const T& value, std::atomic<int>& count)
+            : m_value { value }
+            , m_count { &count }
+            {}
+
+            reader(reader&& other) noexcept
+            : m_value { other.m_value }
+            , m_count { other.m_count } {
+                other.m_count = nullptr;
+            }
+
+            reader(const reader&) = delete;
+            reader& operator=(const reader&) = delete;
+            reader& operator=(reader&&) = delete;
+
+            ~reader() {
+                if (m_count)
+                    m_count->fetch_sub(1);
+            }
+
+            const T& operator*() const {
+                return m_value;
+            }
+
+            const T* operator->() const {
+                return &m_value;
+            }
+
+            operator const T&() const {
+                return m_value;
+            }
+
+        private:
+            const T&            m_value;
+            std::atomic<int>*   m_count;
+        };
+
+
+        /// Read the value.
+        /// @return	A reader referring to the most recently written value.
+
+        reader read() const {
+            auto& count { m_readers[m_version.load()] };
+
+            count.fetch_add(1);
+            return reader { m_values[m_visible.load()], count };
+        }
+
+
+        /// Write a new value.
+        /// Must only be called from one thread at a time.
+        /// @param	value	The new value.
+
+        void write(const T& value) {
+            const auto visible { m_visible.load() };
+
+            m_values[1 - visible] = value;
+            m_visible.store(1 - visible);
+
+            const auto version { m_version.load() };
+
+            wait_for_readers(1 - version);
+            m_version.store(1 - version);
+            wait_for_readers(version);
+
+            m_values[visible] = value;
+        }
+
+    private:
+        T                           m_values[2];
+        std::atomic<int>            m_visible { 0 };       // the copy that readers currently read
+        std::atomic<int>            m_version { 0 };       // the counter that arriving readers increment
+        mutable std::atomic<int>    m_readers[2] {};
+
+        void wait_for_readers(const int version) const {
+            while (m_readers[version].load() != 0)
+                std::this_thread::yield();
+        }
+    };
+
+
     // Shared code used by all of the various incarnations of attribute_threadsafe_helper
     // to set an attribute.
 
@@ -830,6 +1112,9 @@ namespace c74::min {
             attr.m_value = from_atoms<T>(attr.m_setter(constrained_args, -1));
         else
             attr.assign(constrained_args);
+
+        attr.publish();
+        attr.m_owner.complete_attributes();
     }
 
 
@@ -936,6 +1221,50 @@ namespace c74::min {
     };
 
 
+    // A version of attribute_threadsafe_helper<> for attributes which are read from other threads using snapshots.
+    // Setter calls are deferred to the main thread as for threadsafe::no.
+    // Each new value is then published to an attribute_snapshot for readers on any thread.
+
+    template<typename T, template<typename> class limit_type, allow_repetitions repetitions>
+    class attribute_threadsafe_helper<T, threadsafe::snapshot, limit_type, repetitions> {
+        friend void attribute_threadsafe_helper_do_set<T, threadsafe::snapshot, limit_type, repetitions>(attribute_threadsafe_helper<T, threadsafe::snapshot, limit_type, repetitions>* helper, const atoms& args);
+        friend void attribute_threadsafe_helper_qfn<T, threadsafe::snapshot, limit_type, repetitions>(attribute_threadsafe_helper<T, threadsafe::snapshot, limit_type, repetitions>* helper);
+
+    public:
+        explicit attribute_threadsafe_helper(attribute<T, threadsafe::snapshot, limit_type, repetitions>* an_attribute)
+        : m_attribute(an_attribute) {
+            m_qelem = (max::t_qelem*)max::qelem_new(this, (max::method)attribute_threadsafe_helper_qfn<T, threadsafe::snapshot, limit_type, repetitions>);
+        }
+
+        ~attribute_threadsafe_helper() {
+            max::qelem_free(m_qelem);
+        }
+
+        void set(const atoms& args) {
+            if (max::systhread_ismainthread())
+                attribute_threadsafe_helper_do_set(this, args);
+            else {
+                m_value = args;
+                max::qelem_set(m_qelem);
+            }
+        }
+
+        auto read() const {
+            return m_snapshot.read();
+        }
+
+        void publish(const T& value) {
+            m_snapshot.write(value);
+        }
+
+    private:
+        attribute<T, threadsafe::snapshot, limit_type, repetitions>*    m_attribute;
+        max::t_qelem*                                                   m_qelem;
+        atoms                                                           m_value;
+        attribute_snapshot<T>                                           m_snapshot;
+    };
+
+
 #ifdef MAC_VERSION
 #pragma mark -
 #pragma mark Wrapper methods
@@ -947,7 +1276,7 @@ namespace c74::min {
     template<class T>
     max::t_max_err min_attr_getter(minwrap<T>* self, max::t_object* maxattr, long* ac, max::t_atom** av) {
         const symbol	attr_name	= static_cast<const max::t_symbol*>(max::object_method(maxattr, k_sym_getname));
-        auto&	        attr		= self->m_min_object.attributes()[attr_name.c_str()];
+        auto&	        attr		= self->m_min_object.attributes()[attr_name];
         atoms	        rvals		= *attr;
 
         if ((*ac) != rvals.size() || !(*av)) {		 // otherwise use memory passed in
@@ -972,9 +1301,13 @@ namespace c74::min {
     template<class T>
     max::t_max_err min_attr_setter(minwrap<T>* self, max::t_object* maxattr, const long ac, const max::t_atom* av) {
 		const symbol attr_name { static_cast<const max::t_symbol*>(max::object_method(maxattr, k_sym_getname)) };
-		auto         attr      { self->m_min_object.attributes()[attr_name.c_str()] };
+		auto         attr      { self->m_min_object.attributes()[attr_name] };
 
         if (attr) {
+            // attributes set one after another on the main thread, e.g. by a preset recall, are completed together
+            if (self->m_min_object.has_call("attributes_complete") && max::systhread_ismainthread())
+                self->m_min_object.batch_attributes_until_idle();
+
 			const atom_reference args(ac, const_cast<max::t_atom*>(av)); // atom_reference cannot guarantee constness, but we are only using it copy atoms out on the line below
             atoms as(args.begin(), args.end());
             attr->set(as, false, false);
@@ -51,7 +51,9 @@ namespace c74::min {
         }
 
         auto as = to_atoms(a_default_value);
+        m_owner.constructing_attribute(true);
         set(as, false, true);
+        m_owner.constructing_attribute(false);
     }
 
 
@@ -71,7 +73,9 @@ namespace c74::min {
         m_default = a_default_value;
 
         auto as = to_atoms(a_default_value);
+        m_owner.constructing_attribute(true);
         set(as, false, true);
+        m_owner.constructing_attribute(false);
     }
 
 
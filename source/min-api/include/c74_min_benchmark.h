@@ -0,0 +1,190 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include "c74_min.h"    // The standard Min header
+
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+
+
+namespace c74::max {
+
+    // defined in the mock kernel, see c74_mock_msp.h
+
+    extern "C" void* mock_dspchain_new(double samplerate, long vectorsize);
+    extern "C" void  mock_dspchain_free(void* dspchain);
+    extern "C" void  mock_dspchain_add(void* dspchain, void* x, long inputcount, long outputcount, double** inputs);
+    extern "C" void  mock_dspchain_tick(void* dspchain);
+
+}    // namespace c74::max
+
+
+namespace c74::min {
+
+
+    /// The configurations and the number of measurements of a benchmark.
+    /// Every combination of samplerate, vector size and channel count is measured.
+
+    struct benchmark_settings {
+        vector<double>  samplerates { 44100.0 };
+        vector<long>    vector_sizes { 64 };
+        vector<long>    channel_counts { 1 };    ///< channels of each multichannel inlet and outlet, single-channel ones always have 1
+        long            warmup { 1000 };         ///< vectors processed before measuring
+        long            runs { 30 };             ///< measurements
+        long            vectors_per_run { 100 }; ///< vectors processed in each measurement
+
+
+        /// Read the settings from the command line of a benchmark executable, e.g.
+        /// @code
+        /// min.phasor_tilde_bench --samplerates 44100 96000 --vectorsizes 1 64 1024 --channels 1 8 --runs 50
+        /// @endcode
+        /// Options that are not given keep their defaults.
+
+        benchmark_settings(const int argc = 0, const char* const* argv = nullptr) {
+            for (auto i = 1; i < argc; ++i) {
+                const string option { argv[i] };
+                vector<double> values;
+
+                while (i + 1 < argc && argv[i + 1][0] != '-')
+                    values.push_back(std::atof(argv[++i]));
+                if (values.empty())
+                    continue;
+
+                if (option == "--samplerates")
+                    samplerates = values;
+                else if (option == "--vectorsizes")
+                    vector_sizes.assign(values.begin(), values.end());
+                else if (option == "--channels")
+                    channel_counts.assign(values.begin(), values.end());
+                else if (option == "--warmup")
+                    warmup = static_cast<long>(values[0]);
+                else if (option == "--runs")
+                    runs = static_cast<long>(values[0]);
+                else if (option == "--vectors")
+                    vectors_per_run = static_cast<long>(values[0]);
+            }
+        }
+    };
+
+
+    /// The summary of the measurements of one configuration, in nanoseconds per sample.
+    /// The samples are counted on the inputs or the outputs, whichever have more channels.
+
+    struct benchmark_result {
+        double  samplerate {};
+        long    vector_size {};
+        long    channel_count {};
+        double  mean {};
+        double  median {};
+        double  minimum {};
+        double  maximum {};
+        double  deviation {};    ///< standard deviation
+    };
+
+
+    /// Measure the perform routine of a Min class in one configuration.
+    /// A new instance is created and added to the mock signal chain, with all inlets and outlets connected
+    /// and the inputs filled with white noise, and the chain is run repeatedly.
+    /// ext_main() of the class must have been called.
+    ///
+    /// @tparam	min_class_type	The Min class to measure, which must be an audio class.
+    /// @param	settings		The number of measurements.
+    /// @param	samplerate		The samplerate.
+    /// @param	vector_size		The vector size.
+    /// @param	channel_count	The number of channels of each multichannel inlet and outlet.
+    /// @return					The summary of the measurements.
+
+    template<class min_class_type>
+    benchmark_result benchmark(const benchmark_settings& settings, const double samplerate, const long vector_size, const long channel_count) {
+        auto  self { wrapper_new<min_class_type>(symbol("dummy"), 0, nullptr) };
+        auto& object { self->m_min_object };
+        auto  chain { max::mock_dspchain_new(samplerate, vector_size) };
+
+        const auto mc { is_base_of<mc_operator_base, min_class_type>::value };
+        const long input_count { static_cast<long>(object.inlets().size()) * (mc ? channel_count : 1) };
+        long       output_count {};
+
+        for (const auto o : object.outlets()) {
+            if (o->type() == "multichannelsignal")
+                output_count += channel_count;
+            else if (o->type() == "signal")
+                ++output_count;
+        }
+
+        vector<double*> inputs(static_cast<size_t>(input_count));
+        max::mock_dspchain_add(chain, self, input_count, output_count, inputs.data());
+
+        std::mt19937                           generator { 0 };
+        std::uniform_real_distribution<double> noise { -1.0, 1.0 };
+
+        for (auto input : inputs)
+            std::generate_n(input, vector_size, [&] { return noise(generator); });
+
+        for (auto i = 0; i < settings.warmup; ++i)
+            max::mock_dspchain_tick(chain);
+
+        const auto samples { static_cast<double>(settings.vectors_per_run * vector_size * std::max({input_count, output_count, 1L})) };
+        vector<double> times(static_cast<size_t>(settings.runs));
+
+        for (auto& t : times) {
+            const auto start { std::chrono::steady_clock::now() };
+
+            for (auto i = 0; i < settings.vectors_per_run; ++i)
+                max::mock_dspchain_tick(chain);
+            t = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / samples;
+        }
+
+        max::mock_dspchain_free(chain);
+        max::object_free(self);
+
+        benchmark_result r { samplerate, vector_size, channel_count };
+
+        if (times.empty())
+            return r;
+
+        std::sort(times.begin(), times.end());
+        r.minimum = times.front();
+        r.maximum = times.back();
+        r.median  = times[times.size() / 2];
+        r.mean    = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        for (const auto t : times)
+            r.deviation += (t - r.mean) * (t - r.mean);
+        r.deviation = std::sqrt(r.deviation / times.size());
+        return r;
+    }
+
+
+    /// Measure the perform routine of a Min class in every configuration of the settings and print a table of the results.
+    /// This is typically all that the main() of a benchmark executable does after calling ext_main().
+    ///
+    /// @tparam	min_class_type	The Min class to measure, which must be an audio class.
+    /// @param	name			The name of the class to print.
+    /// @param	settings		The configurations and the number of measurements.
+    /// @return					0, to be returned from main().
+
+    template<class min_class_type>
+    int benchmark(const char* name, const benchmark_settings& settings) {
+        std::printf("%s (ns/sample)\n", name);
+        std::printf("%10s %8s %8s %10s %10s %10s %10s %10s\n", "samplerate", "vs", "channels", "mean", "median", "min", "max", "stdev");
+
+        for (const auto sr : settings.samplerates) {
+            for (const auto vs : settings.vector_sizes) {
+                for (const auto channels : settings.channel_counts) {
+                    const auto r { benchmark<min_class_type>(settings, sr, vs, channels) };
+
+                    std::printf("%10.0f %8ld %8ld %10.3f %10.3f %10.3f %10.3f %10.3f\n", r.samplerate, r.vector_size, r.channel_count,
+                        r.mean, r.median, r.minimum, r.maximum, r.deviation);
+                }
+            }
+        }
+        return 0;
+    }
+
+
+}    // namespace c74::min
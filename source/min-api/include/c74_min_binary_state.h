@@ -0,0 +1,400 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// How the bytes of a binary_state are compressed when they are saved with the patcher.
+
+    enum class binary_compression {
+        none,    ///< The bytes are saved as they are (the default).
+        lz       ///< Repeated sequences of bytes are replaced by references to earlier ones. Suits sparse or repetitive data, e.g. runs of zeros.
+    };
+
+
+    /// A contiguous buffer of bytes that an object saves with the patcher and recalls when it is loaded,
+    /// as a fast alternative to writing large state (e.g. a convolution kernel or a wavetable) into the dictionary atom by atom.
+    ///
+    /// An object that defines a 'savestate_binary' message receives a binary_state to write to when the patcher is saved,
+    /// and one that defines a 'loadstate_binary' message receives the bytes again when the object is created from the patcher.
+    /// The bytes are stored as a single string entry of the object's dictionary, encoded as base64 and optionally compressed.
+    ///
+    /// Values are written and read as they are in memory, so they are only portable between platforms with the same byte order.
+    ///
+    /// @code
+    /// message<> savestate_binary { this, "savestate_binary",
+    ///     MIN_FUNCTION {
+    ///         auto& state { binary_state::from(args) };
+    ///         state.compression(binary_compression::lz);
+    ///         state.write(m_kernel.size());
+    ///         state.write(m_kernel.data(), m_kernel.size());
+    ///         return {};
+    ///     }
+    /// };
+    ///
+    /// message<> loadstate_binary { this, "loadstate_binary",
+    ///     MIN_FUNCTION {
+    ///         auto&  state { binary_state::from(args) };
+    ///         size_t size {};
+    ///         if (state.read(size) && size * sizeof(number) == state.remaining()) {
+    ///             m_kernel.resize(size);
+    ///             state.read(m_kernel.data(), size);
+    ///         }
+    ///         return {};
+    ///     }
+    /// };
+    /// @endcode
+
+    class binary_state {
+    public:
+        /// Get the binary_state passed to a 'savestate_binary' or 'loadstate_binary' message.
+        /// @param	args	The arguments of the message.
+        /// @return			The binary state.
+
+        static binary_state& from(const atoms& args) {
+            return *static_cast<binary_state*>(static_cast<void*>(args[0]));
+        }
+
+
+        /// Append bytes.
+        /// @param	data	The bytes.
+        /// @param	size	The number of bytes.
+
+        void write(const void* data, const size_t size) {
+            const auto bytes { static_cast<const uint8_t*>(data) };
+            m_bytes.insert(m_bytes.end(), bytes, bytes + size);
+        }
+
+
+        /// Append a value.
+        /// @tparam	T		A trivially copyable type.
+        /// @param	value	The value.
+
+        template<class T>
+        void write(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be written as bytes");
+            write(static_cast<const void*>(&value), sizeof(T));
+        }
+
+
+        /// Append an array of values.
+        /// @tparam	T		A trivially copyable type.
+        /// @param	values	The values.
+        /// @param	count	The number of values.
+
+        template<class T>
+        void write(const T* values, const size_t count) {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be written as bytes");
+            write(static_cast<const void*>(values), count * sizeof(T));
+        }
+
+
+        /// Read the next bytes.
+        /// @param	data	The buffer for the bytes.
+        /// @param	size	The number of bytes.
+        /// @return			False, without reading anything, if fewer bytes remain.
+
+        bool read(void* data, const size_t size) {
+            if (size > remaining())
+                return false;
+            std::memcpy(data, m_bytes.data() + m_read, size);
+            m_read += size;
+            return true;
+        }
+
+
+        /// Read the next value.
+        /// @tparam	T		A trivially copyable type.
+        /// @param	value	The value that is read.
+        /// @return			False, without reading anything, if the value does not remain.
+
+        template<class T>
+        bool read(T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be read from bytes");
+            return read(static_cast<void*>(&value), sizeof(T));
+        }
+
+
+        /// Read the next values into an array.
+        /// @tparam	T		A trivially copyable type.
+        /// @param	values	The array.
+        /// @param	count	The number of values.
+        /// @return			False, without reading anything, if the values do not remain.
+
+        template<class T>
+        bool read(T* values, const size_t count) {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be read from bytes");
+            return read(static_cast<void*>(values), count * sizeof(T));
+        }
+
+
+        /// @return	The number of bytes that have not been read yet.
+
+        size_t remaining() const {
+            return m_bytes.size() - m_read;
+        }
+
+
+        /// @return	The number of bytes.
+
+        size_t size() const {
+            return m_bytes.size();
+        }
+
+
+        /// @return	The bytes.
+
+        const uint8_t* data() const {
+            return m_bytes.data();
+        }
+
+
+        /// Set how the bytes are compressed when they are saved.
+        /// @param	a_compression	The compression.
+
+        void compression(const binary_compression a_compression) {
+            m_compression = a_compression;
+        }
+
+
+        /// @return	How the bytes are compressed when they are saved.
+
+        binary_compression compression() const {
+            return m_compression;
+        }
+
+
+        /// Encode the bytes as text for the dictionary of the patcher:
+        /// the compression ('n' or 'l'), the number of bytes and a colon, followed by the (compressed) bytes in base64.
+        /// @return	The text.
+
+        std::string encode() const {
+            std::string text { m_compression == binary_compression::lz ? "l" : "n" };
+
+            text += std::to_string(m_bytes.size());
+            text += ':';
+            if (m_compression == binary_compression::lz) {
+                std::vector<uint8_t> compressed;
+                lz_compress(m_bytes.data(), m_bytes.size(), compressed);
+                base64_encode(compressed.data(), compressed.size(), text);
+            }
+            else
+                base64_encode(m_bytes.data(), m_bytes.size(), text);
+            return text;
+        }
+
+
+        /// Replace the bytes by those of text from encode(), to be read from the beginning.
+        /// @param	text	The text.
+        /// @return			False if the text is not valid, in which case the state is empty.
+
+        bool decode(const char* text) {
+            m_bytes.clear();
+            m_read = 0;
+
+            if (!text || (text[0] != 'n' && text[0] != 'l'))
+                return false;
+            m_compression = text[0] == 'l' ? binary_compression::lz : binary_compression::none;
+
+            char*      end {};
+            const auto size { std::strtoull(text + 1, &end, 10) };
+            if (end == text + 1 || *end != ':')
+                return false;
+
+            std::vector<uint8_t> decoded;
+            auto&                target { m_compression == binary_compression::lz ? decoded : m_bytes };
+            if (!base64_decode(end + 1, target))
+                return clear_and_fail();
+
+            if (m_compression == binary_compression::lz && !lz_decompress(decoded.data(), decoded.size(), size, m_bytes))
+                return clear_and_fail();
+            if (m_bytes.size() != size)
+                return clear_and_fail();
+            return true;
+        }
+
+    private:
+        std::vector<uint8_t>    m_bytes;
+        size_t                  m_read {};
+        binary_compression      m_compression { binary_compression::none };
+
+        bool clear_and_fail() {
+            m_bytes.clear();
+            return false;
+        }
+
+
+        // The compressed format is a sequence of a literal run followed by a match, as in LZ4 blocks:
+        // a token with the literal length in the high and the match length minus 4 in the low nibble (15 means more bytes of 255 follow),
+        // the literals, and the offset of the match as two bytes (little-endian). The last sequence only has literals.
+
+        static constexpr size_t k_minimum_match { 4 };
+        static constexpr size_t k_maximum_offset { 65535 };
+        static constexpr int    k_hash_bits { 14 };
+
+        static void write_length(std::vector<uint8_t>& out, size_t length) {
+            for (; length >= 255; length -= 255)
+                out.push_back(255);
+            out.push_back(static_cast<uint8_t>(length));
+        }
+
+        static void write_sequence(std::vector<uint8_t>& out, const uint8_t* literals, const size_t literal_count, const size_t offset, const size_t match_length) {
+            const auto extra_match { match_length ? match_length - k_minimum_match : 0 };
+
+            out.push_back(static_cast<uint8_t>((std::min<size_t>(literal_count, 15) << 4) | std::min<size_t>(extra_match, 15)));
+            if (literal_count >= 15)
+                write_length(out, literal_count - 15);
+            out.insert(out.end(), literals, literals + literal_count);
+            if (!match_length)
+                return;
+            out.push_back(static_cast<uint8_t>(offset & 0xff));
+            out.push_back(static_cast<uint8_t>(offset >> 8));
+            if (extra_match >= 15)
+                write_length(out, extra_match - 15);
+        }
+
+        static void lz_compress(const uint8_t* in, const size_t size, std::vector<uint8_t>& out) {
+            std::vector<uint32_t> table(size_t { 1 } << k_hash_bits, 0);    // position + 1 of the last occurrence of a hash, 0 for none
+            size_t                anchor {};
+            size_t                i {};
+
+            out.clear();
+            out.reserve(size / 2 + 16);
+            while (i + k_minimum_match <= size) {
+                uint32_t sequence;
+                std::memcpy(&sequence, in + i, sizeof(sequence));
+
+                auto&      entry { table[(sequence * 2654435761u) >> (32 - k_hash_bits)] };
+                const auto candidate { static_cast<size_t>(entry) };
+                entry = static_cast<uint32_t>(i + 1);
+
+                if (candidate && i - (candidate - 1) <= k_maximum_offset && std::memcmp(in + candidate - 1, in + i, k_minimum_match) == 0) {
+                    const auto match { candidate - 1 };
+                    auto       length { k_minimum_match };
+                    while (i + length < size && in[match + length] == in[i + length])    // may overlap, which encodes runs
+                        ++length;
+                    write_sequence(out, in + anchor, i - anchor, i - match, length);
+                    i += length;
+                    anchor = i;
+                }
+                else
+                    ++i;
+            }
+            write_sequence(out, in + anchor, size - anchor, 0, 0);
+        }
+
+        static bool read_length(const uint8_t*& p, const uint8_t* end, size_t& length) {
+            while (true) {
+                if (p == end)
+                    return false;
+                const auto b { *p++ };
+                length += b;
+                if (b != 255)
+                    return true;
+            }
+        }
+
+        static bool lz_decompress(const uint8_t* in, const size_t size, const size_t expected_size, std::vector<uint8_t>& out) {
+            const auto end { in + size };
+            auto       p { in };
+
+            out.clear();
+            out.reserve(expected_size);
+            while (p != end) {
+                const auto token { *p++ };
+                size_t     literal_count = token >> 4;
+                if (literal_count == 15 && !read_length(p, end, literal_count))
+                    return false;
+                if (literal_count > static_cast<size_t>(end - p) || out.size() + literal_count > expected_size)
+                    return false;
+                out.insert(out.end(), p, p + literal_count);
+                p += literal_count;
+                if (p == end)
+                    break;
+
+                if (end - p < 2)
+                    return false;
+                const size_t offset = p[0] | (p[1] << 8);
+                p += 2;
+                size_t length = (token & 15);
+                if (length == 15 && !read_length(p, end, length))
+                    return false;
+                length += k_minimum_match;
+                if (offset == 0 || offset > out.size() || out.size() + length > expected_size)
+                    return false;
+                for (auto from = out.size() - offset; length; --length, ++from)
+                    out.push_back(out[from]);
+            }
+            return true;
+        }
+
+
+        static constexpr char k_base64_alphabet[] { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+
+        static void base64_encode(const uint8_t* in, const size_t size, std::string& out) {
+            out.reserve(out.size() + (size + 2) / 3 * 4);
+            size_t i {};
+            for (; i + 3 <= size; i += 3) {
+                const uint32_t v = (in[i] << 16) | (in[i + 1] << 8) | in[i + 2];
+                out += k_base64_alphabet[v >> 18];
+                out += k_base64_alphabet[(v >> 12) & 63];
+                out += k_base64_alphabet[(v >> 6) & 63];
+                out += k_base64_alphabet[v & 63];
+            }
+            if (i < size) {
+                const uint32_t v = (in[i] << 16) | (i + 1 < size ? in[i + 1] << 8 : 0);
+                out += k_base64_alphabet[v >> 18];
+                out += k_base64_alphabet[(v >> 12) & 63];
+                out += i + 1 < size ? k_base64_alphabet[(v >> 6) & 63] : '=';
+                out += '=';
+            }
+        }
+
+        static int base64_value(const char c) {
+            if (c >= 'A' && c <= 'Z')
+                return c - 'A';
+            if (c >= 'a' && c <= 'z')
+                return c - 'a' + 26;
+            if (c >= '0' && c <= '9')
+                return c - '0' + 52;
+            if (c == '+')
+                return 62;
+            if (c == '/')
+                return 63;
+            return -1;
+        }
+
+        static bool base64_decode(const char* in, std::vector<uint8_t>& out) {
+            const auto length { std::strlen(in) };
+            if (length % 4)
+                return false;
+
+            out.clear();
+            out.reserve(length / 4 * 3);
+            for (size_t i = 0; i < length; i += 4) {
+                const auto last { i + 4 == length };
+                const auto padding { last ? (in[i + 3] == '=') + (in[i + 2] == '=') : 0 };
+                uint32_t   v {};
+
+                for (auto j = 0; j < 4 - padding; ++j) {
+                    const auto digit { base64_value(in[i + j]) };
+                    if (digit < 0)
+                        return false;
+                    v |= static_cast<uint32_t>(digit) << (18 - 6 * j);
+                }
+                out.push_back(static_cast<uint8_t>(v >> 16));
+                if (padding < 2)
+                    out.push_back(static_cast<uint8_t>(v >> 8));
+                if (padding < 1)
+                    out.push_back(static_cast<uint8_t>(v));
+            }
+            return true;
+        }
+    };
+
+
+}    // namespace c74::min
@@ -7,6 +7,11 @@
 
 namespace c74::min {
 
+    class buffer_registry;
+    class buffer_loader;
+    class buffer_swap;
+
+
     /// @defgroup buffers Buffer Objects
 
     /// A reference to a buffer~ object.
@@ -18,6 +23,9 @@ namespace c74::min {
     public:
         template<bool>
         friend class buffer_lock;
+        friend class buffer_registry;
+        friend class buffer_loader;
+        friend class buffer_swap;
 
         static const constexpr int k_max_channels = 4096;    ///< The maximum number of channels supported by the buffer~ object.
 
@@ -72,9 +80,7 @@ namespace c74::min {
 
         /// Destroy a buffer reference.
 
-        ~buffer_reference() {
-            object_free(m_instance);
-        }
+        ~buffer_reference();
 
 
         /// Bind the buffer reference to a buffer with a different name.
@@ -85,7 +91,13 @@ namespace c74::min {
                 m_instance = max::buffer_ref_new(m_owner, name);
             else
                 buffer_ref_set(m_instance, name);
+
+            const auto previous_name { m_name };
+
             m_name = name;
+            ++m_info_generation;
+            if (m_registry)
+                reindex(previous_name);
         }
 
         /// Get the latest bound buffer name.
@@ -113,6 +125,9 @@ namespace c74::min {
         atoms handle_notification(object_base* an_owner, const atoms& args) {
             notification n { args };
 
+            if (n.name() == k_sym_globalsymbol_binding || n.name() == k_sym_globalsymbol_unbinding || n.name() == k_sym_buffer_modified)
+                ++m_info_generation;
+
             if (m_notification_callback) {
                 if (n.name() == k_sym_globalsymbol_binding)
                     m_notification_callback({k_sym_binding}, -1);
@@ -126,6 +141,7 @@ namespace c74::min {
 
         /// Handle notifications for a collection of pointers to buffer references.
         /// Only dispatches to the appropriate buffer reference(s).
+        /// Every reference of the collection is compared with the name of the buffer~, see #buffer_registry for a lookup by name.
         template<typename Iter>
             static atoms handle_notification(object_base* an_owner, const c74::min::atoms& args, Iter begin, Iter end) {
                 notification n { args };
@@ -133,7 +149,7 @@ namespace c74::min {
                     //the data is the buffer being bound/unbound. it should have the name
                     auto buf = n.data();
                     c74::max::t_symbol * name = nullptr;
-                    c74::max::object_method(buf, c74::max::gensym("getname"), &name);
+                    c74::max::object_method(buf, k_sym_getname, &name);
                     if (name != nullptr) {
                         //look for buffer references that have a matching name and call their handlers
                         c74::min::symbol mname(name);
@@ -154,6 +170,27 @@ namespace c74::min {
         object_base&       m_owner;
         function           m_notification_callback;
 
+        // The size and samplerate of the buffer~, cached by buffer_lock<true> so that they are not fetched for every vector.
+        // The cache is written only in the audio thread. It is refreshed when the generation has been advanced by a
+        // notification or by binding to a different buffer~, or when the buffer~ object or its samples have been reallocated.
+
+        struct info_cache {
+            max::t_buffer_obj*  buffer_obj { nullptr };
+            float*              samples { nullptr };
+            unsigned            generation { 0 };
+            size_t              frame_count { 0 };
+            size_t              channel_count { 0 };
+            double              samplerate { 0.0 };
+        };
+
+        info_cache              m_info;
+        std::atomic<unsigned>   m_info_generation { 1 };
+
+        buffer_registry*        m_registry { nullptr };     ///< the registry indexing this reference by name, if any
+        bool                    m_modified_pending {};      ///< a coalesced 'modified' notification waits for the registry to deliver it
+
+        void reindex(const symbol previous_name);
+
         // Messages added to the owning object for this buffer~ reference
 
         unique_ptr<message<>> m_set_meth {};
@@ -162,6 +199,179 @@ namespace c74::min {
     };
 
 
+    /// An index of the buffer references of an object by the name of their buffer~,
+    /// for objects with many references (e.g. a sampler or a bank of wavetables) and a custom 'notify' message.
+    /// A notification is dispatched only to the references bound to the buffer~ that sent it, found by name rather than by comparing
+    /// the name of every reference. A reference stays indexed under its current name when set() binds it to another buffer~.
+    ///
+    /// The 'modified' notifications that a buffer~ sends in quick succession, e.g. while it is being filled or resized,
+    /// are coalesced: the notification function of each reference is called once, the next time Max services the main thread.
+    /// The size and samplerate that buffer_lock reads in the audio thread are still refreshed for every notification.
+    ///
+    /// @code
+    /// buffer_registry m_buffers { this };
+    ///
+    /// message<> notify { this, "notify",
+    ///     MIN_FUNCTION {
+    ///         return m_buffers.handle_notification(args);
+    ///     }
+    /// };
+    /// @endcode
+    /// @ingroup buffers
+
+    class buffer_registry {
+    public:
+        /// Create a registry.
+        /// @param	an_owner	The owning object for the registry and its buffer references. Typically you will pass `this`.
+
+        explicit buffer_registry(object_base* an_owner)
+        : m_owner { an_owner }
+        , m_deliver { an_owner,
+            MIN_FUNCTION {
+                deliver();
+                return {};
+            }
+        }
+        {}
+
+
+        ~buffer_registry() {
+            for (auto& entry : m_index) {
+                for (auto r : entry.second)
+                    r->m_registry = nullptr;
+            }
+        }
+
+
+        buffer_registry(const buffer_registry&) = delete;
+        buffer_registry& operator=(const buffer_registry&) = delete;
+
+
+        /// Add a buffer reference to the index. It is removed when it is destroyed.
+        /// The reference should be created with `create_messages` set to false, so that it does not add its own 'notify' message.
+        /// @param	a_reference	The buffer reference.
+
+        void add(buffer_reference& a_reference) {
+            if (a_reference.m_registry == this)
+                return;
+            if (a_reference.m_registry)
+                a_reference.m_registry->remove(a_reference);
+
+            a_reference.m_registry = this;
+            m_index[a_reference.m_name].push_back(&a_reference);
+        }
+
+
+        /// Remove a buffer reference from the index.
+        /// @param	a_reference	The buffer reference.
+
+        void remove(buffer_reference& a_reference) {
+            if (a_reference.m_registry != this)
+                return;
+
+            erase(a_reference.m_name, a_reference);
+            m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), &a_reference), m_pending.end());
+            std::replace(m_delivering.begin(), m_delivering.end(), &a_reference, static_cast<buffer_reference*>(nullptr));
+            a_reference.m_registry         = nullptr;
+            a_reference.m_modified_pending = false;
+        }
+
+
+        /// Dispatch a notification to the buffer references bound to the buffer~ that sent it.
+        /// @param	args	The arguments of the owner's 'notify' message.
+        /// @return			Nothing.
+
+        atoms handle_notification(const atoms& args) {
+            notification n { args };
+
+            if (n.name() != k_sym_globalsymbol_binding && n.name() != k_sym_globalsymbol_unbinding && n.name() != k_sym_buffer_modified)
+                return {};
+
+            max::t_symbol* name { nullptr };
+            max::object_method(n.data(), k_sym_getname, &name);
+            if (!name)
+                return {};
+
+            const auto found { m_index.find(name) };
+            if (found == m_index.end())
+                return {};
+
+            for (auto r : found->second) {
+                if (n.name() != k_sym_buffer_modified) {
+                    r->handle_notification(m_owner, args);
+                    continue;
+                }
+
+                ++r->m_info_generation;
+                max::buffer_ref_notify(r->m_instance, n.registration(), n.name(), n.source(), n.data());
+                if (r->m_notification_callback && !r->m_modified_pending) {
+                    r->m_modified_pending = true;
+                    m_pending.push_back(r);
+                    m_deliver.set();
+                }
+            }
+            return {};
+        }
+
+    private:
+        object_base*                                                    m_owner;
+        std::unordered_map<max::t_symbol*, vector<buffer_reference*>>   m_index;
+        vector<buffer_reference*>                                       m_pending;      ///< references with a coalesced 'modified' notification
+        vector<buffer_reference*>                                       m_delivering;
+        queue<>                                                         m_deliver;
+
+        friend class buffer_reference;
+
+
+        void erase(max::t_symbol* name, buffer_reference& a_reference) {
+            auto found { m_index.find(name) };
+            if (found == m_index.end())
+                return;
+
+            auto& references { found->second };
+            references.erase(std::remove(references.begin(), references.end(), &a_reference), references.end());
+            if (references.empty())
+                m_index.erase(found);
+        }
+
+
+        void deliver() {
+            m_delivering.swap(m_pending);
+
+            // a notification function may destroy other references, which are then cleared from the list rather than erased
+            for (size_t i = 0; i < m_delivering.size(); ++i) {
+                if (auto r = m_delivering[i]) {
+                    r->m_modified_pending = false;
+                    r->m_notification_callback({k_sym_modified}, -1);
+                }
+            }
+            m_delivering.clear();
+        }
+    };
+
+
+    inline buffer_reference::~buffer_reference() {
+        if (m_registry)
+            m_registry->remove(*this);
+        object_free(m_instance);
+    }
+
+
+    inline void buffer_reference::reindex(const symbol previous_name) {
+        m_registry->erase(previous_name, *this);
+        m_registry->m_index[m_name].push_back(this);
+    }
+
+
+    /// How buffer_lock::read() treats positions, and the neighbouring frames used for interpolation, which fall outside of the buffer~.
+    /// @ingroup buffers
+
+    enum class buffer_edge {
+        clamp,    ///< Use the first or last frame.
+        wrap      ///< Wrap around to the other end of the buffer~, as for a loop.
+    };
+
+
     /// A lock guard and accessor for buffer~ access.
     ///	@tparam	audio_thread_access	Make this true if you will access the buffer~ from the audio thread.
     ///								Otherwise make this false for access on other threads.
@@ -198,7 +408,10 @@ namespace c74::min {
         /// @see	length_in_seconds()
 
         size_t frame_count() const {
-            return max::buffer_getframecount(m_buffer_obj);
+            if constexpr (audio_thread_access)
+                return m_frame_count;
+            else
+                return max::buffer_getframecount(m_buffer_obj);
         }
 
 
@@ -206,7 +419,10 @@ namespace c74::min {
         ///	@return	The number of channels in the buffer~.
 
         size_t channel_count() const {
-            return max::buffer_getchannelcount(m_buffer_obj);
+            if constexpr (audio_thread_access)
+                return m_channel_count;
+            else
+                return max::buffer_getchannelcount(m_buffer_obj);
         }
 
 
@@ -239,14 +455,186 @@ namespace c74::min {
         }
 
 
+        /// Read interpolated samples from one channel of the buffer~ at a block of fractional frame positions.
+        /// The size and layout of the buffer~ are fetched once for the whole block rather than once per sample,
+        /// leaving a tight loop for the compiler to optimize.
+        ///
+        /// @tparam	interpolator_type	A four-point interpolator such as lib::interpolator::linear<>, lib::interpolator::cubic<>,
+        ///								or lib::interpolator::hermite<>.
+        /// @param	positions			The positions to read, in frames.
+        /// @param	output				Storage for the interpolated samples. May be the same as positions.
+        /// @param	count				The number of positions to read.
+        /// @param	interpolate			The interpolator.
+        /// @param	channel				The channel from which to read.
+        /// @param	edge				How positions outside of the buffer~ are treated.
+
+        template<class interpolator_type>
+        void read(const sample* positions, sample* output, const size_t count, interpolator_type& interpolate, const size_t channel = 0,
+            const buffer_edge edge = buffer_edge::clamp)
+        {
+            sample* const outputs[] { output };
+            read(positions, outputs, 1, count, interpolate, channel, edge);
+        }
+
+
+        /// Read interpolated samples from several adjacent channels of the buffer~ at a block of fractional frame positions.
+        /// The frame and fraction of each position are calculated once and shared by all channels,
+        /// and the channels of each frame are read together, as they are interleaved in the buffer~.
+        /// Channels beyond the last channel of the buffer~ are read from the last channel.
+        ///
+        /// @tparam	interpolator_type	A four-point interpolator such as lib::interpolator::linear<>, lib::interpolator::cubic<>,
+        ///								or lib::interpolator::hermite<>.
+        /// @param	positions			The positions to read, in frames.
+        /// @param	outputs				Storage for the interpolated samples, one array for each channel.
+        ///								Any of them may be the same as positions.
+        /// @param	output_count		The number of channels to read, which is the number of arrays in outputs.
+        /// @param	count				The number of positions to read.
+        /// @param	interpolate			The interpolator.
+        /// @param	first_channel		The channel from which to read into the first output.
+        /// @param	edge				How positions outside of the buffer~ are treated.
+
+        template<class interpolator_type>
+        void read(const sample* positions, sample* const* outputs, const size_t output_count, const size_t count, interpolator_type& interpolate,
+            const size_t first_channel = 0, const buffer_edge edge = buffer_edge::clamp)
+        {
+            const auto frames { static_cast<long>(frame_count()) };
+            const auto channels { static_cast<long>(channel_count()) };
+
+            if (frames == 0 || channels == 0) {
+                for (size_t c = 0; c < output_count; ++c)
+                    std::fill_n(outputs[c], count, 0.0);
+                return;
+            }
+
+            // In chunks, first split the positions into frames and fractions in a loop without branches,
+            // which the compiler vectorizes, then gather the neighbouring samples and interpolate.
+            // All positions of a chunk are read before any output is written, so an output may be the same as the positions.
+
+            constexpr size_t chunk_size { 64 };
+            long             frame[chunk_size];
+            double           delta[chunk_size];
+
+            const auto last { frames - 1 };
+            const auto frames_as_double { static_cast<double>(frames) };
+
+            for (size_t start = 0; start < count; start += chunk_size) {
+                const auto n { std::min(chunk_size, count - start) };
+
+                if (edge == buffer_edge::wrap) {
+                    for (size_t i = 0; i < n; ++i) {
+                        const auto integral { std::floor(positions[start + i]) };
+
+                        frame[i] = static_cast<long>(integral - frames_as_double * std::floor(integral / frames_as_double));
+                        delta[i] = positions[start + i] - integral;
+                    }
+                }
+                else {
+                    for (size_t i = 0; i < n; ++i) {
+                        const auto position { std::min(std::max(positions[start + i], 0.0), static_cast<double>(last)) };
+                        const auto integral { std::floor(position) };
+
+                        frame[i] = static_cast<long>(integral);
+                        delta[i] = position - integral;
+                    }
+                }
+
+                for (size_t i = 0; i < n; ++i) {
+                    const auto f1 { frame[i] };
+                    long       f0, f2, f3;
+
+                    if (edge == buffer_edge::wrap) {
+                        f0 = f1 == 0 ? last : f1 - 1;
+                        f2 = f1 == last ? 0 : f1 + 1;
+                        f3 = f2 == last ? 0 : f2 + 1;
+                    }
+                    else {
+                        f0 = std::max(f1 - 1, 0L);
+                        f2 = std::min(f1 + 1, last);
+                        f3 = std::min(f1 + 2, last);
+                    }
+
+                    const float* x0 { m_tab + f0 * channels };
+                    const float* x1 { m_tab + f1 * channels };
+                    const float* x2 { m_tab + f2 * channels };
+                    const float* x3 { m_tab + f3 * channels };
+
+                    for (size_t c = 0; c < output_count; ++c) {
+                        const auto chan { std::min(static_cast<long>(first_channel + c), channels - 1) };
+                        outputs[c][start + i] = interpolate(x0[chan], x1[chan], x2[chan], x3[chan], delta[i]);
+                    }
+                }
+            }
+        }
+
+
+        /// Write a block of samples into one channel of the buffer~, optionally overdubbing the existing content.
+        /// Each frame is set to the input sample plus the existing content scaled by the feedback gain,
+        /// so a feedback of 0 replaces the content and a feedback of 1 mixes the input into it.
+        /// When the end of the buffer~ is reached, writing continues from the first frame.
+        /// The frames that are written are added to the modified_range() of this lock.
+        ///
+        /// @param	frame		The frame at which to start writing.
+        /// @param	input		The samples to write.
+        /// @param	count		The number of samples to write.
+        /// @param	channel		The channel into which to write.
+        /// @param	feedback	The gain applied to the existing content.
+        /// @return				The frame following the last frame written, from which the next block may be written.
+
+        size_t write(size_t frame, const sample* input, const size_t count, const size_t channel = 0, const double feedback = 0.0) {
+            const auto frames { frame_count() };
+            const auto channels { channel_count() };
+
+            if (frames == 0 || channels == 0 || count == 0)
+                return 0;
+
+            float* tab { m_tab + std::min(channel, channels - 1) };
+
+            frame %= frames;
+            for (size_t written = 0; written < count;) {
+                const auto run { std::min(count - written, frames - frame) };
+                float*     out { tab + frame * channels };
+
+                if (feedback == 0.0) {
+                    for (size_t i = 0; i < run; ++i)
+                        out[i * channels] = static_cast<float>(input[written + i]);
+                }
+                else {
+                    for (size_t i = 0; i < run; ++i)
+                        out[i * channels] = static_cast<float>(input[written + i] + out[i * channels] * feedback);
+                }
+
+                add_modified_range(frame, frame + run);
+                written += run;
+                frame = (frame + run) % frames;
+            }
+            return frame;
+        }
+
+
+        /// Determine which frames have been written using write() since this lock was obtained.
+        /// Frames changed using lookup() or the [] operator are not included.
+        /// @return	The first frame written and the frame following the last frame written.
+        ///			Both are zero if nothing has been written.
+
+        std::pair<size_t, size_t> modified_range() const {
+            if (m_modified_begin >= m_modified_end)
+                return { 0, 0 };
+            return { m_modified_begin, m_modified_end };
+        }
+
+
         /// Determine the sample rate of the buffer~ contents.
         /// @return	The buffer~ sample rate.
 
         double samplerate() const {
-            max::t_buffer_info info;
+            if constexpr (audio_thread_access)
+                return m_samplerate;
+            else {
+                max::t_buffer_info info;
 
-            max::buffer_getinfo(m_buffer_obj, &info);
-            return info.b_sr;
+                max::buffer_getinfo(m_buffer_obj, &info);
+                return info.b_sr;
+            }
         }
 
 
@@ -268,6 +656,19 @@ namespace c74::min {
         }
 
 
+        /// Mark the buffer~ as dirty only if frames have been written using write() since this lock was obtained.
+        /// Max notifies other objects about the buffer~ as a whole, so this avoids notifications, and e.g. waveform~ redraws,
+        /// for vectors in which nothing was written.
+        /// @return	True if the buffer~ was marked as dirty.
+
+        bool dirty_if_modified() {
+            if (m_modified_begin >= m_modified_end)
+                return false;
+            dirty();
+            return true;
+        }
+
+
         /// resize a buffer.
         /// only available for non-audio thread access.
         /// @param	length_in_ms	The new length to which the buffer should resize.
@@ -292,6 +693,16 @@ namespace c74::min {
         buffer_reference&  m_buffer_ref;
         max::t_buffer_obj* m_buffer_obj { nullptr };
         float*             m_tab        { nullptr };
+        size_t             m_frame_count    { 0 };      // cached for audio thread access
+        size_t             m_channel_count  { 0 };      // cached for audio thread access
+        double             m_samplerate     { 0.0 };    // cached for audio thread access
+        size_t             m_modified_begin { std::numeric_limits<size_t>::max() };
+        size_t             m_modified_end   { 0 };
+
+        void add_modified_range(const size_t begin, const size_t end) {
+            m_modified_begin = std::min(m_modified_begin, begin);
+            m_modified_end   = std::max(m_modified_end, end);
+        }
     };
 
 }    // namespace c74::min
@@ -16,6 +16,24 @@ namespace c74::min {
         m_buffer_obj = buffer_ref_getobject(m_buffer_ref.m_instance);
         m_tab        = buffer_locksamples(m_buffer_obj);
         // TODO: handle case where tab is null -- can't throw an exception in audio code...
+
+        if (!m_tab)
+            return;
+
+        auto&      cache { m_buffer_ref.m_info };
+        const auto generation { m_buffer_ref.m_info_generation.load(std::memory_order_acquire) };
+
+        if (cache.generation != generation || cache.buffer_obj != m_buffer_obj || cache.samples != m_tab) {
+            cache.buffer_obj    = m_buffer_obj;
+            cache.samples       = m_tab;
+            cache.generation    = generation;
+            cache.frame_count   = static_cast<size_t>(buffer_getframecount(m_buffer_obj));
+            cache.channel_count = static_cast<size_t>(buffer_getchannelcount(m_buffer_obj));
+            cache.samplerate    = buffer_getsamplerate(m_buffer_obj);
+        }
+        m_frame_count   = cache.frame_count;
+        m_channel_count = cache.channel_count;
+        m_samplerate    = cache.samplerate;
     }
 
     template<>
@@ -0,0 +1,269 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// The audio decoded from a file by a buffer_loader, before it is copied into the buffer~.
+    /// @ingroup buffers
+
+    struct buffer_staging {
+        vector<float>   samples;                ///< interleaved frames
+        size_t          channel_count { 1 };
+        double          samplerate { 0.0 };
+
+        size_t frame_count() const {
+            return channel_count ? samples.size() / channel_count : 0;
+        }
+    };
+
+
+    /// Fills a buffer~ from an audio file without blocking the main thread.
+    /// The file is decoded, and optionally resampled, on a background thread into a separate allocation, so that the buffer~ keeps
+    /// its previous contents in the meantime. The decoded audio is then copied into the buffer~ in the main thread, in one step between
+    /// buffer_edit_begin() and buffer_edit_end(), so objects reading the buffer~ never see it partially filled.
+    ///
+    /// Min does not include audio file decoders, so the decoding is done by a function that you provide.
+    /// It runs on the background thread and should report its progress regularly, stopping when told to.
+    ///
+    /// The notification function of the buffer_reference is called in the main thread with the progress:
+    /// `loading <fraction>` while the file is decoded, then either `loaded <filename>` or `loaderror <filename>`.
+    ///
+    /// @code
+    /// buffer_reference    m_buffer { this, MIN_FUNCTION { ... } };
+    /// buffer_loader       m_loader { m_buffer, [](const string& filename, buffer_staging& staging, const buffer_loader::progress_function& progress) {
+    ///     ... open the file and set staging.channel_count and staging.samplerate ...
+    ///     for (...) {
+    ///         ... append frames to staging.samples ...
+    ///         if (!progress(frames_read / double(frame_count)))
+    ///             return false;
+    ///     }
+    ///     return true;
+    /// }};
+    ///
+    /// m_loader.load(path);
+    /// @endcode
+    /// @ingroup buffers
+
+    class buffer_loader {
+    public:
+        /// Called by the decoder with the fraction of the file decoded so far.
+        /// Returns false if the load has been cancelled, in which case the decoder should return as soon as possible.
+
+        using progress_function = std::function<bool(double fraction)>;
+
+
+        /// Decodes a file, on the background thread.
+        /// @param	filename	The file.
+        /// @param	staging		Receives the decoded audio.
+        /// @param	progress	To be called with the fraction of the file decoded so far.
+        /// @return				True if the file was decoded.
+
+        using decode_function = std::function<bool(const string& filename, buffer_staging& staging, const progress_function& progress)>;
+
+
+        /// Create a loader.
+        /// @param	a_buffer	The buffer reference to fill.
+        /// @param	a_decoder	The function that decodes files.
+
+        buffer_loader(buffer_reference& a_buffer, const decode_function& a_decoder)
+        : m_buffer { a_buffer }
+        , m_decoder { a_decoder }
+        , m_events { nullptr, [this](const event& e) { handle(e); } }
+        {}
+
+
+        ~buffer_loader() {
+            cancel();
+        }
+
+
+        buffer_loader(const buffer_loader&) = delete;
+        buffer_loader& operator=(const buffer_loader&) = delete;
+
+
+        /// Start loading a file, cancelling the load in progress if there is one. Must be called in the main thread.
+        /// @param	filename	The absolute path of the file.
+        /// @param	samplerate	The samplerate to convert the file to, or 0 to keep the samplerate of the file.
+
+        void load(const string& filename, const double samplerate = 0.0) {
+            cancel();
+
+            m_filename  = filename;
+            m_cancelled = false;
+            m_loading   = true;
+            m_thread    = std::thread { &buffer_loader::run, this, ++m_generation, samplerate };
+        }
+
+
+        /// Stop the load in progress, leaving the buffer~ as it is. Waits for the decoder to return.
+
+        void cancel() {
+            m_cancelled = true;
+            if (m_thread.joinable())
+                m_thread.join();
+            m_loading = false;
+            m_staging = {};
+        }
+
+
+        /// Is a file being loaded?
+        /// @return	True from load() until the buffer~ has been filled, or the load has failed or been cancelled.
+
+        bool loading() const {
+            return m_loading;
+        }
+
+
+        /// Copy audio into a buffer~, resized to fit, while the buffer~ is locked for editing. Must be called in the main thread.
+        /// @param	a_buffer	The buffer reference whose buffer~ is filled.
+        /// @param	staging		The audio.
+        /// @return				True if the buffer~ was filled.
+
+        static bool fill(buffer_reference& a_buffer, const buffer_staging& staging) {
+            auto buffer_obj { a_buffer.m_instance ? max::buffer_ref_getobject(a_buffer.m_instance) : nullptr };
+            if (!buffer_obj)
+                return false;
+
+            atoms size { static_cast<long>(staging.frame_count()), static_cast<long>(staging.channel_count) };
+            atoms samplerate { staging.samplerate };
+
+            max::buffer_edit_begin(buffer_obj);
+            max::object_method_typed(buffer_obj, max::gensym("sizeinsamps"), static_cast<long>(size.size()), &size[0], nullptr);
+            if (staging.samplerate > 0.0)
+                max::object_method_typed(buffer_obj, max::gensym("sr"), 1, &samplerate[0], nullptr);
+
+            max::t_buffer_info info;
+            max::buffer_getinfo(buffer_obj, &info);
+
+            const auto ok { info.b_samples && static_cast<size_t>(info.b_frames) == staging.frame_count()
+                && static_cast<size_t>(info.b_nchans) == staging.channel_count };
+
+            if (ok)
+                std::copy(staging.samples.begin(), staging.samples.end(), info.b_samples);
+            max::buffer_edit_end(buffer_obj, ok);
+            if (ok)
+                max::buffer_setdirty(buffer_obj);
+            return ok;
+        }
+
+
+        /// Copy the audio of a buffer~.
+        /// @param	a_buffer	The buffer reference whose buffer~ is read.
+        /// @param	staging		Receives the audio.
+        /// @return				True if the buffer reference has a buffer~.
+
+        static bool read(buffer_reference& a_buffer, buffer_staging& staging) {
+            buffer_lock<false> b { a_buffer };
+
+            staging = {};
+            if (!b.valid())
+                return false;
+
+            staging.channel_count = b.channel_count();
+            staging.samplerate    = b.samplerate();
+            staging.samples.assign(&b[0], &b[0] + b.frame_count() * b.channel_count());
+            return true;
+        }
+
+    private:
+        enum class event_type { progress, done, failed };
+
+        struct event {
+            event_type  type { event_type::progress };
+            unsigned    generation { 0 };    ///< the load that sent the event
+            double      fraction { 0.0 };
+        };
+
+        buffer_reference&       m_buffer;
+        const decode_function   m_decoder;
+        data_queue<event>       m_events;
+        string                  m_filename;
+        buffer_staging          m_staging;      ///< written by the background thread until it sends done or failed
+        std::atomic<bool>       m_cancelled { false };
+        bool                    m_loading { false };
+        unsigned                m_generation { 0 };     ///< counts the loads, so that events of a cancelled load are ignored
+        std::thread             m_thread;
+
+
+        void run(const unsigned generation, const double samplerate) {
+            double reported { 0.0 };
+
+            const auto progress = [this, &reported, generation](const double fraction) {
+                // progress is reported in steps of 1% so that a decoder may call this for every block
+                if (fraction - reported >= 0.01) {
+                    reported = fraction;
+                    m_events.push({ event_type::progress, generation, fraction });
+                }
+                return !m_cancelled.load();
+            };
+
+            m_staging = {};
+            auto ok { m_decoder(m_filename, m_staging, progress) && !m_cancelled && m_staging.channel_count > 0 };
+
+            if (ok && samplerate > 0.0 && m_staging.samplerate > 0.0 && samplerate != m_staging.samplerate)
+                resample(samplerate);
+
+            // the final event must arrive, so wait for the main thread rather than dropping it
+            while (!m_events.push({ ok ? event_type::done : event_type::failed, generation, 1.0 }) && !m_cancelled)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+
+        // linear interpolation, which is adequate for previewing and for files that are close to the target samplerate
+
+        void resample(const double samplerate) {
+            const auto channels { m_staging.channel_count };
+            const auto frames { m_staging.frame_count() };
+            const auto ratio { m_staging.samplerate / samplerate };
+            const auto new_frames { static_cast<size_t>(frames / ratio) };
+            vector<float> resampled(new_frames * channels);
+
+            for (size_t i = 0; i < new_frames && frames > 0; ++i) {
+                const auto position { i * ratio };
+                const auto index { std::min(static_cast<size_t>(position), frames - 1) };
+                const auto next { std::min(index + 1, frames - 1) };
+                const auto delta { static_cast<float>(position - index) };
+
+                for (size_t c = 0; c < channels; ++c) {
+                    const auto a { m_staging.samples[index * channels + c] };
+                    const auto b { m_staging.samples[next * channels + c] };
+                    resampled[i * channels + c] = a + (b - a) * delta;
+                }
+            }
+            m_staging.samples.swap(resampled);
+            m_staging.samplerate = samplerate;
+        }
+
+
+        void handle(const event& e) {
+            if (!m_loading || e.generation != m_generation)
+                return;    // an event of a cancelled load
+
+            if (e.type == event_type::progress) {
+                report({ symbol("loading"), e.fraction });
+                return;
+            }
+
+            m_thread.join();
+            m_loading = false;
+
+            const auto ok { e.type == event_type::done && fill(m_buffer, m_staging) };
+
+            m_staging = {};
+            report({ symbol(ok ? "loaded" : "loaderror"), symbol(m_filename) });
+        }
+
+
+        void report(const atoms& args) {
+            if (m_buffer.m_notification_callback)
+                m_buffer.m_notification_callback(args, -1);
+        }
+    };
+
+
+}    // namespace c74::min
@@ -0,0 +1,203 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// Content of a buffer~ that is edited live while the audio thread reads it, e.g. a wavetable or an impulse response.
+    ///
+    /// The audio thread reads a copy of the buffer~ held by the buffer_swap instead of the buffer~ itself.
+    /// An edit is made on a background thread to a new copy, which the audio thread swaps in at the start of its next vector,
+    /// so the audio thread neither waits for the edit nor reads content that is partially edited.
+    /// The copy that is swapped out is freed in the main thread.
+    ///
+    /// After each edit the new content is also copied into the buffer~ in the main thread, as by buffer_loader,
+    /// so that it is displayed and saved with the buffer~. The notification function of the buffer_reference is then called with `swapped`.
+    /// Changes made to the buffer~ by other objects are read by calling refresh(), e.g. from that notification function.
+    ///
+    /// @code
+    /// buffer_reference    m_buffer { this };
+    /// buffer_swap         m_table { m_buffer };
+    ///
+    /// // in the main thread
+    /// m_table.edit([gain](buffer_staging& content) {
+    ///     for (auto& x : content.samples)
+    ///         x *= gain;
+    ///     return true;
+    /// });
+    ///
+    /// // in the audio thread, once at the start of each vector
+    /// if (auto table = m_table.acquire())
+    ///     ... read table->samples ...
+    /// @endcode
+    /// @ingroup buffers
+
+    class buffer_swap {
+    public:
+        /// Edits a copy of the content, on the background thread.
+        /// @param	content	The copy, which starts as the content of the latest edit.
+        /// @return			True to swap the copy in, false to discard it along with the edits made together with it.
+
+        using edit_function = std::function<bool(buffer_staging& content)>;
+
+
+        /// Create a buffer swap.
+        /// @param	a_buffer	The buffer reference whose buffer~ is edited.
+        /// @param	write_back	True to copy the content of each edit into the buffer~.
+
+        explicit buffer_swap(buffer_reference& a_buffer, const bool write_back = true)
+        : m_buffer { a_buffer }
+        , m_write_back { write_back }
+        , m_events { nullptr, [this](const bool& ok) { handle(ok); } }
+        , m_retired { nullptr, [](buffer_staging* const& content) { delete content; } }
+        {}
+
+
+        ~buffer_swap() {
+            if (m_thread.joinable())
+                m_thread.join();
+            m_retired.deliver();
+            delete m_pending.exchange(nullptr);
+            delete m_retiring;
+            delete m_current;
+        }
+
+
+        buffer_swap(const buffer_swap&) = delete;
+        buffer_swap& operator=(const buffer_swap&) = delete;
+
+
+        /// Copy the buffer~ into a new content for the audio thread, e.g. after it has been changed by another object
+        /// or the buffer_reference has been set to another buffer~. Must be called in the main thread.
+        /// Waits for an edit that is in progress, which is then followed by the content of the buffer~.
+
+        void refresh() {
+            if (m_thread.joinable())
+                m_thread.join();
+
+            auto content { new buffer_staging };
+            buffer_loader::read(m_buffer, *content);
+            publish(content);
+        }
+
+
+        /// Edit the content on the background thread. Must be called in the main thread.
+        /// Edits made while an edit is in progress are made together after it, to one copy.
+        /// @param	f	The edit.
+
+        void edit(const edit_function& f) {
+            m_queued.push_back(f);
+            if (!m_editing)
+                start();
+        }
+
+
+        /// Is an edit in progress?
+        /// @return	True from edit() until the content of the last edit has been swapped in or discarded.
+
+        bool editing() const {
+            return m_editing;
+        }
+
+
+        /// The content to read in this vector. Must be called in the audio thread, once at the start of each vector,
+        /// and the content must not be used after the next call. It neither allocates nor takes a lock.
+        /// @return	The content of the latest edit or refresh(), or nullptr if there has been neither.
+
+        const buffer_staging* acquire() {
+            // a swapped out content that could not be handed to the main thread waits, and so does the next swap
+            if (m_retiring && m_retired.push(m_retiring))
+                m_retiring = nullptr;
+
+            if (!m_retiring) {
+                if (auto next = m_pending.exchange(nullptr, std::memory_order_acq_rel)) {
+                    m_retiring = m_current;
+                    m_current  = next;
+                    if (m_retiring && m_retired.push(m_retiring))
+                        m_retiring = nullptr;
+                }
+            }
+            return m_current;
+        }
+
+    private:
+        buffer_reference&               m_buffer;
+        const bool                      m_write_back;
+        data_queue<bool>                m_events;               ///< the background thread reports the end of an edit to the main thread
+        data_queue<buffer_staging*>     m_retired;              ///< the audio thread hands the contents it swapped out to the main thread
+        std::atomic<buffer_staging*>    m_pending { nullptr };  ///< published and not yet swapped in by the audio thread
+        buffer_staging*                 m_current { nullptr };  ///< audio thread only
+        buffer_staging*                 m_retiring { nullptr }; ///< audio thread only
+        const buffer_staging*           m_latest { nullptr };   ///< the content most recently published, which edits start from
+        const buffer_staging*           m_edited { nullptr };   ///< the content published by the latest edit
+        vector<edit_function>           m_queued;               ///< main thread only
+        vector<edit_function>           m_running;              ///< read by the background thread during an edit
+        bool                            m_editing { false };
+        std::thread                     m_thread;
+
+
+        // The latest content stays allocated while it is copied on the background thread:
+        // it is only swapped out when a newer content is swapped in, and there is none until the edit or a refresh() publishes one.
+
+        void start() {
+            if (!m_latest)
+                refresh();
+
+            m_running.swap(m_queued);
+            m_queued.clear();
+            m_editing = true;
+            m_thread  = std::thread { [this]() {
+                auto content { new buffer_staging(*m_latest) };
+                auto ok { true };
+
+                for (const auto& f : m_running)
+                    ok = f(*content) && ok;
+
+                if (ok) {
+                    m_edited = content;
+                    publish(content);
+                }
+                else
+                    delete content;
+
+                // the event must arrive, so wait for the main thread rather than dropping it
+                while (!m_events.push(ok))
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }};
+        }
+
+
+        // A published content that the audio thread did not swap in before the next one is freed here,
+        // as the audio thread has never seen it.
+
+        void publish(buffer_staging* content) {
+            m_latest = content;
+            delete m_pending.exchange(content, std::memory_order_acq_rel);
+        }
+
+
+        // refresh() may have joined the thread already, and published the buffer~ after the edit
+
+        void handle(const bool ok) {
+            if (m_thread.joinable())
+                m_thread.join();
+            m_running.clear();
+            m_editing = false;
+
+            if (ok && m_write_back && m_latest == m_edited) {
+                buffer_loader::fill(m_buffer, *m_latest);
+                if (m_buffer.m_notification_callback)
+                    m_buffer.m_notification_callback({ symbol("swapped") }, -1);
+            }
+
+            if (!m_queued.empty())
+                start();
+        }
+    };
+
+
+}    // namespace c74::min
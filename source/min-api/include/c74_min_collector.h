@@ -0,0 +1,183 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A lock-free collection of items that any number of threads append to, and one thread takes out all at once,
+    /// e.g. atoms that arrive from both the main and the scheduler thread and are output as a single list.
+    ///
+    /// The items are stored in a chain of segments. A producer claims room in the current segment with one atomic addition,
+    /// so producers never wait for each other. When a segment is full the producer chains a new one to it,
+    /// which is the only time a producer allocates memory.
+    /// The consumer swaps the whole chain for an empty segment in one step, waits for producers that are still
+    /// writing to the old chain to finish, and then owns it. Items that fit into one segment are handed out in place,
+    /// without copying them, and the segment is kept for the next swap.
+    ///
+    /// @tparam	T	The type of the items.
+
+    template<class T>
+    class collector {
+    public:
+
+        /// Create a collector.
+        /// @param	segment_capacity	The number of items in a segment. More than this can be collected, but then the items are
+        ///								spread across several segments, which need to be allocated and joined when taken out.
+
+        explicit collector(const size_t segment_capacity = 1024)
+        : m_segment_capacity { std::max<size_t>(segment_capacity, 1) }
+        , m_current { new segment(m_segment_capacity) }
+        , m_spare { new segment(m_segment_capacity) }
+        {}
+
+
+        ~collector() {
+            free_chain(m_current.load());
+            delete m_spare;
+        }
+
+
+        collector(const collector&) = delete;
+        collector& operator=(const collector&) = delete;
+
+
+        /// Append items. May be called from any number of threads at the same time.
+        /// @param	items	The items.
+        /// @param	count	The number of items.
+
+        void append(const T* items, const size_t count) {
+            if (count == 0)
+                return;
+
+            // register with the current epoch, so that the consumer can wait for this append to finish
+            for (;;) {
+                const auto epoch { m_epoch.load() };
+                m_active[epoch].fetch_add(1);
+                if (m_epoch.load() == epoch) {
+                    append_to_chain(items, count);
+                    m_active[epoch].fetch_sub(1);
+                    return;
+                }
+                m_active[epoch].fetch_sub(1);
+            }
+        }
+
+
+        /// Take out all items collected so far, in the order they were appended, and leave the collection empty.
+        /// Only one thread may take items out at a time.
+        /// @param	consume	A function that is called with a vector of all items. It may modify the vector or swap it with its own,
+        ///					but must not keep a reference to it.
+        ///					It is not called if there are no items.
+
+        template<class F>
+        void take(F&& consume) {
+            // swap the chain for the spare segment, and wait for appends that may still be writing to the old chain
+            auto chain { m_current.exchange(m_spare) };
+            const auto epoch { m_epoch.load() };
+            m_epoch.store(1 - epoch);
+            while (m_active[epoch].load() != 0)
+                std::this_thread::yield();
+
+            if (!chain->prev) {
+                m_spare = chain;
+                const auto count { chain->count() };
+                if (count) {
+                    chain->items.resize(count);
+                    consume(chain->items);
+                }
+                chain->reset();
+                return;
+            }
+
+            // the items are spread across several segments, from the newest back to the oldest
+            m_gathered.clear();
+            gather(chain);
+            m_spare = new segment(m_segment_capacity);
+            free_chain(chain);
+            if (!m_gathered.empty())
+                consume(m_gathered);
+        }
+
+    private:
+        struct segment {
+            explicit segment(const size_t a_capacity)
+            : capacity { a_capacity }
+            , items(a_capacity)
+            {}
+
+            // the claims that fit into the segment are contiguous from the start:
+            // they end where the first claim that does not fit begins
+
+            size_t count() const {
+                const auto e { end.load() };
+                return e != k_open ? e : std::min(claimed.load(), capacity);
+            }
+
+            void reset() {
+                items.resize(capacity);
+                claimed = 0;
+                end     = k_open;
+                prev    = nullptr;
+            }
+
+            const size_t        capacity;
+            vector<T>           items;
+            std::atomic<size_t> claimed { 0 };
+            std::atomic<size_t> end { k_open };
+            segment*            prev { nullptr };    ///< the segment that was filled before this one
+        };
+
+        static constexpr size_t k_open { std::numeric_limits<size_t>::max() };
+
+        void append_to_chain(const T* items, const size_t count) {
+            auto s { m_current.load() };
+
+            for (;;) {
+                const auto start { s->claimed.fetch_add(count) };
+                if (start + count <= s->capacity) {
+                    std::copy_n(items, count, s->items.begin() + start);
+                    return;
+                }
+
+                // exactly one claim crosses the end of the segment, and it marks where the items of the segment end
+                if (start <= s->capacity)
+                    s->end.store(start);
+
+                // any producer that finds the segment full may chain the next one; the others use it
+                auto next { new segment(std::max(m_segment_capacity, 2 * count)) };
+                next->prev = s;
+                if (m_current.compare_exchange_strong(s, next))
+                    s = next;
+                else
+                    delete next;
+            }
+        }
+
+        void gather(const segment* s) {
+            if (s->prev)
+                gather(s->prev);
+            m_gathered.insert(m_gathered.end(), s->items.begin(), s->items.begin() + s->count());
+        }
+
+        static void free_chain(segment* s) {
+            while (s) {
+                auto prev { s->prev };
+                delete s;
+                s = prev;
+            }
+        }
+
+        const size_t            m_segment_capacity;
+        std::atomic<segment*>   m_current;
+        segment*                m_spare;          ///< only used by the consumer
+        vector<T>               m_gathered;       ///< only used by the consumer
+        std::atomic<int>        m_epoch { 0 };
+        std::atomic<int>        m_active[2] { {0}, {0} };
+    };
+
+
+}    // namespace c74::min
@@ -7,15 +7,104 @@
 
 namespace c74::min::dataspace {
 
-    const double k_gain_midi_power { log(pow(10.0, 10.0 / 20.0)) / log(127.0 / 100.0) };
-    const double k_gain_midi_power_r { 1.0 / k_gain_midi_power };
+    // Natural logarithms used by the units, written out so that they can be used in constant expressions.
+
+    constexpr double k_ln2    { 0.6931471805599453 };
+    constexpr double k_ln10   { 2.302585092994046 };
+    constexpr double k_ln60   { 4.0943445622221 };
+    constexpr double k_ln440  { 6.0867747269123065 };
+    constexpr double k_ln1_27 { 0.23901690047049992 };
+
+    constexpr double k_gain_midi_power { 0.5 * k_ln10 / k_ln1_27 };    // log(pow(10.0, 10.0 / 20.0)) / log(127.0 / 100.0)
+    constexpr double k_gain_midi_power_r { 1.0 / k_gain_midi_power };
+
+
+    /// Describes a unit whose logarithm is an affine function of the neutral unit's logarithm.
+    /// For an exponential unit (e.g. decibels or midi pitch) log(neutral) = offset + factor * x.
+    /// For a power unit (e.g. milliseconds or hertz) log(neutral) = offset + factor * log(x).
+    /// A unit declares it as a static k_log_affine member, and conversions between two such units,
+    /// at least one of them exponential, are then fused into a single transform with constant coefficients.
+
+    struct log_affine {
+        bool    exponential;
+        double  offset;
+        double  factor;
+        double  lowest { -std::numeric_limits<double>::infinity() };    // the lowest value converted to this unit
+    };
+
 
     class dataspace_base {
+
+        template<class unit_type, class = void>
+        struct has_log_affine : std::false_type {};
+
+        template<class unit_type>
+        struct has_log_affine<unit_type, std::void_t<decltype(unit_type::k_log_affine)>> : std::true_type {};
+
+        // log(neutral) is the same for the source value x and the destination value y, so
+        // y' = (source.offset - dest.offset) / dest.factor + source.factor / dest.factor * x'
+        // where x' and y' are the value or its logarithm, depending on the kind of unit.
+        // Two power units are left to the chain, which is a multiplication or a division for all but the midi gain.
+
+        template<class source_unit_type, class dest_unit_type, bool = has_log_affine<source_unit_type>::value && has_log_affine<dest_unit_type>::value>
+        struct fused {
+            static constexpr bool value { false };
+        };
+
+        template<class source_unit_type, class dest_unit_type>
+        struct fused<source_unit_type, dest_unit_type, true> {
+            static constexpr log_affine source { source_unit_type::k_log_affine };
+            static constexpr log_affine dest { dest_unit_type::k_log_affine };
+
+            static constexpr bool   value { source.exponential || dest.exponential };
+            static constexpr double offset { (source.offset - dest.offset) / dest.factor };
+            static constexpr double factor { source.factor / dest.factor };
+
+            static inline number convert(const number x) {
+                number y;
+
+                if constexpr (source.exponential)
+                    y = offset + factor * x;
+                else
+                    y = offset + factor * std::log(x);
+
+                if constexpr (!dest.exponential)
+                    y = std::exp(y);
+                if constexpr (dest.lowest > -std::numeric_limits<double>::infinity())
+                    y = std::max(y, dest.lowest);
+                return y;
+            }
+        };
+
     public:
         // TODO: error checking -- can we do a static_assert that both source and dest are defined in the same dataspace?
+
+        /// Convert a value from one unit to another.
+        /// This is a constant expression if the conversion is arithmetic (e.g. from milliseconds to hertz).
+        /// Conversions between exponential units (e.g. from midi pitch to cents) take a multiply-add,
+        /// and between an exponential unit and a power unit (e.g. from midi pitch to hertz) a single log or exp.
+        /// @param x    The value in the source unit.
+        /// @return     The value in the destination unit.
+
+        template<class source_unit_type, class dest_unit_type>
+        static constexpr number convert(const number x) {
+            if constexpr (std::is_same<source_unit_type, dest_unit_type>::value)
+                return x;
+            else if constexpr (fused<source_unit_type, dest_unit_type>::value)
+                return fused<source_unit_type, dest_unit_type>::convert(x);
+            else
+                return dest_unit_type::from_neutral(source_unit_type::to_neutral(x));
+        }
+
+        /// Convert a block of values, e.g. one vector of a meter or of gain automation.
+        /// The conversion is inlined into a single loop; input and output may be the same buffer.
+        /// @param input    Pointer to count values in the source unit.
+        /// @param output   Pointer to space for count values in the destination unit.
+        /// @param count    The number of values to convert.
         template<class source_unit_type, class dest_unit_type>
-        static inline number convert(const number x) {
-            return dest_unit_type::from_neutral(source_unit_type::to_neutral(x));
+        static inline void convert(const number* input, number* output, const size_t count) {
+            for (auto i = 0u; i < count; ++i)
+                output[i] = convert<source_unit_type, dest_unit_type>(input[i]);
         }
     };
 
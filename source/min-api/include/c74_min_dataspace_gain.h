@@ -13,11 +13,13 @@ namespace c74::min::dataspace {
         class linear {
             friend class dataspace_base;
 
-            static inline number to_neutral(const number input) {
+            static constexpr log_affine k_log_affine { false, 0.0, 1.0 };
+
+            static constexpr number to_neutral(const number input) {
                 return input;
             }
 
-            static inline number from_neutral(const number input) {
+            static constexpr number from_neutral(const number input) {
                 return input;
             }
         };
@@ -26,6 +28,8 @@ namespace c74::min::dataspace {
         class midi {
             friend class dataspace_base;
 
+            static constexpr log_affine k_log_affine { false, -2.0 * k_ln10 * k_gain_midi_power, k_gain_midi_power };
+
             static inline number to_neutral(const number input) {
                 return pow(input * 0.01, k_gain_midi_power);
             }
@@ -39,6 +43,8 @@ namespace c74::min::dataspace {
         class db {
             friend class dataspace_base;
 
+            static constexpr log_affine k_log_affine { true, 0.0, k_ln10 / 20.0, -144.49 };
+
             static inline number to_neutral(const number input) {
                 return pow(10.0, input * 0.05);
             }
@@ -48,8 +54,8 @@ namespace c74::min::dataspace {
 
                 // Output decibel range is limited to 24 bit range, avoids problems with singularities (-inf) when using
                 // dataspace in ramps
-                if (temp < -144.49)
-                    temp = -144.49;
+                if (temp < k_log_affine.lowest)
+                    temp = k_log_affine.lowest;
                 return temp;
             }
         };
@@ -13,11 +13,13 @@ namespace c74::min::dataspace {
         class seconds {
             friend class dataspace_base;
 
-            static inline number to_neutral(const number input) {
+            static constexpr log_affine k_log_affine { false, 0.0, 1.0 };
+
+            static constexpr number to_neutral(const number input) {
                 return input;
             }
 
-            static inline number from_neutral(const number input) {
+            static constexpr number from_neutral(const number input) {
                 return input;
             }
         };
@@ -41,12 +43,14 @@ namespace c74::min::dataspace {
         class bpm {
             friend class dataspace_base;
 
-            static inline number to_neutral(const number input) {
+            static constexpr log_affine k_log_affine { false, k_ln60, -1.0 };
+
+            static constexpr number to_neutral(const number input) {
                 // TODO: prevent division with zero
                 return 60.0 / double(input);
             }
 
-            static inline number from_neutral(const number input) {
+            static constexpr number from_neutral(const number input) {
                 // TODO: prevent division with zero
                 return 60.0 / double(input);
             }
@@ -56,6 +60,8 @@ namespace c74::min::dataspace {
         class cents {
             friend class dataspace_base;
 
+            static constexpr log_affine k_log_affine { true, 6900.0 / 1200.0 * k_ln2 - k_ln440, -k_ln2 / 1200.0 };
+
             static inline number to_neutral(const number input) {
                 return 1.0 / (440.0 * pow(2.0, (double(input) - 6900.0) / 1200.0));
             }
@@ -69,12 +75,14 @@ namespace c74::min::dataspace {
         class hertz {
             friend class dataspace_base;
 
-            static inline number to_neutral(const number input) {
+            static constexpr log_affine k_log_affine { false, 0.0, -1.0 };
+
+            static constexpr number to_neutral(const number input) {
                 // TODO: prevent division with zero
                 return 1.0 / double(input);
             }
 
-            static inline number from_neutral(const number input) {
+            static constexpr number from_neutral(const number input) {
                 // TODO: prevent division with zero
                 return 1.0 / double(input);
             }
@@ -99,6 +107,8 @@ namespace c74::min::dataspace {
         class midi {
             friend class dataspace_base;
 
+            static constexpr log_affine k_log_affine { true, 69.0 / 12.0 * k_ln2 - k_ln440, -k_ln2 / 12.0 };
+
             static inline number to_neutral(const number input) {
                 return 1. / (440.0 * pow(2.0, (double(input) - 69.0) / 12.0));
             }
@@ -114,11 +124,13 @@ namespace c74::min::dataspace {
         class milliseconds {
             friend class dataspace_base;
 
-            static inline number to_neutral(const number input) {
+            static constexpr log_affine k_log_affine { false, -3.0 * k_ln10, 1.0 };
+
+            static constexpr number to_neutral(const number input) {
                 return input * 0.001;
             }
 
-            static inline number from_neutral(const number input) {
+            static constexpr number from_neutral(const number input) {
                 return input * 1000.0;
             }
         };
@@ -144,6 +156,8 @@ namespace c74::min::dataspace {
         class speed {
             friend class dataspace_base;
 
+            static constexpr log_affine k_log_affine { false, 69.0 / 12.0 * k_ln2 - k_ln440, -1.0 };
+
             static inline number to_neutral(const number input) {
                 // Here's one way of converting:
                 //
@@ -0,0 +1,159 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define C74_MIN_DENORMALS_SSE
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_FP))
+    #define C74_MIN_DENORMALS_ARM
+#endif
+
+namespace c74::min {
+
+
+    /// Flush denormal numbers to zero on the calling thread for the lifetime of this object, e.g. during a call of a perform routine.
+    ///
+    /// Recursive filters decay into denormal numbers after their input falls silent,
+    /// and on many processors arithmetic with them is ten to a hundred times slower.
+    /// With flushing these results become zero instead.
+    ///
+    /// On x86 this sets the flush-to-zero and denormals-are-zero flags of the SSE control register,
+    /// on ARM the flush-to-zero flag of the floating-point control register.
+    /// On other processors (and with MSVC for ARM) it does nothing.
+    /// The previous flags are restored when the object is destroyed, so it may be nested.
+    ///
+    /// The wrapper of each audio object flushes denormals during its perform routine,
+    /// unless the class declares `MIN_FLUSH_DENORMALS { false };`.
+    /// @tparam	enabled		False for a guard that does nothing.
+
+    template<bool enabled = true>
+    class denormal_guard {
+    public:
+        /// True if the guard flushes denormals on this processor.
+
+#if defined(C74_MIN_DENORMALS_SSE) || (defined(C74_MIN_DENORMALS_ARM) && !defined(_MSC_VER))
+        static constexpr bool supported { enabled };
+#else
+        static constexpr bool supported { false };
+#endif
+
+        denormal_guard() {
+            if constexpr (supported) {
+                m_previous = read();
+                if ((m_previous & k_flags) != k_flags)
+                    write(m_previous | k_flags);
+            }
+        }
+
+        ~denormal_guard() {
+            if constexpr (supported) {
+                if ((m_previous & k_flags) != k_flags)
+                    write(m_previous);
+            }
+        }
+
+        denormal_guard(const denormal_guard&) = delete;
+        denormal_guard& operator=(const denormal_guard&) = delete;
+
+    private:
+#if defined(C74_MIN_DENORMALS_SSE)
+        using control_register = unsigned int;
+
+        static constexpr control_register k_flags { 0x8040 };    // flush-to-zero (bit 15) and denormals-are-zero (bit 6)
+
+        static control_register read() {
+            return _mm_getcsr();
+        }
+
+        static void write(const control_register value) {
+            _mm_setcsr(value);
+        }
+#elif defined(C74_MIN_DENORMALS_ARM) && defined(__aarch64__) && !defined(_MSC_VER)
+        using control_register = uint64_t;
+
+        static constexpr control_register k_flags { 1 << 24 };    // flush-to-zero
+
+        static control_register read() {
+            control_register value;
+            __asm__ __volatile__("mrs %0, fpcr" : "=r"(value));
+            return value;
+        }
+
+        static void write(const control_register value) {
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(value));
+        }
+#elif defined(C74_MIN_DENORMALS_ARM) && !defined(_MSC_VER)
+        using control_register = uint32_t;
+
+        static constexpr control_register k_flags { 1 << 24 };    // flush-to-zero
+
+        static control_register read() {
+            control_register value;
+            __asm__ __volatile__("vmrs %0, fpscr" : "=r"(value));
+            return value;
+        }
+
+        static void write(const control_register value) {
+            __asm__ __volatile__("vmsr fpscr, %0" : : "r"(value));
+        }
+#else
+        using control_register = unsigned int;
+
+        static constexpr control_register k_flags { 0 };
+
+        static control_register read() {
+            return 0;
+        }
+
+        static void write(const control_register) {}
+#endif
+
+        control_register m_previous {};
+    };
+
+
+    /// Declare whether the wrapper flushes denormals to zero while your class performs (see denormal_guard).
+    /// This is the default; declare `MIN_FLUSH_DENORMALS { false };` in your class
+    /// if its audio processing depends on denormal numbers.
+
+    #define MIN_FLUSH_DENORMALS static constexpr bool class_flush_denormals
+
+
+    // SFINAE implementation used internally to determine if the Min class has
+    // declared whether denormals are flushed using the macro above.
+
+    template<typename min_class_type>
+    struct has_class_flush_denormals {
+        template<class, class>
+        class checker;
+
+        template<typename C>
+        static std::true_type test(checker<C, decltype(&C::class_flush_denormals)>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
+    // Used internally.
+    // Returns true if denormals are flushed while the Min class performs.
+
+    template<class min_class_type>
+    constexpr typename enable_if<has_class_flush_denormals<min_class_type>::value, bool>::type class_flushes_denormals() {
+        return min_class_type::class_flush_denormals;
+    }
+
+    template<class min_class_type>
+    constexpr typename enable_if<!has_class_flush_denormals<min_class_type>::value, bool>::type class_flushes_denormals() {
+        return true;
+    }
+
+
+}    // namespace c74::min
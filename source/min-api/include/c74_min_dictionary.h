@@ -87,6 +87,249 @@ namespace c74::min {
         }
 
 
+        /// Determine if the dictionary has an entry for a key.
+        /// Unlike operator[] this does not create the entry.
+        /// @param	key	The key.
+        /// @return		True if the key exists.
+
+        bool contains(const symbol key) const {
+            return max::dictionary_hasentry(m_instance, key);
+        }
+
+
+        /// Return the keys of all entries.
+        /// @return	The keys, in the order of the entries.
+
+        std::vector<symbol> keys() const {
+            long            count {};
+            max::t_symbol** keys {};
+
+            max::dictionary_getkeys(m_instance, &count, &keys);
+            std::vector<symbol> result(keys, keys + count);
+            if (keys)
+                max::dictionary_freekeys(m_instance, count, keys);
+            return result;
+        }
+
+
+        /// Return the number of entries.
+        /// @return	The number of entries.
+
+        std::size_t size() const {
+            return static_cast<std::size_t>(max::dictionary_getentrycount(m_instance));
+        }
+
+
+        /// Determine if an entry holds the same atoms as the entry with the same key in another dictionary.
+        /// Entries that hold dictionaries or arrays are never the same, as only their references could be compared cheaply.
+        /// @param	key		The key.
+        /// @param	other	The other dictionary.
+        /// @return			True if both dictionaries have the entry and its atoms are equal.
+
+        bool same_entry(const symbol key, const dict& other) const {
+            long         ac {}, other_ac {};
+            max::t_atom* av {};
+            max::t_atom* other_av {};
+
+            if (max::dictionary_getatoms(m_instance, key, &ac, &av) || max::dictionary_getatoms(other.m_instance, key, &other_ac, &other_av))
+                return false;
+            if (ac != other_ac)
+                return false;
+            for (auto i = 0; i < ac; ++i) {
+                if (av[i].a_type != other_av[i].a_type)
+                    return false;
+                switch (av[i].a_type) {
+                    case max::A_LONG:
+                        if (av[i].a_w.w_long != other_av[i].a_w.w_long)
+                            return false;
+                        break;
+                    case max::A_FLOAT:
+                        if (av[i].a_w.w_float != other_av[i].a_w.w_float)
+                            return false;
+                        break;
+                    case max::A_SYM:
+                        if (av[i].a_w.w_sym != other_av[i].a_w.w_sym)
+                            return false;
+                        break;
+                    default:
+                        return false;
+                }
+            }
+            return true;
+        }
+
+
+        /// Copy entries from another dictionary, replacing entries with the same keys.
+        /// Entries that hold dictionaries or arrays are copied deeply.
+        /// @param	source	The dictionary to copy from.
+        /// @param	keys	The keys of the entries to copy.
+
+        void copy_entries(const dict& source, const std::vector<symbol>& keys) {
+            if (keys.empty())
+                return;
+
+            std::vector<max::t_symbol*> terminated_keys;    // the api expects a null-terminated array
+            terminated_keys.reserve(keys.size() + 1);
+            for (const auto& key : keys) {
+                terminated_keys.push_back(key);
+                max::dictionary_deleteentry(m_instance, key);
+            }
+            terminated_keys.push_back(nullptr);
+            max::dictionary_copyentries(source.m_instance, m_instance, terminated_keys.data());
+        }
+
+
+        /// Return the first atom of an entry converted to a type, without creating the entry or an atoms container.
+        /// @tparam	T				The type of the value, e.g. double, int or symbol.
+        /// @param	key				The key.
+        /// @param	default_value	The value to return if there is no entry or the entry is empty.
+        /// @return					The value.
+
+        template<class T>
+        T get(const symbol key, const T& default_value = T{}) const {
+            long         ac {};
+            max::t_atom* av {};
+
+            if (max::dictionary_getatoms(m_instance, key, &ac, &av) || ac == 0)
+                return default_value;
+            return convert<T>(av[0]);
+        }
+
+
+        /// Copy the atoms of an entry converted to numbers straight into a buffer.
+        /// The atoms are read where the dictionary keeps them, so nothing is allocated.
+        /// @tparam	T			A number type.
+        /// @param	key			The key.
+        /// @param	output		The buffer.
+        /// @param	capacity	The number of values that fit into the buffer.
+        /// @return				The number of values copied, which is 0 if there is no entry.
+
+        template<class T>
+        std::size_t get(const symbol key, T* output, const std::size_t capacity) const {
+            static_assert(std::is_arithmetic<T>::value, "only numbers can be copied into a buffer");
+
+            long         ac {};
+            max::t_atom* av {};
+
+            if (max::dictionary_getatoms(m_instance, key, &ac, &av))
+                return 0;
+
+            const auto count { std::min(static_cast<std::size_t>(ac), capacity) };
+            for (std::size_t i = 0; i < count; ++i)
+                output[i] = convert<T>(av[i]);
+            return count;
+        }
+
+
+        /// Copy the atoms of an entry converted to numbers into a vector, which is resized to the number of atoms.
+        /// @tparam	T			A number type.
+        /// @param	key			The key.
+        /// @param	output		The vector, whose memory is reused.
+        /// @return				The number of values, which is 0 if there is no entry.
+
+        template<class T>
+        std::size_t get(const symbol key, std::vector<T>& output) const {
+            long         ac {};
+            max::t_atom* av {};
+
+            if (max::dictionary_getatoms(m_instance, key, &ac, &av))
+                ac = 0;
+            output.resize(static_cast<std::size_t>(ac));
+            return get(key, output.data(), output.size());
+        }
+
+
+        /// A typed accessor for one entry, bound to its key once.
+        /// A symbol that is created from a string is looked up in the symbol table every time,
+        /// so code that accesses the same entries repeatedly should hold views, or at least constant symbols for the keys.
+        /// @tparam	T	The type of the value, e.g. double, int or symbol.
+
+        template<class T>
+        class view {
+        public:
+            /// Create an accessor.
+            /// @param	d	The dictionary, which needs to outlive the view.
+            /// @param	key	The key of the entry.
+
+            view(dict& d, const symbol key)
+            : m_dict { d }
+            , m_key { key }
+            {}
+
+
+            /// Determine if the dictionary has the entry.
+            /// @return	True if the entry exists.
+
+            bool exists() const {
+                return m_dict.contains(m_key);
+            }
+
+
+            /// Return the first atom of the entry as the type of the view.
+            /// @param	default_value	The value to return if there is no entry or the entry is empty.
+            /// @return					The value.
+
+            T get(const T& default_value = T{}) const {
+                return m_dict.get<T>(m_key, default_value);
+            }
+
+
+            /// Copy the atoms of the entry as numbers into a buffer.
+            /// @param	output		The buffer.
+            /// @param	capacity	The number of values that fit into the buffer.
+            /// @return				The number of values copied.
+
+            std::size_t get(T* output, const std::size_t capacity) const {
+                return m_dict.get(m_key, output, capacity);
+            }
+
+
+            /// Copy the atoms of the entry as numbers into a vector.
+            /// @param	output		The vector, which is resized to the number of atoms.
+            /// @return				The number of values.
+
+            std::size_t get(std::vector<T>& output) const {
+                return m_dict.get(m_key, output);
+            }
+
+
+            /// Replace the entry with a single value.
+            /// @param	value	The new value.
+
+            void set(const T& value) {
+                atom a { value };
+                max::dictionary_appendatom(m_dict.m_instance, m_key, &a);
+            }
+
+
+            /// Return the first atom of the entry, or the default value of the type.
+
+            operator T() const {
+                return get();
+            }
+
+
+            /// Return the key of the entry.
+            /// @return	The key.
+
+            symbol key() const {
+                return m_key;
+            }
+
+        private:
+            dict&   m_dict;
+            symbol  m_key;
+        };
+
+
+        /// Remove an entry, if it exists.
+        /// @param	key	The key of the entry.
+
+        void erase(const symbol key) {
+            max::dictionary_deleteentry(m_instance, key);
+        }
+
+
         // bounds check: if key doesn't exist, throw
         atom_reference at(const symbol key) {
             long         argc = 0;
@@ -147,8 +390,97 @@ namespace c74::min {
 
 
     private:
+        // numbers are read straight from the atom, other types through the conversions of atom
+
+        template<class T>
+        static T convert(const max::t_atom& a) {
+            if constexpr (std::is_arithmetic<T>::value) {
+                if (a.a_type == max::A_FLOAT)
+                    return static_cast<T>(a.a_w.w_float);
+                if (a.a_type == max::A_LONG)
+                    return static_cast<T>(a.a_w.w_long);
+                return T{};
+            }
+            else
+                return static_cast<T>(atom(a));
+        }
+
         max::t_dictionary* m_instance       { nullptr };
         bool               m_has_ownership  { true };
     };
 
+
+    /// A view of several dictionaries stacked on top of each other, as if they had been merged,
+    /// but without copying any of their entries. A key is looked up in each layer from the top down,
+    /// so the entries of upper layers hide those of lower layers with the same key.
+    /// The view references the dictionaries, which need to outlive it, and always reflects their current content.
+
+    class dict_overlay {
+    public:
+        /// Create a view of dictionaries.
+        /// @param	layers	The dictionaries, from the top layer down to the bottom layer.
+
+        explicit dict_overlay(std::vector<dict*> layers = {})
+        : m_layers { std::move(layers) }
+        {}
+
+
+        /// Put a dictionary below all layers so far.
+        /// @param	layer	The dictionary.
+
+        void push_back(dict& layer) {
+            m_layers.push_back(&layer);
+        }
+
+
+        /// Determine if any layer has an entry for a key.
+        /// @param	key	The key.
+        /// @return		True if the key exists in any layer.
+
+        bool contains(const symbol key) const {
+            return find(key) != nullptr;
+        }
+
+
+        /// Return the entry for a key from the topmost layer that has it.
+        /// @param	key	The key.
+        /// @return		The atoms of the entry.
+        /// @throw		std::runtime_error if no layer has the key.
+
+        atom_reference at(const symbol key) const {
+            auto layer = find(key);
+            if (!layer) {
+                error("no layer has the key " + std::string(key.c_str()));
+                return atom_reference(0, nullptr);
+            }
+            return layer->at(key);
+        }
+
+
+        /// Return the keys of the entries of the view, i.e. of all layers with duplicates removed.
+        /// @return	The keys, top layer first.
+
+        std::vector<symbol> keys() const {
+            std::vector<symbol> result;
+            for (auto layer : m_layers) {
+                for (const auto& key : layer->keys()) {
+                    if (std::find(result.begin(), result.end(), key) == result.end())
+                        result.push_back(key);
+                }
+            }
+            return result;
+        }
+
+    private:
+        dict* find(const symbol key) const {
+            for (auto layer : m_layers) {
+                if (layer->valid() && layer->contains(key))
+                    return layer;
+            }
+            return nullptr;
+        }
+
+        std::vector<dict*> m_layers;
+    };
+
 }    // namespace c74::min
@@ -0,0 +1,306 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A table of named items (e.g. the messages or attributes of an object) keyed by interned symbol.
+    /// Max has already interned the names of incoming messages and attributes, so a lookup only hashes a pointer
+    /// rather than a string.
+    ///
+    /// The names and the hash table that finds them are kept in a layout, which can be shared by the tables of all the
+    /// instances of a class (see share()). The first instance to share a layout builds it as its items are added.
+    /// Once that instance is sealed, every further instance only keeps an array of pointers to its own items,
+    /// so creating an instance neither copies the names nor rebuilds the hash table.
+    /// An instance that adds a name the shared layout does not have continues with a private copy of the layout.
+    ///
+    /// The table is written when the object is created and is read-only thereafter.
+    /// Iteration visits the items in the order in which they were added.
+    /// As with a std::unordered_map, the [] operator adds an empty entry for a name that is not yet present.
+    ///
+    /// @tparam	T	The type of the items, which are referenced by pointer.
+
+    template<class T>
+    class dispatch_table {
+        static constexpr size_t k_not_found { std::numeric_limits<size_t>::max() };
+        static constexpr size_t k_minimum_slots { 16 };
+
+        template<class table_type, class item_reference>
+        class basic_iterator;
+
+    public:
+        using value_type     = std::pair<const std::string&, T*&>;
+        using iterator       = basic_iterator<dispatch_table, T*&>;
+        using const_iterator = basic_iterator<const dispatch_table, T* const&>;
+
+
+        /// The names of the items of a table, in the order in which they were added, and the hash table to find them.
+        /// Layouts are written on the main thread, while the instances of a class are created.
+
+        class layout {
+        public:
+            size_t size() const {
+                return m_names.size();
+            }
+
+        private:
+            friend class dispatch_table;
+
+            enum class state { empty, building, sealed };
+
+            // Open addressing with linear probing.
+            // The number of slots is a power of two and at least twice the number of names, so probes are short and always end.
+
+            struct slot {
+                const max::t_symbol*    key { nullptr };
+                size_t                  entry { k_not_found };
+            };
+
+            vector<std::string> m_names;
+            vector<slot>        m_slots;
+            state               m_state { state::empty };
+
+
+            static size_t hash(const max::t_symbol* key) {
+                auto h { static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key)) };
+
+                // symbols are aligned, so mix the upper bits into the lower bits that select the slot
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdULL;
+                h ^= h >> 33;
+                return static_cast<size_t>(h);
+            }
+
+
+            size_t find_entry(const max::t_symbol* key) const {
+                if (m_slots.empty())
+                    return k_not_found;
+
+                const auto mask { m_slots.size() - 1 };
+
+                for (auto i = hash(key) & mask;; i = (i + 1) & mask) {
+                    if (m_slots[i].key == key)
+                        return m_slots[i].entry;
+                    if (m_slots[i].key == nullptr)
+                        return k_not_found;
+                }
+            }
+
+
+            size_t add(const symbol name) {
+                const max::t_symbol* key { name };
+                const auto           entry { m_names.size() };
+
+                m_names.emplace_back(name.c_str());
+
+                if (m_names.size() * 2 > m_slots.size()) {
+                    vector<slot> old_slots { std::move(m_slots) };
+
+                    m_slots.assign(std::max(k_minimum_slots, old_slots.size() * 2), slot {});
+                    for (const auto& s : old_slots) {
+                        if (s.key)
+                            place(s.key, s.entry);
+                    }
+                }
+                place(key, entry);
+                return entry;
+            }
+
+
+            void place(const max::t_symbol* key, const size_t entry) {
+                const auto mask { m_slots.size() - 1 };
+                auto       i { hash(key) & mask };
+
+                while (m_slots[i].key != nullptr)
+                    i = (i + 1) & mask;
+                m_slots[i] = { key, entry };
+            }
+        };
+
+
+        dispatch_table() = default;
+        dispatch_table(const dispatch_table&) = delete;
+        dispatch_table& operator=(const dispatch_table&) = delete;
+
+        ~dispatch_table() {
+            seal();
+        }
+
+
+        /// Use a layout shared with the tables of the other instances of a class.
+        /// This must be called before any item is added, otherwise the table keeps its private layout.
+        /// If the shared layout is empty this table builds it, until seal() is called.
+        /// If another table is still building it this table uses a private layout.
+        /// @param	shared	The layout of the class.
+
+        void share(layout& shared) {
+            if (m_layout)
+                return;
+
+            if (shared.m_state == layout::state::empty) {
+                shared.m_state = layout::state::building;
+                m_layout       = &shared;
+                m_building     = true;
+            }
+            else if (shared.m_state == layout::state::sealed) {
+                m_layout = &shared;
+                m_items.assign(shared.size(), nullptr);
+            }
+        }
+
+
+        /// Finish building a shared layout, so that the tables of further instances can use it.
+        /// Does nothing if this table is not building a shared layout.
+
+        void seal() {
+            if (m_building) {
+                m_layout->m_state = layout::state::sealed;
+                m_building        = false;
+            }
+        }
+
+
+        /// Get the item with a name, adding an empty entry if there is none.
+        /// @param	name	The name of the item.
+        /// @return			A reference to the pointer to the item.
+
+        T*& operator[](const symbol name) {
+            auto entry { find_entry(name) };
+
+            if (entry == k_not_found) {
+                entry = writable_layout().add(name);
+                m_items.push_back(nullptr);
+            }
+            return m_items[entry];
+        }
+
+
+        /// Find the item with a name.
+        /// @param	name	The name of the item.
+        /// @return			An iterator to the entry for the item, or end() if there is none.
+
+        iterator find(const symbol name) {
+            const auto entry { find_entry(name) };
+            return entry == k_not_found ? end() : iterator { this, entry };
+        }
+
+
+        /// Find the item with a name.
+        /// @param	name	The name of the item.
+        /// @return			An iterator to the entry for the item, or end() if there is none.
+
+        const_iterator find(const symbol name) const {
+            const auto entry { find_entry(name) };
+            return entry == k_not_found ? end() : const_iterator { this, entry };
+        }
+
+
+        iterator begin() {
+            return { this, 0 };
+        }
+
+        const_iterator begin() const {
+            return { this, 0 };
+        }
+
+        iterator end() {
+            return { this, size() };
+        }
+
+        const_iterator end() const {
+            return { this, size() };
+        }
+
+        size_t size() const {
+            return m_items.size();
+        }
+
+        bool empty() const {
+            return m_items.empty();
+        }
+
+    private:
+        layout*             m_layout { nullptr };    ///< the shared layout or m_private_layout
+        unique_ptr<layout>  m_private_layout;
+        vector<T*>          m_items;                 ///< one for each name of the layout
+        bool                m_building { false };    ///< this table is building the shared layout
+
+
+        // An iterator yields pairs of references to the name and the item, much like the entries of a std::unordered_map.
+
+        template<class table_type, class item_reference>
+        class basic_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<const std::string&, item_reference>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = value_type;
+
+            struct pointer {
+                value_type  entry;
+
+                const value_type* operator->() const {
+                    return &entry;
+                }
+            };
+
+            basic_iterator(table_type* table, const size_t index)
+            : m_table { table }
+            , m_index { index }
+            {}
+
+            reference operator*() const {
+                return { m_table->m_layout->m_names[m_index], m_table->m_items[m_index] };
+            }
+
+            pointer operator->() const {
+                return { **this };
+            }
+
+            basic_iterator& operator++() {
+                ++m_index;
+                return *this;
+            }
+
+            basic_iterator operator++(int) {
+                auto previous { *this };
+                ++m_index;
+                return previous;
+            }
+
+            bool operator==(const basic_iterator& other) const {
+                return m_table == other.m_table && m_index == other.m_index;
+            }
+
+            bool operator!=(const basic_iterator& other) const {
+                return !(*this == other);
+            }
+
+        private:
+            table_type* m_table;
+            size_t      m_index;
+        };
+
+
+        size_t find_entry(const symbol name) const {
+            return m_layout ? m_layout->find_entry(name) : k_not_found;
+        }
+
+
+        // The layout to add a name to: the shared one while this table is building it, otherwise a private one,
+        // which starts as a copy of the shared one if this table was using it.
+
+        layout& writable_layout() {
+            if (m_layout == nullptr || (!m_building && m_layout != m_private_layout.get())) {
+                m_private_layout = m_layout ? std::make_unique<layout>(*m_layout) : std::make_unique<layout>();
+                m_layout         = m_private_layout.get();
+            }
+            return *m_layout;
+        }
+    };
+
+}    // namespace c74::min
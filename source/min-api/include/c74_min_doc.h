@@ -296,8 +296,19 @@ namespace c74::min {
     }
 
 
+    /// Update the refpage of a class when it is registered.
+    ///
+    /// Refpages are normally written at build time by a generator executable (see min-object-docs.cmake),
+    /// which is built with C74_MIN_DOC_GENERATOR defined as the docs folder and writes the refpage unconditionally.
+    /// Externals do no filesystem work here, which keeps the launch of Max fast with many Min externals installed,
+    /// unless C74_MIN_WITH_DOC_UPDATE is defined (the C74_MIN_DOC_UPDATE CMake option) to compare the dates of
+    /// the external and its refpage and regenerate the refpage if it is out of date.
+
     template<class min_class_type>
     void doc_update(const min_class_type& instance, const std::string& max_class_name, const std::string& min_class_name) {
+#if defined(C74_MIN_DOC_GENERATOR)
+        doc_generate(instance, std::string(C74_MIN_DOC_GENERATOR) + "/" + max_class_name + ".maxref.xml", max_class_name, min_class_name);
+#elif defined(C74_MIN_WITH_DOC_UPDATE)
         try {
             path        extern_file(max_class_name, path::filetype::external);
             auto        extern_date     = extern_file.date_modified();
@@ -328,6 +339,11 @@ namespace c74::min {
         catch (std::exception& e) {
             std::cerr << "DOC UPDATE ERROR: " << e.what() << std::endl;
         }
+#else
+        (void)instance;
+        (void)max_class_name;
+        (void)min_class_name;
+#endif
     }
 
 }    // namespace c74::min
@@ -0,0 +1,236 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A reference-counted array of numbers that can be sent from one Min object to another without converting every value to an atom.
+    ///
+    /// Copying a float_array copies the reference, not the numbers.
+    /// Sending it out of an outlet passes a message "float_array <name>" to objects that define a "float_array" message,
+    /// whose name refers to the array for as long as the outlet keeps it (see float_array_publisher),
+    /// and the receiver gets the array back from the arguments of the message with float_array::from().
+    /// Outlets connected to any other object send the numbers as a list instead, so they can be connected to any object.
+    ///
+    /// @code
+    /// message<> array { this, "float_array", "Process an array of numbers.",
+    ///     MIN_FUNCTION {
+    ///         const auto values = float_array::from(args);
+    ///         ...
+    /// @endcode
+
+    class float_array {
+    public:
+        /// Create an empty array.
+
+        float_array() = default;
+
+
+        /// Create an array of numbers.
+        /// @param	size	The number of values.
+        /// @param	value	The value of each of them.
+
+        explicit float_array(const size_t size, const double value = 0.0)
+        : m_values { std::make_shared<vector<double>>(size, value) }
+        {}
+
+
+        /// Create an array from numbers, which are moved rather than copied.
+        /// @param	values	The values.
+
+        explicit float_array(vector<double>&& values)
+        : m_values { std::make_shared<vector<double>>(std::move(values)) }
+        {}
+
+
+        /// Return the array referred to by the arguments of a "float_array" message,
+        /// or the numbers of a list if the arguments are not a reference to an array.
+        /// @param	args	The arguments of the message.
+        /// @return			The array, which is empty if the name refers to no array.
+
+        static float_array from(const atoms& args);
+
+
+        /// Return the number of values.
+        /// @return	The number of values.
+
+        size_t size() const {
+            return m_values ? m_values->size() : 0;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+
+        /// Access the values, e.g. to fill an array before it is sent.
+        /// The values are shared with every copy of the array, so only change them before the array is sent.
+        /// @return	A pointer to the first value, or nullptr if the array is empty.
+
+        double* data() {
+            return m_values ? m_values->data() : nullptr;
+        }
+
+        const double* data() const {
+            return m_values ? m_values->data() : nullptr;
+        }
+
+        double& operator[](const size_t index) {
+            return (*m_values)[index];
+        }
+
+        double operator[](const size_t index) const {
+            return (*m_values)[index];
+        }
+
+        double* begin() {
+            return data();
+        }
+
+        double* end() {
+            return data() + size();
+        }
+
+        const double* begin() const {
+            return data();
+        }
+
+        const double* end() const {
+            return data() + size();
+        }
+
+
+        /// Convert the values to atoms, e.g. to send them as a list.
+        /// @return	The values.
+
+        atoms to_atoms() const {
+            atoms as;
+
+            as.reserve(size());
+            for (const auto value : *this)
+                as.push_back(value);
+            return as;
+        }
+
+    private:
+        std::shared_ptr<vector<double>> m_values;
+    };
+
+
+    /// Used internally: the arrays that have been sent by name, which are found by float_array::from().
+
+    class float_array_registry {
+    public:
+        static float_array_registry& shared() {
+            static float_array_registry s_registry;
+            return s_registry;
+        }
+
+        void set(const max::t_symbol* name, const float_array& value) {
+            std::lock_guard<std::mutex> lock { m_mutex };
+            m_arrays[name] = value;
+        }
+
+        float_array get(const max::t_symbol* name) {
+            std::lock_guard<std::mutex> lock { m_mutex };
+            const auto                  found { m_arrays.find(name) };
+
+            return found != m_arrays.end() ? found->second : float_array {};
+        }
+
+        void remove(const max::t_symbol* name) {
+            std::lock_guard<std::mutex> lock { m_mutex };
+            m_arrays.erase(name);
+        }
+
+    private:
+        std::mutex                                              m_mutex;
+        std::unordered_map<const max::t_symbol*, float_array>   m_arrays;
+    };
+
+
+    /// Publishes arrays under a name of its own, for sending them in a message.
+    /// Each outlet that sends arrays has one.
+    /// The last array published is kept until the next is published or the publisher is destroyed,
+    /// so a receiver that wants the values for longer keeps a copy of the float_array rather than of the name.
+
+    class float_array_publisher {
+    public:
+        float_array_publisher() = default;
+
+        float_array_publisher(const float_array_publisher&) = delete;
+        float_array_publisher& operator=(const float_array_publisher&) = delete;
+
+        ~float_array_publisher() {
+            if (m_name)
+                float_array_registry::shared().remove(m_name);
+        }
+
+
+        /// Publish an array under the name of the publisher, replacing the array published before.
+        /// @param	value	The array.
+        /// @return			The name, which is the same for every array of the publisher.
+
+        symbol publish(const float_array& value) {
+            if (!m_name) {
+                static std::atomic<long> s_count {};
+                m_name = symbol("float_array_" + std::to_string(++s_count));    // one name per publisher, not one per array
+            }
+            float_array_registry::shared().set(m_name, value);
+            return m_name;
+        }
+
+    private:
+        max::t_symbol* m_name { nullptr };
+    };
+
+
+    inline float_array float_array::from(const atoms& args) {
+        if (args.size() == 1 && args[0].type() == message_type::symbol_argument)
+            return float_array_registry::shared().get(args[0]);
+
+        vector<double> values;
+
+        values.reserve(args.size());
+        for (const auto& a : args) {
+            if (a.type() == message_type::int_argument || a.type() == message_type::float_argument)
+                values.push_back(a);
+        }
+        return float_array { std::move(values) };
+    }
+
+
+    /// Determine whether every object connected to an outlet defines a message.
+    /// This walks the patch cords of the patcher of the object, so call it from the main or the scheduler thread.
+    /// @param	owner			The object.
+    /// @param	outlet_index	The index of the outlet, from the left.
+    /// @param	message_name	The name of the message.
+    /// @return					False if the object is not in a patcher or any object connected to the outlet does not define the message.
+
+    inline bool outlet_receivers_define(max::t_object* owner, const long outlet_index, const symbol message_name) {
+        max::t_object* patcher {};
+        max::t_object* box {};
+
+        if (max::object_obex_lookup(owner, k_sym__pound_p, &patcher) != max::MAX_ERR_NONE || !patcher)
+            return false;
+        if (max::object_obex_lookup(owner, k_sym__pound_b, &box) != max::MAX_ERR_NONE || !box)
+            return false;
+
+        for (auto line = max::jpatcher_get_firstline(patcher); line; line = max::jpatchline_get_nextline(line)) {
+            if (max::jpatchline_get_box1(line) != box || max::jpatchline_get_outletnum(line) != outlet_index)
+                continue;
+
+            const auto receiver { max::jbox_get_object(max::jpatchline_get_box2(line)) };
+
+            if (!receiver || !max::zgetfn(receiver, message_name))
+                return false;
+        }
+        return true;
+    }
+
+
+}    // namespace c74::min
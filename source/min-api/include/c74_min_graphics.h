@@ -549,4 +549,77 @@ namespace c74::min::ui {
     };
 
 
+    /// A layer caches what is drawn into it, so that the static parts of a paint routine, e.g. a background and a frame,
+    /// are only drawn once rather than with every paint. Painting the layer again just copies the cached image.
+    /// The layer is invalidated whenever an attribute of its owner changes, or explicitly by calling invalidate().
+    ///
+    /// The function that draws the layer receives the same arguments as a function that draws an image,
+    /// so it creates its target with `target t {args};`.
+
+    class layer {
+    public:
+        /// Create a layer.
+        /// @param	an_owner	The owning ui object. Typically you will pass `this`.
+        /// @param	a_name		The name of the layer, which needs to be unique within the object.
+        /// @param	a_function	The function that draws the content of the layer.
+
+        layer(object_base* an_owner, const symbol a_name, const function& a_function)
+        : m_owner { an_owner }
+        , m_name { a_name }
+        , m_draw_callback { a_function } {
+            if (auto ui = dynamic_cast<ui_operator_base*>(m_owner))
+                ui->add_layer(this);
+        }
+
+        ~layer() {
+            if (auto ui = dynamic_cast<ui_operator_base*>(m_owner))
+                ui->remove_layer(this);
+        }
+
+        // Layers cannot be copied, as their owner references them.
+
+        layer(const layer&) = delete;
+        layer& operator=(const layer&) = delete;
+
+
+        /// Paint the layer, drawing its content first if it is not cached for the size of the target.
+        /// @param	t	The target of the paint routine.
+        /// @param	x	The horizontal position of the layer in the target.
+        /// @param	y	The vertical position of the layer in the target.
+
+        void paint(target& t, const double x = 0.0, const double y = 0.0) {
+            if (auto g = max::jbox_start_layer(m_owner->maxobj(), t.view(), m_name, t.width(), t.height())) {
+                atoms a {{ g, t.width(), t.height() }};
+                m_draw_callback(a, 0);
+                max::jbox_end_layer(m_owner->maxobj(), t.view(), m_name);
+            }
+            max::jbox_paint_layer(m_owner->maxobj(), t.view(), m_name, x, y);
+        }
+
+
+        /// Discard the cached content, so that it is drawn again with the next paint.
+        /// This also needs to be done if anything but the attributes of the owner changes the content.
+
+        void invalidate() {
+            if (m_owner->maxobj())
+                max::jbox_invalidate_layer(m_owner->maxobj(), nullptr, m_name);
+        }
+
+    private:
+        object_base*    m_owner;
+        symbol          m_name;
+        function        m_draw_callback;
+    };
+
+
 } // namespace c74::min:::graphics
+
+
+namespace c74::min {
+
+    inline void ui_operator_base::invalidate_layers() {
+        for (auto a_layer : m_layers)
+            a_layer->invalidate();
+    }
+
+} // namespace c74::min
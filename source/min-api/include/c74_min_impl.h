@@ -25,6 +25,35 @@ namespace c74::min {
     }
 
 
+    // A setter may be called on another thread than the batch is ended on.
+    // In the rare case that it changes an attribute while the batch ends "attributes_complete" may then be called twice,
+    // but it is never missed.
+
+    void object_base::complete_attributes() {
+        if (m_constructing_attribute || m_attribute_batch.load() > 0)
+            return;
+        if (m_attributes_changed.exchange(false))
+            try_call("attributes_complete");
+    }
+
+
+    void object_base::batch_attributes_until_idle() {
+        if (m_attribute_batch_deferred || m_attribute_batch.load() > 0)
+            return;    // already in a batch
+
+        if (!m_attribute_batch_qelem) {
+            auto end_of_batch = [](object_base* self) {
+                self->m_attribute_batch_deferred = false;
+                self->end_attribute_batch();
+            };
+            m_attribute_batch_qelem = max::qelem_new(this, reinterpret_cast<max::method>(static_cast<void (*)(object_base*)>(end_of_batch)));
+        }
+        m_attribute_batch_deferred = true;
+        begin_attribute_batch();
+        max::qelem_set(m_attribute_batch_qelem);
+    }
+
+
     // implemented out-of-line because of bi-directional dependency of min::argument<> and min::object_base
 
     void object_base::process_arguments(const atoms& args) {
@@ -207,14 +236,16 @@ namespace c74::min {
 
     // implementation of sample_operator-style calls made to a vector_operator
 
-    template<placeholder vector_operator_placeholder_type>
-    sample vector_operator<vector_operator_placeholder_type>::operator()(const sample x) {
-        sample        input_storage[1]   { x };
-        sample        output_storage[1]  {};
-        sample*       input              { input_storage };
-        sample*       output             { output_storage };
-        audio_bundle  input_bundle       { &input, 1, 1 };
-        audio_bundle  output_bundle      { &output, 1, 1 };
+    template<typename vector_operator_sample_type>
+    sample vector_operator<vector_operator_sample_type>::operator()(const sample x) {
+        using T = vector_operator_sample_type;
+
+        T                       input_storage[1]   { static_cast<T>(x) };
+        T                       output_storage[1]  {};
+        T*                      input              { input_storage };
+        T*                      output             { output_storage };
+        basic_audio_bundle<T>   input_bundle       { &input, 1, 1 };
+        basic_audio_bundle<T>   output_bundle      { &output, 1, 1 };
 
         (*this)(input_bundle, output_bundle);
 
@@ -236,3 +267,48 @@ namespace c74::min {
 
 
 }    // namespace c74::min
+
+
+#ifdef C74_MIN_REALTIME_CHECKS
+
+// The global allocation functions of the external, replaced to report heap operations in perform routines (see realtime_check).
+
+void* operator new(std::size_t size) {
+    c74::min::realtime_check::heap();
+    if (auto p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc {};
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    c74::min::realtime_check::heap();
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    if (p)
+        c74::min::realtime_check::heap();
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+#endif
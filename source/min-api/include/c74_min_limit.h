@@ -166,6 +166,107 @@ namespace c74::min {
     }
 
 
+    /// Limit a block of values to within a specified range, clamping the values to the outer bounds of the range if neccessary.
+    /// The loop has no branches, so that the compiler can vectorize it.
+    /// @tparam	T			The data type of the numbers to be constrained.
+    ///	@param	input		The values to constrain.
+    ///	@param	output		Filled with the constrained values. May be the same as the input.
+    ///	@param	count		The number of values.
+    ///	@param	low_bound	The low bound for the range.
+    ///	@param	high_bound	The high bound for the range, which must not be less than the low bound.
+    /// @see				wrap()
+    /// @see				fold()
+
+    template<class T>
+    void clamp(const T* input, T* output, const size_t count, const T low_bound, const T high_bound) {
+        for (size_t i = 0; i < count; ++i)
+            output[i] = std::min(std::max(input[i], low_bound), high_bound);
+    }
+
+
+    /// Limit a block of values to within a specified range, wrapping the values to within the range if neccessary.
+    /// Values within the range are passed unchanged, the others are wrapped with a division rather than a loop,
+    /// so that the compiler can vectorize the loop over the block.
+    /// @tparam	T			The data type of the numbers to be constrained.
+    ///	@param	input		The values to constrain.
+    ///	@param	output		Filled with the constrained values. May be the same as the input.
+    ///	@param	count		The number of values.
+    ///	@param	a_low_bound		The low bound for the range.
+    ///	@param	a_high_bound	The high bound for the range.
+    /// @see				clamp()
+    /// @see				fold()
+
+    template<class T>
+    void wrap(const T* input, T* output, const size_t count, const T a_low_bound, const T a_high_bound) {
+        const auto low_bound  { std::min(a_low_bound, a_high_bound) };
+        const auto high_bound { std::max(a_low_bound, a_high_bound) };
+
+        if (low_bound == high_bound) {
+            std::fill_n(output, count, T(0));    // as the scalar version
+            return;
+        }
+
+        if constexpr (std::is_floating_point<T>::value) {
+            const auto range { high_bound - low_bound };
+
+            for (size_t i = 0; i < count; ++i) {
+                const auto x { input[i] };
+                auto       y { x - range * std::floor((x - low_bound) / range) };
+
+                // the division may round to the next integer
+                y = y >= high_bound ? y - range : y;
+                y = y < low_bound ? y + range : y;
+                output[i] = (x >= low_bound && x < high_bound) ? x : y;
+            }
+        }
+        else {
+            // in a wider signed type, so that unsigned values below the low bound wrap correctly
+            const auto low   { static_cast<long long>(low_bound) };
+            const auto range { static_cast<long long>(high_bound) - low };
+
+            for (size_t i = 0; i < count; ++i) {
+                const auto d { (static_cast<long long>(input[i]) - low) % range };
+                output[i] = static_cast<T>((d < 0 ? d + range : d) + low);
+            }
+        }
+    }
+
+
+    /// Limit a block of values to within a specified range, folding the values to within the range if neccessary.
+    /// Values within the range are passed unchanged, the others are folded with a division rather than a loop,
+    /// so that the compiler can vectorize the loop over the block.
+    /// @tparam	T			The data type of the numbers to be constrained.
+    ///	@param	input		The values to constrain.
+    ///	@param	output		Filled with the constrained values. May be the same as the input.
+    ///	@param	count		The number of values.
+    ///	@param	a_low_bound		The low bound for the range.
+    ///	@param	a_high_bound	The high bound for the range. If it is equal to the low bound all values are set to it.
+    /// @see				clamp()
+    /// @see				wrap()
+
+    template<class T>
+    void fold(const T* input, T* output, const size_t count, const T a_low_bound, const T a_high_bound) {
+        const auto low_bound  { std::min(a_low_bound, a_high_bound) };
+        const auto high_bound { std::max(a_low_bound, a_high_bound) };
+
+        if (low_bound == high_bound) {
+            std::fill_n(output, count, low_bound);
+            return;
+        }
+
+        const auto low        { static_cast<double>(low_bound) };
+        const auto fold_range { 2.0 * (static_cast<double>(high_bound) - low) };
+
+        for (size_t i = 0; i < count; ++i) {
+            const auto x { input[i] };
+            const auto d { static_cast<double>(x) - low };
+            const auto y { std::fabs(d - fold_range * std::floor(d / fold_range + 0.5)) + low };
+
+            output[i] = (x >= low_bound && x <= high_bound) ? x : static_cast<T>(y);
+        }
+    }
+
+
     /// A utility for scaling one range of values onto another range of values.
     /// @tparam	T			The data type of the number to be constrained.
     ///	@param	value		The value to constrain.
@@ -267,6 +368,19 @@ namespace c74::min {
             T operator()(const T input, const T low, const T high) {
                 return apply(input, low, high);
             }
+
+
+            /// Constrain a block of input values to the specified range.
+            /// @param	input	The input values to constrain.
+            /// @param	output	Filled with the constrained values. May be the same as the input.
+            /// @param	count	The number of values.
+            /// @param	low		The low boundary of the range.
+            /// @param	high	The high boundary of the range.
+
+            static void apply(const T* input, T* output, const size_t count, const T low, const T high) {
+                if (output != input)
+                    std::copy_n(input, count, output);
+            }
         };
 
 
@@ -296,6 +410,18 @@ namespace c74::min {
             T operator()(const T input, const T low, const T high) {
                 return apply(input, low, high);
             }
+
+
+            /// Constrain a block of input values to the specified range.
+            /// @param	input	The input values to constrain.
+            /// @param	output	Filled with the constrained values. May be the same as the input.
+            /// @param	count	The number of values.
+            /// @param	low		The low boundary of the range.
+            /// @param	high	The high boundary of the range.
+
+            static void apply(const T* input, T* output, const size_t count, const T low, const T high) {
+                min::clamp<T>(input, output, count, low, high);
+            }
         };
 
 
@@ -325,6 +451,18 @@ namespace c74::min {
             T operator()(const T input, const T low, const T high) {
                 return apply(input, low, high);
             }
+
+
+            /// Constrain a block of input values to the specified range.
+            /// @param	input	The input values to constrain.
+            /// @param	output	Filled with the constrained values. May be the same as the input.
+            /// @param	count	The number of values.
+            /// @param	low		The low boundary of the range.
+            /// @param	high	The high boundary of the range.
+
+            static void apply(const T* input, T* output, const size_t count, const T low, const T high) {
+                min::wrap<T>(input, output, count, low, high);
+            }
         };
 
 
@@ -354,6 +492,18 @@ namespace c74::min {
             T operator()(const T input, const T low, const T high) {
                 return apply(input, low, high);
             }
+
+
+            /// Constrain a block of input values to the specified range.
+            /// @param	input	The input values to constrain.
+            /// @param	output	Filled with the constrained values. May be the same as the input.
+            /// @param	count	The number of values.
+            /// @param	low		The low boundary of the range.
+            /// @param	high	The high boundary of the range.
+
+            static void apply(const T* input, T* output, const size_t count, const T low, const T high) {
+                min::fold<T>(input, output, count, low, high);
+            }
         };
 
     }    // namespace limit
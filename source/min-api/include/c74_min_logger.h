@@ -23,6 +23,14 @@ namespace c74::min {
 
     class logger {
     public:
+        class async_line;
+
+
+        /// The number of characters of a line queued by async(), including the terminating null. Longer lines are truncated.
+
+        static constexpr size_t k_async_line_size { 256 };
+
+
         /// The output type of the message.
         /// These are not `levels` as in some languages (e.g. Ruby) but distinct targets.
 
@@ -44,6 +52,18 @@ namespace c74::min {
         {}
 
 
+        ~logger() {
+            if (m_qelem) {
+                max::qelem_free(m_qelem);
+                flush();    // the owner is still valid, so post what remains rather than lose it
+            }
+        }
+
+
+        logger(const logger&) = delete;
+        logger& operator=(const logger&) = delete;
+
+
         /// Use the insertion operator as for any other stream to build the output message
         /// @param	x	A token to be added to the output stream.
         /// @return		A reference to the output stream.
@@ -60,40 +80,256 @@ namespace c74::min {
         /// @return		A reference to the output stream.
 
         logger& operator<<(const logger_line_ending& x) {
-            const std::string& s = m_stream.str();
+            realtime_check::blocking("synchronous console output");
+            post(m_stream.str().c_str());
+            m_stream.str("");
+            return *this;
+        }
+
+
+        /// Preallocate the queue for lines from async(), e.g. in your constructor.
+        /// This allocates and must be called in the main thread, before async() is used from any other thread.
+        /// @param	line_count	The number of lines that can wait to be posted, which is rounded up to a power of two.
+
+        void prepare_async(const size_t line_count = 64) {
+            size_t size { 1 };
+            while (size < line_count)
+                size <<= 1;
+
+            m_lines = std::make_unique<line[]>(size);
+            for (size_t i = 0; i < size; ++i)
+                m_lines[i].sequence.store(i, std::memory_order_relaxed);
+            m_mask = size - 1;
+            m_enqueue.store(0);
+            m_dequeue = 0;
+
+            if (!m_qelem)
+                m_qelem = max::qelem_new(this, reinterpret_cast<max::method>(qelem_callback));
+        }
+
+
+        /// Begin a line that may be written from any thread, including the audio thread.
+        /// The line is formatted on the calling thread without allocating memory or taking a lock,
+        /// and is posted to the Max window later from the main thread.
+        /// If prepare_async() has not been called, or the queue is full, the line is dropped and counted.
+        /// @code
+        /// cout.async() << "peak " << peak << " in channel " << channel << endl;
+        /// @endcode
+        /// @return	The line, which is queued when it receives endl.
+
+        async_line async();
+
+
+        /// The number of lines from async() that were dropped because the queue was full or not prepared.
+        /// @return	The count since the logger was created.
 
+        size_t dropped() const {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        // A bounded queue with a sequence number for each line, which lets any number of threads write
+        // while the main thread reads, without locks.
+        // A line is free for the writer whose position equals its sequence,
+        // and ready for the reader when its sequence is one past the position.
+
+        struct line {
+            std::atomic<size_t> sequence { 0 };
+            char                text[k_async_line_size];
+        };
+
+        const object_base&          m_owner;
+        const logger::type          m_target;
+        std::stringstream           m_stream;
+        std::unique_ptr<line[]>     m_lines;
+        size_t                      m_mask {};
+        std::atomic<size_t>         m_enqueue { 0 };
+        size_t                      m_dequeue {};           ///< only used by the main thread
+        std::atomic<size_t>         m_dropped { 0 };
+        size_t                      m_reported_drops {};    ///< only used by the main thread
+        max::t_qelem*               m_qelem { nullptr };
+
+
+        void post(const char* s) {
             switch (m_target) {
 				case type::message:
                     std::cout << s << std::endl;
 
                     // if the max object is present then it is safe to post even if the owner isn't yet fully initialized
                     if (m_owner.initialized() || k_sym_max)
-                        max::object_post(m_owner, s.c_str());
+                        max::object_post(m_owner, s);
                     break;
 				case type::warning:
                     std::cerr << s << std::endl;
 
                     // if the max object is present then it is safe to post even if the owner isn't yet fully initialized
                     if (m_owner.initialized() || k_sym_max)
-                        max::object_warn(m_owner, s.c_str());
+                        max::object_warn(m_owner, s);
                     break;
 				case type::error:
                     std::cerr << s << std::endl;
 
                     // if the max object is present then it is safe to post even if the owner isn't yet fully initialized
                     if (m_owner.initialized() || k_sym_max)
-                        max::object_error(m_owner, s.c_str());
+                        max::object_error(m_owner, s);
                     break;
             }
+        }
 
-            m_stream.str("");
+
+        // Called by any thread.
+
+        void enqueue(const char* text, const size_t size) {
+            if (!m_lines) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            auto  position { m_enqueue.load(std::memory_order_relaxed) };
+            line* l {};
+
+            for (;;) {
+                l = &m_lines[position & m_mask];
+
+                const auto sequence { l->sequence.load(std::memory_order_acquire) };
+                const auto difference { static_cast<std::ptrdiff_t>(sequence - position) };
+
+                if (difference == 0) {
+                    if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0) {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                else
+                    position = m_enqueue.load(std::memory_order_relaxed);
+            }
+
+            std::memcpy(l->text, text, size);
+            l->text[size] = 0;
+            l->sequence.store(position + 1, std::memory_order_release);
+            max::qelem_set(m_qelem);
+        }
+
+
+        // Called in the main thread.
+
+        void flush() {
+            if (!m_lines)
+                return;
+
+            for (;;) {
+                auto&      l { m_lines[m_dequeue & m_mask] };
+                const auto sequence { l.sequence.load(std::memory_order_acquire) };
+
+                if (sequence != m_dequeue + 1)
+                    break;
+                post(l.text);
+                l.sequence.store(m_dequeue + m_mask + 1, std::memory_order_release);
+                ++m_dequeue;
+            }
+
+            const auto drops { dropped() };
+            if (drops != m_reported_drops) {
+                const auto message { std::to_string(drops - m_reported_drops) + " lines dropped because the log queue was full" };
+                m_reported_drops = drops;
+                post(message.c_str());
+            }
+        }
+
+
+        static void qelem_callback(logger* self) {
+            self->flush();
+        }
+    };
+
+
+    /// A line of a logger that is formatted on the calling thread into a fixed-size buffer, see logger::async().
+    /// Text beyond logger::k_async_line_size is truncated.
+
+    class logger::async_line {
+    public:
+        explicit async_line(logger& a_logger)
+        : m_logger { a_logger }
+        {}
+
+
+        async_line& operator<<(const char* x) {
+            append(x, std::strlen(x));
+            return *this;
+        }
+
+        async_line& operator<<(const std::string& x) {
+            append(x.c_str(), x.size());
+            return *this;
+        }
+
+        async_line& operator<<(const symbol x) {
+            return *this << x.c_str();
+        }
+
+        async_line& operator<<(const char x) {
+            append(&x, 1);
+            return *this;
+        }
+
+        async_line& operator<<(const bool x) {
+            return *this << (x ? "true" : "false");
+        }
+
+        async_line& operator<<(const void* x) {
+            return format("%p", x);
+        }
+
+        template<typename T, typename enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+        async_line& operator<<(const T x) {
+            return format("%lld", static_cast<long long>(x));
+        }
+
+        template<typename T, typename enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, int>::type = 0>
+        async_line& operator<<(const T x) {
+            return format("%llu", static_cast<unsigned long long>(x));
+        }
+
+        template<typename T, typename enable_if<std::is_floating_point<T>::value, int>::type = 0>
+        async_line& operator<<(const T x) {
+            return format("%g", static_cast<double>(x));
+        }
+
+
+        /// Queue the line to be posted and begin a new one.
+
+        async_line& operator<<(const logger_line_ending&) {
+            m_logger.enqueue(m_text, m_size);
+            m_size = 0;
             return *this;
         }
 
     private:
-        const object_base&  m_owner;
-        const logger::type  m_target;
-        std::stringstream   m_stream;
+        logger& m_logger;
+        char    m_text[k_async_line_size];
+        size_t  m_size {};
+
+        void append(const char* x, const size_t size) {
+            const auto n { std::min(size, k_async_line_size - 1 - m_size) };
+            std::memcpy(m_text + m_size, x, n);
+            m_size += n;
+        }
+
+        template<typename T>
+        async_line& format(const char* a_format, const T x) {
+            char       number[32];
+            const auto n { std::snprintf(number, sizeof(number), a_format, x) };
+            if (n > 0)
+                append(number, std::min(static_cast<size_t>(n), sizeof(number) - 1));
+            return *this;
+        }
     };
 
+
+    inline logger::async_line logger::async() {
+        return async_line { *this };
+    }
+
 }    // namespace c74::min
@@ -24,6 +24,22 @@ namespace c74::min {
     #define MIN_FUNCTION [this](const c74::min::atoms& args, const int inlet) -> c74::min::atoms
 
 
+    /// A callback function for messages which only read their arguments.
+    /// The arguments are a view of the atoms passed by Max rather than a copy of them.
+    /// Typically this is provided to a message as a lamba function using the #MIN_SPAN_FUNCTION macro.
+    /// @param	args	A view of the atoms passed to your function, valid only until your function returns.
+    /// @param	inlet	The number (zero-based index) of the inlet at which the message was received, if relevant. Otherwise -1.
+    /// @see		MIN_SPAN_FUNCTION
+
+    using span_function = std::function<atoms(const atom_span& args, const int inlet)>;
+
+
+    /// Provide the correct lamba function prototype for a message which receives its arguments as an atom_span.
+    /// @see span_function
+
+    #define MIN_SPAN_FUNCTION [this](const c74::min::atom_span& args, const int inlet) -> c74::min::atoms
+
+
     // Represents any type of message.
     // Used internally to allow heterogenous containers of messages for the Min class.
 
@@ -82,12 +98,26 @@ namespace c74::min {
             m_owner->messages()[name] = this;    // add the message to the owning object's pile
         }
 
+
+        // Constructor for messages whose function receives an atom_span.
+        // Calls with an atoms container are forwarded to that function by viewing the container.
+
+        message_base(object_base* an_owner, const std::string& a_name, const span_function& a_function, const description& a_description = {}, const message_type type = message_type::gimme)
+        : message_base(an_owner, a_name, adapt(a_function), a_description, type) {
+            m_span_function = a_function;
+        }
+
     public:
         // All messages must define what happens when you call them.
 
         virtual atoms operator()(const atoms& args = {}, const int inlet = -1) = 0;
         virtual atoms operator()(const atom arg, const int inlet = -1)        = 0;
 
+        // Called by the wrapper with the atoms received from Max.
+        // Messages with a span_function that can run immediately receive these atoms without them being copied.
+
+        virtual atoms operator()(const atom_span& args, const int inlet)     = 0;
+
 
         /// Return the Max C API message type constant for this message.
         /// @return The type of the message as a numeric constant.
@@ -121,14 +151,30 @@ namespace c74::min {
         }
 
     protected:
-        object_base* m_owner;
-        function     m_function;
-        message_type m_type { message_type::gimme };
-        symbol       m_name;
-        description  m_description;
+        object_base*    m_owner;
+        function        m_function;
+        span_function   m_span_function;
+        message_type    m_type { message_type::gimme };
+        symbol          m_name;
+        description     m_description;
 
         friend class object_base;
 
+        static function adapt(const span_function& a_function) {
+            assert(a_function != nullptr);
+            return [a_function](const atoms& args, const int inlet) -> atoms {
+                return a_function(atom_span { args }, inlet);
+            };
+        }
+
+        // Call the message's function immediately, copying the arguments only if the function requires an atoms container.
+
+        atoms call(const atom_span& args, const int inlet) {
+            if (m_span_function)
+                return m_span_function(args, inlet);
+            return m_function(atoms(args.begin(), args.end()), inlet);
+        }
+
         void update_inlet_number(int& inlet) {
             if (inlet == -1 && m_owner->maxobj()) {
                 if (m_owner->inlets().size() > 1)    // avoid this potentially expensive call if there is only one inlet
@@ -187,6 +233,8 @@ namespace c74::min {
     template<threadsafe threadsafety = threadsafe::undefined>
     class message : public message_base {
     public:
+        static_assert(threadsafety != threadsafe::snapshot, "threadsafe::snapshot applies only to attributes");
+
         /// Create a new message for a Min class.
         ///
         /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
@@ -228,6 +276,50 @@ namespace c74::min {
         : message(an_owner, a_name, a_function, a_description, a_type)
         {}
 
+
+        /// Create a new message for a Min class whose function receives its arguments as an atom_span.
+        /// When called from Max on a thread where it can run immediately the arguments are not copied.
+        /// Arguments received on a thread from which the message must be deferred are copied for the deferral.
+        ///
+        /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+        /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+        /// @param	a_function		The function to be called when the message is received by your object.
+        ///							This is typically provided as a lamba function using the #MIN_SPAN_FUNCTION definition.
+        /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+        /// @param	a_type			Optional message type determines what kind of messages Max can send.
+        ///							In most cases you should _not_ pass anything here and accept the default.
+
+        message(object_base* an_owner, const std::string& a_name, const span_function& a_function, const description& a_description = {}, const message_type a_type = message_type::gimme)
+        : message_base(an_owner, a_name, a_function, a_description, a_type)
+        {}
+
+
+        /// Create a new message for a Min class whose function receives its arguments as an atom_span.
+        ///
+        /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+        /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+        /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+        /// @param	a_function		The function to be called when the message is received by your object.
+        ///							This is typically provided as a lamba function using the #MIN_SPAN_FUNCTION definition.
+
+        message(object_base* an_owner, const std::string& a_name, const description& a_description, const span_function& a_function)
+        : message_base(an_owner, a_name, a_function, a_description)
+        {}
+
+
+        /// Create a new message for a Min class whose function receives its arguments as an atom_span.
+        ///
+        /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+        /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+        /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+        /// @param	a_type			Optional message type determines what kind of messages Max can send.
+        /// @param	a_function		The function to be called when the message is received by your object.
+        ///							This is typically provided as a lamba function using the #MIN_SPAN_FUNCTION definition.
+
+        message(object_base* an_owner, const std::string& a_name, const description& a_description, message_type a_type, const span_function& a_function)
+        : message(an_owner, a_name, a_function, a_description, a_type)
+        {}
+
         virtual ~message() {}
 
         /// Call the message's action.
@@ -271,11 +363,27 @@ namespace c74::min {
             return (*this)(as, inlet);
         }
 
+
+        /// Call the message's action with atoms that are not owned by the caller.
+        /// @param	args	The arguments to send to the message's action.
+        /// @param	inlet	The inlet number associated with the incoming message, or -1 to look it up.
+        /// @return			Any return values will be returned as atoms.
+
+        atoms operator()(const atom_span& args, const int an_inlet) override {
+            int inlet {an_inlet};
+            update_inlet_number(inlet);
+
+            if (m_owner->is_assumed_threadsafe() || max::systhread_ismainthread())
+                return call(args, inlet);
+            else
+                return (*this)(atoms(args.begin(), args.end()), inlet);    // deferring requires a copy
+        }
+
     private:
         // Any messages received from outside the main thread will be deferred using the queue below.
 
         friend class deferred_message;
-        fifo<deferred_message> m_deferred_messages { 2 };
+        mpmc_fifo<deferred_message> m_deferred_messages { 2 };    // written by any thread other than the main thread
     };
 
 
@@ -299,6 +407,21 @@ namespace c74::min {
         {}
 
 
+        /// Create a new message for a Min class whose function receives its arguments as an atom_span.
+        ///
+        /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+        /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+        /// @param	a_function		The function to be called when the message is received by your object.
+        ///							This is typically provided as a lamba function using the #MIN_SPAN_FUNCTION definition.
+        /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+        /// @param	type			Optional message type determines what kind of messages Max can send.
+        ///							In most cases you should _not_ pass anything here and accept the default.
+
+        message(object_base* an_owner, const std::string& a_name, const span_function& a_function, const description& a_description = {}, const message_type type = message_type::gimme)
+        : message_base(an_owner, a_name, a_function, a_description)
+        {}
+
+
         /// Create a new message for a Min class.
         ///
         /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
@@ -312,6 +435,19 @@ namespace c74::min {
         {}
 
 
+        /// Create a new message for a Min class whose function receives its arguments as an atom_span.
+        ///
+        /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+        /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+        /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+        /// @param	a_function		The function to be called when the message is received by your object.
+        ///							This is typically provided as a lamba function using the #MIN_SPAN_FUNCTION definition.
+
+        message(object_base* an_owner, const std::string& a_name, const description& a_description, const span_function& a_function)
+        : message_base(an_owner, a_name, a_function, a_description)
+        {}
+
+
         /// Call the message's action.
         /// @param	args	Optional arguments to send to the message's action.
         /// @return			Any return values will be returned as atoms.
@@ -352,11 +488,27 @@ namespace c74::min {
             return (*this)(as, inlet);
         }
 
+
+        /// Call the message's action with atoms that are not owned by the caller.
+        /// @param	args	The arguments to send to the message's action.
+        /// @param	inlet	The inlet number associated with the incoming message, or -1 to look it up.
+        /// @return			Any return values will be returned as atoms.
+
+        atoms operator()(const atom_span& args, const int an_inlet) override {
+            int inlet {an_inlet};
+            update_inlet_number(inlet);
+
+            if (max::systhread_ismainthread())
+                return call(args, inlet);
+            else
+                return (*this)(atoms(args.begin(), args.end()), inlet);    // deferring requires a copy
+        }
+
     private:
         // Any messages received from outside the main thread will be deferred using the queue below.
 
         friend class deferred_message;
-        fifo<deferred_message> m_deferred_messages { 2 };
+        mpmc_fifo<deferred_message> m_deferred_messages { 2 };    // written by any thread other than the main thread
     };
 
 
@@ -380,6 +532,21 @@ namespace c74::min {
         {}
 
 
+        /// Create a new message for a Min class whose function receives its arguments as an atom_span.
+        ///
+        /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+        /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+        /// @param	a_function		The function to be called when the message is received by your object.
+        ///							This is typically provided as a lamba function using the #MIN_SPAN_FUNCTION definition.
+        /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+        /// @param	a_type			Optional message type determines what kind of messages Max can send.
+        ///							In most cases you should _not_ pass anything here and accept the default.
+
+        message(object_base* an_owner, const std::string& a_name, const span_function& a_function, const description& a_description = {}, const message_type a_type = message_type::gimme)
+        : message_base(an_owner, a_name, a_function, a_description, a_type)
+        {}
+
+
         /// Create a new message for a Min class.
         ///
         /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
@@ -393,6 +560,19 @@ namespace c74::min {
         {}
 
 
+        /// Create a new message for a Min class whose function receives its arguments as an atom_span.
+        ///
+        /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+        /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+        /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+        /// @param	a_function		The function to be called when the message is received by your object.
+        ///							This is typically provided as a lamba function using the #MIN_SPAN_FUNCTION definition.
+
+        message(object_base* an_owner, const std::string& a_name, const description& a_description, const span_function& a_function)
+        : message_base(an_owner, a_name, a_function, a_description)
+        {}
+
+
         /// Call the message's action.
         /// @param	args	Optional arguments to send to the message's action.
         /// @param	inlet	Optional inlet number associated with the incoming message.
@@ -413,6 +593,18 @@ namespace c74::min {
         atoms operator()(const atom arg, const int inlet = -1) override {
             return m_function({arg}, inlet);
         }
+
+
+        /// Call the message's action with atoms that are not owned by the caller.
+        /// @param	args	The arguments to send to the message's action.
+        /// @param	inlet	The inlet number associated with the incoming message, or -1 to look it up.
+        /// @return			Any return values will be returned as atoms.
+
+        atoms operator()(const atom_span& args, const int an_inlet) override {
+            int inlet {an_inlet};
+            update_inlet_number(inlet);
+            return call(args, inlet);
+        }
     };
 
 }    // namespace c74::min
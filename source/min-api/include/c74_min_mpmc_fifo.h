@@ -0,0 +1,222 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace c74::min {
+
+
+    /// A bounded lock-free queue that any number of threads may write to and read from at the same time,
+    /// e.g. values that arrive from both the main and the scheduler thread.
+    /// It has the same interface as #fifo (the single-producer single-consumer moodycamel::ReaderWriterQueue),
+    /// except that it never grows: enqueue() fails like try_enqueue() when the queue is full, so no call ever allocates memory.
+    ///
+    /// Each cell carries a sequence number that tells writers whether it is free for their position and readers whether it
+    /// holds the value of their position, so a writer or reader only competes for its position with one atomic operation.
+    ///
+    /// @tparam	T	The type of the items.
+
+    template<class T>
+    class mpmc_fifo {
+    public:
+        /// Create a queue.
+        /// @param	size	The number of items that can be enqueued, which is rounded up to a power of two.
+
+        explicit mpmc_fifo(const size_t size = 15) {
+            size_t capacity { 2 };
+            while (capacity < size)
+                capacity <<= 1;
+
+            m_cells = std::make_unique<cell[]>(capacity);
+            m_mask  = capacity - 1;
+            for (size_t i = 0; i < capacity; ++i)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+
+        ~mpmc_fifo() {
+            while (pop())
+                ;
+        }
+
+
+        mpmc_fifo(const mpmc_fifo&) = delete;
+        mpmc_fifo& operator=(const mpmc_fifo&) = delete;
+
+
+        /// Enqueue an item if there is room. May be called from any number of threads at the same time.
+        /// @param	item	The item.
+        /// @return			True if the item was enqueued, false if the queue is full.
+
+        bool try_enqueue(const T& item) {
+            return try_emplace(item);
+        }
+
+        bool try_enqueue(T&& item) {
+            return try_emplace(std::move(item));
+        }
+
+
+        /// Construct an item in place if there is room. May be called from any number of threads at the same time.
+        /// @param	args	The arguments to the constructor of the item.
+        /// @return			True if the item was enqueued, false if the queue is full.
+
+        template<class... Args>
+        bool try_emplace(Args&&... args) {
+            auto  position { m_enqueue.load(std::memory_order_relaxed) };
+            cell* c {};
+
+            for (;;) {
+                c = &m_cells[position & m_mask];
+
+                const auto difference { static_cast<std::ptrdiff_t>(c->sequence.load(std::memory_order_acquire) - position) };
+
+                if (difference == 0) {
+                    if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                    return false;
+                else
+                    position = m_enqueue.load(std::memory_order_relaxed);
+            }
+
+            new (&c->storage) T(std::forward<Args>(args)...);
+            c->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+
+        /// The same as try_enqueue(), as the queue never grows.
+
+        bool enqueue(const T& item) {
+            return try_emplace(item);
+        }
+
+        bool enqueue(T&& item) {
+            return try_emplace(std::move(item));
+        }
+
+        template<class... Args>
+        bool emplace(Args&&... args) {
+            return try_emplace(std::forward<Args>(args)...);
+        }
+
+
+        /// Dequeue the oldest item. May be called from any number of threads at the same time.
+        /// @param	result	Assigned the item.
+        /// @return			True if an item was dequeued, false if the queue is empty.
+
+        template<class U>
+        bool try_dequeue(U& result) {
+            const auto c { claim() };
+            if (!c.first)
+                return false;
+
+            auto item { c.first->item() };
+            result = std::move(*item);
+            release(c);
+            return true;
+        }
+
+
+        /// Get the oldest item without dequeuing it.
+        /// Only valid while there is a single consumer, as another consumer could dequeue the item at any time.
+        /// @return	A pointer to the item, or nullptr if the queue is empty.
+
+        T* peek() {
+            const auto position { m_dequeue.load(std::memory_order_relaxed) };
+            auto&      c { m_cells[position & m_mask] };
+
+            if (c.sequence.load(std::memory_order_acquire) != position + 1)
+                return nullptr;
+            return c.item();
+        }
+
+
+        /// Dequeue the oldest item and discard it. May be called from any number of threads at the same time.
+        /// @return	True if an item was removed, false if the queue is empty.
+
+        bool pop() {
+            const auto c { claim() };
+            if (!c.first)
+                return false;
+
+            release(c);
+            return true;
+        }
+
+
+        /// The number of items in the queue, which may already have changed by the time it is returned.
+        /// @return	The approximate number of items.
+
+        size_t size_approx() const {
+            const auto dequeued { m_dequeue.load(std::memory_order_relaxed) };
+            const auto enqueued { m_enqueue.load(std::memory_order_relaxed) };
+            return enqueued > dequeued ? enqueued - dequeued : 0;
+        }
+
+
+        /// The number of items that the queue can hold.
+        /// @return	The capacity.
+
+        size_t max_capacity() const {
+            return m_mask + 1;
+        }
+
+    private:
+        struct cell {
+            std::atomic<size_t>                                         sequence { 0 };
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type  storage;
+
+            T* item() {
+                return std::launder(reinterpret_cast<T*>(&storage));
+            }
+        };
+
+        static constexpr size_t k_cache_line { 64 };
+
+        std::unique_ptr<cell[]>                 m_cells;
+        size_t                                  m_mask {};
+        alignas(k_cache_line) std::atomic<size_t> m_enqueue { 0 };
+        alignas(k_cache_line) std::atomic<size_t> m_dequeue { 0 };
+
+
+        // Claim the cell of the oldest item for reading, returning it and its position, or nullptr if the queue is empty.
+
+        std::pair<cell*, size_t> claim() {
+            auto position { m_dequeue.load(std::memory_order_relaxed) };
+
+            for (;;) {
+                auto&      c { m_cells[position & m_mask] };
+                const auto difference { static_cast<std::ptrdiff_t>(c.sequence.load(std::memory_order_acquire) - (position + 1)) };
+
+                if (difference == 0) {
+                    if (m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        return { &c, position };
+                }
+                else if (difference < 0)
+                    return { nullptr, 0 };
+                else
+                    position = m_dequeue.load(std::memory_order_relaxed);
+            }
+        }
+
+
+        // Destroy the item of a claimed cell and free the cell for the writer one lap later.
+
+        void release(const std::pair<cell*, size_t>& c) {
+            c.first->item()->~T();
+            c.first->sequence.store(c.second + m_mask + 1, std::memory_order_release);
+        }
+    };
+
+
+}    // namespace c74::min
@@ -0,0 +1,278 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// The locking statistics of all mutexes with the same name, e.g. the mutex of every instance of an object.
+    ///
+    /// They are collected when C74_MIN_MUTEX_STATISTICS is defined, e.g. with
+    /// `target_compile_definitions(${PROJECT_NAME} PRIVATE C74_MIN_MUTEX_STATISTICS)`.
+    /// min::mutex then records how often it is locked, how often a thread had to wait for it,
+    /// and how long threads waited and held it. Every Min object gets a 'mutexstats' message,
+    /// which posts the statistics of all named mutexes of all Min externals to the Max window, or clears them with 'mutexstats clear'.
+    ///
+    /// A mutex is named with set_mutex_name(), typically in the constructor of its object.
+
+    class mutex_statistics {
+    public:
+        using clock = std::chrono::steady_clock;
+
+#ifdef C74_MIN_MUTEX_STATISTICS
+        static constexpr bool enabled { true };
+#else
+        static constexpr bool enabled { false };
+#endif
+
+
+        /// A summary of the statistics.
+
+        struct summary {
+            uint64_t    locks {};           ///< The number of times the mutexes were locked.
+            uint64_t    contended {};       ///< The number of times a thread had to wait for the lock.
+            double      wait_mean {};       ///< The mean time in microseconds that a thread waited, of the contended locks.
+            double      wait_maximum {};    ///< The longest wait in microseconds.
+            double      hold_mean {};       ///< The mean time in microseconds that the lock was held.
+            double      hold_maximum {};    ///< The longest time in microseconds that the lock was held.
+        };
+
+
+        explicit mutex_statistics(const std::string& name)
+        : m_name { name }
+        {}
+
+
+        /// Find the statistics of a name, or create them. This allocates and locks the registry, so it is not for the audio thread.
+        /// @param	name	The name of the mutexes.
+        /// @return			The statistics, which exist until the process ends.
+
+        static mutex_statistics& named(const char* name);
+
+
+        /// Call a function with the statistics of every name of all Min externals, in the order the names were first used.
+        /// @param	f	A function that takes a const mutex_statistics&.
+
+        template<class F>
+        static void for_each(F&& f);
+
+
+        /// Clear the statistics of every name.
+
+        static void clear_all();
+
+
+        /// The name of the mutexes.
+
+        const std::string& name() const {
+            return m_name;
+        }
+
+
+        /// Record the acquisition of the lock.
+        /// @param	wait	How long the thread waited for the lock, or zero if it did not wait.
+
+        void record_lock(const clock::duration wait) {
+            const auto ns { to_ns(wait) };
+
+            m_locks.fetch_add(1, std::memory_order_relaxed);
+            if (ns > 0) {
+                m_contended.fetch_add(1, std::memory_order_relaxed);
+                m_wait_total.fetch_add(ns, std::memory_order_relaxed);
+                update_maximum(m_wait_maximum, ns);
+            }
+        }
+
+
+        /// Record the release of the lock.
+        /// @param	hold	How long the lock was held.
+
+        void record_unlock(const clock::duration hold) {
+            const auto ns { to_ns(hold) };
+
+            m_hold_total.fetch_add(ns, std::memory_order_relaxed);
+            update_maximum(m_hold_maximum, ns);
+        }
+
+
+        /// Summarize the statistics so far.
+        /// @return	The summary.
+
+        summary summarize() const {
+            summary s;
+
+            s.locks        = m_locks.load(std::memory_order_relaxed);
+            s.contended    = m_contended.load(std::memory_order_relaxed);
+            s.wait_maximum = m_wait_maximum.load(std::memory_order_relaxed) * 0.001;
+            s.hold_maximum = m_hold_maximum.load(std::memory_order_relaxed) * 0.001;
+            if (s.contended)
+                s.wait_mean = m_wait_total.load(std::memory_order_relaxed) * 0.001 / s.contended;
+            if (s.locks)
+                s.hold_mean = m_hold_total.load(std::memory_order_relaxed) * 0.001 / s.locks;
+            return s;
+        }
+
+
+        /// Clear the statistics. Locks that are held meanwhile may be counted partially.
+
+        void clear() {
+            for (auto counter : { &m_locks, &m_contended, &m_wait_total, &m_wait_maximum, &m_hold_total, &m_hold_maximum })
+                counter->store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        // The statistics of all min-based externals are listed in one registry, which is shared through the s_thing of a symbol.
+        // important! If you make significant changes to the registry or to this class,
+        // change the name of the symbol to avoid conflicts with externals that use an older version of min-api.
+
+        struct registry_type {
+            std::mutex                      access;
+            std::deque<mutex_statistics>    statistics;    // a deque, so that the elements do not move
+        };
+
+        static registry_type& registry() {
+            static registry_type* s_registry {};
+
+            if (!s_registry) {
+                auto s = max::gensym("__min_mutex_statistics_registry_1__");
+                if (!s->s_thing)
+                    s->s_thing = reinterpret_cast<max::t_object*>(new registry_type);
+                s_registry = reinterpret_cast<registry_type*>(s->s_thing);
+            }
+            return *s_registry;
+        }
+
+        static uint64_t to_ns(const clock::duration d) {
+            return static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(), 0));
+        }
+
+        static void update_maximum(std::atomic<uint64_t>& maximum, const uint64_t value) {
+            auto current { maximum.load(std::memory_order_relaxed) };
+            while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+                ;
+        }
+
+        std::string             m_name;
+        std::atomic<uint64_t>   m_locks { 0 };
+        std::atomic<uint64_t>   m_contended { 0 };
+        std::atomic<uint64_t>   m_wait_total { 0 };      ///< nanoseconds
+        std::atomic<uint64_t>   m_wait_maximum { 0 };    ///< nanoseconds
+        std::atomic<uint64_t>   m_hold_total { 0 };      ///< nanoseconds
+        std::atomic<uint64_t>   m_hold_maximum { 0 };    ///< nanoseconds
+    };
+
+
+    inline mutex_statistics& mutex_statistics::named(const char* name) {
+        auto&                       r { registry() };
+        std::lock_guard<std::mutex> l { r.access };
+
+        for (auto& s : r.statistics) {
+            if (s.name() == name)
+                return s;
+        }
+        r.statistics.emplace_back(name);
+        return r.statistics.back();
+    }
+
+
+    template<class F>
+    void mutex_statistics::for_each(F&& f) {
+        auto&                       r { registry() };
+        std::lock_guard<std::mutex> l { r.access };
+
+        for (const auto& s : r.statistics)
+            f(s);
+    }
+
+
+    inline void mutex_statistics::clear_all() {
+        auto&                       r { registry() };
+        std::lock_guard<std::mutex> l { r.access };
+
+        for (auto& s : r.statistics)
+            s.clear();
+    }
+
+
+    /// The mutex that is used as min::mutex when C74_MIN_REALTIME_CHECKS or C74_MIN_MUTEX_STATISTICS is defined.
+    /// With the realtime checks it reports blocking acquisitions during a perform routine;
+    /// try_lock() does not block and is not reported, so the usual try_to_lock in a perform routine passes.
+    /// With the statistics it records its locking in the mutex_statistics of its name, which is "unnamed" until it is named.
+
+    class checked_mutex {
+    public:
+        checked_mutex() {
+            if constexpr (mutex_statistics::enabled)
+                m_statistics = &mutex_statistics::named("unnamed");
+        }
+
+        void lock() {
+            realtime_check::locked();
+
+            if constexpr (mutex_statistics::enabled) {
+                mutex_statistics::clock::duration wait {};
+                if (!m_mutex.try_lock()) {
+                    const auto start { mutex_statistics::clock::now() };
+                    m_mutex.lock();
+                    m_acquired = mutex_statistics::clock::now();
+                    wait       = std::max(m_acquired - start, mutex_statistics::clock::duration { 1 });    // a contended lock counts as a wait
+                }
+                else
+                    m_acquired = mutex_statistics::clock::now();
+                statistics().record_lock(wait);
+            }
+            else
+                m_mutex.lock();
+        }
+
+        bool try_lock() {
+            if (!m_mutex.try_lock())
+                return false;
+            if constexpr (mutex_statistics::enabled) {
+                m_acquired = mutex_statistics::clock::now();
+                statistics().record_lock({});
+            }
+            return true;
+        }
+
+        void unlock() {
+            if constexpr (mutex_statistics::enabled)
+                statistics().record_unlock(mutex_statistics::clock::now() - m_acquired);
+            m_mutex.unlock();
+        }
+
+
+        /// Set the name under which the locking is recorded. This allocates, so it is typically called in a constructor.
+        /// @param	name	The name.
+
+        void name(const char* name) {
+            if constexpr (mutex_statistics::enabled)
+                m_statistics = &mutex_statistics::named(name);
+        }
+
+    private:
+        std::mutex                          m_mutex;
+        mutex_statistics*                   m_statistics { nullptr };
+        mutex_statistics::clock::time_point m_acquired;    ///< written by the thread that holds the lock
+
+        mutex_statistics& statistics() {
+            return *m_statistics;
+        }
+    };
+
+
+    /// Name a min::mutex for its statistics (see mutex_statistics). Does nothing when the statistics are not compiled in.
+    /// @param	m		The mutex.
+    /// @param	name	The name, e.g. the class and the purpose of the mutex.
+
+    inline void set_mutex_name(checked_mutex& m, const char* name) {
+        m.name(name);
+    }
+
+    inline void set_mutex_name(std::mutex&, const char*) {}
+
+
+}    // namespace c74::min
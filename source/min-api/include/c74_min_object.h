@@ -142,6 +142,15 @@ namespace c74::min {
             //
             // This could occur if a class uses another class directly or in the case of unit testing.
             // In such cases we need to do something reasonable so that our invariants can be held true
+
+            // Every instance of a class has the same messages and attributes, so their names are kept once for the class.
+            // The first instance builds these layouts and the others only reference them.
+
+            static dispatch_table<message_base>::layout   s_message_layout;
+            static dispatch_table<attribute_base>::layout s_attribute_layout;
+
+            messages().share(s_message_layout);
+            attributes().share(s_attribute_layout);
         }
 
         /// Destructor.
@@ -85,14 +85,19 @@ namespace c74::min {
         // Inheriting classes can retrieve information from this dictionary using the state() method.
 
         object_base()
-        : m_state { (max::t_dictionary*)k_sym__pound_d, false }
-        {}
+        : m_state { (max::t_dictionary*)k_sym__pound_d, false } {
+            // an instance created by the wrapper is a batch of attribute changes until the wrapper has applied all attributes
+            if (m_min_magic == k_magic)
+                m_attribute_batch = 1;
+        }
 
 
         // Destructor is only called when freeing a min::object<>, and never directly.
 
         virtual ~object_base() {
             // TODO: free proxy inlets!
+            if (m_attribute_batch_qelem)
+                max::qelem_free(m_attribute_batch_qelem);
         }
 
 
@@ -197,14 +202,14 @@ namespace c74::min {
         /// Get a reference to this object's messages.
         /// @return	A reference to this object's messages.
 
-        auto messages() -> std::unordered_map<std::string, message_base*>& {
+        auto messages() -> dispatch_table<message_base>& {
             return m_messages;
         }
 
         /// Get a reference to this object's messages.
         /// @return	A reference to this object's messages.
 
-        auto messages() const -> const std::unordered_map<std::string, message_base*>& {
+        auto messages() const -> const dispatch_table<message_base>& {
             return m_messages;
         }
 
@@ -212,7 +217,7 @@ namespace c74::min {
         /// Get a reference to this object's attributes.
         /// @return	A reference to this object's attributes.
 
-        auto attributes() -> std::unordered_map<std::string, attribute_base*>& {
+        auto attributes() -> dispatch_table<attribute_base>& {
             return m_attributes;
         }
 
@@ -220,7 +225,7 @@ namespace c74::min {
         /// Get a reference to this object's attributes.
         /// @return	A reference to this object's attributes.
 
-        auto attributes() const -> const std::unordered_map<std::string, attribute_base*>& {
+        auto attributes() const -> const dispatch_table<attribute_base>& {
             return m_attributes;
         }
 
@@ -233,6 +238,67 @@ namespace c74::min {
         }
 
 
+        /// Notify the object that an attribute changed state that is derived from several attributes.
+        /// Call this from a setter instead of computing the derived state there, and compute it in a message named "attributes_complete".
+        /// That message is called once the new value is assigned, or once after all attributes of a batch are set:
+        /// at instantiation after the default values, the arguments and the attribute arguments (or saved attributes) are applied,
+        /// and when several attributes are set by the same event of the main thread, e.g. a pattr preset recall.
+        /// @see	attributes_pending()
+
+        void attributes_changed() {
+            m_attributes_changed = true;
+        }
+
+
+        /// Will "attributes_complete" be called after the attribute that is set now?
+        /// A setter may compute what depends on its own attribute alone when this is false,
+        /// and should call attributes_changed() otherwise.
+        /// @return	True during construction and during a batch, or if a change has not been completed yet. Otherwise false.
+
+        bool attributes_pending() const {
+            return m_constructing_attribute || m_attribute_batch.load() > 0 || m_attributes_changed.load();
+        }
+
+
+        /// Begin a batch of attribute changes. Batches may be nested.
+        /// @see	attribute_batch
+
+        void begin_attribute_batch() {
+            ++m_attribute_batch;
+        }
+
+
+        /// End a batch of attribute changes, calling "attributes_complete" if it is the outermost batch and an attribute changed.
+
+        void end_attribute_batch() {
+            --m_attribute_batch;
+            complete_attributes();
+        }
+
+
+        // DO NOT USE
+        // Called by an attribute after a value is assigned.
+        // Calls "attributes_complete" if an attribute changed, unless a batch is in progress.
+
+        void complete_attributes();
+
+
+        // DO NOT USE
+        // Called by an attribute while its constructor sets the default value,
+        // when the attributes declared after it are not constructed yet.
+
+        void constructing_attribute(const bool constructing) {
+            m_constructing_attribute = constructing;
+        }
+
+
+        // Called by the wrapper when Max sets an attribute on the main thread.
+        // Begins a batch that ends when the main thread is idle again,
+        // so that the attributes set one after another by the same event form one batch.
+
+        void batch_attributes_until_idle();
+
+
         /// Get the dictionary representing this object's state in the patcher.
         /// @return	A dictionary with the object's state.
         /// @see	"Saving State" in GuideToWritingObjects.md
@@ -317,10 +383,15 @@ namespace c74::min {
         std::vector<inlet_base*>                         m_inlets;
         std::vector<outlet_base*>                        m_outlets;
         std::vector<argument_base*>                      m_arguments;
-        std::unordered_map<std::string, message_base*>   m_messages;      // written at class init -- readonly thereafter
-        std::unordered_map<std::string, attribute_base*> m_attributes;    // written at class init -- readonly thereafter
+        dispatch_table<message_base>                     m_messages;      // written at construction -- readonly thereafter, names shared by the class
+        dispatch_table<attribute_base>                   m_attributes;    // written at construction -- readonly thereafter, names shared by the class
         dict                                             m_state;
         symbol                                           m_classname;    // what's typed in the max box
+        bool                                             m_constructing_attribute { false };
+        std::atomic<int>                                 m_attribute_batch { 0 };
+        std::atomic<bool>                                m_attributes_changed { true };    // the default values are completed once, too
+        bool                                             m_attribute_batch_deferred { false };
+        max::t_qelem*                                    m_attribute_batch_qelem { nullptr };
 
         friend class inlet_base;
         friend class outlet_base;
@@ -374,6 +445,8 @@ namespace c74::min {
 
         void postinitialize() {
             m_initialized = true;
+            m_messages.seal();
+            m_attributes.seal();
         }
 
 
@@ -405,6 +478,29 @@ namespace c74::min {
     };
 
 
+    /// A batch of attribute changes for the lifetime of this object.
+    /// The "attributes_complete" message of the object is called once when the outermost batch ends,
+    /// if one of its setters called attributes_changed() in the meantime.
+
+    class attribute_batch {
+    public:
+        explicit attribute_batch(object_base& an_owner)
+        : m_owner { an_owner } {
+            m_owner.begin_attribute_batch();
+        }
+
+        ~attribute_batch() {
+            m_owner.end_attribute_batch();
+        }
+
+        attribute_batch(const attribute_batch&) = delete;
+        attribute_batch& operator=(const attribute_batch&) = delete;
+
+    private:
+        object_base& m_owner;
+    };
+
+
     // The 'minwrap' is the struct for our Max object instance as we would think of it using the traditional Max SDK.
     // The first member is one of the variants of a t_object (via the maxobject_header).
     // Following that is a data member for an instance of our C++ Min class.
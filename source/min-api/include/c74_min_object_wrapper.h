@@ -17,6 +17,27 @@ namespace c74::min {
     // All objects use A_GIMME signature for construction.
     // However, all Min classes may not define a constructor to handle those arguments.
 
+    // A class that defines a copy constructor, and no constructor taking the arguments, opts in to being created from a prototype.
+    // The prototype is constructed normally, outside of any patcher, when the first instance is created and is kept for the life of the class.
+    // Each new instance is then copy constructed from it, so the copy constructor can copy expensive default state
+    // (e.g. tables computed in the constructor) rather than computing it again.
+    // The members of the new instance are still constructed by their default initializers, as the copy constructor must not
+    // copy the messages, attributes, inlets or outlets of the prototype, which refer to the prototype itself.
+    // The arguments and attributes typed into the box are then applied to the new instance as usual.
+
+    template<class min_class_type>
+    struct is_prototyped {
+        static const bool value = std::is_copy_constructible<min_class_type>::value && !std::is_constructible<min_class_type, atoms>::value;
+    };
+
+
+    template<class min_class_type>
+    const min_class_type& prototype() {
+        static const std::unique_ptr<min_class_type> s_prototype { std::make_unique<min_class_type>() };
+        return *s_prototype;
+    }
+
+
     // Class has constructor -- The arguments will be handled manually
 
     template<class min_class_type, typename enable_if<std::is_constructible<min_class_type, atoms>::value, int>::type = 0>
@@ -26,12 +47,20 @@ namespace c74::min {
 
     // Class has no constructor -- Handle the arguments automatically
 
-    template<class min_class_type, typename enable_if<!std::is_constructible<min_class_type, atoms>::value, int>::type = 0>
+    template<class min_class_type, typename enable_if<!std::is_constructible<min_class_type, atoms>::value && !is_prototyped<min_class_type>::value, int>::type = 0>
     void min_ctor(minwrap<min_class_type>* self, const atoms& args) {
         new (&self->m_min_object) min_class_type;    // placement new
         self->m_min_object.process_arguments(args);
     }
 
+    // Class has a copy constructor -- Copy the default state from the prototype, then handle the arguments automatically
+
+    template<class min_class_type, typename enable_if<is_prototyped<min_class_type>::value, int>::type = 0>
+    void min_ctor(minwrap<min_class_type>* self, const atoms& args) {
+        new (&self->m_min_object) min_class_type(prototype<min_class_type>());    // placement new
+        self->m_min_object.process_arguments(args);
+    }
+
 
     template<class min_class_type>
     minwrap<min_class_type>* wrapper_new(const max::t_symbol* name, const long ac, const max::t_atom* av) {
@@ -55,15 +84,20 @@ namespace c74::min {
             if (self->m_min_object.is_ui_class()) {
                 max::t_dictionary* d = object_dictionaryarg(ac, const_cast<max::t_atom*>(av));
                 if (d) {
+                    wrapper_loadstate_binary(self, d);
                     max::attr_dictionary_process(self, d);
                     max::jbox_ready((max::t_jbox*)self);
                 }
             }
             else {
+                wrapper_loadstate_binary(self, reinterpret_cast<max::t_dictionary*>(static_cast<max::t_symbol*>(k_sym__pound_d)->s_thing));
                 max::object_attach_byptr_register(
                     self, self, k_sym_box);    // so that objects can get notifications about their own attributes
                 max::attr_args_process(self, static_cast<short>(args.size()), const_cast<max::t_atom*>(args.begin()));
             }
+
+            // ends the batch begun by the constructor, calling "attributes_complete" once for all of the above
+            self->m_min_object.end_attribute_batch();
             return self;
         }
         catch (std::exception& e) {
@@ -111,10 +145,18 @@ namespace c74::min {
     }
 
 
+    // Return the symbol for the name of a wrapper message, interned only on the first call
+    template<class message_name_type>
+    const symbol& wrapper_message_symbol() {
+        static const symbol s_name { message_name_type::name };
+        return s_name;
+    }
+
+
     template<class min_class_type, class message_name_type>
     void wrapper_method_zero(max::t_object* o) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
 
         meth();
     }
@@ -122,7 +164,7 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     void wrapper_method_int(max::t_object* o, const max::t_atom_long v) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as   = {v};
 
         meth(as);
@@ -131,7 +173,7 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     void wrapper_method_float(max::t_object* o, const double v) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as   = {v};
 
         meth(as);
@@ -140,7 +182,7 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     void wrapper_method_symbol(max::t_object* o, const max::t_symbol* v) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as   = {symbol(v)};
 
         meth(as);
@@ -149,7 +191,7 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     void wrapper_method_anything(max::t_object* o, const max::t_symbol* s, const long ac, const max::t_atom* av) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as(ac + 1L);
 
         as[0] = s;
@@ -161,7 +203,7 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     void wrapper_method_ptr(max::t_object* o, const void* v) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as   = {v};
 
         meth(as);
@@ -169,16 +211,45 @@ namespace c74::min {
 
     template<class min_class_type>
     void wrapper_method_savestate(max::t_object* o, const max::t_dictionary* d) {
-        auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()["savestate"];
-        atoms as   = {d};
-        meth(as);
+        auto self = wrapper_find_self<min_class_type>(o);
+
+        if (self->m_min_object.has_call("savestate")) {
+            auto& meth = *self->m_min_object.messages()["savestate"];
+            atoms as   = {d};
+            meth(as);
+        }
+
+        if (self->m_min_object.has_call("savestate_binary")) {
+            binary_state state;
+            self->m_min_object.try_call("savestate_binary", atom { static_cast<void*>(&state) });
+            if (state.size())
+                max::dictionary_appendstring(const_cast<max::t_dictionary*>(d), k_sym_min_binary_state, state.encode().c_str());
+        }
+    }
+
+
+    // Pass the bytes saved by 'savestate_binary' to 'loadstate_binary' when an object is created from a patcher.
+
+    template<class min_class_type>
+    void wrapper_loadstate_binary(minwrap<min_class_type>* self, max::t_dictionary* d) {
+        const char* text {};
+
+        if (!d || !self->m_min_object.has_call("loadstate_binary"))
+            return;
+        if (max::dictionary_getstring(d, k_sym_min_binary_state, &text) || !text)
+            return;
+
+        binary_state state;
+        if (state.decode(text))
+            self->m_min_object.try_call("loadstate_binary", atom { static_cast<void*>(&state) });
+        else
+            max::object_error(self->maxobj(), "could not decode the binary state saved with the patcher");
     }
 
     template<class min_class_type, class message_name_type>
     void wrapper_method_self_ptr(max::t_object* o, const void* arg1) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as{o, arg1};
 
         meth(as);
@@ -192,7 +263,7 @@ namespace c74::min {
         if ( self->m_min_object.messages().empty() )
             return 0;
         else {
-            auto& meth = *self->m_min_object.messages()[message_name_type::name];
+            auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
             atoms as{arg1};
             atoms r = meth(as);
             return r[0];
@@ -204,7 +275,7 @@ namespace c74::min {
         if (is_base_of<ui_operator_base, min_class_type>::value) {
             auto  self = wrapper_find_self<min_class_type>(o);
             auto& ui_op = const_cast<ui_operator_base&>(dynamic_cast<const ui_operator_base&>(self->m_min_object));
-            auto& meth = *self->m_min_object.messages()[message_name_type::name];
+            auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
             atoms as{ o, arg1 };
 
             ui_op.update_colors();
@@ -214,10 +285,48 @@ namespace c74::min {
             wrapper_method_self_ptr< min_class_type, message_name_type>(o, arg1);
     }
 
+    // Deliver the mouse drags that a ui object held back since the main thread was last serviced.
+    // Called by the qelem of the object, and before any other mouse event, so that the events keep their order.
+
+    template<class min_class_type>
+    void wrapper_deliver_drags(max::t_object* o) {
+        auto  self  = wrapper_find_self<min_class_type>(o);
+        auto& ui_op = const_cast<ui_operator_base&>(dynamic_cast<const ui_operator_base&>(self->m_min_object));
+
+        ui_op.take_drags([&](const symbol a_message, max::t_object* a_patcherview, const max::t_mouseevent& an_event) {
+            auto& meth = *self->m_min_object.messages()[a_message];
+            event e { o, a_patcherview, an_event };
+            atoms as { e };
+            meth(as);
+        });
+    }
+
+
+    // Deliver a mouse event to a message, holding back drags of ui objects so that they are delivered once per service of the main thread.
+
+    template<class min_class_type>
+    void wrapper_deliver_mouse(max::t_object* o, max::t_object* a_patcherview, const max::t_mouseevent& an_event, const symbol a_message, const bool is_drag, const bool relative) {
+        auto self = wrapper_find_self<min_class_type>(o);
+
+        if (is_base_of<ui_operator_base, min_class_type>::value) {
+            auto& ui_op = const_cast<ui_operator_base&>(dynamic_cast<const ui_operator_base&>(self->m_min_object));
+            if (is_drag) {
+                ui_op.defer_drag(reinterpret_cast<max::method>(wrapper_deliver_drags<min_class_type>), o, a_message, a_patcherview, an_event, relative);
+                return;
+            }
+            wrapper_deliver_drags<min_class_type>(o);
+        }
+
+        auto& meth = *self->m_min_object.messages()[a_message];
+        event e { o, a_patcherview, an_event };
+        atoms as { e };
+        meth(as);
+    }
+
+
     template<class min_class_type, class message_name_type>
     void wrapper_method_mouse(max::t_object* o, max::t_object* a_patcherview, const max::t_pt position, const max::t_atom_long modifiers) {
-        auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        const auto& name = wrapper_message_symbol<message_name_type>();
         max::t_mouseevent an_event {};
 
         an_event.type = max::eMouseEvent;
@@ -230,17 +339,14 @@ namespace c74::min {
         // tiltX;
         //tiltY;
 
-        //atoms as {o, a_patcherview, arg2.x, arg2.y, arg3};
-        event e { o, a_patcherview, an_event };
-        atoms as { e };
-        meth(as);
+        const bool relative { name == "mousedragdelta" };
+        wrapper_deliver_mouse<min_class_type>(o, a_patcherview, an_event, name, relative || name == "mousedrag", relative);
     }
 
 
     template<class min_class_type, class message_name_type>
     void wrapper_method_multitouch(max::t_object* o, max::t_object* a_patcherview, const max::t_mouseevent* an_event) {
-        auto  self = wrapper_find_self<min_class_type>(o);
-        auto  name = message_name_type::name;
+        string name { message_name_type::name };
 
         if (name == "mt_mouseenter")
             name = "mouseenter";
@@ -254,11 +360,8 @@ namespace c74::min {
             name = "mousemove";
         else if (name == "mt_mousedrag")
             name = "mousedrag";
-        auto& meth = *self->m_min_object.messages()[name];
 
-        event e { o, a_patcherview, *an_event };
-        atoms as { e };
-        meth(as);
+        wrapper_deliver_mouse<min_class_type>(o, a_patcherview, *an_event, name, name == "mousedrag", false);
     }
 
 
@@ -268,7 +371,7 @@ namespace c74::min {
 
         // This supports notify methods for UI objects which don't actually have a notify method member in the min class
         if (self->m_min_object.messages().find(message_name_type::name) != self->m_min_object.messages().end()) {
-            auto& meth = *self->m_min_object.messages()[message_name_type::name];
+            auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
             atoms as{o, s1, s2, p1, p2};    // NOTE: self could be the jitter object rather than the max object -- so we pass `o` which is
                                             // always the correct `self` for box operations
             auto ret = meth(as);
@@ -281,6 +384,13 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     max::t_max_err wrapper_method_notify(max::t_object* o, const max::t_symbol* s1, const max::t_symbol* s2, const void* p1, const void* p2) {
         if (is_base_of<ui_operator_base, min_class_type>::value) {
+            // the cached layers of the object may show any of its attributes
+            if (s2 == static_cast<const max::t_symbol*>(k_sym_attr_modified) && p1 == o) {
+                auto  self  = wrapper_find_self<min_class_type>(o);
+                auto& ui_op = const_cast<ui_operator_base&>(dynamic_cast<const ui_operator_base&>(self->m_min_object));
+                ui_op.invalidate_layers();
+            }
+
             auto err = wrapper_method_self_sym_sym_ptr_ptr___err<min_class_type, message_name_type>(o, s1, s2, p1, p2);
             if (!err)
                 return c74::max::jbox_notify(reinterpret_cast<c74::max::t_jbox*>(o), const_cast<max::t_symbol*>(s1), const_cast<max::t_symbol*>(s2), const_cast<void*>(p1), const_cast<void*>(p2));
@@ -294,7 +404,7 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     void wrapper_method_self_ptr_long_ptr_long_ptr_long(max::t_object* o, const void* arg1, const max::t_atom_long arg2, const max::t_atom_long* arg3, const max::t_atom_long arg4, const max::t_atom_long* arg5, const max::t_atom_long arg6) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as {o, arg1, arg2, arg3, arg4, arg5, arg6};   // NOTE: self could be the jitter object rather than the max object -- so we
                                                             // pass `o` which is always the correct `self` for box operations
         meth(as);
@@ -304,17 +414,28 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     max::t_atom_long wrapper_method_self_ptr_long_long_long(max::t_object* o, const void* arg1, const max::t_atom_long arg2, const max::t_atom_long arg3, const max::t_atom_long arg4) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as {o, arg1, arg2, arg3, arg4};   // NOTE: self could be the jitter object rather than the max object -- so we
                                                 // pass `o` which is always the correct `self` for box operations
         auto return_value = static_cast<max::t_atom_long>(meth(as)[0]);
         return return_value;
     }
 
+    template<class min_class_type, class message_name_type>
+    max::t_atom_long wrapper_method_long___long(max::t_object* o, const max::t_atom_long arg1) {
+        auto  self = wrapper_find_self<min_class_type>(o);
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
+        atoms as {arg1};
+        auto  ret = meth(as);
+        if (ret.empty())
+            return 0;
+        return static_cast<max::t_atom_long>(ret[0]);
+    }
+
     template<class min_class_type, class message_name_type>
     void wrapper_method_getplaystate(max::t_object* o, long* play, double* pos, long* loop) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         atoms as = meth();
 
         assert(as.size() == 3);
@@ -327,7 +448,7 @@ namespace c74::min {
     template<class min_class_type, class message_name_type>
     void wrapper_method_dictionary(max::t_object* o, const max::t_symbol* s) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *self->m_min_object.messages()[wrapper_message_symbol<message_name_type>()];
         auto  d    = dictobj_findregistered_retain(const_cast<max::t_symbol*>(s));
         atoms as   = {atom(d)};
 
@@ -354,27 +475,21 @@ namespace c74::min {
     }
 
     // this version is called for most message instances defined in the min class
+    // the atoms from Max are passed as a span so that messages defined with a span_function receive them without a copy
     template<class min_class_type>
     void wrapper_method_generic(max::t_object* o, const max::t_symbol* s, const long ac, const max::t_atom* av) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[s->s_name];
-        atoms as(ac);
+        auto& meth = *self->m_min_object.messages()[s];
 
-        for (auto i = 0; i < ac; ++i)
-            as[i] = av[i];
-        meth(as);
+        meth(atom_span { av, ac }, -1);
     }
 
     // same as wrapper_method_generic but can return values in an atom (A_GIMMEBACK)
     template<class min_class_type>
     void wrapper_method_generic_typed(max::t_object* o, const max::t_symbol* s, const long ac, const max::t_atom* av, max::t_atom* rv) {
         auto  self = wrapper_find_self<min_class_type>(o);
-        auto& meth = *self->m_min_object.messages()[s->s_name];
-        atoms as(ac);
-
-        for (auto i = 0; i < ac; ++i)
-            as[i] = av[i];
-        atoms ra = meth(as);
+        auto& meth = *self->m_min_object.messages()[s];
+        atoms ra   = meth(atom_span { av, ac }, -1);
 
         if (rv)
             *rv = ra[0];
@@ -469,6 +584,7 @@ namespace c74::min {
     MIN_WRAPPER_CREATE_TYPE_FROM_STRING(mt_mousemove)
     MIN_WRAPPER_CREATE_TYPE_FROM_STRING(mousedrag)
     MIN_WRAPPER_CREATE_TYPE_FROM_STRING(mt_mousedrag)
+    MIN_WRAPPER_CREATE_TYPE_FROM_STRING(multichanneloutputs)
     MIN_WRAPPER_CREATE_TYPE_FROM_STRING(mousedragdelta)
     MIN_WRAPPER_CREATE_TYPE_FROM_STRING(mousedoubleclick)
     MIN_WRAPPER_CREATE_TYPE_FROM_STRING(notify)
@@ -478,6 +594,28 @@ namespace c74::min {
     MIN_WRAPPER_CREATE_TYPE_FROM_STRING(patchlineupdate)
 
 
+#ifdef C74_MIN_MUTEX_STATISTICS
+
+    // The 'mutexstats' message of every Min object: post the statistics of all named mutexes, or clear them with 'mutexstats clear'.
+
+    template<class min_class_type>
+    void wrapper_method_mutexstats(max::t_object* o, const max::t_symbol* s, const long ac, const max::t_atom* av) {
+        if (ac > 0 && symbol(max::atom_getsym(av)) == MIN_SYMBOL("clear")) {
+            mutex_statistics::clear_all();
+            return;
+        }
+
+        mutex_statistics::for_each([o](const mutex_statistics& m) {
+            const auto s { m.summarize() };
+            max::object_post(o, "mutex %s: %llu locks, %llu contended (%.1f%%), wait mean %.1f us max %.1f us, hold mean %.1f us max %.1f us",
+                m.name().c_str(), static_cast<unsigned long long>(s.locks), static_cast<unsigned long long>(s.contended),
+                s.locks ? 100.0 * s.contended / s.locks : 0.0, s.wait_mean, s.wait_maximum, s.hold_mean, s.hold_maximum);
+        });
+    }
+
+#endif
+
+
     // Simplify the meth switches in the following code to reduce excessive and tedious code duplication
 
     #define MIN_WRAPPER_ADDMETHOD(c, methname, wrappermethod, methtype)                                                                    \
@@ -509,7 +647,7 @@ namespace c74::min {
 
         // messages
 
-        for (auto& a_message : instance.messages()) {
+        for (const auto& a_message : instance.messages()) {
             MIN_WRAPPER_ADDMETHOD(c, bang, zero, A_NOTHING)
             else MIN_WRAPPER_ADDMETHOD(c, dblclick, zero, A_CANT)
             else MIN_WRAPPER_ADDMETHOD(c, dspstate, int, A_CANT)
@@ -543,12 +681,15 @@ namespace c74::min {
             else MIN_WRAPPER_ADDMETHOD(c, focusgained, self_ptr, A_CANT)
             else MIN_WRAPPER_ADDMETHOD(c, focuslost, self_ptr, A_CANT)
             else MIN_WRAPPER_ADDMETHOD(c, key, self_ptr_long_long_long, A_CANT)
+            else MIN_WRAPPER_ADDMETHOD(c, multichanneloutputs, long___long, A_CANT)
             else if (static_cast<message_type>(*a_message.second) == message_type::ellipsis)
                 max::class_addmethod(c, reinterpret_cast<method>(wrapper_method_ellipsis<min_class_type>), a_message.first.c_str(), max::A_CANT, 0);
             else if (a_message.first == "dspsetup");    // skip -- handle it in operator classes
             else if (a_message.first == "maxclass_setup");          // for min class construction only, do not add for exposure to max
-            else if (a_message.first == "savestate")
+            else if (a_message.first == "savestate" || a_message.first == "savestate_binary")
                 max::class_addmethod(c, reinterpret_cast<max::method>(wrapper_method_savestate<min_class_type>), "appendtodictionary", max::A_CANT, 0);
+            else if (a_message.first == "loadstate_binary");    // called by the wrapper when the object is created
+            else if (a_message.first == "attributes_complete"); // called when a batch of attribute changes ends
             else {
               if (a_message.second->type() == max::A_GIMMEBACK) {
                 max::class_addmethod(c, reinterpret_cast<method>(wrapper_method_generic_typed<min_class_type>),
@@ -566,9 +707,13 @@ namespace c74::min {
             }
         }
 
+#ifdef C74_MIN_MUTEX_STATISTICS
+        max::class_addmethod(c, reinterpret_cast<method>(wrapper_method_mutexstats<min_class_type>), "mutexstats", max::A_GIMME, 0);
+#endif
+
         // attributes
 
-        for (auto& an_attribute : instance.attributes()) {
+        for (const auto& an_attribute : instance.attributes()) {
             std::string     attr_name  { an_attribute.first };
             attribute_base& attr       { *an_attribute.second };
 
@@ -766,7 +911,7 @@ namespace c74::min {
                 this_jit_class, reinterpret_cast<method>(jit_matrix_calc<min_class_type>), "matrix_calc", max::A_CANT, 0);
         }
 
-        for (auto& an_attribute : instance->attributes()) {
+        for (const auto& an_attribute : instance->attributes()) {
             std::string     attr_name = an_attribute.first;
             attribute_base& attr      = *an_attribute.second;
 
@@ -804,7 +949,7 @@ namespace c74::min {
 
         // add special messages to max class, and object messages to jitter class
         // must happen pror to max_jit_class_wrap_standard call
-        for (auto& a_message : instance->messages()) {
+        for (const auto& a_message : instance->messages()) {
             MIN_WRAPPER_ADDMETHOD(c, bang, zero, A_NOTHING)
             else MIN_WRAPPER_ADDMETHOD(c, dblclick, zero, A_CANT)
             else MIN_WRAPPER_ADDMETHOD(c, dspstate, int, A_CANT)
@@ -834,8 +979,10 @@ namespace c74::min {
             else MIN_WRAPPER_ADDMETHOD(c, oksize, oksize, A_CANT)
             else MIN_WRAPPER_ADDMETHOD(c, mousedragdelta, mouse, A_CANT)
             else MIN_WRAPPER_ADDMETHOD(c, mousedoubleclick, mouse, A_CANT)
-            else if (a_message.first == "savestate")
+            else if (a_message.first == "savestate" || a_message.first == "savestate_binary")
                 max::class_addmethod(c, reinterpret_cast<max::method>(wrapper_method_savestate<min_class_type>), "appendtodictionary", max::A_CANT, 0);
+            else if (a_message.first == "loadstate_binary");    // called by the wrapper when the object is created
+            else if (a_message.first == "attributes_complete"); // called when a batch of attribute changes ends
             else if (a_message.first == "dspsetup");          // skip -- handle it in operator classes
             else if (a_message.first == "maxclass_setup");    // for min class construction only, do not add for exposure to max
             else if (a_message.first == "jitclass_setup");    // for min class construction only, do not add for exposure to max
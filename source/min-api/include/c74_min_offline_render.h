@@ -0,0 +1,236 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// The settings of a render by an offline_render.
+
+    struct offline_render_settings {
+        long            vector_size { 64 };     ///< frames passed to each call of the perform routine
+        double          samplerate { 0.0 };     ///< samplerate the objects are prepared for, or 0 for that of the source (or of Max if the source has none)
+        size_t          tail_frames { 0 };      ///< frames of silence processed after the source, e.g. for the tail of a filter or a reverb
+        worker_pool*    pool { nullptr };       ///< threads to process independent channels, or nullptr to process them in the calling thread
+    };
+
+
+    /// Processes audio offline with the perform routine of a Min audio class, e.g. to normalize, filter or convolve the content of a buffer~
+    /// with exactly the DSP of an object, as fast as the processor allows rather than by playing it through the signal chain in real time.
+    ///
+    /// The offline_render creates its own instances of the class, which are in no patcher and no signal chain.
+    /// Each render prepares them as compiling the signal chain does, including the `dspsetup` message and the selection of a kernel,
+    /// with the inlets that receive the source connected. It then calls the perform routine for each vector of the source.
+    ///
+    /// With one instance the channels of the source are the inputs of its inlets, in order,
+    /// and the outputs of its signal outlets are the channels of the result.
+    /// With more instances the channels are independent: each channel of the source is the input of the first inlet of an instance of its own,
+    /// and the output of the first signal outlet of that instance is the same channel of the result.
+    /// These instances may be processed in parallel by a worker_pool.
+    ///
+    /// The instances are created and freed in the main thread, and keep their state from one render to the next.
+    /// A render from one buffer_staging to another may be made on any thread, e.g. on a background thread,
+    /// provided the attributes of the instances are not changed meanwhile.
+    /// The class must have been set up by its ext_main(), e.g. by being the class of the object that renders.
+    ///
+    /// @code
+    /// offline_render<lowpass>    m_render { { 1000.0 }, 2 };    // with an argument of 1000, one instance for each of two channels
+    /// worker_pool                m_pool { worker_pool::default_thread_count(), thread_priority::background };
+    ///
+    /// // in the main thread
+    /// m_render.render(m_source, m_target, { 64, 0.0, 0, &m_pool });
+    /// @endcode
+    /// @tparam	min_class_type	The Min class, a vector_operator or a sample_operator. Multichannel classes are not supported.
+    /// @ingroup buffers
+
+    template<class min_class_type>
+    class offline_render {
+        static_assert((is_base_of<vector_operator_base, min_class_type>::value || is_base_of<sample_operator_base, min_class_type>::value)
+            && !is_base_of<mc_operator_base, min_class_type>::value, "offline_render<> only supports vector_operator and sample_operator classes");
+
+    public:
+        /// Create the instances. Must be called in the main thread.
+        /// @param	args			The arguments of each instance, including attribute arguments.
+        /// @param	instance_count	The number of instances. With more than one the channels are independent.
+
+        explicit offline_render(const atoms& args = {}, const size_t instance_count = 1) {
+            for (auto i = 0u; i < std::max<size_t>(instance_count, 1); ++i) {
+                const auto self { wrapper_new<min_class_type>(symbol("offline_render"), static_cast<long>(args.size()), args.data()) };
+
+                if (!self) {
+                    free_instances();
+                    error("offline_render could not create an instance");
+                }
+                m_instances.push_back(self);
+            }
+        }
+
+
+        ~offline_render() {
+            free_instances();
+        }
+
+
+        offline_render(const offline_render&) = delete;
+        offline_render& operator=(const offline_render&) = delete;
+
+
+        /// The number of instances.
+        /// @return	The number of instances.
+
+        size_t instance_count() const {
+            return m_instances.size();
+        }
+
+
+        /// Access an instance, e.g. to set its attributes before a render.
+        /// @param	index	The instance.
+        /// @return			A reference to the Min object.
+
+        min_class_type& object(const size_t index = 0) {
+            return m_instances[index]->m_min_object;
+        }
+
+
+        /// Process audio.
+        /// @param	source		The audio to process.
+        /// @param	target		Receives the result: the frames of the source and the tail, at the samplerate of the render.
+        /// @param	settings	The vector size, samplerate and tail of the render.
+        /// @return				False if the source has more independent channels than there are instances, or the class has no signal outlet.
+
+        bool render(const buffer_staging& source, buffer_staging& target, const offline_render_settings& settings = {}) {
+            const auto independent { m_instances.size() > 1 };
+            const auto vector_size { std::max(settings.vector_size, 1L) };
+            const auto samplerate { settings.samplerate > 0.0 ? settings.samplerate : source.samplerate > 0.0 ? source.samplerate : max::sys_getsr() };
+            const auto instances { independent ? source.channel_count : 1 };
+            const auto channels { independent ? source.channel_count : signal_outlet_count() };
+
+            if (instances > m_instances.size() || channels == 0)
+                return false;
+
+            target.channel_count = channels;
+            target.samplerate    = samplerate;
+            target.samples.assign((source.frame_count() + settings.tail_frames) * channels, 0.0f);
+
+            // preparing may call the object in ways that are only safe in one thread at a time, e.g. its dspsetup message
+            for (auto i = 0u; i < instances; ++i)
+                prepare(i, independent ? 1 : source.channel_count, samplerate, vector_size);
+
+            auto render_instance = [&](const size_t i) {
+                perform(i, independent ? i : 0, source, target, vector_size);
+            };
+
+            if (settings.pool)
+                settings.pool->parallel_for(instances, render_instance);
+            else {
+                for (auto i = 0u; i < instances; ++i)
+                    render_instance(i);
+            }
+            return true;
+        }
+
+
+        /// Process the content of a buffer~ into a buffer~, which is resized to fit. Must be called in the main thread.
+        /// The target may be the same buffer~ as the source.
+        /// @param	source		The buffer reference whose buffer~ is processed.
+        /// @param	target		The buffer reference whose buffer~ receives the result.
+        /// @param	settings	The vector size, samplerate and tail of the render.
+        /// @return				True if the target buffer~ was filled.
+
+        bool render(buffer_reference& source, buffer_reference& target, const offline_render_settings& settings = {}) {
+            buffer_staging input;
+            buffer_staging output;
+
+            return buffer_loader::read(source, input) && render(input, output, settings) && buffer_loader::fill(target, output);
+        }
+
+    private:
+        vector<minwrap<min_class_type>*> m_instances;
+
+
+        void free_instances() {
+            for (auto self : m_instances)
+                max::object_free(self);
+            m_instances.clear();
+        }
+
+
+        size_t signal_outlet_count() {
+            size_t count {};
+
+            for (const auto o : object().outlets())
+                count += o->type() == "signal";
+            return count;
+        }
+
+
+        // Connect the first inlets and the signal outlets that are used, as Max would before calling dsp64.
+        // With independent channels only the first signal outlet is used.
+
+        void prepare(const size_t index, const size_t input_count, const double samplerate, const long vector_size) {
+            const auto  self { m_instances[index] };
+            const auto& inlets { self->m_min_object.inlets() };
+            const auto& outlets { self->m_min_object.outlets() };
+            const auto  independent { m_instances.size() > 1 };
+            vector<short> count(inlets.size() + outlets.size());
+            auto        signal_outlets { 0 };
+
+            for (auto i = 0u; i < inlets.size(); ++i)
+                count[i] = i < input_count;
+
+            for (auto i = 0u; i < outlets.size(); ++i) {
+                if (outlets[i]->type() == "signal")
+                    count[inlets.size() + i] = !independent || signal_outlets++ == 0;
+            }
+
+            min_dsp64_prepare(self, count.data(), samplerate, vector_size);
+            self->m_silence.reset();
+        }
+
+
+        // Process the source with one instance, a vector at a time, starting with channel `first` of the source and of the target.
+        // The last vector is filled up with silence, as the perform routine is always called with whole vectors.
+
+        void perform(const size_t index, const size_t first, const buffer_staging& source, buffer_staging& target, const long vector_size) {
+            const auto self { m_instances[index] };
+            const long input_count { static_cast<long>(self->m_min_object.inlets().size()) };
+            const long output_count { static_cast<long>(signal_outlet_count()) };
+            const auto independent { m_instances.size() > 1 };
+            const auto inputs_used { std::min<size_t>(independent ? 1 : source.channel_count, input_count) };
+            const auto outputs_used { independent ? std::min<size_t>(1, output_count) : output_count };
+            const auto frame_count { target.frame_count() };
+
+            vector<double>  storage(static_cast<size_t>((input_count + output_count) * vector_size));
+            vector<double*> inputs(static_cast<size_t>(input_count));
+            vector<double*> outputs(static_cast<size_t>(output_count));
+
+            for (auto i = 0u; i < inputs.size(); ++i)
+                inputs[i] = storage.data() + i * vector_size;
+            for (auto i = 0u; i < outputs.size(); ++i)
+                outputs[i] = storage.data() + (inputs.size() + i) * vector_size;
+
+            for (size_t frame = 0; frame < frame_count; frame += vector_size) {
+                const auto n { std::min<size_t>(vector_size, frame_count - frame) };
+
+                for (auto channel = 0u; channel < inputs_used; ++channel) {
+                    for (auto i = 0u; i < static_cast<size_t>(vector_size); ++i) {
+                        const auto source_frame { frame + i };
+                        inputs[channel][i] = source_frame < source.frame_count() ? source.samples[source_frame * source.channel_count + first + channel] : 0.0;
+                    }
+                }
+
+                profiled_perform(self, nullptr, inputs.data(), input_count, outputs.data(), output_count, vector_size, 0, nullptr);
+
+                for (auto channel = 0u; channel < outputs_used; ++channel) {
+                    for (auto i = 0u; i < n; ++i)
+                        target.samples[(frame + i) * target.channel_count + first + channel] = static_cast<float>(outputs[channel][i]);
+                }
+            }
+        }
+    };
+
+
+}    // namespace c74::min
@@ -41,13 +41,119 @@ namespace c74::min {
     };
 
 
+    // Do two matrices have the same type and cells at the same places, so that one may be copied to the other at once?
+
+    inline bool matrix_layouts_match(const max::t_jit_matrix_info& a, const max::t_jit_matrix_info& b) {
+        if (a.type != b.type || a.planecount != b.planecount || a.dimcount != b.dimcount || a.size != b.size)
+            return false;
+        for (auto i = 0; i < a.dimcount; ++i) {
+            if (a.dim[i] != b.dim[i] || a.dimstride[i] != b.dimstride[i])
+                return false;
+        }
+        return true;
+    }
+
+
+    /// The last frames of the input of a matrix_operator, kept for temporal effects (see matrix_operator::history_size()).
+    /// The frames are kept in a ring of buffers that are allocated once and reused,
+    /// and each input is copied into the ring once, before it is calculated.
+    /// The frames are read through matrix_info::previous().
+
+    class matrix_history {
+    public:
+
+        /// Set the number of frames kept, forgetting the frames kept so far if it changes.
+        /// @param	a_frame_count	The number of frames before the current one, or 0 to keep none.
+
+        void resize(const size_t a_frame_count) {
+            if (a_frame_count == m_size)
+                return;
+            m_size = a_frame_count;
+            m_frames.resize(a_frame_count ? a_frame_count + 1 : 0);    // one more for the current frame
+            m_next  = 0;
+            m_count = 0;
+        }
+
+
+        size_t size() const {
+            return m_size;
+        }
+
+
+        /// Copy the input that is about to be calculated into the ring.
+        /// The frames kept so far are forgotten if the input has a different layout.
+        /// @param	a_info	The layout of the input.
+        /// @param	a_data	The data of the input.
+        /// @return			The copy, which is calculated instead of the input, so that the input may be overwritten.
+
+        uchar* push(const max::t_jit_matrix_info& a_info, const uchar* a_data) {
+            if (!matrix_layouts_match(a_info, m_info)) {
+                m_info  = a_info;
+                m_count = 0;
+            }
+
+            auto& frame { m_frames[m_next] };
+            const auto size { static_cast<size_t>(a_info.size) };
+
+            if (frame.size() < size)
+                frame.resize(size);    // only grows, so frames of a constant size do not allocate
+            std::copy_n(a_data, size, frame.data());
+            m_current = frame.data();
+            return m_current;
+        }
+
+
+        /// Make the input that has been calculated the previous frame.
+
+        void advance() {
+            m_next  = (m_next + 1) % m_frames.size();
+            m_count = std::min(m_count + 1, m_size);
+        }
+
+
+        /// Return the number of frames that may be read, which is less than size() until that many frames have been calculated.
+        /// @return	The number of frames.
+
+        size_t count() const {
+            return m_count;
+        }
+
+
+        /// Return the data of an earlier frame.
+        /// @param	age	1 for the previous frame, up to count().
+        /// @return		The data, laid out as the current frame.
+
+        const uchar* frame(const size_t age) const {
+            return m_frames[(m_next + m_frames.size() - age) % m_frames.size()].data();
+        }
+
+
+        /// Return the data of the current frame.
+        /// @return	The copy returned by push().
+
+        const uchar* current() const {
+            return m_current;
+        }
+
+    private:
+        vector<vector<uchar>>   m_frames;
+        max::t_jit_matrix_info  m_info {};    // the layout of the frames kept
+        size_t                  m_size {};
+        size_t                  m_next {};    // the frame the next input is copied into
+        size_t                  m_count {};
+        uchar*                  m_current {};
+    };
+
+
     class matrix_info {
     public:
-        matrix_info(const max::t_jit_matrix_info* a_in_info, uchar* ip, max::t_jit_matrix_info* a_out_info, uchar* op)
+        matrix_info(const max::t_jit_matrix_info* a_in_info, uchar* ip, max::t_jit_matrix_info* a_out_info, uchar* op,
+            const matrix_history* a_history = nullptr)
         : m_in_info { a_in_info }
         , m_bip { ip }
         , m_out_info { a_out_info }
         , m_bop { op }
+        , m_history { a_history }
         {}
 
 
@@ -67,6 +173,32 @@ namespace c74::min {
             return m_in_info->dim[1];
         }
 
+        symbol type() const {
+            return m_in_info->type;
+        }
+
+
+        /// Return the number of earlier frames of the input that previous() can view.
+        /// @return	The number of frames, which is 0 unless the class keeps a history (see matrix_operator::history_size()).
+
+        size_t history_count() const {
+            return m_history ? m_history->count() : 0;
+        }
+
+
+        /// Return a view of an earlier frame of the input, whose in_cell() and in_pixel() read the cells of that frame
+        /// at the same places as this view reads the current frame.
+        /// @param	age	1 for the previous frame, up to history_count().
+        /// @return		The view, or this view of the current frame if that many frames have not been kept (yet).
+
+        matrix_info previous(const size_t age) const {
+            if (age < 1 || age > history_count())
+                return *this;
+
+            const auto offset { m_bip - m_history->current() };    // of the part of the matrix that this view is of
+            return { m_in_info, const_cast<uchar*>(m_history->frame(age)) + offset, m_out_info, m_bop, m_history };
+        }
+
 
         template<class matrix_type, size_t plane_count>
         const std::array<matrix_type, plane_count> in_cell(const matrix_coord& coord) const {
@@ -118,9 +250,109 @@ namespace c74::min {
         uchar*                  m_bip;
         max::t_jit_matrix_info* m_out_info;
         uchar*                  m_bop;
+        const matrix_history*   m_history;
+    };
+
+
+    /// A view of one row of a matrix, passed to the optional calc_row() method of a matrix_operator.
+    /// Cells are cell_stride() elements apart and the planes of a cell are plane_stride() elements apart.
+    /// When contiguous() is true the row is a packed array of size() * plane_count() elements
+    /// which can be processed with a single loop that the compiler is able to vectorize.
+    ///
+    /// @tparam T	The type of the elements of the matrix, const-qualified for the input row.
+
+    template<typename T>
+    class matrix_span {
+    public:
+
+        /// Create a view of a row.
+        /// @param	a_data			A pointer to the first plane of the first cell, or nullptr if there is no matrix.
+        /// @param	a_size			The number of cells in the row.
+        /// @param	a_plane_count	The number of planes in each cell.
+        /// @param	a_cell_stride	The number of elements between neighbouring cells.
+        ///							This is zero when a matrix with a width of 1 is extended across the row.
+        /// @param	a_plane_stride	The number of elements between neighbouring planes of a cell.
+
+        matrix_span(T* a_data, const long a_size, const long a_plane_count, const long a_cell_stride, const long a_plane_stride)
+        : m_data { a_data }
+        , m_size { a_size }
+        , m_plane_count { a_plane_count }
+        , m_cell_stride { a_cell_stride }
+        , m_plane_stride { a_plane_stride }
+        {}
+
+
+        /// Is there a matrix to view?
+        /// @return	False for the input row of a generator, which has no input matrix.
+
+        bool valid() const {
+            return m_data != nullptr;
+        }
+
+
+        /// Are the elements of the row packed without gaps?
+        /// @return	True if the row can be processed as a single array of size() * plane_count() elements.
+
+        bool contiguous() const {
+            return m_plane_stride == 1 && m_cell_stride == m_plane_count;
+        }
+
+
+        T* data() const {
+            return m_data;
+        }
+
+        long size() const {
+            return m_size;
+        }
+
+        long plane_count() const {
+            return m_plane_count;
+        }
+
+        long cell_stride() const {
+            return m_cell_stride;
+        }
+
+        long plane_stride() const {
+            return m_plane_stride;
+        }
+
+
+        /// Access a plane of a cell.
+        /// NOTE: No bounds checking is performed!
+        /// @param	cell	The index of the cell in the row.
+        /// @param	plane	The index of the plane in the cell.
+        /// @return			A reference to the element.
+
+        T& operator()(const long cell, const long plane) const {
+            return m_data[cell * m_cell_stride + plane * m_plane_stride];
+        }
+
+    private:
+        T*      m_data;
+        long    m_size;
+        long    m_plane_count;
+        long    m_cell_stride;
+        long    m_plane_stride;
     };
 
 
+    /// Return the same row of an earlier frame of the input as a row of the current frame, for a class keeping a history.
+    /// @param	info	The matrix_info passed to calc_row().
+    /// @param	a_row	The input row passed to calc_row().
+    /// @param	age		1 for the previous frame, up to info.history_count().
+    /// @return			The row, or the row itself if that many frames have not been kept (yet).
+
+    template<typename T>
+    matrix_span<const T> previous_row(const matrix_info& info, const matrix_span<const T>& a_row, const size_t age) {
+        const auto bytes { info.previous(age).m_bip - info.m_bip };
+        const auto data { reinterpret_cast<const T*>(reinterpret_cast<const uchar*>(a_row.data()) + bytes) };
+
+        return { data, a_row.size(), a_row.plane_count(), a_row.cell_stride(), a_row.plane_stride() };
+    }
+
+
     /// The base class for all template specializations of matrix_operator.
 
     class matrix_operator_base {
@@ -128,6 +360,7 @@ namespace c74::min {
     public:
         /// When the matrix is processed a call is made to the subclass calc_cell() method for each cell.
         /// The order in which the cells are iterated will be one of the options provided here.
+        /// A subclass that defines calc_row() instead chooses its own order within each row.
 
         enum class  iteration_direction { forward, reverse, bidirectional, enum_count };
         enum_map    iteration_direction_info {"forward", "reverse", "bidirectional"};
@@ -135,6 +368,46 @@ namespace c74::min {
 
 
     /// Inheriting from matrix_operator extends your class functionality to processing matrices.
+    ///
+    /// Your class defines calc_cell(), which is called for each cell of the matrix,
+    /// or calc_row(), which is called once for each row and is preferred when both are defined:
+    /// @code
+    /// template<typename T>
+    /// void calc_row(matrix_span<const T> input, matrix_span<T> output, const matrix_info& info, long row);
+    /// @endcode
+    /// A row kernel avoids the cost of gathering the planes of every cell into an array and calling calc_cell() for it,
+    /// and is able to process contiguous rows of char matrices as one packed array.
+    /// When Jitter's parallel breakup is used the row index is relative to the portion of the matrix being calculated.
+    ///
+    /// A class whose calculation for char matrices maps each value to a new value, independent of its position and plane,
+    /// may also define `uchar calc_char(uchar value)`.
+    /// Before each char matrix is calculated it is called for each of the 256 values to fill a lookup table,
+    /// and the rows are then calculated by looking up each element in the table.
+    /// Matrices of other types still use calc_row() or calc_cell().
+    ///
+    /// Rows are calculated in parallel either by Jitter's parallel breakup or, when thread_count() is set,
+    /// by dividing the rows of all the 2-dimensional slices of the matrix into bands for the shared worker_pool.
+    /// Bands keep the row indices and the matrix_info of each slice, so calc_cell() may read neighbouring rows.
+    /// Matrices are only calculated in parallel when the iteration direction is forward.
+    ///
+    /// The calc_row() or calc_char() of a pointwise class (see below) is instead passed runs of cells that continue
+    /// from one row, and one slice, to the next wherever both matrices are packed, up to 16384 cells at a time.
+    /// The row index passed with a run is then only the index of the run.
+    ///
+    /// The input and output may be the same matrix, e.g. when the output is named after the input matrix.
+    /// A class that calculates each cell from the same cell of the input only may declare `MIN_POINTWISE { true };`,
+    /// and is then calculated in place when the iteration direction is forward.
+    /// Otherwise the input is first copied into a buffer that is kept and reused for the following matrices,
+    /// so that neighbouring cells are read before they are overwritten.
+    ///
+    /// A class that leaves some matrices unchanged, e.g. because of its attributes, may also define
+    /// `bool passthrough(const matrix_info& info)`, returning true for those matrices.
+    /// They are then not calculated at all: a matrix calculated in place is left as it is,
+    /// and otherwise the input is copied to the output at once if both have the same layout.
+    ///
+    /// A temporal effect, e.g. frame differencing or motion blur, sets history_size() to keep the last frames of the input,
+    /// and reads them with matrix_info::previous() while calculating the current frame.
+    /// The input is then copied into the history instead of being copied for calculating in place.
 
     template<placeholder matrix_operator_placeholder_type = placeholder::none>
     class matrix_operator : public matrix_operator_base {
@@ -168,12 +441,178 @@ namespace c74::min {
             return m_direction;
         }
 
+
+        /// Set the number of threads among which the rows of a matrix are divided.
+        /// A value of 0 (the default) leaves parallel processing to Jitter, if parallel breakup is enabled.
+        /// A value of 1 calculates the matrix serially.
+        /// This is typically called by an attribute setter on the main thread, which also creates the shared worker_pool.
+        /// @param	a_thread_count	The number of row bands, or 0 to use Jitter's parallel breakup.
+
+        void thread_count(const int a_thread_count) {
+            if (a_thread_count > 1)
+                worker_pool::shared();
+            m_thread_count = std::max(a_thread_count, 0);
+        }
+
+
+        /// Return the number of threads among which the rows of a matrix are divided.
+        /// @return	The number of row bands, or 0 if Jitter's parallel breakup is used.
+
+        int thread_count() const {
+            return m_thread_count;
+        }
+
+
+        /// Fill the lookup table used for char matrices by a class defining calc_char().
+        /// This is called internally before each char matrix is calculated.
+        /// @param	f	The function to call for each of the 256 values, returning the new value.
+
+        template<class function_type>
+        void update_char_table(function_type&& f) {
+            for (auto i = 0; i < 256; ++i)
+                m_char_table[i] = f(static_cast<uchar>(i));
+        }
+
+
+        /// Return the lookup table used for char matrices by a class defining calc_char().
+        /// @return	The new value for each of the 256 values.
+
+        const std::array<uchar, 256>& char_table() const {
+            return m_char_table;
+        }
+
+
+        /// Copy an input matrix that is also the output before it is calculated.
+        /// This is called internally for classes that are not pointwise.
+        /// The buffer is kept for the next matrix and only grows, so matrices of a constant size do not allocate.
+        /// @param	data	The data of the matrix.
+        /// @param	size	The size of the data in bytes.
+        /// @return			The copy, valid until the next call.
+
+        uchar* copy_input(const uchar* data, const size_t size) {
+            if (m_input_copy.size() < size)
+                m_input_copy.resize(size);
+            std::copy_n(data, size, m_input_copy.data());
+            return m_input_copy.data();
+        }
+
+
+        /// Set the number of earlier frames of the input that are kept for matrix_info::previous().
+        /// This is typically called by an attribute setter on the main thread.
+        /// It takes effect with the next matrix, which allocates the frames, and forgets the frames kept so far.
+        /// @param	a_frame_count	The number of frames, or 0 (the default) to keep none.
+
+        void history_size(const int a_frame_count) {
+            m_history_size = std::max(a_frame_count, 0);
+        }
+
+
+        /// Return the number of earlier frames of the input that are kept.
+        /// @return	The number of frames.
+
+        int history_size() const {
+            return m_history_size;
+        }
+
+
+        /// Return the earlier frames of the input, which matrix_info::previous() views.
+        /// @return	The history.
+
+        const matrix_history& history() const {
+            return m_history;
+        }
+
+
+        /// Apply history_size() to the history, and return it for the input to be copied into.
+        /// This is called internally before each matrix is calculated.
+        /// @return	The history.
+
+        matrix_history& prepare_history() {
+            m_history.resize(static_cast<size_t>(static_cast<int>(m_history_size)));
+            return m_history;
+        }
+
+
+        /// Call a function for each band of rows in a matrix.
+        /// If thread_count() is greater than 1 and the matrix is large enough to amortize the dispatch
+        /// the bands are divided among the threads of the shared worker_pool and the calling thread.
+        /// Otherwise the function is called once with all of the rows.
+        /// The call returns when all bands have been calculated.
+        ///
+        /// @param	row_count	The number of rows in the matrix.
+        /// @param	cell_count	The total number of cells in the matrix.
+        /// @param	f			The function to call, prototyped as `void (long first_row, long end_row)`.
+        ///						It must be safe to call this function concurrently for different bands.
+
+        template<class function_type>
+        void for_each_row_band(const long row_count, const long cell_count, function_type&& f) {
+            const long thread_count { m_thread_count };
+
+            if (thread_count <= 1 || row_count <= 1 || cell_count < k_minimum_parallel_cells) {
+                f(0L, row_count);
+                return;
+            }
+
+            const auto band_count { std::min(thread_count, row_count) };
+
+            worker_pool::shared().parallel_for(static_cast<size_t>(band_count), [&](const size_t band) {
+                const auto b { static_cast<long>(band) };
+                f(row_count * b / band_count, row_count * (b + 1) / band_count);
+            });
+        }
+
     private:
+        static constexpr long k_minimum_parallel_cells { 16384 };    // cells in a matrix below which parallel dispatch does not pay off
+
         bool                m_enable_parallel_breakup;
         iteration_direction m_direction {};
+        std::atomic<int>    m_thread_count { 0 };    // set on the main thread, read on the threads calculating the matrix
+        std::array<uchar, 256> m_char_table {};
+        vector<uchar>       m_input_copy;    // reused by copy_input()
+        matrix_history      m_history;
+        std::atomic<int>    m_history_size { 0 };    // set on the main thread, applied by prepare_history() on the thread calculating the matrix
     };
 
 
+    /// Declare that your matrix_operator calculates each cell of the output from the same cell of the input only,
+    /// so that it may be calculated in place (see matrix_operator).
+
+    #define MIN_POINTWISE static constexpr bool class_pointwise
+
+
+    // SFINAE implementation used internally to determine if the Min class has
+    // declared itself as pointwise using the macro above.
+
+    template<typename min_class_type>
+    struct has_class_pointwise {
+        template<class, class>
+        class checker;
+
+        template<typename C>
+        static std::true_type test(checker<C, decltype(&C::class_pointwise)>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
+    // Used internally.
+    // Returns true if the Min class has declared that it is pointwise.
+
+    template<class min_class_type>
+    constexpr typename enable_if<has_class_pointwise<min_class_type>::value, bool>::type class_is_pointwise() {
+        return min_class_type::class_pointwise;
+    }
+
+    template<class min_class_type>
+    constexpr typename enable_if<!has_class_pointwise<min_class_type>::value, bool>::type class_is_pointwise() {
+        return false;
+    }
+
+
     // this is for the jitter object (the normal one is used for the max wrapper of that)
     static max::t_class* this_jit_class = nullptr;
 
@@ -197,6 +636,8 @@ namespace c74::min {
 
         self->m_min_object.try_call("setup");
 
+        // ends the batch begun by the constructor -- the attribute arguments of the Max wrapper are a batch of their own
+        self->m_min_object.end_attribute_batch();
         return self->maxobj();
     }
 
@@ -233,7 +674,12 @@ namespace c74::min {
             max_jit_mop_setup_simple(self, o, args.size(), args.begin());
         }
 
-        max_jit_attr_args(self, static_cast<short>(args.size()), args.begin());
+        {
+            attribute_batch batch { job->m_min_object };
+
+            max_jit_attr_args(self, static_cast<short>(args.size()), args.begin());
+            wrapper_loadstate_binary(job, reinterpret_cast<max::t_dictionary*>(static_cast<max::t_symbol*>(k_sym__pound_d)->s_thing));
+        }
         job->m_min_object.try_call("maxob_setup", atoms(args.begin(), args.begin() + attrstart));
 
         return self;
@@ -248,271 +694,494 @@ namespace c74::min {
     }
 
 
+    // SFINAE implementation used internally to determine if a matrix_operator<> class defines calc_row()
+    // for matrices with elements of type U.
+
+    template<class min_class_type, typename U, class = void>
+    struct has_calc_row : std::false_type {};
+
+    template<class min_class_type, typename U>
+    struct has_calc_row<min_class_type, U, std::void_t<decltype(std::declval<min_class_type&>().calc_row(
+        std::declval<matrix_span<const U>>(), std::declval<matrix_span<U>>(), std::declval<const matrix_info&>(), std::declval<long>()))>> : std::true_type {};
+
+
+    // SFINAE implementation used internally to determine if a matrix_operator<> class defines calc_char().
+
+    template<class min_class_type, class = void>
+    struct has_calc_char : std::false_type {};
+
+    template<class min_class_type>
+    struct has_calc_char<min_class_type, std::void_t<decltype(std::declval<min_class_type&>().calc_char(std::declval<uchar>()))>> : std::true_type {};
+
+
+    // SFINAE implementation used internally to determine if a matrix_operator<> class defines passthrough().
+
+    template<class min_class_type, class = void>
+    struct has_passthrough : std::false_type {};
+
+    template<class min_class_type>
+    struct has_passthrough<min_class_type, std::void_t<decltype(std::declval<min_class_type&>().passthrough(std::declval<const matrix_info&>()))>> : std::true_type {};
+
+
     // We are using a C++ template to process a vector of the matrix for any of the given types.
     // Thus, we don't need to duplicate the code for each datatype.
+    //
+    // This version is for input and output matrices with the same plane count, which is known at compile time,
+    // so the planes of each cell are gathered into and scattered from an array of exactly that size with unrolled loops.
+
+    template<class min_class_type, typename U, size_t plane_count, enable_if_matrix_operator<min_class_type> = 0>
+    void jit_calculate_cells_planes(
+        minwrap<min_class_type>* self, const matrix_info& info, const long n, const long i, const max::t_jit_op_info* in, max::t_jit_op_info* out) {
+        const auto is        = in ? in->stride : 0;
+        const auto os        = out->stride;
+        const auto step      = os ? os / static_cast<long>(plane_count) : 1;
+        const auto direction = self->m_min_object.direction();
+
+        const auto calc = [&](const U* source, U* destination, const long j) {
+            matrix_coord               position(j, i);
+            std::array<U, plane_count> tmp {};
+
+            if (source) {
+                for (size_t k = 0; k < plane_count; ++k)
+                    tmp[k] = *(source + step * k);
+            }
+
+            const std::array<U, plane_count> out_cell = self->m_min_object.calc_cell(tmp, info, position);
+
+            for (size_t k = 0; k < plane_count; ++k)
+                *(destination + step * k) = out_cell[k];
+        };
+
+        // forward or bidirectional
+        if (direction != matrix_operator_base::iteration_direction::reverse) {
+            auto ip = in ? static_cast<U*>(in->p) : nullptr;
+            auto op = static_cast<U*>(out->p);
+
+            for (auto j = 0; j < n; ++j) {
+                calc(ip, op, j);
+                if (ip)
+                    ip += is;
+                op += os;
+            }
+        }
+
+        // reverse or bidirectional
+        if (direction != matrix_operator_base::iteration_direction::forward) {
+            const bool bidirectional = direction == matrix_operator_base::iteration_direction::bidirectional;
+            auto       ip            = in ? static_cast<U*>(in->p) + is * (n - 1) : nullptr;
+            auto       op            = static_cast<U*>(out->p) + os * (n - 1);
+
+            for (auto j = n - 1; j >= 0; --j) {
+                calc(bidirectional ? op : ip, op, j);    // the second pass of bidirectional iteration reads the output of the first
+                if (ip)
+                    ip -= is;
+                op -= os;
+            }
+        }
+    }
+
+
+    // Dispatch to the version above for the common plane counts.
+    // Other plane counts, and input and output matrices with different plane counts, use a temporary array large enough for any matrix.
 
     template<class min_class_type, typename U, enable_if_matrix_operator<min_class_type> = 0>
-    void jit_calculate_vector(
+    void jit_calculate_cells(
         minwrap<min_class_type>* self, const matrix_info& info, const long n, const long i, const max::t_jit_op_info* in, max::t_jit_op_info* out) {
-        auto       ip         = in ? static_cast<U*>(in->p) : nullptr;
-        auto       op         = static_cast<U*>(out->p);
-        auto       is         = in ? in->stride : 0;
-        auto       os         = out->stride;
-        const auto step       = os / info.plane_count();
-        const bool planematch = (info.m_in_info->planecount == info.m_out_info->planecount);
-        auto       ip_last    = ip + (is * (n - 1));
-        auto       op_last    = op + (os * (n - 1));
-
-        if (planematch && info.plane_count() == 1) {
-            // forward or bidirectional
-            if (self->m_min_object.direction() != matrix_operator_base::iteration_direction::reverse) {
-                for (auto j = 0; j < n; ++j) {
-                    matrix_coord           position(j, i);
-                    U                      val = ip ? *(ip) : 0;
-                    const std::array<U, 1> tmp = {{val}};
-                    const std::array<U, 1> out_cell = self->m_min_object.calc_cell(tmp, info, position);
-
-                    *(op) = out_cell[0];
-                    if (ip)
-                        ip += is;
-                    op += os;
+        if (info.m_in_info->planecount == info.m_out_info->planecount) {
+            switch (info.m_out_info->planecount) {
+                case 1:
+                    jit_calculate_cells_planes<min_class_type, U, 1>(self, info, n, i, in, out);
+                    return;
+                case 2:
+                    jit_calculate_cells_planes<min_class_type, U, 2>(self, info, n, i, in, out);
+                    return;
+                case 3:
+                    jit_calculate_cells_planes<min_class_type, U, 3>(self, info, n, i, in, out);
+                    return;
+                case 4:
+                    jit_calculate_cells_planes<min_class_type, U, 4>(self, info, n, i, in, out);
+                    return;
+                default:
+                    break;
+            }
+        }
+
+        auto ip      = in ? static_cast<U*>(in->p) : nullptr;
+        auto op      = static_cast<U*>(out->p);
+        auto is      = in ? in->stride : 0;
+        auto os      = out->stride;
+        auto ip_last = ip + (is * (n - 1));
+        auto op_last = op + (os * (n - 1));
+
+        const auto instep  = is / info.m_in_info->planecount;
+        const auto outstep = os / info.m_out_info->planecount;
+
+        // forward or bidirectional
+        if (self->m_min_object.direction() != matrix_operator_base::iteration_direction::reverse) {
+            for (auto j = 0; j < n; ++j) {
+                matrix_coord                                  position(j, i);
+                std::array<U, max::JIT_MATRIX_MAX_PLANECOUNT> tmp;
+
+                if (ip) {
+                    for (auto k = 0; k < info.m_in_info->planecount; ++k)
+                        tmp[k] = *(ip + instep * k);
                 }
+
+                const std::array<U, max::JIT_MATRIX_MAX_PLANECOUNT> out_cell = self->m_min_object.calc_cell(tmp, info, position);
+
+                for (auto k = 0; k < info.m_out_info->planecount; ++k)
+                    *(op + outstep * k) = out_cell[k];
+
+                if (ip)
+                    ip += is;
+                op += os;
             }
+        }
 
-            // reverse or bidirectional
-            if (self->m_min_object.direction() != matrix_operator_base::iteration_direction::forward) {
-                ip = ip_last;
-                op = op_last;
+        // reverse or bidirectional
+        if (self->m_min_object.direction() != matrix_operator_base::iteration_direction::forward) {
+            ip = ip_last;
+            op = op_last;
 
-                for (auto j = n - 1; j >= 0; --j) {
-                    matrix_coord position(j, i);
+            for (auto j = n - 1; j >= 0; --j) {
+                matrix_coord                                  position(j, i);
+                std::array<U, max::JIT_MATRIX_MAX_PLANECOUNT> tmp;
 
-                    if (self->m_min_object.direction() == matrix_operator_base::iteration_direction::bidirectional) {
-                        const std::array<U, 1> tmp = {{*op}};
-                        const std::array<U, 1> out_cell = self->m_min_object.calc_cell(tmp, info, position);
-                        *op                        = out_cell[0];
-                    }
-                    else {
-                        std::array<U, 1> tmp;
-                        if (ip)
-                            tmp = {{*ip}};
-                        const std::array<U, 1> out_cell = self->m_min_object.calc_cell(tmp, info, position);
-                        *op                        = out_cell[0];
-                    }
-                    if (ip)
-                        ip -= is;
-                    op -= os;
+                if (ip) {
+                    for (auto k = 0; k < info.m_in_info->planecount; ++k)
+                        tmp[k] = *(ip + instep * k);
                 }
+
+                const std::array<U, max::JIT_MATRIX_MAX_PLANECOUNT> out_cell = self->m_min_object.calc_cell(tmp, info, position);
+
+                for (auto k = 0; k < info.m_out_info->planecount; ++k)
+                    *(op + outstep * k) = out_cell[k];
+
+                if (ip)
+                    ip -= is;
+                op -= os;
             }
         }
-        else if (planematch && info.plane_count() == 4) {
-            if (self->m_min_object.direction() != matrix_operator_base::iteration_direction::reverse) {
-                for (auto j = 0; j < n; ++j) {
-                    matrix_coord           position(j, i);
-                    U                      v1  = ip ? *(ip) : 0;
-                    U                      v2  = ip ? *(ip + step) : 0;
-                    U                      v3  = ip ? *(ip + step * 2) : 0;
-                    U                      v4  = ip ? *(ip + step * 3) : 0;
-                    const std::array<U, 4> tmp = {{v1, v2, v3, v4}};
-                    const std::array<U, 4> out_cell = self->m_min_object.calc_cell(tmp, info, position);
-
-                    *(op)            = out_cell[0];
-                    *(op + step)     = out_cell[1];
-                    *(op + step * 2) = out_cell[2];
-                    *(op + step * 3) = out_cell[3];
-
-                    if (ip)
-                        ip += is;
-                    op += os;
-                }
+    }
+
+
+    // Apply the lookup table filled from calc_char() to a row of a char matrix.
+    // Contiguous rows with matching plane counts are looked up as one packed array.
+
+    inline void jit_apply_char_table(const std::array<uchar, 256>& table, const matrix_span<const uchar>& in_row, const matrix_span<uchar>& out_row) {
+        if (in_row.valid() && in_row.contiguous() && out_row.contiguous() && in_row.plane_count() == out_row.plane_count()) {
+            const auto ip    = in_row.data();
+            const auto op    = out_row.data();
+            const auto count = out_row.size() * out_row.plane_count();
+
+            for (auto j = 0; j < count; ++j)
+                op[j] = table[ip[j]];
+            return;
+        }
+
+        for (auto j = 0; j < out_row.size(); ++j) {
+            for (auto plane = 0; plane < out_row.plane_count(); ++plane) {
+                const uchar value = in_row.valid() && plane < in_row.plane_count() ? in_row(j, plane) : 0;
+                out_row(j, plane) = table[value];
             }
+        }
+    }
 
-            // reverse or bidirectional
-            if (self->m_min_object.direction() != matrix_operator_base::iteration_direction::forward) {
-                ip = ip_last;
-                op = op_last;
-
-                for (auto j = n - 1; j >= 0; --j) {
-                    matrix_coord position(j, i);
-
-                    if (self->m_min_object.direction() == matrix_operator_base::iteration_direction::bidirectional) {
-                        U                      v1  = ip ? *(op) : 0;
-                        U                      v2  = ip ? *(op + step) : 0;
-                        U                      v3  = ip ? *(op + step * 2) : 0;
-                        U                      v4  = ip ? *(op + step * 3) : 0;
-                        const std::array<U, 4> tmp = {{v1, v2, v3, v4}};
-                        const std::array<U, 4> out_cell = self->m_min_object.calc_cell(tmp, info, position);
-                        *(op)                      = out_cell[0];
-                        *(op + step)               = out_cell[1];
-                        *(op + step * 2)           = out_cell[2];
-                        *(op + step * 3)           = out_cell[3];
-                    }
-                    else {
-                        U                      v1  = ip ? *(ip) : 0;
-                        U                      v2  = ip ? *(ip + step) : 0;
-                        U                      v3  = ip ? *(ip + step * 2) : 0;
-                        U                      v4  = ip ? *(ip + step * 3) : 0;
-                        const std::array<U, 4> tmp = {{v1, v2, v3, v4}};
-                        const std::array<U, 4> out_cell = self->m_min_object.calc_cell(tmp, info, position);
-                        *(op)                      = out_cell[0];
-                        *(op + step)               = out_cell[1];
-                        *(op + step * 2)           = out_cell[2];
-                        *(op + step * 3)           = out_cell[3];
-                    }
-                    if (ip)
-                        ip -= is;
-                    op -= os;
-                }
+
+    // Hand a whole row to calc_char()'s lookup table or calc_row() when the class defines them,
+    // otherwise call calc_cell() for each cell of the row.
+
+    template<class min_class_type, typename U, enable_if_matrix_operator<min_class_type> = 0>
+    void jit_calculate_vector(
+        minwrap<min_class_type>* self, const matrix_info& info, const long n, const long i, const max::t_jit_op_info* in, max::t_jit_op_info* out) {
+        if constexpr ((is_same<U, uchar>::value && has_calc_char<min_class_type>::value) || has_calc_row<min_class_type, U>::value) {
+            const auto out_planes = info.m_out_info->planecount;
+            const auto in_planes  = in ? info.m_in_info->planecount : out_planes;
+            const auto step       = out->stride ? out->stride / out_planes : 1;    // planes are interleaved within each cell
+
+            matrix_span<const U> in_row { in ? static_cast<const U*>(in->p) : nullptr, n, in_planes, in ? in->stride : 0, step };
+            matrix_span<U>       out_row { static_cast<U*>(out->p), n, out_planes, out->stride, step };
+
+            if constexpr (is_same<U, uchar>::value && has_calc_char<min_class_type>::value)
+                jit_apply_char_table(self->m_min_object.char_table(), in_row, out_row);
+            else
+                self->m_min_object.calc_row(in_row, out_row, info, i);
+        }
+        else
+            jit_calculate_cells<min_class_type, U>(self, info, n, i, in, out);
+    }
+
+
+    // Fill the lookup table of a class defining calc_char() before calculating a char matrix.
+    // This happens on the calling thread, before the rows are divided among threads.
+
+    template<class min_class_type>
+    void jit_prepare_char_table(minwrap<min_class_type>* self, const max::t_jit_matrix_info& minfo) {
+        if constexpr (has_calc_char<min_class_type>::value) {
+            if (minfo.type == max::_jit_sym_char) {
+                self->m_min_object.update_char_table([self](const uchar value) {
+                    return static_cast<uchar>(self->m_min_object.calc_char(value));
+                });
             }
         }
-        else {
-            const auto instep  = is / info.m_in_info->planecount;
-            const auto outstep = os / info.m_out_info->planecount;
-
-            // forward or bidirectional
-            if (self->m_min_object.direction() != matrix_operator_base::iteration_direction::reverse) {
-                for (auto j = 0; j < n; ++j) {
-                    matrix_coord                                  position(j, i);
-                    std::array<U, max::JIT_MATRIX_MAX_PLANECOUNT> tmp;
-
-                    if (ip) {
-                        for (auto k = 0; k < info.m_in_info->planecount; ++k)
-                            tmp[k] = *(ip + instep * k);
-                    }
+    }
 
-                    const std::array<U, max::JIT_MATRIX_MAX_PLANECOUNT> out_cell = self->m_min_object.calc_cell(tmp, info, position);
 
-                    for (auto k = 0; k < info.m_out_info->planecount; ++k)
-                        *(op + outstep * k) = out_cell[k];
+    // A matrix is calculated as runs of cells, each of which is passed to jit_calculate_vector() as one row.
+    // A run is normally a row of a 2-dimensional slice of the matrix, passed with its index in the slice and a matrix_info of the slice,
+    // so that the class may read the neighbouring rows. The runs of all slices are numbered together,
+    // so that matrices of any number of dimensions are divided among threads by the runs rather than by the rows of one slice.
+    //
+    // The row kernel of a pointwise class does not read other rows, so its runs continue across the dimensions
+    // whose cells follow each other in both matrices: a packed matrix of any number of dimensions is then one run,
+    // which is split into runs of k_split_length cells so that it may still be divided among threads.
+    // The row index passed for these runs is the index of the run.
 
-                    if (ip)
-                        ip += is;
-                    op += os;
-                }
+    class matrix_runs {
+    public:
+        static constexpr long k_split_length { 16384 };
+
+        struct run {
+            long in;           // offset of the run from the start of the input, in bytes
+            long out;          // and of the output
+            long in_slice;     // offset of the slice of the run from the start of the input, in bytes
+            long out_slice;    // and of the output
+            long row;          // passed to the class
+            long length;       // in cells
+        };
+
+
+        /// Lay out the runs of a matrix.
+        /// @param	dim_count	The number of dimensions to calculate.
+        /// @param	dim			The size of each dimension to calculate.
+        /// @param	in			The input matrix, or nullptr for a generator.
+        /// @param	out			The output matrix.
+        /// @param	collapse	True to continue the runs across contiguous dimensions.
+
+        matrix_runs(const long dim_count, const long* dim, const max::t_jit_matrix_info* in, const max::t_jit_matrix_info& out, const bool collapse) {
+            // an input with a size of 1 in a dimension is extended across that dimension of the output
+
+            const auto in_stride  = [&](const long k) { return in && in->dim[k] > 1 ? in->dimstride[k] : 0L; };
+
+            m_in_cell_stride  = in && in->dim[0] > 1 ? in->planecount : 0;
+            m_out_cell_stride = out.dim[0] > 1 ? out.planecount : 0;
+            m_length          = dim_count > 0 ? dim[0] : 0;
+
+            const auto contiguous = [&](const long k) {
+                if (dim[k] == 1)
+                    return true;
+
+                const auto in_follows  { !in || (m_in_cell_stride && in->dim[k] > 1 && in->dimstride[k] == m_length * in->dimstride[0]) };
+                const auto out_follows { m_out_cell_stride && out.dimstride[k] == m_length * out.dimstride[0] };
+                return in_follows && out_follows;
+            };
+
+            auto first { 1L };    // the first dimension beyond the runs
+
+            if (collapse) {
+                while (first < dim_count && contiguous(first))
+                    m_length *= dim[first++];
+            }
+            m_collapsed = first > 1;
+
+            for (auto k = first; k < dim_count; ++k) {
+                m_outer_dim[m_outer_count]  = dim[k];
+                m_in_stride[m_outer_count]  = in_stride(k);
+                m_out_stride[m_outer_count] = out.dimstride[k];
+                m_count *= dim[k];
+                ++m_outer_count;
+            }
+            m_last_length = m_length;
+
+            if (m_collapsed && m_count == 1 && m_length > k_split_length) {
+                const auto pieces { (m_length + k_split_length - 1) / k_split_length };
+
+                m_outer_dim[0]  = pieces;
+                m_in_stride[0]  = k_split_length * (in ? in->dimstride[0] : 0);
+                m_out_stride[0] = k_split_length * out.dimstride[0];
+                m_outer_count   = 1;
+                m_count         = pieces;
+                m_last_length   = m_length - (pieces - 1) * k_split_length;
+                m_length        = k_split_length;
             }
+        }
 
-            // reverse or bidirectional
-            if (self->m_min_object.direction() != matrix_operator_base::iteration_direction::forward) {
-                ip = ip_last;
-                op = op_last;
 
-                for (auto j = n - 1; j >= 0; --j) {
-                    matrix_coord                                  position(j, i);
-                    std::array<U, max::JIT_MATRIX_MAX_PLANECOUNT> tmp;
+        long count() const {
+            return m_count;
+        }
 
-                    if (ip) {
-                        for (auto k = 0; k < info.m_in_info->planecount; ++k)
-                            tmp[k] = *(ip + instep * k);
-                    }
+        long cell_count() const {
+            return (m_count - 1) * m_length + m_last_length;
+        }
 
-                    const std::array<U, max::JIT_MATRIX_MAX_PLANECOUNT> out_cell = self->m_min_object.calc_cell(tmp, info, position);
+        long in_cell_stride() const {
+            return m_in_cell_stride;
+        }
 
-                    for (auto k = 0; k < info.m_out_info->planecount; ++k)
-                        *(op + outstep * k) = out_cell[k];
+        long out_cell_stride() const {
+            return m_out_cell_stride;
+        }
 
-                    if (ip)
-                        ip -= is;
-                    op -= os;
-                }
+
+        /// Locate a run.
+        /// @param	index	The index of the run, from 0 to count().
+        /// @return			The run.
+
+        run operator[](const long index) const {
+            run  r { 0, 0, 0, 0, m_collapsed ? index : 0, index == m_count - 1 ? m_last_length : m_length };
+            auto remaining { index };
+
+            for (auto k = 0; k < m_outer_count; ++k) {
+                const auto i { remaining % m_outer_dim[k] };
+
+                remaining /= m_outer_dim[k];
+                r.in  += i * m_in_stride[k];
+                r.out += i * m_out_stride[k];
+                if (k == 0 && !m_collapsed)
+                    r.row = i;    // the first dimension beyond an uncollapsed run is the rows of its slice
             }
+
+            r.in_slice  = m_collapsed ? 0 : r.in - r.row * m_in_stride[0];
+            r.out_slice = m_collapsed ? 0 : r.out - r.row * m_out_stride[0];
+            return r;
         }
+
+    private:
+        long    m_length {};
+        long    m_last_length {};
+        long    m_count { 1 };
+        long    m_in_cell_stride {};     // elements between the cells of a run, 0 when the input is extended across it
+        long    m_out_cell_stride {};
+        bool    m_collapsed {};
+        long    m_outer_count {};
+        long    m_outer_dim[max::JIT_MATRIX_MAX_DIMCOUNT] {};
+        long    m_in_stride[max::JIT_MATRIX_MAX_DIMCOUNT] {};     // bytes between neighbouring runs along each dimension beyond them
+        long    m_out_stride[max::JIT_MATRIX_MAX_DIMCOUNT] {};
+    };
+
+
+    // Does a class calculate the rows of matrices with elements of type U without reading other rows, so that its runs may be collapsed?
+
+    template<class min_class_type, typename U>
+    constexpr bool class_calculates_runs() {
+        return class_is_pointwise<min_class_type>()
+            && (has_calc_row<min_class_type, U>::value || (is_same<U, uchar>::value && has_calc_char<min_class_type>::value));
     }
 
 
-    // We also use a C+ template for the loop that wraps the call to jit_simple_vector(),
-    // further reducing code duplication in jit_simple_calculate_ndim().
-    // The calls into these templates should be inlined by the compiler, eliminating concern about any added function call overhead.
+    // Calculate the runs from first_run up to (but not including) end_run.
 
     template<class min_class_type, typename U>
-    typename enable_if<is_base_of<matrix_operator_base, min_class_type>::value>::type
-    jit_calculate_ndim_loop(minwrap<min_class_type>* self, const long n, max::t_jit_op_info* in_opinfo, max::t_jit_op_info* out_opinfo, max::t_jit_matrix_info* in_minfo, max::t_jit_matrix_info* out_minfo, uchar* bip, uchar* bop, long* dim, const long plane_count, const long datasize) {
-        matrix_info info((in_minfo ? in_minfo : out_minfo), (bip ? bip : bop), out_minfo, bop);
-        for (auto i = 0; i < dim[1]; i++) {
-            if (in_opinfo)
-                in_opinfo->p = bip + i * in_minfo->dimstride[1];
-            out_opinfo->p = bop + i * out_minfo->dimstride[1];
-            jit_calculate_vector<min_class_type, U>(self, info, n, i, in_opinfo, out_opinfo);
+    void jit_calculate_runs(minwrap<min_class_type>* self, const matrix_runs& runs, const max::t_jit_matrix_info* in_minfo, uchar* bip,
+        max::t_jit_matrix_info* out_minfo, uchar* bop, const long first_run, const long end_run) {
+        max::t_jit_op_info in_opinfo;
+        max::t_jit_op_info out_opinfo;
+        const auto         history { bip ? &self->m_min_object.history() : nullptr };
+
+        in_opinfo.stride  = runs.in_cell_stride();
+        out_opinfo.stride = runs.out_cell_stride();
+
+        for (auto index = first_run; index < std::min(end_run, runs.count()); ++index) {
+            const auto        run { runs[index] };
+            const matrix_info info { in_minfo ? in_minfo : out_minfo, bip ? bip + run.in_slice : bop + run.out_slice, out_minfo, bop + run.out_slice, history };
+
+            if (bip)
+                in_opinfo.p = bip + run.in;
+            out_opinfo.p = bop + run.out;
+            jit_calculate_vector<min_class_type, U>(self, info, run.length, run.row, bip ? &in_opinfo : nullptr, &out_opinfo);
         }
     }
 
 
+    template<class min_class_type, typename U>
+    void jit_calculate_matrix_of(minwrap<min_class_type>* self, const long dim_count, const long* dim, const max::t_jit_matrix_info* in_minfo, uchar* bip,
+        max::t_jit_matrix_info* out_minfo, uchar* bop, const bool in_bands) {
+        const matrix_runs runs { dim_count, dim, in_minfo, *out_minfo, class_calculates_runs<min_class_type, U>() };
+
+        const auto calculate = [&](const long first_run, const long end_run) {
+            jit_calculate_runs<min_class_type, U>(self, runs, in_minfo, bip, out_minfo, bop, first_run, end_run);
+        };
+
+        if (in_bands)
+            self->m_min_object.for_each_row_band(runs.count(), runs.cell_count(), calculate);
+        else
+            calculate(0, runs.count());
+    }
+
+
+    // Calculate a matrix, dividing its runs among the threads of the shared worker_pool if in_bands is true.
+    // A generator has no input matrix, so in_minfo and bip are nullptr.
+
     template<class min_class_type, enable_if_matrix_operator<min_class_type> = 0>
-    void jit_calculate_ndim(minwrap<min_class_type>* self, const long dim_count, long* dim, const long plane_count, max::t_jit_matrix_info* in_minfo, uchar* bip, max::t_jit_matrix_info* out_minfo, uchar* bop) {
+    void jit_calculate_matrix(minwrap<min_class_type>* self, const long dim_count, const long* dim, const max::t_jit_matrix_info* in_minfo, uchar* bip,
+        max::t_jit_matrix_info* out_minfo, uchar* bop, const bool in_bands) {
         if (dim_count < 1)
             return;    // safety
 
-        max::t_jit_op_info in_opinfo;
-        max::t_jit_op_info out_opinfo;
+        const auto type { in_minfo ? in_minfo->type : out_minfo->type };
 
-        switch (dim_count) {
-            case 1:
-                dim[1] = 1;
-                // (fall-through to next case is intentional)
-            case 2: {
-                // if plane_count is the same then flatten planes - treat as single plane data for speed
-                auto n            = dim[0];
-                in_opinfo.stride  = in_minfo->dim[0] > 1 ? in_minfo->planecount : 0;
-                out_opinfo.stride = out_minfo->dim[0] > 1 ? out_minfo->planecount : 0;
-
-                if (in_minfo->type == max::_jit_sym_char)
-                    jit_calculate_ndim_loop<min_class_type, uchar>(
-                        self, n, &in_opinfo, &out_opinfo, in_minfo, out_minfo, bip, bop, dim, plane_count, 1);
-                else if (in_minfo->type == max::_jit_sym_long)
-                    jit_calculate_ndim_loop<min_class_type, int>(
-                        self, n, &in_opinfo, &out_opinfo, in_minfo, out_minfo, bip, bop, dim, plane_count, 4);
-                else if (in_minfo->type == max::_jit_sym_float32)
-                    jit_calculate_ndim_loop<min_class_type, float>(
-                        self, n, &in_opinfo, &out_opinfo, in_minfo, out_minfo, bip, bop, dim, plane_count, 4);
-                else if (in_minfo->type == max::_jit_sym_float64)
-                    jit_calculate_ndim_loop<min_class_type, double>(
-                        self, n, &in_opinfo, &out_opinfo, in_minfo, out_minfo, bip, bop, dim, plane_count, 8);
-            } break;
-            default:
-                for (auto i = 0; i < dim[dim_count - 1]; i++) {
-                    auto ip = bip + i * in_minfo->dimstride[dim_count - 1];
-                    auto op = bop + i * out_minfo->dimstride[dim_count - 1];
-                    jit_calculate_ndim(self, dim_count - 1, dim, plane_count, in_minfo, ip, out_minfo, op);
-                }
-        }
+        if (type == max::_jit_sym_char)
+            jit_calculate_matrix_of<min_class_type, uchar>(self, dim_count, dim, in_minfo, bip, out_minfo, bop, in_bands);
+        else if (type == max::_jit_sym_long)
+            jit_calculate_matrix_of<min_class_type, int>(self, dim_count, dim, in_minfo, bip, out_minfo, bop, in_bands);
+        else if (type == max::_jit_sym_float32)
+            jit_calculate_matrix_of<min_class_type, float>(self, dim_count, dim, in_minfo, bip, out_minfo, bop, in_bands);
+        else if (type == max::_jit_sym_float64)
+            jit_calculate_matrix_of<min_class_type, double>(self, dim_count, dim, in_minfo, bip, out_minfo, bop, in_bands);
+    }
+
+
+    // Calculate the whole matrix, which is also the callback for Jitter's parallel breakup.
+
+    template<class min_class_type, enable_if_matrix_operator<min_class_type> = 0>
+    void jit_calculate_ndim(minwrap<min_class_type>* self, const long dim_count, long* dim, const long plane_count, max::t_jit_matrix_info* in_minfo, uchar* bip, max::t_jit_matrix_info* out_minfo, uchar* bop) {
+        jit_calculate_matrix(self, dim_count, dim, in_minfo, bip, out_minfo, bop, false);
     }
 
 
     template<class min_class_type, enable_if_matrix_operator<min_class_type> = 0>
     void jit_calculate_ndim_single(
         minwrap<min_class_type>* self, const long dim_count, long* dim, const long plane_count, max::t_jit_matrix_info* out_minfo, uchar* bop) {
-        if (dim_count < 1)
-            return;    // safety
+        jit_calculate_matrix(self, dim_count, dim, nullptr, nullptr, out_minfo, bop, false);
+    }
 
-        max::t_jit_op_info out_opinfo;
 
-        switch (dim_count) {
-            case 1:
-                dim[1] = 1;
-                // (fall-through to next case is intentional)
-            case 2: {
-                // if plane_count is the same then flatten planes - treat as single plane data for speed
-                auto n            = dim[0];
-                out_opinfo.stride = out_minfo->dim[0] > 1 ? out_minfo->planecount : 0;
-
-                if (out_minfo->type == max::_jit_sym_char)
-                    jit_calculate_ndim_loop<min_class_type, uchar>(
-                        self, n, NULL, &out_opinfo, NULL, out_minfo, NULL, bop, dim, plane_count, 1);
-                else if (out_minfo->type == max::_jit_sym_long)
-                    jit_calculate_ndim_loop<min_class_type, int>(
-                        self, n, NULL, &out_opinfo, NULL, out_minfo, NULL, bop, dim, plane_count, 1);
-                else if (out_minfo->type == max::_jit_sym_float32)
-                    jit_calculate_ndim_loop<min_class_type, float>(
-                        self, n, NULL, &out_opinfo, NULL, out_minfo, NULL, bop, dim, plane_count, 1);
-                else if (out_minfo->type == max::_jit_sym_float64)
-                    jit_calculate_ndim_loop<min_class_type, double>(
-                        self, n, NULL, &out_opinfo, NULL, out_minfo, NULL, bop, dim, plane_count, 1);
-            } break;
-            default:
-                for (auto i = 0; i < dim[dim_count - 1]; i++) {
-                    auto op = bop + i * out_minfo->dimstride[dim_count - 1];
-                    jit_calculate_ndim_single(self, dim_count - 1, dim, plane_count, out_minfo, op);
-                }
+    // Determine how the rows of a matrix are to be divided among threads.
+    // Reverse and bidirectional iteration carry state from one row to the next, so they are always calculated serially.
+
+    enum class matrix_dispatch { serial, jitter, bands };
+
+    template<class min_class_type>
+    matrix_dispatch matrix_dispatch_for(minwrap<min_class_type>* self) {
+        auto& op = self->m_min_object;
+
+        if (op.direction() != matrix_operator_base::iteration_direction::forward)
+            return matrix_dispatch::serial;
+        if (op.thread_count() > 0)
+            return matrix_dispatch::bands;
+        return op.parallel_breakup_enabled() ? matrix_dispatch::jitter : matrix_dispatch::serial;
+    }
+
+
+    // Handle the matrices that the class does not need to calculate, returning true if the output is complete.
+
+    template<class min_class_type>
+    bool jit_matrix_passthrough(minwrap<min_class_type>* self, max::t_jit_matrix_info& in_minfo, uchar* in_bp, max::t_jit_matrix_info& out_minfo, uchar* out_bp) {
+        if constexpr (has_passthrough<min_class_type>::value) {
+            const matrix_info info { &in_minfo, in_bp, &out_minfo, out_bp };
+
+            if (!self->m_min_object.passthrough(info))
+                return false;
+            if (in_bp == out_bp)
+                return true;
+            if (!matrix_layouts_match(in_minfo, out_minfo))
+                return false;
+            std::copy_n(in_bp, in_minfo.size, out_bp);
+            return true;
         }
+        else
+            return false;
     }
 
 
@@ -550,7 +1219,7 @@ namespace c74::min {
             else if (in_minfo.type != out_minfo.type)
                 err = max::JIT_ERR_MISMATCH_TYPE;
 
-            if (in_minfo.type == out_minfo.type && in_bp && out_bp) {
+            if (in_minfo.type == out_minfo.type && in_bp && out_bp && !jit_matrix_passthrough(self, in_minfo, in_bp, out_minfo, out_bp)) {
                 long dim[max::JIT_MATRIX_MAX_DIMCOUNT];
                 auto dim_count   = out_minfo.dimcount;
                 auto plane_count = out_minfo.planecount;
@@ -564,14 +1233,33 @@ namespace c74::min {
                     }
                 }
 
-                if (self->m_min_object.parallel_breakup_enabled()) {
+                const auto dispatch { matrix_dispatch_for(self) };
+
+                // a pointwise class going forward reads each cell before writing it, so it may calculate in place
+                const auto in_place { class_is_pointwise<min_class_type>()
+                    && self->m_min_object.direction() == matrix_operator_base::iteration_direction::forward };
+
+                auto& history { self->m_min_object.prepare_history() };
+
+                // the copy kept in the history is calculated instead of the input, so it also serves as the copy of an input that is the output
+                if (history.size())
+                    in_bp = history.push(in_minfo, in_bp);
+                else if (in_bp == out_bp && !in_place)
+                    in_bp = self->m_min_object.copy_input(in_bp, static_cast<size_t>(in_minfo.size));
+
+                jit_prepare_char_table(self, in_minfo);
+
+                if (dispatch == matrix_dispatch::jitter) {
                     max::jit_parallel_ndim_simplecalc2(reinterpret_cast<max::method>(jit_calculate_ndim<min_class_type>), self, dim_count,
                         dim, plane_count, &in_minfo, reinterpret_cast<char*>(in_bp), &out_minfo, reinterpret_cast<char*>(out_bp), 0, 0);
                 }
                 else {
-                    jit_calculate_ndim<min_class_type>(self, dim_count, dim, plane_count, &in_minfo, reinterpret_cast<uchar*>(in_bp),
-                        &out_minfo, reinterpret_cast<uchar*>(out_bp));
+                    jit_calculate_matrix(self, dim_count, dim, &in_minfo, reinterpret_cast<uchar*>(in_bp), &out_minfo, reinterpret_cast<uchar*>(out_bp),
+                        dispatch == matrix_dispatch::bands);
                 }
+
+                if (history.size())
+                    history.advance();
             }
 
             max::object_method(out_matrix, max::_jit_sym_lock, out_savelock);
@@ -623,13 +1311,17 @@ namespace c74::min {
                 if (!out_bp)
                     err = max::JIT_ERR_INVALID_OUTPUT;
                 else {
-                    if (jitob->m_min_object.parallel_breakup_enabled()) {
+                    const auto dispatch { matrix_dispatch_for(jitob) };
+
+                    jit_prepare_char_table(jitob, out_minfo);
+
+                    if (dispatch == matrix_dispatch::jitter) {
                         max::jit_parallel_ndim_simplecalc1(reinterpret_cast<max::method>(jit_calculate_ndim_single<min_class_type>), jitob,
                             out_minfo.dimcount, out_minfo.dim, out_minfo.planecount, &out_minfo, out_bp, 0);
                     }
                     else {
-                        jit_calculate_ndim_single<min_class_type>(
-                            jitob, out_minfo.dimcount, out_minfo.dim, out_minfo.planecount, &out_minfo, reinterpret_cast<uchar*>(out_bp));
+                        jit_calculate_matrix(jitob, out_minfo.dimcount, out_minfo.dim, nullptr, nullptr, &out_minfo, reinterpret_cast<uchar*>(out_bp),
+                            dispatch == matrix_dispatch::bands);
                     }
                     max::object_method(out_matrix, max::_jit_sym_lock, out_savelock);
                 }
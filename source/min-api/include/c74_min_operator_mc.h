@@ -70,6 +70,90 @@ namespace c74::min {
         }
 
 
+        /// Set the number of channels processed together by one task when the channels are processed in parallel.
+        /// A value of 0 (the default) processes all channels serially on the audio thread.
+        /// This is typically called by an attribute setter on the main thread, which also creates the shared worker_pool.
+        /// @param	a_group_size	The number of channels in each group, or 0 to disable parallel processing.
+
+        void channel_group_size(const int a_group_size) {
+            if (a_group_size > 0)
+                worker_pool::shared();
+            m_channel_group_size = std::max(a_group_size, 0);
+        }
+
+
+        /// Return the number of channels processed together by one task when the channels are processed in parallel.
+        /// @return	The number of channels in each group, or 0 if parallel processing is disabled.
+
+        int channel_group_size() const {
+            return m_channel_group_size;
+        }
+
+
+        /// Determine the number of channel groups that for_each_channel_group() will use for a vector of audio.
+        /// Use this to size any per-group storage before calling for_each_channel_group().
+        /// @param	channel_count	The number of channels in the vector.
+        /// @param	frame_count		The number of samples in each channel.
+        /// @return					The number of channel groups, which is 1 when the channels will be processed serially.
+
+        size_t channel_group_count(const long channel_count, const long frame_count) const {
+            const long group_size { m_channel_group_size };
+
+            if (group_size <= 0 || channel_count <= group_size || channel_count * frame_count < k_minimum_parallel_samples)
+                return 1;
+            return static_cast<size_t>((channel_count + group_size - 1) / group_size);
+        }
+
+
+        /// Call a function for each group of channels in a vector of audio.
+        /// If channel_group_size() is set and the vector is large enough to amortize the dispatch
+        /// the groups are divided among the threads of the shared worker_pool and the audio thread.
+        /// Otherwise the function is called once with all of the channels on the audio thread.
+        /// The call returns when all groups have been processed.
+        ///
+        /// @param	channel_count	The number of channels in the vector.
+        /// @param	frame_count		The number of samples in each channel.
+        /// @param	f				The function to call, prototyped as `void (long first_channel, long end_channel, size_t group)`.
+        ///							It must be safe to call this function concurrently for different groups.
+
+        template<class function_type>
+        void for_each_channel_group(const long channel_count, const long frame_count, function_type&& f) {
+            const auto group_count { channel_group_count(channel_count, frame_count) };
+
+            if (group_count == 1) {
+                f(0L, channel_count, size_t(0));
+                return;
+            }
+
+            const long group_size { m_channel_group_size };
+
+            worker_pool::shared().parallel_for(group_count, [&](const size_t group) {
+                const auto first { static_cast<long>(group) * group_size };
+                f(first, std::min(first + group_size, channel_count), group);
+            });
+        }
+
+
+        /// The mask of the output channels that are processed.
+        /// Max only changes the number of channels of a multichannel signal when the dsp chain is compiled, which interrupts the audio of the whole patcher.
+        /// To change the number of channels (e.g. voices) while the audio runs, reserve the largest number that may be needed
+        /// by returning it from the "multichanneloutputs" message, and enable only the channels in use with this mask.
+        /// @code
+        /// enabled_channels().enable_first(voices);
+        /// @endcode
+        /// Your call operator can skip the disabled channels by checking channel_enabled() of the output audio_bundle.
+        /// Their outputs are set to zero after it returns.
+        /// @return	The mask, which may be changed from any thread.
+
+        channel_mask& enabled_channels() {
+            return m_enabled_channels;
+        }
+
+        const channel_mask& enabled_channels() const {
+            return m_enabled_channels;
+        }
+
+
         // Ideally we would also declare a pure virtual function call operator
         // for the inheriting class to implement.
         // That is impossible, however, because we can't generically prototype N arguments
@@ -82,13 +166,20 @@ namespace c74::min {
         // void operator() (sample input1, sample input2);
 
     private:
+        static constexpr long k_minimum_parallel_samples { 4096 };    // total samples in a vector below which parallel dispatch does not pay off
+
         double m_samplerate{c74::max::sys_getsr()};    // initialized to the global samplerate, but updated to the local samplerate when the
                                                        // dsp chain is compiled.
         int m_vector_size{c74::max::sys_getblksize()};    // ...
         vector<std::pair<int,attribute_base*>> m_attributes_mapped_to_inlets;
+        std::atomic<int> m_channel_group_size{0};    // set on the main thread, read on the audio thread
+        channel_mask m_enabled_channels;
     };
 
     template<class min_class_type, enable_if_mc_operator<min_class_type> = 0>
     void min_dsp64_attrmap(minwrap<min_class_type>* self, const short* count) {}
 
+    template<class min_class_type, enable_if_mc_operator<min_class_type> = 0>
+    void min_dsp64_converter(minwrap<min_class_type>* self, const long maxvectorsize) {}
+
 }    // namespace c74::min
@@ -94,6 +94,41 @@ namespace c74::min {
         }
 
 
+        /// Return the position of the sample currently being processed by the call operator,
+        /// counted in samples since the object started processing audio.
+        /// A block call operator is called at the first frame of the block and should add its own frame index.
+        /// @return	The position in samples.
+
+        uint64_t sample_position() const {
+            return m_vector_position + static_cast<uint64_t>(m_frame);
+        }
+
+
+        /// Return the time of the sample currently being processed by the call operator,
+        /// measured in milliseconds of audio since the object started processing audio.
+        /// Use this to timestamp events sent from the audio thread, e.g. with outlet<>::send_at().
+        /// @return	The time in milliseconds.
+
+        double sample_time() const {
+            return static_cast<double>(sample_position()) * 1000.0 / m_samplerate;
+        }
+
+
+        // Used internally by the performer to track the frame currently being processed.
+
+        void current_frame(const long a_frame) {
+            m_frame = a_frame;
+        }
+
+
+        // Used internally by the performer when it has finished processing a vector.
+
+        void advance_vector(const long a_frame_count) {
+            m_vector_position += static_cast<uint64_t>(a_frame_count);
+            m_frame = 0;
+        }
+
+
         // Ideally we would also declare a pure virtual function call operator
         // for the inheriting class to implement.
         // That is impossible, however, because we can't generically prototype N arguments
@@ -110,6 +145,8 @@ namespace c74::min {
                                                        // dsp chain is compiled.
         int m_vector_size {c74::max::sys_getblksize()};    // ...
         vector<std::pair<int,attribute_base*>> m_attributes_mapped_to_inlets;
+        uint64_t m_vector_position {};    // position of the first sample of the current vector
+        long     m_frame {};              // index of the current sample within the vector
     };
 
 
@@ -128,6 +165,10 @@ namespace c74::min {
     }
 
 
+    template<class min_class_type, enable_if_sample_operator<min_class_type> = 0>
+    void min_dsp64_converter(minwrap<min_class_type>* self, const long maxvectorsize) {}
+
+
     // To implement the performer class (below) generically we use std::array<sample> for both input and output.
     // However, we wish to define the call operator in the Min class with each sample as a
     // separate argument.
@@ -177,6 +218,83 @@ namespace c74::min {
     };
 
 
+    /// A non-owning view of N channels of contiguous audio samples spanning one (sub-)vector.
+    /// A sample_operator<> class may optionally define a block call operator taking these as arguments:
+    /// @code
+    /// void operator()(const sample_block<2>& input, sample_block<1>& output);
+    /// @endcode
+    /// When present, the performer hands whole vectors to it instead of calling the per-sample call operator,
+    /// allowing the inner loops to be written so that the compiler can vectorize them.
+    ///
+    /// @tparam channel_count_param	The number of channels in the block.
+
+    template<size_t channel_count_param>
+    class sample_block {
+    public:
+
+        /// Create a view of the audio vectors for each channel.
+        /// @param	a_channels		An array of channel_count_param pointers to the first sample of each channel.
+        /// @param	a_frame_count	The number of samples in the view for each channel.
+        /// @param	a_offset		The offset of the first sample in the view from the start of each channel.
+
+        sample_block(double* const* a_channels, const long a_frame_count, const long a_offset = 0)
+        : m_frame_count { a_frame_count }
+        {
+            for (auto chan = 0; chan < channel_count_param; ++chan)
+                m_channels[chan] = a_channels[chan] + a_offset;
+        }
+
+
+        /// Return the number of channels in the block.
+        /// @return The number of channels.
+
+        static constexpr size_t channel_count() {
+            return channel_count_param;
+        }
+
+
+        /// Return the number of samples in each channel of the block.
+        /// @return The number of frames.
+
+        long frame_count() const {
+            return m_frame_count;
+        }
+
+
+        /// Get a pointer to the samples of a channel.
+        /// NOTE: No bounds checking is performed!
+        /// @param	channel		The channel for which to fetch the pointer.
+        /// @return				A pointer to the first sample of the channel.
+
+        double* operator[](const size_t channel) {
+            return m_channels[channel];
+        }
+
+        const double* operator[](const size_t channel) const {
+            return m_channels[channel];
+        }
+
+    private:
+        std::array<double*, channel_count_param>    m_channels {};
+        long                                        m_frame_count;
+    };
+
+
+    // SFINAE implementation used internally to determine if a sample_operator<> class defines a block call operator
+    // taking a `const sample_block<input_count>&` and a `sample_block<output_count>&`.
+    //
+    // To test this in isolation, for a class named slide, use the following code:
+    // static_assert(has_block_operator<slide>::value, "error");
+
+    template<class min_class_type, class = void>
+    struct has_block_operator : std::false_type {};
+
+    template<class min_class_type>
+    struct has_block_operator<min_class_type, std::void_t<decltype(std::declval<min_class_type&>()(
+        std::declval<const sample_block<min_class_type::input_count()>&>(),
+        std::declval<sample_block<min_class_type::output_count()>&>()))>> : std::true_type {};
+
+
     // version of perform_copy_output() for samples<N> returned by the sample_operator<>'s call operator in the performer below.
 
     template<class min_class_type, typename type_returned_from_call_operator>
@@ -203,7 +321,8 @@ namespace c74::min {
     // This one is optimized for the most common case: a single input and a single output.
 
     template<class min_class_type>
-    class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1, 1>, min_class_type>::value>::type> {
+    class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1, 1>, min_class_type>::value
+                                                    && !has_block_operator<min_class_type>::value>::type> {
     public:
         // The traditional Max audio "perform" callback routine
 
@@ -212,10 +331,12 @@ namespace c74::min {
             auto out_samps = out_chans[0];
 
             for (auto i = 0; i < sampleframes; ++i) {
+                self->m_min_object.current_frame(i);
                 auto in      = in_samps[i];
                 auto out     = self->m_min_object(in);
                 out_samps[i] = out;
             }
+            self->m_min_object.advance_vector(sampleframes);
         }
     };
 
@@ -224,7 +345,8 @@ namespace c74::min {
     // This specialization is for a single input with no outputs
 
     template<class min_class_type>
-    class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1, 0>, min_class_type>::value>::type> {
+    class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1, 0>, min_class_type>::value
+                                                    && !has_block_operator<min_class_type>::value>::type> {
     public:
         // The traditional Max audio "perform" callback routine
 
@@ -232,9 +354,11 @@ namespace c74::min {
             auto in_samps = in_chans[0];
 
             for (auto i = 0; i < sampleframes; ++i) {
+                self->m_min_object.current_frame(i);
                 auto in = in_samps[i];
                 self->m_min_object(in);
             }
+            self->m_min_object.advance_vector(sampleframes);
         }
     };
 
@@ -247,7 +371,8 @@ namespace c74::min {
     class performer<min_class_type,
         typename enable_if<is_base_of<sample_operator_base, min_class_type>::value
                         && !is_base_of<sample_operator<1, 1>, min_class_type>::value
-                        && !is_base_of<sample_operator<1, 0>, min_class_type>::value>::type> {
+                        && !is_base_of<sample_operator<1, 0>, min_class_type>::value
+                        && !has_block_operator<min_class_type>::value>::type> {
     public:
         static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
             auto& attrs { self->m_min_object.mapped_attributes() };
@@ -258,6 +383,7 @@ namespace c74::min {
                 // the typical case:
 
                 for (auto i = 0; i < sampleframes; ++i) {
+                    self->m_min_object.current_frame(i);
                     callable_samples<min_class_type, min_class_type::input_count()> ins(self);
 
                     for (auto chan = 0; chan < input_count; ++chan)
@@ -274,6 +400,7 @@ namespace c74::min {
                 // the case where audio inlets are mapped to attributes
 
                 for (auto i = 0; i < sampleframes; ++i) {
+                    self->m_min_object.current_frame(i);
                     callable_samples<min_class_type, min_class_type::input_count()> ins(self);
 
                     for (auto& inletnum_and_attr : attrs) {
@@ -294,6 +421,57 @@ namespace c74::min {
                         perform_copy_output(self, i, out_chans, out);
                 }
             }
+            self->m_min_object.advance_vector(sampleframes);
+        }
+    };
+
+
+    // The performer class wraps the C callback routine for a Max audio "perform" method.
+    // This specialization is for sample_operator<> classes that define a block call operator (see sample_block above).
+    // It takes precedence over all of the per-sample specializations above.
+
+    template<class min_class_type>
+    class performer<min_class_type,
+        typename enable_if<is_base_of<sample_operator_base, min_class_type>::value
+                        && has_block_operator<min_class_type>::value>::type> {
+    public:
+        static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+            auto& attrs { self->m_min_object.mapped_attributes() };
+            auto  ins { const_cast<double**>(in_chans) };
+
+            if (attrs.empty()) {
+
+                // the typical case: the entire vector is processed with a single call
+
+                const sample_block<min_class_type::input_count()>   input { ins, sampleframes };
+                sample_block<min_class_type::output_count()>        output { out_chans, sampleframes };
+
+                call_kernel(self, input, output);
+            }
+            else {
+
+                // the case where audio inlets are mapped to attributes
+                // the attributes must be updated for every sample so we process blocks of a single frame
+
+                for (auto i = 0; i < sampleframes; ++i) {
+                    self->m_min_object.current_frame(i);
+
+                    for (auto& inletnum_and_attr : attrs) {
+                        int 			inletnum { inletnum_and_attr.first };
+                        attribute_base*	attr { inletnum_and_attr.second };
+                        auto			value { in_chans[inletnum][i] };
+                        atoms			a {{value}};
+
+                        attr->set(a, false, false);
+                    }
+
+                    const sample_block<min_class_type::input_count()>   input { ins, 1, i };
+                    sample_block<min_class_type::output_count()>        output { out_chans, 1, i };
+
+                    call_kernel(self, input, output);
+                }
+            }
+            self->m_min_object.advance_vector(sampleframes);
         }
     };
 
@@ -9,10 +9,105 @@ namespace c74::min {
 
     using tagged_attribute = std::pair<const symbol, attribute_base*>;
 
+    namespace ui {
+        class layer;
+    }
+
     class ui_operator_base {
     public:
+        ~ui_operator_base() {
+            if (m_drag_qelem)
+                max::qelem_free(m_drag_qelem);
+        }
+
+
 		virtual void add_color_attribute(const tagged_attribute a_color_attr) = 0;
         virtual void update_colors() = 0;
+
+
+        /// Register a layer of the object, so that it is invalidated whenever an attribute of the object changes.
+        /// Layers register themselves when they are created.
+        /// @param	a_layer	The layer.
+
+        void add_layer(ui::layer* a_layer) {
+            m_layers.push_back(a_layer);
+        }
+
+
+        /// Unregister a layer of the object.
+        /// @param	a_layer	The layer.
+
+        void remove_layer(ui::layer* a_layer) {
+            m_layers.erase(std::remove(m_layers.begin(), m_layers.end(), a_layer), m_layers.end());
+        }
+
+
+        /// Invalidate all layers of the object, so that they are drawn again with the next paint.
+
+        void invalidate_layers();    // defined in c74_min_graphics.h
+
+
+        /// Hold back a mouse drag until the main thread is next serviced, merged with the drags that arrived since then.
+        /// The mouse may report many drags between two frames of the display, and each of them would otherwise
+        /// output and redraw. The absolute positions of a drag replace those of an earlier drag of the same touch,
+        /// the relative positions of a mousedragdelta are added up.
+        /// Called by the wrapper, which also creates the qelem with the first drag.
+        /// @param	a_qelem_function	The function that delivers the held back drags, called with the Max object.
+        /// @param	o					The Max object.
+        /// @param	a_message			The name of the message that receives the drag.
+        /// @param	a_patcherview		The patcherview of the drag.
+        /// @param	an_event			The drag.
+        /// @param	relative			True if the position of the drag is relative to the previous drag.
+
+        void defer_drag(max::method a_qelem_function, max::t_object* o, const symbol a_message, max::t_object* a_patcherview,
+            const max::t_mouseevent& an_event, const bool relative)
+        {
+            if (!m_drag_qelem)
+                m_drag_qelem = static_cast<max::t_qelem*>(max::qelem_new(o, a_qelem_function));
+
+            auto pending = std::find_if(m_drags.begin(), m_drags.end(), [&](const drag& d) {
+                return d.message == a_message && d.patcherview == a_patcherview && d.event.index == an_event.index;
+            });
+            if (pending == m_drags.end())
+                m_drags.push_back({ a_message, a_patcherview, an_event });
+            else if (relative) {
+                auto position { pending->event.position };
+                pending->event = an_event;
+                pending->event.position.x += position.x;
+                pending->event.position.y += position.y;
+            }
+            else
+                pending->event = an_event;
+
+            max::qelem_set(m_drag_qelem);
+        }
+
+
+        /// Take out the drags held back so far, in the order of their touches.
+        /// Called before any other mouse event is delivered, so that the events keep their order.
+        /// @param	deliver		A function that is called for each drag with the name of its message, the patcherview and the event.
+
+        template<class F>
+        void take_drags(F&& deliver) {
+            if (m_drags.empty())
+                return;
+
+            vector<drag> drags;
+            std::swap(drags, m_drags);
+            for (const auto& d : drags)
+                deliver(d.message, d.patcherview, d.event);
+        }
+
+    private:
+        struct drag {
+            symbol              message;
+            max::t_object*      patcherview;
+            max::t_mouseevent   event;
+        };
+
+        vector<ui::layer*>  m_layers;
+        vector<drag>        m_drags;
+        max::t_qelem*       m_drag_qelem {};
     };
 
 
@@ -8,9 +8,97 @@
 namespace c74::min {
 
 
+    /// The channels of a multichannel object that are enabled, so that an mc_operator can reserve the largest number of channels it may need
+    /// when the dsp chain is compiled and then enable and disable channels (e.g. voices) while the audio runs, without compiling it again.
+    /// All channels are enabled until they are disabled. Channels beyond the capacity of the mask are always enabled.
+    ///
+    /// The mask may be changed from any thread. It neither allocates nor locks.
+
+    class channel_mask {
+    public:
+        /// The number of channels that can be disabled.
+
+        static constexpr long k_capacity { 1024 };
+
+
+        /// Create a mask with all channels enabled.
+
+        channel_mask() {
+            for (auto& word : m_words)
+                word.store(~uint64_t(0), std::memory_order_relaxed);
+        }
+
+        channel_mask(const channel_mask&) = delete;
+        channel_mask& operator=(const channel_mask&) = delete;
+
+
+        /// Enable or disable a channel.
+        /// @param	channel		The channel, from 0. Channels beyond the capacity are ignored.
+        /// @param	enabled		True to enable the channel, false to disable it.
+
+        void enable(const long channel, const bool enabled = true) {
+            if (channel < 0 || channel >= k_capacity)
+                return;
+
+            const auto bit { uint64_t(1) << (channel % 64) };
+
+            if (enabled)
+                m_words[channel / 64].fetch_or(bit, std::memory_order_relaxed);
+            else
+                m_words[channel / 64].fetch_and(~bit, std::memory_order_relaxed);
+        }
+
+
+        /// Enable the first channels and disable all others, e.g. to set the number of voices.
+        /// @param	count	The number of channels to enable.
+
+        void enable_first(const long count) {
+            const auto enabled { std::clamp(count, 0L, k_capacity) };
+
+            for (auto word = 0L; word < k_word_count; ++word) {
+                const auto bits { std::clamp(enabled - word * 64, 0L, 64L) };
+                m_words[word].store(bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1, std::memory_order_relaxed);
+            }
+        }
+
+
+        /// Determine if a channel is enabled.
+        /// @param	channel		The channel, from 0.
+        /// @return				True if the channel is enabled.
+
+        bool enabled(const long channel) const {
+            if (channel < 0 || channel >= k_capacity)
+                return true;
+            return (m_words[channel / 64].load(std::memory_order_relaxed) >> (channel % 64)) & 1;
+        }
+
+
+        /// Count the enabled channels among the first channels.
+        /// @param	channel_count	The number of channels to consider.
+        /// @return					The number of those channels that are enabled.
+
+        long enabled_count(const long channel_count) const {
+            long count {};
+
+            for (auto channel = 0L; channel < channel_count; ++channel)
+                count += enabled(channel);
+            return count;
+        }
+
+    private:
+        static constexpr long k_word_count { k_capacity / 64 };
+
+        std::array<std::atomic<uint64_t>, k_word_count> m_words;
+    };
+
+
     /// An audio bundle is a container for N channels of M-sized vectors of audio sample values.
+    /// Max always processes audio in double precision, which is represented by the audio_bundle type alias.
+    /// A vector_operator<float> receives bundles of single-precision samples that have been converted once per vector.
+    /// @tparam	T	The type of the audio sample values: either double or float.
 
-    struct audio_bundle {
+    template<typename T>
+    struct basic_audio_bundle {
 
         /// Create an audio bundle from an existing array-array of sample values.
         /// This is used internally by Min when receiving the per-vector callback from Max for audio objects
@@ -19,7 +107,7 @@ namespace c74::min {
         /// @param	channel_count	The number of channels in the memory pointed to by the samples parameter.
         /// @param	frame_count		The size (in samples) of the audio vectors for each channel.
 
-        audio_bundle(double** samples, const long channel_count, const long frame_count)
+        basic_audio_bundle(T** samples, const long channel_count, const long frame_count)
         : m_samples { samples }
         , m_channel_count { channel_count }
         , m_frame_count { frame_count }
@@ -29,7 +117,7 @@ namespace c74::min {
         /// Get a direct pointer to the memory of the audio bundle.
         /// @return	A pointer to the beginning memory location of the audio bundle.
 
-        double** samples() {
+        T** samples() {
             return m_samples;
         }
 
@@ -40,7 +128,7 @@ namespace c74::min {
         ///						You are responsible for only accessing valid channels!
         /// @return				A pointer the beginning memory location for samples in the specified channel.
 
-        double* samples(const size_t channel) {
+        T* samples(const size_t channel) {
             return m_samples[channel];
         }
 
@@ -64,13 +152,35 @@ namespace c74::min {
         }
 
 
+        /// Determine if a channel is enabled, i.e. if it should be processed.
+        /// The output bundle of an mc_operator carries the mask of the channels the object has enabled (see channel_mask),
+        /// and the outputs of disabled channels are set to zero after your call operator returns.
+        /// All channels of other bundles are enabled.
+        /// @param	channel		The channel.
+        /// @return				True if the channel should be processed.
+
+        bool channel_enabled(const long channel) const {
+            return !m_mask || m_mask->enabled(channel);
+        }
+
+
+        /// Attach the mask of enabled channels. This is used internally by Min for mc_operator classes.
+        /// @param	mask	The mask, or nullptr if all channels are enabled.
+
+        void channel_mask(const min::channel_mask* mask) {
+            m_mask = mask;
+        }
+
+
         /// Zero-out the data in the entire audio bundle.
 
         void clear() {
-            for (auto channel = 0; channel < m_channel_count; ++channel) {
-                for (auto i = 0; i < m_frame_count; ++i)
-                    m_samples[channel][i] = 0.0;
-            }
+            static_assert(std::is_floating_point<T>::value, "audio_bundle samples must be IEEE 754 floating point so that all-zero bits represent 0.0");
+
+            const auto bytes { static_cast<size_t>(m_frame_count) * sizeof(T) };
+
+            for (auto channel = 0; channel < m_channel_count; ++channel)
+                std::memset(m_samples[channel], 0, bytes);
         }
 
 
@@ -84,24 +194,186 @@ namespace c74::min {
         ///
         /// Similarly, both source and destination are REQUIRED to have the same framesize or an assertion will fire.
         ///
+        /// Channels for which the source and destination are the same memory (e.g. when Max processes in-place)
+        /// are skipped, making the copy a no-op in that case.
+        ///
         /// @param 	other	The audio_bundle that will be the source of the copy.
         /// @return			The destination to which the contents of the audio bundle is copied.
 
-        audio_bundle& operator=(const audio_bundle& other) {
+        basic_audio_bundle& operator=(const basic_audio_bundle& other) {
             assert(m_channel_count <= other.m_channel_count);
             assert(m_frame_count == other.m_frame_count);
 
+            if (this == &other || m_samples == other.m_samples)
+                return *this;
+
+            const auto bytes { static_cast<size_t>(m_frame_count) * sizeof(T) };
+
             for (auto channel = 0; channel < m_channel_count; ++channel) {
-                for (auto i = 0; i < m_frame_count; ++i)
-                    m_samples[channel][i] = other.m_samples[channel][i];
+                if (m_samples[channel] != other.m_samples[channel])
+                    std::memmove(m_samples[channel], other.m_samples[channel], bytes);    // buffers may partially overlap
             }
             return *this;
         }
 
     private:
-        double** m_samples { nullptr };
-        long     m_channel_count {};
-        long     m_frame_count {};
+        T**                         m_samples { nullptr };
+        long                        m_channel_count {};
+        long                        m_frame_count {};
+        const min::channel_mask*    m_mask { nullptr };
+    };
+
+
+    /// The audio_bundle type used by Max's double precision signal chain.
+
+    using audio_bundle = basic_audio_bundle<double>;
+
+
+    /// Storage for converting the double precision audio of the signal chain to and from another sample type.
+    /// This is used internally by vector_operator<> classes whose sample type is not double.
+    /// The storage is allocated when the dsp chain is compiled so that no allocations happen in the perform routine.
+    /// @tparam	T	The sample type to convert to and from.
+
+    template<typename T>
+    class audio_bundle_converter {
+    public:
+
+        /// Allocate storage for the given number of channels and vector size.
+        /// @param	input_count		The number of input channels.
+        /// @param	output_count	The number of output channels.
+        /// @param	vector_size		The maximum number of samples per channel.
+
+        void resize(const long input_count, const long output_count, const long vector_size) {
+            m_storage.assign(static_cast<size_t>((input_count + output_count) * vector_size), T(0));
+            m_inputs.resize(static_cast<size_t>(input_count));
+            m_outputs.resize(static_cast<size_t>(output_count));
+
+            auto p = m_storage.data();
+            for (auto& channel : m_inputs) {
+                channel = p;
+                p += vector_size;
+            }
+            for (auto& channel : m_outputs) {
+                channel = p;
+                p += vector_size;
+            }
+            m_vector_size = vector_size;
+        }
+
+
+        /// Convert incoming audio into the input storage.
+        /// @param	samples			The incoming double precision audio.
+        /// @param	channel_count	The number of channels of incoming audio.
+        /// @param	frame_count		The number of samples per channel.
+        /// @return					An audio bundle referencing the converted audio.
+
+        basic_audio_bundle<T> input(const double* const* samples, const long channel_count, const long frame_count) {
+            assert(channel_count <= static_cast<long>(m_inputs.size()) && frame_count <= m_vector_size);
+
+            for (auto channel = 0; channel < channel_count; ++channel) {
+                auto in  = samples[channel];
+                auto out = m_inputs[channel];
+                for (auto i = 0; i < frame_count; ++i)
+                    out[i] = static_cast<T>(in[i]);
+            }
+            return { m_inputs.data(), channel_count, frame_count };
+        }
+
+
+        /// Get the output storage in which the vector_operator writes its results.
+        /// @param	channel_count	The number of channels of outgoing audio.
+        /// @param	frame_count		The number of samples per channel.
+        /// @return					An audio bundle referencing the output storage.
+
+        basic_audio_bundle<T> output(const long channel_count, const long frame_count) {
+            assert(channel_count <= static_cast<long>(m_outputs.size()) && frame_count <= m_vector_size);
+            return { m_outputs.data(), channel_count, frame_count };
+        }
+
+
+        /// Convert the results in the output storage back to double precision.
+        /// @param	samples			The outgoing double precision audio.
+        /// @param	channel_count	The number of channels of outgoing audio.
+        /// @param	frame_count		The number of samples per channel.
+
+        void write(double** samples, const long channel_count, const long frame_count) const {
+            for (auto channel = 0; channel < channel_count; ++channel) {
+                auto in  = m_outputs[channel];
+                auto out = samples[channel];
+                for (auto i = 0; i < frame_count; ++i)
+                    out[i] = static_cast<double>(in[i]);
+            }
+        }
+
+    private:
+        vector<T>   m_storage;
+        vector<T*>  m_inputs;
+        vector<T*>  m_outputs;
+        long        m_vector_size {};
+    };
+
+
+    /// Declare that the audio processing of your class is safe to perform in-place.
+    /// By default Min objects request separate signal buffers for their inputs and outputs from Max.
+    /// If your object reads all of the input samples for a frame before writing the output samples for the same frame
+    /// (as is always the case for a sample_operator<> with a per-sample call operator) then you may declare
+    /// `MIN_INPLACE { true };` in your class so that Max can reuse the input buffers for the outputs.
+
+    #define MIN_INPLACE static constexpr bool class_inplace
+
+
+    // SFINAE implementation used internally to determine if the Min class has
+    // declared itself as safe for in-place processing using the macro above.
+
+    template<typename min_class_type>
+    struct has_class_inplace {
+        template<class, class>
+        class checker;
+
+        template<typename C>
+        static std::true_type test(checker<C, decltype(&C::class_inplace)>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
+    // Used internally.
+    // Returns true if the Min class has declared that it is safe for in-place processing.
+
+    template<class min_class_type>
+    constexpr typename enable_if<has_class_inplace<min_class_type>::value, bool>::type class_is_inplace() {
+        return min_class_type::class_inplace;
+    }
+
+    template<class min_class_type>
+    constexpr typename enable_if<!has_class_inplace<min_class_type>::value, bool>::type class_is_inplace() {
+        return false;
+    }
+
+
+    // SFINAE implementation used internally to determine if the Min class selects its kernel when the dsp chain is compiled
+    // (see "Kernels" in the documentation of vector_operator).
+
+    template<class min_class_type, class = void>
+    struct has_select_kernel : std::false_type {};
+
+    template<class min_class_type>
+    struct has_select_kernel<min_class_type, std::void_t<decltype(std::declval<min_class_type&>().select_kernel())>> : std::true_type {};
+
+
+    // The kernel selected by a Min class that has a select_kernel() member function, stored in its minwrap.
+    // Classes without one store nothing.
+
+    template<class min_class_type, class = void>
+    struct selected_kernel {};
+
+    template<class min_class_type>
+    struct selected_kernel<min_class_type, typename enable_if<has_select_kernel<min_class_type>::value>::type> {
+        decltype(std::declval<min_class_type&>().select_kernel()) function { nullptr };
     };
 
 
@@ -114,22 +386,43 @@ namespace c74::min {
     struct minwrap<min_class_type, type_enable_if_audio_class<min_class_type>> {
         maxobject_header m_max_header;
         min_class_type   m_min_object;
+        perform_profile  m_profile;
+        silence_detector m_silence;
+        selected_kernel<min_class_type> m_kernel;
+#ifdef C74_MIN_REALTIME_CHECKS
+        realtime_violations m_realtime_violations;
+        logger              m_realtime_log { &m_min_object, logger::type::warning };
+        uint32_t            m_realtime_reports;
+#endif
 
 
         // Setup is called at instantiation.
 
         void setup() {
             max::dsp_setup(m_max_header, (long)m_min_object.inlets().size());
+            new (&m_profile) perform_profile;    // placement new, as only the Min class is constructed by the wrapper
+            m_profile.attach(maxobj());
+            new (&m_silence) silence_detector;
+            new (&m_kernel) selected_kernel<min_class_type>;
+#ifdef C74_MIN_REALTIME_CHECKS
+            new (&m_realtime_violations) realtime_violations;
+            new (&m_realtime_log) logger { &m_min_object, logger::type::warning };
+            m_realtime_log.prepare_async(16);
+            m_realtime_reports = 0;
+            realtime_check::prepare();
+#endif
 
             if (m_min_object.is_ui_class()) {
                 max::t_pxjbox* x = m_max_header;
-                x->z_misc |= Z_NO_INPLACE;
+                if (!class_is_inplace<min_class_type>())
+                    x->z_misc |= Z_NO_INPLACE;
                 if (is_base_of<mc_operator_base, min_class_type>::value)
                     x->z_misc |= Z_MC_INLETS;
             }
             else {
                 max::t_pxobject* x = m_max_header;
-                x->z_misc |= Z_NO_INPLACE;
+                if (!class_is_inplace<min_class_type>())
+                    x->z_misc |= Z_NO_INPLACE;
                 if (is_base_of<mc_operator_base, min_class_type>::value)
                     x->z_misc |= Z_MC_INLETS;
             }
@@ -141,6 +434,11 @@ namespace c74::min {
         // Cleanup is called when the object is freed.
 
         void cleanup() {
+            m_profile.detach();
+            m_profile.~perform_profile();
+#ifdef C74_MIN_REALTIME_CHECKS
+            m_realtime_log.~logger();
+#endif
             if (m_min_object.is_ui_class())
                 max::dsp_freejbox(m_max_header);
             else
@@ -174,13 +472,41 @@ namespace c74::min {
     /// In some cases inheriting from vector_operator<> will be more computationally efficient.
     /// This is particularly true if your object will perform buffer~ access.
     ///
-    /// @tparam vector_operator_placeholder_type	Unused. You should supply no arguments. For example, `vector_operator<>`.
+    /// By default audio is processed in double precision, as it is by Max.
+    /// Inheriting from `vector_operator<float>` instead converts the audio to and from single precision once per vector
+    /// so that the processing in your call operator can run in float (doubling the number of values per SIMD register).
+    ///
+    /// ## Kernels
+    ///
+    /// Which of its inlets are connected to signals, and other state that only changes when the dsp chain is compiled,
+    /// may call for different versions of the processing, e.g. one for a position given by a signal and a cheaper one for a constant position.
+    /// Rather than testing that state in every vector (or every sample) your class may define each version as a member function
+    /// with the signature of its call operator, and a member function `select_kernel()` which returns a pointer to the one to use.
+    /// It is called each time the dsp chain is compiled, after the signal connections are known and after a 'dspsetup' message,
+    /// and the wrapper then calls the selected member function for each vector instead of the call operator.
+    /// @code
+    /// auto select_kernel() {
+    ///     return in_pos.has_signal_connection() ? &xfade::modulated : &xfade::constant;
+    /// }
+    /// @endcode
+    /// A sample_operator<> may select between versions of its block call operator (see sample_block) in the same way.
+    ///
+    /// @tparam vector_operator_sample_type	The type of the samples in the audio bundles your call operator receives.
+    ///										Either double (the default, for example `vector_operator<>`) or float.
     /// @see sample_operator
     /// @see buffer_reference
 
-    template<placeholder vector_operator_placeholder_type = placeholder::none>
+    template<typename vector_operator_sample_type = sample>
     class vector_operator : public vector_operator_base {
+        static_assert(is_same<vector_operator_sample_type, double>::value || is_same<vector_operator_sample_type, float>::value,
+            "vector_operator<> only supports double and float sample types");
+
     public:
+        /// The type of the samples in the audio bundles passed to the call operator.
+
+        using sample_type = vector_operator_sample_type;
+
+
         ///	Set a new samplerate.
         /// You will not typically have any need to call this.
         /// It is called internally any time the dsp chain containing your object is compiled.
@@ -231,14 +557,38 @@ namespace c74::min {
         /// @param	input	The incoming audio.
         /// @param	output	The outgoing audio.
 
-        virtual void operator()(audio_bundle input, audio_bundle output) = 0;
+        virtual void operator()(basic_audio_bundle<sample_type> input, basic_audio_bundle<sample_type> output) = 0;
+
+
+        /// Get the storage used to convert audio to and from the sample type of this vector_operator.
+        /// You will not typically have any need to call this.
+        /// It is used internally when the sample type is not double.
+        /// @return	A reference to the converter.
+
+        audio_bundle_converter<sample_type>& converter() {
+            return m_converter;
+        }
 
     private:
-        double  m_samplerate { c74::max::sys_getsr() };        // initialized to the global samplerate, but updated to the local samplerate when the dsp chain is compiled.
-        int     m_vector_size { c74::max::sys_getblksize() };  // ...
+        double                              m_samplerate { c74::max::sys_getsr() };        // initialized to the global samplerate, but updated to the local samplerate when the dsp chain is compiled.
+        int                                 m_vector_size { c74::max::sys_getblksize() };  // ...
+        audio_bundle_converter<sample_type> m_converter;                                   // only allocated for sample types other than double
     };
 
 
+    // Process a vector with the kernel selected when the dsp chain was compiled, or with the call operator if the class does not select one.
+
+    template<class min_class_type, class input_type, class output_type>
+    void call_kernel(minwrap<min_class_type>* self, input_type& input, output_type& output) {
+        if constexpr (has_select_kernel<min_class_type>::value) {
+            const auto kernel { self->m_kernel.function };
+            (self->m_min_object.*kernel)(input, output);
+        }
+        else
+            self->m_min_object(input, output);
+    }
+
+
     // The performer class wraps the C callback routine for a Max audio "perform" method.
     // It adapts the calls coming from the Max application to the call operator implemented in the Min class.
     // The correct version of this enabled using SFINAE template enabling depending on whether this is a
@@ -254,7 +604,40 @@ namespace c74::min {
         static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
             audio_bundle input {in_chans, numins, sampleframes};
             audio_bundle output {out_chans, numouts, sampleframes};
-            self->m_min_object(input, output);
+
+            if constexpr (is_base_of<mc_operator_base, min_class_type>::value) {
+                const auto& mask { self->m_min_object.enabled_channels() };
+
+                output.channel_mask(&mask);
+                call_kernel(self, input, output);
+
+                for (auto channel = 0; channel < numouts; ++channel) {
+                    if (!mask.enabled(channel))
+                        std::fill_n(out_chans[channel], sampleframes, 0.0);
+                }
+            }
+            else
+                call_kernel(self, input, output);
+        }
+    };
+
+
+    // The performer class wraps the C callback routine for a Max audio "perform" method.
+    // This specialization is for vector_operator<float> classes.
+    // The audio is converted to single precision, processed, and converted back once per vector.
+
+    template<class min_class_type>
+    class performer<min_class_type, typename enable_if<is_base_of<vector_operator<float>, min_class_type>::value>::type> {
+    public:
+        // The traditional Max audio "perform" callback routine
+
+        static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*) {
+            auto& converter { self->m_min_object.converter() };
+            auto  input { converter.input(in_chans, numins, sampleframes) };
+            auto  output { converter.output(numouts, sampleframes) };
+
+            call_kernel(self, input, output);
+            converter.write(out_chans, numouts, sampleframes);
         }
     };
 
@@ -301,7 +684,7 @@ namespace c74::min {
 
     // The "dsp64" method for Max audio objects is split up into several components here.
     // The main "dsp64" method is min_dsp64(), which needs to obey basic C rules because it is called by Max.
-    // This in-turn then calls min_dsp64_sel() which is a templated C++ function that is specialized based on the properties of the Min
+    // This in-turn then calls min_dsp64_sel(), and that calls min_dsp64_prepare() which is a templated C++ function that is specialized based on the properties of the Min
     // class. Each of those specializations needs to perform some common/shared functions which are then factored out as well.
 
     // The min_dsp64_io function handles updating the inlet and outlet connection state any time the dsp64 message is called.
@@ -328,49 +711,166 @@ namespace c74::min {
     {}
 
 
+    // The min_dsp64_converter function allocates the storage used by vector_operator<float> classes
+    // to convert audio to and from double precision, so that the perform routine never allocates.
+
+    template<class min_class_type, enable_if_vector_operator<min_class_type> = 0>
+    void min_dsp64_converter(minwrap<min_class_type>* self, const long maxvectorsize) {
+        if (!is_same<typename min_class_type::sample_type, double>::value) {
+            auto& object { self->m_min_object };
+            object.converter().resize(static_cast<long>(object.inlets().size()), static_cast<long>(object.outlets().size()), maxvectorsize);
+        }
+    }
+
+
+    // The min_dsp64_smoothing function sets the length of the ramps of smoothed attributes for the new samplerate.
+
+    template<class min_class_type>
+    void min_dsp64_smoothing(minwrap<min_class_type>* self, const double samplerate) {
+        for (const auto& an_attribute : self->m_min_object.attributes())
+            an_attribute.second->prepare_smoothing(samplerate);
+    }
+
+
+#ifdef C74_MIN_REALTIME_CHECKS
+
+    // Report what one call of the perform routine did that it should not, through the async logger.
+    // Only the first few calls with violations are reported, as the same violation usually happens in every vector.
+
+    template<class min_class_type>
+    void report_realtime_violations(minwrap<min_class_type>* self) {
+        constexpr uint32_t k_report_limit { 8 };
+        auto&              v { self->m_realtime_violations };
+
+        if (!v.any())
+            return;
+
+        if (self->m_realtime_reports < k_report_limit) {
+            ++self->m_realtime_reports;
+
+            auto line { self->m_realtime_log.async() };
+            line << v.first << " in the perform routine: " << v.heap << " heap operations, " << v.locks << " locks, "
+                 << v.blocking_calls << " blocking calls. First at";
+            for (auto i = 0; i < v.frame_count; ++i)
+                line << ' ' << v.frames[i];
+            if (self->m_realtime_reports == k_report_limit)
+                line << ". Further violations are not reported.";
+            line << endl;
+        }
+        v.clear();
+    }
+
+#endif
+
+
+    // The profiled_perform function is the perform method that is added to the signal chain.
+    // It calls the performer, and measures the time the call takes while profiling is enabled (see perform_profile).
+    // With C74_MIN_REALTIME_CHECKS it also reports allocations and locks during the call (see realtime_check).
+    // Denormals are flushed to zero during the call unless the class declares otherwise (see denormal_guard).
+    // If the class defines silence_tail() the call is skipped once the inputs have been silent for longer than the tail (see silence_detector).
+
+    template<class min_class_type>
+    void profiled_perform(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long flags, const void* userparam) {
+#ifdef C74_MIN_REALTIME_CHECKS
+        struct reporter {
+            minwrap<min_class_type>* self;
+            ~reporter() {
+                report_realtime_violations(self);
+            }
+        } report { self };    // destroyed after the scope below, so the report is not counted
+        realtime_check::scope checking { self->m_realtime_violations };
+#endif
+        denormal_guard<class_flushes_denormals<min_class_type>()> flushing;
+
+        if constexpr (has_silence_tail<min_class_type>::value) {
+            if (self->m_silence.skip(in_chans, numins, sampleframes, self->m_min_object.silence_tail())) {
+                for (auto channel = 0; channel < numouts; ++channel)
+                    std::fill_n(out_chans[channel], sampleframes, 0.0);
+                return;
+            }
+        }
+
+        if (!perform_profile::enabled()) {
+            performer<min_class_type>::perform(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, flags, userparam);
+            return;
+        }
+
+        const auto start { perform_profile::now() };
+        performer<min_class_type>::perform(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, flags, userparam);
+        self->m_profile.record(perform_profile::now() - start);
+    }
+
+
+    // The min_dsp64_kernel function lets a class that defines select_kernel() choose its kernel for the new signal connections.
+
+    template<class min_class_type>
+    void min_dsp64_kernel(minwrap<min_class_type>* self) {
+        if constexpr (has_select_kernel<min_class_type>::value) {
+            self->m_kernel.function = self->m_min_object.select_kernel();
+            assert(self->m_kernel.function != nullptr);
+        }
+    }
+
+
     // The min_dsp64_add_perform function handles adding the perform method to the signal chain (see performer class above)
 
     template<class min_class_type>
     void min_dsp64_add_perform(minwrap<min_class_type>* self, max::t_object* dsp64) {
+        self->m_silence.reset();
+
         // find the perform method and add it
         using namespace c74::max;
         object_method_direct(void, (void*, max::t_object*, const max::t_perfroutine64, const long, const void*), dsp64, symbol("dsp_add64"),
-            self->maxobj(), reinterpret_cast<max::t_perfroutine64>(performer<min_class_type>::perform), 0, NULL);
+            self->maxobj(), reinterpret_cast<max::t_perfroutine64>(profiled_perform<min_class_type>), 0, NULL);
     }
 
 
-    // A specialization of min_dsp64_sel for classes that have a custom "dspsetup" message.
-
+    // The min_dsp64_prepare function does everything that compiling the signal chain does to an object except adding its perform method,
+    // so that an offline_render can prepare an object in the same way.
+    // A specialization of min_dsp64_prepare for classes that have a custom "dspsetup" message.
 
     template<class min_class_type>
     typename enable_if<has_dspsetup<min_class_type>::value
     || has_m_dspsetup<min_class_type>::value>::type
-    min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags) {
+    min_dsp64_prepare(minwrap<min_class_type>* self, const short* count, const double samplerate, const long maxvectorsize) {
         self->m_min_object.samplerate(samplerate);
         self->m_min_object.vector_size(maxvectorsize);
         min_dsp64_io(self, count);
         min_dsp64_attrmap(self, count);
+        min_dsp64_converter(self, maxvectorsize);
+        min_dsp64_smoothing(self, samplerate);
 
         atoms args;
         args.push_back(atom(samplerate));
         args.push_back(atom(max::t_atom_long(maxvectorsize)));
         self->m_min_object.dspsetup(args);
 
-        min_dsp64_add_perform(self, dsp64);
+        min_dsp64_kernel(self);
     }
 
 
-    // A (non)specialization of min_dsp64_sel for classes that do _not_ have a custom "dspsetup" message
+    // A (non)specialization of min_dsp64_prepare for classes that do _not_ have a custom "dspsetup" message
     // (which is most audio classes).
 
     template<class min_class_type>
     typename enable_if<!has_dspsetup<min_class_type>::value
     && !has_m_dspsetup<min_class_type>::value>::type
-    min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags) {
+    min_dsp64_prepare(minwrap<min_class_type>* self, const short* count, const double samplerate, const long maxvectorsize) {
         self->m_min_object.samplerate(samplerate);
         self->m_min_object.vector_size(maxvectorsize);
         min_dsp64_io(self, count);
         min_dsp64_attrmap(self, count);
+        min_dsp64_converter(self, maxvectorsize);
+        min_dsp64_smoothing(self, samplerate);
+        min_dsp64_kernel(self);
+    }
+
+
+    // Prepare the object for the new signal chain and add its perform method to it.
+
+    template<class min_class_type>
+    void min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags) {
+        min_dsp64_prepare(self, count, samplerate, maxvectorsize);
         min_dsp64_add_perform(self, dsp64);
     }
 
@@ -25,18 +25,22 @@ namespace c74::min {
     // Regardless of how the threading is handled, when it comes time to actually send the data to the outlet the
     // outlet_do_send() helper function is called.
 
-    template<typename outlet_type>
-    inline void outlet_do_send(const t_max_outlet maxoutlet, const outlet_type& value) {
-        if (value[0].a_type == max::A_LONG || value[0].a_type == max::A_FLOAT)
-            max::outlet_list(maxoutlet, nullptr, static_cast<short>(value.size()), (max::t_atom*)&value[0]);
+    inline void outlet_do_send(const t_max_outlet maxoutlet, const max::t_atom* av, const long ac) {
+        if (av[0].a_type == max::A_LONG || av[0].a_type == max::A_FLOAT)
+            max::outlet_list(maxoutlet, nullptr, static_cast<short>(ac), const_cast<max::t_atom*>(av));
         else {
-            if (value.size() > 1)
-                max::outlet_anything(maxoutlet, value[0], static_cast<short>(value.size() - 1), (max::t_atom*)&value[1]);
+            if (ac > 1)
+                max::outlet_anything(maxoutlet, av[0].a_w.w_sym, static_cast<short>(ac - 1), const_cast<max::t_atom*>(av + 1));
             else
-                max::outlet_anything(maxoutlet, value[0], 0, nullptr);
+                max::outlet_anything(maxoutlet, av[0].a_w.w_sym, 0, nullptr);
         }
     }
 
+    template<typename outlet_type>
+    inline void outlet_do_send(const t_max_outlet maxoutlet, const outlet_type& value) {
+        outlet_do_send(maxoutlet, &value[0], static_cast<long>(value.size()));
+    }
+
     template<>
     inline void outlet_do_send<max::t_atom_long>(const t_max_outlet maxoutlet, const max::t_atom_long& value) {
         max::outlet_int(maxoutlet, value);
@@ -139,42 +143,390 @@ namespace c74::min {
     };
 
 
+    /// Determines what happens when a value is sent to an outlet whose fixed-capacity queue is full.
+    /// @see outlet_queue
+
+    enum class queue_overflow {
+        drop,      ///< Discard the value and count it as dropped (the default).
+        assert     ///< Terminate execution in debug builds. In release builds the value is dropped.
+    };
+
+
+    // The storage shared by the FIFO and BATCH outlet queues.
+    //
+    // The values are stored in a fixed-capacity ring of slots that is allocated when the outlet is created,
+    // so sending from the audio thread never touches the heap.
+    // Each slot holds a few atoms inline. Longer lists occupy several consecutive slots.
+    // There is one producer (the thread sending to the outlet) and one consumer (the thread of the thread_check).
+
+    class outlet_event_ring {
+
+        static constexpr size_t k_inline_atom_count { 3 };
+        static constexpr size_t k_default_capacity  { 256 };
+
+        struct event_slot {
+            message_type    type;
+            long            count;
+            double          time;
+            int64_t         pushed;                        // queue_health::now() when the value was pushed
+            max::t_atom     atoms[k_inline_atom_count];    // continuation slots of long lists only use this member
+        };
+
+    public:
+        outlet_event_ring() {
+            capacity(k_default_capacity);
+        }
+
+
+        // Called by the producer.
+        // Returns false if the value was dropped because the ring is full.
+
+        bool push(const message_type a_type, const max::t_atom* av, const long ac, const double a_time = 0.0) {
+            const auto  write   { m_write.load(std::memory_order_relaxed) };
+            const auto  read    { m_read.load(std::memory_order_acquire) };
+            const auto  needed  { slots_for(ac) };
+
+            if (m_slots.size() - (write - read) < needed) {
+                assert(m_overflow != queue_overflow::assert);
+                m_health.record_overflow();
+                return false;
+            }
+
+            auto& slot { m_slots[write & m_mask] };
+            slot.type   = a_type;
+            slot.count  = ac;
+            slot.time   = a_time;
+            slot.pushed = queue_health::now();
+            for (auto i = 0; i < ac; ++i)
+                m_slots[(write + i / k_inline_atom_count) & m_mask].atoms[i % k_inline_atom_count] = av[i];
+
+            m_write.store(write + needed, std::memory_order_release);
+            m_health.record_depth(write + needed - read);
+            return true;
+        }
+
+
+        // Called by the consumer.
+        // Calls f(type, av, ac, time) for every value in the ring, in the order they were pushed.
+
+        template<class function_type>
+        void drain(function_type&& f) {
+            auto        read  { m_read.load(std::memory_order_relaxed) };
+            const auto  write { m_write.load(std::memory_order_acquire) };
+            const auto  now   { queue_health::now() };
+
+            while (read != write) {
+                const auto& slot { m_slots[read & m_mask] };
+
+                m_health.record_latency(slot.pushed, now);
+                if (slot.count <= static_cast<long>(k_inline_atom_count))
+                    f(slot.type, slot.atoms, slot.count, slot.time);
+                else {
+                    // gather a list that spans several slots (on the consumer thread, so allocation is permitted)
+                    m_gathered.clear();
+                    for (auto i = 0; i < slot.count; ++i)
+                        m_gathered.push_back(m_slots[(read + i / k_inline_atom_count) & m_mask].atoms[i % k_inline_atom_count]);
+                    f(slot.type, &m_gathered[0], slot.count, slot.time);
+                }
+                read += slots_for(slot.count);
+            }
+            m_read.store(read, std::memory_order_release);
+        }
+
+
+        // Called by the consumer.
+        // Like drain() but stops at the first value whose time is later than a_time.
+        // Returns true if values remain, in which case the time of the next one is returned in next_time.
+
+        template<class function_type>
+        bool drain_until(const double a_time, function_type&& f, double& next_time) {
+            auto        read  { m_read.load(std::memory_order_relaxed) };
+            const auto  write { m_write.load(std::memory_order_acquire) };
+            const auto  now   { queue_health::now() };
+
+            while (read != write) {
+                const auto& slot { m_slots[read & m_mask] };
+
+                if (slot.time > a_time) {
+                    m_read.store(read, std::memory_order_release);
+                    next_time = slot.time;
+                    return true;
+                }
+
+                m_health.record_latency(slot.pushed, now);
+                if (slot.count <= static_cast<long>(k_inline_atom_count))
+                    f(slot.type, slot.atoms, slot.count, slot.time);
+                else {
+                    m_gathered.clear();
+                    for (auto i = 0; i < slot.count; ++i)
+                        m_gathered.push_back(m_slots[(read + i / k_inline_atom_count) & m_mask].atoms[i % k_inline_atom_count]);
+                    f(slot.type, &m_gathered[0], slot.count, slot.time);
+                }
+                read += slots_for(slot.count);
+            }
+            m_read.store(read, std::memory_order_release);
+            return false;
+        }
+
+
+        /// Set the number of slots in the queue.
+        /// This reallocates the queue and must not be called while values are being sent (e.g. call it in your constructor).
+        /// @param	slot_count	The number of slots, which is rounded up to a power of two.
+        ///						A list of values takes one slot for every three atoms.
+
+        void capacity(const size_t slot_count) {
+            size_t size { 1 };
+            while (size < slot_count)
+                size <<= 1;
+
+            m_slots.assign(size, event_slot {});
+            m_mask = size - 1;
+            m_read.store(0);
+            m_write.store(0);
+        }
+
+
+        /// The number of slots in the queue.
+        /// @return	The number of slots.
+
+        size_t capacity() const {
+            return m_slots.size();
+        }
+
+
+        /// Set the policy for values sent while the queue is full.
+        /// @param	policy	The overflow policy.
+
+        void overflow(const queue_overflow policy) {
+            m_overflow = policy;
+        }
+
+
+        /// The number of values that have been dropped because the queue was full.
+        /// @return	The count of dropped values since the outlet was created.
+
+        size_t dropped() const {
+            return m_health.overflows();
+        }
+
+
+        /// The health of the queue: the most slots in use at once, the dropped values,
+        /// and the time from sending a value to its delivery (for values sent with send_at(), including the intended delay).
+        /// @return	The counters, which may be summarized and cleared by any thread.
+
+        queue_health& health() {
+            return m_health;
+        }
+
+        const queue_health& health() const {
+            return m_health;
+        }
+
+    private:
+        vector<event_slot>  m_slots;
+        size_t              m_mask {};
+        std::atomic<size_t> m_read { 0 };     // only modified by the consumer
+        std::atomic<size_t> m_write { 0 };    // only modified by the producer
+        queue_health        m_health;
+        queue_overflow      m_overflow { queue_overflow::drop };
+        atoms               m_gathered;       // only used by the consumer
+
+        static size_t slots_for(const long atom_count) {
+            return std::max<size_t>(1, (static_cast<size_t>(atom_count) + k_inline_atom_count - 1) / k_inline_atom_count);
+        }
+    };
+
+
     // FIFO: defer all values
+    //
+    // Values sent with outlet<>::send_at() carry a time stamp from the audio thread.
+    // When delivering in the scheduler thread those values are re-spaced using a clock
+    // so that they keep the timing they had within (and across) the audio vectors in which they were sent,
+    // rather than all being delivered at once when the scheduler next runs.
 
     template<thread_check check>
-    class outlet_queue<check, thread_action::fifo> : public thread_trigger<t_max_outlet, check> {
+    class outlet_queue<check, thread_action::fifo> : public thread_trigger<t_max_outlet, check>, public outlet_event_ring {
+    public:
+        static constexpr double k_untimed { -1.0 };    // time stamp for values sent with send() rather than send_at()
 
-        struct tagged_atoms {
-            message_type m_type;
-            atoms        m_as;
-        };
+        explicit outlet_queue(const t_max_outlet a_maxoutlet)
+        : thread_trigger<t_max_outlet, check>(a_maxoutlet) {
+            if (check == thread_check::scheduler)
+                m_clock = max::clock_new(this, reinterpret_cast<max::method>(scheduled_callback));
+        }
+
+
+        ~outlet_queue() {
+            if (m_clock)
+                max::object_free(m_clock);
+        }
+
+
+        void callback() {
+            bool    have_origin { false };
+            double  origin {};
+            double  now {};
+
+            if (m_clock)
+                max::clock_getftime(&now);
+
+            drain([&](const message_type a_type, const max::t_atom* av, const long ac, const double a_time) {
+                if (a_time == k_untimed || !m_clock)
+                    deliver(a_type, av, ac);
+                else {
+                    // the first time-stamped value of this delivery is output now and the others relative to it
+                    if (!have_origin) {
+                        origin = now - a_time;
+                        have_origin = true;
+                    }
+                    m_scheduled.push(a_type, av, ac, a_time + origin);
+                }
+            });
+
+            if (have_origin)
+                deliver_scheduled();
+        }
+
+
+        void push(const message_type a_type, const max::t_atom_long value, const double a_time = k_untimed) {
+            max::t_atom a;
+            max::atom_setlong(&a, value);
+            push(a_type, &a, 1, a_time);
+        }
+
+
+        void push(const message_type a_type, const double value, const double a_time = k_untimed) {
+            max::t_atom a;
+            max::atom_setfloat(&a, value);
+            push(a_type, &a, 1, a_time);
+        }
+
+
+        void push(const message_type a_type, const atoms& as) {
+            push(a_type, &as[0], static_cast<long>(as.size()), k_untimed);
+        }
+
+
+        void push(const message_type a_type, const atoms& as, const double a_time) {
+            push(a_type, &as[0], static_cast<long>(as.size()), a_time);
+        }
 
+    private:
+        max::t_clock*       m_clock { nullptr };    // only for the scheduler thread: delivers time-stamped values
+        outlet_event_ring   m_scheduled;            // time-stamped values waiting for their time, in scheduler time
+
+        void push(const message_type a_type, const max::t_atom* av, const long ac, const double a_time) {
+            if (outlet_event_ring::push(a_type, av, ac, a_time))
+                thread_trigger<t_max_outlet, check>::set();
+        }
+
+
+        void deliver(const message_type a_type, const max::t_atom* av, const long ac) {
+            if (a_type == message_type::int_argument)
+                outlet_do_send<max::t_atom_long>(this->m_baton, av[0].a_w.w_long);
+            else if (a_type == message_type::float_argument)
+                outlet_do_send<double>(this->m_baton, av[0].a_w.w_float);
+            else
+                outlet_do_send(this->m_baton, av, ac);
+        }
+
+
+        void deliver_scheduled() {
+            double now;
+            double next;
+
+            max::clock_getftime(&now);
+            auto remaining = m_scheduled.drain_until(now, [this](const message_type a_type, const max::t_atom* av, const long ac, const double) {
+                deliver(a_type, av, ac);
+            }, next);
+
+            if (remaining)
+                max::clock_fdelay(m_clock, next - now);
+        }
+
+
+        static void scheduled_callback(outlet_queue* self) {
+            self->deliver_scheduled();
+        }
+    };
+
+
+    // BATCH: defer all values and deliver everything received since the last delivery as a single list
+    //
+    // Optionally each value in the list is preceded by the time (in milliseconds) at which it was sent.
+
+    template<thread_check check>
+    class outlet_queue<check, thread_action::batch> : public thread_trigger<t_max_outlet, check>, public outlet_event_ring {
     public:
         explicit outlet_queue(const t_max_outlet a_maxoutlet)
-        : thread_trigger<t_max_outlet, check>(a_maxoutlet)
-        {}
+        : thread_trigger<t_max_outlet, check>(a_maxoutlet) {
+            m_batch.reserve(64);
+        }
+
 
         void callback() {
-            tagged_atoms tas;
-            while (m_values.try_dequeue(tas)) {
-                if (tas.m_type == message_type::int_argument)
-                    outlet_do_send<max::t_atom_long>(this->m_baton, tas.m_as[0]);
-                else if (tas.m_type == message_type::float_argument)
-                    outlet_do_send<double>(this->m_baton, tas.m_as[0]);
-                else
-                    outlet_do_send(this->m_baton, tas.m_as);
-            }
+            m_pending.clear();
+
+            const bool timestamps { m_timestamps };
+
+            m_batch.clear();
+            drain([this, timestamps](const message_type, const max::t_atom* av, const long ac, const double a_time) {
+                if (timestamps)
+                    m_batch.push_back(a_time);
+                m_batch.insert(m_batch.end(), av, av + ac);
+            });
+
+            if (!m_batch.empty())
+                outlet_do_send(this->m_baton, m_batch);
         }
 
+
+        void push(const message_type a_type, const max::t_atom_long value) {
+            max::t_atom a;
+            max::atom_setlong(&a, value);
+            push(a_type, &a, 1);
+        }
+
+
+        void push(const message_type a_type, const double value) {
+            max::t_atom a;
+            max::atom_setfloat(&a, value);
+            push(a_type, &a, 1);
+        }
+
+
         void push(const message_type a_type, const atoms& as) {
-            tagged_atoms tas{a_type, as};
-            m_values.enqueue(tas);
-            thread_trigger<t_max_outlet, check>::set();
+            push(a_type, &as[0], static_cast<long>(as.size()));
+        }
+
+
+        /// Precede each value in the delivered list by the time at which it was sent.
+        /// @param	enable	True to include timestamps.
+
+        void timestamps(const bool enable) {
+            m_timestamps = enable;
         }
 
 
+        /// Determine if each value in the delivered list is preceded by the time at which it was sent.
+        /// @return	True if timestamps are included.
+
+        bool timestamps() const {
+            return m_timestamps;
+        }
+
     private:
-        fifo<tagged_atoms> m_values;
+        atoms               m_batch;                // only used by the consumer
+        std::atomic_flag    m_pending = ATOMIC_FLAG_INIT;
+        std::atomic<bool>   m_timestamps { false };
+
+        void push(const message_type a_type, const max::t_atom* av, const long ac) {
+            const auto now { m_timestamps ? static_cast<double>(max::systimer_gettime()) : 0.0 };
+
+            // only trigger one delivery for all of the values received before it happens
+            if (outlet_event_ring::push(a_type, av, ac, now) && !m_pending.test_and_set())
+                thread_trigger<t_max_outlet, check>::set();
+        }
     };
 
 
@@ -210,10 +562,10 @@ namespace c74::min {
     template<thread_check check_type, thread_action action_type, typename outlet_type>
     class handle_unsafe_outlet_send {
     public:
-        handle_unsafe_outlet_send(outlet<check_type, thread_action::fifo>* an_outlet, const outlet_type& a_value) {
-            if (typeid(outlet_type) == typeid(max::t_atom_long))
+        handle_unsafe_outlet_send(outlet<check_type, action_type>* an_outlet, const outlet_type& a_value) {
+            if constexpr (is_same<outlet_type, max::t_atom_long>::value)
                 an_outlet->queue_storage().push(message_type::int_argument, a_value);
-            else if (typeid(outlet_type) == typeid(double))
+            else if constexpr (is_same<outlet_type, double>::value)
                 an_outlet->queue_storage().push(message_type::float_argument, a_value);
             else    // atoms
                 an_outlet->queue_storage().push(message_type::gimme, a_value);
@@ -398,6 +750,25 @@ namespace c74::min {
         }
 
 
+        /// Send an array of numbers out an outlet.
+        /// Objects that define a "float_array" message receive a reference to the array rather than a list of its numbers (see float_array).
+        /// The numbers are sent as a list instead if any object connected to the outlet does not define that message,
+        /// or if the outlet cannot send on the calling thread.
+        /// @param value The values to send.
+
+        void send(const float_array& value) {
+            if (value.empty())
+                return;
+
+            if (outlet_call_is_safe<check>() && outlet_receivers_define(m_owner->maxobj(), index(), k_sym_float_array)) {
+                atom name { m_arrays.publish(value) };
+                max::outlet_anything(m_instance, k_sym_float_array, 1, &name);
+            }
+            else
+                send(value.to_atoms());
+        }
+
+
         /// Send values out an outlet
         /// @param args The values to send.
 
@@ -417,9 +788,68 @@ namespace c74::min {
             send(args...);
         }
 
+
+        /// Send values out an outlet at a specific time.
+        /// This is intended for events sent from the audio thread to a thread_action::fifo outlet that delivers in the scheduler thread.
+        /// Values sent this way keep their spacing in time when delivered rather than being quantized to the audio vector.
+        /// If the outlet call is safe on the current thread the values are sent immediately.
+        /// @param	a_time	The time of the event in milliseconds, e.g. from sample_operator<>::sample_time().
+        /// @param	args	The values to send.
+
+        template<typename... ARGS>
+        void send_at(const double a_time, ARGS... args) {
+            static_assert(action == thread_action::fifo, "send_at() requires an outlet with thread_action::fifo");
+
+            if (outlet_call_is_safe<check>())
+                send(args...);
+            else {
+                handle_arguments(args...);
+                if (!m_accumulated_output.empty())
+                    m_queue_storage.push(message_type::gimme, m_accumulated_output, a_time);
+                m_accumulated_output.clear();
+            }
+        }
+
+
+        /// Send values out an outlet at a specific time.
+        /// Unlike the variadic version the values are not copied before they are queued,
+        /// so a list that was prepared in advance (e.g. with reserved storage) is sent without allocating.
+        /// @param	a_time	The time of the event in milliseconds, e.g. from sample_operator<>::sample_time().
+        /// @param	values	The values to send.
+
+        void send_at(const double a_time, const atoms& values) {
+            static_assert(action == thread_action::fifo, "send_at() requires an outlet with thread_action::fifo");
+
+            if (values.empty())
+                return;
+            if (outlet_call_is_safe<check>())
+                send(values);
+            else
+                m_queue_storage.push(message_type::gimme, values, a_time);
+        }
+
+
+        /// Get the queue that delivers values sent from threads which do not pass the thread check.
+        /// For a thread_action::fifo or thread_action::batch outlet this may be used to set the capacity and overflow policy
+        /// of the queue, or to read how many values have been dropped.
+        /// @return	A reference to the queue.
+
+        outlet_queue<check, action>& queue() {
+            return m_queue_storage;
+        }
+
     private:
         atoms                       m_accumulated_output;
         outlet_queue<check, action> m_queue_storage { this->m_instance };
+        float_array_publisher       m_arrays;    // names the last array sent, for as long as it is kept
+
+
+        // the index of the outlet from the left, as used by patch cords
+
+        long index() const {
+            const auto& outlets { m_owner->outlets() };
+            return static_cast<long>(std::find(outlets.begin(), outlets.end(), this) - outlets.begin());
+        }
 
 
         // called by object_base::create_outlets() when the owning object is constructed
@@ -12,14 +12,21 @@ namespace c74::min {
     /// This could be a box, a patcher, or anything else that is a live instance of a class in Max.
 
     class instance {
+    public:
+        /// A method of an instance that has been looked up with resolve(),
+        /// so that it can be called repeatedly without searching the messages of the instance again.
+
         struct messinfo {
             max::t_object*  ob;
             max::method     fn;
             int             type;
+
+            explicit operator bool() const {
+                return ob != nullptr;
+            }
         };
 
 
-    public:
         instance(max::t_object* an_instance = nullptr)
         : m_instance { an_instance }
         {}
@@ -50,7 +57,39 @@ namespace c74::min {
         /// call a method on an instance
 
         atom operator()(const symbol method_name) {
-            auto m { find_method(method_name) };
+            return call(find_method(method_name), method_name);
+        }
+
+
+        template<typename T1>
+        atom operator()(const symbol method_name, const T1 arg1) {
+            return call(find_method(method_name), method_name, arg1);
+        }
+
+
+        template<typename T1, typename T2>
+        atom operator()(const symbol method_name, const T1 arg1, const T2 arg2) {
+            return call(find_method(method_name), method_name, arg1, arg2);
+        }
+
+
+        /// Look up a method of the instance once, for calling it repeatedly with call().
+        /// @param	method_name	The name of the method.
+        /// @return				The method, which is false if the instance has no such method.
+
+        messinfo resolve(const symbol method_name) {
+            return find_method(method_name);
+        }
+
+
+        /// Call a method that has been looked up with resolve().
+        /// @param	m			The method.
+        /// @param	method_name	The name of the method, which it is called with.
+        /// @return				The return value of the method, or an empty atom if the method was not found.
+
+        atom call(const messinfo& m, const symbol method_name) {
+            if (!m)
+                return {};
 
             if (m.type == max::A_GIMME) {
                 atoms as {};
@@ -70,8 +109,9 @@ namespace c74::min {
 
 
         template<typename T1>
-        atom operator()(const symbol method_name, const T1 arg1) {
-            auto m { find_method(method_name) };
+        atom call(const messinfo& m, const symbol method_name, const T1 arg1) {
+            if (!m)
+                return {};
 
             if (m.type == max::A_GIMME) {
                 atoms   as { arg1 };
@@ -97,8 +137,9 @@ namespace c74::min {
 
 
         template<typename T1, typename T2>
-        atom operator()(const symbol method_name, const T1 arg1, const T2 arg2) {
-            auto m { find_method(method_name) };
+        atom call(const messinfo& m, const symbol method_name, const T1 arg1, const T2 arg2) {
+            if (!m)
+                return {};
 
             if (m.type == max::A_GIMME) {
                 atoms   as { arg1, arg2 };
@@ -207,6 +248,35 @@ namespace c74::min {
         void name(const symbol a_new_scripting_name) {
             max::jbox_set_varname(m_instance, a_new_scripting_name);
         }
+
+
+        /// Read several properties of the box at once.
+        /// @param	fields	The properties to read: "classname", "path", "name", or the name of any attribute of the box.
+        /// @return			The values of the properties in order. An attribute adds as many atoms as it has values,
+        ///					a property that does not exist adds none.
+
+        atoms properties(const vector<symbol>& fields) const {
+            atoms values;
+
+            for (const auto& field : fields) {
+                if (field == "classname")
+                    values.push_back(classname());
+                else if (field == "path")
+                    values.push_back(path());
+                else if (field == "name")
+                    values.push_back(name());
+                else {
+                    long         argc {};
+                    max::t_atom* argv {};
+
+                    if (!max::object_attr_getvalueof(m_instance, field, &argc, &argv) && argv) {
+                        values.insert(values.end(), argv, argv + argc);
+                        max::sysmem_freeptr(argv);
+                    }
+                }
+            }
+            return values;
+        }
     };
     
     using boxes = std::vector<box>;
@@ -265,9 +335,245 @@ namespace c74::min {
              return max::jpatcher_get_name(m_instance);
         }
 
+
+        /// Read several properties of every box in a single walk of the patcher,
+        /// rather than walking it once for each property.
+        /// @param	fields	The properties to read, as for box::properties().
+        /// @return			One row for each box, in the order of the patcher.
+
+        vector<atoms> query(const vector<symbol>& fields) const {
+            vector<atoms> rows;
+
+            for (auto b = max::jpatcher_get_firstobject(m_instance); b; b = max::jbox_get_nextobject(b))
+                rows.push_back(box(b).properties(fields));
+            return rows;
+        }
+
+
+        /// Edits of the attributes of boxes that are applied together.
+        /// Setting attributes of boxes one at a time marks the patcher as modified and invalidates it for every edit.
+        /// A transaction collects the edits instead, and applies them all at once when it is committed or destroyed,
+        /// after which the patcher is marked as modified once.
+        /// Edits of boxes that have been deleted in the meantime are skipped.
+
+        class transaction {
+        public:
+            /// Begin a transaction.
+            /// @param	a_patcher	The patcher of the boxes that are edited.
+
+            explicit transaction(max::t_object* a_patcher)
+            : m_patcher { a_patcher }
+            {}
+
+            ~transaction() {
+                commit();
+            }
+
+            transaction(const transaction&) = delete;
+            transaction& operator=(const transaction&) = delete;
+
+
+            /// Add an edit, which is applied with the commit.
+            /// @param	a_box		The box to edit.
+            /// @param	attribute	The name of the attribute.
+            /// @param	values		The new value of the attribute.
+
+            void set(max::t_object* a_box, const symbol attribute, const atoms& values) {
+                m_edits.push_back({ a_box, attribute, values });
+            }
+
+
+            /// Return the number of edits that have not been applied yet.
+
+            size_t size() const {
+                return m_edits.size();
+            }
+
+
+            /// Apply all edits, in the order they were added.
+
+            void commit() {
+                if (m_edits.empty() || !m_patcher)
+                    return;
+
+                // one walk of the patcher tells which boxes still exist
+                vector<max::t_object*> existing;
+                for (auto b = max::jpatcher_get_firstobject(m_patcher); b; b = max::jbox_get_nextobject(b))
+                    existing.push_back(b);
+                std::sort(existing.begin(), existing.end());
+
+                for (const auto& e : m_edits) {
+                    if (std::binary_search(existing.begin(), existing.end(), e.box))
+                        max::object_attr_setvalueof(e.box, e.attribute, static_cast<long>(e.values.size()), const_cast<atom*>(e.values.data()));
+                }
+                m_edits.clear();
+                max::jpatcher_set_dirty(m_patcher, true);
+            }
+
+
+            /// Discard all edits that have not been applied yet.
+
+            void cancel() {
+                m_edits.clear();
+            }
+
+        private:
+            struct edit {
+                max::t_object*  box;
+                symbol          attribute;
+                atoms           values;
+            };
+
+            max::t_object*  m_patcher;
+            vector<edit>    m_edits;
+        };
+
     private:
         min::boxes      m_boxes     {};
     };
 
 
+    /// An index of the boxes of a patcher by scripting name and by class name.
+    /// patcher::boxes() walks all boxes of the patcher whenever it is called, and finding a box by its name in that list
+    /// compares every name. The index is built once and looked up by the interned symbols instead.
+    /// It is kept until the patcher or one of its boxes changes: the listener is attached to them,
+    /// and the owner forwards the notifications it receives to notify(), which drops the index so that the next lookup builds it again.
+
+    class box_index {
+    public:
+        /// Create an index, which is built with the first lookup.
+        /// @param	a_listener	The Max object that is attached to the patcher and its boxes, typically maxobj() of the owner.
+
+        explicit box_index(max::t_object* a_listener)
+        : m_listener { a_listener }
+        {}
+
+        ~box_index() {
+            clear();
+        }
+
+        // the listener is attached to the boxes of the index
+        box_index(const box_index&) = delete;
+        box_index& operator=(const box_index&) = delete;
+
+
+        /// Return all boxes of a patcher, in the order of the patcher.
+        /// @param	a_patcher	The patcher.
+        /// @return				The boxes.
+
+        const min::boxes& all(max::t_object* a_patcher) {
+            update(a_patcher);
+            return m_boxes;
+        }
+
+
+        /// Find a box by its scripting name.
+        /// @param	a_patcher	The patcher.
+        /// @param	a_name		The scripting name of the box.
+        /// @return				The box, or nullptr if no box in the patcher has the name.
+
+        box* find(max::t_object* a_patcher, const symbol a_name) {
+            update(a_patcher);
+            const auto found { m_names.find(static_cast<key>(a_name)) };
+            return found == m_names.end() ? nullptr : &m_boxes[found->second];
+        }
+
+
+        /// Return the boxes of a class.
+        /// @param	a_patcher	The patcher.
+        /// @param	a_classname	The name of the class of the boxes, e.g. "newobj" or "message".
+        /// @return				The boxes, in the order of the patcher.
+
+        const min::boxes& of_class(max::t_object* a_patcher, const symbol a_classname) {
+            update(a_patcher);
+            const auto found { m_classes.find(static_cast<key>(a_classname)) };
+            return found == m_classes.end() ? m_none : found->second;
+        }
+
+
+        /// Handle a notification received by the owner.
+        /// The index is dropped if the patcher has changed, a box has been freed, or the scripting name of a box has changed.
+        /// @param	args	The arguments of the owner's "notify" message.
+        /// @return			True if the index was dropped, e.g. for the owner to drop what it has looked up in it.
+
+        bool notify(const atoms& args) {
+            const notification n { args };
+            if (!m_patcher)
+                return false;
+
+            if (n.source() == m_patcher) {
+                clear();
+                return true;
+            }
+
+            auto b = std::find_if(m_boxes.begin(), m_boxes.end(), [&](const box& a_box) {
+                return static_cast<max::t_object*>(a_box) == n.source();
+            });
+            if (b == m_boxes.end())
+                return false;
+
+            if (n.name() == k_sym_free) {
+                m_boxes.erase(b);    // Max detaches from an object that is freed
+                clear();
+                return true;
+            }
+            if (n.name() == k_sym_attr_modified && symbol(static_cast<max::t_symbol*>(max::object_method(n.data(), k_sym_getname))) == k_sym_varname) {
+                clear();
+                return true;
+            }
+            return false;
+        }
+
+
+        /// Drop the index and detach from the patcher and its boxes.
+
+        void clear() {
+            if (m_patcher) {
+                for (auto& b : m_boxes)
+                    max::object_detach_byptr(m_listener, b);
+                max::object_detach_byptr(m_listener, m_patcher);
+            }
+            m_patcher = nullptr;
+            m_boxes.clear();
+            m_names.clear();
+            m_classes.clear();
+        }
+
+    private:
+        using key = const max::t_symbol*;    // symbols are interned, so hashing the pointer is enough
+
+        max::t_object*                                      m_listener;
+        max::t_object*                                      m_patcher { nullptr };
+        min::boxes                                          m_boxes;
+        std::unordered_map<key, size_t>                     m_names;      ///< index into m_boxes
+        std::unordered_map<key, min::boxes>                 m_classes;
+        const min::boxes                                    m_none;
+
+        void update(max::t_object* a_patcher) {
+            if (a_patcher == m_patcher)
+                return;
+            clear();
+            if (!a_patcher)
+                return;
+
+            m_patcher = a_patcher;
+            max::object_attach_byptr_register(m_listener, m_patcher, k_sym_nobox);
+
+            for (auto b = max::jpatcher_get_firstobject(m_patcher); b; b = max::jbox_get_nextobject(b)) {
+                m_boxes.push_back(b);
+                max::object_attach_byptr_register(m_listener, b, k_sym_nobox);
+            }
+
+            for (size_t i = 0; i < m_boxes.size(); ++i) {
+                const auto& b { m_boxes[i] };
+                const auto  name { b.name() };
+
+                if (name != k_sym__empty)
+                    m_names.emplace(static_cast<key>(name), i);    // scripting names are unique within a patcher
+                m_classes[static_cast<key>(b.classname())].push_back(b);
+            }
+        }
+    };
+
+
 }    // namespace c74::min
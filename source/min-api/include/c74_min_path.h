@@ -153,12 +153,15 @@ namespace c74::min {
         }
 
 
+        // the absolute path is resolved the first time it is needed and then cached, as the path can not change
         operator string() const {
-            char pathname[max::MAX_PATH_CHARS];
+            if (m_absolute.empty()) {
+                char pathname[max::MAX_PATH_CHARS];
 
-            max::path_toabsolutesystempath(m_path, m_filename, pathname);
-            std::string s = pathname;
-            return s;
+                max::path_toabsolutesystempath(m_path, m_filename, pathname);
+                m_absolute = pathname;
+            }
+            return m_absolute;
         }
 
 
@@ -187,6 +190,48 @@ namespace c74::min {
         using enumerate_function = std::function<void(string)>;
 
         void enumerate(const filetype a_type, const enumerate_function a_callback) {
+            enumerate_until(a_type, [&a_callback](const char* name) {
+                a_callback(name);
+                return true;
+            });
+        }
+
+
+        string name() const {
+            if (m_directory) {
+                const string pathname = *this;
+                return pathname.substr(pathname.rfind('/') + 1);
+            }
+            else
+                return m_filename;
+        }
+
+
+        /// Copy the file/folder represented by this path to a specified destination.
+        /// @param destination_folder The folder will be the folder containing the copy of this path
+
+        void copy(const path& destination_folder, const string& destination_name) {
+            short newpath{};
+            if (m_directory)
+                c74::max::path_copyfolder(m_path, destination_folder.m_path, (char*)destination_name.c_str(), true, &newpath);
+            else
+                c74::max::path_copyfile(m_path, m_filename, destination_folder.m_path, (char*)destination_name.c_str());
+        }
+
+    private:
+        short           m_path                     {};
+        char            m_filename[max::MAX_PATH_CHARS] {};
+        max::t_fourcc   m_type                     {};
+        bool            m_directory                {};
+        mutable string  m_absolute;                 ///< cache for operator string()
+
+        friend class directory_enumeration;
+
+
+        // call a function with the name of each file of a type in this folder until it returns false
+
+        template<class F>
+        void enumerate_until(const filetype a_type, F a_callback) {
             if (!m_directory)
                 return;
             if (!m_path)
@@ -217,42 +262,93 @@ namespace c74::min {
                         }
                     }
                 }
-                if (match) {
-                    a_callback(name);
-                }
+                if (match && !a_callback(name))
+                    break;
             }
             max::path_closefolder(fold);
         }
+    };
 
 
-        string name() const {
-            if (m_directory) {
-                char pathname[max::MAX_PATH_CHARS];
-                max::path_toabsolutesystempath(m_path, m_filename, pathname);
-                char* last = strrchr(pathname, '/') + 1;
-                return last;
-            }
-            else
-                return m_filename;
-        }
+    /// Lists the files of a folder on a worker thread, so that a large folder (e.g. a sample library) does not stall the main thread.
+    /// The names are delivered in batches to a function called in the main thread, the last time with `finished` set.
+    /// Destroying the enumeration cancels it: the worker thread stops and no more batches are delivered.
+    ///
+    /// @code
+    /// unique_ptr<directory_enumeration> m_listing;
+    ///
+    /// m_listing = std::make_unique<directory_enumeration>(folder, path::filetype::audio, [this](const vector<string>& names, bool finished) {
+    ///     for (const auto& name : names)
+    ///         m_files.push_back(name);
+    /// });
+    /// @endcode
+
+    class directory_enumeration {
+    public:
+        /// The function that receives the names in the main thread.
+        /// @param	names		The next batch of file names, which may be empty when finished.
+        /// @param	finished	True for the last batch.
 
+        using batch_function = std::function<void(const vector<string>& names, bool finished)>;
 
-        /// Copy the file/folder represented by this path to a specified destination.
-        /// @param destination_folder The folder will be the folder containing the copy of this path
 
-        void copy(const path& destination_folder, const string& destination_name) {
-            short newpath{};
-            if (m_directory)
-                c74::max::path_copyfolder(m_path, destination_folder.m_path, (char*)destination_name.c_str(), true, &newpath);
-            else
-                c74::max::path_copyfile(m_path, m_filename, destination_folder.m_path, (char*)destination_name.c_str());
+        /// Start listing the files of a folder.
+        /// @param	folder		The folder.
+        /// @param	type		The type of the files to list.
+        /// @param	a_function	The function called in the main thread with each batch of names.
+        /// @param	batch_size	The number of names in each batch.
+
+        directory_enumeration(const path& folder, const path::filetype type, const batch_function& a_function, const size_t batch_size = 64)
+        : m_function { a_function }
+        , m_batches { nullptr, [this](const batch& b) { m_function(b.names, b.finished); }, 16 }
+        , m_thread { &directory_enumeration::run, this, folder, type, batch_size }
+        {}
+
+
+        ~directory_enumeration() {
+            m_cancelled = true;
+            m_thread.join();
         }
 
+
+        directory_enumeration(const directory_enumeration&) = delete;
+        directory_enumeration& operator=(const directory_enumeration&) = delete;
+
     private:
-        short         m_path                     {};
-        char          m_filename[max::MAX_PATH_CHARS] {};
-        max::t_fourcc m_type                     {};
-        bool          m_directory                {};
+        struct batch {
+            vector<string>  names;
+            bool            finished {};
+        };
+
+        const batch_function    m_function;
+        data_queue<batch>       m_batches;
+        std::atomic<bool>       m_cancelled { false };
+        std::thread             m_thread;
+
+
+        void run(path folder, const path::filetype type, const size_t batch_size) {
+            batch b;
+
+            b.names.reserve(batch_size);
+            folder.enumerate_until(type, [&](const char* name) {
+                b.names.emplace_back(name);
+                if (b.names.size() == batch_size) {
+                    send(b);
+                    b.names.clear();
+                }
+                return !m_cancelled.load();
+            });
+            b.finished = true;
+            send(b);
+        }
+
+
+        // wait for the main thread rather than dropping names when it falls behind
+
+        void send(const batch& b) {
+            while (!m_batches.push(b) && !m_cancelled)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
     };
 
 }    // namespace c74::min
@@ -0,0 +1,207 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// Interpolation between presets of the numeric attributes of an object, e.g. to morph from one sound to another.
+    ///
+    /// A preset is a compact array of the values of the attributes, in the order of the morph.
+    /// Applying an interpolated preset assigns the values directly, without converting them to atoms and without calling the setters,
+    /// so that morphing at a high control rate costs little more than the interpolation itself.
+    /// The setters are called, and Max is notified (e.g. to update the inspector), at a throttled rate instead,
+    /// and once more when the morph is flushed, so that the side effects of the setters catch up with the values.
+    /// Attributes declared with allow_repetitions::no skip their setters then, as the value is already assigned.
+    ///
+    /// At audio rate the perform routine reads the interpolated values with value() or interpolate() instead,
+    /// which never allocate or lock.
+    ///
+    /// Numeric attributes are those of type number, float, int or bool without a custom getter. Readonly attributes are skipped.
+
+    class preset_morph {
+    public:
+        /// The values of the attributes, in the order of the morph.
+
+        using preset = std::vector<double>;
+
+
+        /// Create a morph.
+        /// Declare it after the attributes it morphs, as they must be constructed first.
+        /// @param	an_owner	The object whose attributes are morphed, typically 'this'.
+        /// @param	names		The names of the attributes to morph, in that order. If empty all numeric attributes are morphed.
+
+        explicit preset_morph(object_base* an_owner, const std::vector<symbol>& names = {})
+        : m_owner { *an_owner } {
+            if (names.empty()) {
+                for (const auto& a : m_owner.attributes()) {
+                    if (a.second->numeric() && a.second->writable())
+                        m_attributes.push_back(a.second);
+                }
+            }
+            else {
+                for (const auto& name : names) {
+                    auto found = m_owner.attributes().find(name);
+                    if (found == m_owner.attributes().end() || !found->second->numeric())
+                        error("preset_morph: " + std::string(name) + " is not a numeric attribute");
+                    m_attributes.push_back(found->second);
+                }
+            }
+            m_current.resize(m_attributes.size());
+            m_endpoints.write({ capture(), capture() });
+        }
+
+        preset_morph(const preset_morph&) = delete;
+        preset_morph& operator=(const preset_morph&) = delete;
+
+
+        /// The number of attributes morphed.
+        /// @return	The number of values in a preset.
+
+        size_t size() const {
+            return m_attributes.size();
+        }
+
+
+        /// The position of an attribute in a preset.
+        /// @param	name	The name of the attribute.
+        /// @return			The index, or size() if the attribute is not morphed.
+
+        size_t index(const symbol name) const {
+            for (auto i = 0u; i < m_attributes.size(); ++i) {
+                if (m_attributes[i]->name() == name)
+                    return i;
+            }
+            return size();
+        }
+
+
+        /// Capture the current values of the attributes.
+        /// @return	The preset.
+
+        preset capture() const {
+            preset p(m_attributes.size());
+
+            for (auto i = 0u; i < m_attributes.size(); ++i)
+                p[i] = m_attributes[i]->numeric_value();
+            return p;
+        }
+
+
+        /// Set the attributes to a preset at once, calling their setters.
+        /// @param	p	The preset.
+
+        void recall(const preset& p) {
+            check(p);
+            for (auto i = 0u; i < m_attributes.size(); ++i) {
+                m_attributes[i]->assign_numeric(p[i]);
+                m_current[i] = p[i];
+            }
+            flush();
+        }
+
+
+        /// Set the presets to interpolate between. Call this from the main thread.
+        /// @param	from	The preset at position 0.
+        /// @param	to		The preset at position 1.
+
+        void morph(const preset& from, const preset& to) {
+            check(from);
+            check(to);
+            m_endpoints.write({ from, to });
+        }
+
+
+        /// Interpolate between the presets and assign the values to the attributes, at control rate.
+        /// Call this from the main or the scheduler thread.
+        /// The setters are called if the setter interval has passed since they were called last.
+        /// @param	position	The position between the presets, from 0 to 1.
+
+        void apply(const double position) {
+            interpolate(position, m_current.data());
+            for (auto i = 0u; i < m_attributes.size(); ++i)
+                m_attributes[i]->assign_numeric(m_current[i]);
+
+            m_setters_pending = true;
+            if (clock::now() - m_setters_called >= m_setter_interval)
+                flush();
+        }
+
+
+        /// Call the setters of the attributes with their current values and notify Max, if a value was applied since they were called last.
+
+        void flush() {
+            if (!m_setters_pending)
+                return;
+            m_setters_pending = false;
+            m_setters_called  = clock::now();
+
+            attribute_batch batch { m_owner };
+
+            for (auto a : m_attributes)
+                a->set(static_cast<atoms>(*a));
+        }
+
+
+        /// Change the minimum time between two calls of the setters by apply().
+        /// @param	milliseconds	The interval. Zero calls the setters for each call of apply().
+
+        void setter_interval(const double milliseconds) {
+            m_setter_interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::milli>(std::max(milliseconds, 0.0)));
+        }
+
+
+        /// Interpolate the value of one attribute, at audio rate. Wait-free.
+        /// @param	index		The index of the attribute, see index().
+        /// @param	position	The position between the presets, from 0 to 1.
+        /// @return				The value, which is not rounded for integer attributes.
+
+        double value(const size_t index, const double position) const {
+            const auto e { m_endpoints.read() };
+            const auto t { std::clamp(position, 0.0, 1.0) };
+
+            return e->from[index] + (e->to[index] - e->from[index]) * t;
+        }
+
+
+        /// Interpolate the values of all attributes, at audio rate. Wait-free.
+        /// @param	position	The position between the presets, from 0 to 1.
+        /// @param	values		Filled with size() values, which are not rounded for integer attributes.
+
+        void interpolate(const double position, double* values) const {
+            const auto e    { m_endpoints.read() };
+            const auto t    { std::clamp(position, 0.0, 1.0) };
+            const auto from { e->from.data() };
+            const auto to   { e->to.data() };
+
+            for (auto i = 0u; i < m_attributes.size(); ++i)
+                values[i] = from[i] + (to[i] - from[i]) * t;
+        }
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct endpoints {
+            preset  from;
+            preset  to;
+        };
+
+        object_base&                    m_owner;
+        std::vector<attribute_base*>    m_attributes;
+        attribute_snapshot<endpoints>   m_endpoints;
+        preset                          m_current;                                  // the values assigned by apply()
+        clock::duration                 m_setter_interval { std::chrono::milliseconds(50) };
+        clock::time_point               m_setters_called {};
+        bool                            m_setters_pending { false };
+
+        void check(const preset& p) const {
+            if (p.size() != m_attributes.size())
+                error("preset_morph: the preset has " + std::to_string(p.size()) + " values instead of " + std::to_string(m_attributes.size()));
+        }
+    };
+
+
+}    // namespace c74::min
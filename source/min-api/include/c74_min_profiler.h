@@ -0,0 +1,235 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// The time that the audio processing of one object takes, measured around every call of its perform routine.
+    /// Each audio object has a profile, which only measures while profiling is enabled, e.g. by the min.profile object.
+    /// When it is disabled the cost is one relaxed atomic load per vector.
+    ///
+    /// The times are counted in a histogram whose buckets grow exponentially, with four buckets per power of two,
+    /// so a percentile is accurate to about 20% without storing the individual times.
+    /// Only the audio thread writes the counters, so it does so without read-modify-write instructions;
+    /// any thread may read them while the audio is running, and gets a slightly inconsistent snapshot at worst.
+
+    class perform_profile {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        static constexpr int k_bucket_count { 128 };
+
+
+        /// A summary of a profile.
+
+        struct summary {
+            uint64_t    count {};           ///< The number of vectors measured.
+            double      mean {};            ///< The mean time per vector in microseconds.
+            double      p99 {};             ///< The time in microseconds that 99% of the vectors took less than.
+            double      maximum {};         ///< The longest time in microseconds.
+            uint64_t    thread_hops {};     ///< The number of vectors that were processed on a different thread than the one before.
+        };
+
+
+        /// Turn the measurements of all audio objects on or off.
+        /// @param	enable	True to measure.
+
+        static void enabled(const bool enable);
+
+
+        /// Determine if the audio objects are measured.
+        /// @return	True if profiling is enabled.
+
+        static bool enabled();
+
+
+        /// Call a function with every profile of all min-based externals, e.g. to report them.
+        /// Profiles are neither added nor removed while the function runs.
+        /// @param	f	A function that takes a perform_profile&.
+
+        template<class F>
+        static void for_each(F&& f);
+
+
+        /// Return the current time of the clock used for the measurements.
+
+        static clock::time_point now() {
+            return clock::now();
+        }
+
+
+        /// Return the object that is profiled.
+
+        max::t_object* owner() const {
+            return m_owner;
+        }
+
+
+        /// Record the time of one call of the perform routine. Called on the audio thread.
+        /// @param	duration	The time the call took.
+
+        void record(const clock::duration duration) {
+            if (m_reset_requested.load(std::memory_order_acquire)) {
+                for (auto& b : m_buckets)
+                    b.store(0, std::memory_order_relaxed);
+                m_count.store(0, std::memory_order_relaxed);
+                m_total.store(0, std::memory_order_relaxed);
+                m_maximum.store(0, std::memory_order_relaxed);
+                m_thread_hops.store(0, std::memory_order_relaxed);
+                m_reset_requested.store(false, std::memory_order_release);
+            }
+
+            const auto ns { static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0)) };
+            auto&      bucket { m_buckets[bucket_index(ns)] };
+
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            m_total.store(m_total.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+            if (ns > m_maximum.load(std::memory_order_relaxed))
+                m_maximum.store(ns, std::memory_order_relaxed);
+
+            const auto thread { std::hash<std::thread::id>()(std::this_thread::get_id()) };
+            if (thread != m_thread) {
+                if (m_thread != 0)
+                    m_thread_hops.store(m_thread_hops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                m_thread = thread;
+            }
+        }
+
+
+        /// Clear the measurements. They are cleared by the audio thread before it records the next time.
+
+        void reset() {
+            m_reset_requested.store(true, std::memory_order_release);
+        }
+
+
+        /// Summarize the measurements so far.
+        /// @return	The summary.
+
+        summary summarize() const {
+            summary s;
+
+            s.count       = m_count.load(std::memory_order_relaxed);
+            s.maximum     = m_maximum.load(std::memory_order_relaxed) * 0.001;
+            s.thread_hops = m_thread_hops.load(std::memory_order_relaxed);
+            if (s.count == 0)
+                return s;
+            s.mean = m_total.load(std::memory_order_relaxed) * 0.001 / s.count;
+
+            // the bucket that contains the 99th percentile, counted from the top, reported by its upper bound
+            const auto above { s.count / 100 };
+            uint64_t   counted {};
+            for (auto i = k_bucket_count - 1; i >= 0; --i) {
+                counted += m_buckets[i].load(std::memory_order_relaxed);
+                if (counted > above) {
+                    s.p99 = std::min(bucket_limit(i) * 0.001, s.maximum);
+                    break;
+                }
+            }
+            return s;
+        }
+
+
+        /// Register the profile of an audio object, so that it is reported. Called on the main thread.
+        /// @param	an_owner	The audio object.
+
+        void attach(max::t_object* an_owner) {
+            m_owner = an_owner;
+            auto& r { registry() };
+            lock  l { r.access };
+            r.profiles.push_back(this);
+        }
+
+
+        /// Unregister the profile before the audio object is freed. Called on the main thread.
+
+        void detach() {
+            if (!m_owner)
+                return;
+            auto& r { registry() };
+            lock  l { r.access };
+            r.profiles.erase(std::remove(r.profiles.begin(), r.profiles.end(), this), r.profiles.end());
+            m_owner = nullptr;
+        }
+
+    private:
+        // The profiles of all min-based externals are listed in one registry, which is shared through the s_thing of a symbol.
+        // important! If you make significant changes to the registry or to this class,
+        // change the name of the symbol to avoid conflicts with externals that use an older version of min-api.
+
+        struct profile_registry {
+            mutex                       access;
+            vector<perform_profile*>    profiles;
+            std::atomic<bool>           enabled { false };
+        };
+
+        static profile_registry& registry() {
+            static profile_registry* s_registry {};
+
+            if (!s_registry) {
+                auto s = max::gensym("__min_perform_profile_registry_1__");
+                if (!s->s_thing)
+                    s->s_thing = reinterpret_cast<max::t_object*>(new profile_registry);
+                s_registry = reinterpret_cast<profile_registry*>(s->s_thing);
+            }
+            return *s_registry;
+        }
+
+        // bucket 4 * e + m holds the times with the highest bit e (counted from 1) and the next two bits m
+
+        static int bucket_index(const uint64_t ns) {
+            if (ns < 4)
+                return static_cast<int>(ns);
+
+            int e {};
+            for (auto v = ns; v > 3; v >>= 1)
+                ++e;
+            const auto m { static_cast<int>((ns >> (e - 1)) & 3) };
+            return std::min(4 * e + m, k_bucket_count - 1);
+        }
+
+        static double bucket_limit(const int index) {
+            if (index < 4)
+                return index + 1;
+
+            const auto e { index / 4 };
+            const auto m { index % 4 };
+            return std::ldexp(4.0 + m + 1.0, e - 1);
+        }
+
+        max::t_object*                                      m_owner { nullptr };
+        std::array<std::atomic<uint64_t>, k_bucket_count>   m_buckets {};
+        std::atomic<uint64_t>                               m_count { 0 };
+        std::atomic<uint64_t>                               m_total { 0 };      ///< nanoseconds
+        std::atomic<uint64_t>                               m_maximum { 0 };    ///< nanoseconds
+        std::atomic<uint64_t>                               m_thread_hops { 0 };
+        std::atomic<bool>                                   m_reset_requested { false };
+        size_t                                              m_thread {};        ///< audio thread only
+    };
+
+
+    inline void perform_profile::enabled(const bool enable) {
+        registry().enabled.store(enable, std::memory_order_relaxed);
+    }
+
+
+    inline bool perform_profile::enabled() {
+        return registry().enabled.load(std::memory_order_relaxed);
+    }
+
+
+    template<class F>
+    void perform_profile::for_each(F&& f) {
+        auto& r { registry() };
+        lock  l { r.access };
+        for (const auto p : r.profiles)
+            f(*p);
+    }
+
+
+}    // namespace c74::min
@@ -91,4 +91,150 @@ namespace c74::min {
     };
 
 
+    /// How a data_queue treats values that are pushed before the previous ones have been delivered.
+
+    enum class queue_coalescing {
+        none,      ///< Every value is delivered, in the order pushed. Values pushed while the queue is full are dropped and counted.
+        latest     ///< Only the latest value is delivered. Values that are replaced before they are delivered are not counted as dropped.
+    };
+
+
+    /// A queue that carries values from one thread (e.g. the audio thread) to a function called in Max's main (low-priority) thread.
+    /// Pushing a value neither allocates memory nor takes a lock, so it is safe in the audio thread.
+    ///
+    /// Without coalescing the values are passed through a single-producer single-consumer fifo with a fixed capacity.
+    /// With queue_coalescing::latest they are passed through a triple buffer, so the producer always has a slot to write to
+    /// and the main thread receives the most recent value, e.g. for a meter or a display.
+    ///
+    /// Only one thread may push values at a time.
+    ///
+    /// @tparam	T			The type of the values, which must be default constructible and copyable.
+    /// @tparam	coalescing	How values that are pushed before the previous ones have been delivered are treated.
+    /// @seealso			#queue
+    /// @seealso			#fifo
+
+    template<class T, queue_coalescing coalescing = queue_coalescing::none>
+    class data_queue {
+    public:
+        /// The function that receives the values in the main thread.
+
+        using function_type = std::function<void(const T&)>;
+
+
+        /// Create a data queue.
+        /// @param	an_owner	The owning object for the queue. Typically you will pass `this`.
+        /// @param	a_function	A function to be executed in the main thread for every value delivered.
+        /// @param	capacity	The number of values that can wait for delivery. Not used with queue_coalescing::latest.
+
+        data_queue(object_base* an_owner, const function_type& a_function, const size_t capacity = 64)
+        : m_function { a_function }
+        , m_fifo { coalescing == queue_coalescing::none ? capacity : 1 } {
+            m_instance = max::qelem_new(this, reinterpret_cast<max::method>(qelem_callback));
+        }
+
+
+        ~data_queue() {
+            max::qelem_free(m_instance);
+        }
+
+
+        // Data queues cannot be copied.
+        // If they are then the ownership of the internal t_qelem becomes ambiguous.
+
+        data_queue(const data_queue&) = delete;
+        data_queue& operator=(const data_queue& value) = delete;
+
+
+        /// Push a value for delivery in the main thread.
+        /// @param	value	The value.
+        /// @return			False if the value was dropped because the queue is full, otherwise true.
+
+        bool push(const T& value) {
+            if constexpr (coalescing == queue_coalescing::latest) {
+                m_slots[m_back] = { value, queue_health::now() };
+                m_back = m_middle.exchange(m_back | k_fresh, std::memory_order_acq_rel) & k_index;
+                m_health.record_depth(1);
+            }
+            else {
+                if (!m_fifo.try_enqueue({ value, queue_health::now() })) {
+                    m_health.record_overflow();
+                    return false;
+                }
+                m_health.record_depth(m_fifo.size_approx());
+            }
+            max::qelem_set(m_instance);
+            return true;
+        }
+
+
+        /// Deliver the values that are waiting now, rather than when Max next services the queue.
+        /// Must be called in the main thread.
+
+        void deliver() {
+            if constexpr (coalescing == queue_coalescing::latest) {
+                if (m_middle.load(std::memory_order_relaxed) & k_fresh) {
+                    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & k_index;
+                    m_health.record_latency(m_slots[m_front].pushed, queue_health::now());
+                    m_function(m_slots[m_front].value);
+                }
+            }
+            else {
+                const auto now { queue_health::now() };
+
+                while (m_fifo.try_dequeue(m_delivered)) {
+                    m_health.record_latency(m_delivered.pushed, now);
+                    m_function(m_delivered.value);
+                }
+            }
+        }
+
+
+        /// The number of values dropped because the queue was full.
+        /// @return	The count since the queue was created.
+
+        size_t dropped() const {
+            return m_health.overflows();
+        }
+
+
+        /// The health of the queue: the most values waiting at once, the dropped values,
+        /// and the time from pushing a value to its delivery in the main thread.
+        /// @return	The counters, which may be summarized and cleared by any thread.
+
+        queue_health& health() {
+            return m_health;
+        }
+
+        const queue_health& health() const {
+            return m_health;
+        }
+
+    private:
+        struct stamped {
+            T       value {};
+            int64_t pushed {};    ///< queue_health::now() when the value was pushed
+        };
+
+        // The triple buffer: the producer writes to the back slot and swaps it with the middle one, marking it fresh,
+        // and the consumer swaps its front slot with the middle one when that is fresh.
+
+        static constexpr int k_index { 3 };
+        static constexpr int k_fresh { 4 };
+
+        const function_type m_function;
+        max::t_qelem*       m_instance { nullptr };
+        fifo<stamped>       m_fifo;
+        stamped             m_delivered {};           ///< only used by the consumer
+        queue_health        m_health;
+        stamped             m_slots[3] {};
+        int                 m_back { 0 };             ///< only used by the producer
+        std::atomic<int>    m_middle { 1 };
+        int                 m_front { 2 };            ///< only used by the consumer
+
+        static void qelem_callback(data_queue* self) {
+            self->deliver();
+        }
+    };
+
+
 }    // namespace c74::min
@@ -0,0 +1,214 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A histogram of durations whose buckets grow exponentially, with four buckets per power of two,
+    /// so a percentile is accurate to about 20% without storing the individual durations.
+    ///
+    /// Only one thread records, so it does so without read-modify-write instructions;
+    /// any thread may read while durations are recorded, and gets a slightly inconsistent snapshot at worst.
+    /// A clear requested by another thread is performed by the recording thread before it records the next duration.
+
+    class duration_histogram {
+    public:
+        static constexpr int k_bucket_count { 128 };
+
+
+        /// Record a duration. Called by the recording thread only.
+        /// @param	ns	The duration in nanoseconds.
+
+        void record(const uint64_t ns) {
+            if (m_clear_requested.load(std::memory_order_acquire)) {
+                for (auto& b : m_buckets)
+                    b.store(0, std::memory_order_relaxed);
+                m_count.store(0, std::memory_order_relaxed);
+                m_total.store(0, std::memory_order_relaxed);
+                m_maximum.store(0, std::memory_order_relaxed);
+                m_clear_requested.store(false, std::memory_order_release);
+            }
+
+            auto& bucket { m_buckets[bucket_index(ns)] };
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            m_total.store(m_total.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+            if (ns > m_maximum.load(std::memory_order_relaxed))
+                m_maximum.store(ns, std::memory_order_relaxed);
+        }
+
+
+        /// Request that the durations are cleared before the next one is recorded. Called by any thread.
+
+        void clear() {
+            m_clear_requested.store(true, std::memory_order_release);
+        }
+
+
+        /// @return	The number of durations recorded.
+
+        uint64_t count() const {
+            return m_count.load(std::memory_order_relaxed);
+        }
+
+
+        /// @return	The mean duration in nanoseconds, or zero if none was recorded.
+
+        double mean() const {
+            const auto n { count() };
+            return n ? static_cast<double>(m_total.load(std::memory_order_relaxed)) / n : 0.0;
+        }
+
+
+        /// @return	The longest duration in nanoseconds.
+
+        double maximum() const {
+            return static_cast<double>(m_maximum.load(std::memory_order_relaxed));
+        }
+
+
+        /// The duration that a fraction of the durations were shorter than, reported by the upper bound of its bucket.
+        /// @param	fraction	The fraction, e.g. 0.99 for the 99th percentile.
+        /// @return				The duration in nanoseconds, or zero if none was recorded.
+
+        double percentile(const double fraction) const {
+            const auto n { count() };
+            if (n == 0)
+                return 0.0;
+
+            // the bucket that contains the percentile, counted from the top
+            const auto above { static_cast<uint64_t>(n * (1.0 - fraction)) };
+            uint64_t   counted {};
+            for (auto i = k_bucket_count - 1; i >= 0; --i) {
+                counted += m_buckets[i].load(std::memory_order_relaxed);
+                if (counted > above)
+                    return std::min(bucket_limit(i), maximum());
+            }
+            return maximum();
+        }
+
+    private:
+        // bucket 4 * e + m holds the durations with the highest bit e (counted from 1) and the next two bits m
+
+        static int bucket_index(const uint64_t ns) {
+            if (ns < 4)
+                return static_cast<int>(ns);
+
+            int e {};
+            for (auto v = ns; v > 3; v >>= 1)
+                ++e;
+            const auto m { static_cast<int>((ns >> (e - 1)) & 3) };
+            return std::min(4 * e + m, k_bucket_count - 1);
+        }
+
+        static double bucket_limit(const int index) {
+            if (index < 4)
+                return index + 1;
+
+            const auto e { index / 4 };
+            const auto m { index % 4 };
+            return std::ldexp(4.0 + m + 1.0, e - 1);
+        }
+
+        std::array<std::atomic<uint64_t>, k_bucket_count>   m_buckets {};
+        std::atomic<uint64_t>                               m_count { 0 };
+        std::atomic<uint64_t>                               m_total { 0 };
+        std::atomic<uint64_t>                               m_maximum { 0 };
+        std::atomic<bool>                                   m_clear_requested { false };
+    };
+
+
+    /// Counters that show whether a queue between two threads is large enough and how long its values wait:
+    /// the largest number of values waiting at once, the number of values dropped because the queue was full,
+    /// and the distribution of the time from the push of a value to its delivery.
+    ///
+    /// The producer records the depth and the overflows, the consumer records the latencies.
+    /// Any thread may summarize them.
+
+    class queue_health {
+    public:
+        using clock = std::chrono::steady_clock;
+
+
+        /// A summary of the counters.
+
+        struct summary {
+            size_t  maximum_depth {};     ///< The largest number of values (or slots) in use at once.
+            size_t  overflows {};         ///< The number of values dropped because the queue was full.
+            double  latency_p50 {};       ///< The median time in milliseconds from the push of a value to its delivery.
+            double  latency_p99 {};       ///< The time in milliseconds that 99% of the values were delivered in.
+            double  latency_maximum {};   ///< The longest time in milliseconds from the push of a value to its delivery.
+        };
+
+
+        /// The time stamp to store with a pushed value, for record_latency().
+        /// @return	The current time in nanoseconds.
+
+        static int64_t now() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+        }
+
+
+        /// Record the number of values waiting after a push. Called by the producer.
+        /// @param	depth	The number of values or slots in use.
+
+        void record_depth(const size_t depth) {
+            if (depth > m_maximum_depth.load(std::memory_order_relaxed))
+                m_maximum_depth.store(depth, std::memory_order_relaxed);
+        }
+
+
+        /// Record values that were dropped. Called by the producer.
+        /// @param	count	The number of values.
+
+        void record_overflow(const size_t count = 1) {
+            m_overflows.fetch_add(count, std::memory_order_relaxed);
+        }
+
+
+        /// Record the delivery of a value. Called by the consumer.
+        /// @param	pushed		The time stamp from now() when the value was pushed.
+        /// @param	delivered	The time stamp from now() when the value was delivered.
+
+        void record_latency(const int64_t pushed, const int64_t delivered) {
+            m_latency.record(static_cast<uint64_t>(std::max<int64_t>(delivered - pushed, 0)));
+        }
+
+
+        /// @return	The number of values dropped because the queue was full.
+
+        size_t overflows() const {
+            return m_overflows.load(std::memory_order_relaxed);
+        }
+
+
+        /// Summarize the counters.
+        /// @return	The summary.
+
+        summary summarize() const {
+            return { m_maximum_depth.load(std::memory_order_relaxed), overflows(), m_latency.percentile(0.5) * 1e-6,
+                m_latency.percentile(0.99) * 1e-6, m_latency.maximum() * 1e-6 };
+        }
+
+
+        /// Clear the counters, e.g. when the audio is turned on.
+        /// The depth and overflows are cleared at once, the latencies before the next one is recorded.
+
+        void clear() {
+            m_maximum_depth.store(0, std::memory_order_relaxed);
+            m_overflows.store(0, std::memory_order_relaxed);
+            m_latency.clear();
+        }
+
+    private:
+        std::atomic<size_t> m_maximum_depth { 0 };
+        std::atomic<size_t> m_overflows { 0 };
+        duration_histogram  m_latency;
+    };
+
+
+}    // namespace c74::min
@@ -0,0 +1,189 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#ifdef C74_MIN_REALTIME_CHECKS
+    #ifdef WIN_VERSION
+        #include <windows.h>
+    #else
+        #include <execinfo.h>
+    #endif
+#endif
+
+namespace c74::min {
+
+
+    /// What a perform routine did that it should not do on the audio thread, counted during one call.
+
+    struct realtime_violations {
+        static constexpr int k_frame_count { 8 };
+
+        uint32_t    heap {};                    ///< Calls of operator new or delete.
+        uint32_t    locks {};                   ///< Blocking acquisitions of a min::mutex.
+        uint32_t    blocking_calls {};          ///< Calls of functions that were declared blocking with realtime_check::blocking().
+        const char* first {};                   ///< What the first violation was.
+        void*       frames[k_frame_count] {};   ///< The innermost return addresses of the first violation.
+        int         frame_count {};
+
+
+        /// Determine if there was a violation.
+        /// @return	True if anything was counted.
+
+        bool any() const {
+            return heap || locks || blocking_calls;
+        }
+
+
+        /// Clear the counts for the next call.
+
+        void clear() {
+            heap = locks = blocking_calls = 0;
+            first       = nullptr;
+            frame_count = 0;
+        }
+    };
+
+
+    /// Instrumentation that detects heap allocations, locking and other blocking calls in perform routines.
+    ///
+    /// It is compiled in when C74_MIN_REALTIME_CHECKS is defined, e.g. with
+    /// `target_compile_definitions(${PROJECT_NAME} PRIVATE C74_MIN_REALTIME_CHECKS)` in a debug build of an external.
+    /// The wrapper of each audio object then counts the violations during each call of its perform routine
+    /// and reports them with the address of the first one to the Max window, through the async logger.
+    /// The return addresses can be resolved to functions with atos (macOS), addr2line or a debugger.
+    ///
+    /// Without the definition all of this compiles to nothing.
+    ///
+    /// Heap operations are detected by replacing the global operator new and delete (not the forms with an alignment),
+    /// locking by min::mutex, and blocking calls by the functions that call realtime_check::blocking(),
+    /// which min-api does for synchronous logger output. Any function of an external may do the same.
+
+    class realtime_check {
+    public:
+
+#ifdef C74_MIN_REALTIME_CHECKS
+        static constexpr bool enabled { true };
+#else
+        static constexpr bool enabled { false };
+#endif
+
+
+        /// Count the violations of the calling thread while the scope exists, e.g. during a call of a perform routine.
+
+        class scope {
+        public:
+            explicit scope(realtime_violations& violations)
+            : m_previous { current() } {
+                current() = &violations;
+            }
+
+            ~scope() {
+                current() = m_previous;
+            }
+
+            scope(const scope&) = delete;
+            scope& operator=(const scope&) = delete;
+
+        private:
+            realtime_violations* m_previous;
+        };
+
+
+        /// Allow what a scope would count for the lifetime of this object, e.g. around a deliberate allocation.
+
+        class allow {
+        public:
+            allow()
+            : m_previous { current() } {
+                current() = nullptr;
+            }
+
+            ~allow() {
+                current() = m_previous;
+            }
+
+            allow(const allow&) = delete;
+            allow& operator=(const allow&) = delete;
+
+        private:
+            realtime_violations* m_previous;
+        };
+
+
+        /// Capture a stack trace once on the main thread, as the first capture may allocate while loading the unwinder.
+
+        static void prepare() {
+            if constexpr (enabled) {
+                void* frames[2];
+                capture(frames, 2);
+            }
+        }
+
+
+        /// Called by operator new and delete.
+
+        static void heap() {
+            if (auto v = current())
+                record(*v, v->heap, "heap allocation");
+        }
+
+
+        /// Called by min::mutex when it waits for the lock.
+
+        static void locked() {
+            if (auto v = current())
+                record(*v, v->locks, "lock");
+        }
+
+
+        /// Declare that the calling function may block, e.g. because it performs file i/o or waits for another thread.
+        /// @param	what	A description for the report, which must be a string literal.
+
+        static void blocking(const char* what) {
+            if constexpr (enabled) {
+                if (auto v = current())
+                    record(*v, v->blocking_calls, what);
+            }
+        }
+
+    private:
+        static realtime_violations*& current() {
+            thread_local realtime_violations* t_current { nullptr };
+            return t_current;
+        }
+
+
+        static int capture(void** frames, const int count) {
+#if defined(C74_MIN_REALTIME_CHECKS) && defined(WIN_VERSION)
+            return static_cast<int>(CaptureStackBackTrace(0, static_cast<DWORD>(count), frames, nullptr));
+#elif defined(C74_MIN_REALTIME_CHECKS)
+            return backtrace(frames, count);
+#else
+            (void)frames;
+            (void)count;
+            return 0;
+#endif
+        }
+
+
+        static void record(realtime_violations& v, uint32_t& counter, const char* what) {
+            ++counter;
+            if (v.first)
+                return;
+
+            // skip the frames of this class and of the hook that called it
+            constexpr int k_skipped { 3 };
+            void*         frames[realtime_violations::k_frame_count + k_skipped];
+            allow         capturing;
+
+            v.first       = what;
+            v.frame_count = std::max(capture(frames, realtime_violations::k_frame_count + k_skipped) - k_skipped, 0);
+            std::copy_n(frames + k_skipped, v.frame_count, v.frames);
+        }
+    };
+
+
+}    // namespace c74::min
@@ -0,0 +1,155 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// Per-frame minimum, maximum, argmin and argmax across the channels of an audio_bundle.
+    ///
+    /// Channels are accumulated one at a time, walking each channel's vector contiguously
+    /// and updating running per-frame results. The inner loop is free of branches so that compilers can vectorize it.
+    /// This scales much better to wide multi-channel signals than comparing all channels for each frame in turn.
+    ///
+    /// Channel numbers are stored as samples so that they can be written directly to signal outputs.
+    /// In case of a tie the lowest channel number wins.
+    ///
+    /// @tparam	T	The type of the audio samples.
+
+    template<typename T = sample>
+    class channel_extrema {
+    public:
+
+        /// Allocate storage for a vector size.
+        /// Call this outside of the perform routine (e.g. in a 'dspsetup' message) to avoid allocation on the audio thread.
+        /// @param	frame_count		The maximum number of frames per vector.
+
+        void resize(const long frame_count) {
+            const auto size { static_cast<size_t>(frame_count) };
+
+            m_low.resize(size);
+            m_high.resize(size);
+            m_low_channel.resize(size);
+            m_high_channel.resize(size);
+        }
+
+
+        /// Prepare to reduce a new vector of audio.
+        /// @param	frame_count		The number of frames in the vector.
+        ///							The storage is grown if it is too small.
+
+        void reset(const long frame_count) {
+            if (static_cast<size_t>(frame_count) > m_low.size())
+                resize(frame_count);
+
+            m_frame_count = frame_count;
+            std::fill_n(m_low.begin(), frame_count, std::numeric_limits<T>::max());
+            std::fill_n(m_high.begin(), frame_count, -std::numeric_limits<T>::max());
+            std::fill_n(m_low_channel.begin(), frame_count, T(-1));
+            std::fill_n(m_high_channel.begin(), frame_count, T(-1));
+        }
+
+
+        /// Accumulate a range of channels into the results.
+        /// Channels must be accumulated in ascending order for ties to resolve to the lowest channel.
+        /// @param	input	The audio to reduce.
+        ///					Its frame count must match the one passed to reset().
+        /// @param	first	The first channel to accumulate.
+        /// @param	end		One past the last channel to accumulate.
+
+        void accumulate(basic_audio_bundle<T>& input, const long first, const long end) {
+            assert(input.frame_count() == m_frame_count);
+
+            auto low            { m_low.data() };
+            auto high           { m_high.data() };
+            auto low_channel    { m_low_channel.data() };
+            auto high_channel   { m_high_channel.data() };
+
+            for (auto channel = first; channel < end; ++channel) {
+                const auto in { input.samples(channel) };
+                const auto n { static_cast<T>(channel) };
+
+                for (auto i = 0; i < m_frame_count; ++i) {
+                    const auto x { in[i] };
+                    const bool is_lower { x < low[i] };
+                    const bool is_higher { x > high[i] };
+
+                    low[i]          = is_lower ? x : low[i];
+                    low_channel[i]  = is_lower ? n : low_channel[i];
+                    high[i]         = is_higher ? x : high[i];
+                    high_channel[i] = is_higher ? n : high_channel[i];
+                }
+            }
+        }
+
+
+        /// Merge the results of another reduction of the same vector into these results.
+        /// The other reduction must cover channels that come after the channels of this one.
+        /// @param	other	The results to merge.
+
+        void merge(const channel_extrema& other) {
+            assert(other.m_frame_count == m_frame_count);
+
+            for (auto i = 0; i < m_frame_count; ++i) {
+                const bool is_lower { other.m_low[i] < m_low[i] };
+                const bool is_higher { other.m_high[i] > m_high[i] };
+
+                m_low[i]          = is_lower ? other.m_low[i] : m_low[i];
+                m_low_channel[i]  = is_lower ? other.m_low_channel[i] : m_low_channel[i];
+                m_high[i]         = is_higher ? other.m_high[i] : m_high[i];
+                m_high_channel[i] = is_higher ? other.m_high_channel[i] : m_high_channel[i];
+            }
+        }
+
+
+        /// The lowest value among the channels for each frame.
+        /// @return	A pointer to frame_count() values.
+
+        const T* low() const {
+            return m_low.data();
+        }
+
+
+        /// The highest value among the channels for each frame.
+        /// @return	A pointer to frame_count() values.
+
+        const T* high() const {
+            return m_high.data();
+        }
+
+
+        /// The channel with the lowest value for each frame, or -1 if no channels were accumulated.
+        /// @return	A pointer to frame_count() values.
+
+        const T* low_channel() const {
+            return m_low_channel.data();
+        }
+
+
+        /// The channel with the highest value for each frame, or -1 if no channels were accumulated.
+        /// @return	A pointer to frame_count() values.
+
+        const T* high_channel() const {
+            return m_high_channel.data();
+        }
+
+
+        /// The number of frames in the current results.
+        /// @return	The number of frames passed to reset().
+
+        long frame_count() const {
+            return m_frame_count;
+        }
+
+    private:
+        vector<T>   m_low;
+        vector<T>   m_high;
+        vector<T>   m_low_channel;
+        vector<T>   m_high_channel;
+        long        m_frame_count {};
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,132 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A wait-free ring buffer for streaming blocks of items, e.g. audio samples, from one thread to another.
+    /// Exactly one thread may write (the producer) and exactly one thread may read (the consumer).
+    /// Unlike a fifo, which moves one item at a time, the ring buffer copies runs of items in at most two pieces.
+    ///
+    /// Positions count every item ever written or read, so they never wrap around.
+    /// A consumer can use the producer's write_position() to discard everything written before a given point,
+    /// e.g. prefetched audio that is no longer needed after seeking in a file.
+    ///
+    /// @tparam	T	The type of the items.
+
+    template<class T>
+    class ring_buffer {
+    public:
+
+        /// Create a ring buffer.
+        /// @param	minimum_capacity	The number of items the ring buffer must be able to hold.
+        ///								The capacity is rounded up to the next power of two.
+
+        explicit ring_buffer(const size_t minimum_capacity) {
+            size_t capacity { 1 };
+
+            while (capacity < minimum_capacity)
+                capacity <<= 1;
+            m_items.resize(capacity);
+            m_mask = capacity - 1;
+        }
+
+        ring_buffer(const ring_buffer& other) = delete;
+        ring_buffer& operator=(const ring_buffer& other) = delete;
+
+
+        /// The number of items the ring buffer can hold.
+
+        size_t capacity() const {
+            return m_items.size();
+        }
+
+
+        /// Producer only: the number of items that can currently be written.
+
+        size_t space() const {
+            return capacity() - static_cast<size_t>(m_write.load(std::memory_order_relaxed) - m_read.load(std::memory_order_acquire));
+        }
+
+
+        /// Producer only: write as many items as there is space for.
+        /// @param	items	The items to write.
+        /// @param	count	The number of items to write.
+        /// @return			The number of items written.
+
+        size_t write(const T* items, size_t count) {
+            const auto w { m_write.load(std::memory_order_relaxed) };
+            const auto r { m_read.load(std::memory_order_acquire) };
+
+            count = std::min(count, capacity() - static_cast<size_t>(w - r));
+
+            const auto start { static_cast<size_t>(w) & m_mask };
+            const auto first { std::min(count, capacity() - start) };
+
+            std::copy_n(items, first, m_items.begin() + start);
+            std::copy_n(items + first, count - first, m_items.begin());
+            m_write.store(w + count, std::memory_order_release);
+            return count;
+        }
+
+
+        /// The total number of items written so far.
+        /// @return	The position following the last item written.
+
+        uint64_t write_position() const {
+            return m_write.load(std::memory_order_acquire);
+        }
+
+
+        /// Consumer only: the number of items that can currently be read.
+
+        size_t available() const {
+            return static_cast<size_t>(m_write.load(std::memory_order_acquire) - m_read.load(std::memory_order_relaxed));
+        }
+
+
+        /// Consumer only: read as many items as are available.
+        /// @param	items	Storage for the items read.
+        /// @param	count	The number of items to read.
+        /// @return			The number of items read.
+
+        size_t read(T* items, size_t count) {
+            const auto r { m_read.load(std::memory_order_relaxed) };
+            const auto w { m_write.load(std::memory_order_acquire) };
+
+            count = std::min(count, static_cast<size_t>(w - r));
+
+            const auto start { static_cast<size_t>(r) & m_mask };
+            const auto first { std::min(count, capacity() - start) };
+
+            std::copy_n(m_items.begin() + start, first, items);
+            std::copy_n(m_items.begin(), count - first, items + first);
+            m_read.store(r + count, std::memory_order_release);
+            return count;
+        }
+
+
+        /// Consumer only: discard the items written before a position.
+        /// Nothing happens if the items before the position have already been read.
+        /// @param	position	A position previously returned by write_position().
+
+        void skip_to(const uint64_t position) {
+            if (position > m_read.load(std::memory_order_relaxed))
+                m_read.store(position, std::memory_order_release);
+        }
+
+    private:
+        vector<T>   m_items;
+        size_t      m_mask {};
+
+        // on separate cache lines so that the producer and consumer do not contend
+
+        alignas(64) std::atomic<uint64_t>   m_write { 0 };
+        alignas(64) std::atomic<uint64_t>   m_read { 0 };
+    };
+
+}    // namespace c74::min
@@ -0,0 +1,105 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// Determine if a vector of audio is silent, i.e. all of its samples are zero.
+    /// The loop has no branches, so that the compiler can vectorize it.
+    /// @param	samples	The samples.
+    /// @param	count	The number of samples.
+    /// @return			True if all samples are zero.
+
+    inline bool is_silent(const double* samples, const size_t count) {
+        bool sound { false };
+
+        for (size_t i = 0; i < count; ++i)
+            sound |= (samples[i] != 0.0);
+        return !sound;
+    }
+
+
+    /// Tracks how long the inputs of an audio object have been silent,
+    /// to skip its processing once its output has become silent as well.
+    ///
+    /// An audio object opts in by defining a member function `size_t silence_tail()`,
+    /// which returns the number of frames its output may still sound after its inputs have fallen silent,
+    /// e.g. the length of a delay line or the release of a limiter.
+    /// Return 0 if silent inputs produce silent outputs right away.
+    /// Once the inputs have been silent for longer than the tail, the wrapper outputs zeros
+    /// instead of calling the object, until any input sounds again.
+    ///
+    /// Processing resumes with the state the object had when it was skipped,
+    /// so the tail should be long enough for that state to have decayed (e.g. to -120 dB).
+    /// While processing is skipped smoothed attributes do not ramp, and nothing that the object does per vector happens.
+    ///
+    /// Vectors are only counted as silent as a whole, and an object without signal inputs is never skipped.
+
+    class silence_detector {
+    public:
+        /// Update the count with the next vector of input.
+        /// @param	channels		The input channels.
+        /// @param	channel_count	The number of input channels.
+        /// @param	frame_count		The number of frames in each channel.
+        /// @param	tail			The number of frames the output may still sound after the inputs fell silent.
+        /// @return					True if the tail has elapsed and the processing of this vector may be skipped.
+
+        bool skip(const double* const* channels, const long channel_count, const long frame_count, const size_t tail) {
+            auto silent { channel_count > 0 };
+
+            for (auto channel = 0; channel < channel_count && silent; ++channel)
+                silent = is_silent(channels[channel], static_cast<size_t>(frame_count));
+
+            if (!silent) {
+                m_silent_frames = 0;
+                return false;
+            }
+            if (m_silent_frames >= tail)
+                return true;
+            m_silent_frames += static_cast<size_t>(frame_count);    // stops counting once the tail has elapsed, so it cannot overflow
+            return false;
+        }
+
+
+        /// Start counting again, e.g. when the dsp chain is compiled.
+
+        void reset() {
+            m_silent_frames = 0;
+        }
+
+
+        /// The number of frames the inputs have been silent, up to the tail.
+        /// @return	The number of frames.
+
+        size_t silent_frames() const {
+            return m_silent_frames;
+        }
+
+    private:
+        size_t m_silent_frames {};
+    };
+
+
+    // SFINAE implementation used internally to determine if the Min class has a member named silence_tail (see silence_detector).
+
+    template<typename min_class_type>
+    struct has_silence_tail {
+        template<class, class>
+        class checker;
+
+        template<typename C>
+        static std::true_type test(checker<C, decltype(&C::silence_tail)>*);
+
+        template<typename C>
+        static std::false_type test(...);
+
+        typedef decltype(test<min_class_type>(nullptr)) type;
+        static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
+    };
+
+
+}    // namespace c74::min
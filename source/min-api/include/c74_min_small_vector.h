@@ -0,0 +1,449 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace c74::min {
+
+
+    /// A sequence container with the interface of std::vector that stores up to N elements inline.
+    /// Only when more than N elements are held is memory allocated on the heap.
+    /// This keeps short sequences (e.g. the typical message of one to four atoms) free of allocations.
+    ///
+    /// Iterators are plain pointers and follow the same invalidation rules as those of std::vector,
+    /// with the addition that moving or swapping a container invalidates the iterators of its inline elements.
+    ///
+    /// @tparam	T					The type of the elements.
+    /// @tparam	inline_capacity		The number of elements stored without allocating.
+
+    template<class T, size_t inline_capacity>
+    class small_vector {
+    public:
+        using value_type                = T;
+        using size_type                 = size_t;
+        using difference_type           = std::ptrdiff_t;
+        using reference                 = T&;
+        using const_reference           = const T&;
+        using pointer                   = T*;
+        using const_pointer             = const T*;
+        using iterator                  = T*;
+        using const_iterator            = const T*;
+        using reverse_iterator          = std::reverse_iterator<iterator>;
+        using const_reverse_iterator    = std::reverse_iterator<const_iterator>;
+
+
+        small_vector() noexcept {}
+
+        explicit small_vector(const size_type count) {
+            resize(count);
+        }
+
+        small_vector(const size_type count, const T& value) {
+            assign(count, value);
+        }
+
+        template<class input_iterator, typename = typename std::iterator_traits<input_iterator>::iterator_category>
+        small_vector(input_iterator first, input_iterator last) {
+            assign(first, last);
+        }
+
+        small_vector(std::initializer_list<T> init) {
+            assign(init.begin(), init.end());
+        }
+
+        small_vector(const small_vector& other) {
+            assign(other.begin(), other.end());
+        }
+
+        small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+            steal(std::move(other));
+        }
+
+        ~small_vector() {
+            clear();
+            release();
+        }
+
+
+        small_vector& operator=(const small_vector& other) {
+            if (this != &other)
+                assign(other.begin(), other.end());
+            return *this;
+        }
+
+        small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+            if (this != &other) {
+                clear();
+                release();
+                steal(std::move(other));
+            }
+            return *this;
+        }
+
+        small_vector& operator=(std::initializer_list<T> init) {
+            assign(init.begin(), init.end());
+            return *this;
+        }
+
+
+        void assign(const size_type count, const T& value) {
+            clear();
+            reserve(count);
+            std::uninitialized_fill_n(m_data, count, value);
+            m_size = count;
+        }
+
+        template<class input_iterator, typename = typename std::iterator_traits<input_iterator>::iterator_category>
+        void assign(input_iterator first, input_iterator last) {
+            clear();
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        void assign(std::initializer_list<T> init) {
+            assign(init.begin(), init.end());
+        }
+
+
+        // element access
+
+        reference at(const size_type pos) {
+            if (pos >= m_size)
+                throw std::out_of_range("small_vector::at");
+            return m_data[pos];
+        }
+
+        const_reference at(const size_type pos) const {
+            if (pos >= m_size)
+                throw std::out_of_range("small_vector::at");
+            return m_data[pos];
+        }
+
+        reference operator[](const size_type pos) {
+            return m_data[pos];
+        }
+
+        const_reference operator[](const size_type pos) const {
+            return m_data[pos];
+        }
+
+        reference front() {
+            return m_data[0];
+        }
+
+        const_reference front() const {
+            return m_data[0];
+        }
+
+        reference back() {
+            return m_data[m_size - 1];
+        }
+
+        const_reference back() const {
+            return m_data[m_size - 1];
+        }
+
+        T* data() noexcept {
+            return m_data;
+        }
+
+        const T* data() const noexcept {
+            return m_data;
+        }
+
+
+        // iterators
+
+        iterator begin() noexcept {
+            return m_data;
+        }
+
+        const_iterator begin() const noexcept {
+            return m_data;
+        }
+
+        const_iterator cbegin() const noexcept {
+            return m_data;
+        }
+
+        iterator end() noexcept {
+            return m_data + m_size;
+        }
+
+        const_iterator end() const noexcept {
+            return m_data + m_size;
+        }
+
+        const_iterator cend() const noexcept {
+            return m_data + m_size;
+        }
+
+        reverse_iterator rbegin() noexcept {
+            return reverse_iterator(end());
+        }
+
+        const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        reverse_iterator rend() noexcept {
+            return reverse_iterator(begin());
+        }
+
+        const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+
+        // capacity
+
+        bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        size_type size() const noexcept {
+            return m_size;
+        }
+
+        size_type max_size() const noexcept {
+            return std::numeric_limits<difference_type>::max() / sizeof(T);
+        }
+
+        size_type capacity() const noexcept {
+            return m_capacity;
+        }
+
+        /// Determine if the elements are currently stored inline (i.e. no memory is allocated).
+        /// @return	True if the elements are stored inline.
+
+        bool is_inline() const noexcept {
+            return m_data == inline_data();
+        }
+
+        void reserve(const size_type new_capacity) {
+            if (new_capacity > m_capacity)
+                reallocate(new_capacity);
+        }
+
+        void shrink_to_fit() {
+            if (is_inline() || m_size == m_capacity)
+                return;
+            if (m_size <= inline_capacity) {
+                T* heap { m_data };
+                std::uninitialized_move(heap, heap + m_size, inline_data());
+                std::destroy(heap, heap + m_size);
+                ::operator delete(heap);
+                m_data = inline_data();
+                m_capacity = inline_capacity;
+            }
+            else
+                reallocate(m_size);
+        }
+
+
+        // modifiers
+
+        void clear() noexcept {
+            std::destroy(m_data, m_data + m_size);
+            m_size = 0;
+        }
+
+        iterator insert(const_iterator pos, const T& value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value) {
+            return emplace(pos, std::move(value));
+        }
+
+        iterator insert(const_iterator pos, const size_type count, const T& value) {
+            const auto index { static_cast<size_type>(pos - m_data) };
+            const T    copy { value };    // the value may refer to an element of this container
+
+            for (auto i = 0u; i < count; ++i)
+                emplace(m_data + index + i, copy);
+            return m_data + index;
+        }
+
+        template<class input_iterator, typename = typename std::iterator_traits<input_iterator>::iterator_category>
+        iterator insert(const_iterator pos, input_iterator first, input_iterator last) {
+            const auto      index { static_cast<size_type>(pos - m_data) };
+            small_vector    items(first, last);    // the range may refer to elements of this container
+
+            reserve(m_size + items.size());
+            for (auto i = 0u; i < items.size(); ++i)
+                emplace(m_data + index + i, std::move(items[i]));
+            return m_data + index;
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> init) {
+            return insert(pos, init.begin(), init.end());
+        }
+
+        template<class... args_type>
+        iterator emplace(const_iterator pos, args_type&&... args) {
+            const auto index { static_cast<size_type>(pos - m_data) };
+
+            if (index == m_size) {
+                emplace_back(std::forward<args_type>(args)...);
+                return m_data + index;
+            }
+
+            T value(std::forward<args_type>(args)...);    // construct first: the arguments may refer to an element of this container
+
+            if (m_size == m_capacity)
+                reallocate(grown_capacity());
+
+            ::new (static_cast<void*>(m_data + m_size)) T(std::move(m_data[m_size - 1]));
+            std::move_backward(m_data + index, m_data + m_size - 1, m_data + m_size);
+            m_data[index] = std::move(value);
+            ++m_size;
+            return m_data + index;
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            const auto  index { first - m_data };
+            const auto  count { last - first };
+
+            if (count > 0) {
+                std::move(m_data + index + count, m_data + m_size, m_data + index);
+                std::destroy(m_data + m_size - count, m_data + m_size);
+                m_size -= static_cast<size_type>(count);
+            }
+            return m_data + index;
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        template<class... args_type>
+        reference emplace_back(args_type&&... args) {
+            if (m_size == m_capacity) {
+                T value(std::forward<args_type>(args)...);    // the arguments may refer to an element of this container
+                reallocate(grown_capacity());
+                ::new (static_cast<void*>(m_data + m_size)) T(std::move(value));
+            }
+            else
+                ::new (static_cast<void*>(m_data + m_size)) T(std::forward<args_type>(args)...);
+            return m_data[m_size++];
+        }
+
+        void pop_back() {
+            --m_size;
+            std::destroy_at(m_data + m_size);
+        }
+
+        void resize(const size_type count) {
+            if (count < m_size)
+                erase(m_data + count, m_data + m_size);
+            else {
+                reserve(count);
+                std::uninitialized_value_construct(m_data + m_size, m_data + count);
+                m_size = count;
+            }
+        }
+
+        void resize(const size_type count, const value_type& value) {
+            if (count < m_size)
+                erase(m_data + count, m_data + m_size);
+            else {
+                const T copy { value };
+                reserve(count);
+                std::uninitialized_fill(m_data + m_size, m_data + count, copy);
+                m_size = count;
+            }
+        }
+
+        void swap(small_vector& other) {
+            small_vector temp { std::move(other) };
+            other = std::move(*this);
+            *this = std::move(temp);
+        }
+
+    private:
+        alignas(T) unsigned char    m_inline[sizeof(T) * inline_capacity];
+        T*                          m_data { inline_data() };
+        size_type                   m_size {};
+        size_type                   m_capacity { inline_capacity };
+
+        T* inline_data() noexcept {
+            return reinterpret_cast<T*>(m_inline);
+        }
+
+        const T* inline_data() const noexcept {
+            return reinterpret_cast<const T*>(m_inline);
+        }
+
+        size_type grown_capacity() const {
+            return m_capacity * 2;
+        }
+
+        void reallocate(const size_type new_capacity) {
+            T* heap { static_cast<T*>(::operator new(new_capacity * sizeof(T))) };
+
+            std::uninitialized_move(m_data, m_data + m_size, heap);
+            std::destroy(m_data, m_data + m_size);
+            release();
+            m_data = heap;
+            m_capacity = new_capacity;
+        }
+
+        void release() noexcept {
+            if (!is_inline())
+                ::operator delete(m_data);
+            m_data = inline_data();
+            m_capacity = inline_capacity;
+        }
+
+        // requires that this container is empty and inline
+        void steal(small_vector&& other) {
+            if (other.is_inline()) {
+                std::uninitialized_move(other.m_data, other.m_data + other.m_size, m_data);
+                m_size = other.m_size;
+                other.clear();
+            }
+            else {
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_capacity = other.m_capacity;
+                other.m_data = other.inline_data();
+                other.m_size = 0;
+                other.m_capacity = inline_capacity;
+            }
+        }
+    };
+
+
+    template<class T, size_t N>
+    bool operator==(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs) {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class T, size_t N>
+    bool operator!=(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<class T, size_t N>
+    bool operator<(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs) {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+}    // namespace c74::min
@@ -0,0 +1,226 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// The shape of the ramp used when smoothing a value.
+
+    enum class smoothing_type {
+        linear,         ///< Change by the same amount at each sample.
+        exponential     ///< Change by the same ratio at each sample. Used only when both the current and the target value are positive.
+    };
+
+
+    /// An optional argument to an attribute<number> that smooths changes to its value in the audio thread.
+    /// Read the smoothed value once per sample using the attribute's smoothed() method.
+    ///
+    /// @code
+    /// attribute<number> gain { this, "gain", 1.0, smoothing { 20.0 } };
+    /// @endcode
+
+    class smoothing {
+    public:
+
+        /// Create a smoothing specification.
+        /// @param	milliseconds	The duration of the ramp to a new value.
+        /// @param	type			The shape of the ramp.
+
+        smoothing(const double milliseconds = 0.0, const smoothing_type type = smoothing_type::linear)
+        : m_time { milliseconds }
+        , m_type { type }
+        {}
+
+        double time() const {
+            return m_time;
+        }
+
+        smoothing_type type() const {
+            return m_type;
+        }
+
+    private:
+        double          m_time;
+        smoothing_type  m_type;
+    };
+
+
+    /// A value which ramps to a new target over a number of steps, typically one step per sample.
+    ///
+    /// @tparam	T	The type of the value.
+
+    template<typename T = sample>
+    class ramped_value {
+    public:
+
+        /// Create a ramped value.
+        /// @param	initial_value	The initial and target value.
+
+        explicit ramped_value(const T initial_value = T {})
+        : m_value { initial_value }
+        , m_target { initial_value }
+        {}
+
+
+        /// Set the number of steps over which a ramp to a new target is performed.
+        /// Takes effect with the next call to set().
+        /// @param	step_count	The number of steps. Zero or less jumps to new targets immediately.
+
+        void steps(const int step_count) {
+            m_steps = step_count;
+        }
+
+
+        /// Set the shape of the ramp.
+        /// Takes effect with the next call to set().
+        /// @param	type	The shape of the ramp.
+
+        void type(const smoothing_type type) {
+            m_type = type;
+        }
+
+
+        /// Begin a ramp to a new target.
+        /// @param	target	The new target value.
+        /// @return			True if a ramp has begun, false if the value jumped directly to the target.
+
+        bool set(const T target) {
+            m_target = target;
+            if (m_steps <= 0 || m_value == target) {
+                m_value     = target;
+                m_remaining = 0;
+                return false;
+            }
+
+            m_exponential = m_type == smoothing_type::exponential && m_value > T {} && target > T {};
+            if (m_exponential)
+                m_increment = std::pow(target / m_value, T { 1 } / static_cast<T>(m_steps));
+            else
+                m_increment = (target - m_value) / static_cast<T>(m_steps);
+            m_remaining = m_steps;
+            return true;
+        }
+
+
+        /// Set the value and target without ramping.
+        /// @param	value	The new value.
+
+        void set_immediately(const T value) {
+            m_value     = value;
+            m_target    = value;
+            m_remaining = 0;
+        }
+
+
+        /// Advance the ramp by one step.
+        /// The last step lands exactly on the target.
+        /// @return	The value after the step.
+
+        T next() {
+            if (m_remaining > 0) {
+                --m_remaining;
+                if (m_remaining == 0)
+                    m_value = m_target;
+                else if (m_exponential)
+                    m_value *= m_increment;
+                else
+                    m_value += m_increment;
+            }
+            return m_value;
+        }
+
+
+        T value() const {
+            return m_value;
+        }
+
+        T target() const {
+            return m_target;
+        }
+
+        bool ramping() const {
+            return m_remaining > 0;
+        }
+
+    private:
+        T               m_value;
+        T               m_target;
+        T               m_increment {};
+        int             m_steps {};
+        int             m_remaining {};
+        smoothing_type  m_type { smoothing_type::linear };
+        bool            m_exponential { false };
+    };
+
+
+    // The smoothing state of an attribute.
+    // The target is published from the thread that sets the attribute and the ramp is performed in the audio thread.
+
+    class attribute_smoother {
+    public:
+
+        void configure(const smoothing& a_smoothing) {
+            m_time.store(a_smoothing.time());
+            m_type = a_smoothing.type();
+            update_steps();
+        }
+
+        void time(const double milliseconds) {
+            m_time.store(milliseconds);
+            update_steps();
+        }
+
+        double time() const {
+            return m_time.load();
+        }
+
+        void prepare(const double samplerate) {
+            m_samplerate.store(samplerate);
+            update_steps();
+        }
+
+        void publish(const double target) {
+            m_target.store(target, std::memory_order_relaxed);
+        }
+
+
+        // audio thread only
+
+        double next() {
+            const auto target { m_target.load(std::memory_order_relaxed) };
+
+            if (!m_started) {
+                m_ramp.set_immediately(target);
+                m_started = true;
+            }
+            else if (target != m_ramp.target()) {
+                m_ramp.steps(m_steps.load(std::memory_order_relaxed));
+                m_ramp.type(m_type);
+                m_ramp.set(target);
+            }
+            return m_ramp.next();
+        }
+
+        bool ramping() const {
+            return m_ramp.ramping();
+        }
+
+    private:
+        std::atomic<double>     m_time { 0.0 };
+        std::atomic<double>     m_samplerate { 44100.0 };
+        std::atomic<double>     m_target { 0.0 };
+        std::atomic<int>        m_steps { 0 };
+        smoothing_type          m_type { smoothing_type::linear };
+        ramped_value<double>    m_ramp;
+        bool                    m_started { false };
+
+        void update_steps() {
+            m_steps.store(static_cast<int>(m_time.load() * 0.001 * m_samplerate.load()));
+        }
+    };
+
+}    // namespace c74::min
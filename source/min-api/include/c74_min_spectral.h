@@ -0,0 +1,427 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// Fourier transform of real signals of a fixed, power-of-2 size.
+    /// The signal is packed into a complex transform of half the size, so a transform costs about half of a complex one.
+    /// The twiddle factors and the bit-reversal permutation are computed once at construction.
+    ///
+    /// @tparam	fft_size	The number of samples of the signal, a power of 2 of at least 4.
+
+    template<size_t fft_size>
+    class real_fft {
+        static_assert(fft_size >= 4 && (fft_size & (fft_size - 1)) == 0, "fft_size must be a power of 2 of at least 4");
+
+    public:
+        using complex = std::complex<double>;
+
+        /// The number of frequencies from zero up to nyquist.
+        static constexpr size_t bin_count { fft_size / 2 + 1 };
+
+        real_fft() {
+            const auto two_pi { 2.0 * M_PI };
+
+            for (auto k = 0u; k < half; ++k) {
+                m_half_twiddles[k] = std::polar(1.0, -two_pi * k / half);
+                m_twiddles[k]      = std::polar(1.0, -two_pi * k / fft_size);
+            }
+
+            auto bits { 0u };
+            while ((1u << bits) < half)
+                ++bits;
+            for (auto i = 0u; i < half; ++i) {
+                auto reversed { 0u };
+                for (auto b = 0u; b < bits; ++b)
+                    reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+                m_bit_reversed[i] = reversed;
+            }
+        }
+
+
+        /// Transform a signal into its spectrum. The transform is not normalized.
+        /// @param	in	Pointer to fft_size samples.
+        /// @param	out	Pointer to space for bin_count frequencies.
+
+        void forward(const double* in, complex* out) const {
+            for (auto i = 0u; i < half; ++i)
+                out[m_bit_reversed[i]] = { in[2 * i], in[2 * i + 1] };
+            transform(out, false);
+
+            // separate the transforms of the even and the odd samples
+            const auto z0 { out[0] };
+            out[0]    = { z0.real() + z0.imag(), 0.0 };
+            out[half] = { z0.real() - z0.imag(), 0.0 };
+            for (auto k = 1u; k <= half / 2; ++k) {
+                const auto j  { half - k };
+                const auto zk { out[k] };
+                const auto zj { out[j] };
+                out[k] = separate(zk, zj, k);
+                if (j != k)
+                    out[j] = separate(zj, zk, j);
+            }
+        }
+
+
+        /// Transform a spectrum back into a signal, including the normalization by 1 / fft_size.
+        /// The imaginary parts of the first and the last frequency are ignored.
+        /// @param	in	Pointer to bin_count frequencies, which is used as working memory and is overwritten.
+        /// @param	out	Pointer to space for fft_size samples.
+
+        void inverse(complex* in, double* out) const {
+            const auto x0 { in[0].real() };
+            const auto xn { in[half].real() };
+            in[0] = { x0 + xn, x0 - xn };
+            for (auto k = 1u; k <= half / 2; ++k) {
+                const auto j  { half - k };
+                const auto xk { in[k] };
+                const auto xj { in[j] };
+                in[k] = pack(xk, xj, k);
+                if (j != k)
+                    in[j] = pack(xj, xk, j);
+            }
+
+            for (auto i = 0u; i < half; ++i) {
+                const auto j { m_bit_reversed[i] };
+                if (i < j)
+                    std::swap(in[i], in[j]);
+            }
+            transform(in, true);
+
+            const auto scale { 0.5 / half };
+            for (auto i = 0u; i < half; ++i) {
+                out[2 * i]     = in[i].real() * scale;
+                out[2 * i + 1] = in[i].imag() * scale;
+            }
+        }
+
+    private:
+        static constexpr size_t half { fft_size / 2 };
+
+        // In-place radix-2 transform of half the size on bit-reversed input.
+        void transform(complex* data, const bool inverse) const {
+            for (auto length = 2u; length <= half; length *= 2) {
+                const auto stride { half / length };
+                for (auto start = 0u; start < half; start += length) {
+                    for (auto k = 0u; k < length / 2; ++k) {
+                        const auto w { inverse ? std::conj(m_half_twiddles[k * stride]) : m_half_twiddles[k * stride] };
+                        const auto a { data[start + k] };
+                        const auto b { data[start + k + length / 2] * w };
+                        data[start + k]              = a + b;
+                        data[start + k + length / 2] = a - b;
+                    }
+                }
+            }
+        }
+
+        // X[k] = E[k] + W^k O[k] from the packed transform Z of the even (real) and odd (imaginary) samples
+        complex separate(const complex& zk, const complex& zj, const size_t k) const {
+            const auto even { 0.5 * (zk + std::conj(zj)) };
+            const auto odd  { complex { 0.0, -0.5 } * (zk - std::conj(zj)) };
+            return even + m_twiddles[k] * odd;
+        }
+
+        // Z[k] = E[k] + i O[k], the inverse of separate(), scaled by 2
+        complex pack(const complex& xk, const complex& xj, const size_t k) const {
+            const auto even { xk + std::conj(xj) };
+            const auto odd  { (xk - std::conj(xj)) * std::conj(m_twiddles[k]) };
+            return even + complex { 0.0, 1.0 } * odd;
+        }
+
+        std::array<complex, half>   m_half_twiddles;
+        std::array<complex, half>   m_twiddles;
+        std::array<size_t, half>    m_bit_reversed;
+    };
+
+
+    /// Short-time Fourier analysis and overlap-add resynthesis of one channel of audio.
+    /// The input is cut into frames of fft_size samples every hop_size = fft_size / overlap samples,
+    /// which are windowed, transformed, handed to a callback and transformed back.
+    /// Analysis and synthesis use a square-root Hann window, so an unchanged spectrum reproduces the input
+    /// delayed by latency samples.
+    ///
+    /// All buffers are allocated at construction. The transform and the window are shared by all processors
+    /// of the same size, so process() never allocates.
+    ///
+    /// @tparam	fft_size	The number of samples in each frame, a power of 2 of at least 4.
+    /// @tparam	overlap		The number of frames that overlap at any time, a power of 2 of at least 2.
+
+    template<size_t fft_size, size_t overlap = 4>
+    class spectral_processor {
+        static_assert(overlap >= 2 && (overlap & (overlap - 1)) == 0 && overlap <= fft_size, "overlap must be a power of 2 of at least 2");
+
+    public:
+        using complex = std::complex<double>;
+
+        static constexpr size_t hop_size  { fft_size / overlap };
+        static constexpr size_t bin_count { real_fft<fft_size>::bin_count };
+        static constexpr size_t latency   { fft_size };
+
+        spectral_processor()
+        : m_input(fft_size, 0.0)
+        , m_accumulator(fft_size, 0.0)
+        , m_output(hop_size, 0.0)
+        , m_frame(fft_size, 0.0)
+        , m_bins(bin_count)
+        {}
+
+
+        /// Process a vector of audio.
+        /// @param	in					Pointer to frame_count input samples.
+        /// @param	out					Pointer to space for frame_count output samples, which may be the same as in.
+        /// @param	frame_count			The number of samples.
+        /// @param	process_spectrum	Called with a pointer to the bin_count frequencies of every frame, which it may change.
+
+        template<class callback_type>
+        void process(const double* in, double* out, const long frame_count, callback_type&& process_spectrum) {
+            const auto& tables { shared_tables() };
+
+            for (auto i = 0L; i < frame_count;) {
+                // copy up to the end of the frame at once
+                const auto count { std::min(static_cast<size_t>(frame_count - i), fft_size - m_position) };
+                const auto output_position { m_position - first_position };
+
+                for (auto n = 0u; n < count; ++n) {
+                    m_input[m_position + n] = in[i + n];
+                    out[i + n]              = m_output[output_position + n];
+                }
+                m_position += count;
+                i += static_cast<long>(count);
+
+                if (m_position == fft_size) {
+                    process_frame(tables, process_spectrum);
+                    m_position = first_position;
+                }
+            }
+        }
+
+
+        /// Clear all audio that is buffered, e.g. when the dsp is restarted.
+
+        void clear() {
+            std::fill(m_input.begin(), m_input.end(), 0.0);
+            std::fill(m_accumulator.begin(), m_accumulator.end(), 0.0);
+            std::fill(m_output.begin(), m_output.end(), 0.0);
+            m_position = first_position;
+        }
+
+    private:
+        // The last hop of the input is written from here, while the output of the previous frame is read.
+        static constexpr size_t first_position { fft_size - hop_size };
+
+        struct tables {
+            real_fft<fft_size>      fft;
+            std::vector<double>     window;
+
+            tables()
+            : window(fft_size)
+            {
+                // periodic sqrt-Hann, whose square overlaps to overlap / 2 at every sample
+                for (auto i = 0u; i < fft_size; ++i)
+                    window[i] = std::sqrt(0.5 - 0.5 * std::cos(2.0 * M_PI * i / fft_size));
+            }
+        };
+
+        static const tables& shared_tables() {
+            static const tables s_tables;
+            return s_tables;
+        }
+
+        template<class callback_type>
+        void process_frame(const tables& t, callback_type& process_spectrum) {
+            for (auto i = 0u; i < fft_size; ++i)
+                m_frame[i] = m_input[i] * t.window[i];
+            t.fft.forward(m_frame.data(), m_bins.data());
+
+            process_spectrum(m_bins.data());
+
+            t.fft.inverse(m_bins.data(), m_frame.data());
+
+            const auto gain { 2.0 / overlap };
+            for (auto i = 0u; i < fft_size; ++i)
+                m_accumulator[i] += m_frame[i] * t.window[i] * gain;
+
+            // the first hop is complete, move everything on by one hop
+            std::copy(m_accumulator.begin(), m_accumulator.begin() + hop_size, m_output.begin());
+            std::copy(m_accumulator.begin() + hop_size, m_accumulator.end(), m_accumulator.begin());
+            std::fill(m_accumulator.end() - hop_size, m_accumulator.end(), 0.0);
+            std::copy(m_input.begin() + hop_size, m_input.end(), m_input.begin());
+        }
+
+        std::vector<double>     m_input;
+        std::vector<double>     m_accumulator;
+        std::vector<double>     m_output;
+        std::vector<double>     m_frame;
+        std::vector<complex>    m_bins;
+        size_t                  m_position { first_position };
+    };
+
+
+    /// Short-time Fourier analysis of one channel of audio, without resynthesis, e.g. for detectors and meters.
+    /// The input is cut into frames of fft_size samples every hop_size = fft_size / overlap samples,
+    /// which are windowed with a Hann window, transformed, and handed to a callback
+    /// together with the position in the vector at which the frame is complete.
+    /// A vector of frame_count samples therefore costs at most frame_count / hop_size + 1 transforms.
+    ///
+    /// All buffers are allocated at construction. The transform and the window are shared by all analyzers
+    /// of the same size, so process() never allocates.
+    ///
+    /// @tparam	fft_size	The number of samples in each frame, a power of 2 of at least 4.
+    /// @tparam	overlap		The number of frames that overlap at any time, a power of 2.
+
+    template<size_t fft_size, size_t overlap = 4>
+    class spectral_analyzer {
+        static_assert(overlap >= 1 && (overlap & (overlap - 1)) == 0 && overlap <= fft_size, "overlap must be a power of 2");
+
+    public:
+        using complex = std::complex<double>;
+
+        static constexpr size_t hop_size  { fft_size / overlap };
+        static constexpr size_t bin_count { real_fft<fft_size>::bin_count };
+
+        spectral_analyzer()
+        : m_input(fft_size, 0.0)
+        , m_frame(fft_size, 0.0)
+        , m_bins(bin_count)
+        {}
+
+
+        /// Analyze a vector of audio.
+        /// @param	in					Pointer to frame_count input samples.
+        /// @param	frame_count			The number of samples.
+        /// @param	analyze_spectrum	Called for every frame that is completed by this vector,
+        ///								prototyped as `void (const complex* bins, long offset)`,
+        ///								where offset is the index in the vector of the last sample of the frame.
+
+        template<class callback_type>
+        void process(const double* in, const long frame_count, callback_type&& analyze_spectrum) {
+            const auto& tables { shared_tables() };
+
+            for (auto i = 0L; i < frame_count;) {
+                const auto count { std::min(static_cast<size_t>(frame_count - i), fft_size - m_position) };
+
+                std::copy_n(in + i, count, m_input.begin() + m_position);
+                m_position += count;
+                i += static_cast<long>(count);
+
+                if (m_position == fft_size) {
+                    for (auto n = 0u; n < fft_size; ++n)
+                        m_frame[n] = m_input[n] * tables.window[n];
+                    tables.fft.forward(m_frame.data(), m_bins.data());
+
+                    analyze_spectrum(static_cast<const complex*>(m_bins.data()), i - 1);
+
+                    std::copy(m_input.begin() + hop_size, m_input.end(), m_input.begin());
+                    m_position = first_position;
+                }
+            }
+        }
+
+
+        /// Clear all audio that is buffered, e.g. when the dsp is restarted.
+
+        void clear() {
+            std::fill(m_input.begin(), m_input.end(), 0.0);
+            m_position = first_position;
+        }
+
+    private:
+        // The last hop of the input is written from here.
+        static constexpr size_t first_position { fft_size - hop_size };
+
+        struct tables {
+            real_fft<fft_size>      fft;
+            std::vector<double>     window;
+
+            tables()
+            : window(fft_size)
+            {
+                // periodic Hann
+                for (auto i = 0u; i < fft_size; ++i)
+                    window[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / fft_size);
+            }
+        };
+
+        static const tables& shared_tables() {
+            static const tables s_tables;
+            return s_tables;
+        }
+
+        std::vector<double>     m_input;
+        std::vector<double>     m_frame;
+        std::vector<complex>    m_bins;
+        size_t                  m_position { first_position };
+    };
+
+
+    /// Inherit from spectral_operator to write an audio object that processes the spectrum of its input,
+    /// as you would otherwise patch inside of pfft~. The operator buffers the input, windows it, computes the
+    /// Fourier transform every hop_size samples and resynthesizes the output by overlap-add.
+    /// Your class only implements process_spectrum(), which receives the bin_count frequencies from zero up to nyquist.
+    ///
+    /// Each input channel is processed into the output channel with the same index, up to the channel count that is
+    /// passed to the constructor. All buffers are allocated at construction, so processing never allocates.
+    /// The output is delayed by latency samples.
+    ///
+    /// @tparam	fft_size	The number of samples in each frame, a power of 2 of at least 4.
+    /// @tparam	overlap		The number of frames that overlap at any time, a power of 2 of at least 2.
+    /// @see vector_operator
+
+    template<size_t fft_size, size_t overlap = 4>
+    class spectral_operator : public vector_operator<> {
+    public:
+        using complex   = std::complex<double>;
+        using processor = spectral_processor<fft_size, overlap>;
+
+        static constexpr size_t hop_size  { processor::hop_size };
+        static constexpr size_t bin_count { processor::bin_count };
+        static constexpr size_t latency   { processor::latency };
+
+
+        /// @param	channel_count	The number of channels for which buffers are allocated.
+
+        explicit spectral_operator(const size_t channel_count = 1)
+        : m_processors(channel_count)
+        {}
+
+
+        /// All classes extending spectral_operator<> must implement this method.
+        /// It is called on the audio thread for every frame of every channel.
+        /// @param	bins		Pointer to the bin_count frequencies of the frame, which may be changed in place.
+        /// @param	bin_count	The number of frequencies, fft_size / 2 + 1.
+        /// @param	channel		The channel of the frame.
+
+        virtual void process_spectrum(complex* bins, size_t bin_count, size_t channel) = 0;
+
+
+        /// Clear all audio that is buffered, e.g. in response to a 'clear' message.
+
+        void clear_spectra() {
+            for (auto& p : m_processors)
+                p.clear();
+        }
+
+
+        void operator()(audio_bundle input, audio_bundle output) override {
+            const auto channels { std::min({ static_cast<size_t>(input.channel_count()), static_cast<size_t>(output.channel_count()), m_processors.size() }) };
+
+            for (auto channel = 0u; channel < channels; ++channel) {
+                m_processors[channel].process(input.samples(channel), output.samples(channel), input.frame_count(), [this, channel](complex* bins) {
+                    process_spectrum(bins, bin_count, channel);
+                });
+            }
+            for (auto channel = static_cast<long>(channels); channel < output.channel_count(); ++channel)
+                std::fill_n(output.samples(channel), output.frame_count(), 0.0);
+        }
+
+    private:
+        std::vector<processor> m_processors;
+    };
+
+
+}    // namespace c74::min
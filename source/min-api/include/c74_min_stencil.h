@@ -0,0 +1,350 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// How a stencil reads the cells beyond the edges of a matrix.
+
+    enum class matrix_edge {
+        clamp,  ///< Repeat the cells at the edge.
+        wrap,   ///< Read from the opposite edge.
+        fold,   ///< Reflect back into the matrix, in the same way as fold().
+        zero    ///< Read zero.
+    };
+
+
+    /// Map a coordinate onto one dimension of a matrix.
+    /// @param	index	The coordinate, which may be outside of the matrix.
+    /// @param	size	The size of the dimension.
+    /// @param	edge	How coordinates outside of the matrix are mapped.
+    /// @return			The coordinate within the matrix, or -1 if the cell reads as zero.
+
+    inline long matrix_edge_index(const long index, const long size, const matrix_edge edge) {
+        if (index >= 0 && index < size)
+            return index;
+
+        switch (edge) {
+            case matrix_edge::clamp:
+                return index < 0 ? 0 : size - 1;
+            case matrix_edge::wrap: {
+                const auto m { index % size };
+                return m < 0 ? m + size : m;
+            }
+            case matrix_edge::fold: {
+                if (size == 1)
+                    return 0;
+
+                const auto period { 2 * (size - 1) };
+                auto       m { index % period };
+
+                if (m < 0)
+                    m += period;
+                return m < size ? m : period - m;
+            }
+            default:
+                return -1;
+        }
+    }
+
+
+    /// A read-only view of a whole 2-dimensional matrix, for kernels that read the neighbours of each cell.
+    ///
+    /// @tparam	T	The type of the elements of the matrix.
+
+    template<typename T>
+    class matrix_view {
+    public:
+
+        /// Create a view of a matrix.
+        /// @param	a_data			A pointer to the first plane of the first cell.
+        /// @param	a_width			The number of cells in each row.
+        /// @param	a_height		The number of rows.
+        /// @param	a_plane_count	The number of planes in each cell, which are neighbouring elements.
+        /// @param	a_cell_stride	The number of elements between neighbouring cells.
+        /// @param	a_row_stride	The number of elements between neighbouring rows.
+
+        matrix_view(const T* a_data, const long a_width, const long a_height, const long a_plane_count, const long a_cell_stride, const long a_row_stride)
+        : m_data { a_data }
+        , m_width { a_width }
+        , m_height { a_height }
+        , m_plane_count { a_plane_count }
+        , m_cell_stride { a_cell_stride }
+        , m_row_stride { a_row_stride }
+        {}
+
+
+        /// Create a view of the input matrix described by the matrix_info passed to calc_row() or calc_cell().
+        /// @param	info	The matrix_info.
+
+        explicit matrix_view(const matrix_info& info)
+        : matrix_view { reinterpret_cast<const T*>(info.m_bip), info.width(), info.dim_count() > 1 ? info.height() : 1, info.plane_count(),
+            info.m_in_info->dimstride[0] / static_cast<long>(sizeof(T)), info.m_in_info->dimstride[1] / static_cast<long>(sizeof(T)) }
+        {}
+
+
+        long width() const {
+            return m_width;
+        }
+
+        long height() const {
+            return m_height;
+        }
+
+        long plane_count() const {
+            return m_plane_count;
+        }
+
+        long cell_stride() const {
+            return m_cell_stride;
+        }
+
+
+        /// Get a pointer to the first element of a row.
+        /// NOTE: No bounds checking is performed!
+        /// @param	y	The index of the row.
+        /// @return		A pointer to the first plane of the first cell of the row.
+
+        const T* row(const long y) const {
+            return m_data + y * m_row_stride;
+        }
+
+    private:
+        const T*    m_data;
+        long        m_width;
+        long        m_height;
+        long        m_plane_count;
+        long        m_cell_stride;
+        long        m_row_stride;
+    };
+
+
+    /// One point of a stencil: an offset from the cell being calculated and the weight of the cell at that offset.
+
+    struct stencil_tap {
+        long    x;
+        long    y;
+        double  weight;
+    };
+
+
+    /// A kernel that is the product of a horizontal and a vertical kernel, such as a box or gaussian blur.
+    /// Each output cell then costs the sum of the two kernel sizes rather than their product, which makes larger radii affordable.
+
+    class separable_kernel {
+    public:
+        static constexpr long k_max_radius { 32 };    ///< The largest number of cells on either side of the centre of a kernel.
+
+
+        /// Create a kernel.
+        /// @param	a_horizontal	The weights across a row, centred on the cell being calculated. The size must be odd.
+        /// @param	a_vertical		The weights down a column, centred on the cell being calculated. The size must be odd.
+
+        separable_kernel(const vector<double>& a_horizontal, const vector<double>& a_vertical)
+        : m_horizontal { a_horizontal }
+        , m_vertical { a_vertical }
+        {
+            if (!valid(m_horizontal) || !valid(m_vertical)) {
+                error("separable_kernel requires an odd number of weights, at most " + std::to_string(2 * k_max_radius + 1));
+                m_horizontal = { 1.0 };
+                m_vertical   = { 1.0 };
+            }
+        }
+
+
+        /// Create a kernel using the same weights across rows and down columns.
+        /// @param	weights		The weights, centred on the cell being calculated. The size must be odd.
+
+        explicit separable_kernel(const vector<double>& weights)
+        : separable_kernel { weights, weights }
+        {}
+
+
+        /// Create a kernel that averages a square of cells.
+        /// @param	radius	The number of cells on each side of the cell being calculated.
+        /// @return			The kernel.
+
+        static separable_kernel box(const long radius) {
+            const auto size { 2 * std::clamp(radius, 0L, k_max_radius) + 1 };
+            return separable_kernel { vector<double>(static_cast<size_t>(size), 1.0 / static_cast<double>(size)) };
+        }
+
+
+        const vector<double>& horizontal() const {
+            return m_horizontal;
+        }
+
+        const vector<double>& vertical() const {
+            return m_vertical;
+        }
+
+        long horizontal_radius() const {
+            return static_cast<long>(m_horizontal.size() / 2);
+        }
+
+        long vertical_radius() const {
+            return static_cast<long>(m_vertical.size() / 2);
+        }
+
+    private:
+        vector<double> m_horizontal;
+        vector<double> m_vertical;
+
+        static bool valid(const vector<double>& weights) {
+            return weights.size() % 2 == 1 && weights.size() <= static_cast<size_t>(2 * k_max_radius + 1);
+        }
+    };
+
+
+    // Internal storage and helpers for the stencil routines below.
+    // Rows are processed in chunks which fit in arrays on the stack, so no memory is allocated
+    // and the routines can be called concurrently from the threads calculating a matrix.
+
+    static constexpr long k_stencil_chunk_elements { 1024 };
+
+
+    // Add the weighted cells from x0 + offset up to x1 + offset of a row to an accumulator holding plane_count elements per cell.
+    // Only the cells beyond the edges of the matrix need their coordinates mapped.
+
+    template<typename T>
+    void stencil_accumulate(const matrix_view<T>& in, const T* row, const long x0, const long x1, const long offset, const double weight, const matrix_edge edge, const long plane_count, double* acc) {
+        const auto cs          { in.cell_stride() };
+        const auto inner_begin { std::clamp(-offset, x0, x1) };
+        const auto inner_end   { std::clamp(in.width() - offset, inner_begin, x1) };
+
+        const auto border = [&](const long x) {
+            const auto sx { matrix_edge_index(x + offset, in.width(), edge) };
+
+            if (sx >= 0) {
+                for (auto plane = 0; plane < plane_count; ++plane)
+                    acc[(x - x0) * plane_count + plane] += weight * row[sx * cs + plane];
+            }
+        };
+
+        for (auto x = x0; x < inner_begin; ++x)
+            border(x);
+
+        if (cs == plane_count) {
+            const auto source { row + (inner_begin + offset) * plane_count };
+            const auto dest   { acc + (inner_begin - x0) * plane_count };
+            const auto count  { (inner_end - inner_begin) * plane_count };
+
+            for (auto i = 0; i < count; ++i)
+                dest[i] += weight * source[i];
+        }
+        else {
+            for (auto x = inner_begin; x < inner_end; ++x) {
+                for (auto plane = 0; plane < plane_count; ++plane)
+                    acc[(x - x0) * plane_count + plane] += weight * row[(x + offset) * cs + plane];
+            }
+        }
+
+        for (auto x = inner_end; x < x1; ++x)
+            border(x);
+    }
+
+
+    // Convert the accumulated cells from x0 up to x1 to the type of the output, rounding and saturating integers.
+
+    template<typename T>
+    void stencil_write(const matrix_span<T>& out, const long x0, const long x1, const long plane_count, const double* acc) {
+        for (auto x = x0; x < x1; ++x) {
+            for (auto plane = 0; plane < plane_count; ++plane) {
+                const auto value { acc[(x - x0) * plane_count + plane] };
+
+                if constexpr (std::is_integral<T>::value) {
+                    const auto low  { static_cast<double>(std::numeric_limits<T>::min()) };
+                    const auto high { static_cast<double>(std::numeric_limits<T>::max()) };
+
+                    out(x, plane) = static_cast<T>(std::clamp(std::round(value), low, high));
+                }
+                else
+                    out(x, plane) = static_cast<T>(value);
+            }
+        }
+    }
+
+
+    /// Calculate one row of a matrix as the weighted sum of the neighbours of each cell.
+    /// Call this from the calc_row() method of a matrix_operator.
+    ///
+    /// @param	in		The whole input matrix.
+    /// @param	out		The output row.
+    /// @param	y		The index of the row in the input matrix.
+    /// @param	taps	A container of stencil_tap.
+    /// @param	edge	How the cells beyond the edges of the input matrix are read.
+
+    template<typename T, class tap_container_type>
+    void stencil_row(const matrix_view<T>& in, const matrix_span<T>& out, const long y, const tap_container_type& taps, const matrix_edge edge) {
+        const auto plane_count { std::min(in.plane_count(), out.plane_count()) };
+        const auto chunk       { std::max(k_stencil_chunk_elements / plane_count, 1L) };
+
+        std::array<double, k_stencil_chunk_elements> acc;
+
+        for (auto x0 = 0L; x0 < out.size(); x0 += chunk) {
+            const auto x1 { std::min(x0 + chunk, out.size()) };
+
+            std::fill_n(acc.begin(), (x1 - x0) * plane_count, 0.0);
+
+            for (const auto& tap : taps) {
+                const auto sy { matrix_edge_index(y + tap.y, in.height(), edge) };
+
+                if (sy >= 0)
+                    stencil_accumulate(in, in.row(sy), x0, x1, tap.x, tap.weight, edge, plane_count, acc.data());
+            }
+            stencil_write(out, x0, x1, plane_count, acc.data());
+        }
+    }
+
+
+    /// Calculate one row of a matrix convolved with a separable kernel.
+    /// The vertical kernel is applied first to a run of cells wide enough for the horizontal kernel,
+    /// then the horizontal kernel is applied to that run.
+    ///
+    /// @param	in		The whole input matrix.
+    /// @param	out		The output row.
+    /// @param	y		The index of the row in the input matrix.
+    /// @param	kernel	The kernel.
+    /// @param	edge	How the cells beyond the edges of the input matrix are read.
+
+    template<typename T>
+    void stencil_row(const matrix_view<T>& in, const matrix_span<T>& out, const long y, const separable_kernel& kernel, const matrix_edge edge) {
+        const auto  plane_count { std::min(in.plane_count(), out.plane_count()) };
+        const auto  chunk       { std::max(k_stencil_chunk_elements / plane_count, 1L) };
+        const auto  rx          { kernel.horizontal_radius() };
+        const auto  ry          { kernel.vertical_radius() };
+        const auto& horizontal  { kernel.horizontal() };
+        const auto& vertical    { kernel.vertical() };
+
+        std::array<double, k_stencil_chunk_elements> acc;
+        std::array<double, k_stencil_chunk_elements + 2 * separable_kernel::k_max_radius * max::JIT_MATRIX_MAX_PLANECOUNT> columns;
+
+        for (auto x0 = 0L; x0 < out.size(); x0 += chunk) {
+            const auto x1    { std::min(x0 + chunk, out.size()) };
+            const auto count { (x1 - x0) * plane_count };
+
+            std::fill_n(columns.begin(), count + 2 * rx * plane_count, 0.0);
+            for (auto k = 0L; k <= 2 * ry; ++k) {
+                const auto sy { matrix_edge_index(y + k - ry, in.height(), edge) };
+
+                if (sy >= 0)
+                    stencil_accumulate(in, in.row(sy), x0 - rx, x1 + rx, 0L, vertical[k], edge, plane_count, columns.data());
+            }
+
+            std::fill_n(acc.begin(), count, 0.0);
+            for (auto k = 0L; k <= 2 * rx; ++k) {
+                const auto weight { horizontal[k] };
+                const auto source { columns.data() + k * plane_count };
+
+                for (auto i = 0; i < count; ++i)
+                    acc[i] += weight * source[i];
+            }
+            stencil_write(out, x0, x1, plane_count, acc.data());
+        }
+    }
+
+}    // namespace c74::min
@@ -153,9 +153,7 @@ namespace c74::min {
             return s->s_thing;
         }
 
-        bool empty() const {
-            return (s == nullptr) || (s == max::gensym(""));
-        }
+        bool empty() const;
 
 		operator max::t_atom_long() const {
 			// maybe object_method should use t_ptr_size
@@ -187,9 +185,11 @@ namespace c74::min {
     static const symbol k_sym__pound_b                  { "#B" };           ///< The special "#B" symbol used for accessing an object's box.
     static const symbol k_sym__pound_d                  { "#D" };           ///< The special "#D" symbol used for accessing an object's dictionary in the patcher.
     static const symbol k_sym__pound_p                  { "#P" };           ///< The special "#D" symbol used for accessing an object's owning patcher.
+    static const symbol k_sym_min_binary_state          { "min_binary_state" };    ///< The dictionary key of the state saved by a 'savestate_binary' message.
     static const symbol k_sym_float                     { "float" };		///< The symbol "float".
     static const symbol k_sym_float32                   { "float32" };      ///< The symbol "float32".
     static const symbol k_sym_float64                   { "float64" };      ///< The symbol "float64".
+    static const symbol k_sym_float_array               { "float_array" };  ///< The symbol "float_array", the message that sends a float_array.
     static const symbol k_sym_getmatrix                 { "getmatrix" };    ///< The symbol "getmatrix".
     static const symbol k_sym_long                      { "long" };         ///< The symbol "long".
     static const symbol k_sym_modified                  { "modified" };     ///< The symbol "modified".
@@ -202,6 +202,8 @@ namespace c74::min {
     static const symbol k_sym_size                      { "size" };         ///< Cached symbol "size"
     static const symbol k_sym_time                      { "time" };         ///< The symbol "time".
     static const symbol k_sym_value                     { "value" };	    ///< The symbol "value".
+    static const symbol k_sym_free                      { "free" };         ///< The symbol "free", notified by an object that is being freed.
+    static const symbol k_sym_varname                   { "varname" };      ///< The symbol "varname", the attribute of a box holding its scripting name.
 
     static const symbol k_sym_attr_modified             { "attr_modified" };            ///< Cached symbol "attr_modified"
     static const symbol k_sym_globalsymbol_binding      { "globalsymbol_binding"};      ///< Cached symbol "globalsymbol_binding"
@@ -264,4 +266,43 @@ namespace c74::min {
     static const symbol k_sym_spectrum_grid_lines        { "spectrum_grid_lines" };        ///< Cached symbol naming a Live color
     static const symbol k_sym_retro_display_scale_text   { "retro_display_scale_text" };   ///< Cached symbol naming a Live color
 
+
+    inline bool symbol::empty() const {
+        return (s == nullptr) || (s == static_cast<max::t_symbol*>(k_sym__empty));
+    }
+
+
+#ifdef __APPLE__
+#pragma mark -
+#pragma mark Symbol Literals
+#endif
+
+    /// The storage of a symbol literal, see #MIN_SYMBOL.
+    /// As a static member of a class template it is initialized when the external is loaded, along with the k_sym_ constants,
+    /// and reading it afterwards is a plain load without the guard of a function-local static.
+    /// @tparam literal_type	A class whose static text() function returns the string of the symbol.
+
+    template<class literal_type>
+    struct symbol_literal {
+        static inline const symbol value { literal_type::text() };
+    };
+
 }    // namespace c74::min
+
+
+/// A symbol for a string literal that is interned once, when the external is loaded, instead of each time the expression is evaluated.
+/// Constructing a symbol from a string hashes the string and looks it up in the symbol table of Max,
+/// so this is for code that is run often, e.g. comparing the names of notifications or looking up the keys of a dictionary:
+/// @code
+/// if (n.name() == MIN_SYMBOL("attr_modified")) ...
+/// auto pattern = d[MIN_SYMBOL("pattern")];
+/// @endcode
+/// Every use of the macro has its own storage, so a symbol used in many places is better declared once as a constant.
+/// The order in which these symbols are initialized is unspecified, so do not use the macro in the initializers of other static objects.
+/// @param	str	A string literal.
+/// @return		A const reference to the symbol.
+
+#define MIN_SYMBOL(str) ([]() -> const c74::min::symbol& {                                            \
+    struct literal { static constexpr const char* text() { return str; } };                         \
+    return c74::min::symbol_literal<literal>::value;                                                \
+}())
@@ -0,0 +1,265 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    class task_scheduler;
+
+    static const char* task_scheduler_impl_name = "min_task_scheduler_impl";
+
+    // important! this class is used by all min-based externals to find the one task_scheduler of the process. If you make significant
+    // changes to the task_scheduler or the worker_pool, change the task_scheduler_impl_name to avoid sharing a scheduler with externals
+    // that use an older version of min-api.
+    struct task_scheduler_impl {
+        max::t_object   m_obj;
+        task_scheduler* m_scheduler;
+    };
+
+
+    /// The worker threads of the process, with two lanes:
+    /// a real-time lane (a worker_pool) that divides the work of an audio vector or a matrix across cores,
+    /// and a background lane for loading and analysis, whose tasks run at low priority until they are done.
+    ///
+    /// Each background thread has its own queue of tasks. Tasks submitted by a background task go to the queue of its thread
+    /// and are taken from the back, while an idle thread steals the oldest tasks from the front of the other queues.
+    /// Work that divides itself into tasks therefore stays on one core until there are idle cores to share it.
+    ///
+    /// All Min externals share one scheduler, so that several objects with parallel processing do not oversubscribe the cores.
+
+    class task_scheduler {
+    public:
+
+        /// Create a scheduler. Objects use the shared() scheduler instead.
+        /// @param	realtime_thread_count	The number of worker threads of the real-time lane, in addition to the calling audio thread.
+        /// @param	background_thread_count	The number of threads of the background lane, at least one.
+
+        task_scheduler(const size_t realtime_thread_count, const size_t background_thread_count)
+        : m_realtime { realtime_thread_count, thread_priority::realtime }
+        , m_queues(std::max<size_t>(background_thread_count, 1)) {
+            m_threads.reserve(m_queues.size());
+            for (auto i = 0u; i < m_queues.size(); ++i)
+                m_threads.emplace_back(&task_scheduler::run, this, i);
+        }
+
+
+        /// Tasks that are still queued are discarded without running them.
+
+        ~task_scheduler() {
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                m_running = false;
+            }
+            m_condition.notify_all();
+            for (auto& t : m_threads)
+                t.join();
+
+            for (auto& q : m_queues) {
+                for (auto& t : q.tasks)
+                    t.perform(t.context, false);
+            }
+        }
+
+
+        task_scheduler(const task_scheduler&) = delete;
+        task_scheduler& operator=(const task_scheduler&) = delete;
+
+
+        /// Get the scheduler shared by all Min externals in the process.
+        /// The first external to call this creates the scheduler and registers it, the others find it.
+        /// The first call should happen on the main thread (e.g. when an attribute is set).
+        /// @return	A reference to the shared scheduler.
+
+        static task_scheduler& shared() {
+            // intentionally never deleted: joining threads while the external is unloaded can deadlock
+            static task_scheduler* s_scheduler { find_or_create() };
+            return *s_scheduler;
+        }
+
+
+        /// The real-time lane.
+        /// @return	The pool of real-time worker threads.
+
+        worker_pool& realtime() {
+            return m_realtime;
+        }
+
+
+        /// Call a function for each index in a range on the real-time lane, see worker_pool::parallel_for().
+        /// @param	count	The number of indices.
+        /// @param	f		The function to call, which takes a size_t index as its only argument.
+
+        template<class function_type>
+        void parallel_for(const size_t count, function_type&& f) {
+            m_realtime.parallel_for(count, std::forward<function_type>(f));
+        }
+
+
+        /// Run a function on the background lane.
+        /// This allocates, so it must not be called on the audio thread.
+        /// @param	f	The function to call, which takes no arguments. It may submit further tasks.
+
+        template<class function_type>
+        void background(function_type&& f) {
+            using closure_type = typename std::decay<function_type>::type;
+
+            const task t {
+                [](void* context, const bool execute) {
+                    std::unique_ptr<closure_type> closure { static_cast<closure_type*>(context) };
+                    if (execute)
+                        (*closure)();
+                },
+                new closure_type { std::forward<function_type>(f) }
+            };
+
+            const auto own { current_queue() };
+            auto&      q { m_queues[own < m_queues.size() ? own : m_next_queue++ % m_queues.size()] };
+
+            m_pending.fetch_add(1, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock { q.mutex };
+                q.tasks.push_back(t);
+            }
+            {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                ++m_queued;
+            }
+            m_condition.notify_one();
+        }
+
+
+        /// The number of background tasks that are queued or running.
+        /// @return	The number of tasks.
+
+        size_t background_pending() const {
+            return m_pending.load(std::memory_order_acquire);
+        }
+
+
+        /// The number of threads of the background lane.
+        /// @return	The number of threads.
+
+        size_t background_thread_count() const {
+            return m_threads.size();
+        }
+
+    private:
+
+        // a type-erased task, which deletes its context after it is performed or discarded
+
+        struct task {
+            void (*perform)(void* context, bool execute);
+            void* context;
+        };
+
+        struct queue {
+            std::mutex          mutex;
+            std::deque<task>    tasks;
+        };
+
+
+        static task_scheduler* find_or_create() {
+            const auto name { max::gensym(task_scheduler_impl_name) };
+
+            // the scheduler is potentially already registered by another min based external
+            if (const auto registered = static_cast<task_scheduler_impl*>(max::object_findregistered(max::CLASS_NOBOX, name)))
+                return registered->m_scheduler;
+
+            auto c = max::class_findbyname(max::CLASS_NOBOX, name);
+            if (!c) {
+                c = max::class_new(task_scheduler_impl_name, (max::method)0, (max::method)0, sizeof(task_scheduler_impl), (max::method)0, 0);
+                max::class_register(max::CLASS_NOBOX, c);
+            }
+
+            const auto cores { std::thread::hardware_concurrency() };
+            auto       impl { static_cast<task_scheduler_impl*>(max::object_alloc(c)) };
+
+            impl->m_scheduler = new task_scheduler { worker_pool::default_thread_count(), cores > 1 ? std::min<size_t>(cores - 1, 4) : 1 };
+            max::object_register(max::CLASS_NOBOX, name, impl);
+            return impl->m_scheduler;
+        }
+
+
+        // The index of the queue of the calling thread, or the number of queues for a thread outside the background lane.
+        // The threads are compared rather than kept in a thread_local, which each external would have its own copy of.
+
+        size_t current_queue() const {
+            const auto id { std::this_thread::get_id() };
+            for (auto i = 0u; i < m_threads.size(); ++i) {
+                if (m_threads[i].get_id() == id)
+                    return i;
+            }
+            return m_queues.size();
+        }
+
+
+        // take from the back of the own queue, or else steal from the front of the others
+
+        bool take(const size_t own, task& t) {
+            {
+                auto&                       q { m_queues[own] };
+                std::lock_guard<std::mutex> lock { q.mutex };
+                if (!q.tasks.empty()) {
+                    t = q.tasks.back();
+                    q.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (auto i = 1u; i < m_queues.size(); ++i) {
+                auto&                       q { m_queues[(own + i) % m_queues.size()] };
+                std::lock_guard<std::mutex> lock { q.mutex };
+                if (!q.tasks.empty()) {
+                    t = q.tasks.front();
+                    q.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+
+        void run(const size_t own) {
+            set_current_thread_priority(thread_priority::background);
+
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock { m_mutex };
+                    m_condition.wait(lock, [this] {
+                        return m_queued > 0 || !m_running;
+                    });
+                    if (!m_running)
+                        return;
+                    --m_queued;
+                }
+
+                // each count stands for a queued task, so there is one to take, though not necessarily the one that was counted
+                task t;
+                if (take(own, t)) {
+                    t.perform(t.context, true);
+                    m_pending.fetch_sub(1, std::memory_order_acq_rel);
+                }
+            }
+        }
+
+
+        worker_pool             m_realtime;
+        vector<queue>           m_queues;
+        vector<std::thread>     m_threads;
+        std::mutex              m_mutex;
+        std::condition_variable m_condition;
+        size_t                  m_queued { 0 };      // tasks queued and not yet claimed by a thread, guarded by m_mutex
+        bool                    m_running { true };  // guarded by m_mutex
+        std::atomic<size_t>     m_pending { 0 };
+        std::atomic<size_t>     m_next_queue { 0 };
+    };
+
+
+    inline worker_pool& worker_pool::shared() {
+        return task_scheduler::shared().realtime();
+    }
+
+}    // namespace c74::min
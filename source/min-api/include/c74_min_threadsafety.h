@@ -32,7 +32,8 @@ namespace c74::min {
         assert,    ///< Terminate execution
         fifo,      ///< Queue the operation(s) into a first-in-first-out buffer
         first,     ///< Queue the operation -- only queueing the first one if there are multiple
-        last       ///< Queue the operation -- only queueing the last one if there are multiple
+        last,      ///< Queue the operation -- only queueing the last one if there are multiple
+        batch      ///< Queue the operation(s) and deliver all of them together as a single list
     };
 
 
@@ -0,0 +1,155 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+
+    /// A queue of timestamped events (e.g. parameter changes) from the main or scheduler thread to the audio thread,
+    /// which places each event at the sample within a vector that corresponds to the time it was posted,
+    /// so that a vector_operator can apply it at that sample rather than at the start of the vector.
+    ///
+    /// Events are stamped with the logical time of the scheduler when they are posted, optionally with a delay.
+    /// At the start of each vector the audio thread collects the events that became due since the previous vector,
+    /// and places them within the vector in proportion to their time between the previous vector and this one.
+    /// With Overdrive and Scheduler in Audio Interrupt enabled this places the events exactly, one vector later than they were posted.
+    /// Otherwise they are placed as closely as the time of the scheduler thread allows.
+    ///
+    /// @code
+    /// void operator()(audio_bundle input, audio_bundle output) {
+    ///     m_events.split(output.frame_count(),
+    ///         [this](const double& gain) { m_gain = gain; },
+    ///         [&](long start, long count) { process(input, output, start, count); });
+    /// }
+    /// @endcode
+    ///
+    /// Posting an event neither allocates nor locks, and neither does collecting the events in the audio thread.
+    /// Any number of threads may post events; only the audio thread may collect them.
+    ///
+    /// @tparam	T	The type of the events, which must be default constructible and copyable.
+
+    template<class T>
+    class timed_events {
+    public:
+        /// An event placed within a vector.
+
+        struct event {
+            long    offset;    ///< The index of the sample within the vector at which the event takes effect.
+            T       value;     ///< The event.
+        };
+
+
+        /// Create a queue of events.
+        /// @param	capacity	The number of events that can wait to take effect.
+
+        explicit timed_events(const size_t capacity = 256)
+        : m_fifo { capacity } {
+            m_pending.reserve(capacity);
+            m_due.reserve(capacity);
+        }
+
+        timed_events(const timed_events&) = delete;
+        timed_events& operator=(const timed_events&) = delete;
+
+
+        /// Post an event, from any thread other than the audio thread.
+        /// @param	value		The event.
+        /// @param	delay_in_ms	The time after now at which the event takes effect.
+        /// @return				False if the event was dropped because the queue is full, otherwise true.
+
+        bool post(const T& value, const double delay_in_ms = 0.0) {
+            double now;
+            max::clock_getftime(&now);
+
+            if (!m_fifo.try_enqueue({ now + std::max(delay_in_ms, 0.0), value })) {
+                ++m_dropped;
+                return false;
+            }
+            return true;
+        }
+
+
+        /// Collect the events that take effect in the vector that is about to be processed. Call this in the audio thread once per vector.
+        /// @param	frame_count		The number of frames in the vector.
+        /// @return					The events in the order of their offsets, which are in the range 0 to frame_count - 1.
+        ///							The reference is valid until the next call.
+
+        const std::vector<event>& due(const long frame_count) {
+            double now;
+            max::clock_getftime(&now);
+            if (!m_started) {
+                m_previous = now;
+                m_started  = true;
+            }
+
+            // keep the waiting events sorted by time, with events of the same time in the order they were posted
+
+            stamped posted;
+            while (m_pending.size() < m_pending.capacity() && m_fifo.try_dequeue(posted)) {
+                auto position = std::upper_bound(m_pending.begin(), m_pending.end(), posted.time, [](const double time, const stamped& e) {
+                    return time < e.time;
+                });
+                m_pending.insert(position, posted);
+            }
+
+            const auto elapsed { now - m_previous };
+            auto       end { m_pending.begin() };
+
+            m_due.clear();
+            for (; end != m_pending.end() && end->time <= now; ++end) {
+                auto offset { elapsed > 0.0 ? static_cast<long>((end->time - m_previous) / elapsed * frame_count) : 0L };
+                m_due.push_back({ std::clamp(offset, 0L, std::max(frame_count - 1, 0L)), end->value });
+            }
+            m_pending.erase(m_pending.begin(), end);
+            m_previous = now;
+            return m_due;
+        }
+
+
+        /// Split the vector that is about to be processed at the events that take effect in it. Call this in the audio thread once per vector.
+        /// @param	frame_count		The number of frames in the vector.
+        /// @param	apply			Called with each event, before the frames from its offset on are processed.
+        /// @param	process			Called with the first frame and the number of frames of each part of the vector between the events.
+
+        template<class apply_type, class process_type>
+        void split(const long frame_count, apply_type&& apply, process_type&& process) {
+            long start {};
+
+            for (const auto& e : due(frame_count)) {
+                if (e.offset > start) {
+                    process(start, e.offset - start);
+                    start = e.offset;
+                }
+                apply(e.value);
+            }
+            if (start < frame_count)
+                process(start, frame_count - start);
+        }
+
+
+        /// The number of events dropped because the queue was full.
+        /// @return	The count since the queue was created.
+
+        size_t dropped() const {
+            return m_dropped;
+        }
+
+    private:
+        struct stamped {
+            double  time {};     ///< the logical time in milliseconds at which the event takes effect
+            T       value {};
+        };
+
+        mpmc_fifo<stamped>      m_fifo;
+        std::atomic<size_t>     m_dropped {};
+        std::vector<stamped>    m_pending;           ///< only used by the audio thread
+        std::vector<event>      m_due;               ///< only used by the audio thread
+        double                  m_previous {};       ///< the time of the previous vector
+        bool                    m_started { false };
+    };
+
+
+}    // namespace c74::min
@@ -138,6 +138,11 @@ namespace c74::min {
                 m_qelem = max::qelem_new(m_timer_impl, reinterpret_cast<max::method>(timer_qfn_callback));
         }
 
+        // the Max object that is passed to the callbacks, e.g. to make it the owner of an ITM time object
+        max::t_object* impl() const {
+            return reinterpret_cast<max::t_object*>(m_timer_impl);
+        }
+
     private:
         object_base*  m_owner;
         function      m_function;
@@ -182,4 +187,511 @@ namespace c74::min {
     };
 
 
+    /// The transport_timer class schedules a function like the timer class, but the delay may be given in any of Max's time units:
+    /// milliseconds, note values such as "4n", bars.beats.units such as "1.0.0", or ticks such as "480 ticks".
+    /// The delay is scheduled by an ITM time object, so delays in tempo-relative units follow the tempo of the transport
+    /// (including changes while the timer is running) without being converted to milliseconds by the caller.
+    /// @tparam		options		Optional argument to alter the delivery from the scheduler thread to the main thread.
+    ///
+    ///	@seealso	#timer
+    ///	@seealso	#time_value
+
+    template<timer_options options = timer_options::deliver_on_scheduler>
+    class transport_timer : public timer_base {
+    public:
+        /// Create a transport timer.
+        /// @param	an_owner	The owning object for the timer. Typically you will pass `this`.
+        /// @param	a_function	A function to be executed when the timer is called.
+        ///						Typically the function is defined using a C++ lambda with the #MIN_FUNCTION signature.
+
+        transport_timer(object_base* an_owner, const function a_function)
+        : timer_base(an_owner, options, a_function) {
+            m_timeobj = static_cast<max::t_object*>(max::time_new(impl(), max::gensym("delaytime"),
+                reinterpret_cast<max::method>(timer_tick_callback), max::TIME_FLAGS_TICKSONLY | max::TIME_FLAGS_USECLOCK));
+        }
+
+        ~transport_timer() {
+            max::object_free(m_timeobj);
+        }
+
+        // Timers cannot be copied.
+        // If they are then the ownership of the internal time object becomes ambiguous.
+
+        transport_timer(const transport_timer&) = delete;
+        transport_timer& operator=(const transport_timer& value) = delete;
+
+
+        /// Set the timer to fire after a delay in any of Max's time units.
+        /// When the timer fires its function will be executed.
+        /// @param	interval	The length of the delay (from "now"), e.g. { "4n" }, { "1.0.0" } or { 480, "ticks" }.
+        ///						A single number is in milliseconds.
+
+        void delay(const atoms& interval) {
+            max::time_setvalue(m_timeobj, nullptr, static_cast<long>(interval.size()), const_cast<max::t_atom*>(static_cast<const max::t_atom*>(&interval[0])));
+            max::time_schedule(m_timeobj, nullptr);
+        }
+
+
+        /// Set the timer to fire after a delay in milliseconds.
+        /// @param	duration_in_ms	The length of the delay (from "now") before the timer fires.
+
+        void delay(const double duration_in_ms) {
+            delay(atoms { duration_in_ms });
+        }
+
+
+        /// Stop a timer that has been previously set using the delay() call.
+
+        void stop() {
+            max::time_stop(m_timeobj);
+        }
+
+
+        /// Return the current delay in milliseconds, at the current tempo for tempo-relative units.
+        /// @return	The delay in milliseconds.
+
+        double milliseconds() const {
+            return max::time_getms(m_timeobj);
+        }
+
+
+        /// Follow a named transport rather than the global one.
+        /// @param	name	The name of the transport.
+
+        void transport(const symbol name) {
+            max::object_attr_setsym(m_timeobj, max::gensym("transport"), name);
+        }
+
+    private:
+        max::t_object* m_timeobj { nullptr };
+    };
+
+
+    /// The multi_timer class schedules any number of events with a single timer, e.g. the note-offs of many notes.
+    /// Creating a timer for every event allocates a Max clock each time, which is costly when there are many events.
+    /// Instead the pending events are kept in a min-heap ordered by their onset, and the one timer is always set for the earliest.
+    /// The storage of the heap is kept when events are delivered, so once it has grown to the number of events pending at once
+    /// nothing is allocated anymore.
+    /// @tparam		T			The type of the data that is delivered with each event.
+    /// @tparam		options		Optional argument to alter the delivery from the scheduler thread to the main thread.
+    ///
+    /// @seealso	#timer
+
+    template<class T, timer_options options = timer_options::deliver_on_scheduler>
+    class multi_timer {
+    public:
+        using callback = std::function<void(const T&)>;
+
+
+        /// Create a multi_timer.
+        /// @param	an_owner	The owning object for the timer. Typically you will pass `this`.
+        /// @param	a_callback	A function to be executed with the data of each event when it is due.
+
+        multi_timer(object_base* an_owner, const callback& a_callback)
+        : m_callback { a_callback }
+        , m_timer { an_owner, MIN_FUNCTION {
+            deliver();
+            return {};
+        }}
+        {}
+
+
+        // Timers cannot be copied.
+        // If they are then the ownership of the internal t_clock becomes ambiguous.
+
+        multi_timer(const multi_timer&) = delete;
+        multi_timer& operator=(const multi_timer& value) = delete;
+
+
+        /// Reserve storage for a number of pending events, so that scheduling them does not allocate.
+        /// @param	count	The number of events.
+
+        void reserve(const size_t count) {
+            lock l { m_mutex };
+            m_events.reserve(count);
+        }
+
+
+        /// Schedule an event.
+        /// Events that are due at the same time are delivered in the order they were scheduled.
+        /// @param	duration_in_ms	The length of the delay (from "now") before the event is delivered.
+        /// @param	data			The data that the callback is executed with.
+
+        void delay(const double duration_in_ms, const T& data) {
+            lock l { m_mutex };
+
+            const auto onset { now() + std::max(duration_in_ms, 0.0) };
+            m_events.push_back({ onset, m_counter++, data });
+            std::push_heap(m_events.begin(), m_events.end(), later);
+
+            // the timer only needs to be moved if the new event is the earliest
+            if (m_events.front().order == m_counter - 1)
+                m_timer.delay(duration_in_ms);
+        }
+
+
+        /// Deliver all pending events immediately / synchronously, in the order they are due.
+
+        void flush() {
+            while (auto event = pop(std::numeric_limits<double>::infinity()))
+                m_callback(event->data);
+            m_timer.stop();
+        }
+
+
+        /// Discard all pending events without delivering them.
+
+        void clear() {
+            lock l { m_mutex };
+            m_events.clear();
+            m_timer.stop();
+        }
+
+
+        /// Return the number of pending events.
+        /// @return The number of events that have been scheduled but not yet delivered.
+
+        size_t size() {
+            lock l { m_mutex };
+            return m_events.size();
+        }
+
+    private:
+        struct event {
+            double      onset;
+            uint64_t    order;    ///< breaks ties between events with the same onset
+            T           data;
+        };
+
+        static bool later(const event& a, const event& b) {
+            return a.onset > b.onset || (a.onset == b.onset && a.order > b.order);
+        }
+
+        static double now() {
+            double time {};
+            max::clock_getftime(&time);
+            return time;
+        }
+
+        // The lock is released before the callback is executed, as the callback may schedule new events.
+
+        std::optional<event> pop(const double until) {
+            lock l { m_mutex };
+
+            if (m_events.empty() || m_events.front().onset > until)
+                return {};
+            std::pop_heap(m_events.begin(), m_events.end(), later);
+            auto e { std::move(m_events.back()) };
+            m_events.pop_back();
+            return e;
+        }
+
+        void deliver() {
+            const auto time { now() };
+
+            while (auto event = pop(time))
+                m_callback(event->data);
+
+            lock l { m_mutex };
+            if (!m_events.empty())
+                m_timer.delay(m_events.front().onset - time);
+        }
+
+        callback        m_callback;
+        mutex           m_mutex;
+        vector<event>   m_events;
+        uint64_t        m_counter {};
+        timer<options>  m_timer;
+    };
+
+
+    /// The timer_pool class recycles timers for short-lived callbacks that are each scheduled once.
+    /// A timer allocates a Max clock and further Max objects when it is created and frees them when it is destroyed.
+    /// The pool creates its timers in advance and lends one to each scheduled callback until it has fired or is stopped,
+    /// so scheduling a callback costs no more than setting a clock. If all timers are lent, the pool grows.
+    /// @tparam		options		Optional argument to alter the delivery from the scheduler thread to the main thread.
+    ///
+    /// @seealso	#timer
+    /// @seealso	#multi_timer
+
+    template<timer_options options = timer_options::deliver_on_scheduler>
+    class timer_pool {
+    public:
+        /// Identifies a callback scheduled with the pool, so that it can be stopped.
+        /// A handle remains safe to use after the callback has fired and its timer has been lent again.
+
+        struct handle {
+            size_t      index { std::numeric_limits<size_t>::max() };
+            uint64_t    generation {};
+        };
+
+
+        /// Create a pool of timers.
+        /// @param	an_owner		The owning object for the timers. Typically you will pass `this`.
+        /// @param	initial_count	The number of timers that are created in advance.
+
+        timer_pool(object_base* an_owner, const size_t initial_count = 16)
+        : m_owner { an_owner } {
+            lock l { m_mutex };
+            grow(initial_count);
+        }
+
+
+        // Timers cannot be copied.
+        // If they are then the ownership of the internal t_clock becomes ambiguous.
+
+        timer_pool(const timer_pool&) = delete;
+        timer_pool& operator=(const timer_pool& value) = delete;
+
+
+        /// Schedule a function to be executed once after a delay.
+        /// @param	duration_in_ms	The length of the delay (from "now") before the function is executed.
+        /// @param	a_function		The function to execute.
+        /// @return					A handle for stopping the function before it is executed.
+
+        handle delay(const double duration_in_ms, const function& a_function) {
+            lock l { m_mutex };
+
+            if (m_free.empty())
+                grow(std::max<size_t>(m_slots.size(), 1));
+
+            const auto index { m_free.back() };
+            m_free.pop_back();
+
+            auto& s    = *m_slots[index];
+            s.function = a_function;
+            s.busy     = true;
+            s.timer.delay(duration_in_ms);
+            return { index, s.generation };
+        }
+
+
+        /// Stop a function that has been scheduled, and return its timer to the pool.
+        /// @param	a_handle	The handle returned when the function was scheduled.
+        /// @return				True if the function was still pending. False if it has already been executed or stopped.
+
+        bool stop(const handle& a_handle) {
+            lock l { m_mutex };
+
+            if (a_handle.index >= m_slots.size())
+                return false;
+            auto& s = *m_slots[a_handle.index];
+            if (!s.busy || s.generation != a_handle.generation)
+                return false;
+
+            s.timer.stop();
+            release(a_handle.index);
+            return true;
+        }
+
+
+        /// Stop all scheduled functions.
+
+        void stop_all() {
+            lock l { m_mutex };
+
+            for (auto index = 0u; index < m_slots.size(); ++index) {
+                if (m_slots[index]->busy) {
+                    m_slots[index]->timer.stop();
+                    release(index);
+                }
+            }
+        }
+
+
+        /// Return the number of timers that are not lent.
+        /// @return The number of functions that can be scheduled before the pool grows.
+
+        size_t available() {
+            lock l { m_mutex };
+            return m_free.size();
+        }
+
+    private:
+        struct slot {
+            template<class fn_type>
+            slot(object_base* an_owner, fn_type&& a_fire)
+            : timer { an_owner, a_fire }
+            {}
+
+            c74::min::timer<options>    timer;
+            c74::min::function          function;
+            uint64_t                    generation {};
+            bool                        busy {};
+        };
+
+        void grow(const size_t count) {
+            for (auto i = 0u; i < count; ++i) {
+                const auto index { m_slots.size() };
+                m_slots.push_back(std::make_unique<slot>(m_owner, [this, index](const atoms&, const int) -> atoms {
+                    fire(index);
+                    return {};
+                }));
+                m_free.push_back(index);
+            }
+        }
+
+        void release(const size_t index) {
+            auto& s = *m_slots[index];
+            s.busy  = false;
+            ++s.generation;
+            m_free.push_back(index);
+        }
+
+        // The timer is returned to the pool before the function is executed, as the function may schedule new functions.
+
+        void fire(const size_t index) {
+            c74::min::function f;
+            {
+                lock l { m_mutex };
+                auto& s = *m_slots[index];
+                if (!s.busy)
+                    return;
+                f = std::move(s.function);
+                release(index);
+            }
+            atoms a;
+            f(a, -1);
+        }
+
+        object_base*                    m_owner;
+        mutex                           m_mutex;
+        vector<std::unique_ptr<slot>>   m_slots;    ///< the timers need stable addresses, as Max holds pointers to them
+        vector<size_t>                  m_free;     ///< indices of the timers that are not lent
+    };
+
+
+    /// The refresher class calls a function once per frame of the display, e.g. to animate a user interface object.
+    /// Giving each animated object a timer of its own wakes the main thread once for every object,
+    /// which adds up with hundreds of objects. Instead all refreshers share one timer, which calls the function of each
+    /// running refresher in turn, so any number of animated objects cost one wakeup per frame.
+    /// Refreshers are started, stopped and called on the main thread.
+    ///
+    /// @seealso	#timer
+
+    class refresher {
+    public:
+        /// The time between two frames in milliseconds.
+
+        static constexpr double k_frame_interval { 1000.0 / 60.0 };
+
+
+        /// Create a refresher, which is stopped until start() is called.
+        /// @param	an_owner	The owning object for the refresher. Typically you will pass `this`.
+        /// @param	a_function	A function to be executed once per frame while the refresher is running.
+        ///						Typically the function is defined using a C++ lambda with the #MIN_FUNCTION signature.
+
+        refresher(object_base* an_owner, const function& a_function)
+        : m_owner { an_owner }
+        , m_function { a_function }
+        {}
+
+
+        ~refresher() {
+            stop();
+        }
+
+
+        // Refreshers cannot be copied, as the shared timer holds pointers to them.
+
+        refresher(const refresher&) = delete;
+        refresher& operator=(const refresher& value) = delete;
+
+
+        /// Start calling the function with the next frame.
+        /// Nothing happens for the instance that is created when the class is registered, which is never shown.
+
+        void start() {
+            if (m_running || !m_owner->maxobj())
+                return;
+            m_running = true;
+            shared().add(this);
+        }
+
+
+        /// Stop calling the function. May be called from the function itself.
+
+        void stop() {
+            if (!m_running)
+                return;
+            m_running = false;
+            shared().remove(this);
+        }
+
+
+        /// Determine if the function is called with every frame.
+        /// @return		True if the refresher has been started and not stopped since.
+
+        bool running() const {
+            return m_running;
+        }
+
+    private:
+        // The timer is created for the object of the first refresher, but does not refer to that object afterwards,
+        // so it keeps running for the others when the object goes away. It is only freed when no refresher is left
+        // outside of a frame, as it must not be freed while it is delivering the frame.
+
+        struct service {
+            vector<refresher*>                                      members;    ///< stopped refreshers are null until the frame is delivered
+            std::unique_ptr<timer<timer_options::defer_delivery>>   frame;
+            bool                                                    scheduled { false };
+            bool                                                    delivering { false };
+
+            void add(refresher* r) {
+                members.push_back(r);
+                if (!frame) {
+                    frame = std::make_unique<timer<timer_options::defer_delivery>>(r->m_owner, [this](const atoms&, const int) -> atoms {
+                        deliver();
+                        return {};
+                    });
+                }
+                if (!scheduled && !delivering) {
+                    frame->delay(k_frame_interval);
+                    scheduled = true;
+                }
+            }
+
+            void remove(refresher* r) {
+                auto member = std::find(members.begin(), members.end(), r);
+                if (delivering)
+                    *member = nullptr;
+                else {
+                    members.erase(member);
+                    if (members.empty()) {
+                        frame.reset();
+                        scheduled = false;
+                    }
+                }
+            }
+
+            void deliver() {
+                scheduled  = false;
+                delivering = true;
+                for (size_t i = 0; i < members.size(); ++i) {    // refreshers started by a function are appended and called as well
+                    if (auto r = members[i]) {
+                        atoms a;
+                        r->m_function(a, -1);
+                    }
+                }
+                delivering = false;
+
+                members.erase(std::remove(members.begin(), members.end(), nullptr), members.end());
+                if (!members.empty()) {
+                    frame->delay(k_frame_interval);
+                    scheduled = true;
+                }
+            }
+        };
+
+        static service& shared() {
+            static service s_service;
+            return s_service;
+        }
+
+        object_base*    m_owner;
+        function        m_function;
+        bool            m_running { false };
+    };
+
+
 }    // namespace c74::min
@@ -67,4 +67,17 @@ namespace c74::max {
 
     extern "C" t_sequence* object_getoutput(void* o, int outletnum);
 
+
+    /// Advance the simulated time of the mock kernel, executing the timers, clocks and queues that become due.
+    /// Time does not pass by itself in unit tests, so timer-driven objects are tested without waiting.
+    /// @param	duration_in_ms	The time to advance. Zero executes only what is due now.
+    /// @return					The number of callbacks executed.
+
+    extern "C" uint64_t mock_clock_advance(double duration_in_ms);
+
+
+    /// The simulated time of the mock kernel in milliseconds, as returned by clock_getftime().
+
+    extern "C" double mock_clock_now();
+
 }    // namespace c74::max
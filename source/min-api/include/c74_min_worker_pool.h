@@ -0,0 +1,226 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include <condition_variable>
+#ifndef WIN_VERSION
+    #include <pthread.h>
+#endif
+
+namespace c74::min {
+
+
+    /// The scheduling priority of the threads of a worker_pool or a task_scheduler.
+
+    enum class thread_priority {
+        background,    ///< Below normal, for loading and analysis that must not compete with the user interface
+        normal,        ///< The default priority of new threads
+        realtime       ///< Elevated where the system permits it, for work on behalf of the audio thread
+    };
+
+
+    /// Set the scheduling priority of the calling thread.
+    /// Requests the system does not permit (e.g. real-time scheduling for an unprivileged process on Linux) are ignored.
+    /// @param	priority	The priority.
+
+    inline void set_current_thread_priority(const thread_priority priority) {
+#ifdef WIN_VERSION
+        const int levels[] { THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_TIME_CRITICAL };
+        SetThreadPriority(GetCurrentThread(), levels[static_cast<int>(priority)]);
+#else
+        if (priority == thread_priority::realtime) {
+            sched_param param {};
+            param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+            pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        }
+#ifdef __APPLE__
+        else if (priority == thread_priority::background)
+            pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#endif
+#endif
+    }
+
+
+    /// A small pool of worker threads for dividing the work of an audio vector or a matrix across several cores.
+    /// The thread calling parallel_for() participates in the work and returns only when all of it is complete,
+    /// which acts as a barrier at the end of each vector.
+    ///
+    /// Dispatching work does not allocate memory.
+    /// If the pool is already busy (e.g. it is being used by another audio thread) the work is performed serially
+    /// on the calling thread instead of waiting.
+
+    class worker_pool {
+    public:
+
+        /// Create a worker pool.
+        /// @param	thread_count	The number of worker threads in addition to the calling thread.
+        /// @param	priority		The scheduling priority of the worker threads.
+
+        explicit worker_pool(const size_t thread_count, const thread_priority priority = thread_priority::normal)
+        : m_priority { priority } {
+            m_threads.reserve(thread_count);
+            for (auto i = 0u; i < thread_count; ++i)
+                m_threads.emplace_back(&worker_pool::run, this);
+        }
+
+
+        ~worker_pool() {
+            m_running = false;
+            m_task_count.store(0, std::memory_order_relaxed);
+            publish(++m_generation);
+
+            for (auto& t : m_threads)
+                t.join();
+        }
+
+
+        worker_pool(const worker_pool&) = delete;
+        worker_pool& operator=(const worker_pool&) = delete;
+
+
+        /// Get the pool shared by all Min externals in the process, which is the real-time lane of the shared task_scheduler.
+        /// The pool is created on the first call, which should happen on the main thread (e.g. when an attribute is set).
+        /// @return	A reference to the shared pool.
+
+        static worker_pool& shared();    // defined in c74_min_task_scheduler.h
+
+
+        /// The number of worker threads for a pool that divides audio work: leave cores for the main thread and the rest of the system.
+        /// @return	The number of worker threads.
+
+        static size_t default_thread_count() {
+            const auto cores { std::thread::hardware_concurrency() };
+            return cores > 2 ? std::min<size_t>(cores - 2, 4) : 0;
+        }
+
+
+        /// The number of worker threads in the pool, excluding the calling thread.
+        /// @return	The number of worker threads.
+
+        size_t thread_count() const {
+            return m_threads.size();
+        }
+
+
+        /// Call a function for each index in a range, dividing the indices among the worker threads and the calling thread.
+        /// @param	count	The number of indices.
+        /// @param	f		The function to call, which takes a size_t index as its only argument.
+        ///					It must be safe to call this function concurrently for different indices.
+
+        template<class function_type>
+        void parallel_for(const size_t count, function_type&& f) {
+            if (count == 0)
+                return;
+
+            bool expected { false };
+            if (count == 1 || m_threads.empty() || !m_busy.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                for (auto i = 0u; i < count; ++i)
+                    f(i);
+                return;
+            }
+
+            m_task_context = &f;
+            m_task = [](void* context, const size_t index) {
+                (*static_cast<typename std::remove_reference<function_type>::type*>(context))(index);
+            };
+            m_task_count.store(count, std::memory_order_relaxed);
+            m_remaining.store(count, std::memory_order_relaxed);
+
+            const auto generation { ++m_generation };
+            publish(generation);
+            perform_tasks(generation);
+
+            while (m_remaining.load(std::memory_order_acquire) > 0)
+                std::this_thread::yield();
+
+            m_busy.store(false, std::memory_order_release);
+        }
+
+    private:
+        static constexpr int    k_spin_count { 20000 };    // iterations a worker spins before it sleeps while waiting for work
+
+
+        // The claim packs the generation of the current work into the upper 32 bits and the next unclaimed index into the lower 32 bits.
+        // Claiming an index therefore fails for a worker that is still looking at a previous generation.
+
+        static uint32_t generation_of(const uint64_t claim) {
+            return static_cast<uint32_t>(claim >> 32);
+        }
+
+
+        void publish(const uint32_t generation) {
+            m_claim.store(static_cast<uint64_t>(generation) << 32);
+            if (m_sleeping.load() > 0) {
+                std::lock_guard<std::mutex> lock { m_mutex };
+                m_condition.notify_all();
+            }
+        }
+
+
+        void perform_tasks(const uint32_t generation) {
+            auto claim { m_claim.load(std::memory_order_acquire) };
+
+            for (;;) {
+                if (generation_of(claim) != generation)
+                    return;
+
+                const auto index { static_cast<size_t>(claim & 0xffffffff) };
+                if (index >= m_task_count.load(std::memory_order_relaxed))
+                    return;
+
+                if (!m_claim.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                    continue;
+
+                m_task(m_task_context, index);
+                m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+                claim = m_claim.load(std::memory_order_acquire);
+            }
+        }
+
+
+        void run() {
+            set_current_thread_priority(m_priority);
+            auto seen { generation_of(m_claim.load()) };
+
+            for (;;) {
+                auto spins { 0 };
+                while (generation_of(m_claim.load(std::memory_order_acquire)) == seen && spins < k_spin_count)
+                    ++spins;
+
+                if (generation_of(m_claim.load()) == seen) {
+                    std::unique_lock<std::mutex> lock { m_mutex };
+                    ++m_sleeping;
+                    m_condition.wait(lock, [&] {
+                        return generation_of(m_claim.load()) != seen;
+                    });
+                    --m_sleeping;
+                }
+
+                seen = generation_of(m_claim.load(std::memory_order_acquire));
+                if (!m_running)
+                    break;
+                perform_tasks(seen);
+            }
+        }
+
+        using task_type = void (*)(void*, size_t);
+
+        thread_priority             m_priority;
+        vector<std::thread>         m_threads;
+        std::mutex                  m_mutex;
+        std::condition_variable     m_condition;
+        std::atomic<bool>           m_running { true };
+        std::atomic<bool>           m_busy { false };
+        std::atomic<uint64_t>       m_claim { 0 };
+        std::atomic<int>            m_sleeping { 0 };
+        std::atomic<size_t>         m_task_count { 0 };
+        std::atomic<size_t>         m_remaining { 0 };
+        uint32_t                    m_generation { 0 };    // only modified by the thread that holds m_busy
+        task_type                   m_task { nullptr };
+        void*                       m_task_context { nullptr };
+    };
+
+}    // namespace c74::min
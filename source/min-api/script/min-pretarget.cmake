@@ -25,6 +25,13 @@ file(GLOB_RECURSE C74_MIN_HEADERS ${CMAKE_CURRENT_LIST_DIR}/../include/*.h)
 
 add_definitions(-DC74_MIN_API)
 
+# Refpages are generated at build time (see test/min-object-docs.cmake).
+# Turn this on during development to also have each external update its refpage when Max registers its class.
+option(C74_MIN_DOC_UPDATE "Update the refpage of each external when its class is registered in Max (slows the launch of Max)" OFF)
+if (C74_MIN_DOC_UPDATE)
+    add_definitions(-DC74_MIN_WITH_DOC_UPDATE)
+endif ()
+
 if (EXISTS "${CMAKE_CURRENT_LIST_DIR}/../../min-lib")
     message(STATUS "Min-Lib found")
     add_definitions(
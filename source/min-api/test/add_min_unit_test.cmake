@@ -129,4 +129,120 @@ function(add_unit_test_impl target)
 	endif ()
 
 	add_test(NAME ${target} COMMAND ${target})
-endfunction()
\ No newline at end of file
+endfunction()
+
+
+# Add a benchmark target with given name from given sources files. The benchmark is linked to the mock kernel like a unit test,
+# but it is not added as a test. Instead it is added to the min_bench target, which builds all benchmarks.
+#
+# Call example:
+#
+# add_benchmark(my_random_bench
+#     SOURCES
+#         random_bench.cpp
+#     OUTPUT_DIRECTORY
+#         ../tests
+# )
+
+function(add_benchmark target)
+	set(oneValueArgs OUTPUT_DIRECTORY)
+	set(multiValueArgs SOURCES)
+	cmake_parse_arguments(PARSE_ARGV 0 PARAMS "${options}" "${oneValueArgs}" "${multiValueArgs}")
+
+	c74_max_pre_project_calls()
+	c74_max_post_project_calls()
+	add_definitions(-DC74_MIN_API)
+	add_definitions(-DC74_USE_MIN_LIB)
+
+	set(CMAKE_RUNTIME_OUTPUT_DIRECTORY "${PARAMS_OUTPUT_DIRECTORY}")
+	set(CMAKE_RUNTIME_OUTPUT_DIRECTORY_DEBUG "${CMAKE_RUNTIME_OUTPUT_DIRECTORY}")
+	set(CMAKE_RUNTIME_OUTPUT_DIRECTORY_RELEASE "${CMAKE_RUNTIME_OUTPUT_DIRECTORY}")
+
+	add_executable(${target} ${PARAMS_SOURCES})
+	add_dependencies(${target} mock_kernel)
+	target_compile_definitions(${target} PUBLIC -DMIN_TEST)
+
+	set_target_properties(${target} PROPERTIES FOLDER "Benchmarks")
+	set_target_properties(${target} PROPERTIES CXX_STANDARD 17)
+	set_target_properties(${target} PROPERTIES CXX_STANDARD_REQUIRED ON)
+
+	target_link_libraries(${target} PUBLIC "mock_kernel")
+	target_link_libraries(${target} PRIVATE max-sdk-base-headers min-api min-api-test)
+
+	if (APPLE)
+		set_target_properties(${target} PROPERTIES LINK_FLAGS "-Wl,-F'${MAX_SDK_JIT_INCLUDES}', -weak_framework JitterAPI")
+	endif ()
+	if (WIN32)
+		set_target_properties(${target} PROPERTIES COMPILE_PDB_NAME ${target})
+	endif ()
+
+	if (NOT TARGET min_bench)
+		add_custom_target(min_bench)
+		set_target_properties(min_bench PROPERTIES FOLDER "Benchmarks")
+	endif ()
+	add_dependencies(min_bench ${target})
+endfunction()
+
+
+# Add a refpage generator target with given name from the sources of an object. The generator is linked to the mock kernel like a unit test
+# and is run after it is built, writing the refpage of the object to the docs directory. It is also added to the min_docs target,
+# which builds and runs all generators.
+#
+# Call example:
+#
+# add_doc_generator(my_random_docs
+#     SOURCES
+#         random.cpp
+#     OUTPUT_DIRECTORY
+#         ../tests
+#     DOCS_DIRECTORY
+#         ../docs
+# )
+
+function(add_doc_generator target)
+	set(oneValueArgs OUTPUT_DIRECTORY DOCS_DIRECTORY)
+	set(multiValueArgs SOURCES)
+	cmake_parse_arguments(PARSE_ARGV 0 PARAMS "${options}" "${oneValueArgs}" "${multiValueArgs}")
+
+	c74_max_pre_project_calls()
+	c74_max_post_project_calls()
+	add_definitions(-DC74_MIN_API)
+	add_definitions(-DC74_USE_MIN_LIB)
+
+	set(CMAKE_RUNTIME_OUTPUT_DIRECTORY "${PARAMS_OUTPUT_DIRECTORY}")
+	set(CMAKE_RUNTIME_OUTPUT_DIRECTORY_DEBUG "${CMAKE_RUNTIME_OUTPUT_DIRECTORY}")
+	set(CMAKE_RUNTIME_OUTPUT_DIRECTORY_RELEASE "${CMAKE_RUNTIME_OUTPUT_DIRECTORY}")
+
+	get_filename_component(DOCS_DIRECTORY "${PARAMS_DOCS_DIRECTORY}" ABSOLUTE)
+	file(MAKE_DIRECTORY "${DOCS_DIRECTORY}")
+
+	add_executable(${target} ${PARAMS_SOURCES} "${C74_MIN_API_DIR}/test/min_doc_generator.cpp")
+	add_dependencies(${target} mock_kernel)
+	target_compile_definitions(${target} PUBLIC -DMIN_TEST "C74_MIN_DOC_GENERATOR=\"${DOCS_DIRECTORY}\"")
+
+	set_target_properties(${target} PROPERTIES FOLDER "Docs")
+	set_target_properties(${target} PROPERTIES CXX_STANDARD 17)
+	set_target_properties(${target} PROPERTIES CXX_STANDARD_REQUIRED ON)
+
+	target_link_libraries(${target} PUBLIC "mock_kernel")
+	target_link_libraries(${target} PRIVATE max-sdk-base-headers min-api)
+
+	if (APPLE)
+		set_target_properties(${target} PROPERTIES LINK_FLAGS "-Wl,-F'${MAX_SDK_JIT_INCLUDES}', -weak_framework JitterAPI")
+	endif ()
+	if (WIN32)
+		set_target_properties(${target} PROPERTIES COMPILE_PDB_NAME ${target})
+	endif ()
+
+	add_custom_command(TARGET ${target} POST_BUILD
+		COMMAND ${target}
+		WORKING_DIRECTORY "${PARAMS_OUTPUT_DIRECTORY}"
+		COMMENT "Generating the refpage with ${target}"
+	)
+
+	if (NOT TARGET min_docs)
+		add_custom_target(min_docs)
+		set_target_properties(min_docs PROPERTIES FOLDER "Docs")
+	endif ()
+	add_dependencies(min_docs ${target})
+endfunction()
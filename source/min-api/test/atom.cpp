@@ -96,3 +96,93 @@ TEST_CASE( "Atom Class", "[atoms]" ) {
 	}
 
 }
+
+
+TEST_CASE( "Atoms Inline Storage", "[atoms]" ) {
+
+	SECTION("short sequences are stored inline") {
+		c74::min::atoms	as = { 1, 2.0, "three", 4 };
+
+		REQUIRE( as.is_inline() );
+		REQUIRE( as.capacity() == c74::min::k_atoms_inline_capacity );
+		REQUIRE( (int)as[0] == 1 );
+		REQUIRE( (double)as[1] == 2.0 );
+		REQUIRE( (int)as[3] == 4 );
+	}
+
+	SECTION("long sequences move to the heap and keep their values") {
+		c74::min::atoms	as;
+
+		for (auto i = 0; i < 20; ++i)
+			as.push_back(i);
+
+		REQUIRE( !as.is_inline() );
+		REQUIRE( as.size() == 20 );
+		for (auto i = 0; i < 20; ++i)
+			REQUIRE( (int)as[i] == i );
+
+		as.resize(3);
+		as.shrink_to_fit();
+		REQUIRE( as.is_inline() );
+		REQUIRE( (int)as[2] == 2 );
+	}
+
+	SECTION("copies and moves") {
+		c74::min::atoms	a = { 1, 2, 3 };
+		c74::min::atoms	b { a };
+		c74::min::atoms	c { std::move(a) };
+
+		REQUIRE( b == c );
+		REQUIRE( a.empty() );
+
+		b.insert(b.begin(), b.back());
+		REQUIRE( b.size() == 4 );
+		REQUIRE( (int)b[0] == 3 );
+		REQUIRE( (int)b[1] == 1 );
+
+		b.erase(b.begin());
+		REQUIRE( b == c );
+	}
+
+}
+
+
+TEST_CASE( "Atom Span", "[atoms]" ) {
+
+	SECTION("a span views atoms from Max without copying them") {
+		c74::max::t_atom	av[3];
+
+		c74::max::atom_setlong(av + 0, 1);
+		c74::max::atom_setfloat(av + 1, 2.5);
+		c74::max::atom_setsym(av + 2, c74::max::gensym("three"));
+
+		c74::min::atom_span	span { av, 3 };
+
+		REQUIRE( span.size() == 3 );
+		REQUIRE( span.data() == av );
+		REQUIRE( (int)span[0] == 1 );
+		REQUIRE( (double)span[1] == 2.5 );
+		REQUIRE( span.back() == c74::min::symbol("three") );
+	}
+
+	SECTION("a span can be viewed in part or copied to atoms") {
+		c74::min::atoms		as = { 1, 2, 3, 4 };
+		c74::min::atom_span	span { as };
+		auto				tail = span.subspan(2);
+
+		REQUIRE( tail.size() == 2 );
+		REQUIRE( (int)tail.front() == 3 );
+		REQUIRE( span.subspan(5).empty() );
+
+		c74::min::atoms		copy(span.begin(), span.end());
+		REQUIRE( copy == as );
+	}
+
+	SECTION("an empty span") {
+		c74::min::atom_span	span;
+
+		REQUIRE( span.empty() );
+		REQUIRE( span.begin() == span.end() );
+	}
+
+}
@@ -0,0 +1,95 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+static std::vector<double> test_kernel() {
+    std::vector<double> kernel(4096, 0.0);
+    for (size_t i = 0; i < 256; ++i)
+        kernel[i] = std::sin(i * 0.1) / (i + 1);
+    return kernel;
+}
+
+
+TEST_CASE( "Binary State", "[binary_state]" ) {
+
+    SECTION("values and arrays round-trip through the text, with and without compression") {
+        const auto kernel { test_kernel() };
+
+        for (auto compression : { binary_compression::none, binary_compression::lz }) {
+            binary_state saved;
+            saved.compression(compression);
+            saved.write(kernel.size());
+            saved.write(kernel.data(), kernel.size());
+            saved.write(int32_t { -7 });
+
+            binary_state loaded;
+            REQUIRE( loaded.decode(saved.encode().c_str()) );
+            REQUIRE( loaded.compression() == compression );
+            REQUIRE( loaded.size() == saved.size() );
+
+            size_t size {};
+            REQUIRE( loaded.read(size) );
+            REQUIRE( size == kernel.size() );
+
+            std::vector<double> recalled(size);
+            REQUIRE( loaded.read(recalled.data(), size) );
+            REQUIRE( recalled == kernel );
+
+            int32_t last {};
+            REQUIRE( loaded.read(last) );
+            REQUIRE( last == -7 );
+            REQUIRE( loaded.remaining() == 0 );
+            REQUIRE_FALSE( loaded.read(last) );
+        }
+    }
+
+    SECTION("compression shrinks sparse data") {
+        const auto      kernel { test_kernel() };
+        binary_state    plain;
+        binary_state    compressed;
+
+        plain.write(kernel.data(), kernel.size());
+        compressed.write(kernel.data(), kernel.size());
+        compressed.compression(binary_compression::lz);
+        REQUIRE( compressed.encode().size() * 4 < plain.encode().size() );
+    }
+
+    SECTION("every length of the last base64 group round-trips") {
+        for (uint8_t n = 0; n < 8; ++n) {
+            binary_state saved;
+            for (uint8_t i = 0; i < n; ++i)
+                saved.write(i);
+
+            binary_state loaded;
+            REQUIRE( loaded.decode(saved.encode().c_str()) );
+            REQUIRE( loaded.size() == n );
+            for (uint8_t i = 0; i < n; ++i) {
+                uint8_t value {};
+                REQUIRE( loaded.read(value) );
+                REQUIRE( value == i );
+            }
+        }
+    }
+
+    SECTION("damaged text is rejected") {
+        binary_state saved;
+        saved.compression(binary_compression::lz);
+        for (auto i = 0; i < 100; ++i)
+            saved.write(i % 10);
+        auto text { saved.encode() };
+
+        binary_state loaded;
+        REQUIRE_FALSE( loaded.decode("") );
+        REQUIRE_FALSE( loaded.decode("x12:AAAA") );
+        REQUIRE_FALSE( loaded.decode("n4:AA*A") );
+        REQUIRE_FALSE( loaded.decode("n5:AAAAAA==") );
+        REQUIRE_FALSE( loaded.decode(text.substr(0, text.size() - 4).c_str()) );
+        REQUIRE( loaded.size() == 0 );
+    }
+}
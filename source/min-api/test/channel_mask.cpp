@@ -0,0 +1,66 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "enabling and disabling channels", "[channel_mask]" ) {
+    channel_mask mask;
+
+    REQUIRE( mask.enabled(0) );
+    REQUIRE( mask.enabled(1023) );
+    REQUIRE( mask.enabled_count(100) == 100 );
+
+    mask.enable(3, false);
+    mask.enable(64, false);
+    REQUIRE( !mask.enabled(3) );
+    REQUIRE( !mask.enabled(64) );
+    REQUIRE( mask.enabled(63) );
+    REQUIRE( mask.enabled_count(100) == 98 );
+
+    mask.enable(3);
+    REQUIRE( mask.enabled(3) );
+
+    mask.enable_first(70);
+    REQUIRE( mask.enabled(63) );
+    REQUIRE( mask.enabled(64) );
+    REQUIRE( mask.enabled(69) );
+    REQUIRE( !mask.enabled(70) );
+    REQUIRE( !mask.enabled(1023) );
+    REQUIRE( mask.enabled_count(128) == 70 );
+
+    mask.enable_first(0);
+    REQUIRE( mask.enabled_count(1024) == 0 );
+
+    mask.enable_first(2000);
+    REQUIRE( mask.enabled_count(1024) == 1024 );
+
+    // channels beyond the capacity cannot be disabled
+
+    mask.enable(channel_mask::k_capacity, false);
+    REQUIRE( mask.enabled(channel_mask::k_capacity) );
+}
+
+
+TEST_CASE( "audio bundles carry the mask", "[channel_mask]" ) {
+    std::vector<double> left(8, 1.0);
+    std::vector<double> right(8, 1.0);
+    double*             channels[2] { left.data(), right.data() };
+    audio_bundle        bundle { channels, 2, 8 };
+    channel_mask        mask;
+
+    REQUIRE( bundle.channel_enabled(0) );
+    REQUIRE( bundle.channel_enabled(1) );
+
+    mask.enable_first(1);
+    bundle.channel_mask(&mask);
+    REQUIRE( bundle.channel_enabled(0) );
+    REQUIRE( !bundle.channel_enabled(1) );
+
+    mask.enable(1);
+    REQUIRE( bundle.channel_enabled(1) );
+}
@@ -0,0 +1,76 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include <numeric>
+
+
+TEST_CASE( "Collector", "[collector]" ) {
+
+    SECTION("items are taken out in the order appended, and only once") {
+        c74::min::collector<int>    c { 8 };
+        int                         in[3] { 1, 2, 3 };
+        std::vector<int>            out;
+
+        c.append(in, 3);
+        c.append(in, 2);
+        c.take([&out](std::vector<int>& items) { out = items; });
+        REQUIRE( out == std::vector<int> { 1, 2, 3, 1, 2 } );
+
+        out.clear();
+        c.take([&out](std::vector<int>& items) { out = items; });
+        REQUIRE( out.empty() );
+    }
+
+    SECTION("more items than fit into a segment are chained and joined") {
+        c74::min::collector<int>    c { 4 };
+        std::vector<int>            in(10);
+        std::vector<int>            out;
+
+        std::iota(in.begin(), in.end(), 0);
+        c.append(in.data(), 3);
+        c.append(in.data() + 3, 3);     // does not fit into the first segment
+        c.append(in.data() + 6, 4);
+        c.take([&out](std::vector<int>& items) { out = items; });
+        REQUIRE( out == in );
+    }
+
+    SECTION("nothing is lost when several threads append while items are taken out") {
+        c74::min::collector<int>    c { 64 };
+        const int                   thread_count { 4 };
+        const int                   per_thread { 20000 };
+        std::atomic<bool>           done { false };
+        std::vector<int>            counts(thread_count);
+
+        std::vector<std::thread> producers;
+        for (auto t = 0; t < thread_count; ++t) {
+            producers.emplace_back([&c, t] {
+                for (auto i = 0; i < per_thread; ++i)
+                    c.append(&t, 1);
+            });
+        }
+
+        std::thread consumer { [&] {
+            while (!done) {
+                c.take([&counts](std::vector<int>& items) {
+                    for (auto t : items)
+                        ++counts[t];
+                });
+            }
+        }};
+
+        for (auto& p : producers)
+            p.join();
+        done = true;
+        consumer.join();
+        c.take([&counts](std::vector<int>& items) {
+            for (auto t : items)
+                ++counts[t];
+        });
+
+        for (auto t = 0; t < thread_count; ++t)
+            REQUIRE( counts[t] == per_thread );
+    }
+}
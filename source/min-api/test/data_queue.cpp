@@ -0,0 +1,57 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+
+TEST_CASE( "Data Queue", "[data_queue]" ) {
+
+    SECTION("every value is delivered in order, and values that do not fit are dropped") {
+        std::vector<int>                    delivered;
+        c74::min::data_queue<int>           queue { nullptr, [&](const int& x) { delivered.push_back(x); }, 4 };
+
+        for (auto i = 0; i < 4; ++i)
+            REQUIRE( queue.push(i) );
+
+        // the fifo may round its capacity up, so push until it is full
+        auto pushed { 4 };
+        while (queue.push(pushed))
+            ++pushed;
+        REQUIRE( queue.dropped() == 1 );
+
+        queue.deliver();
+        REQUIRE( delivered.size() == static_cast<size_t>(pushed) );
+        for (auto i = 0; i < pushed; ++i)
+            REQUIRE( delivered[i] == i );
+
+        queue.deliver();
+        REQUIRE( delivered.size() == static_cast<size_t>(pushed) );
+    }
+
+    SECTION("with coalescing only the latest value is delivered") {
+        using c74::min::queue_coalescing;
+
+        std::vector<double>                                         delivered;
+        c74::min::data_queue<double, queue_coalescing::latest>      queue { nullptr, [&](const double& x) { delivered.push_back(x); } };
+
+        queue.deliver();
+        REQUIRE( delivered.empty() );
+
+        for (auto i = 0; i < 100; ++i)
+            REQUIRE( queue.push(i * 0.5) );
+        queue.deliver();
+        queue.deliver();
+        REQUIRE( delivered.size() == 1 );
+        REQUIRE( delivered[0] == 49.5 );
+
+        queue.push(1.0);
+        queue.push(2.0);
+        queue.deliver();
+        REQUIRE( delivered.size() == 2 );
+        REQUIRE( delivered[1] == 2.0 );
+        REQUIRE( queue.dropped() == 0 );
+    }
+
+}
@@ -0,0 +1,61 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+using namespace c74::min::dataspace;
+
+
+TEST_CASE( "converting time units", "[dataspace]" ) {
+
+    SECTION( "arithmetic conversions are constant expressions" ) {
+        static_assert(time::convert<time::milliseconds, time::seconds>(250.0) == 0.25);
+        static_assert(time::convert<time::hertz, time::milliseconds>(4.0) == 250.0);
+        static_assert(time::convert<time::bpm, time::hertz>(120.0) == 2.0);
+        static_assert(gain::convert<gain::linear, gain::linear>(0.5) == 0.5);
+    }
+
+    SECTION( "fused conversions match the conversion through the neutral unit" ) {
+        REQUIRE( time::convert<time::midi, time::hertz>(69.0) == Approx(440.0) );
+        REQUIRE( time::convert<time::midi, time::hertz>(81.0) == Approx(880.0) );
+        REQUIRE( time::convert<time::hertz, time::midi>(220.0) == Approx(57.0) );
+        REQUIRE( time::convert<time::midi, time::cents>(60.0) == Approx(6000.0) );
+        REQUIRE( time::convert<time::cents, time::midi>(6950.0) == Approx(69.5) );
+        REQUIRE( time::convert<time::milliseconds, time::midi>(1000.0 / 440.0) == Approx(69.0) );
+        REQUIRE( time::convert<time::midi, time::bpm>(69.0) == Approx(440.0 * 60.0) );
+        REQUIRE( time::convert<time::speed, time::midi>(2.0) == Approx(12.0) );
+        REQUIRE( time::convert<time::midi, time::speed>(-12.0) == Approx(0.5) );
+    }
+
+    SECTION( "conversions without a fused form" ) {
+        REQUIRE( time::convert<time::hertz, time::mel>(1000.0) == Approx(1000.0).epsilon(0.001) );
+        REQUIRE( time::convert<time::mel, time::midi>(time::convert<time::midi, time::mel>(60.0)) == Approx(60.0) );
+    }
+}
+
+
+TEST_CASE( "converting gain units", "[dataspace]" ) {
+    REQUIRE( gain::convert<gain::linear, gain::db>(1.0) == Approx(0.0).margin(1e-12) );
+    REQUIRE( gain::convert<gain::linear, gain::db>(0.5) == Approx(-6.0206) );
+    REQUIRE( gain::convert<gain::db, gain::linear>(-20.0) == Approx(0.1) );
+    REQUIRE( gain::convert<gain::midi, gain::linear>(100.0) == Approx(1.0) );
+    REQUIRE( gain::convert<gain::midi, gain::db>(127.0) == Approx(10.0) );
+    REQUIRE( gain::convert<gain::db, gain::midi>(10.0) == Approx(127.0) );
+
+    SECTION( "decibels are limited to the 24 bit range" ) {
+        REQUIRE( gain::convert<gain::linear, gain::db>(0.0) == Approx(-144.49) );
+        REQUIRE( gain::convert<gain::midi, gain::db>(0.0) == Approx(-144.49) );
+    }
+
+    SECTION( "a block is converted as the single values" ) {
+        std::vector<number> x { 0.0, 1.0, 50.0, 100.0, 127.0 };
+        std::vector<number> y(x.size());
+
+        gain::convert<gain::midi, gain::db>(x.data(), y.data(), x.size());
+        for (auto i = 0u; i < x.size(); ++i)
+            REQUIRE( y[i] == gain::convert<gain::midi, gain::db>(x[i]) );
+    }
+}
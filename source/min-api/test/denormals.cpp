@@ -0,0 +1,61 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+namespace {
+
+    // read through volatile, so that the compiler neither folds the product nor moves it out of the scope of a guard
+
+    volatile double smallest_normal { std::numeric_limits<double>::min() };
+
+    double halve_smallest_normal() {
+        return smallest_normal * 0.5;
+    }
+
+    class denormal_filter {
+    public:
+        MIN_FLUSH_DENORMALS { false };
+    };
+
+    class filter {};
+
+}
+
+
+TEST_CASE( "flushing denormals", "[denormals]" ) {
+    REQUIRE( halve_smallest_normal() > 0.0 );
+
+    SECTION( "denormal results are flushed within the scope and restored after it" ) {
+        {
+            denormal_guard<> flushing;
+
+            if (denormal_guard<>::supported)
+                REQUIRE( halve_smallest_normal() == 0.0 );
+
+            {
+                denormal_guard<> nested;
+            }
+            if (denormal_guard<>::supported)
+                REQUIRE( halve_smallest_normal() == 0.0 );
+        }
+        REQUIRE( halve_smallest_normal() > 0.0 );
+    }
+
+    SECTION( "a disabled guard does nothing" ) {
+        denormal_guard<false> flushing;
+
+        REQUIRE( !denormal_guard<false>::supported );
+        REQUIRE( halve_smallest_normal() > 0.0 );
+    }
+
+    SECTION( "classes flush denormals unless they declare otherwise" ) {
+        static_assert(class_flushes_denormals<filter>());
+        static_assert(!class_flushes_denormals<denormal_filter>());
+    }
+}
@@ -0,0 +1,96 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+
+TEST_CASE( "Dispatch Table", "[dispatch]" ) {
+
+    SECTION("items are found by symbol, string or c-string") {
+        c74::min::dispatch_table<int>   table;
+        int                             a { 1 };
+        int                             b { 2 };
+
+        table["alpha"] = &a;
+        table[std::string("beta")] = &b;
+
+        REQUIRE( table.size() == 2 );
+        REQUIRE( table[c74::min::symbol("alpha")] == &a );
+        REQUIRE( table.find(c74::max::gensym("beta"))->second == &b );
+        REQUIRE( table.find("gamma") == table.end() );
+        REQUIRE( table.size() == 2 );
+    }
+
+    SECTION("iteration follows the order of insertion and survives growth") {
+        c74::min::dispatch_table<int>   table;
+        std::vector<int>                values(100);
+
+        for (auto i = 0; i < 100; ++i) {
+            values[i] = i;
+            table[std::to_string(i)] = &values[i];
+        }
+
+        REQUIRE( table.size() == 100 );
+
+        auto i = 0;
+        for (const auto& entry : table) {
+            REQUIRE( entry.first == std::to_string(i) );
+            REQUIRE( *entry.second == i );
+            ++i;
+        }
+
+        for (auto j = 0; j < 100; ++j)
+            REQUIRE( table.find(std::to_string(j))->second == &values[j] );
+    }
+
+    SECTION("the [] operator adds an empty entry for a missing name") {
+        c74::min::dispatch_table<int>   table;
+
+        REQUIRE( table["missing"] == nullptr );
+        REQUIRE( table.size() == 1 );
+        REQUIRE( table.find("missing") != table.end() );
+    }
+
+    SECTION("tables share the names of a layout once it is sealed") {
+        c74::min::dispatch_table<int>::layout   layout;
+        int                                     a { 1 };
+        int                                     b { 2 };
+        int                                     c { 3 };
+
+        c74::min::dispatch_table<int>   first;
+        first.share(layout);
+        first["alpha"] = &a;
+        first["beta"] = &b;
+
+        INFO("a table that shares the layout while it is being built keeps its own names");
+        c74::min::dispatch_table<int>   early;
+        early.share(layout);
+        early["gamma"] = &c;
+        REQUIRE( early.size() == 1 );
+
+        first.seal();
+        REQUIRE( layout.size() == 2 );
+
+        c74::min::dispatch_table<int>   second;
+        second.share(layout);
+        REQUIRE( second.size() == 2 );
+        REQUIRE( second["alpha"] == nullptr );
+
+        second["alpha"] = &b;
+        second["beta"] = &a;
+        REQUIRE( second.find("alpha")->second == &b );
+        REQUIRE( first.find("alpha")->second == &a );
+        REQUIRE( layout.size() == 2 );
+
+        INFO("adding a name the layout does not have leaves the layout unchanged");
+        second["gamma"] = &c;
+        REQUIRE( second.size() == 3 );
+        REQUIRE( second.find("gamma")->second == &c );
+        REQUIRE( second.find("beta")->second == &a );
+        REQUIRE( layout.size() == 2 );
+        REQUIRE( first.find("gamma") == first.end() );
+    }
+
+}
@@ -0,0 +1,65 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "Float Array", "[float_array]" ) {
+
+    SECTION("copies share the values") {
+        float_array a(3, 1.0);
+        float_array b { a };
+
+        b[1] = 2.0;
+        REQUIRE( a.size() == 3 );
+        REQUIRE( a[1] == 2.0 );
+        REQUIRE( a.data() == b.data() );
+        REQUIRE( float_array {}.empty() );
+    }
+
+    SECTION("an array is converted to a list") {
+        const float_array a { vector<double> {1.0, 2.5} };
+        const auto        as { a.to_atoms() };
+
+        REQUIRE( as.size() == 2 );
+        REQUIRE( static_cast<double>(as[1]) == 2.5 );
+    }
+
+    SECTION("a published array is found by its name") {
+        const float_array   a { vector<double> {1.0, 2.0, 3.0} };
+        symbol              name;
+
+        {
+            float_array_publisher publisher;
+
+            name = publisher.publish(a);
+            REQUIRE( float_array::from({ name }).data() == a.data() );
+
+            const float_array b { vector<double> {4.0} };
+            REQUIRE( publisher.publish(b) == name );    // the publisher keeps its name
+            REQUIRE( float_array::from({ name })[0] == 4.0 );
+        }
+
+        REQUIRE( float_array::from({ name }).empty() );    // the publisher is gone
+    }
+
+    SECTION("publishers have names of their own") {
+        float_array_publisher p1;
+        float_array_publisher p2;
+        const float_array     a(1);
+
+        REQUIRE( p1.publish(a) != p2.publish(a) );
+    }
+
+    SECTION("a list is read as an array") {
+        const auto a { float_array::from({ 1, 2.5, "x", 4.0 }) };
+
+        REQUIRE( a.size() == 3 );
+        REQUIRE( a[0] == 1.0 );
+        REQUIRE( a[2] == 4.0 );
+    }
+}
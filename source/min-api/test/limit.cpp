@@ -142,6 +142,67 @@ TEST_CASE( "folding", "[limits]" ) {
 }
 
 
+TEST_CASE( "limiting blocks", "[limits]" ) {
+    const std::vector<number>   d { -1001.0, -36.0, -25.0, -10.0, -5.0, 0.0, 0.5, 4.99, 5.0, 6.5, 11.0, 1001.0 };
+    const std::vector<int>      i { -1001, -36, -25, -10, -5, -1, 0, 3, 4, 5, 6, 11, 719, 1001 };
+
+    SECTION("the block versions match the scalar versions") {
+        std::vector<number> dout(d.size());
+        std::vector<int>    iout(i.size());
+
+        clamp(d.data(), dout.data(), d.size(), -5.0, 5.0);
+        for (auto n = 0u; n < d.size(); ++n)
+            REQUIRE( dout[n] == clamp(d[n], -5.0, 5.0) );
+
+        wrap(d.data(), dout.data(), d.size(), -5.0, 5.0);
+        for (auto n = 0u; n < d.size(); ++n)
+            REQUIRE( dout[n] == Approx(wrap(d[n], -5.0, 5.0)).margin(1e-9) );
+
+        wrap(d.data(), dout.data(), d.size(), -5.0, -25.0);
+        for (auto n = 0u; n < d.size(); ++n)
+            REQUIRE( dout[n] == Approx(wrap(d[n], -5.0, -25.0)).margin(1e-9) );
+
+        fold(d.data(), dout.data(), d.size(), -5.0, 5.0);
+        for (auto n = 0u; n < d.size(); ++n)
+            REQUIRE( dout[n] == Approx(fold(d[n], -5.0, 5.0)).margin(1e-9) );
+
+        fold(d.data(), dout.data(), d.size(), -5.0, -25.0);
+        for (auto n = 0u; n < d.size(); ++n)
+            REQUIRE( dout[n] == Approx(fold(d[n], -5.0, -25.0)).margin(1e-9) );
+
+        // exact for integers, where the scalar version goes through a floating-point division (e.g. it wraps -36 to 3)
+        wrap(i.data(), iout.data(), i.size(), 0, 5);
+        REQUIRE( iout == std::vector<int> { 4, 4, 0, 0, 0, 4, 0, 3, 4, 0, 1, 1, 4, 1 } );
+
+        fold(i.data(), iout.data(), i.size(), 0, 5);
+        for (auto n = 0u; n < i.size(); ++n)
+            REQUIRE( iout[n] == fold(i[n], 0, 5) );
+    }
+
+    SECTION("values within the range pass unchanged, in place") {
+        std::vector<number> x { -5.0, -0.1, 0.0, 4.99 };
+        const auto          y { x };
+
+        wrap(x.data(), x.data(), x.size(), -5.0, 5.0);
+        REQUIRE( x == y );
+        fold(x.data(), x.data(), x.size(), -5.0, 5.0);
+        REQUIRE( x == y );
+        limit::clamp<number>::apply(x.data(), x.data(), x.size(), -5.0, 5.0);
+        REQUIRE( x == y );
+    }
+
+    SECTION("an empty range") {
+        std::vector<number> x { -3.0, 0.0, 7.0 };
+
+        wrap(x.data(), x.data(), x.size(), 2.0, 2.0);
+        REQUIRE( x == std::vector<number> { 0.0, 0.0, 0.0 } );
+
+        x = { -3.0, 0.0, 7.0 };
+        fold(x.data(), x.data(), x.size(), 2.0, 2.0);
+        REQUIRE( x == std::vector<number> { 2.0, 2.0, 2.0 } );
+    }
+}
+
 TEST_CASE( "scaling", "[limits]" ) {
     REQUIRE( scale(0.0, 0.0, 1.0, 0.0, 127.0) == 0.0);
     REQUIRE( scale(1.0, 0.0, 1.0, 0.0, 127.0) == 127.0);
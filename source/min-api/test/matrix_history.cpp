@@ -0,0 +1,96 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+namespace {
+
+    // a char matrix of one plane, 4 cells wide and 2 rows high
+
+    max::t_jit_matrix_info char_matrix_info() {
+        max::t_jit_matrix_info info {};
+
+        info.type         = max::gensym("char");
+        info.planecount   = 1;
+        info.dimcount     = 2;
+        info.dim[0]       = 4;
+        info.dim[1]       = 2;
+        info.dimstride[0] = 1;
+        info.dimstride[1] = 4;
+        info.size         = 8;
+        return info;
+    }
+
+}
+
+
+TEST_CASE( "Matrix History", "[matrix]" ) {
+    auto             info { char_matrix_info() };
+    matrix_history   history;
+    vector<uchar>    frame(8);
+
+    history.resize(2);
+
+    // calculate three frames, filled with 1, 2 and 3
+
+    const auto calculate = [&](const uchar value) -> matrix_info {
+        std::fill(frame.begin(), frame.end(), value);
+
+        const auto copy { history.push(info, frame.data()) };
+        const matrix_info view { &info, copy, &info, frame.data(), &history };
+        return view;
+    };
+
+    SECTION("the first frame has no history, so previous() views the current frame") {
+        const auto view { calculate(1) };
+
+        REQUIRE( view.history_count() == 0 );
+        REQUIRE( (view.previous(1).in_cell<uchar, 1>(0, 0)[0] == 1) );
+    }
+
+    SECTION("earlier frames are viewed at the same places, up to the size of the history") {
+        calculate(1);
+        history.advance();
+        calculate(2);
+        history.advance();
+
+        auto view { calculate(3) };
+
+        REQUIRE( view.history_count() == 2 );
+        REQUIRE( (view.in_cell<uchar, 1>(3, 1)[0] == 3) );
+        REQUIRE( (view.previous(1).in_cell<uchar, 1>(3, 1)[0] == 2) );
+        REQUIRE( (view.previous(2).in_cell<uchar, 1>(3, 1)[0] == 1) );
+        REQUIRE( (view.previous(3).in_cell<uchar, 1>(3, 1)[0] == 3) );    // beyond the history
+
+        // a view of the second row only, as for a band of rows, views the second row of the earlier frames
+        const matrix_info band { &info, view.m_bip + 4, &info, frame.data() + 4, &history };
+        REQUIRE( band.previous(1).m_bip == view.previous(1).m_bip + 4 );
+
+        history.advance();
+        view = calculate(4);
+        REQUIRE( (view.previous(2).in_cell<uchar, 1>(0, 0)[0] == 2) );    // the oldest frame was replaced
+    }
+
+    SECTION("a matrix of a different layout forgets the history") {
+        calculate(1);
+        history.advance();
+
+        info.dim[1] = 1;
+        info.size   = 4;
+
+        const auto view { calculate(2) };
+        REQUIRE( view.history_count() == 0 );
+    }
+
+    SECTION("resizing the history forgets it") {
+        calculate(1);
+        history.advance();
+        history.resize(3);
+        REQUIRE( history.count() == 0 );
+    }
+}
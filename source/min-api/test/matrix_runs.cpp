@@ -0,0 +1,75 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+namespace {
+
+    // a 3-dimensional char matrix of four planes, with padding of pad bytes at the end of each row
+
+    max::t_jit_matrix_info char_matrix_info(const long width, const long height, const long depth, const long pad = 0) {
+        max::t_jit_matrix_info info {};
+
+        info.type         = max::gensym("char");
+        info.planecount   = 4;
+        info.dimcount     = 3;
+        info.dim[0]       = width;
+        info.dim[1]       = height;
+        info.dim[2]       = depth;
+        info.dimstride[0] = 4;
+        info.dimstride[1] = width * 4 + pad;
+        info.dimstride[2] = info.dimstride[1] * height;
+        info.size         = info.dimstride[2] * depth;
+        return info;
+    }
+
+}
+
+
+TEST_CASE( "Matrix Runs", "[matrix]" ) {
+
+    SECTION("runs that are not collapsed are the rows of every slice, numbered together") {
+        const auto        info { char_matrix_info(320, 240, 3) };
+        const matrix_runs runs { 3, info.dim, &info, info, false };
+
+        REQUIRE( runs.count() == 720 );
+
+        const auto run { runs[241] };
+        REQUIRE( run.row == 1 );
+        REQUIRE( run.length == 320 );
+        REQUIRE( run.in == info.dimstride[2] + info.dimstride[1] );
+        REQUIRE( run.in_slice == info.dimstride[2] );
+    }
+
+    SECTION("a packed matrix is collapsed into one run, split so that it may be divided among threads") {
+        const auto        info { char_matrix_info(320, 240, 3) };
+        const matrix_runs runs { 3, info.dim, &info, info, true };
+
+        REQUIRE( runs.count() == (320 * 240 * 3 + matrix_runs::k_split_length - 1) / matrix_runs::k_split_length );
+        REQUIRE( runs.cell_count() == 320 * 240 * 3 );
+        REQUIRE( runs[1].in == matrix_runs::k_split_length * 4 );
+        REQUIRE( runs[runs.count() - 1].length == 320 * 240 * 3 - (runs.count() - 1) * matrix_runs::k_split_length );
+    }
+
+    SECTION("padded rows are not collapsed") {
+        const auto        info { char_matrix_info(320, 240, 3, 16) };
+        const matrix_runs runs { 3, info.dim, &info, info, true };
+
+        REQUIRE( runs.count() == 720 );
+    }
+
+    SECTION("an input of one row is extended across the rows of the output") {
+        const auto        in { char_matrix_info(320, 1, 1) };
+        const auto        out { char_matrix_info(320, 240, 1) };
+        const matrix_runs runs { 3, out.dim, &in, out, true };
+
+        REQUIRE( runs.count() == 240 );
+        REQUIRE( runs[5].in == 0 );
+        REQUIRE( runs[5].out == 5 * out.dimstride[1] );
+    }
+}
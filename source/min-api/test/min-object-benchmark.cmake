@@ -0,0 +1,24 @@
+# Copyright 2018 The Min-API Authors. All rights reserved.
+# Use of this source code is governed by the MIT License found in the License.md file.
+
+# Benchmarks run the perform routine of an object in the mock signal chain (see c74_min_benchmark.h) to measure its cost.
+# Build the min_bench target, in a release configuration, to build the benchmarks of all objects.
+
+
+set(BENCH_NAME "${PROJECT_NAME}_bench")
+
+if (EXISTS "${CMAKE_CURRENT_SOURCE_DIR}/${BENCH_NAME}.cpp")
+
+	if (NOT TARGET mock_kernel)
+		set(C74_MOCK_TARGET_DIR "${CMAKE_CURRENT_LIST_DIR}/../../../tests")
+		add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/../test/mock ${CMAKE_BINARY_DIR}/mock)
+	endif ()
+
+	add_benchmark(${BENCH_NAME}
+		OUTPUT_DIRECTORY
+			"${CMAKE_CURRENT_SOURCE_DIR}/../../../tests"
+		SOURCES
+			${BENCH_NAME}.cpp
+	)
+
+endif ()
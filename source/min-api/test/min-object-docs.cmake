@@ -0,0 +1,23 @@
+# Copyright 2018 The Min-API Authors. All rights reserved.
+# Use of this source code is governed by the MIT License found in the License.md file.
+
+# Refpages are generated at build time rather than when Max registers the class of an external (see doc_update() in c74_min_doc.h).
+# A generator executable is built from the sources of the object and run after it is built, writing the refpage to the docs folder of the package.
+# Build the min_docs target to generate the refpages of all objects.
+
+
+set(DOCS_NAME "${PROJECT_NAME}_docs")
+
+if (NOT TARGET mock_kernel)
+	set(C74_MOCK_TARGET_DIR "${CMAKE_CURRENT_LIST_DIR}/../../../tests")
+	add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/../test/mock ${CMAKE_BINARY_DIR}/mock)
+endif ()
+
+add_doc_generator(${DOCS_NAME}
+	OUTPUT_DIRECTORY
+		"${CMAKE_CURRENT_SOURCE_DIR}/../../../tests"
+	DOCS_DIRECTORY
+		"${CMAKE_CURRENT_SOURCE_DIR}/../../../docs"
+	SOURCES
+		${SOURCE_FILES}
+)
@@ -26,6 +26,9 @@ if (EXISTS "${CMAKE_CURRENT_SOURCE_DIR}/${TEST_NAME}.cpp")
 		SOURCES 
 			${TEST_NAME}.cpp ${TEST_SOURCE_FILES}
 	)
+
+	# objects that build against the mock kernel for their unit test also get their refpage generated there
+	include(${CMAKE_CURRENT_LIST_DIR}/min-object-docs.cmake)
 	 
 endif ()
 	 
\ No newline at end of file
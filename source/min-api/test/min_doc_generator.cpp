@@ -0,0 +1,25 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+// The main() of a refpage generator (see add_doc_generator() in add_min_unit_test.cmake).
+// It is compiled with the sources of an object and C74_MIN_DOC_GENERATOR defined as the docs folder,
+// so registering the class writes its refpage there.
+
+#include <exception>
+#include <iostream>
+
+extern "C" void ext_main(void* r);
+
+
+int main() {
+    try {
+        ext_main(nullptr);
+    }
+    catch (std::exception& e) {
+        std::cerr << "DOC GENERATOR ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -12,22 +12,6 @@
 
 namespace c74 {
 namespace max {
-    struct t_qelem;
-
-    MOCK_EXPORT t_qelem* qelem_new(void* obj, method fn) {
-        return nullptr;
-    }
-
-    MOCK_EXPORT void qelem_free(t_qelem* qelem) {
-        ;
-    }
-
-    MOCK_EXPORT void qelem_set(t_qelem* q) {
-        ;
-    }
-
-    MOCK_EXPORT void qelem_unset(t_qelem* q) {}
-
     MOCK_EXPORT void* scheduler_fromobject(t_object* x) { return nullptr; }
 
     MOCK_EXPORT short systhread_ismainthread(void) {
@@ -138,6 +122,33 @@ namespace max {
         return nullptr;
     }
 
+    // objects registered by name, without the notifications of Max's real registry
+
+    static std::unordered_map<t_symbol*, void*>& mock_registry() {
+        static std::unordered_map<t_symbol*, void*> registry;
+        return registry;
+    }
+
+    MOCK_EXPORT void *object_register(t_symbol *name_space, t_symbol *s, void *x) {
+        mock_registry()[s] = x;
+        return x;
+    }
+
+    MOCK_EXPORT void *object_findregistered(t_symbol *name_space, t_symbol *s) {
+        const auto found = mock_registry().find(s);
+        return found == mock_registry().end() ? nullptr : found->second;
+    }
+
+    MOCK_EXPORT t_max_err object_unregister(void *x) {
+        for (auto i = mock_registry().begin(); i != mock_registry().end(); ++i) {
+            if (i->second == x) {
+                mock_registry().erase(i);
+                break;
+            }
+        }
+        return 0;
+    }
+
     MOCK_EXPORT t_max_err class_sticky(t_class* x, t_symbol* stickyname, t_symbol* s, t_object* o) {
         return 0;
     }
@@ -177,6 +188,20 @@ namespace max {
 
     MOCK_EXPORT t_max_err object_obex_storeflags(void *x,t_symbol *key, t_object *val, long flags) { return 0; }
 
+    // mock objects are not in a patcher, so they have no box, patcher, or patch cords
+
+    MOCK_EXPORT t_max_err object_obex_lookup(void* x, t_symbol* key, t_object** val) {
+        *val = nullptr;
+        return MAX_ERR_GENERIC;
+    }
+
+    MOCK_EXPORT t_object* jpatcher_get_firstline(t_object* p) { return nullptr; }
+    MOCK_EXPORT t_object* jpatchline_get_nextline(t_object* l) { return nullptr; }
+    MOCK_EXPORT t_object* jpatchline_get_box1(t_object* l) { return nullptr; }
+    MOCK_EXPORT t_object* jpatchline_get_box2(t_object* l) { return nullptr; }
+    MOCK_EXPORT long jpatchline_get_outletnum(t_object* l) { return 0; }
+    MOCK_EXPORT t_object* jbox_get_object(t_object* b) { return nullptr; }
+
     using t_jit_object = t_object;
     using t_jit_err = long;
 
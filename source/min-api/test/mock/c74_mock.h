@@ -14,6 +14,7 @@
 #include <ctime>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <ratio>
 #include <set>
@@ -5,6 +5,11 @@
 
 #pragma once
 
+namespace c74 {
+namespace mock {
+    bool free_clock(void* x);    // defined in c74_mock_clock.h
+}}
+
 namespace c74 {
 namespace max {
 
@@ -195,6 +200,9 @@ namespace max {
      @remark	At the moment, we don't know about tinyobjects, should be easy to add support for that.
  */
 MOCK_EXPORT t_max_err object_free(void *x) {
+    if (mock::free_clock(x))
+        return 0;
+
     auto o = (t_object*)x;
     if (o && o->o_magic == OB_MAGIC) {
         t_mock_messlist *mock_messlist = (t_mock_messlist*)o->o_messlist;
@@ -6,185 +6,240 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
+#include <unordered_set>
 
 using namespace std::chrono_literals;
 
 namespace c74 {
 namespace mock {
 
-    using function = std::function<void(void)>;
-    using generic_callback = void(*)(void*); // TODO: convert to std::function?
-
-    using clock_type = std::chrono::time_point<std::chrono::steady_clock>;
     using lock = std::lock_guard<std::mutex>;
-    using timepoint = std::chrono::steady_clock::time_point;
-    using duration_ms = std::chrono::milliseconds;
 
-    class clock {
+    class clock;
+    class qelem;
 
-        class event {
-            timepoint	m_onset;
-//			function	m_meth;
-            max::method	m_meth;
-            void*		m_baton;
 
-        public:
-            event(timepoint onset, max::method meth, void* baton)
-            : m_onset(onset)
-            , m_meth(meth)
-            , m_baton(baton)
-            {}
+    /// The simulated time of the mock kernel.
+    ///
+    /// Clocks and qelems do not run on threads of their own and time does not pass by itself.
+    /// A unit test advances the time with mock_clock_advance(), which runs every clock that becomes due in the order of its onset
+    /// (clocks with the same onset in the order they were set) and services the qelems whenever no clock is due,
+    /// as Max's scheduler and main thread would, but without waiting.
+    /// So tests of timer-driven objects are deterministic and take no longer than the callbacks themselves.
+    ///
+    /// Clocks and qelems may be set from any thread, e.g. from a perform routine that is called by another thread of the test.
+    /// The callbacks are executed by the thread that advances the time.
 
+    class scheduler {
+        struct event {
+            double      onset;
+            uint64_t    order;    ///< breaks ties between events with the same onset
+            clock*      owner;
 
             friend bool operator< (const event& lhs, const event& rhs) {
-                return lhs.m_onset < rhs.m_onset;
+                return lhs.onset < rhs.onset || (lhs.onset == rhs.onset && lhs.order < rhs.order);
             }
+        };
 
-            friend bool operator< (const event& lhs, const timepoint rhs) {
-                return lhs.m_onset < rhs;
-            }
+    public:
+        static scheduler& instance() {
+            static scheduler s_instance;
+            return s_instance;
+        }
 
-            friend bool operator > (const event& lhs, const timepoint rhs) {
-                return lhs.m_onset > rhs;
-            }
 
-            void operator ()() const {
-                m_meth(m_baton);
-            }
+        /// The current simulated time in milliseconds.
 
-            auto onset() const {
-                return m_onset;
-            }
-        };
+        double now() {
+            lock l { m_mutex };
+            return m_now;
+        }
 
 
-    public:
-		clock(max::method a_callback, void* a_baton)
-		: meth(a_callback)
-		, baton(a_baton) {
-			run_thread.test_and_set();
+        void add(clock* c) {
+            lock l { m_mutex };
+            m_clocks.insert(c);
         }
 
-        ~clock() {
-			run_thread.clear();
-			if (t.joinable()) {
-				t.join();
-            }
+
+        // Returns false if c is not a clock.
+
+        bool remove(clock* c) {
+            lock l { m_mutex };
+            if (!m_clocks.erase(c))
+                return false;
+            unschedule_locked(c);
+            return true;
         }
 
-        // TODO: mark class as not copyable?
 
-        void unset() {
-            {
-                lock l(scheduled_events_mutex);
-                scheduled_events.clear();
-            }
-            {
-                lock l(pending_events_mutex);
-                pending_events.clear();
-            }
+        // Setting a clock that is already set moves it to the new onset, as in Max.
+
+        void schedule(clock* c, const double delay_in_ms) {
+            lock l { m_mutex };
+            unschedule_locked(c);
+            m_events.insert({ m_now + std::max(delay_in_ms, 0.0), m_order++, c });
+        }
+
+
+        void unschedule(clock* c) {
+            lock l { m_mutex };
+            unschedule_locked(c);
+        }
+
+
+        // Setting a qelem that is already set does nothing, as in Max.
+
+        void set(qelem* q) {
+            lock l { m_mutex };
+            if (std::find(m_qelems.begin(), m_qelems.end(), q) == m_qelems.end())
+                m_qelems.push_back(q);
         }
 
-        auto time(clock_type onset) {
-            return std::chrono::duration_cast<std::chrono::milliseconds>(onset - started_at).count();
+
+        void unset(qelem* q) {
+            lock l { m_mutex };
+            m_qelems.erase(std::remove(m_qelems.begin(), m_qelems.end(), q), m_qelems.end());
         }
 
-        auto now() {
-            return std::chrono::high_resolution_clock::now();
+
+        /// Advance the simulated time, executing the clocks and qelems that become due.
+        /// @param	duration_in_ms	The time to advance. Zero executes only what is due now.
+        /// @return					The number of callbacks executed.
+
+        uint64_t advance(const double duration_in_ms);
+
+    private:
+        std::mutex                  m_mutex;
+        double                      m_now {};
+        uint64_t                    m_order {};
+        std::set<event>             m_events;
+        std::deque<qelem*>          m_qelems;
+        std::unordered_set<clock*>  m_clocks;
+
+        void unschedule_locked(clock* c) {
+            for (auto e = m_events.begin(); e != m_events.end();) {
+                if (e->owner == c)
+                    e = m_events.erase(e);
+                else
+                    ++e;
+            }
         }
+    };
 
-        void tick() {
-			while (run_thread.test_and_set()) {
-#ifdef WIN_VERSION
-				// On Windows an exception will be thrown when we try to lock the mutex wihout some sort of time passage
-				// (either a console post or an explicit short delay)
-				// std::cout << c74::mock::clock::tick()" << std::endl;
-				std::this_thread::sleep_for(1ms);
-#endif
-				std::unique_lock<std::mutex> pending_lock(pending_events_mutex);
-				std::unique_lock<std::mutex> scheduled_lock(scheduled_events_mutex);
 
-				// update list of events
-				for (auto &e : pending_events)
-					scheduled_events.insert(e);
-				pending_events.clear();
+    class clock {
+    public:
+        clock(max::method a_callback, void* a_baton)
+        : m_meth { a_callback }
+        , m_baton { a_baton } {
+            scheduler::instance().add(this);
+        }
 
-				// User code can add new events, so don't lock pending_events
-				// while calling the scheduled events!
-				pending_lock.unlock();
+        ~clock() {
+            scheduler::instance().remove(this);
+        }
 
-				std::vector<event> events_that_ran;
-				for (auto& e : scheduled_events) {
-					if (e > now()) {
-						//std::cout << time(now()) << " (all remaining events in the future)" << std::endl;
-						break;
-					}
-					//std::cout << time(now()) << " (event to run)" << std::endl;
-					events_that_ran.push_back(e);
-					e();
-				}
+        clock(const clock&) = delete;
+        clock& operator=(const clock&) = delete;
 
-				// purge events that have run
-				for (auto& e : events_that_ran)
-					scheduled_events.erase(e);
+        void add(const double delay_in_ms) {
+            scheduler::instance().schedule(this, delay_in_ms);
+        }
 
+        void unset() {
+            scheduler::instance().unschedule(this);
+        }
 
-				// events themselves may have added new (pending) events
-				pending_lock.lock();
-				for (auto &e : pending_events)
-					scheduled_events.insert(e);
-				pending_events.clear();
-        
-				const auto next = scheduled_events.empty() ? now()+1h : scheduled_events.begin()->onset();
-				scheduled_lock.unlock(); // we're not touching any scheduled events anymore. Unlock the scheduled_events_mutex.
-				cv.wait_until(pending_lock, next);
-			}
+        void operator()() const {
+            m_meth(m_baton);
         }
 
-        void add(const std::chrono::milliseconds delay/*, function meth*/) {
-            auto			onset = now() + delay;
-            clock::event	event {onset, meth, baton};
+    private:
+        max::method m_meth;
+        void*       m_baton;
+    };
 
-            //std::cout << time(now()) << " NEW EVENT: " << std::chrono::duration_cast<std::chrono::milliseconds>(onset - started_at).count() << "   " << baton << std::endl;
 
-            // a previous version of this code incorrectly tried to deal with deadlock by checking to see if the tick thread was the one adding a new event.
-            // but if the tick thread was adding an event simultaneously to another thread then the content of new_events would be undefined, so we need to lock it for all writing.
-            // the deadlock was occurring because the tick() method was calling into user code while locked, and the user code (in the metro case) was adding new events.
+    class qelem {
+    public:
+        qelem(max::method a_callback, void* a_baton)
+        : m_meth { a_callback }
+        , m_baton { a_baton }
+        {}
 
-            lock l(pending_events_mutex);
-            pending_events.push_back(event);
-            cv.notify_one();
+        ~qelem() {
+            unset();
         }
 
-        /** Convenience wrapper for adding events with a callback to a class member method without having to manually setup std::bind.
-            @param delay	time offset from now() at which to execute
-            @param meth		pointer to member method to be called
-            @param target	pointer to this
-         */
-//		template<class MethType, class T>
-//		void add(const std::chrono::milliseconds delay, MethType meth, T* target) {
-//			add(delay, std::bind(meth, target));
-//		}
+        qelem(const qelem&) = delete;
+        qelem& operator=(const qelem&) = delete;
+
+        void set() {
+            scheduler::instance().set(this);
+        }
 
+        void unset() {
+            scheduler::instance().unset(this);
+        }
 
-        const std::thread::id threadid() const {
-            return t.get_id();
+        void operator()() const {
+            m_meth(m_baton);
         }
 
     private:
-        clock_type				started_at = { std::chrono::steady_clock::now() };
-        std::thread				t { &clock::tick, this };
-        std::mutex				pending_events_mutex; // mutex that must be locked when accessing pending_events
-        std::vector<event>		pending_events;
-        std::mutex				scheduled_events_mutex; // mutex that must be locked when accessing scheduled_events
-        std::multiset<event>	scheduled_events;	// using multiset instead of vector because we want to keep it sorted, performance impacts?
-        std::condition_variable	cv;
-		std::atomic_flag        run_thread;
-
-        max::method				meth;
-        void*					baton;
+        max::method m_meth;
+        void*       m_baton;
     };
 
+
+    // The lock is released while a callback is executed, as the callback may set clocks and qelems.
+    // A clock that is due runs before the qelems, and the qelems run before the time moves on to the next onset.
+
+    inline uint64_t scheduler::advance(const double duration_in_ms) {
+        std::unique_lock<std::mutex>    l { m_mutex };
+        const auto                      until { m_now + std::max(duration_in_ms, 0.0) };
+        uint64_t                        count {};
+
+        while (true) {
+            if (!m_events.empty() && m_events.begin()->onset <= m_now) {
+                const auto c { m_events.begin()->owner };
+                m_events.erase(m_events.begin());
+                l.unlock();
+                (*c)();
+            }
+            else if (!m_qelems.empty()) {
+                const auto q { m_qelems.front() };
+                m_qelems.pop_front();
+                l.unlock();
+                (*q)();
+            }
+            else if (!m_events.empty() && m_events.begin()->onset <= until) {
+                m_now = m_events.begin()->onset;
+                continue;
+            }
+            else
+                break;
+            ++count;
+            l.lock();
+        }
+        m_now = until;
+        return count;
+    }
+
+
+    // Clocks are freed with object_free(), like any Max object.
+
+    bool free_clock(void* x) {
+        const auto c { static_cast<clock*>(x) };
+
+        if (!scheduler::instance().remove(c))
+            return false;
+        delete c;
+        return true;
+    }
+
 }} //namespace c74::mock
 
 
@@ -192,25 +247,27 @@ namespace c74 {
 namespace max {
 
     using t_clock = mock::clock;
+    using t_qelem = mock::qelem;
     using t_timeobject = t_object;
 
 
     MOCK_EXPORT t_clock* clock_new(void* obj, method fn) {
-
-        // TODO: we're going to run into trouble freeing this with object_free...
-
         return new mock::clock(fn, obj);
     }
 
 
     MOCK_EXPORT void clock_unset(t_clock* self) {
-        // TODO: implement
 		self->unset();
     }
 
 
     MOCK_EXPORT void clock_fdelay(t_clock* self, double duration_in_ms) {
-        self->add(std::chrono::milliseconds((int)duration_in_ms));
+        self->add(duration_in_ms);
+    }
+
+
+    MOCK_EXPORT void clock_getftime(double* time) {
+        *time = mock::scheduler::instance().now();
     }
 
 
@@ -219,4 +276,40 @@ namespace max {
     }
 
 
+    MOCK_EXPORT t_qelem* qelem_new(void* obj, method fn) {
+        return new mock::qelem(fn, obj);
+    }
+
+
+    MOCK_EXPORT void qelem_free(t_qelem* qelem) {
+        delete qelem;
+    }
+
+
+    MOCK_EXPORT void qelem_set(t_qelem* q) {
+        q->set();
+    }
+
+
+    MOCK_EXPORT void qelem_unset(t_qelem* q) {
+        q->unset();
+    }
+
+
+    /// Advance the simulated time of the mock kernel, executing the clocks and qelems that become due.
+    /// @param	duration_in_ms	The time to advance. Zero executes only what is due now.
+    /// @return					The number of callbacks executed.
+
+    MOCK_EXPORT uint64_t mock_clock_advance(double duration_in_ms) {
+        return mock::scheduler::instance().advance(duration_in_ms);
+    }
+
+
+    /// The simulated time of the mock kernel in milliseconds, as returned by clock_getftime().
+
+    MOCK_EXPORT double mock_clock_now() {
+        return mock::scheduler::instance().now();
+    }
+
+
 }} // namespace c74::max
@@ -48,6 +48,50 @@ namespace max {
     }
 
 
+    MOCK_EXPORT t_max_err dictionary_appendatom(t_dictionary* d, t_symbol* key, t_atom* value) {
+        return 0;
+    }
+
+    MOCK_EXPORT t_max_err dictionary_appendstring(t_dictionary* d, t_symbol* key, const char* value) {
+        return 0;
+    }
+
+    MOCK_EXPORT t_max_err dictionary_getstring(const t_dictionary* d, t_symbol* key, const char** value) {
+        *value = nullptr;
+        return -1;
+    }
+
+    MOCK_EXPORT t_max_err dictionary_copyentries(t_dictionary* src, t_dictionary* dst, t_symbol** keys) {
+        return 0;
+    }
+
+    MOCK_EXPORT t_max_err dictionary_deleteentry(t_dictionary* d, t_symbol* key) {
+        return 0;
+    }
+
+    MOCK_EXPORT long dictionary_hasentry(t_dictionary* d, t_symbol* key) {
+        return 0;
+    }
+
+    MOCK_EXPORT t_atom_long dictionary_getentrycount(t_dictionary* d) {
+        return 0;
+    }
+
+    MOCK_EXPORT t_max_err dictionary_getkeys(t_dictionary* d, long* numkeys, t_symbol*** keys) {
+        *numkeys = 0;
+        *keys    = nullptr;
+        return 0;
+    }
+
+    MOCK_EXPORT void dictionary_freekeys(t_dictionary* d, long numkeys, t_symbol** keys) {}
+
+    MOCK_EXPORT t_max_err dictionary_getatoms(t_dictionary* d, t_symbol* key, long* argc, t_atom** argv) {
+        *argc = 0;
+        *argv = nullptr;
+        return -1;
+    }
+
+
     MOCK_EXPORT t_symbol* dictobj_namefromptr(t_dictionary* d) {
         return nullptr;
     }
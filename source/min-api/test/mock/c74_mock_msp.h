@@ -69,27 +69,27 @@ class t_mock_dspchain_item {
     double				**m_outs;
 
 public:
-    t_mock_dspchain_item(void *x, t_mock_audiovectors& inputs, t_mock_audiovectors& outputs)
+    t_mock_dspchain_item(void *x, t_mock_audiovectors& inputs, t_mock_audiovectors& outputs, size_t framecount)
     : m_perf(NULL)
     {
         m_obj = (t_object*)x;
-        m_framecount  = inputs[0].size();
+        m_framecount  = framecount;
         m_inputcount  = inputs.size();
         m_outputcount = outputs.size();
         m_ins  = (double**)malloc(sizeof(double*) * m_inputcount);
         m_outs = (double**)malloc(sizeof(double*) * m_outputcount);
 
-        // adapt the outputs (and additional inputs) dimensions to that of the first signal
-        for (int i=1; i<m_inputcount; i++)
+        // adapt the dimensions of all inputs and outputs to the vector size
+        for (int i=0; i<m_inputcount; i++)
             inputs[i].resize(m_framecount);
         for (int i=0; i<m_outputcount; i++)
             outputs[i].resize(m_framecount);
 
         // inputs and outputs are references to external memory from the t_mock_audiovectors passed-in.
         for (int i=0; i<m_inputcount; i++)
-            m_ins[i] = &inputs[i][0];
+            m_ins[i] = inputs[i].data();
         for (int i=0; i<m_outputcount; i++)
-            m_outs[i] = &outputs[i][0];
+            m_outs[i] = outputs[i].data();
     }
 
 
@@ -116,7 +116,8 @@ public:
     /**	Execute the perform routine. */
     void tick()
     {
-        m_perf(m_obj, NULL, m_ins, static_cast<long>(m_inputcount), m_outs, static_cast<long>(m_outputcount), static_cast<long>(m_framecount), 0, NULL);
+        if (m_perf)
+            m_perf(m_obj, NULL, m_ins, static_cast<long>(m_inputcount), m_outs, static_cast<long>(m_outputcount), static_cast<long>(m_framecount), 0, NULL);
     }
 
     /**	Set the perform method that is to be used for this item. */
@@ -131,21 +132,54 @@ public:
 typedef std::vector<t_mock_dspchain_item>	t_mock_dspchain_items;
 
 
+extern "C" inline void dsp_add64(t_object *dsp64, t_object *x, t_perfroutine64 perf, long flags, void *userparam);
+
+
 /**	The big kahuna.  The mock dspchain.
     When an object is added the chain, the chain calls the 'dsp64' method on that object.
     A callback then sets the perform routine for that object.
 
     A vector of all items is maintained.
     Executing the dspchain is simply executing every item in that vector.
-    Memory for the input and output is entirely handled by the caller!
-    That makes this mock implementation simpler, and allows for inspection and full control of the memory in a unit-testing context.
+    Memory for the input and output is either handled by the caller, which allows for inspection and full control of the memory
+    in a unit-testing context, or by the dspchain itself, e.g. for benchmarks that only need the perform routines to run.
+
+    The dspchain starts with a t_object, so that objects can find the 'dsp_add64' method of it as they would in Max.
  */
 class t_mock_dspchain {
-    t_mock_dspchain_items	m_chainitems;	///< all items in the dspchain
+    t_object				m_ob {};					///< must be first
+    t_mock_messlist			m_messlist;					///< the methods of the dspchain, i.e. 'dsp_add64'
+    double					m_samplerate;
+    long					m_vectorsize;
+    t_mock_dspchain_items	m_chainitems;				///< all items in the dspchain
     t_mock_dspchain_item*	m_current = nullptr;		///< object currently being added to the dspchain
+    std::vector<std::unique_ptr<t_mock_audiovectors>>	m_audio;	///< inputs and outputs owned by the dspchain
 
 public:
 
+    /** Create a dspchain.
+        @param	samplerate		The samplerate passed to the dsp method of the objects.
+        @param	vectorsize		The vector size used by objects added without any audio, or without any input.
+     */
+    t_mock_dspchain(double samplerate = 44100, long vectorsize = 64)
+    : m_samplerate(samplerate)
+    , m_vectorsize(vectorsize)
+    {
+        m_messlist["dsp_add64"] = (method)dsp_add64;
+        m_ob.o_messlist = (t_messlist*)&m_messlist;
+    }
+
+    t_mock_dspchain(const t_mock_dspchain&) = delete;
+    t_mock_dspchain& operator = (const t_mock_dspchain&) = delete;
+
+
+    /** The samplerate passed to the dsp method of the objects. */
+    double samplerate() const
+    {
+        return m_samplerate;
+    }
+
+
     /** Add an object to the dspchain.  Calls an object's DSP method
         @param	x				The object to add.
         @param	inputs			The vectors of audio to use as input.
@@ -158,15 +192,15 @@ public:
     {
         short					*count;
         int						i = 0;
-        double					sr = 44100;				// TODO: use sys_getsr()
-        size_t					vs = inputs[0].size();
-        t_mock_dspchain_item	item(x, inputs, outputs);
+        size_t					vs = inputs.empty() ? 0 : inputs[0].size();
         t_object				*o = (t_object*)x;
         t_mock_inlets			*inlets = (t_mock_inlets*)o->o_inlet;
         size_t					inletcount = inlets->size();
 
         if (!vs)
-            vs = 64;			// TODO: use sys_getblksize()
+            vs = static_cast<size_t>(m_vectorsize);
+
+        t_mock_dspchain_item	item(x, inputs, outputs, vs);
 
         // use the number inlets, not the number of inputs -- they can differ
         count = (short*)sysmem_newptrclear(static_cast<long>( sizeof(short) * (inletcount+outputs.size()) ));
@@ -189,7 +223,12 @@ public:
 
         m_current = &item;
 
-        object_method((t_object*)x, gensym("dsp64"), (void*)this, count, (void*)(size_t)sr, (void*)(size_t)vs, 0);
+        // call the method with its actual prototype, as the samplerate is passed as a double
+        typedef void (*t_dsp64_method)(t_object *x, t_object *dsp64, short *count, double samplerate, long maxvectorsize, long flags);
+        t_dsp64_method dsp64 = (t_dsp64_method)zgetfn(o, gensym("dsp64"));
+
+        if (dsp64)
+            dsp64(o, &m_ob, count, m_samplerate, static_cast<long>(vs), 0);
 
         m_current = NULL;
         m_chainitems.push_back(item);
@@ -198,10 +237,29 @@ public:
     }
 
 
+    /** Add an object to the dspchain with inputs and outputs of the vector size owned by the dspchain.
+        @param	x				The object to add.
+        @param	inputcount		The number of input channels.
+        @param	outputcount		The number of output channels.
+        @return					The input channels, which the caller may fill with a signal before calling tick().
+     */
+    t_mock_audiovectors& add(void *x, size_t inputcount, size_t outputcount)
+    {
+        m_audio.push_back(std::make_unique<t_mock_audiovectors>(inputcount, t_mock_audiovector(m_vectorsize)));
+        auto& inputs = *m_audio.back();
+        m_audio.push_back(std::make_unique<t_mock_audiovectors>(outputcount, t_mock_audiovector(m_vectorsize)));
+        auto& outputs = *m_audio.back();
+
+        add(x, inputs, outputs);
+        return inputs;
+    }
+
+
     /** Callback from the DSP method to define the actual perform routine to use. */
     void add_performroutine(t_object *x, t_perfroutine64 perf)
     {
-        m_current->setperf(perf);
+        if (m_current)
+            m_current->setperf(perf);
     }
 
 
@@ -221,6 +279,46 @@ extern "C" inline void dsp_add64(t_object *dsp64, t_object *x, t_perfroutine64 p
 }
 
 
+/**	The dspchain for clients of the mock kernel that do not include its headers, such as benchmarks.
+    @ingroup msp
+ */
+
+MOCK_EXPORT void* mock_dspchain_new(double samplerate, long vectorsize)
+{
+    return new t_mock_dspchain(samplerate, vectorsize);
+}
+
+
+MOCK_EXPORT void mock_dspchain_free(void *dspchain)
+{
+    delete (t_mock_dspchain*)dspchain;
+}
+
+
+/** Add an object to a dspchain with inputs and outputs owned by the dspchain.
+    @param	dspchain		The dspchain.
+    @param	x				The object to add.
+    @param	inputcount		The number of input channels.
+    @param	outputcount		The number of output channels.
+    @param	inputs			Optional array of inputcount pointers that is set to the input channels, so that they can be filled.
+ */
+MOCK_EXPORT void mock_dspchain_add(void *dspchain, void *x, long inputcount, long outputcount, double **inputs)
+{
+    auto& in = ((t_mock_dspchain*)dspchain)->add(x, static_cast<size_t>(inputcount), static_cast<size_t>(outputcount));
+
+    if (inputs) {
+        for (long i=0; i<inputcount; i++)
+            inputs[i] = in[i].data();
+    }
+}
+
+
+MOCK_EXPORT void mock_dspchain_tick(void *dspchain)
+{
+    ((t_mock_dspchain*)dspchain)->tick();
+}
+
+
 MOCK_EXPORT void class_dspinit(t_class *c)
 {
     ;
@@ -262,6 +360,21 @@ MOCK_EXPORT void z_dsp_setup(t_pxobject* x, long inletcount)
     }
 
 
+    MOCK_EXPORT t_atom_long buffer_getframecount(t_buffer_obj* buffer_object) {
+        return 0;
+    }
+
+
+    MOCK_EXPORT t_atom_long buffer_getchannelcount(t_buffer_obj* buffer_object) {
+        return 0;
+    }
+
+
+    MOCK_EXPORT double buffer_getsamplerate(t_buffer_obj* buffer_object) {
+        return 0.0;
+    }
+
+
     MOCK_EXPORT t_max_err buffer_edit_begin(t_buffer_obj* buffer_object) {
         return 0;
     }
@@ -0,0 +1,207 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+
+TEST_CASE( "MPMC FIFO", "[mpmc_fifo]" ) {
+
+    SECTION("capacity is rounded up to a power of two and the queue never grows") {
+        c74::min::mpmc_fifo<int>    q { 5 };
+
+        REQUIRE( q.max_capacity() == 8 );
+        for (auto i = 0; i < 8; ++i)
+            REQUIRE( q.enqueue(i) );
+        REQUIRE( !q.enqueue(8) );
+        REQUIRE( !q.try_enqueue(8) );
+        REQUIRE( q.size_approx() == 8 );
+    }
+
+    SECTION("items are dequeued in the order enqueued, across the end of the storage") {
+        c74::min::mpmc_fifo<int>    q { 4 };
+        int                         x {};
+
+        for (auto lap = 0; lap < 3; ++lap) {
+            REQUIRE( q.try_enqueue(lap * 10 + 1) );
+            REQUIRE( q.try_enqueue(lap * 10 + 2) );
+            REQUIRE( q.try_enqueue(lap * 10 + 3) );
+
+            REQUIRE( *q.peek() == lap * 10 + 1 );
+            REQUIRE( q.try_dequeue(x) );
+            REQUIRE( x == lap * 10 + 1 );
+            REQUIRE( q.pop() );
+            REQUIRE( q.try_dequeue(x) );
+            REQUIRE( x == lap * 10 + 3 );
+            REQUIRE( !q.try_dequeue(x) );
+            REQUIRE( q.peek() == nullptr );
+        }
+    }
+
+    SECTION("items are constructed in place and destroyed when dequeued or left in the queue") {
+        auto counter { std::make_shared<int>(0) };
+        {
+            c74::min::mpmc_fifo<std::shared_ptr<int>>   q { 4 };
+            std::shared_ptr<int>                        x;
+
+            REQUIRE( q.try_emplace(counter) );
+            REQUIRE( q.emplace(counter) );
+            REQUIRE( counter.use_count() == 3 );
+
+            REQUIRE( q.try_dequeue(x) );
+            x.reset();
+            REQUIRE( counter.use_count() == 2 );
+        }
+        REQUIRE( counter.use_count() == 1 );
+    }
+
+    SECTION("every item written by several threads is read exactly once by several threads") {
+        constexpr int                   k_producers { 3 };
+        constexpr int                   k_consumers { 2 };
+        constexpr int                   k_count { 20000 };
+        c74::min::mpmc_fifo<int>        q { 64 };
+        std::atomic<long long>          sum { 0 };
+        std::atomic<int>                received { 0 };
+        std::vector<std::thread>        threads;
+
+        for (auto p = 0; p < k_producers; ++p) {
+            threads.emplace_back([&q] {
+                for (auto i = 1; i <= k_count; ++i) {
+                    while (!q.try_enqueue(i))
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (auto c = 0; c < k_consumers; ++c) {
+            threads.emplace_back([&] {
+                int x {};
+                while (received.load() < k_producers * k_count) {
+                    if (q.try_dequeue(x)) {
+                        sum += x;
+                        ++received;
+                    }
+                    else
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        REQUIRE( received == k_producers * k_count );
+        REQUIRE( sum == static_cast<long long>(k_producers) * k_count * (k_count + 1) / 2 );
+        REQUIRE( q.size_approx() == 0 );
+    }
+}
+
+
+namespace {
+
+    // Nanoseconds per item for producer threads to hand items to consumer threads through a queue.
+    // Producers retry when the queue is full and consumers when it is empty, as a deferring message does on the main thread.
+
+    template<class queue_type>
+    double handoff(const int producers, const int consumers, const int items_per_producer) {
+        queue_type                  q { 256 };
+        std::atomic<int>            received { 0 };
+        std::atomic<bool>           go { false };
+        std::vector<std::thread>    threads;
+        const auto                  total { producers * items_per_producer };
+
+        for (auto p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                while (!go)
+                    ;
+                for (auto i = 0; i < items_per_producer; ++i) {
+                    while (!q.try_enqueue(i))
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (auto c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                int x {};
+                while (!go)
+                    ;
+                while (received.load(std::memory_order_relaxed) < total) {
+                    if (q.try_dequeue(x))
+                        received.fetch_add(1, std::memory_order_relaxed);
+                    else
+                        std::this_thread::yield();
+                }
+            });
+        }
+
+        const auto start { std::chrono::steady_clock::now() };
+        go = true;
+        for (auto& t : threads)
+            t.join();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / total;
+    }
+
+
+    // The single-producer single-consumer fifo, serialized with a mutex when used by several threads.
+
+    template<bool guarded>
+    class guarded_fifo {
+    public:
+        explicit guarded_fifo(const size_t size)
+        : m_fifo { size }
+        {}
+
+        bool try_enqueue(const int item) {
+            if constexpr (guarded) {
+                c74::min::guard g { m_producer_lock };
+                return m_fifo.try_enqueue(item);
+            }
+            else
+                return m_fifo.try_enqueue(item);
+        }
+
+        bool try_dequeue(int& item) {
+            if constexpr (guarded) {
+                c74::min::guard g { m_consumer_lock };
+                return m_fifo.try_dequeue(item);
+            }
+            else
+                return m_fifo.try_dequeue(item);
+        }
+
+    private:
+        c74::min::fifo<int> m_fifo;
+        c74::min::mutex     m_producer_lock;
+        c74::min::mutex     m_consumer_lock;
+    };
+}
+
+
+// Hidden, so running the unit tests measures nothing. To measure, select it by its tag in a release build:
+//
+//     min-tests "[benchmark]"
+
+TEST_CASE( "MPMC FIFO handoff between Max threads", "[.][benchmark]" ) {
+    constexpr int k_items { 240000 };
+
+    struct topology {
+        const char* name;
+        int         producers;
+        int         consumers;
+    };
+
+    const topology topologies[] {
+        { "audio -> main", 1, 1 },
+        { "main + scheduler -> main", 2, 1 },
+        { "main + scheduler + audio -> main", 3, 1 },
+        { "4 workers -> 4 workers", 4, 4 }
+    };
+
+    std::printf("%-36s %12s %12s\n", "topology (ns/item)", "fifo", "mpmc_fifo");
+    for (const auto& t : topologies) {
+        const auto spsc { t.producers == 1 && t.consumers == 1 ?
+            handoff<guarded_fifo<false>>(1, 1, k_items) : handoff<guarded_fifo<true>>(t.producers, t.consumers, k_items / t.producers) };
+        const auto mpmc { handoff<c74::min::mpmc_fifo<int>>(t.producers, t.consumers, k_items / t.producers) };
+
+        std::printf("%-36s %12.1f %12.1f\n", t.name, spsc, mpmc);
+    }
+}
@@ -0,0 +1,66 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+using namespace std::chrono_literals;
+
+
+TEST_CASE( "Mutex Statistics", "[mutex]" ) {
+
+    SECTION("statistics are shared by name") {
+        auto& a { mutex_statistics::named("test shared") };
+        auto& b { mutex_statistics::named("test shared") };
+        auto& c { mutex_statistics::named("test other") };
+
+        REQUIRE( &a == &b );
+        REQUIRE( &a != &c );
+        REQUIRE( a.name() == "test shared" );
+    }
+
+    SECTION("locks, contention, waits and holds are summarized") {
+        auto& s { mutex_statistics::named("test summary") };
+        s.clear();
+
+        s.record_lock({});
+        s.record_unlock(2us);
+        s.record_lock(10us);
+        s.record_unlock(6us);
+
+        const auto summary { s.summarize() };
+        REQUIRE( summary.locks == 2 );
+        REQUIRE( summary.contended == 1 );
+        REQUIRE( summary.wait_mean == Approx(10.0) );
+        REQUIRE( summary.wait_maximum == Approx(10.0) );
+        REQUIRE( summary.hold_mean == Approx(4.0) );
+        REQUIRE( summary.hold_maximum == Approx(6.0) );
+
+        mutex_statistics::clear_all();
+        REQUIRE( s.summarize().locks == 0 );
+    }
+
+    SECTION("the checked mutex is a lockable mutex") {
+        checked_mutex                       m;
+        int                                 count {};
+        std::vector<std::thread>            threads;
+
+        set_mutex_name(m, "test checked");
+        for (auto t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (auto i = 0; i < 1000; ++i) {
+                    std::lock_guard<checked_mutex> l { m };
+                    ++count;
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        REQUIRE( count == 4000 );
+
+        std::unique_lock<checked_mutex> l { m, std::try_to_lock };
+        REQUIRE( l.owns_lock() );
+    }
+}
@@ -0,0 +1,68 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "Duration Histogram", "[queue_health]" ) {
+
+    SECTION("percentiles are accurate to a bucket") {
+        duration_histogram h;
+
+        REQUIRE( h.percentile(0.5) == 0.0 );
+
+        for (uint64_t ns = 1; ns <= 1000; ++ns)
+            h.record(ns * 1000);
+
+        REQUIRE( h.count() == 1000 );
+        REQUIRE( h.mean() == Approx(500500.0) );
+        REQUIRE( h.maximum() == 1000000.0 );
+        REQUIRE( h.percentile(0.5) >= 500000.0 );
+        REQUIRE( h.percentile(0.5) <= 500000.0 * 1.25 );
+        REQUIRE( h.percentile(0.99) >= 990000.0 );
+        REQUIRE( h.percentile(0.99) <= 1000000.0 );
+    }
+
+    SECTION("a clear takes effect with the next duration") {
+        duration_histogram h;
+
+        h.record(1000000);
+        h.clear();
+        REQUIRE( h.count() == 1 );
+        h.record(10);
+        REQUIRE( h.count() == 1 );
+        REQUIRE( h.maximum() == 10.0 );
+    }
+}
+
+
+TEST_CASE( "Queue Health", "[queue_health]" ) {
+
+    SECTION("a data queue counts its depth, overflows and latency") {
+        data_queue<int> queue { nullptr, [](const int&) {}, 4 };
+
+        auto pushed { 0 };
+        while (queue.push(pushed))
+            ++pushed;
+        queue.push(pushed);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        queue.deliver();
+
+        const auto health { queue.health().summarize() };
+        REQUIRE( health.maximum_depth == static_cast<size_t>(pushed) );
+        REQUIRE( health.overflows == 2 );
+        REQUIRE( health.overflows == queue.dropped() );
+        REQUIRE( health.latency_p50 >= 2.0 );
+        REQUIRE( health.latency_p99 >= health.latency_p50 );
+        REQUIRE( health.latency_maximum >= health.latency_p99 );
+
+        queue.health().clear();
+        REQUIRE( queue.health().summarize().maximum_depth == 0 );
+        REQUIRE( queue.dropped() == 0 );
+    }
+}
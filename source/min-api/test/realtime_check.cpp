@@ -0,0 +1,62 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "Realtime Check", "[realtime_check]" ) {
+
+    SECTION("violations are only counted inside a scope") {
+        realtime_violations v;
+
+        realtime_check::heap();
+        {
+            realtime_check::scope checking { v };
+            realtime_check::heap();
+            realtime_check::heap();
+            realtime_check::locked();
+        }
+        realtime_check::locked();
+
+        REQUIRE( v.any() );
+        REQUIRE( v.heap == 2 );
+        REQUIRE( v.locks == 1 );
+        REQUIRE( std::string { v.first } == "heap allocation" );
+
+        v.clear();
+        REQUIRE( !v.any() );
+    }
+
+    SECTION("nested scopes and allowances restore the scope around them") {
+        realtime_violations outer;
+        realtime_violations inner;
+        {
+            realtime_check::scope checking { outer };
+            {
+                realtime_check::scope nested { inner };
+                realtime_check::locked();
+            }
+            {
+                realtime_check::allow allowed;
+                realtime_check::locked();
+            }
+            realtime_check::heap();
+        }
+        REQUIRE( inner.locks == 1 );
+        REQUIRE( outer.locks == 0 );
+        REQUIRE( outer.heap == 1 );
+    }
+
+    SECTION("blocking calls are only checked when the checks are compiled in") {
+        realtime_violations v;
+        {
+            realtime_check::scope checking { v };
+            realtime_check::blocking("file i/o");
+        }
+        REQUIRE( v.blocking_calls == (realtime_check::enabled ? 1 : 0) );
+    }
+}
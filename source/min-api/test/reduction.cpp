@@ -0,0 +1,62 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "channel extrema", "[reduction]" ) {
+
+    sample ch0[] { 0.0,  1.0, -1.0, 2.0 };
+    sample ch1[] { 0.5, -2.0, -1.0, 2.0 };
+    sample ch2[] { 0.5,  3.0,  4.0, 0.0 };
+    sample* channels[] { ch0, ch1, ch2 };
+
+    audio_bundle            input { channels, 3, 4 };
+    channel_extrema<>       result;
+
+    result.reset(input.frame_count());
+    result.accumulate(input, 0, input.channel_count());
+
+    REQUIRE( result.low()[0] == 0.0 );
+    REQUIRE( result.low_channel()[0] == 0 );
+    REQUIRE( result.high()[0] == 0.5 );
+    REQUIRE( result.high_channel()[0] == 1 );    // ties resolve to the lowest channel
+
+    REQUIRE( result.low()[1] == -2.0 );
+    REQUIRE( result.low_channel()[1] == 1 );
+    REQUIRE( result.high()[1] == 3.0 );
+    REQUIRE( result.high_channel()[1] == 2 );
+
+    REQUIRE( result.low_channel()[2] == 0 );
+    REQUIRE( result.high_channel()[3] == 0 );
+
+    SECTION( "merging channel groups matches a single pass" ) {
+        channel_extrema<> first;
+        channel_extrema<> second;
+
+        first.reset(input.frame_count());
+        second.reset(input.frame_count());
+        first.accumulate(input, 0, 1);
+        second.accumulate(input, 1, 3);
+        first.merge(second);
+
+        for (auto i = 0; i < input.frame_count(); ++i) {
+            REQUIRE( first.low()[i] == result.low()[i] );
+            REQUIRE( first.high()[i] == result.high()[i] );
+            REQUIRE( first.low_channel()[i] == result.low_channel()[i] );
+            REQUIRE( first.high_channel()[i] == result.high_channel()[i] );
+        }
+    }
+
+    SECTION( "no channels" ) {
+        channel_extrema<> empty;
+
+        empty.reset(input.frame_count());
+        REQUIRE( empty.low_channel()[0] == -1 );
+        REQUIRE( empty.high_channel()[0] == -1 );
+    }
+}
@@ -0,0 +1,90 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+
+TEST_CASE( "Ring Buffer", "[ring_buffer]" ) {
+
+    SECTION("capacity is rounded up to a power of two") {
+        c74::min::ring_buffer<float>    ring { 100 };
+
+        REQUIRE( ring.capacity() == 128 );
+        REQUIRE( ring.space() == 128 );
+        REQUIRE( ring.available() == 0 );
+    }
+
+    SECTION("items are read in the order written, across the end of the storage") {
+        c74::min::ring_buffer<int>  ring { 8 };
+        int                         in[6] { 1, 2, 3, 4, 5, 6 };
+        int                         out[6] {};
+
+        REQUIRE( ring.write(in, 6) == 6 );
+        REQUIRE( ring.read(out, 4) == 4 );
+        REQUIRE( ring.write(in, 6) == 6 );     // wraps around
+        REQUIRE( ring.write(in, 6) == 0 );     // full
+        REQUIRE( ring.available() == 8 );
+
+        REQUIRE( ring.read(out, 6) == 6 );
+        REQUIRE( out[0] == 5 );
+        REQUIRE( out[1] == 6 );
+        REQUIRE( out[2] == 1 );
+        REQUIRE( out[5] == 4 );
+        REQUIRE( ring.read(out, 6) == 2 );
+        REQUIRE( out[1] == 6 );
+    }
+
+    SECTION("skipping discards items written before a position") {
+        c74::min::ring_buffer<int>  ring { 8 };
+        int                         in[4] { 1, 2, 3, 4 };
+        int                         out[4] {};
+
+        ring.write(in, 3);
+        const auto position = ring.write_position();
+        ring.write(in + 3, 1);
+
+        ring.skip_to(position);
+        REQUIRE( ring.available() == 1 );
+        REQUIRE( ring.read(out, 4) == 1 );
+        REQUIRE( out[0] == 4 );
+
+        ring.skip_to(position);     // already read past this position
+        REQUIRE( ring.available() == 0 );
+        REQUIRE( ring.space() == 8 );
+    }
+
+    SECTION("a consumer thread receives every item in order") {
+        c74::min::ring_buffer<int>  ring { 64 };
+        std::atomic<int>            out_of_order { 0 };
+        constexpr int               count { 100000 };
+
+        std::thread consumer { [&] {
+            int expected { 0 };
+            int block[16];
+
+            while (expected < count) {
+                const auto n = ring.read(block, 16);
+                for (size_t i = 0; i < n; ++i) {
+                    if (block[i] != expected++)
+                        ++out_of_order;    // Catch assertions are not threadsafe, so check the count below
+                }
+            }
+        } };
+
+        int next { 0 };
+        int block[10];
+
+        while (next < count) {
+            const auto n = std::min(10, count - next);
+            for (auto i = 0; i < n; ++i)
+                block[i] = next + i;
+            next += static_cast<int>(ring.write(block, n));
+        }
+        consumer.join();
+
+        REQUIRE( out_of_order == 0 );
+    }
+
+}
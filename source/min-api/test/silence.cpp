@@ -0,0 +1,78 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+namespace {
+
+    class reverb {
+    public:
+        size_t silence_tail() {
+            return 100;
+        }
+    };
+
+    class oscillator {};
+
+}
+
+
+TEST_CASE( "detecting silent vectors", "[silence]" ) {
+    std::vector<double> silence(64, 0.0);
+    std::vector<double> sound(64, 0.0);
+
+    sound[63] = 1e-20;
+
+    REQUIRE( is_silent(silence.data(), silence.size()) );
+    REQUIRE( !is_silent(sound.data(), sound.size()) );
+    REQUIRE( is_silent(sound.data(), 63) );
+    REQUIRE( is_silent(sound.data(), 0) );
+}
+
+
+TEST_CASE( "skipping processing after the tail", "[silence]" ) {
+    std::vector<double> silence(64, 0.0);
+    std::vector<double> sound(64, 0.5);
+    const double*       silent_channels[2] { silence.data(), silence.data() };
+    const double*       sounding_channels[2] { silence.data(), sound.data() };
+    silence_detector    detector;
+
+    SECTION( "vectors are processed until the tail has elapsed" ) {
+        REQUIRE( !detector.skip(sounding_channels, 2, 64, 100) );
+        REQUIRE( !detector.skip(silent_channels, 2, 64, 100) );
+        REQUIRE( !detector.skip(silent_channels, 2, 64, 100) );
+        REQUIRE( detector.silent_frames() == 128 );
+        REQUIRE( detector.skip(silent_channels, 2, 64, 100) );
+        REQUIRE( detector.skip(silent_channels, 2, 64, 100) );
+        REQUIRE( detector.silent_frames() == 128 );
+
+        // any sound resumes the processing
+        REQUIRE( !detector.skip(sounding_channels, 2, 64, 100) );
+        REQUIRE( detector.silent_frames() == 0 );
+    }
+
+    SECTION( "a longer tail resumes the processing" ) {
+        for (auto i = 0; i < 3; ++i)
+            detector.skip(silent_channels, 2, 64, 100);
+        REQUIRE( detector.skip(silent_channels, 2, 64, 100) );
+        REQUIRE( !detector.skip(silent_channels, 2, 64, 1000) );
+    }
+
+    SECTION( "without a tail silent vectors are skipped right away" ) {
+        REQUIRE( detector.skip(silent_channels, 2, 64, 0) );
+    }
+
+    SECTION( "objects without signal inputs are never skipped" ) {
+        REQUIRE( !detector.skip(nullptr, 0, 64, 0) );
+    }
+
+    SECTION( "classes opt in by defining silence_tail()" ) {
+        static_assert(has_silence_tail<reverb>::value);
+        static_assert(!has_silence_tail<oscillator>::value);
+    }
+}
@@ -0,0 +1,51 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+
+TEST_CASE( "Attribute Snapshot", "[attributes]" ) {
+
+    SECTION("readers see the most recent value") {
+        c74::min::attribute_snapshot<std::vector<double>>   snapshot;
+
+        snapshot.write({ 1.0, 2.0 });
+        REQUIRE( snapshot.read()->size() == 2 );
+
+        snapshot.write({ 3.0, 4.0, 5.0 });
+        auto reader = snapshot.read();
+        REQUIRE( reader->size() == 3 );
+        REQUIRE( (*reader)[0] == 3.0 );
+    }
+
+    SECTION("a value being read is not changed by a concurrent write") {
+        c74::min::attribute_snapshot<std::vector<int>>  snapshot;
+        std::atomic<bool>                               done { false };
+        std::atomic<int>                                torn_reads { 0 };
+
+        snapshot.write(std::vector<int>(16, 0));
+
+        std::thread reader_thread { [&] {
+            while (!done) {
+                auto        reader { snapshot.read() };
+                const auto& value { *reader };
+
+                for (auto x : value) {
+                    if (x != value[0])
+                        ++torn_reads;    // Catch assertions are not threadsafe, so check the count below
+                }
+            }
+        } };
+
+        for (auto i = 1; i <= 1000; ++i)
+            snapshot.write(std::vector<int>(16, i));
+        done = true;
+        reader_thread.join();
+
+        REQUIRE( torn_reads == 0 );
+        REQUIRE( (*snapshot.read())[0] == 1000 );
+    }
+
+}
@@ -0,0 +1,110 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "real fft", "[spectral]" ) {
+    constexpr size_t    size { 16 };
+    real_fft<size>      fft;
+    double              signal[size];
+    double              result[size];
+    std::complex<double> bins[real_fft<size>::bin_count];
+
+    for (auto i = 0u; i < size; ++i)
+        signal[i] = std::sin(0.3 * i) + 0.25 * i;
+
+    fft.forward(signal, bins);
+
+    for (auto k = 0u; k < real_fft<size>::bin_count; ++k) {
+        std::complex<double> expected {};
+        for (auto n = 0u; n < size; ++n)
+            expected += signal[n] * std::polar(1.0, -2.0 * M_PI * k * n / size);
+        REQUIRE( std::abs(bins[k] - expected) < 1e-12 );
+    }
+
+    fft.inverse(bins, result);
+
+    for (auto i = 0u; i < size; ++i)
+        REQUIRE( result[i] == Approx(signal[i]).margin(1e-12) );
+}
+
+
+TEST_CASE( "spectral processor", "[spectral]" ) {
+    using processor = spectral_processor<64, 4>;
+
+    std::vector<double> input(1000);
+    std::vector<double> output(input.size());
+    for (auto i = 0u; i < input.size(); ++i)
+        input[i] = std::sin(0.05 * i) + 0.5 * std::sin(0.71 * i);
+
+    SECTION( "an unchanged spectrum reproduces the delayed input, for any vector size" ) {
+        processor   p;
+        auto        frames { 0L };
+        const long  vector_sizes[] { 1, 17, 64, 100, 3 };
+
+        for (auto v = 0; frames < static_cast<long>(input.size()); ++v) {
+            const auto count { std::min(vector_sizes[v % 5], static_cast<long>(input.size()) - frames) };
+            p.process(input.data() + frames, output.data() + frames, count, [](std::complex<double>*) {});
+            frames += count;
+        }
+
+        for (auto i = 0u; i < processor::latency; ++i)
+            REQUIRE( output[i] == Approx(0.0).margin(1e-12) );
+        for (auto i = processor::latency; i < input.size(); ++i)
+            REQUIRE( output[i] == Approx(input[i - processor::latency]).margin(1e-12) );
+    }
+
+    SECTION( "changes to the spectrum are resynthesized, also in place" ) {
+        processor p;
+
+        output = input;
+        p.process(output.data(), output.data(), static_cast<long>(output.size()), [](std::complex<double>* bins) {
+            for (auto k = 0u; k < processor::bin_count; ++k)
+                bins[k] *= 0.5;
+        });
+
+        for (auto i = processor::latency; i < input.size(); ++i)
+            REQUIRE( output[i] == Approx(0.5 * input[i - processor::latency]).margin(1e-12) );
+    }
+}
+
+
+TEST_CASE( "spectral analyzer", "[spectral]" ) {
+    using analyzer = spectral_analyzer<64, 4>;
+
+    std::vector<double> input(1000);
+    for (auto i = 0u; i < input.size(); ++i)
+        input[i] = std::sin(2.0 * M_PI * 8 * i / 64.0);
+
+    analyzer            a;
+    std::vector<long>   ends;
+    auto                frames { 0L };
+    const long          vector_sizes[] { 1, 17, 64, 100, 3 };
+
+    for (auto v = 0; frames < static_cast<long>(input.size()); ++v) {
+        const auto count { std::min(vector_sizes[v % 5], static_cast<long>(input.size()) - frames) };
+
+        a.process(input.data() + frames, count, [&](const std::complex<double>* bins, const long offset) {
+            ends.push_back(frames + offset);
+
+            // once the frame is full of the sine, its energy is in bin 8 and the neighbours of the Hann window
+            if (frames + offset >= 63) {
+                REQUIRE( std::abs(bins[8]) == Approx(16.0) );
+                REQUIRE( std::abs(bins[7]) == Approx(8.0) );
+                REQUIRE( std::abs(bins[20]) == Approx(0.0).margin(1e-9) );
+            }
+        });
+        frames += count;
+    }
+
+    // a frame is complete every hop, the first one after the first hop of input
+
+    REQUIRE( ends.size() == input.size() / analyzer::hop_size );
+    for (auto i = 0u; i < ends.size(); ++i)
+        REQUIRE( ends[i] == static_cast<long>((i + 1) * analyzer::hop_size - 1) );
+}
@@ -0,0 +1,96 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE( "Stencil Edges", "[stencil]" ) {
+
+    SECTION("coordinates inside the matrix are unchanged") {
+        for (auto edge : { matrix_edge::clamp, matrix_edge::wrap, matrix_edge::fold, matrix_edge::zero })
+            REQUIRE( matrix_edge_index(3, 5, edge) == 3 );
+    }
+
+    SECTION("coordinates outside the matrix are mapped according to the edge mode") {
+        REQUIRE( matrix_edge_index(-2, 5, matrix_edge::clamp) == 0 );
+        REQUIRE( matrix_edge_index(7, 5, matrix_edge::clamp) == 4 );
+        REQUIRE( matrix_edge_index(-2, 5, matrix_edge::wrap) == 3 );
+        REQUIRE( matrix_edge_index(7, 5, matrix_edge::wrap) == 2 );
+        REQUIRE( matrix_edge_index(-1, 5, matrix_edge::fold) == 1 );
+        REQUIRE( matrix_edge_index(5, 5, matrix_edge::fold) == 3 );
+        REQUIRE( matrix_edge_index(9, 5, matrix_edge::fold) == 1 );
+        REQUIRE( matrix_edge_index(-1, 1, matrix_edge::fold) == 0 );
+        REQUIRE( matrix_edge_index(-1, 5, matrix_edge::zero) == -1 );
+    }
+}
+
+
+TEST_CASE( "Stencil Rows", "[stencil]" ) {
+    constexpr long  width  { 6 };
+    constexpr long  height { 4 };
+    constexpr long  planes { 2 };
+
+    float input[height][width][planes];
+
+    for (auto y = 0; y < height; ++y) {
+        for (auto x = 0; x < width; ++x) {
+            input[y][x][0] = static_cast<float>(y * 10 + x);
+            input[y][x][1] = static_cast<float>(-(y * 10 + x));
+        }
+    }
+
+    const matrix_view<float> in { &input[0][0][0], width, height, planes, planes, width * planes };
+
+    SECTION("a single tap shifts the row, reading the edges as requested") {
+        float                              output[width][planes] {};
+        const matrix_span<float>           out { &output[0][0], width, planes, planes, 1 };
+        const std::array<stencil_tap, 1>   taps {{ { 1, -1, 1.0 } }};
+
+        stencil_row(in, out, 0, taps, matrix_edge::wrap);
+        REQUIRE( output[0][0] == Approx(31.0f) );    // row -1 wraps to row 3
+        REQUIRE( output[5][0] == Approx(30.0f) );    // column 6 wraps to column 0
+        REQUIRE( output[5][1] == Approx(-30.0f) );
+
+        stencil_row(in, out, 0, taps, matrix_edge::zero);
+        REQUIRE( output[2][0] == Approx(0.0f) );
+    }
+
+    SECTION("a separable kernel matches the equivalent stencil") {
+        float                  separable[width][planes] {};
+        float                  taps_output[width][planes] {};
+        vector<stencil_tap>    taps;
+
+        for (long ty = -1; ty <= 1; ++ty) {
+            for (long tx = -1; tx <= 1; ++tx)
+                taps.push_back({ tx, ty, 1.0 / 9.0 });
+        }
+
+        for (auto edge : { matrix_edge::clamp, matrix_edge::wrap, matrix_edge::fold, matrix_edge::zero }) {
+            for (long y = 0; y < height; ++y) {
+                stencil_row(in, matrix_span<float> { &separable[0][0], width, planes, planes, 1 }, y, separable_kernel::box(1), edge);
+                stencil_row(in, matrix_span<float> { &taps_output[0][0], width, planes, planes, 1 }, y, taps, edge);
+
+                for (auto x = 0; x < width; ++x) {
+                    REQUIRE( separable[x][0] == Approx(taps_output[x][0]) );
+                    REQUIRE( separable[x][1] == Approx(taps_output[x][1]) );
+                }
+            }
+        }
+    }
+
+    SECTION("integer outputs are rounded and saturated") {
+        uchar                            pixels[3] { 200, 250, 100 };
+        uchar                            output[3] {};
+        const matrix_view<uchar>         row { pixels, 3, 1, 1, 1, 3 };
+        const std::array<stencil_tap, 2> taps {{ { 0, 0, 1.0 }, { 1, 0, 0.5 } }};
+
+        stencil_row(row, matrix_span<uchar> { output, 3, 1, 1, 1 }, 0, taps, matrix_edge::zero);
+        REQUIRE( output[0] == 255 );
+        REQUIRE( output[1] == 255 );
+        REQUIRE( output[2] == 100 );
+    }
+}
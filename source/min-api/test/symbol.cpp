@@ -16,4 +16,16 @@ TEST_CASE( "Symbol Class", "[symbols]" ) {
         REQUIRE( !strcmp(c1, "foo") );
     }
 
+    SECTION("symbol literals") {
+        const auto& s1 = MIN_SYMBOL("foo");
+        const auto& s2 = MIN_SYMBOL("foo");
+
+        REQUIRE( s1 == c74::min::symbol("foo") );
+        REQUIRE( s1 == s2 );    // every use has its own storage, for the same symbol of Max
+
+        const auto bar = []() { return &MIN_SYMBOL("bar"); };
+        REQUIRE( bar() == bar() );    // and is interned only once
+        REQUIRE( *bar() == "bar" );
+    }
+
 }
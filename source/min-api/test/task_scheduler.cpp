@@ -0,0 +1,80 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+static void wait_for_background(const task_scheduler& s) {
+    while (s.background_pending() > 0)
+        std::this_thread::yield();
+}
+
+
+TEST_CASE( "Task Scheduler", "[task_scheduler]" ) {
+
+    SECTION("every index of the real-time lane is performed once") {
+        task_scheduler      s { 2, 1 };
+        std::atomic<int>    counts[64] {};
+
+        s.parallel_for(64, [&](const size_t i) {
+            ++counts[i];
+        });
+        for (auto& c : counts)
+            REQUIRE( c == 1 );
+    }
+
+    SECTION("background tasks are all performed, including the ones they submit") {
+        task_scheduler      s { 0, 3 };
+        std::atomic<int>    sum { 0 };
+
+        for (auto i = 0; i < 10; ++i) {
+            s.background([&s, &sum, i] {
+                for (auto j = 0; j < 10; ++j) {
+                    s.background([&sum, i, j] {
+                        sum += i * 10 + j;
+                    });
+                }
+            });
+        }
+        wait_for_background(s);
+        REQUIRE( sum == 4950 );
+    }
+
+    SECTION("a busy background lane does not hold up the real-time lane") {
+        task_scheduler      s { 1, 1 };
+        std::atomic<bool>   release { false };
+        std::atomic<int>    count { 0 };
+
+        s.background([&release] {
+            while (!release)
+                std::this_thread::yield();
+        });
+        s.parallel_for(16, [&](const size_t) {
+            ++count;
+        });
+        REQUIRE( count == 16 );
+
+        release = true;
+        wait_for_background(s);
+    }
+
+    SECTION("queued tasks are discarded, not leaked, when the scheduler is destroyed") {
+        auto                resource { std::make_shared<int>(1) };
+        std::atomic<bool>   release { false };
+        {
+            task_scheduler s { 0, 1 };
+            s.background([&release] {
+                while (!release)
+                    std::this_thread::yield();
+            });
+            for (auto i = 0; i < 4; ++i)
+                s.background([resource] {});
+            release = true;
+        }
+        REQUIRE( resource.use_count() == 1 );
+    }
+}
@@ -0,0 +1,87 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+namespace c74::max {
+    extern "C" uint64_t mock_clock_advance(double duration_in_ms);    // see c74_min_unittest.h
+}
+
+
+TEST_CASE( "Timed Events", "[timed_events]" ) {
+    using c74::max::mock_clock_advance;
+
+    // vectors of 64 frames that take 1 ms each, as the scheduler in the audio interrupt runs once per vector
+
+    timed_events<int> events;
+
+    REQUIRE( events.due(64).empty() );
+
+    SECTION("events are placed within the vector in proportion to their time") {
+        mock_clock_advance(0.25);
+        events.post(1);
+        mock_clock_advance(0.5);
+        events.post(2);
+        events.post(3);
+        mock_clock_advance(0.25);
+
+        const auto& due { events.due(64) };
+
+        REQUIRE( due.size() == 3 );
+        REQUIRE( due[0].offset == 16 );
+        REQUIRE( due[0].value == 1 );
+        REQUIRE( due[1].offset == 48 );
+        REQUIRE( due[1].value == 2 );
+        REQUIRE( due[2].offset == 48 );
+        REQUIRE( due[2].value == 3 );
+
+        mock_clock_advance(1.0);
+        REQUIRE( events.due(64).empty() );
+    }
+
+    SECTION("delayed events wait for their vector") {
+        events.post(7, 2.5);
+
+        mock_clock_advance(1.0);
+        REQUIRE( events.due(64).empty() );
+        mock_clock_advance(1.0);
+        REQUIRE( events.due(64).empty() );
+        mock_clock_advance(1.0);
+
+        const auto& due { events.due(64) };
+
+        REQUIRE( due.size() == 1 );
+        REQUIRE( due[0].offset == 32 );
+        REQUIRE( due[0].value == 7 );
+    }
+
+    SECTION("a vector is split at the events") {
+        std::vector<std::pair<long, long>>  parts;
+        std::vector<int>                    applied;
+
+        mock_clock_advance(0.5);
+        events.post(1);
+        mock_clock_advance(0.5);
+
+        events.split(64, [&](const int& value) { applied.push_back(value); }, [&](long start, long count) { parts.push_back({ start, count }); });
+
+        REQUIRE( applied == std::vector<int> { 1 } );
+        REQUIRE( parts.size() == 2 );
+        REQUIRE( parts[0] == std::pair<long, long> { 0, 32 } );
+        REQUIRE( parts[1] == std::pair<long, long> { 32, 32 } );
+    }
+
+    SECTION("events that do not fit are dropped") {
+        timed_events<int> small { 4 };
+
+        auto posted { 0 };
+        while (small.post(posted))
+            ++posted;
+        REQUIRE( posted >= 4 );
+        REQUIRE( small.dropped() == 1 );
+    }
+}
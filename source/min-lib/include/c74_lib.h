@@ -8,6 +8,7 @@
 
 #include "c74_lib_circular_storage.h"
 #include "c74_lib_interpolator.h"
+#include "c74_lib_lookup_table.h"
 #include "c74_lib_math.h"
 #include "c74_lib_easing.h"
 #include "c74_lib_filters.h"
@@ -18,7 +19,14 @@
 #include "c74_lib_delay.h"
 #include "c74_lib_generator.h"
 #include "c74_lib_limiter.h"
+#include "c74_lib_multitap_delay.h"
+#include "c74_lib_noise.h"
 #include "c74_lib_onepole.h"
+#include "c74_lib_oversampler.h"
+#include "c74_lib_loudness.h"
 #include "c74_lib_saturation.h"
 #include "c74_lib_sync.h"
 #include "c74_lib_oscillator.h"
+
+#include "c74_lib_chain.h"
+#include "c74_lib_voice_allocator.h"
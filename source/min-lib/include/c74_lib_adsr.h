@@ -41,22 +41,71 @@ namespace c74::min::lib {
                         m_exp = 1.0 + m_curve * k_power_multiplier;
                     else if (m_curve < 0)
                         m_exp = 1.0 + (-m_curve) * k_power_multiplier;
+
+                    // the table is only allocated the first time that a slope is curved
+                    m_table.resize(k_table_size + 2);
+                    for (auto i = 0; i <= k_table_size; ++i)
+                        m_table[i] = curve(static_cast<number>(i) / k_table_size);
+                    m_table[k_table_size + 1] = m_table[k_table_size];
                 }
             }
 
             number operator()(number x) {
                 if (m_is_linear)
                     return x;
-                else if (m_curve > 0.0)
+                else
+                    return curve(x);
+            }
+
+
+            /// Render consecutive samples of a segment of the envelope that follows this slope.
+            /// A curved slope is read from a table, which differs from operator() by less than 1e-5 of the segment,
+            /// so that pow() is only called when the curve changes.
+            /// @param	output		The buffer to fill.
+            /// @param	count		The number of samples.
+            /// @param	position	The position within the segment from 0.0 to 1.0, advanced by step before each sample.
+            /// @param	step		The increment of the position per sample.
+            /// @param	from		The value at the start of the segment.
+            /// @param	to			The value at the end of the segment.
+
+            void render(sample* output, int count, number& position, number step, number from, number to) const {
+                const auto range = to - from;
+
+                if (m_is_linear) {
+                    for (auto i = 0; i < count; ++i) {
+                        position += step;
+                        output[i] = position * range + from;
+                    }
+                }
+                else {
+                    for (auto i = 0; i < count; ++i) {
+                        position += step;
+                        output[i] = lookup(position) * range + from;
+                    }
+                }
+            }
+
+        private:
+            static constexpr int k_table_size { 1024 };    ///< intervals of the curve from 0.0 to 1.0
+
+            number curve(number x) const {
+                if (m_curve > 0.0)
                     return 1.0 - pow(std::abs(x - 1.0), m_exp);
                 else
                     return pow(x, m_exp);
             }
 
-        private:
-            number	m_curve		{ 0.0 };
-            number	m_exp		{ 1.0 };
-            bool	m_is_linear	{ true };
+            number lookup(number x) const {
+                auto p     = std::max(x, 0.0) * k_table_size;
+                auto index = std::min(static_cast<int>(p), k_table_size);
+                auto delta = p - index;
+                return m_table[index] + delta * (m_table[index + 1] - m_table[index]);
+            }
+
+            number	        m_curve		{ 0.0 };
+            number	        m_exp		{ 1.0 };
+            bool	        m_is_linear	{ true };
+            vector<number>  m_table;    ///< the curve at k_table_size + 1 points, and the last once more
         };
 
 
@@ -76,7 +125,7 @@ namespace c74::min::lib {
 
 
         sample active() {
-            return m_stage != adsr_stage::inactive;
+            return m_voice.stage != adsr_stage::inactive;
         }
 
 
@@ -167,117 +216,190 @@ namespace c74::min::lib {
 
 
         void trigger(bool active) {
-            if (active != m_active) {
-                m_active = active;
+            trigger(m_voice, active);
+        }
+
+
+        adsr_stage stage() {
+            return m_voice.stage;
+        }
+
+
+        /// Calculate one sample.
+        ///	@return		Calculated sample
+
+        sample operator()() {
+            return tick(m_voice);
+        }
+
+
+        /// Calculate a block of samples.
+        /// Within the attack, decay and release the samples are rendered without a branch per sample,
+        /// and curved segments are read from a table instead of calling pow() for every sample.
+        /// @param	output		The buffer to fill.
+        /// @param	frame_count	The number of samples.
+
+        void process(sample* output, int frame_count) {
+            render(m_voice, output, frame_count);
+        }
+
+    private:
+        int     m_attack_new {};
+        slope	m_attack_exp;
+        number	m_attack_step;
+        int		m_attack_step_count;
+
+        int     m_decay_new {};
+        slope	m_decay_exp;
+        number	m_decay_step;
+        int		m_decay_step_count;
+
+        int     m_release_new {};
+        slope	m_release_exp;
+        number	m_release_step;
+        int		m_release_step_count;
+
+        number	m_initial_cached;
+        number	m_peak_cached;
+        number	m_sustain_cached;
+        number	m_end_cached;
+
+        envelope_mode   m_envelope_mode { envelope_mode::adsr };
+        int             m_retrigger_step_count {};
+        bool            m_return_to_zero { true };
+
+        // The state of one envelope, apart from the settings above which may be shared by many (see adsr_bank).
+
+        struct voice {
+            adsr_stage  stage { adsr_stage::inactive };
+            int         index { 0xFFFFFF };
+            sample      attack_current {};
+            sample      decay_current {};
+            sample      release_current { 0.0 };
+            bool        active { false };
+            sample      last_output {};
+            sample      retrigger_start {};
+        };
+
+        voice   m_voice;
+
+        friend class adsr_bank;
+
+        void recalc() {
+            m_attack_step_count = std::max(m_attack_new, 1);
+            m_decay_step_count = std::max(m_decay_new, 1);
+            m_release_step_count = std::max(m_release_new, 1);
+
+            m_attack_step = 1.0 / m_attack_step_count;
+            m_decay_step = 1.0 / m_decay_step_count;
+            m_release_step = 1.0 / m_release_step_count;
+        }
 
-                if (m_active) {
-                    m_stage = adsr_stage::attack;
-                    m_index = 0;
-                    m_attack_current = 0.0;
+
+        void trigger(voice& v, bool active) {
+            if (active != v.active) {
+                v.active = active;
+
+                if (v.active) {
+                    v.stage = adsr_stage::attack;
+                    v.index = 0;
+                    v.attack_current = 0.0;
                 }
                 else {
-                    if (m_stage == adsr_stage::sustain) {
-                        m_stage = adsr_stage::release;
-                        m_index = 0;
-                        m_release_current = 0.0;
+                    if (v.stage == adsr_stage::sustain) {
+                        v.stage = adsr_stage::release;
+                        v.index = 0;
+                        v.release_current = 0.0;
                     }
                     else {
-                        m_stage = adsr_stage::early_release;
-                        m_index = 0;
-                        m_release_current = 0.0;
-                        m_retrigger_start = m_last_output; // re-using m_retrigger_start for release_start
+                        v.stage = adsr_stage::early_release;
+                        v.index = 0;
+                        v.release_current = 0.0;
+                        v.retrigger_start = v.last_output; // re-using v.retrigger_start for release_start
                     }
                 }
             }
             else if (active) { // re-trigger when we are already active
-                m_stage = adsr_stage::retrigger;
-                m_index = 0;
-                m_retrigger_start = m_last_output;
+                v.stage = adsr_stage::retrigger;
+                v.index = 0;
+                v.retrigger_start = v.last_output;
             }
 
             recalc();
         }
 
 
-        adsr_stage stage() {
-            return m_stage;
-        }
-
-
-        /// Calculate one sample.
-        ///	@return		Calculated sample
-
-        sample operator()() {
+        sample tick(voice& v) {
 			sample output {};
 
-            switch (m_stage) {
+            switch (v.stage) {
                 case adsr_stage::attack:
-                    m_attack_current += m_attack_step;
-                    ++m_index;
-                    if (m_index == m_attack_step_count) {
+                    v.attack_current += m_attack_step;
+                    ++v.index;
+                    if (v.index == m_attack_step_count) {
                         output = m_peak_cached;
-                        m_stage = adsr_stage::decay;
-                        m_index = 0;
-                        m_decay_current = 0.0;
+                        v.stage = adsr_stage::decay;
+                        v.index = 0;
+                        v.decay_current = 0.0;
                     }
                     else
-                        output = m_attack_exp(m_attack_current) * (m_peak_cached - m_initial_cached) + m_initial_cached;
+                        output = m_attack_exp(v.attack_current) * (m_peak_cached - m_initial_cached) + m_initial_cached;
                     break;
                 case adsr_stage::decay:
-                    m_decay_current += m_decay_step;
-                    ++m_index;
-                    if (m_index == m_decay_step_count) {
+                    v.decay_current += m_decay_step;
+                    ++v.index;
+                    if (v.index == m_decay_step_count) {
                         output = m_sustain_cached;
                         if (m_envelope_mode == envelope_mode::adsr)
-                            m_stage = adsr_stage::sustain;
+                            v.stage = adsr_stage::sustain;
                         else
-                            m_stage = adsr_stage::release;
-                        m_index = 0;
-                        m_release_current = 0;
+                            v.stage = adsr_stage::release;
+                        v.index = 0;
+                        v.release_current = 0;
                     }
                     else
-                        output = m_decay_exp(m_decay_current) * (m_sustain_cached - m_peak_cached) + m_peak_cached;
+                        output = m_decay_exp(v.decay_current) * (m_sustain_cached - m_peak_cached) + m_peak_cached;
                     break;
                 case adsr_stage::sustain:
                     output = m_sustain_cached;
                     break;
                 case adsr_stage::release:
-                    m_release_current += m_release_step;
-                    ++m_index;
-                    if (m_index >= m_release_step_count) {
+                    v.release_current += m_release_step;
+                    ++v.index;
+                    if (v.index >= m_release_step_count) {
                         output = m_end_cached;
-                        m_stage = adsr_stage::inactive;
-                        m_active = false;
+                        v.stage = adsr_stage::inactive;
+                        v.active = false;
                     }
                     else
-                        output = m_release_exp(m_release_current) * (m_end_cached - m_sustain_cached) + m_sustain_cached;
+                        output = m_release_exp(v.release_current) * (m_end_cached - m_sustain_cached) + m_sustain_cached;
                     break;
                 case adsr_stage::early_release:
-                     m_release_current += m_release_step;
-                    ++m_index;
-                    if (m_index >= m_release_step_count) {
+                     v.release_current += m_release_step;
+                    ++v.index;
+                    if (v.index >= m_release_step_count) {
                         output = m_end_cached;
-                        m_stage = adsr_stage::inactive;
-                        m_active = false;
+                        v.stage = adsr_stage::inactive;
+                        v.active = false;
                     }
                     else
-                        output = m_release_exp(m_release_current) * (m_end_cached - m_retrigger_start) + m_retrigger_start;
+                        output = m_release_exp(v.release_current) * (m_end_cached - v.retrigger_start) + v.retrigger_start;
                     break;
                 case adsr_stage::retrigger:
                     if (m_return_to_zero) {
-                        ++m_index;
-                        output = m_retrigger_start - (((m_retrigger_start - m_end_cached) / m_retrigger_step_count) * m_index);
-                        if (m_index >= m_retrigger_step_count) {
-                            m_stage = adsr_stage::attack;
-                            m_index = 0;
-                            m_attack_current = 0.0;
+                        ++v.index;
+                        output = v.retrigger_start - (((v.retrigger_start - m_end_cached) / m_retrigger_step_count) * v.index);
+                        if (v.index >= m_retrigger_step_count) {
+                            v.stage = adsr_stage::attack;
+                            v.index = 0;
+                            v.attack_current = 0.0;
                         }
                     }
                     else {
                         if (m_return_to_zero) {
-                            m_stage = adsr_stage::attack;
-                            m_index = 0;
-                            m_attack_current = 0.0;
+                            v.stage = adsr_stage::attack;
+                            v.index = 0;
+                            v.attack_current = 0.0;
                             output = m_initial_cached;
                         }
                         else {
@@ -295,20 +417,20 @@ namespace c74::min::lib {
                             for (auto i=0; i<m_attack_step_count; ++i) {
                                 attack_current += m_attack_step;
                                 attack_curved = m_attack_exp(attack_current) * (m_peak_cached - m_initial_cached) + m_initial_cached;
-                                is_below = attack_curved < m_last_output;
+                                is_below = attack_curved < v.last_output;
                                 if (is_below != was_below) { // we found the position from which to retrigger
-                                    m_stage = adsr_stage::attack;
-                                    m_index = i;
-                                    m_attack_current = attack_current;
-                                    output = m_last_output;
+                                    v.stage = adsr_stage::attack;
+                                    v.index = i;
+                                    v.attack_current = attack_current;
+                                    output = v.last_output;
                                     found = true;
                                 }
                             }
 
                             if (!found) { // so return to zero
-                                m_stage = adsr_stage::attack;
-                                m_index = 0;
-                                m_attack_current = 0.0;
+                                v.stage = adsr_stage::attack;
+                                v.index = 0;
+                                v.attack_current = 0.0;
                                 output = m_initial_cached;
                             }
                         }
@@ -318,54 +440,181 @@ namespace c74::min::lib {
                     output = m_end_cached;
                     break;
             }
-            m_last_output = output;
+            v.last_output = output;
             return output;
         }
 
-    private:
-        int     m_attack_new;
-        slope	m_attack_exp;
-        number	m_attack_step;
-        int		m_attack_step_count;
-        sample	m_attack_current;
 
-        int     m_decay_new;
-        slope	m_decay_exp;
-        number	m_decay_step;
-        int		m_decay_step_count;
-        sample 	m_decay_current;
+        void render(voice& v, sample* output, int frame_count) {
+            auto i = 0;
+
+            while (i < frame_count) {
+                // the samples before the last of the current stage, which cannot change the stage
+                auto count = frame_count - i;
+
+                switch (v.stage) {
+                    case adsr_stage::attack:
+                        count = std::min(count, m_attack_step_count - v.index - 1);
+                        m_attack_exp.render(output + i, count, v.attack_current, m_attack_step, m_initial_cached, m_peak_cached);
+                        break;
+                    case adsr_stage::decay:
+                        count = std::min(count, m_decay_step_count - v.index - 1);
+                        m_decay_exp.render(output + i, count, v.decay_current, m_decay_step, m_peak_cached, m_sustain_cached);
+                        break;
+                    case adsr_stage::release:
+                        count = std::min(count, m_release_step_count - v.index - 1);
+                        m_release_exp.render(output + i, count, v.release_current, m_release_step, m_sustain_cached, m_end_cached);
+                        break;
+                    case adsr_stage::early_release:
+                        count = std::min(count, m_release_step_count - v.index - 1);
+                        m_release_exp.render(output + i, count, v.release_current, m_release_step, v.retrigger_start, m_end_cached);
+                        break;
+                    case adsr_stage::sustain:
+                    case adsr_stage::inactive:
+                        // constant until the next trigger, and the index does not advance
+                        v.last_output = v.stage == adsr_stage::sustain ? m_sustain_cached : m_end_cached;
+                        std::fill_n(output + i, count, v.last_output);
+                        return;
+                    default:
+                        count = 0;
+                        break;
+                }
 
-        int     m_release_new;
-        slope	m_release_exp;
-        number	m_release_step;
-        int		m_release_step_count;
-        sample 	m_release_current { 0.0 };
+                if (count > 0) {
+                    v.index += count;
+                    v.last_output = output[i + count - 1];
+                    i += count;
+                }
+                else
+                    output[i++] = tick(v);    // a stage boundary or a retrigger
+            }
+        }
+    };
 
-        number	m_initial_cached;
-        number	m_peak_cached;
-        number	m_sustain_cached;
-        number	m_end_cached;
 
-        int	m_index { 0xFFFFFF };
+    ///	Many ADSR envelopes with the same settings, e.g. one for each voice of a polyphonic synthesizer.
+    /// The settings and the tables of the curves are stored once for all voices instead of once per envelope,
+    /// and the state of all voices is stored together, so rendering a block for every voice touches little memory.
+    /// Times are latched for all voices whenever any voice is triggered.
 
-        adsr_stage m_stage { adsr_stage::inactive };
+    class adsr_bank {
+    public:
+        /// Create a bank of envelopes.
+        /// @param	voice_count		The number of envelopes.
 
-        bool	        m_active { false };
-        envelope_mode   m_envelope_mode { envelope_mode::adsr };
-        sample          m_last_output {};
-        sample          m_retrigger_start {};
-        int             m_retrigger_step_count {};
-        bool            m_return_to_zero { true };
+        explicit adsr_bank(int voice_count = 16)
+        : m_voices(voice_count) {}
 
-        void recalc() {
-            m_attack_step_count = std::max(m_attack_new, 1);
-            m_decay_step_count = std::max(m_decay_new, 1);
-            m_release_step_count = std::max(m_release_new, 1);
 
-            m_attack_step = 1.0 / m_attack_step_count;
-            m_decay_step = 1.0 / m_decay_step_count;
-            m_release_step = 1.0 / m_release_step_count;
+        /// Return the number of envelopes.
+        /// @return	The number of envelopes.
+
+        int voice_count() const {
+            return static_cast<int>(m_voices.size());
+        }
+
+
+        void mode(adsr::envelope_mode mode_value) {
+            m_settings.mode(mode_value);
+        }
+
+        void initial(number initial_value) {
+            m_settings.initial(initial_value);
+        }
+
+        void peak(number peak_value) {
+            m_settings.peak(peak_value);
+        }
+
+        void sustain(number sustain_value) {
+            m_settings.sustain(sustain_value);
+        }
+
+        void end(number end_value) {
+            m_settings.end(end_value);
+        }
+
+        void attack(number attack_ms, number sampling_frequency) {
+            m_settings.attack(attack_ms, sampling_frequency);
         }
+
+        void attack_curve(number attack_curve) {
+            m_settings.attack_curve(attack_curve);
+        }
+
+        void decay(number decay_ms, number sampling_frequency) {
+            m_settings.decay(decay_ms, sampling_frequency);
+        }
+
+        void decay_curve(number decay_curve) {
+            m_settings.decay_curve(decay_curve);
+        }
+
+        void release(number release_ms, number sampling_frequency) {
+            m_settings.release(release_ms, sampling_frequency);
+        }
+
+        void release_curve(number release_curve) {
+            m_settings.release_curve(release_curve);
+        }
+
+        void retrigger(number retrigger_ms, number sampling_frequency) {
+            m_settings.retrigger(retrigger_ms, sampling_frequency);
+        }
+
+        void return_to_zero(bool rtz) {
+            m_settings.return_to_zero(rtz);
+        }
+
+
+        /// Start or release the envelope of one voice.
+        /// @param	voice	The index of the voice.
+        /// @param	active	True to start the envelope, false to release it.
+
+        void trigger(int voice, bool active) {
+            m_settings.trigger(m_voices[voice], active);
+        }
+
+
+        /// Return whether the envelope of one voice is running.
+        /// @param	voice	The index of the voice.
+        /// @return			True if the envelope is not inactive.
+
+        bool active(int voice) const {
+            return m_voices[voice].stage != adsr::adsr_stage::inactive;
+        }
+
+
+        /// Return the stage of the envelope of one voice.
+        /// @param	voice	The index of the voice.
+        /// @return			The stage.
+
+        adsr::adsr_stage stage(int voice) const {
+            return m_voices[voice].stage;
+        }
+
+
+        /// Calculate one sample of one voice.
+        /// @param	voice	The index of the voice.
+        ///	@return			Calculated sample
+
+        sample operator()(int voice) {
+            return m_settings.tick(m_voices[voice]);
+        }
+
+
+        /// Calculate a block of samples for every voice.
+        /// @param	outputs		One buffer of frame_count samples per voice.
+        /// @param	frame_count	The number of samples.
+
+        void process(sample* const* outputs, int frame_count) {
+            for (auto voice = 0; voice < voice_count(); ++voice)
+                m_settings.render(m_voices[voice], outputs[voice], frame_count);
+        }
+
+    private:
+        adsr                    m_settings;    ///< the settings of all voices; its own voice is unused
+        vector<adsr::voice>     m_voices;
     };
 
     
@@ -50,6 +50,17 @@ namespace c74::min::lib {
         };
 
 
+        /// Set a new delay time in samples, crossfading both delay lines over a number of samples
+        /// instead of jumping to the new read position.
+        /// @param	new_size				The new delay time in samples. Will be clamped to the capacity.
+        /// @param	crossfade_frame_count	The duration of the crossfade in samples.
+
+        void delay(number new_size, std::size_t crossfade_frame_count) {
+            m_feedforward_history.size(new_size, crossfade_frame_count);
+            m_feedback_history.size(new_size, crossfade_frame_count);
+        }
+
+
         /// Return the current delay time in samples.
         /// @return The delay time in samples.
 
@@ -58,6 +69,14 @@ namespace c74::min::lib {
         };
 
 
+        /// Return the maximum delay time in samples, which is fixed at creation.
+        /// @return The capacity in samples.
+
+        number capacity() const {
+            return m_feedforward_history.capacity();
+        }
+
+
         /// Set a new delay time in milliseconds.
         /// @param	new_size_ms		The new delay time in milliseconds.
         /// @param	sampling_frequency		The sampling frequency of the environment in hertz.
@@ -128,6 +147,17 @@ namespace c74::min::lib {
             return y;
         }
 
+
+        /// Calculate a block of samples.
+        /// @param	input			frame_count samples.
+        /// @param	output			frame_count samples. May be the same as input.
+        /// @param	frame_count		The number of samples.
+
+        void operator()(const sample* input, sample* output, std::size_t frame_count) {
+            for (std::size_t i = 0; i < frame_count; ++i)
+                output[i] = (*this)(input[i]);
+        }
+
     private:
         c74::min::lib::delay m_feedforward_history{};    ///< Delay line for the FIR side of the filter.
         c74::min::lib::delay m_feedback_history{};       ///< Delay line for the IIR side of the filter.
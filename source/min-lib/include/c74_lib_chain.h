@@ -0,0 +1,175 @@
+/// @file
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include "c74_min_api.h"
+
+namespace c74::min::lib {
+
+
+    // SFINAE implementations used internally by the chain to determine what a unit offers.
+
+    template<class unit_type, class = void>
+    struct unit_has_block_operator : std::false_type {};
+
+    template<class unit_type>
+    struct unit_has_block_operator<unit_type, std::void_t<decltype(std::declval<unit_type&>()(
+        std::declval<const sample*>(), std::declval<sample*>(), std::declval<std::size_t>()))>> : std::true_type {};
+
+    template<class unit_type, class = void>
+    struct unit_has_clear : std::false_type {};
+
+    template<class unit_type>
+    struct unit_has_clear<unit_type, std::void_t<decltype(std::declval<unit_type&>().clear())>> : std::true_type {};
+
+
+    ///	A chain of single-channel units, e.g. `chain<dcblocker, onepole, saturation>`,
+    /// which processes a sample or a block of samples through each of the units in turn as if they were one unit.
+    ///
+    /// If all units are trivially copyable, as the filters are, a block is processed by a single loop
+    /// that calls the per-sample operator of each unit, with the state of all units copied to local variables,
+    /// so that it stays in registers for the whole block instead of passing through memory between the units.
+    /// Otherwise (e.g. for a saturation, which owns an oversampler) the block is processed in chunks that stay in the cache,
+    /// each passed through the block operator of every unit in turn.
+    ///
+    /// A unit is any class with a per-sample call operator `sample operator()(sample x)`.
+    /// Its block call operator `void operator()(const sample* input, sample* output, std::size_t frame_count)`
+    /// is used if it has one, and its clear() if it has one.
+    /// @tparam	unit_types	The classes of the units, in the order in which they process the audio.
+
+    template<class... unit_types>
+    class chain {
+        static_assert(sizeof...(unit_types) > 0, "a chain needs at least one unit");
+
+    public:
+        /// True if a block is processed by a single loop through all units.
+
+        static constexpr bool fused { (std::is_trivially_copyable<unit_types>::value && ...) };
+
+
+        /// The number of frames that each unit processes in turn if the units are not fused.
+
+        static constexpr std::size_t k_chunk_size { 64 };
+
+
+        /// Access a unit by its position in the chain, e.g. to set its parameters.
+        /// @tparam	index	The position of the unit, from 0.
+        /// @return			The unit.
+
+        template<std::size_t index>
+        auto& unit() {
+            return std::get<index>(m_units);
+        }
+
+
+        /// Access a unit by its class, if the class appears only once in the chain.
+        /// @tparam	unit_type	The class of the unit.
+        /// @return				The unit.
+
+        template<class unit_type>
+        unit_type& unit() {
+            return std::get<unit_type>(m_units);
+        }
+
+
+        /// Clear the history of all units that have one.
+
+        void clear() {
+            std::apply([](auto&... units) {
+                (clear_unit(units), ...);
+            }, m_units);
+        }
+
+
+        /// Calculate one sample.
+        ///	@return		Calculated sample
+
+        sample operator()(sample x) {
+            return process(m_units, x);
+        }
+
+
+        /// Calculate a block of samples.
+        /// @param	input		frame_count input samples.
+        /// @param	output		frame_count output samples. May be the same as input.
+        /// @param	frame_count	The number of samples.
+
+        void operator()(const sample* input, sample* output, std::size_t frame_count) {
+            if constexpr (fused) {
+                auto units { m_units };    // in registers for the whole block
+
+                for (std::size_t i = 0; i < frame_count; ++i)
+                    output[i] = process(units, input[i]);
+                m_units = units;
+            }
+            else {
+                for (std::size_t offset = 0; offset < frame_count; offset += k_chunk_size) {
+                    const auto count { std::min(k_chunk_size, frame_count - offset) };
+                    const auto in { input + offset };
+                    const auto out { output + offset };
+
+                    std::apply([in, out, count](auto& first, auto&... rest) {
+                        process_block(first, in, out, count);
+                        (process_block(rest, out, out, count), ...);
+                    }, m_units);
+                }
+            }
+        }
+
+    private:
+        std::tuple<unit_types...> m_units;
+
+        static sample process(std::tuple<unit_types...>& units, sample x) {
+            std::apply([&x](auto&... each) {
+                ((x = each(x)), ...);
+            }, units);
+            return x;
+        }
+
+        template<class unit_type>
+        static void process_block(unit_type& unit, const sample* input, sample* output, const std::size_t frame_count) {
+            if constexpr (unit_has_block_operator<unit_type>::value)
+                unit(input, output, frame_count);
+            else {
+                for (std::size_t i = 0; i < frame_count; ++i)
+                    output[i] = unit(input[i]);
+            }
+        }
+
+        template<class unit_type>
+        static void clear_unit(unit_type& unit) {
+            if constexpr (unit_has_clear<unit_type>::value)
+                unit.clear();
+        }
+    };
+
+
+    ///	A base for audio objects with one input and one output that are made of a chain of units.
+    /// Inherit from it together with object<>, e.g.
+    /// @code
+    /// class strip : public object<strip>, public lib::chain_operator<lib::dcblocker, lib::onepole, lib::saturation> {
+    /// @endcode
+    /// and set the parameters of the units with unit<>(), e.g. in the setters of attributes.
+    /// Each vector of audio is processed with a single call of the block operator of the chain.
+    /// @tparam	unit_types	The classes of the units, in the order in which they process the audio.
+
+    template<class... unit_types>
+    class chain_operator : public sample_operator<1, 1>, public chain<unit_types...> {
+    public:
+        using chain<unit_types...>::operator();
+
+
+        /// Calculate a vector of samples.
+        /// @param	input	The input vector.
+        /// @param	output	The output vector.
+
+        void operator()(const sample_block<1>& input, sample_block<1>& output) {
+            (*this)(input[0], output[0], static_cast<std::size_t>(output.frame_count()));
+        }
+    };
+
+
+}    // namespace c74::min::lib
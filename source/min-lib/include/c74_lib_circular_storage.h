@@ -9,6 +9,69 @@
 
 namespace c74::min::lib {
 
+
+    /// Policies for how circular_storage asserts that it is only accessed from a single thread.
+    /// Querying the thread can cost more than writing a sample, which matters in builds that keep asserts enabled.
+
+    namespace thread_check {
+
+
+        /// Check the thread on every access (the default).
+
+        class checked {
+        public:
+            /// Confirm that calls to multiple public methods are happening on the same thread.
+            /// First call to this method will set the m_thread variable.
+            /// Every call after will compare to the current thread id to m_thread.
+            /// @return         false if the thread id changes between calls, else true
+
+            bool operator()() {
+                if (m_thread == null_thread) {
+                    m_thread = {std::this_thread::get_id()};
+                    return true;
+                }
+                else {
+                    return std::this_thread::get_id() == m_thread;
+                }
+            }
+
+        private:
+            std::thread::id m_thread;       ///< used to ensure we don't access unsafely from multiple threads
+            std::thread::id null_thread;    ///< save the default constructor output to catch the first call
+        };
+
+
+        /// Never check the thread, while other asserts remain in effect.
+
+        class unchecked {
+        public:
+            bool operator()() {
+                return true;
+            }
+        };
+
+
+        /// Check the thread on the first access and then on every interval-th access,
+        /// which still catches sustained access from a second thread at a fraction of the cost.
+        /// @tparam	interval	The number of accesses per check.
+
+        template<int interval = 1024>
+        class sampled {
+        public:
+            bool operator()() {
+                if (--m_countdown > 0)
+                    return true;
+                m_countdown = interval;
+                return m_check();
+            }
+
+        private:
+            checked m_check;
+            int     m_countdown {1};
+        };
+
+    }    // namespace thread_check
+
     
     ///	A generic circular buffer designed specifically for access from a single thread.
     ///
@@ -16,8 +79,18 @@ namespace c74::min::lib {
     ///	Reading items from the vector can then return chunks of the N most recent items.
     ///	The initial design of this class is for use as an audio sample delay buffer,
     ///	however it's functionality has been generalized to allow for other datatypes and applications.
+    ///
+    ///	Whenever the size is a power of two, positions are wrapped with a bit mask instead of a division.
+    ///	Delay lines that read single items often should therefore prefer such sizes, see next_power_of_two().
+    ///
+    ///	Optionally, the first items are mirrored in a guard region behind the end of the storage.
+    ///	Then any window of up to guard() + 1 consecutive items, as needed for interpolation, can be read with window()
+    ///	from a single pointer without checking for the wrap.
+    ///
+    /// @tparam	T					The type of the items.
+    /// @tparam	thread_check_type	One of the thread_check policies, which determines how single-threaded access is asserted.
 
-    template<class T>
+    template<class T, class thread_check_type = thread_check::checked>
     class circular_storage {
     public:
         /// Constructor specifies a fixed amount of storage for the container.
@@ -26,12 +99,43 @@ namespace c74::min::lib {
 
         explicit circular_storage(std::size_t item_count)
         : m_items(item_count)
-        , m_size(item_count) {}
+        , m_size(item_count) {
+            update_mask();
+        }
+
+
+        /// Constructor for a container with a mirrored guard region.
+        /// @param	item_count	The number of items to be stored in the container.
+        /// @param	guard_count	The number of items at the beginning that are mirrored behind the end.
+        ///						Windows of up to guard_count + 1 items can be read with window().
+
+        circular_storage(std::size_t item_count, std::size_t guard_count)
+        : m_items(item_count + guard_count)
+        , m_size(item_count)
+        , m_guard(guard_count) {
+            assert(guard_count <= item_count);
+            update_mask();
+        }
 
 
         circular_storage(std::pair<size_t, size_t> capacity_and_size)
         : m_items(capacity_and_size.first)
-        , m_size(capacity_and_size.second) {}
+        , m_size(capacity_and_size.second) {
+            update_mask();
+        }
+
+
+        /// Return the smallest power of two that is not less than an item count,
+        /// e.g. to choose a size for which positions are wrapped with a bit mask.
+        /// @param	item_count	The minimum number of items.
+        /// @return				The power of two.
+
+        static std::size_t next_power_of_two(std::size_t item_count) {
+            std::size_t result {1};
+            while (result < item_count)
+                result <<= 1;
+            return result;
+        }
 
 
         /// Write a block of items into the container.
@@ -51,6 +155,7 @@ namespace c74::min::lib {
             }
 
             std::copy_n(new_input.begin(), count, m_items.begin() + m_index);
+            mirror(m_index, m_index + count);
             m_index += count;
 
             if (wrap) {
@@ -58,6 +163,7 @@ namespace c74::min::lib {
 
                 count = new_input.size() - offset;
                 std::copy_n(new_input.begin() + offset, count, m_items.begin());
+                mirror(0, count);
                 m_index = count;
             }
         }
@@ -70,11 +176,37 @@ namespace c74::min::lib {
             assert(check_thread());
 
             m_items[m_index] = new_input;
+            if (m_index < m_guard)
+                m_items[m_size + m_index] = new_input;
             ++m_index;
             if (m_index >= size())
                 m_index = 0;
 
             m_items[m_index] = T();    // delays <1 sample require us to clear the old value at new index
+            if (m_index < m_guard)
+                m_items[m_size + m_index] = T();
+        }
+
+
+        /// Write a block of items into the container.
+        ///	The result is the same as writing the items one at a time with write(const T&),
+        ///	but they are copied in at most two contiguous segments.
+        ///	@param	new_input	The items to add.
+        ///	@param	count		The number of items. May not be more than the size of the container.
+
+        void write(const T* new_input, std::size_t count) {
+            assert(check_thread());
+            assert(count <= size());
+
+            auto first = std::min(count, size() - m_index);
+            std::copy_n(new_input, first, m_items.begin() + m_index);
+            std::copy_n(new_input + first, count - first, m_items.begin());
+            mirror(m_index, m_index + first);
+            mirror(0, count - first);
+            m_index = wrap(m_index + count);
+
+            m_items[m_index] = T();    // as for writing single items
+            mirror(m_index, m_index + 1);
         }
 
 
@@ -160,8 +292,45 @@ namespace c74::min::lib {
         ///	@see	head()
 
         T tail(size_t offset = 0) {
-            // TODO: benchmark / evaluate use of modulo here
-            return m_items[(m_index + offset) % size()];
+            return m_items[wrap(m_index + offset)];
+        }
+
+
+        /// Read a block of items out from the container, starting at an offset from the oldest item.
+        ///	The result is the same as calling tail(offset + i) for every item i of the output,
+        ///	but the items are copied in at most two contiguous segments.
+        ///	@param	output	A place to write the items from the buffer.
+        ///	@param	count	The number of items to read. May not be more than the size of the container.
+        /// @param	offset	The number of items newer than the oldest value that the first item is.
+        ///	@see	tail()
+
+        void read_tail(T* output, std::size_t count, std::size_t offset = 0) {
+            assert(check_thread());
+            assert(count <= size());
+
+            auto start = wrap(m_index + offset);
+            auto first = std::min(count, size() - start);
+            std::copy_n(m_items.begin() + start, first, output);
+            std::copy_n(m_items.begin(), count - first, output + first);
+        }
+
+
+        /// Return a pointer to the item tail(offset), behind which the items tail(offset + 1) to tail(offset + guard())
+        ///	follow contiguously. The pointer is valid until the next write.
+        /// @param	offset	The number of items newer than the oldest value that the first item is.
+        ///	@return			A pointer to the first item of the window.
+        ///	@see	tail()
+
+        const T* window(std::size_t offset = 0) const {
+            return m_items.data() + wrap(m_index + offset);
+        }
+
+
+        ///	Return the number of items that are mirrored behind the end of the storage.
+        /// @return	The size of the guard region.
+
+        std::size_t guard() const {
+            return m_guard;
         }
 
 
@@ -179,7 +348,9 @@ namespace c74::min::lib {
         void clear() {
             assert(check_thread());
             m_items.clear();
-            m_size = 0;
+            m_size  = 0;
+            m_guard = 0;
+            update_mask();
         }
 
 
@@ -195,7 +366,7 @@ namespace c74::min::lib {
         /// @return	The capacity (or maximum size) of the container.
 
         std::size_t capacity() {
-            return m_items.size();
+            return m_items.size() - m_guard;
         }
 
         ///	Change the number of items in the container.
@@ -204,8 +375,10 @@ namespace c74::min::lib {
         /// @param	new_size	The new item count for the circular storage container.
 
         void resize(std::size_t new_size) {
-            assert(new_size <= m_items.size());
+            assert(new_size <= capacity());
             m_size = new_size;
+            update_mask();
+            mirror(0, m_guard);
             // if m_index is out of bounds after resize, we zero the memory to prevent invalid output from history
             if (m_index >= m_size) {
                 m_index = 0;
@@ -215,6 +388,7 @@ namespace c74::min::lib {
 
 
         /// Get a reference to an individual item by index from the container.
+        /// Items that are changed through the reference are not mirrored in the guard region.
         /// @param	index	The index of the item to fetch.
         /// @return			A reference to the item.
 
@@ -224,26 +398,39 @@ namespace c74::min::lib {
         }
 
     private:
-        /// Confirm that calls to multiple public methods are happening on the same thread.
-        /// First call to this method will set the m_thread variable.
-        /// Every call after will compare to the current thread id to m_thread.
+        /// Wrap a position into the container, with a bit mask for power-of-two sizes.
+
+        std::size_t wrap(std::size_t position) const {
+            if (m_mask)
+                return position & m_mask;
+            return position % m_size;
+        }
+
+        /// Copy the items in [begin, end) that lie in the guard region behind the end of the storage.
+
+        void mirror(std::size_t begin, std::size_t end) {
+            end = std::min(end, m_guard);
+            if (begin < end)
+                std::copy(m_items.begin() + begin, m_items.begin() + end, m_items.begin() + m_size + begin);
+        }
+
+        void update_mask() {
+            m_mask = (m_size > 1 && (m_size & (m_size - 1)) == 0) ? m_size - 1 : 0;
+        }
+
+        /// Confirm that calls to multiple public methods are happening on the same thread, as far as the policy checks.
         /// @return         false if the thread id changes between calls, else true
 
         bool check_thread() {
-            if (m_thread == null_thread) {
-                m_thread = {std::this_thread::get_id()};
-                return true;
-            }
-            else {
-                return std::this_thread::get_id() == m_thread;
-            }
+            return m_thread_check();
         }
 
         std::vector<T>  m_items;        ///< storage for the circular buffer's data
         std::size_t     m_index{};      ///< location of the record head
         std::size_t     m_size;         ///< the size of the circular buffer (may be different from the amount of allocated storage)
-        std::thread::id m_thread;       ///< used to ensure we don't access unsafely from multiple threads
-        std::thread::id null_thread;    ///< save the default constructor output to catch the first call in check_thread()
+        std::size_t     m_mask{};       ///< m_size - 1 if m_size is a power of two, else 0
+        std::size_t     m_guard{};      ///< number of items at the beginning that are mirrored behind the end
+        thread_check_type m_thread_check;    ///< used to ensure we don't access unsafely from multiple threads
     };
 
 
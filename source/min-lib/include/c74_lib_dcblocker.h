@@ -25,16 +25,123 @@ namespace c74::min::lib {
         ///	@return		Calculated sample
 
         sample operator()(sample x) {
-            auto y = x - x_1 + y_1 * 0.9997;
+            auto y = x - x_1 + y_1 * k_gain;
             y_1    = y;
             x_1    = x;
             return y;
         }
 
+
+        /// Calculate a block of samples.
+        /// @param	input		frame_count input samples.
+        /// @param	output		frame_count output samples. May be the same as input.
+        /// @param	frame_count	The number of samples.
+
+        void operator()(const sample* input, sample* output, std::size_t frame_count) {
+            auto x_1 = this->x_1;    // in registers for the whole block
+            auto y_1 = this->y_1;
+
+            for (std::size_t i = 0; i < frame_count; ++i) {
+                auto x    = input[i];
+                y_1       = x - x_1 + y_1 * k_gain;
+                x_1       = x;
+                output[i] = y_1;
+            }
+            this->x_1 = x_1;
+            this->y_1 = y_1;
+        }
+
     private:
+        static constexpr number k_gain { 0.9997 };    ///< feedback gain, which sets the cutoff frequency
+
         sample x_1{};    ///< feedforward history
         sample y_1{};    ///< feedback history
     };
 
 
+    ///	Multichannel version of dcblocker, with the history of all channels stored in arrays.
+    ///	Planar buffers are filtered one channel after the other, with the history in registers;
+    ///	interleaved buffers are filtered one frame after the other, all channels at once, which the compiler can vectorize.
+
+    class dcblocker_bank {
+    public:
+        /// Constructor with the number of channels.
+        /// @param	channel_count	The number of channels.
+
+        explicit dcblocker_bank(int channel_count = 2)
+        : m_x_1(channel_count)
+        , m_y_1(channel_count) {}
+
+
+        /// Return the number of channels.
+        /// @return	The number of channels.
+
+        int channel_count() const {
+            return static_cast<int>(m_y_1.size());
+        }
+
+
+        /// Clear the history of all channels.
+
+        void clear() {
+            std::fill(m_x_1.begin(), m_x_1.end(), 0.0);
+            std::fill(m_y_1.begin(), m_y_1.end(), 0.0);
+        }
+
+
+        /// Calculate a block of samples for every channel from planar buffers.
+        /// @param	inputs		One buffer of frame_count input samples per channel.
+        /// @param	outputs		One buffer of frame_count output samples per channel. May be the same as the inputs.
+        /// @param	frame_count	The number of samples.
+
+        void operator()(const sample* const* inputs, sample* const* outputs, std::size_t frame_count) {
+            for (auto channel = 0; channel < channel_count(); ++channel) {
+                auto x_1    = m_x_1[channel];
+                auto y_1    = m_y_1[channel];
+                auto input  = inputs[channel];
+                auto output = outputs[channel];
+
+                for (std::size_t i = 0; i < frame_count; ++i) {
+                    auto x    = input[i];
+                    y_1       = x - x_1 + y_1 * k_gain;
+                    x_1       = x;
+                    output[i] = y_1;
+                }
+                m_x_1[channel] = x_1;
+                m_y_1[channel] = y_1;
+            }
+        }
+
+
+        /// Calculate a block of samples for every channel from an interleaved buffer.
+        /// @param	input		frame_count frames of channel_count() input samples each.
+        /// @param	output		frame_count frames of channel_count() output samples each. May be the same as input.
+        /// @param	frame_count	The number of frames.
+
+        void process_interleaved(const sample* input, sample* output, std::size_t frame_count) {
+            const auto channels = static_cast<std::size_t>(channel_count());
+            const auto x_1      = m_x_1.data();
+            const auto y_1      = m_y_1.data();
+
+            for (std::size_t i = 0; i < frame_count; ++i) {
+                auto x = input + i * channels;
+                auto y = output + i * channels;
+
+                for (std::size_t channel = 0; channel < channels; ++channel) {
+                    auto in      = x[channel];
+                    y_1[channel] = in - x_1[channel] + y_1[channel] * k_gain;
+                    x_1[channel] = in;
+                    y[channel]   = y_1[channel];
+                }
+            }
+        }
+
+    private:
+        static constexpr number k_gain { 0.9997 };    ///< feedback gain, which sets the cutoff frequency
+
+        vector<sample> m_x_1;    ///< feedforward history of each channel
+        vector<sample> m_y_1;    ///< feedback history of each channel
+    };
+
+
 }   // namespace c74::min::lib
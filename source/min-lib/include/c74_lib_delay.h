@@ -9,6 +9,7 @@ namespace c74::min::lib {
 
 
     ///	A single-channel interpolating delay line.
+    ///	The capacity is reserved at creation, so changing the delay time never allocates memory: it only moves the read position.
 
     class delay {
     public:
@@ -18,7 +19,8 @@ namespace c74::min::lib {
         ///		Default is 256 samples.
 
         delay(number initial_size = 256)
-        : m_history(static_cast<size_t>(initial_size + 5))    // 5 extra samples to accomodate the 'now' sample + up to 4 interpolation samples
+        : m_history(history_size(static_cast<size_t>(initial_size)), k_guard_size)
+        , m_capacity(initial_size)
         {
             size(initial_size);
         }
@@ -30,36 +32,58 @@ namespace c74::min::lib {
         ///			First value (capacity) must be greater than the second value (size).
 
         delay(std::pair<size_t, number> capacity_and_size)
-        : m_history(capacity_and_size.first + 5) {
+        : m_history(history_size(capacity_and_size.first), k_guard_size)
+        , m_capacity(static_cast<number>(capacity_and_size.first)) {
             assert(capacity_and_size.first > capacity_and_size.second);
             size(capacity_and_size.second);
         }
 
 
         /// Set a new delay time in samples.
-        /// @param	new_size	The new delay time in samples.
+        /// The change is immediate, which cancels a crossfade that is still running.
+        /// @param	new_size	The new delay time in samples. Will be clamped to the capacity.
 
         void size(number new_size) {
-            m_size            = new_size;
+            m_size            = MIN_CLAMP(new_size, 0.0, m_capacity);
             m_size_integral   = static_cast<std::size_t>(m_size);
             m_size_fractional = m_size - m_size_integral;
+            m_fade_remaining  = 0;
         }
 
         /// Set a new delay time in samples.
-        /// @param	new_size	The new delay time in samples.
+        /// @param	new_size	The new delay time in samples. Will be clamped to the capacity.
 
         void size(size_t new_size) {
-            m_size = static_cast<number>(new_size);
-            m_size_fractional = 0;
+            size(static_cast<number>(new_size));
         }
 
 
         /// Set a new delay time in samples.
-        /// @param	new_size	The new delay time in samples.
+        /// @param	new_size	The new delay time in samples. Will be clamped to the capacity.
 
         void size(int new_size) {
-            m_size = static_cast<number>(new_size);
-            m_size_fractional = 0;
+            size(static_cast<number>(new_size));
+        }
+
+
+        /// Set a new delay time in samples, crossfading from the output at the old delay time to the output at the new one,
+        /// which avoids the clicks and zipper noise of jumping to the new read position.
+        /// @param	new_size				The new delay time in samples. Will be clamped to the capacity.
+        /// @param	crossfade_frame_count	The duration of the crossfade in samples.
+
+        void size(number new_size, std::size_t crossfade_frame_count) {
+            // if a crossfade is still running, fade from whichever of its two delay times is heard more
+            if (m_fade_remaining == 0 || m_fade_gain < 0.5) {
+                m_fade_integral   = m_size_integral;
+                m_fade_fractional = m_size_fractional;
+            }
+            size(new_size);
+
+            if (crossfade_frame_count > 0) {
+                m_fade_remaining = crossfade_frame_count;
+                m_fade_step      = 1.0 / crossfade_frame_count;
+                m_fade_gain      = 1.0;
+            }
         }
 
 
@@ -71,6 +95,14 @@ namespace c74::min::lib {
         }
 
 
+        /// Return the maximum delay time in samples, which is fixed at creation.
+        /// @return The capacity in samples.
+
+        number capacity() const {
+            return m_capacity;
+        }
+
+
         /// Set a new delay time in milliseconds.
         /// @param	new_size_ms		The new delay time in milliseconds.
         /// @param	sampling_frequency		The sampling frequency of the environment in hertz.
@@ -102,13 +134,9 @@ namespace c74::min::lib {
         ///	@return	output	The item from the buffer.
 
         sample tail(int offset = 0) {
-
-            // calculate the difference between the capacity and our delay so that tail() can be properly offset
-            // extra 2 "now" samples to allow for interpolation
-            size_t true_offset = m_history.capacity() - integral_size() - 2 + offset;
-
-            return m_interpolator(m_history.tail(true_offset + 2), m_history.tail(true_offset + 1), m_history.tail(true_offset),
-                m_history.tail(true_offset - 1), fractional_size());
+            return m_interpolator.visit([&](auto& interpolate) {
+                return tail(interpolate, offset);
+            });
         }
 
 
@@ -117,6 +145,11 @@ namespace c74::min::lib {
 
         void write(sample new_input) {
             m_history.write(new_input);
+
+            if (m_fade_remaining > 0) {
+                --m_fade_remaining;
+                m_fade_gain = m_fade_remaining * m_fade_step;
+            }
         }
 
 
@@ -145,11 +178,68 @@ namespace c74::min::lib {
         }
 
 
+        /// Calculate a block of samples.
+        /// The interpolation type is looked up once for the whole block rather than for every sample.
+        /// @param	input			frame_count samples to write.
+        /// @param	output			frame_count samples that are read. May be the same as input.
+        /// @param	frame_count		The number of samples.
+
+        void operator()(const sample* input, sample* output, std::size_t frame_count) {
+            m_interpolator.visit([&](auto& interpolate) {
+                for (std::size_t i = 0; i < frame_count; ++i) {
+                    write(input[i]);
+                    output[i] = tail(interpolate, 0);
+                }
+            });
+        }
+
+
     private:
-        circular_storage<sample> m_history;            ///< Memory for storing the delayed samples.
+        // the history is written every sample, so the thread is only checked every now and then
+        using history_type = circular_storage<sample, thread_check::sampled<>>;
+
+        static constexpr size_t k_guard_size {3};    ///< the history mirrors enough samples to read 4 for interpolation in one window
+
+        // 5 extra samples to accomodate the 'now' sample + up to 4 interpolation samples,
+        // rounded up to a power of two so that the history is wrapped with a bit mask rather than a division
+
+        static size_t history_size(size_t capacity) {
+            return history_type::next_power_of_two(capacity + 5);
+        }
+
+        template<class interpolator_type>
+        sample tail(interpolator_type& interpolate, int offset) {
+            auto y = read(interpolate, offset, m_size_integral, m_size_fractional);
+
+            if (m_fade_remaining > 0) {
+                auto faded = read(interpolate, offset, m_fade_integral, m_fade_fractional);
+                y += (faded - y) * m_fade_gain;
+            }
+            return y;
+        }
+
+        template<class interpolator_type>
+        sample read(interpolator_type& interpolate, int offset, std::size_t integral, double fractional) {
+            // calculate the difference between the capacity and our delay so that tail() can be properly offset
+            // extra 2 "now" samples to allow for interpolation
+            size_t true_offset = m_history.capacity() - integral - 2 + offset;
+
+            // the four samples around the read position, which the guard region of the history makes contiguous
+            auto x = m_history.window(true_offset - 1);
+
+            return interpolate(x[3], x[2], x[1], x[0], fractional);
+        }
+
+        history_type             m_history;            ///< Memory for storing the delayed samples.
+        number                   m_capacity;           ///< Maximum delay time in samples.
         number                   m_size;               ///< Delay time in samples. May include a fractional component.
         std::size_t              m_size_integral;      ///< The integral component of the delay time.
         double                   m_size_fractional;    ///< The fractional component of the delay time.
+        std::size_t              m_fade_integral {};      ///< The integral component of the delay time that is faded out.
+        double                   m_fade_fractional {};    ///< The fractional component of the delay time that is faded out.
+        std::size_t              m_fade_remaining {};     ///< The number of samples until the crossfade is complete.
+        double                   m_fade_step {};          ///< The change of the crossfade gain per sample.
+        double                   m_fade_gain {};          ///< The gain of the delay time that is faded out.
         interpolator::proxy<>    m_interpolator{
             interpolator::type::cubic};    ///< The interpolator instance used to produce interpolated output.
     };
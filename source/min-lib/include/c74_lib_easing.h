@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include "c74_lib_interpolator.h"
+
 namespace c74::min::lib::easing {
 
 
@@ -585,4 +587,228 @@ namespace c74::min::lib::easing {
     }
 
 
+
+    /// Apply one of the standard easing functions to a block of numbers.
+    /// The function is chosen once for the whole block rather than once per number,
+    /// so the loop over the block can be inlined and, for the polynomial functions, vectorized by the compiler.
+    /// @tparam	T		The type of number to use for the calculations (e.g. float, double, number, or sample).
+    /// @param	name	The easing function to apply as enumerated in the #easing::function enum.
+    ///	@param	input	The values to feed as input into the easing function.
+    ///	@param	output	The "eased" output. May be the same as input.
+    ///	@param	count	The number of values.
+
+    template<typename T>
+    void apply(easing::function name, const T* input, T* output, std::size_t count) {
+        auto loop = [input, output, count](auto f) {
+            for (std::size_t i = 0; i < count; ++i)
+                output[i] = f(input[i]);
+        };
+
+        switch (name) {
+            case easing::function::linear:
+                return loop(linear<T>);
+            case easing::function::in_back:
+                return loop(in_back<T>);
+            case easing::function::in_out_back:
+                return loop(in_out_back<T>);
+            case easing::function::out_back:
+                return loop(out_back<T>);
+            case easing::function::in_bounce:
+                return loop(in_bounce<T>);
+            case easing::function::in_out_bounce:
+                return loop(in_out_bounce<T>);
+            case easing::function::out_bounce:
+                return loop(out_bounce<T>);
+            case easing::function::in_circular:
+                return loop(in_circular<T>);
+            case easing::function::in_out_circular:
+                return loop(in_out_circular<T>);
+            case easing::function::out_circular:
+                return loop(out_circular<T>);
+            case easing::function::in_cubic:
+                return loop(in_cubic<T>);
+            case easing::function::in_out_cubic:
+                return loop(in_out_cubic<T>);
+            case easing::function::out_cubic:
+                return loop(out_cubic<T>);
+            case easing::function::in_elastic:
+                return loop(in_elastic<T>);
+            case easing::function::in_out_elastic:
+                return loop(in_out_elastic<T>);
+            case easing::function::out_elastic:
+                return loop(out_elastic<T>);
+            case easing::function::in_exponential:
+                return loop(in_exponential<T>);
+            case easing::function::in_out_exponential:
+                return loop(in_out_exponential<T>);
+            case easing::function::out_exponential:
+                return loop(out_exponential<T>);
+            case easing::function::in_quadratic:
+                return loop(in_quadratic<T>);
+            case easing::function::in_out_quadratic:
+                return loop(in_out_quadratic<T>);
+            case easing::function::out_quadratic:
+                return loop(out_quadratic<T>);
+            case easing::function::in_quartic:
+                return loop(in_quartic<T>);
+            case easing::function::in_out_quartic:
+                return loop(in_out_quartic<T>);
+            case easing::function::out_quartic:
+                return loop(out_quartic<T>);
+            case easing::function::in_quintic:
+                return loop(in_quintic<T>);
+            case easing::function::in_out_quintic:
+                return loop(in_out_quintic<T>);
+            case easing::function::out_quintic:
+                return loop(out_quintic<T>);
+            case easing::function::in_sine:
+                return loop(in_sine<T>);
+            case easing::function::in_out_sine:
+                return loop(in_out_sine<T>);
+            case easing::function::out_sine:
+                return loop(out_sine<T>);
+            case easing::function::enum_count:
+                assert(false);
+        }
+    }
+
+
+    /// One of the standard easing functions sampled into a table, for evaluating it many times (e.g. per sample)
+    /// without the calls of sin() and pow() or the branches of the exact function.
+    /// The input is clamped to the range 0.0 to 1.0.
+    ///
+    /// With the default resolution the error of the smooth functions (e.g. in_cubic, out_sine or in_elastic) is below 1e-4
+    /// with linear and below 1e-6 with cubic interpolation. The in-out functions are only as accurate as linear interpolation at their midpoint,
+    /// and the corners of bounce, the vertical ends of circular and the jump of exponential at its end cost up to 3e-2.
+    /// The tests in Easing_test.cpp document the bounds for every function.
+
+    class table {
+    public:
+        /// Options for interpolating between the points of the table.
+
+        enum class interpolation {
+            linear,    ///< 2 points, exact at the points and continuous
+            cubic      ///< 4 points with a Catmull-Rom spline, smooth wherever the function is
+        };
+
+
+        /// Create a table.
+        /// @param	name			The easing function to sample as enumerated in the #easing::function enum.
+        /// @param	resolution		The number of intervals between the points of the table.
+        /// @param	a_interpolation	The interpolation between the points.
+
+        explicit table(easing::function name = easing::function::linear, int resolution = 256, interpolation a_interpolation = interpolation::cubic)
+        : m_interpolation { a_interpolation } {
+            change(name, resolution);
+        }
+
+
+        /// Sample another easing function into the table. This allocates memory.
+        /// @param	name			The easing function to sample as enumerated in the #easing::function enum.
+        /// @param	resolution		The number of intervals between the points of the table.
+
+        void change(easing::function name, int resolution = 256) {
+            resolution   = std::max(resolution, 1);
+            m_resolution = resolution;
+            m_function   = name;
+
+            // one point beyond each end, on the parabola through the last three, so that cubic interpolation needs no special case at the ends
+            m_points.resize(resolution + 3);
+            for (auto i = 0; i <= resolution; ++i)
+                m_points[i + 1] = apply(name, static_cast<double>(i) / resolution);
+
+            const auto n = resolution + 1;
+            if (resolution > 1) {
+                m_points[0]     = 3.0 * m_points[1] - 3.0 * m_points[2] + m_points[3];
+                m_points[n + 1] = 3.0 * m_points[n] - 3.0 * m_points[n - 1] + m_points[n - 2];
+            }
+            else {
+                m_points[0]     = 2.0 * m_points[1] - m_points[2];
+                m_points[n + 1] = 2.0 * m_points[n] - m_points[n - 1];
+            }
+        }
+
+
+        /// Return the easing function in the table.
+        /// @return The easing function.
+
+        easing::function function() const {
+            return m_function;
+        }
+
+
+        /// Return the number of intervals between the points of the table.
+        /// @return The resolution.
+
+        int resolution() const {
+            return m_resolution;
+        }
+
+
+        /// Set the interpolation between the points.
+        /// @param	a_interpolation	The new interpolation.
+
+        void mode(interpolation a_interpolation) {
+            m_interpolation = a_interpolation;
+        }
+
+
+        /// Return the interpolation between the points.
+        /// @return The interpolation.
+
+        interpolation mode() const {
+            return m_interpolation;
+        }
+
+
+        /// Evaluate the easing function.
+        ///	@param	x		The value to feed as input into the easing function.
+        ///	@return			The "eased" output.
+
+        template<typename T>
+        T operator()(T x) const {
+            if (m_interpolation == interpolation::cubic)
+                return static_cast<T>(lookup(interpolator::spline<double>(), x));
+            return static_cast<T>(lookup(interpolator::linear<double>(), x));
+        }
+
+
+        /// Evaluate the easing function for a block of numbers.
+        ///	@param	input	The values to feed as input into the easing function.
+        ///	@param	output	The "eased" output. May be the same as input.
+        ///	@param	count	The number of values.
+
+        template<typename T>
+        void operator()(const T* input, T* output, std::size_t count) const {
+            if (m_interpolation == interpolation::cubic) {
+                interpolator::spline<double> interpolate;
+                for (std::size_t i = 0; i < count; ++i)
+                    output[i] = static_cast<T>(lookup(interpolate, input[i]));
+            }
+            else {
+                interpolator::linear<double> interpolate;
+                for (std::size_t i = 0; i < count; ++i)
+                    output[i] = static_cast<T>(lookup(interpolate, input[i]));
+            }
+        }
+
+    private:
+        template<class interpolator_type>
+        double lookup(interpolator_type&& interpolate, double x) const {
+            auto position = std::min(std::max(x, 0.0), 1.0) * m_resolution;
+            auto index    = std::min(static_cast<int>(position), m_resolution - 1);
+            auto delta    = position - index;
+            auto p        = m_points.data() + index;    // p[1] is the point at index
+
+            return interpolate(p[0], p[1], p[2], p[3], delta);
+        }
+
+        easing::function    m_function {easing::function::linear};
+        int                 m_resolution {};
+        interpolation       m_interpolation;
+        std::vector<double> m_points;    ///< resolution + 1 points from 0.0 to 1.0, with one more at each end
+    };
+
+
+
 }    // namespace c74::min::lib::easing
@@ -381,5 +381,246 @@ namespace c74::min::lib {
             number m_cycle_count;
         };
 
+
+
+        /// The correction of a unit step that the PolyBLEP technique adds to the samples next to a discontinuity,
+        /// i.e. the difference between a band-limited step approximated by a polynomial and the ideal step, over two samples.
+        /// @param	t	The phase of the sample, where the discontinuity is at 0.0 (and 1.0).
+        /// @param	dt	The increment of the phase per sample.
+        /// @return	The correction, which is zero apart from the samples closer than dt to the discontinuity.
+
+        inline number polyblep(number t, number dt) {
+            if (t < dt) {
+                auto x = t / dt;
+                return x + x - x * x - 1.0;
+            }
+            else if (t > 1.0 - dt) {
+                auto x = (t - 1.0) / dt;
+                return x * x + x + x + 1.0;
+            }
+            return 0.0;
+        }
+
+
+        /// The correction of a unit change of slope that the PolyBLAMP technique adds to the samples next to a corner,
+        /// the integral of polyblep(), in units of dt.
+        /// @param	t	The phase of the sample, where the corner is at 0.0 (and 1.0).
+        /// @param	dt	The increment of the phase per sample.
+        /// @return	The correction, which is zero apart from the samples closer than dt to the corner.
+
+        inline number polyblamp(number t, number dt) {
+            if (t < dt) {
+                auto x = t / dt - 1.0;
+                return -x * x * x / 3.0;
+            }
+            else if (t > 1.0 - dt) {
+                auto x = (t - 1.0) / dt + 1.0;
+                return x * x * x / 3.0;
+            }
+            return 0.0;
+        }
+
+
+        /// Generates a sawtooth waveform from -1 to 1, band-limited with PolyBLEP,
+        /// so that it may also be generated at audio rate without a large wavetable or oversampling.
+        /// @tparam T       render output as this datatype. algorithm was designed to assume the use of floating point.
+
+        template<typename T = sample>
+        class sawtooth_polyblep {
+        public:
+            /// Create an instance of a generator to calculate an output with N points.
+            /// @param	size	The number of points over which the generator will produce a function.
+            ///	@param	count	number of cycles of the wave to generate across the vector. default is 1.
+
+            sawtooth_polyblep(size_t size = 1, double count = 1.0)
+            : m_step { std::min(count / size, 0.5) } {}
+
+
+            /// Set the frequency, to generate the waveform at audio rate rather than into a table.
+            /// @param	oscillator_frequency	The frequency in hertz. It is limited to the nyquist frequency.
+            /// @param	sampling_frequency		The sampling frequency of the environment in hertz.
+
+            void frequency(number oscillator_frequency, number sampling_frequency) {
+                m_step = std::min(std::abs(oscillator_frequency) / sampling_frequency, 0.5);
+            }
+
+
+            /// Set the phase.
+            ///	@param	new_phase	The new phase in the range [0.0, 1.0).
+
+            void phase(number new_phase) {
+                m_phase = new_phase - std::floor(new_phase);
+            }
+
+
+            /// Called by std::generate to produce the next value in the series to produce this function.
+            ///	@return	The next value in the series.
+
+            T operator()() {
+                auto t = m_phase;
+
+                m_phase += m_step;
+                if (m_phase >= 1.0)
+                    m_phase -= 1.0;
+                return T(2.0 * t - 1.0 - polyblep(t, m_step));
+            }
+
+
+            /// Fill a block with the next values in the series.
+            /// @param	output	The block to fill.
+            /// @param	count	The number of values.
+
+            void operator()(T* output, size_t count) {
+                for (size_t i = 0; i < count; ++i)
+                    output[i] = (*this)();
+            }
+
+        private:
+            number m_phase {};
+            number m_step;
+        };
+
+
+        /// Generates a square (or pulse) waveform from -1 to 1, band-limited with PolyBLEP.
+        /// @tparam T       render output as this datatype. algorithm was designed to assume the use of floating point.
+
+        template<typename T = sample>
+        class square_polyblep {
+        public:
+            /// Create an instance of a generator to calculate an output with N points.
+            /// @param	size	The number of points over which the generator will produce a function.
+            ///	@param	count	number of cycles of the wave to generate across the vector. default is 1.
+            ///	@param	width	The part of each cycle at 1, the rest is at -1. default is 0.5.
+
+            square_polyblep(size_t size = 1, double count = 1.0, double width = 0.5)
+            : m_step { std::min(count / size, 0.5) }
+            , m_width { width } {}
+
+
+            /// Set the frequency, to generate the waveform at audio rate rather than into a table.
+            /// @param	oscillator_frequency	The frequency in hertz. It is limited to the nyquist frequency.
+            /// @param	sampling_frequency		The sampling frequency of the environment in hertz.
+
+            void frequency(number oscillator_frequency, number sampling_frequency) {
+                m_step = std::min(std::abs(oscillator_frequency) / sampling_frequency, 0.5);
+            }
+
+
+            /// Set the phase.
+            ///	@param	new_phase	The new phase in the range [0.0, 1.0).
+
+            void phase(number new_phase) {
+                m_phase = new_phase - std::floor(new_phase);
+            }
+
+
+            /// Set the pulse width.
+            ///	@param	new_width	The part of each cycle at 1, in the range (0.0, 1.0).
+
+            void width(number new_width) {
+                m_width = new_width;
+            }
+
+
+            /// Called by std::generate to produce the next value in the series to produce this function.
+            ///	@return	The next value in the series.
+
+            T operator()() {
+                auto t    = m_phase;
+                auto fall = t - m_width + (t < m_width ? 1.0 : 0.0);    // the phase relative to the falling edge
+
+                m_phase += m_step;
+                if (m_phase >= 1.0)
+                    m_phase -= 1.0;
+                return T((t < m_width ? 1.0 : -1.0) + polyblep(t, m_step) - polyblep(fall, m_step));
+            }
+
+
+            /// Fill a block with the next values in the series.
+            /// @param	output	The block to fill.
+            /// @param	count	The number of values.
+
+            void operator()(T* output, size_t count) {
+                for (size_t i = 0; i < count; ++i)
+                    output[i] = (*this)();
+            }
+
+        private:
+            number m_phase {};
+            number m_step;
+            number m_width;
+        };
+
+
+        /// Generates a triangle wave from -1 to 1 like triangle, band-limited with PolyBLAMP.
+        /// @tparam T       render output as this datatype. algorithm was designed to assume the use of floating point.
+
+        template<typename T = sample>
+        class triangle_polyblamp {
+        public:
+            /// Create an instance of a generator to calculate an output with N points.
+            /// @param	size	The number of points over which the generator will produce a function.
+            ///	@param	count	number of cycles of the wave to generate across the vector. default is 1.
+
+            triangle_polyblamp(size_t size = 1, double count = 1.0)
+            : m_step { std::min(count / size, 0.5) } {}
+
+
+            /// Set the frequency, to generate the waveform at audio rate rather than into a table.
+            /// @param	oscillator_frequency	The frequency in hertz. It is limited to the nyquist frequency.
+            /// @param	sampling_frequency		The sampling frequency of the environment in hertz.
+
+            void frequency(number oscillator_frequency, number sampling_frequency) {
+                m_step = std::min(std::abs(oscillator_frequency) / sampling_frequency, 0.5);
+            }
+
+
+            /// Set the phase.
+            ///	@param	new_phase	The new phase in the range [0.0, 1.0).
+
+            void phase(number new_phase) {
+                m_phase = new_phase - std::floor(new_phase);
+            }
+
+
+            /// Called by std::generate to produce the next value in the series to produce this function.
+            ///	@return	The next value in the series.
+
+            T operator()() {
+                auto t = m_phase;
+
+                m_phase += m_step;
+                if (m_phase >= 1.0)
+                    m_phase -= 1.0;
+
+                number out;
+                if (t <= 0.25)
+                    out = t / 0.25;
+                else if (t >= 0.75)
+                    out = -1.0 + (t - 0.75) / 0.25;
+                else
+                    out = 1.0 - (t - 0.25) / 0.25;
+
+                // the slope changes by -8 at the peak and by 8 at the trough
+                auto peak   = t - 0.25 + (t < 0.25 ? 1.0 : 0.0);
+                auto trough = t - 0.75 + (t < 0.75 ? 1.0 : 0.0);
+                return T(out + 8.0 * m_step * (polyblamp(trough, m_step) - polyblamp(peak, m_step)));
+            }
+
+
+            /// Fill a block with the next values in the series.
+            /// @param	output	The block to fill.
+            /// @param	count	The number of values.
+
+            void operator()(T* output, size_t count) {
+                for (size_t i = 0; i < count; ++i)
+                    output[i] = (*this)();
+            }
+
+        private:
+            number m_phase {};
+            number m_step;
+        };
+
     }    // namespace generator
 }      // namespace c74::min::lib
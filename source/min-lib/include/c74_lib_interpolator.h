@@ -12,6 +12,8 @@
 #define MIN_CONSTEXPR
 #endif
 
+#include <tuple>
+
 namespace c74::min::lib {
 
     /// Defines several methods for <a href="http://en.wikipedia.org/wiki/Interpolation">interpolating</a> between discrete data points such
@@ -57,7 +59,7 @@ namespace c74::min::lib {
         ///	@tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
-        class none : public base<T> {
+        class none final : public base<T> {
         public:
             static const int delay = 0;
 
@@ -90,7 +92,7 @@ namespace c74::min::lib {
         ///	@tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
-        class nearest : public base<T> {
+        class nearest final : public base<T> {
         public:
             static const int delay = 0;
 
@@ -128,7 +130,7 @@ namespace c74::min::lib {
         ///	@tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
-        class linear : public base<T> {
+        class linear final : public base<T> {
         public:
             static const int delay = 1;
 
@@ -164,7 +166,7 @@ namespace c74::min::lib {
         ///	@tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
-        class allpass : public base<T> {
+        class allpass final : public base<T> {
         public:
             static const int delay = 1;
 
@@ -212,7 +214,7 @@ namespace c74::min::lib {
         ///	@tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
-        class cosine : public base<T> {
+        class cosine final : public base<T> {
         public:
             static const int delay = 1;
 
@@ -246,7 +248,7 @@ namespace c74::min::lib {
         ///	@tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
-        class cubic : public base<T> {
+        class cubic final : public base<T> {
         public:
             static const int delay = 3;
 
@@ -272,7 +274,7 @@ namespace c74::min::lib {
         ///	@tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
-        class spline : public base<T> {
+        class spline final : public base<T> {
         public:
             static const int delay = 3;
 
@@ -299,7 +301,7 @@ namespace c74::min::lib {
         ///	@tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
-        class hermite : public base<T> {
+        class hermite final : public base<T> {
         public:
             static const int delay{3};
 
@@ -372,6 +374,12 @@ namespace c74::min::lib {
 
 
         /// Proxy that provides means for objects to switch between interpolation types.
+        ///
+        /// One instance of every interpolator is held by value and the selected one is called through a switch,
+        /// so there is no virtual call per sample.
+        /// Loops over many samples should go through visit() or the block operator(),
+        /// which make the selection once and then run an inner loop with the concrete interpolator that the compiler can inline.
+        ///
         /// @tparam	T		The data type to interpolate. By default this is the number type.
 
         template<class T = number>
@@ -381,18 +389,7 @@ namespace c74::min::lib {
             /// @param	first_type	Option from the type enum. By default this is type::none.
 
             explicit proxy(interpolator::type first_type = type::none) {
-                // NW: The order here must match the order in type enum
-
-                std::get<0>(m_type_vector) = std::unique_ptr<interpolator::base<T>>(new interpolator::none<T>);
-                std::get<1>(m_type_vector) = std::unique_ptr<interpolator::base<T>>(new interpolator::nearest<T>);
-                std::get<2>(m_type_vector) = std::unique_ptr<interpolator::base<T>>(new interpolator::linear<T>);
-                std::get<3>(m_type_vector) = std::unique_ptr<interpolator::base<T>>(new interpolator::allpass<T>);
-                std::get<4>(m_type_vector) = std::unique_ptr<interpolator::base<T>>(new interpolator::cosine<T>);
-                std::get<5>(m_type_vector) = std::unique_ptr<interpolator::base<T>>(new interpolator::cubic<T>);
-                std::get<6>(m_type_vector) = std::unique_ptr<interpolator::base<T>>(new interpolator::spline<T>);
-                std::get<7>(m_type_vector) = std::unique_ptr<interpolator::base<T>>(new interpolator::hermite<T>);
-
-                m_which_type = static_cast<int>(first_type);
+                change_interpolation(first_type);
             }
 
 
@@ -400,7 +397,7 @@ namespace c74::min::lib {
             /// @param	new_bias	The new bias value used in interpolating.
 
             void bias(double new_bias) {
-                m_type_vector[m_hermite_type]->bias(new_bias);
+                std::get<hermite<T>>(m_types).bias(new_bias);
             }
 
 
@@ -408,7 +405,7 @@ namespace c74::min::lib {
             /// @return The current bias.
 
             double bias() {
-                return m_type_vector[m_hermite_type]->bias();
+                return std::get<hermite<T>>(m_types).bias();
             }
 
 
@@ -416,7 +413,7 @@ namespace c74::min::lib {
             /// @param	new_tension		The new tension value used in interpolating.
 
             void tension(double new_tension) {
-                m_type_vector[m_hermite_type]->tension(new_tension);
+                std::get<hermite<T>>(m_types).tension(new_tension);
             }
 
 
@@ -424,20 +421,66 @@ namespace c74::min::lib {
             /// @return The current tension.
 
             double tension() {
-                return m_type_vector[m_hermite_type]->tension();
+                return std::get<hermite<T>>(m_types).tension();
+            }
+
+
+            /// Call a function with the selected interpolator as its argument.
+            /// The function is instantiated for each interpolator type, so within it the interpolator is called directly.
+            /// @param function	A callable taking any of the interpolator types, e.g. a generic lambda.
+            /// @return			The return value of the function.
+
+            template<class function_type>
+            decltype(auto) visit(function_type&& function) {
+                // NW: The order here must match the order in type enum
+                switch (m_which_type) {
+                    case type::nearest:
+                        return function(std::get<nearest<T>>(m_types));
+                    case type::linear:
+                        return function(std::get<linear<T>>(m_types));
+                    case type::allpass:
+                        return function(std::get<allpass<T>>(m_types));
+                    case type::cosine:
+                        return function(std::get<cosine<T>>(m_types));
+                    case type::cubic:
+                        return function(std::get<cubic<T>>(m_types));
+                    case type::spline:
+                        return function(std::get<spline<T>>(m_types));
+                    case type::hermite:
+                        return function(std::get<hermite<T>>(m_types));
+                    default:
+                        return function(std::get<none<T>>(m_types));
+                }
             }
 
 
             /// Interpolate based on 4 samples of input.
-            /// @param x0		Unused sample value
-            /// @param x1		Sample value that will be returned
-            /// @param x2		Unused sample value
-            /// @param x3		Unused sample value
-            /// @param delta	Unused fractional locationq
+            /// @param x0		Sample value at integer index prior to x1
+            /// @param x1		Sample value at prior integer index
+            /// @param x2		Sample value at next integer index
+            /// @param x3		Sample value at integer index after x2
+            /// @param delta	Fractional location between x1 (delta=0) and x2 (delta=1)
             /// @return         The interpolated value
 
-            MIN_CONSTEXPR T operator()(T x0, T x1, T x2, T x3, double delta) noexcept {
-                return m_type_vector[m_which_type]->operator()(x0, x1, x2, x3, delta);
+            T operator()(T x0, T x1, T x2, T x3, double delta) noexcept {
+                return visit([&](auto& interpolate) {
+                    return interpolate(x0, x1, x2, x3, delta);
+                });
+            }
+
+
+            /// Interpolate a block of samples at a constant fractional location, e.g. to read a delay line.
+            /// output[i] is interpolated between input[i + 1] and input[i + 2], with input[i] and input[i + 3] as outer points.
+            /// @param input		frame_count + 3 samples
+            /// @param delta		Fractional location between the inner samples
+            /// @param output		frame_count samples
+            /// @param frame_count	Number of samples to calculate
+
+            void operator()(const T* input, double delta, T* output, std::size_t frame_count) noexcept {
+                visit([&](auto& interpolate) {
+                    for (std::size_t i = 0; i < frame_count; ++i)
+                        output[i] = interpolate(input[i], input[i + 1], input[i + 2], input[i + 3], delta);
+                });
             }
 
 
@@ -445,15 +488,14 @@ namespace c74::min::lib {
             /// @param	new_type	option from the type enum
 
             void change_interpolation(type new_type) {
-                m_which_type = static_cast<int>(new_type);
+                m_which_type = new_type;
             }
 
 
         private:
-            std::array<std::unique_ptr<interpolator::base<T>>, std::size_t(type::type_count)> m_type_vector;    ///< vector with one instance of each interpolator type
-            int m_which_type;    ///< index within m_type_vector used for interpolation operator, stored to avoid repeat casting
-            static const int m_hermite_type
-                = static_cast<int>(type::hermite);    ///< index of the hermite interpolator, stored to avoid repeat casting
+            std::tuple<none<T>, nearest<T>, linear<T>, allpass<T>, cosine<T>, cubic<T>, spline<T>, hermite<T>>
+                 m_types;           ///< one instance of each interpolator type
+            type m_which_type;      ///< type used for interpolation
         };
 
     }    // namespace interpolator
@@ -28,13 +28,14 @@ namespace c74::min::lib {
             m_channelcount = a_channel_count;
             m_samplerate = a_samplerate;
 
-            for (auto i = 0; i < m_channelcount; ++i)
-                m_dcblockers.push_back(std::make_unique<lib::dcblocker>());
+            m_dcblockers.resize(m_channelcount);
 
             m_lookahead_buffers.resize(m_channelcount);
             for (auto& buffer : m_lookahead_buffers)
                 buffer.resize(m_buffer_size);
             m_gain_buffer.resize(m_buffer_size);
+            m_peaks.resize(m_buffer_size);
+            m_applied_gains.resize(m_buffer_size);
             clear();
         }
 
@@ -192,7 +193,7 @@ namespace c74::min::lib {
 
         void clear() {
             for (auto& filter : m_dcblockers)
-                filter->clear();
+                filter.clear();
             for (auto& buffer : m_lookahead_buffers)
                 std::fill(buffer.begin(), buffer.end(), 0.0);
             std::fill(m_gain_buffer.begin(), m_gain_buffer.end(), 1.0);
@@ -220,37 +221,87 @@ namespace c74::min::lib {
 
         /// Calculate n-samples for m-channels.
         /// The number of channels at the input and output must match the channel count of the limiter.
-
-        void operator()(audio_bundle input, audio_bundle output) {
+        /// Bundles of either double or float samples (e.g. from a vector_operator<float>) may be passed.
+        /// The envelope and gain computation is always performed in double precision.
+        ///
+        /// The frames are processed in runs that do not wrap around the lookahead buffers, each in three passes:
+        /// the peaks across channels are found one channel after the other,
+        /// then the gain curve is computed for the run, and finally it is applied to one channel after the other.
+        /// Only the gain curve is computed frame by frame; the other passes are loops over contiguous samples.
+
+        template<typename T>
+        void operator()(basic_audio_bundle<T> input, basic_audio_bundle<T> output) {
             if (m_bypass) {
                 output = input;
                 return;
             }
 
-            int    lookahead = m_lookahead;
-            bool   is_linear = (m_mode == response_mode::linear);
-            bool   dcblock = m_dcblock;
-            sample v;
+            const auto frame_count = static_cast<int>(input.frame_count());
+
+            if (m_lookahead_index >= m_lookahead)
+                m_lookahead_index = 0;
+
+            for (auto offset = 0; offset < frame_count;) {
+                const auto count = std::min(frame_count - offset, m_lookahead - m_lookahead_index);
+
+                detect_peaks(input, offset, count);
+                compute_gains(count);
+                apply_gains(output, offset, count);
 
-            for (auto i = 0; i < input.frame_count(); ++i) {
-                sample hot_sample {0.0};
+                offset += count;
+                m_lookahead_index += count;
+                if (m_lookahead_index >= m_lookahead)
+                    m_lookahead_index = 0;
+            }
+        }
 
-                for (auto channel = 0; channel < m_channelcount; ++channel) {
-                    auto x = input.samples(channel);
 
-                    // Preprocessing (DC Blocking, Preamp)
+    private:
+        // Preprocess (DC blocking, preamp) count frames into the lookahead buffers, and find the peak of each frame across the channels.
 
-                    v = dcblock ? (*m_dcblockers[channel])(x[i]) : x[i];
-                    v *= m_linear_preamp;
+        template<typename T>
+        void detect_peaks(basic_audio_bundle<T>& input, int offset, int count) {
+            const auto preamp  = m_linear_preamp;
+            const auto postamp = m_linear_postamp;
+            auto       peaks   = m_peaks.data();
 
-                    // Analysis
+            std::fill_n(peaks, count, 0.0);
 
-                    m_lookahead_buffers[channel][m_lookahead_index] = v * m_linear_postamp;
-                    v = fabs(v);
-                    if (v > hot_sample)
-                        hot_sample = v;
+            for (auto channel = 0; channel < m_channelcount; ++channel) {
+                auto x      = input.samples(channel) + offset;
+                auto buffer = m_lookahead_buffers[channel].data() + m_lookahead_index;
+
+                if (m_dcblock) {
+                    auto& filter = m_dcblockers[channel];
+                    for (auto i = 0; i < count; ++i)
+                        buffer[i] = filter(x[i]);
+                }
+                else {
+                    for (auto i = 0; i < count; ++i)
+                        buffer[i] = x[i];
                 }
 
+                for (auto i = 0; i < count; ++i) {
+                    const sample v = buffer[i] * preamp;
+                    peaks[i]       = std::max(peaks[i], std::fabs(v));
+                    buffer[i]      = v * postamp;
+                }
+            }
+        }
+
+
+        // Compute the gain of count frames from their peaks, and lower the gains of the preceding frames in the lookahead buffer
+        // where the threshold is exceeded. The gain of each frame is recorded as it is when the frame is output.
+
+        void compute_gains(int count) {
+            const auto lookahead = m_lookahead;
+            const bool is_linear = (m_mode == response_mode::linear);
+
+            for (auto i = 0; i < count; ++i) {
+                const auto index = m_lookahead_index + i;
+                const auto hot_sample = m_peaks[i];
+                sample v;
+
                 if (is_linear)
                     v = m_last + m_recover;
                 else {
@@ -262,13 +313,7 @@ namespace c74::min::lib {
 
                 if (v > 1)
                     v = 1;
-                m_gain_buffer[m_lookahead_index] = v;
-
-                int lookahead_playback = m_lookahead_index - lookahead;
-                if (lookahead_playback < 0)
-                    lookahead_playback += lookahead;
-
-                // Process
+                m_gain_buffer[index] = v;
 
                 if (hot_sample * v > m_linear_threshold) {
                     number newgain;
@@ -278,7 +323,7 @@ namespace c74::min::lib {
                     auto   flag    = 0;
 
                     for (auto j = 0; flag == 0 && j < lookahead; j++) {
-                        auto k = m_lookahead_index - j;
+                        auto k = index - j;
 
                         if (k < 0)
                             k += lookahead;
@@ -296,26 +341,32 @@ namespace c74::min::lib {
                     }
                 }
 
-                // Apply Gain
+                m_applied_gains[i] = m_gain_buffer[index];
+                m_last = m_gain_buffer[index];
+            }
+        }
+
 
-                for (auto channel = 0; channel < m_channelcount; ++channel) {
-                    auto y = output.samples(channel);
-                    y[i]   = m_lookahead_buffers[channel][lookahead_playback] * m_gain_buffer[lookahead_playback];
-                }
+        // Apply the gains to count frames from the lookahead buffers.
 
-                m_last = m_gain_buffer[m_lookahead_index];
-                ++m_lookahead_index;
-                if (m_lookahead_index >= lookahead)
-                    m_lookahead_index = 0;
+        template<typename T>
+        void apply_gains(basic_audio_bundle<T>& output, int offset, int count) {
+            const auto gains = m_applied_gains.data();
+
+            for (auto channel = 0; channel < m_channelcount; ++channel) {
+                auto       y      = output.samples(channel) + offset;
+                const auto buffer = m_lookahead_buffers[channel].data() + m_lookahead_index;
+
+                for (auto i = 0; i < count; ++i)
+                    y[i] = static_cast<T>(buffer[i] * gains[i]);
             }
         }
 
 
-    private:
         int									m_channelcount		{};  	  	// number of channels
         int									m_buffer_size		{};
         number								m_samplerate		{48000};
-        vector<unique_ptr<lib::dcblocker>>	m_dcblockers;
+        vector<lib::dcblocker>				m_dcblockers;		// one per channel, by value
         bool								m_dcblock			{true};
         bool								m_bypass			{false};
         response_mode						m_mode				{response_mode::exponential};
@@ -333,6 +384,8 @@ namespace c74::min::lib {
         int									m_lookahead_index	{0};
         vector<sample_vector>				m_lookahead_buffers;
         sample_vector						m_gain_buffer;
+        sample_vector						m_peaks;			// scratch: peak across channels of each frame of a run
+        sample_vector						m_applied_gains;	// scratch: gain that each frame of a run is output with
     };
 
 }    // namespace c74::min::lib
@@ -0,0 +1,91 @@
+/// @file
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace c74::min::lib {
+
+
+    /// A function of the range 0.0 to 1.0 sampled into a table of fixed size, for evaluating it many times (e.g. per sample)
+    /// with a linear interpolation between two points rather than a call of sin(), sqrt() or pow().
+    /// The input is clamped to the range 0.0 to 1.0.
+    ///
+    /// The points are stored in the object itself, aligned to a cache line, so a table can be a static or global constant
+    /// that is shared by all instances of an object. The table is generated by the constructor,
+    /// at compile time if the function is constexpr (e.g. a polynomial) and otherwise when it is constructed.
+    /// A guard point after the last one lets the input 1.0 be interpolated like any other, without a check of the index.
+    ///
+    /// The error of the interpolation is at most size^-2 / 8 times the largest second derivative of the function,
+    /// e.g. below 2e-7 for a quarter period of a sine with the default size.
+    /// Functions with a vertical tangent, such as sqrt() at 0.0, are less accurate close to it.
+    ///
+    /// @tparam	size_param	The number of intervals between the points of the table.
+    /// @tparam	T			The type of the points.
+
+    template<std::size_t size_param = 4096, class T = double>
+    class lookup_table {
+        static_assert(size_param > 0, "a lookup_table needs at least one interval");
+
+    public:
+        /// The number of intervals between the points of the table.
+
+        static constexpr std::size_t size = size_param;
+
+
+        /// Create a table.
+        /// @param	f	The function to sample, called with the values 0.0 to 1.0 in steps of 1.0 / size.
+
+        template<class function_type>
+        constexpr explicit lookup_table(function_type&& f) {
+            for (std::size_t i = 0; i <= size; ++i)
+                m_points[i] = static_cast<T>(f(static_cast<double>(i) / size));
+            m_points[size + 1] = m_points[size];
+        }
+
+
+        /// Return one of the points of the table.
+        /// @param	index	The index of the point, from 0 to size.
+        /// @return			The function at the input index / size.
+
+        constexpr T operator[](const std::size_t index) const {
+            return m_points[index];
+        }
+
+
+        /// Evaluate the function.
+        /// @param	x	The input of the function.
+        /// @return		The interpolated output of the function.
+
+        T operator()(const T x) const {
+            const auto position = std::min(std::max(x, T(0)), T(1)) * T(size);
+            const auto index    = static_cast<std::size_t>(position);
+            const auto delta    = position - static_cast<T>(index);
+            const auto p        = m_points.data() + index;
+
+            return p[0] + delta * (p[1] - p[0]);
+        }
+
+
+        /// Evaluate the function for a block of inputs.
+        /// The loop has no branches, so that the compiler can vectorize it where gathers are available.
+        /// @param	input	The inputs of the function.
+        /// @param	output	The interpolated outputs. May be the same as input.
+        /// @param	count	The number of values.
+
+        void operator()(const T* input, T* output, const std::size_t count) const {
+            for (std::size_t i = 0; i < count; ++i)
+                output[i] = (*this)(input[i]);
+        }
+
+    private:
+        alignas(64) std::array<T, size + 2> m_points {};    ///< size + 1 points from 0.0 to 1.0, and the guard point
+    };
+
+
+}    // namespace c74::min::lib
@@ -0,0 +1,354 @@
+/// @file
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include "c74_min_api.h"
+#include "c74_lib_oversampler.h"
+
+
+namespace c74::min::lib {
+
+
+    ///	Coefficients of a biquad filter, normalized so that a0 is 1.
+
+    struct biquad_coefficients {
+        number b0 {1.0};
+        number b1 {};
+        number b2 {};
+        number a1 {};
+        number a2 {};
+
+
+        /// The first stage of the K-weighting of ITU-R BS.1770: a high shelf of about +4 dB above 1.5 kHz
+        /// that models the acoustic effect of the head. Computed for any samplerate, as in libebur128.
+        /// @param samplerate	The samplerate in hz.
+        /// @return				The coefficients.
+
+        static biquad_coefficients k_weighting_shelf(const number samplerate) {
+            const auto f0 { 1681.974450955533 };
+            const auto gain { 3.999843853973347 };
+            const auto q { 0.7071752369554196 };
+
+            const auto k  { std::tan(M_PI * f0 / samplerate) };
+            const auto vh { std::pow(10.0, gain / 20.0) };
+            const auto vb { std::pow(vh, 0.4996667741545416) };
+            const auto a0 { 1.0 + k / q + k * k };
+
+            return { (vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+        }
+
+
+        /// The second stage of the K-weighting of ITU-R BS.1770: the "RLB" highpass at about 38 hz.
+        /// @param samplerate	The samplerate in hz.
+        /// @return				The coefficients.
+
+        static biquad_coefficients k_weighting_highpass(const number samplerate) {
+            const auto f0 { 38.13547087602444 };
+            const auto q { 0.5003270373238773 };
+
+            const auto k  { std::tan(M_PI * f0 / samplerate) };
+            const auto a0 { 1.0 + k / q + k * k };
+
+            return { 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+        }
+    };
+
+
+    ///	Loudness and true-peak meter after ITU-R BS.1770 and EBU R128, for any number of channels.
+    ///
+    /// The channels are K-weighted and their mean squares are summed in sub-blocks of 100 ms.
+    /// Every 100 ms the momentary (400 ms) and short-term (3 s) loudness are computed from the last sub-blocks,
+    /// and the loudness of the 400 ms block is added to a histogram from which the gated integrated loudness is computed.
+    /// The histogram has bins of 0.1 LU from -70 to +30 LUFS, so the integrated loudness takes constant memory
+    /// however long the measurement runs. The true-peak is the largest absolute sample after 4x oversampling.
+    ///
+    /// The filters keep their state per channel in separate arrays and every sample is filtered for all channels
+    /// in one loop, which the compiler can vectorize across the channels.
+    ///
+    /// reset() allocates; process() and the accessors may be called on the audio thread.
+
+    class loudness_meter {
+    public:
+        /// Loudness that is reported when there is none to measure, e.g. for silence.
+        static constexpr number silence { -std::numeric_limits<number>::infinity() };
+
+
+        /// Create a meter.
+        /// @param channel_count	The number of channels.
+        /// @param samplerate		The samplerate in hz.
+        /// @param max_frame_count	The largest number of samples passed to process() at once.
+
+        explicit loudness_meter(int channel_count = 2, number samplerate = 48000.0, int max_frame_count = 512) {
+            reset(channel_count, samplerate, max_frame_count);
+        }
+
+
+        /// Set the number of channels and the samplerate. This allocates and clears the measurement.
+        /// Channel weights are 1.0. With six or more channels the first six are taken as a 5.1 layout
+        /// (L R C LFE Ls Rs): the LFE channel is ignored and the surround channels are weighted by 1.41, as BS.1770 specifies.
+        /// @param channel_count	The number of channels.
+        /// @param samplerate		The samplerate in hz.
+        /// @param max_frame_count	The largest number of samples passed to process() at once.
+
+        void reset(int channel_count, number samplerate, int max_frame_count = 512) {
+            m_channel_count = std::max(channel_count, 1);
+            m_samplerate    = samplerate;
+            m_shelf         = biquad_coefficients::k_weighting_shelf(samplerate);
+            m_highpass      = biquad_coefficients::k_weighting_highpass(samplerate);
+            m_subblock_size = std::max(1, static_cast<int>(std::lround(0.1 * samplerate)));
+
+            const auto channels { static_cast<size_t>(m_channel_count) };
+            m_weights.assign(channels, 1.0);
+            if (channels >= 6) {
+                m_weights[3] = 0.0;
+                m_weights[4] = 1.41;
+                m_weights[5] = 1.41;
+            }
+
+            for (auto state : { &m_shelf_z1, &m_shelf_z2, &m_highpass_z1, &m_highpass_z2, &m_sums })
+                state->assign(channels, 0.0);
+
+            m_oversamplers.clear();
+            for (auto c = 0u; c < channels; ++c)
+                m_oversamplers.emplace_back(4, max_frame_count);
+
+            clear();
+        }
+
+
+        /// Set the weight of a channel in the sum of the channels, e.g. 0 for an LFE channel.
+        /// @param channel	The channel.
+        /// @param weight	The weight, 1.0 by default.
+
+        void channel_weight(int channel, number weight) {
+            assert(channel >= 0 && channel < m_channel_count);
+            m_weights[channel] = weight;
+        }
+
+
+        /// Start a new measurement, e.g. for the integrated loudness of the next program.
+
+        void clear() {
+            for (auto state : { &m_shelf_z1, &m_shelf_z2, &m_highpass_z1, &m_highpass_z2, &m_sums })
+                std::fill(state->begin(), state->end(), 0.0);
+            for (auto& o : m_oversamplers)
+                o.clear();
+
+            m_subblocks.fill(0.0);
+            m_subblock_index = 0;
+            m_subblock_fill  = 0;
+            m_subblock_count = 0;
+            m_histogram_counts.fill(0);
+            m_histogram_energies.fill(0.0);
+
+            m_momentary  = silence;
+            m_short_term = silence;
+            m_integrated = silence;
+            m_max_momentary = silence;
+            m_true_peak  = 0.0;
+        }
+
+
+        /// Measure a block of audio.
+        /// @param channels		Pointers to frame_count samples of each channel.
+        /// @param frame_count	The number of samples, at most the maximum frame count passed to reset().
+
+        template<typename T>
+        void process(const T* const* channels, int frame_count) {
+            const auto channel_count { static_cast<size_t>(m_channel_count) };
+
+            for (auto c = 0u; c < channel_count; ++c) {
+                const auto oversampled { m_oversamplers[c].up(channels[c], frame_count) };
+                auto       peak { m_true_peak };
+                for (auto i = 0; i < 4 * frame_count; ++i)
+                    peak = std::max(peak, std::abs(oversampled[i]));
+                m_true_peak = peak;
+            }
+
+            for (auto offset = 0; offset < frame_count;) {
+                const auto count { std::min(frame_count - offset, m_subblock_size - m_subblock_fill) };
+                filter(channels, offset, count);
+                offset += count;
+                m_subblock_fill += count;
+
+                if (m_subblock_fill == m_subblock_size)
+                    complete_subblock();
+            }
+        }
+
+
+        /// @return The loudness of the last 400 ms in LUFS.
+        number momentary() const {
+            return m_momentary;
+        }
+
+        /// @return The loudness of the last 3 s in LUFS.
+        number short_term() const {
+            return m_short_term;
+        }
+
+        /// @return The gated loudness since the last clear() in LUFS.
+        number integrated() const {
+            return m_integrated;
+        }
+
+        /// @return The largest momentary loudness since the last clear() in LUFS.
+        number max_momentary() const {
+            return m_max_momentary;
+        }
+
+        /// @return The largest absolute value of the 4x oversampled signal since the last clear(), as a linear gain.
+        number true_peak() const {
+            return m_true_peak;
+        }
+
+        /// @return The true-peak in dBTP.
+        number true_peak_db() const {
+            return m_true_peak > 0.0 ? 20.0 * std::log10(m_true_peak) : silence;
+        }
+
+        int channel_count() const {
+            return m_channel_count;
+        }
+
+    private:
+        static constexpr size_t k_short_term_subblocks { 30 };
+        static constexpr size_t k_momentary_subblocks { 4 };
+        static constexpr number k_histogram_min { -70.0 };    // the absolute gate
+        static constexpr size_t k_histogram_bins { 1000 };    // 0.1 LU each, up to +30 LUFS
+
+
+        static number loudness(const number mean_square) {
+            return mean_square > 0.0 ? -0.691 + 10.0 * std::log10(mean_square) : silence;
+        }
+
+
+        // K-weight count samples of all channels from offset on and add their weighted squares to the sums.
+        // Transposed direct form II, with the state of each channel in its own lane.
+
+        template<typename T>
+        void filter(const T* const* channels, const int offset, const int count) {
+            const auto channel_count { static_cast<size_t>(m_channel_count) };
+            const auto s { m_shelf };
+            const auto h { m_highpass };
+
+            auto shelf_z1 { m_shelf_z1.data() };
+            auto shelf_z2 { m_shelf_z2.data() };
+            auto highpass_z1 { m_highpass_z1.data() };
+            auto highpass_z2 { m_highpass_z2.data() };
+            auto sums { m_sums.data() };
+
+            for (auto i = offset; i < offset + count; ++i) {
+                for (auto c = 0u; c < channel_count; ++c) {
+                    const number x { static_cast<number>(channels[c][i]) };
+
+                    const auto y1 { s.b0 * x + shelf_z1[c] };
+                    shelf_z1[c] = s.b1 * x - s.a1 * y1 + shelf_z2[c];
+                    shelf_z2[c] = s.b2 * x - s.a2 * y1;
+
+                    const auto y2 { h.b0 * y1 + highpass_z1[c] };
+                    highpass_z1[c] = h.b1 * y1 - h.a1 * y2 + highpass_z2[c];
+                    highpass_z2[c] = h.b2 * y1 - h.a2 * y2;
+
+                    sums[c] += y2 * y2;
+                }
+            }
+        }
+
+
+        void complete_subblock() {
+            number energy {};
+            for (auto c = 0u; c < m_sums.size(); ++c) {
+                energy += m_weights[c] * m_sums[c];
+                m_sums[c] = 0.0;
+            }
+            m_subblocks[m_subblock_index] = energy;
+            m_subblock_index = (m_subblock_index + 1) % k_short_term_subblocks;
+            m_subblock_fill  = 0;
+            ++m_subblock_count;
+
+            // the newest sub-blocks are the ones before the index
+            number momentary {};
+            number short_term {};
+            for (auto n = 1u; n <= k_short_term_subblocks; ++n) {
+                const auto e { m_subblocks[(m_subblock_index + k_short_term_subblocks - n) % k_short_term_subblocks] };
+                if (n <= k_momentary_subblocks)
+                    momentary += e;
+                short_term += e;
+            }
+
+            const auto block_mean_square { momentary / (k_momentary_subblocks * m_subblock_size) };
+            m_momentary     = loudness(block_mean_square);
+            m_short_term    = loudness(short_term / (k_short_term_subblocks * m_subblock_size));
+            m_max_momentary = std::max(m_max_momentary, m_momentary);
+
+            // only complete 400 ms blocks take part in the gating
+            if (m_subblock_count >= k_momentary_subblocks && m_momentary >= k_histogram_min) {
+                const auto bin { std::min(static_cast<size_t>((m_momentary - k_histogram_min) * 10.0), k_histogram_bins - 1) };
+                ++m_histogram_counts[bin];
+                m_histogram_energies[bin] += block_mean_square;
+                update_integrated();
+            }
+        }
+
+
+        // The blocks above the absolute gate define the relative gate 10 LU below their loudness,
+        // and the blocks above both gates make up the integrated loudness.
+
+        void update_integrated() {
+            number energy {};
+            size_t count {};
+            for (auto bin = 0u; bin < k_histogram_bins; ++bin) {
+                energy += m_histogram_energies[bin];
+                count += m_histogram_counts[bin];
+            }
+            if (count == 0)
+                return;
+
+            const auto relative_gate { loudness(energy / count) - 10.0 };
+            const auto first_bin { static_cast<size_t>(std::clamp((relative_gate - k_histogram_min) * 10.0, 0.0, number(k_histogram_bins - 1))) };
+
+            energy = 0.0;
+            count  = 0;
+            for (auto bin = first_bin; bin < k_histogram_bins; ++bin) {
+                energy += m_histogram_energies[bin];
+                count += m_histogram_counts[bin];
+            }
+            m_integrated = count ? loudness(energy / count) : silence;
+        }
+
+
+        int                 m_channel_count {};
+        number              m_samplerate {};
+        biquad_coefficients m_shelf;
+        biquad_coefficients m_highpass;
+
+        vector<number>      m_weights;
+        vector<number>      m_shelf_z1;
+        vector<number>      m_shelf_z2;
+        vector<number>      m_highpass_z1;
+        vector<number>      m_highpass_z2;
+        vector<number>      m_sums;             ///< weighted squares of the current sub-block, per channel
+        vector<oversampler> m_oversamplers;
+
+        int                                         m_subblock_size {};
+        int                                         m_subblock_fill {};
+        size_t                                      m_subblock_index {};
+        size_t                                      m_subblock_count {};
+        std::array<number, k_short_term_subblocks>  m_subblocks {};
+        std::array<size_t, k_histogram_bins>        m_histogram_counts {};
+        std::array<number, k_histogram_bins>        m_histogram_energies {};
+
+        number m_momentary {silence};
+        number m_short_term {silence};
+        number m_integrated {silence};
+        number m_max_momentary {silence};
+        number m_true_peak {};
+    };
+
+
+}    // namespace c74::min::lib
@@ -0,0 +1,196 @@
+/// @file
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include "c74_lib_delay.h"
+
+namespace c74::min::lib {
+
+
+    ///	A single-channel delay line with several interpolated read taps, e.g. for chorus voices or early reflections.
+    ///	Each tap produces the same output as a lib::delay of the same size would,
+    ///	but the input is written only once into one shared history instead of once per tap.
+
+    class multitap_delay {
+    public:
+        /// Constructor with the number of taps and the capacity.
+        /// @param	tap_count	The number of read taps. Default is 2 taps.
+        /// @param	capacity	The maximum delay time of any tap in samples. It is also the initial size of all taps.
+        ///						Default is 256 samples.
+
+        explicit multitap_delay(int tap_count = 2, number capacity = 256)
+        : m_history(history_size(static_cast<size_t>(capacity)), k_guard_size)
+        , m_capacity(capacity)
+        , m_taps(tap_count) {
+            for (auto tap = 0; tap < tap_count; ++tap)
+                size(tap, capacity);
+        }
+
+
+        /// Return the number of taps.
+        /// @return The number of taps.
+
+        int tap_count() const {
+            return static_cast<int>(m_taps.size());
+        }
+
+
+        /// Set a new delay time in samples for one tap.
+        /// @param	tap			The index of the tap.
+        /// @param	new_size	The new delay time in samples. Will be clamped to the capacity.
+
+        void size(int tap, number new_size) {
+            assert(tap >= 0 && tap < tap_count());
+            m_taps[tap] = make_tap(new_size);
+        }
+
+
+        /// Return the current delay time in samples of one tap.
+        /// @param	tap		The index of the tap.
+        /// @return The delay time in samples.
+
+        number size(int tap) const {
+            return m_taps[tap].size;
+        }
+
+
+        /// Set a new delay time in milliseconds for one tap.
+        /// @param	tap					The index of the tap.
+        /// @param	new_size_ms			The new delay time in milliseconds.
+        /// @param	sampling_frequency	The sampling frequency of the environment in hertz.
+
+        void size_ms(int tap, number new_size_ms, number sampling_frequency) {
+            size(tap, math::milliseconds_to_samples(new_size_ms, sampling_frequency));
+        }
+
+
+        /// Change the interpolation algorithm used by all taps.
+        /// Note that the taps share one interpolator, so interpolator::type::allpass mixes the history of the taps.
+        /// @param	new_type	option from the interpolator::type enum that names algorithm
+
+        void change_interpolation(interpolator::type new_type = interpolator::type::none) {
+            m_interpolator.change_interpolation(new_type);
+        }
+
+
+        /// Write a single sample into the delay.
+        ///	@param	new_input	A sample to add.
+
+        void write(sample new_input) {
+            m_history.write(new_input);
+        }
+
+
+        /// Read the output of one tap for the samples written so far.
+        /// @param	tap		The index of the tap.
+        ///	@return			The interpolated sample.
+
+        sample tail(int tap) {
+            return m_interpolator.visit([&](auto& interpolate) {
+                return read(interpolate, m_taps[tap]);
+            });
+        }
+
+
+        /// Erase the delay history.
+
+        void clear() {
+            m_history.zero();
+        }
+
+
+        /// Calculate one sample for all taps.
+        /// @param	x		The input sample.
+        /// @param	outputs	One output sample per tap.
+
+        void operator()(sample x, sample* outputs) {
+            write(x);
+            m_interpolator.visit([&](auto& interpolate) {
+                for (auto tap = 0; tap < tap_count(); ++tap)
+                    outputs[tap] = read(interpolate, m_taps[tap]);
+            });
+        }
+
+
+        /// Calculate a block of samples for all taps at their current delay times.
+        /// @param	input			frame_count input samples.
+        /// @param	outputs			One buffer of frame_count samples per tap.
+        /// @param	frame_count		The number of samples.
+
+        void operator()(const sample* input, sample* const* outputs, std::size_t frame_count) {
+            m_interpolator.visit([&](auto& interpolate) {
+                for (std::size_t i = 0; i < frame_count; ++i) {
+                    write(input[i]);
+                    for (auto tap = 0; tap < tap_count(); ++tap)
+                        outputs[tap][i] = read(interpolate, m_taps[tap]);
+                }
+            });
+        }
+
+
+        /// Calculate a block of samples for all taps with modulated delay times.
+        /// @param	input			frame_count input samples.
+        /// @param	sizes			One buffer of frame_count delay times in samples per tap.
+        ///							The delay time of each tap remains at the last value when the block is done.
+        /// @param	outputs			One buffer of frame_count samples per tap.
+        /// @param	frame_count		The number of samples.
+
+        void operator()(const sample* input, const sample* const* sizes, sample* const* outputs, std::size_t frame_count) {
+            m_interpolator.visit([&](auto& interpolate) {
+                for (std::size_t i = 0; i < frame_count; ++i) {
+                    write(input[i]);
+                    for (auto tap = 0; tap < tap_count(); ++tap)
+                        outputs[tap][i] = read(interpolate, make_tap(sizes[tap][i]));
+                }
+            });
+            if (frame_count > 0) {
+                for (auto tap = 0; tap < tap_count(); ++tap)
+                    size(tap, sizes[tap][frame_count - 1]);
+            }
+        }
+
+
+    private:
+        struct tap_time {
+            number      size {};
+            std::size_t integral {};
+            double      fractional {};
+        };
+
+        tap_time make_tap(number new_size) const {
+            new_size = MIN_CLAMP(new_size, 0.0, m_capacity);
+            auto integral = static_cast<std::size_t>(new_size);
+            return { new_size, integral, new_size - integral };
+        }
+
+        // the history is written every sample, so the thread is only checked every now and then
+        using history_type = circular_storage<sample, thread_check::sampled<>>;
+
+        static constexpr size_t k_guard_size {3};    ///< the history mirrors enough samples to read 4 for interpolation in one window
+
+        // laid out like the history of lib::delay
+
+        static size_t history_size(size_t capacity) {
+            return history_type::next_power_of_two(capacity + 5);
+        }
+
+        template<class interpolator_type>
+        sample read(interpolator_type& interpolate, const tap_time& t) {
+            size_t true_offset = m_history.capacity() - t.integral - 2;
+            auto   x           = m_history.window(true_offset - 1);
+
+            return interpolate(x[3], x[2], x[1], x[0], t.fractional);
+        }
+
+        history_type             m_history;        ///< Memory for storing the delayed samples, shared by all taps.
+        number                   m_capacity;       ///< Maximum delay time in samples.
+        vector<tap_time>         m_taps;           ///< Delay time of each tap.
+        interpolator::proxy<>    m_interpolator{
+            interpolator::type::cubic};    ///< The interpolator instance used to produce interpolated output.
+    };
+
+
+}    // namespace c74::min::lib
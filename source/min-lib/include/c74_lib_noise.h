@@ -0,0 +1,93 @@
+/// @file
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include "c74_min_api.h"
+#include "c74_lib_math.h"
+
+namespace c74::min::lib {
+
+
+    ///	A single-channel white noise generator with its own math::random_generator,
+    ///	so that every instance is cheap and can reproduce its output from a seed.
+
+    class noise {
+    public:
+        /// Options for the distribution of the noise.
+
+        enum class distribution : int {
+            uniform,     ///< uniform between -1 and 1
+            gaussian,    ///< normal with a standard deviation of 1/3, so that it rarely exceeds -1 or 1
+            enum_count
+        };
+
+
+        /// Create a noise generator seeded from std::random_device.
+
+        noise() = default;
+
+
+        /// Create a noise generator with a seed.
+        /// @param	a_seed	The seed. Generators with the same seed produce the same noise.
+
+        explicit noise(std::uint64_t a_seed)
+        : m_generator { a_seed } {}
+
+
+        /// Restart the noise from a seed.
+        /// @param	a_seed	The seed.
+
+        void seed(std::uint64_t a_seed) {
+            m_generator.seed(a_seed);
+        }
+
+
+        /// Set the distribution of the noise.
+        /// @param	a_distribution	The new distribution.
+
+        void mode(distribution a_distribution) {
+            m_distribution = a_distribution;
+        }
+
+        /// Return the distribution of the noise.
+        /// @return The current distribution.
+
+        distribution mode() const {
+            return m_distribution;
+        }
+
+
+        /// Calculate one sample.
+        ///	@return		Calculated sample
+
+        sample operator()() {
+            if (m_distribution == distribution::gaussian)
+                return m_generator.normal(0.0, k_gaussian_deviation);
+            return m_generator.uniform(-1.0, 1.0);
+        }
+
+
+        /// Calculate a block of samples.
+        /// @param	output			The block to fill.
+        /// @param	frame_count		The number of samples.
+
+        template<typename T>
+        void operator()(T* output, std::size_t frame_count) {
+            if (m_distribution == distribution::gaussian)
+                m_generator.fill_normal(output, frame_count, 0.0, k_gaussian_deviation);
+            else
+                m_generator.fill_uniform(output, frame_count, -1.0, 1.0);
+        }
+
+    private:
+        static constexpr double k_gaussian_deviation {1.0 / 3.0};
+
+        math::random_generator  m_generator;
+        distribution            m_distribution {distribution::uniform};
+    };
+
+
+}    // namespace c74::min::lib
@@ -74,10 +74,168 @@ namespace c74::min::lib {
             return y;
         }
 
+
+        /// Calculate a block of samples.
+        /// @param	input		frame_count input samples.
+        /// @param	output		frame_count output samples. May be the same as input.
+        /// @param	frame_count	The number of samples.
+
+        void operator()(const sample* input, sample* output, std::size_t frame_count) {
+            auto y_1 = this->y_1;    // in a register for the whole block
+
+            for (std::size_t i = 0; i < frame_count; ++i) {
+                y_1       = (input[i] * a_0) + (y_1 * b_1);
+                output[i] = y_1;
+            }
+            this->y_1 = y_1;
+        }
+
     private:
         number a_0{0.5};    ///< gain coefficient
         number b_1{0.5};    ///< feedback coefficient
         sample y_1{};       ///< previous output sample
     };
 
+
+    ///	Multichannel version of onepole, with the coefficients and the history of all channels stored in arrays.
+    ///	Planar buffers are filtered one channel after the other, with the history in a register;
+    ///	interleaved buffers are filtered one frame after the other, all channels at once, which the compiler can vectorize.
+
+    class onepole_bank {
+    public:
+        /// Constructor with the number of channels and the initial coefficient of all of them.
+        /// @param	channel_count			The number of channels.
+        /// @param	initial_coefficient		Sets the gain coefficient that is applied to samples from history.
+        ///									Default value is 0.5.
+
+        explicit onepole_bank(int channel_count = 2, number initial_coefficient = 0.5)
+        : m_a_0(channel_count)
+        , m_b_1(channel_count)
+        , m_y_1(channel_count) {
+            coefficient(initial_coefficient);
+        }
+
+
+        /// Return the number of channels.
+        /// @return	The number of channels.
+
+        int channel_count() const {
+            return static_cast<int>(m_y_1.size());
+        }
+
+
+        /// Set the filter coefficient of one channel directly.
+        /// @param channel			The index of the channel.
+        /// @param new_coefficient	The new value of the feedback coefficient in the range [0.0, 1.0].
+
+        void coefficient(int channel, number new_coefficient) {
+            new_coefficient = MIN_CLAMP(new_coefficient, 0.0, 1.0);
+            m_b_1[channel]  = new_coefficient;
+            m_a_0[channel]  = 1 - new_coefficient;
+        }
+
+
+        /// Set the filter coefficient of all channels directly.
+        /// @param new_coefficient	The new value of the feedback coefficient in the range [0.0, 1.0].
+
+        void coefficient(number new_coefficient) {
+            for (auto channel = 0; channel < channel_count(); ++channel)
+                coefficient(channel, new_coefficient);
+        }
+
+
+        /// Get the current coefficent of one channel.
+        /// @param channel	The index of the channel.
+        /// @return	The value of the feedback coefficient.
+
+        number coefficient(int channel) const {
+            return m_b_1[channel];
+        }
+
+
+        /// Set the filter coefficient of one channel using a cutoff frequency.
+        /// @param channel				The index of the channel.
+        /// @param cutoff_frequency		The cutoff frequency in hertz.
+        /// @param sampling_frequency	The sample frequency in hertz.
+
+        void frequency(int channel, number cutoff_frequency, number sampling_frequency) {
+            coefficient(channel, 1.0 - exp(-2.0 * M_PI * cutoff_frequency / sampling_frequency));
+        }
+
+
+        /// Set the filter coefficient of all channels using a cutoff frequency.
+        /// @param cutoff_frequency		The cutoff frequency in hertz.
+        /// @param sampling_frequency	The sample frequency in hertz.
+
+        void frequency(number cutoff_frequency, number sampling_frequency) {
+            coefficient(1.0 - exp(-2.0 * M_PI * cutoff_frequency / sampling_frequency));
+        }
+
+
+        /// Clear the history of all channels.
+
+        void clear() {
+            std::fill(m_y_1.begin(), m_y_1.end(), 0.0);
+        }
+
+
+        /// Retrieve the history of one channel.
+        /// @param channel	The index of the channel.
+        /// @return	The value stored in the filter's history.
+
+        sample history(int channel) const {
+            return m_y_1[channel];
+        }
+
+
+        /// Calculate a block of samples for every channel from planar buffers.
+        /// @param	inputs		One buffer of frame_count input samples per channel.
+        /// @param	outputs		One buffer of frame_count output samples per channel. May be the same as the inputs.
+        /// @param	frame_count	The number of samples.
+
+        void operator()(const sample* const* inputs, sample* const* outputs, std::size_t frame_count) {
+            for (auto channel = 0; channel < channel_count(); ++channel) {
+                const auto a_0    = m_a_0[channel];
+                const auto b_1    = m_b_1[channel];
+                auto       y_1    = m_y_1[channel];
+                auto       input  = inputs[channel];
+                auto       output = outputs[channel];
+
+                for (std::size_t i = 0; i < frame_count; ++i) {
+                    y_1       = (input[i] * a_0) + (y_1 * b_1);
+                    output[i] = y_1;
+                }
+                m_y_1[channel] = y_1;
+            }
+        }
+
+
+        /// Calculate a block of samples for every channel from an interleaved buffer.
+        /// @param	input		frame_count frames of channel_count() input samples each.
+        /// @param	output		frame_count frames of channel_count() output samples each. May be the same as input.
+        /// @param	frame_count	The number of frames.
+
+        void process_interleaved(const sample* input, sample* output, std::size_t frame_count) {
+            const auto channels = static_cast<std::size_t>(channel_count());
+            const auto a_0      = m_a_0.data();
+            const auto b_1      = m_b_1.data();
+            const auto y_1      = m_y_1.data();
+
+            for (std::size_t i = 0; i < frame_count; ++i) {
+                auto x = input + i * channels;
+                auto y = output + i * channels;
+
+                for (std::size_t channel = 0; channel < channels; ++channel) {
+                    y_1[channel] = (x[channel] * a_0[channel]) + (y_1[channel] * b_1[channel]);
+                    y[channel]   = y_1[channel];
+                }
+            }
+        }
+
+    private:
+        vector<number> m_a_0;    ///< gain coefficient of each channel
+        vector<number> m_b_1;    ///< feedback coefficient of each channel
+        vector<sample> m_y_1;    ///< previous output sample of each channel
+    };
+
 }    // namespace c74::min::lib
@@ -5,11 +5,35 @@
 
 #pragma once
 
+#include <memory>
+
 const int k_total_padding = 8;
 const int k_half_padding = k_total_padding / 2;
 
 namespace c74::min::lib {
 
+
+    /// Generate a single-cycle wavetable with the padding used by oscillator and oscillator_bank,
+    /// to be shared by several of them. The table cannot be changed once it has been generated.
+    /// @tparam waveform_type	generator option defined in c74_lib_generator.h
+    /// @param	wavetable_size	The number of samples in the wavetable without the padding.
+    /// @return	The wavetable.
+
+    template<class waveform_type = generator::sine<>>
+    std::shared_ptr<const sample_vector> make_wavetable(std::size_t wavetable_size = 4096) {
+        auto wavetable = std::make_shared<sample_vector>(wavetable_size + k_total_padding);
+
+        // first generate one cycle inside the padding
+        std::generate(wavetable->begin()+k_half_padding, wavetable->end()-k_half_padding, waveform_type(wavetable_size));
+
+        // second copy samples to the padding
+        std::copy(wavetable->end()-k_total_padding, wavetable->end()-k_half_padding, wavetable->begin());
+        std::copy(wavetable->begin()+k_half_padding, wavetable->begin()+k_total_padding, wavetable->end()-k_half_padding);
+
+        return wavetable;
+    }
+
+
     /// Generate basic <a href="https://en.wikipedia.org/wiki/Waveform">waveforms</a> using a single-cycle
     /// <a href="https://en.wikipedia.org/wiki/Wavetable_synthesis">wavetable</a>
     /// @tparam initial_waveform_type	generator option defined in c74_lib_generator.h
@@ -22,16 +46,21 @@ namespace c74::min::lib {
         /// @param	wavetable_size	The number of samples in the wavetable.
 
         oscillator(std::size_t wavetable_size = 4096)
-        : m_wavetable(wavetable_size + k_total_padding) {	// extra samples to accomodate the padding at beginning and end
-            change_waveform<initial_waveform_type>();
-        }
+        : m_wavetable { make_wavetable<initial_waveform_type>(wavetable_size) } {}
+
+
+        /// Constructor for an oscillator that reads a wavetable shared with other oscillators, e.g. the voices of a synthesizer.
+        /// @param	wavetable	A wavetable created by make_wavetable().
+
+        explicit oscillator(std::shared_ptr<const sample_vector> wavetable)
+        : m_wavetable { std::move(wavetable) } {}
 
 
         ///	Return the size of the internal wavetable without padding.
         /// @return	The size of the sample_vector containing our single-cycle wavetable.
 
         std::size_t size() {
-            return m_wavetable.size() - k_total_padding;
+            return m_wavetable->size() - k_total_padding;
         }
 
 
@@ -69,33 +98,43 @@ namespace c74::min::lib {
 
 
         /// Generate a new shape for the internal wavetable.
+        /// A wavetable shared with other oscillators is not changed: this oscillator gets a new one of its own.
         /// @tparam new_waveform_type	generator object defined in c74_lib_generator.h
 
         template<class new_waveform_type = generator::sine<>>
         void change_waveform() {
-            // first generate one cycle inside the padding
-            std::generate(m_wavetable.begin()+k_half_padding, m_wavetable.end()-k_half_padding, new_waveform_type(size()));
+            m_wavetable = make_wavetable<new_waveform_type>(size());
+        }
+
+
+        /// Read another wavetable, e.g. one shared with other oscillators.
+        /// @param	wavetable	A wavetable created by make_wavetable().
 
-            // second copy samples to the padding
-            std::copy(m_wavetable.end()-k_total_padding, m_wavetable.end()-k_half_padding, m_wavetable.begin());
-            std::copy(m_wavetable.begin()+k_half_padding, m_wavetable.begin()+k_total_padding, m_wavetable.end()-k_half_padding);
+        void change_wavetable(std::shared_ptr<const sample_vector> wavetable) {
+            m_wavetable = std::move(wavetable);
+        }
+
+
+        /// Return the wavetable, e.g. to share it with other oscillators.
+        /// @return	The wavetable including the padding.
+
+        std::shared_ptr<const sample_vector> wavetable() const {
+            return m_wavetable;
         }
 
 
         /// Return the value at an interpolated position.
+        /// The position is not checked, so it must be within the wavetable and its padding.
         /// @param	new_position	Position within the sample_vector. Non-integer values will be interpolated.
         /// @return Interpolated sample value.
 
         sample at(number new_position) {
             std::size_t position_integral = static_cast<std::size_t>(new_position);
             number position_fractional = new_position - position_integral;
+            auto x = m_wavetable->data() + position_integral;
 
-            return m_interpolator(	m_wavetable.at(position_integral-1),
-                                    m_wavetable.at(position_integral),
-                                    m_wavetable.at(position_integral+1),
-                                    m_wavetable.at(position_integral+2),
-                                    position_fractional	);
-
+            assert(position_integral >= 1 && position_integral + 2 < m_wavetable->size());
+            return m_interpolator(x[-1], x[0], x[1], x[2], position_fractional);
         }
 
 
@@ -112,8 +151,152 @@ namespace c74::min::lib {
 
     private:
         sync					m_phase_ramp{};    ///< manages the frequency and phase of our oscillator
-        sample_vector			m_wavetable{};     ///< vector containing single cycle of the waveform
+        std::shared_ptr<const sample_vector>	m_wavetable;    ///< vector containing single cycle of the waveform, possibly shared with other oscillators
         interpolator::cubic<>   m_interpolator{};    ///< The interpolator instance used to produce interpolated output.
     };
 
+
+    /// Many oscillators reading one shared wavetable, e.g. the voices of a synthesizer, rendered together.
+    /// The phases and increments of all voices are stored in arrays, and for each block the positions in the wavetable
+    /// are computed directly from the phase at the start of the block, without a dependency from one sample to the next,
+    /// so that the compiler can vectorize that part before the table is read and interpolated.
+    /// @tparam initial_waveform_type	generator option defined in c74_lib_generator.h
+
+    template<class initial_waveform_type = generator::sine<>>
+    class oscillator_bank {
+    public:
+        /// Constructor with the number of voices and the size of a wavetable of the initial waveform.
+        /// @param	voice_count		The number of voices.
+        /// @param	wavetable_size	The number of samples in the wavetable.
+
+        explicit oscillator_bank(int voice_count = 8, std::size_t wavetable_size = 4096)
+        : oscillator_bank { voice_count, make_wavetable<initial_waveform_type>(wavetable_size) } {}
+
+
+        /// Constructor with the number of voices and a wavetable, which may also be shared with other oscillators.
+        /// @param	voice_count		The number of voices.
+        /// @param	wavetable		A wavetable created by make_wavetable().
+
+        oscillator_bank(int voice_count, std::shared_ptr<const sample_vector> wavetable)
+        : m_wavetable { std::move(wavetable) }
+        , m_phases(voice_count)
+        , m_steps(voice_count)
+        , m_frequencies(voice_count) {}
+
+
+        /// Return the number of voices.
+        /// @return	The number of voices.
+
+        int voice_count() const {
+            return static_cast<int>(m_phases.size());
+        }
+
+
+        ///	Return the size of the wavetable without padding.
+        /// @return	The number of samples in the single cycle of the waveform.
+
+        std::size_t size() const {
+            return m_wavetable->size() - k_total_padding;
+        }
+
+
+        /// Set the frequency of one voice.
+        /// @param	voice					The index of the voice.
+        /// @param	oscillator_frequency	The frequency of the oscillator in hertz.
+        /// @param	sampling_frequency		The sampling frequency of the environment in hertz.
+
+        void frequency(int voice, number oscillator_frequency, number sampling_frequency) {
+            auto f_nyquist       = sampling_frequency * 0.5;
+            m_frequencies[voice] = fold(oscillator_frequency, -f_nyquist, f_nyquist);
+            m_steps[voice]       = m_frequencies[voice] / sampling_frequency;
+        }
+
+
+        /// Get the current frequency of one voice.
+        /// @param	voice	The index of the voice.
+        /// @return	The current frequency of the voice in hertz.
+
+        number frequency(int voice) const {
+            return m_frequencies[voice];
+        }
+
+
+        /// Set the phase of one voice.
+        /// @param	voice		The index of the voice.
+        ///	@param	new_phase	The new phase to which the voice will be set. Range is [0.0, 1.0).
+
+        void phase(int voice, number new_phase) {
+            m_phases[voice] = wrap(new_phase, 0.0, 1.0);
+        }
+
+
+        /// Get the current phase of one voice.
+        /// @param	voice	The index of the voice.
+        /// @return	The current phase of the voice in the range [0.0, 1.0).
+
+        number phase(int voice) const {
+            return m_phases[voice];
+        }
+
+
+        /// Generate a new shape for the wavetable of all voices.
+        /// A wavetable shared with other oscillators is not changed: the bank gets a new one of its own.
+        /// @tparam new_waveform_type	generator object defined in c74_lib_generator.h
+
+        template<class new_waveform_type = generator::sine<>>
+        void change_waveform() {
+            m_wavetable = make_wavetable<new_waveform_type>(size());
+        }
+
+
+        /// Read another wavetable, e.g. one shared with other oscillators.
+        /// @param	wavetable	A wavetable created by make_wavetable().
+
+        void change_wavetable(std::shared_ptr<const sample_vector> wavetable) {
+            m_wavetable = std::move(wavetable);
+        }
+
+
+        /// Calculate a block of samples for every voice.
+        /// @param	outputs		One buffer of frame_count samples per voice.
+        /// @param	frame_count	The number of samples.
+
+        void process(sample* const* outputs, int frame_count) {
+            const auto table = m_wavetable->data();
+            const auto length = static_cast<number>(size());
+
+            for (auto voice = 0; voice < voice_count(); ++voice) {
+                auto       output = outputs[voice];
+                const auto start  = m_phases[voice];
+                const auto step   = m_steps[voice];
+
+                // the positions first, in the output buffer: the phase of each sample is independent of the previous one
+                for (auto i = 0; i < frame_count; ++i) {
+                    auto phase = start + i * step;
+                    phase -= std::floor(phase);
+                    output[i] = phase * length + k_half_padding;
+                }
+
+                // then the table lookup replaces each position with its interpolated sample
+                for (auto i = 0; i < frame_count; ++i) {
+                    auto position_integral   = static_cast<std::size_t>(output[i]);
+                    auto position_fractional = output[i] - position_integral;
+                    auto x                   = table + position_integral;
+
+                    output[i] = m_interpolator(x[-1], x[0], x[1], x[2], position_fractional);
+                }
+
+                auto phase = start + frame_count * step;
+                m_phases[voice] = phase - std::floor(phase);
+            }
+        }
+
+    private:
+        std::shared_ptr<const sample_vector>	m_wavetable;      ///< vector containing single cycle of the waveform, possibly shared with other oscillators
+        vector<number>                          m_phases;         ///< current phase of each voice
+        vector<number>                          m_steps;          ///< increment for each sample iteration of each voice
+        vector<number>                          m_frequencies;    ///< frequency of each voice
+        interpolator::cubic<>                   m_interpolator{};    ///< The interpolator instance used to produce interpolated output.
+    };
+
 }    // namespace c74::min::lib
@@ -0,0 +1,291 @@
+/// @file
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include "c74_min_api.h"
+
+
+namespace c74::min::lib {
+
+
+    ///	One octave of oversampling: a linear-phase halfband lowpass in polyphase form,
+    /// with the history for interpolating up to and decimating down from twice the samplerate.
+    ///	Every other tap of a halfband filter is zero apart from the center tap of 0.5,
+    /// so each output sample costs only half of the non-zero taps.
+
+    class halfband {
+    public:
+        /// Create a halfband filter.
+        /// @param pair_count	Half the number of non-zero taps beside the center. The filter has 4 * pair_count - 1 taps.
+
+        explicit halfband(int pair_count = 16)
+        : m_length { 2 * pair_count }
+        , m_coefficients(m_length)
+        , m_up_history(2 * m_length)
+        , m_down_history(2 * m_length)
+        , m_center_history(pair_count) {
+            // Blackman-windowed sinc at the taps at odd distances from the center, normalized to unity gain at DC
+            number sum {};
+            for (auto i = 0; i < m_length; ++i) {
+                auto m      = 2.0 * i - (m_length - 1.0);
+                auto sinc   = sin(M_PI * m / 2.0) / (M_PI * m);
+                auto window = 0.42 + 0.5 * cos(M_PI * m / m_length) + 0.08 * cos(2.0 * M_PI * m / m_length);
+                m_coefficients[i] = sinc * window;
+                sum += m_coefficients[i];
+            }
+            for (auto& c : m_coefficients)
+                c *= 0.5 / sum;
+        }
+
+
+        /// Return the delay of interpolating followed by decimating, in samples of the lower samplerate.
+        /// @return The latency in samples.
+
+        number latency() const {
+            return m_length - 1.5;
+        }
+
+
+        /// Clear the history.
+
+        void clear() {
+            std::fill(m_up_history.begin(), m_up_history.end(), 0.0);
+            std::fill(m_down_history.begin(), m_down_history.end(), 0.0);
+            std::fill(m_center_history.begin(), m_center_history.end(), 0.0);
+            m_up_index = m_down_index = m_center_index = 0;
+        }
+
+
+        /// Interpolate to twice the samplerate.
+        /// @param input		frame_count samples.
+        /// @param output		2 * frame_count samples.
+        /// @param frame_count	The number of input samples.
+
+        void up(const sample* input, sample* output, int frame_count) {
+            const auto center { m_length / 2 };
+
+            for (auto i = 0; i < frame_count; ++i) {
+                auto history = push(m_up_history, m_up_index, input[i]);
+                output[2 * i]     = 2.0 * convolve(history);
+                output[2 * i + 1] = history[m_length - center];
+            }
+        }
+
+
+        /// Decimate to half the samplerate.
+        /// @param input		2 * frame_count samples.
+        /// @param output		frame_count samples.
+        /// @param frame_count	The number of output samples.
+
+        void down(const sample* input, sample* output, int frame_count) {
+            const auto delay { static_cast<int>(m_center_history.size()) - 1 };
+
+            for (auto i = 0; i < frame_count; ++i) {
+                auto history = push(m_down_history, m_down_index, input[2 * i + 1]);
+                auto y       = convolve(history);
+
+                // the first sample of each pair meets the center tap delay pairs later
+                m_center_history[m_center_index] = input[2 * i];
+                auto center_index = m_center_index - delay;
+                if (center_index < 0)
+                    center_index += delay + 1;
+                output[i] = y + 0.5 * m_center_history[center_index];
+
+                ++m_center_index;
+                if (m_center_index > delay)
+                    m_center_index = 0;
+            }
+        }
+
+    private:
+        // The history is written twice, m_length samples apart, so that the last m_length samples are always contiguous.
+        // Returns a pointer to the oldest of them.
+
+        const sample* push(sample_vector& history, int& index, sample x) {
+            ++index;
+            if (index == m_length)
+                index = 0;
+            history[index + m_length - 1] = x;
+            history[index == 0 ? 2 * m_length - 1 : index - 1] = x;
+            return history.data() + index;
+        }
+
+        number convolve(const sample* history) const {
+            number y {};
+            for (auto i = 0; i < m_length; ++i)
+                y += m_coefficients[i] * history[m_length - 1 - i];
+            return y;
+        }
+
+        int             m_length;            ///< number of non-zero taps beside the center
+        vector<number>  m_coefficients;
+        sample_vector   m_up_history;
+        sample_vector   m_down_history;
+        sample_vector   m_center_history;    ///< samples waiting for the center tap of the decimator
+        int             m_up_index {};
+        int             m_down_index {};
+        int             m_center_index {};
+    };
+
+
+    ///	Single-channel oversampling by a factor of 1, 2, 4 or 8 for nonlinear processing (saturation, filters with feedback, limiting)
+    /// that would alias at the samplerate of the patcher.
+    /// The signal is interpolated with a cascade of halfband filters, processed by a kernel at the higher samplerate, and decimated again.
+    ///
+    /// The filters are linear-phase FIR filters, so the latency is constant and reported by latency().
+    /// The octave next to the samplerate has the steepest filter; the higher octaves only need to reject images far above the audible range.
+    ///
+    /// Blocks of any size may be processed: they are split into chunks of the maximum frame count given at creation,
+    /// so nothing is allocated while processing.
+    ///
+    /// Usage from the operator() of a vector_operator, with one oversampler per channel:
+    /// @code
+    ///     m_oversampler(input.samples(0), output.samples(0), input.frame_count(), [this](sample x) {
+    ///         return m_saturation(x);
+    ///     });
+    /// @endcode
+
+    class oversampler {
+    public:
+        /// Create an oversampler.
+        /// @param a_factor				The oversampling factor: 1, 2, 4 or 8.
+        /// @param a_max_frame_count	The number of samples at the original samplerate that are processed at once.
+
+        explicit oversampler(int a_factor = 2, int a_max_frame_count = 512)
+        : m_max_frame_count { a_max_frame_count } {
+            factor(a_factor);
+        }
+
+
+        /// Set the oversampling factor. This allocates and clears the history.
+        /// @param a_factor		1, 2, 4 or 8. Other values are rounded down to one of these.
+
+        void factor(int a_factor) {
+            a_factor = MIN_CLAMP(a_factor, 1, 8);
+
+            m_stages.clear();
+            for (auto pairs : { 16, 6, 4 }) {
+                if ((2 << m_stages.size()) > a_factor)
+                    break;
+                m_stages.emplace_back(pairs);
+            }
+            m_factor = 1 << m_stages.size();
+
+            m_buffer_a.resize(m_max_frame_count * m_factor);
+            m_buffer_b.resize(m_max_frame_count * m_factor);
+        }
+
+        /// Return the oversampling factor.
+        /// @return The oversampling factor.
+
+        int factor() const {
+            return m_factor;
+        }
+
+
+        /// Return the delay that the oversampling adds to the signal.
+        /// @return The latency in samples at the original samplerate. It is not necessarily an integer.
+
+        number latency() const {
+            number latency {};
+            auto   rate { 1.0 };
+
+            for (auto& stage : m_stages) {
+                latency += stage.latency() / rate;
+                rate *= 2.0;
+            }
+            return latency;
+        }
+
+
+        /// Clear the history of the filters.
+
+        void clear() {
+            for (auto& stage : m_stages)
+                stage.clear();
+        }
+
+
+        /// Interpolate a block to the oversampled rate.
+        /// @param input		frame_count samples at the original samplerate.
+        /// @param frame_count	The number of samples, at most the maximum frame count.
+        /// @return				factor() * frame_count samples, which may be processed in place until the next call.
+
+        template<typename T>
+        sample* up(const T* input, int frame_count) {
+            assert(frame_count <= m_max_frame_count);
+
+            std::copy_n(input, frame_count, m_buffer_a.data());
+            auto source = m_buffer_a.data();
+            auto target = m_buffer_b.data();
+
+            for (auto& stage : m_stages) {
+                stage.up(source, target, frame_count);
+                std::swap(source, target);
+                frame_count *= 2;
+            }
+            return source;
+        }
+
+
+        /// Decimate the block returned by the last call of up() back to the original samplerate.
+        /// @param output		frame_count samples at the original samplerate.
+        /// @param frame_count	The number of samples, which must be the same as for the call of up().
+
+        template<typename T>
+        void down(T* output, int frame_count) {
+            assert(frame_count <= m_max_frame_count);
+
+            // up() left its result in the first buffer if the number of stages is even
+            auto source = m_stages.size() % 2 ? m_buffer_b.data() : m_buffer_a.data();
+            auto target = m_stages.size() % 2 ? m_buffer_a.data() : m_buffer_b.data();
+            auto count  = frame_count * m_factor;
+
+            for (auto stage = m_stages.rbegin(); stage != m_stages.rend(); ++stage) {
+                count /= 2;
+                stage->down(source, target, count);
+                std::swap(source, target);
+            }
+            for (auto i = 0; i < frame_count; ++i)
+                output[i] = static_cast<T>(source[i]);
+        }
+
+
+        /// Process a block of any length at the oversampled rate.
+        /// @param input		frame_count samples at the original samplerate.
+        /// @param output		frame_count samples at the original samplerate. May be the same as input.
+        /// @param frame_count	The number of samples.
+        /// @param kernel		Either a function that calculates one sample, sample(sample),
+        ///						or one that processes a block in place, void(sample* samples, int frame_count),
+        ///						both at factor() times the samplerate.
+
+        template<typename T, typename kernel_type>
+        void operator()(const T* input, T* output, int frame_count, kernel_type&& kernel) {
+            for (auto offset = 0; offset < frame_count; offset += m_max_frame_count) {
+                auto count       = std::min(m_max_frame_count, frame_count - offset);
+                auto oversampled = up(input + offset, count);
+
+                if constexpr (std::is_invocable_r_v<sample, kernel_type, sample>) {
+                    for (auto i = 0; i < count * m_factor; ++i)
+                        oversampled[i] = kernel(oversampled[i]);
+                }
+                else
+                    kernel(oversampled, count * m_factor);
+
+                down(output + offset, count);
+            }
+        }
+
+    private:
+        int             m_max_frame_count;
+        int             m_factor {1};
+        vector<halfband> m_stages;      ///< from the original samplerate upwards
+        sample_vector   m_buffer_a;
+        sample_vector   m_buffer_b;
+    };
+
+
+}    // namespace c74::min::lib
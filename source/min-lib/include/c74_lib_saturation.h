@@ -6,14 +6,25 @@
 #pragma once
 
 #include "c74_min_api.h"
+#include "c74_lib_math.h"
+#include "c74_lib_oversampler.h"
 
 namespace c74::min::lib {
 
 
     ///	A single-channel soft-saturation/distortion effect.
+    /// The input is clamped to [-1, 1] and shaped with a polynomial sine, without branches,
+    /// so a block is shaped by a loop that the compiler can vectorize, and the output is the same on every platform.
 
     class saturation {
     public:
+        /// Create a saturation without overdrive.
+
+        saturation() {
+            drive(m_drive);
+        }
+
+
         /// Set the amount of overdrive.
         /// @param	drive_percentage	The new amount of overdrive as a percentage.
 
@@ -21,15 +32,12 @@ namespace c74::min::lib {
             m_drive = drive_percentage;
             auto f  = MIN_CLAMP(drive_percentage / 100.0, 0.001, 0.999);
 
-            m_z    = M_PI * f;
-            m_s    = 1.0 / sin(m_z);
-            m_b    = MIN_CLAMP(1.0 / f, 0.0, 1.0);
-            m_nb   = m_b * -1.0;
-            auto i = int(f);
-            if ((f - (double)i) > 0.5)
-                m_scale = sin(m_z);    // sin(f * kTTPi);
-            else
-                m_scale = 1.0;
+            m_z = M_PI * f;
+
+            // inputs beyond 1.0 are clipped to 1.0, where sin(m_z * x) / sin(m_z) reaches 1.0
+            auto s     = 1.0 / math::fast_sin(m_z);
+            auto scale = f > 0.5 ? math::fast_sin(m_z) : 1.0;
+            m_gain     = s * scale;
         }
 
 
@@ -41,39 +49,69 @@ namespace c74::min::lib {
         }
 
 
-        /// Calculate one sample.
+        /// Set the oversampling of the block operator(), which reduces the aliasing of strong overdrive.
+        /// This allocates memory.
+        /// @param	factor	The oversampling factor: 1 (no oversampling), 2, 4 or 8.
+
+        void oversampling(int factor) {
+            m_oversampler.factor(factor);
+        }
+
+
+        /// Return the oversampling factor of the block operator().
+        /// @return The oversampling factor.
+
+        int oversampling() const {
+            return m_oversampler.factor();
+        }
+
+
+        /// Return the delay that the oversampling adds to the block operator().
+        /// @return The latency in samples.
+
+        number latency() const {
+            return m_oversampler.latency();
+        }
+
+
+        /// Calculate one sample, without oversampling.
         ///	@return		Calculated sample
 
         sample operator()(sample x) {
-            if (x > m_b)
-                x = 1.0;
-            else if (x < m_nb)
-                x = -1.0;
-#ifdef WIN_VERSION
+            return shape(x);
+        }
+
+
+        /// Calculate a block of samples, oversampled if oversampling() is more than 1.
+        /// @param	input		frame_count input samples.
+        /// @param	output		frame_count output samples. May be the same as input.
+        /// @param	frame_count	The number of samples.
+
+        void operator()(const sample* input, sample* output, int frame_count) {
+            if (m_oversampler.factor() == 1) {
+                for (auto i = 0; i < frame_count; ++i)
+                    output[i] = shape(input[i]);
+            }
             else {
-                number sign;
-                if (x < 0.0) {
-                    x    = -x;
-                    sign = -1.0;
-                }
-                else
-                    sign = 1.0;
-                x = sign * sin(m_z * x) * m_s;
+                m_oversampler(input, output, frame_count, [this](sample* x, int count) {
+                    for (auto i = 0; i < count; ++i)
+                        x[i] = shape(x[i]);
+                });
             }
-#else
-            else
-                x = sin(m_z * x) * m_s;
-#endif
-            return x * m_scale;
         }
 
     private:
-        number m_drive{};
-        number m_z;
-        number m_s;
-        number m_b;
-        number m_nb;    // negative b
-        number m_scale;
+        sample shape(sample x) const {
+            // clamping the magnitude of the angle clamps the input to [-1, 1] in a way that the compiler vectorizes
+            auto a = std::abs(m_z * x);
+            a      = a < m_z ? a : m_z;
+            return math::fast_sin(std::copysign(a, x)) * m_gain;
+        }
+
+        number      m_drive{};
+        number      m_z;
+        number      m_gain;    ///< 1 / sin(m_z), and for a drive above 50% also scaled by sin(m_z)
+        oversampler m_oversampler { 1 };
     };
 
 
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+
 namespace c74::min::lib {
 
     ///	Generate a non-bandlimited <a href="https://en.wikipedia.org/wiki/Sawtooth_wave">sawtooth wave</a> oscillator (a phasor~ in MSP
@@ -63,6 +66,50 @@ namespace c74::min::lib {
             return y;
         }
 
+
+        /// Calculate a block of samples.
+        /// Each sample is calculated from the phase at the start of the block rather than by adding up the steps,
+        /// so the loop has no dependency from one sample to the next and the compiler can vectorize it.
+        /// @param	output		The calculated samples.
+        /// @param	frame_count	The number of samples.
+
+        void operator()(sample* output, std::size_t frame_count) {
+            if (frame_count == 0)
+                return;
+
+            const auto base = m_phase - std::floor(m_phase);
+            const auto step = m_step;
+
+            for (std::size_t i = 0; i < frame_count; ++i) {
+                const auto p = base + static_cast<double>(i) * step;
+                output[i]    = p - std::floor(p);
+            }
+            m_phase = output[frame_count - 1] + step;
+        }
+
+
+        /// Calculate a block of samples with a frequency for each sample, e.g. from a signal.
+        /// The frequencies are limited to the range of +/- the nyquist frequency, rather than folded into it as by frequency().
+        /// The frequency set with frequency() is not changed.
+        /// @param	frequencies	The frequency of the oscillator in hertz for each sample.
+        /// @param	output		The calculated samples. May be the same as frequencies.
+        /// @param	frame_count	The number of samples.
+
+        void operator()(const sample* frequencies, sample* output, std::size_t frame_count) {
+            const auto to_step   = m_fs > 0.0 ? 1.0 / m_fs : 0.0;
+            const auto f_nyquist = m_fs * 0.5;
+            auto       phase     = m_phase;
+
+            for (std::size_t i = 0; i < frame_count; ++i) {
+                const auto f = std::min(std::max(frequencies[i], -f_nyquist), f_nyquist);
+
+                phase -= std::floor(phase);
+                output[i] = phase;
+                phase += f * to_step;
+            }
+            m_phase = phase;
+        }
+
     private:
         number m_phase{};    ///< current phase
         number m_step{};     ///< increment for each sample iteration
@@ -0,0 +1,412 @@
+/// @file
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include "c74_min_api.h"
+
+namespace c74::min::lib {
+
+
+    ///	Assign the notes of a polyphonic instrument to a fixed pool of voices.
+    ///
+    /// A voice is free, held (its note is on) or released (its note is off but it is still sounding, e.g. in the release of its envelope).
+    /// A new note takes the voice that already plays its pitch, else a free voice,
+    /// else the oldest released voice, and else steals a held voice according to the steal_policy.
+    /// A voice only becomes free when its owner reports that it has finished sounding by calling finished().
+    ///
+    /// The state of the voices is stored as one array per field rather than one struct per voice,
+    /// and the sounding voices are kept in a compact list in the order they were started,
+    /// so that processing them touches only the voices that sound.
+    /// All storage is allocated by the constructor, and none of the other functions allocate,
+    /// so notes can be allocated in the audio thread.
+    /// The allocator is not thread-safe: use it from one thread (see voice_bank_operator).
+
+    class voice_allocator {
+    public:
+        /// How a note is assigned a voice when all voices are held.
+
+        enum class steal_policy {
+            none,       ///< drop the new note
+            oldest,     ///< steal the voice whose note was started first
+            lowest,     ///< steal the voice with the lowest pitch
+            highest     ///< steal the voice with the highest pitch
+        };
+
+
+        /// The state of a voice.
+
+        enum class voice_state : unsigned char {
+            free,
+            held,
+            released
+        };
+
+
+        /// Returned instead of a voice if a note has none.
+
+        static constexpr int k_no_voice { -1 };
+
+
+        /// Create a pool of voices.
+        /// @param	voice_count		The number of voices.
+        /// @param	policy			How a voice is found for a note when all voices are held.
+
+        explicit voice_allocator(const int voice_count = 16, const steal_policy policy = steal_policy::oldest)
+        : m_pitch(std::max(voice_count, 1))
+        , m_velocity(std::max(voice_count, 1))
+        , m_state(std::max(voice_count, 1), voice_state::free)
+        , m_policy { policy } {
+            m_active.reserve(m_state.size());
+            m_free.reserve(m_state.size());
+            reset();
+        }
+
+
+        /// Return the number of voices.
+        /// @return	The number of voices.
+
+        int voice_count() const {
+            return static_cast<int>(m_state.size());
+        }
+
+
+        /// Set how a voice is found for a note when all voices are held.
+        /// @param	policy	The steal policy.
+
+        void policy(const steal_policy policy) {
+            m_policy = policy;
+        }
+
+
+        /// Return how a voice is found for a note when all voices are held.
+        /// @return	The steal policy.
+
+        steal_policy policy() const {
+            return m_policy;
+        }
+
+
+        /// Start a note. A velocity of zero stops the note instead, as in MIDI.
+        /// @param	pitch		The pitch of the note.
+        /// @param	velocity	The velocity of the note.
+        /// @return				The voice that plays the note, or k_no_voice if it was dropped or (for a velocity of zero) not playing.
+        ///						If the voice was playing a note, whether the same pitch or a stolen one, the note replaces it.
+
+        int note_on(const int pitch, const int velocity) {
+            if (velocity <= 0)
+                return note_off(pitch);
+
+            auto voice { find(pitch) };
+
+            if (voice == k_no_voice && !m_free.empty()) {
+                voice = m_free.back();
+                m_free.pop_back();
+            }
+            else if (voice == k_no_voice) {
+                voice = steal();
+                if (voice == k_no_voice)
+                    return k_no_voice;
+            }
+
+            remove_active(voice);
+            m_active.push_back(voice);    // the newest note is last
+
+            m_pitch[voice]    = pitch;
+            m_velocity[voice] = velocity;
+            m_state[voice]    = voice_state::held;
+            return voice;
+        }
+
+
+        /// Stop a note. Its voice is released, and remains active until finished() is called for it.
+        /// @param	pitch	The pitch of the note.
+        /// @return			The voice that played the note, or k_no_voice if no voice holds the pitch.
+
+        int note_off(const int pitch) {
+            for (const auto voice : m_active) {
+                if (m_state[voice] == voice_state::held && m_pitch[voice] == pitch) {
+                    m_state[voice] = voice_state::released;
+                    return voice;
+                }
+            }
+            return k_no_voice;
+        }
+
+
+        /// Release all held voices.
+
+        void release_all() {
+            for (const auto voice : m_active)
+                m_state[voice] = voice_state::released;
+        }
+
+
+        /// Return a voice to the pool after it has finished sounding.
+        /// @param	voice	The voice.
+
+        void finished(const int voice) {
+            if (m_state[voice] == voice_state::free)
+                return;
+            remove_active(voice);
+            m_state[voice] = voice_state::free;
+            m_free.push_back(voice);
+        }
+
+
+        /// Free all voices immediately.
+
+        void reset() {
+            m_active.clear();
+            m_free.clear();
+            for (auto voice = voice_count() - 1; voice >= 0; --voice) {    // so that voice 0 is taken first
+                m_state[voice] = voice_state::free;
+                m_free.push_back(voice);
+            }
+        }
+
+
+        /// Return the state of a voice.
+        /// @param	voice	The voice.
+        /// @return			The state.
+
+        voice_state state(const int voice) const {
+            return m_state[voice];
+        }
+
+
+        /// Return whether a voice is sounding, i.e. held or released.
+        /// @param	voice	The voice.
+        /// @return			True if the voice is not free.
+
+        bool active(const int voice) const {
+            return m_state[voice] != voice_state::free;
+        }
+
+
+        /// Return the pitch of the last note of a voice.
+        /// @param	voice	The voice.
+        /// @return			The pitch.
+
+        int pitch(const int voice) const {
+            return m_pitch[voice];
+        }
+
+
+        /// Return the velocity of the last note of a voice.
+        /// @param	voice	The voice.
+        /// @return			The velocity.
+
+        int velocity(const int voice) const {
+            return m_velocity[voice];
+        }
+
+
+        /// Return the sounding voices, in the order their notes were started.
+        /// The list changes with each call of note_on() and finished().
+        /// @return	The voices.
+
+        const vector<int>& active_voices() const {
+            return m_active;
+        }
+
+
+        /// Return the number of sounding voices.
+        /// @return	The number of voices that are not free.
+
+        int active_count() const {
+            return static_cast<int>(m_active.size());
+        }
+
+    private:
+        vector<int>             m_pitch;
+        vector<int>             m_velocity;
+        vector<voice_state>     m_state;
+        vector<int>             m_active;    ///< the voices that are not free, oldest first
+        vector<int>             m_free;      ///< taken from the back
+        steal_policy            m_policy;
+
+        // the voice that is playing a pitch (held or released)
+
+        int find(const int pitch) const {
+            for (const auto voice : m_active) {
+                if (m_pitch[voice] == pitch)
+                    return voice;
+            }
+            return k_no_voice;
+        }
+
+        int steal() const {
+            for (const auto voice : m_active) {
+                if (m_state[voice] == voice_state::released)
+                    return voice;
+            }
+
+            if (m_active.empty())
+                return k_no_voice;
+
+            switch (m_policy) {
+                case steal_policy::oldest:
+                    return m_active.front();
+                case steal_policy::lowest:
+                    return *std::min_element(m_active.begin(), m_active.end(), [this](const int a, const int b) {
+                        return m_pitch[a] < m_pitch[b];
+                    });
+                case steal_policy::highest:
+                    return *std::max_element(m_active.begin(), m_active.end(), [this](const int a, const int b) {
+                        return m_pitch[a] < m_pitch[b];
+                    });
+                default:
+                    return k_no_voice;
+            }
+        }
+
+        void remove_active(const int voice) {
+            const auto position { std::find(m_active.begin(), m_active.end(), voice) };
+
+            if (position != m_active.end())
+                m_active.erase(position);
+        }
+    };
+
+
+    ///	A base for polyphonic instruments whose voices are output on the channels of a multichannel signal.
+    /// Inherit from it together with object<>, e.g.
+    /// @code
+    /// class poly : public object<poly>, public lib::voice_bank_operator {
+    /// @endcode
+    /// and reserve a channel per voice by returning voice_count() from the "multichanneloutputs" message.
+    ///
+    /// Notes are passed to note() from any thread, and take effect in the audio thread at the sample that corresponds to their time
+    /// (see timed_events). The call operator hands the output to process_voices(),
+    /// which renders only the voices that are sounding. The channels of the other voices are set to zero by the wrapper
+    /// (see channel_mask), so the cost of the instrument grows with the number of sounding notes rather than with its polyphony.
+
+    class voice_bank_operator : public mc_operator<> {
+    public:
+        /// Create a bank of voices.
+        /// @param	voice_count		The number of voices, which is also the number of output channels.
+        /// @param	policy			How a voice is found for a note when all voices are held.
+
+        explicit voice_bank_operator(const int voice_count = 16, const voice_allocator::steal_policy policy = voice_allocator::steal_policy::oldest)
+        : m_voices { voice_count, policy }
+        , m_rendered(m_voices.voice_count()) {}
+
+
+        /// Return the number of voices.
+        /// @return	The number of voices.
+
+        int voice_count() const {
+            return m_voices.voice_count();
+        }
+
+
+        /// Start or stop a note, from any thread other than the audio thread. A velocity of zero stops the note.
+        /// @param	pitch		The pitch of the note.
+        /// @param	velocity	The velocity of the note.
+        /// @param	delay_in_ms	The time after now at which the note starts or stops.
+        /// @return				False if the note was dropped because too many notes are waiting, otherwise true.
+
+        bool note(const int pitch, const int velocity, const double delay_in_ms = 0.0) {
+            return m_notes.post({ pitch, velocity }, delay_in_ms);
+        }
+
+
+        /// Stop all notes, from any thread other than the audio thread. The voices are released rather than silenced.
+
+        void stop_all() {
+            m_notes.post({ 0, k_stop_all });
+        }
+
+    protected:
+        /// Process a vector of audio for the sounding voices. Call this from the call operator.
+        ///
+        /// @param	output		The output of the call operator, with a channel for each voice.
+        /// @param	on_note		Called when a voice starts or stops a note, prototyped as `void (int voice, int pitch, int velocity)`.
+        ///						The velocity is zero when the note stops.
+        /// @param	render		Called for each sounding voice and each part of the vector between notes,
+        ///						prototyped as `bool (int voice, sample* output, long frame_count)`.
+        ///						It must fill the output and return false when the voice has finished sounding, e.g. at the end of its release.
+
+        template<class on_note_type, class render_type>
+        void process_voices(audio_bundle& output, on_note_type&& on_note, render_type&& render) {
+            const auto channel_count { std::min(static_cast<long>(voice_count()), output.channel_count()) };
+            const auto frame_count { output.frame_count() };
+
+            std::fill(m_rendered.begin(), m_rendered.end(), false);
+
+            m_notes.split(frame_count,
+                [&](const note_event& e) {
+                    if (e.velocity == k_stop_all) {
+                        for (const auto voice : m_voices.active_voices()) {
+                            if (m_voices.state(voice) == voice_allocator::voice_state::held)
+                                on_note(voice, m_voices.pitch(voice), 0);
+                        }
+                        m_voices.release_all();
+                        return;
+                    }
+
+                    const auto voice { m_voices.note_on(e.pitch, e.velocity) };
+
+                    if (voice != voice_allocator::k_no_voice)
+                        on_note(voice, e.pitch, e.velocity);
+                },
+                [&](const long start, const long count) {
+                    // finished voices are removed from the list while it is traversed
+
+                    const auto& active { m_voices.active_voices() };
+
+                    for (auto i = 0; i < static_cast<int>(active.size());) {
+                        const auto voice { active[i] };
+
+                        if (voice >= channel_count) {
+                            ++i;
+                            continue;
+                        }
+                        if (!m_rendered[voice] && start > 0)
+                            std::fill_n(output.samples(voice), start, 0.0);    // the voice starts within this vector
+                        m_rendered[voice] = true;
+
+                        if (render(voice, output.samples(voice) + start, count))
+                            ++i;
+                        else
+                            m_voices.finished(voice);
+                    }
+
+                    // voices that finished earlier in this vector are silent for the rest of it
+
+                    for (auto voice = 0; voice < channel_count; ++voice) {
+                        if (m_rendered[voice] && !m_voices.active(voice))
+                            std::fill_n(output.samples(voice) + start, count, 0.0);
+                    }
+                });
+
+            for (auto voice = 0; voice < channel_count; ++voice)
+                enabled_channels().enable(voice, m_rendered[voice]);
+        }
+
+
+        /// Access the allocator, e.g. to set its steal policy. Only use it in the audio thread.
+        /// @return	The allocator.
+
+        voice_allocator& voices() {
+            return m_voices;
+        }
+
+    private:
+        struct note_event {
+            int pitch {};
+            int velocity {};
+        };
+
+        static constexpr int k_stop_all { -1 };    ///< the velocity of the event posted by stop_all()
+
+        voice_allocator             m_voices;
+        timed_events<note_event>    m_notes;
+        vector<bool>                m_rendered;    ///< the voices rendered in the current vector
+    };
+
+
+}    // namespace c74::min::lib
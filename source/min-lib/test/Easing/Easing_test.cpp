@@ -2434,3 +2434,103 @@ SCENARIO ("Using In Out Sine Easing") {
 
     }
 }
+
+
+SCENARIO ("Using a table of an easing function") {
+    using namespace c74::min::lib::easing;
+
+    struct bound {
+        function name;
+        double   linear;    ///< maximum error with linear interpolation
+        double   cubic;     ///< maximum error with cubic interpolation
+    };
+
+    // The maximum errors at the default resolution of 256 intervals.
+    const bound bounds[] = {
+        { function::linear, 1e-12, 1e-12 },
+        { function::in_back, 4e-5, 1e-7 },
+        { function::in_bounce, 4e-3, 3e-3 },
+        { function::in_circular, 3e-2, 3e-2 },
+        { function::in_cubic, 2e-5, 3e-8 },
+        { function::in_elastic, 9e-4, 4e-5 },
+        { function::in_exponential, 1e-3, 1e-3 },
+        { function::in_quadratic, 5e-6, 1e-12 },
+        { function::in_quartic, 3e-5, 1e-7 },
+        { function::in_quintic, 5e-5, 3e-7 },
+        { function::in_sine, 6e-6, 2e-8 },
+        { function::in_out_back, 7e-5, 4e-5 },
+        { function::in_out_bounce, 1e-2, 8e-3 },
+        { function::in_out_circular, 2e-2, 2e-2 },
+        { function::in_out_cubic, 3e-5, 2e-5 },
+        { function::in_out_elastic, 2e-3, 1e-3 },
+        { function::in_out_exponential, 6e-4, 6e-4 },
+        { function::in_out_quadratic, 1e-5, 6e-6 },
+        { function::in_out_quartic, 6e-5, 4e-5 },
+        { function::in_out_quintic, 1e-4, 6e-5 },
+        { function::in_out_sine, 1e-5, 2e-8 },
+        { function::out_back, 4e-5, 1e-7 },
+        { function::out_bounce, 4e-3, 3e-3 },
+        { function::out_circular, 3e-2, 3e-2 },
+        { function::out_cubic, 2e-5, 3e-8 },
+        { function::out_elastic, 9e-4, 4e-5 },
+        { function::out_exponential, 1e-3, 1e-3 },
+        { function::out_quadratic, 5e-6, 1e-12 },
+        { function::out_quartic, 3e-5, 1e-7 },
+        { function::out_quintic, 5e-5, 3e-7 },
+        { function::out_sine, 6e-6, 2e-8 },
+    };
+
+    for (auto& b : bounds) {
+        GIVEN ("A table of " + std::string(function_info[static_cast<int>(b.name)])) {
+            table linear_table { b.name, 256, table::interpolation::linear };
+            table cubic_table { b.name, 256, table::interpolation::cubic };
+
+            THEN("The output matches the easing function within the documented bounds") {
+                for (auto i = 0; i <= 10000; ++i) {
+                    auto x = i / 10000.0;
+                    auto y = apply(b.name, x);
+                    INFO( "when x == " << x );
+                    REQUIRE( linear_table(x) == Approx(y).margin(b.linear) );
+                    REQUIRE( cubic_table(x) == Approx(y).margin(b.cubic) );
+                }
+            }
+        }
+    }
+
+    GIVEN ("A table and input outside the range of 0.0 to 1.0") {
+        table t { function::in_back };
+
+        THEN("The input is clamped") {
+            REQUIRE( t(-0.5) == Approx(0.0).margin(1e-12) );
+            REQUIRE( t(1.5) == Approx(1.0).margin(1e-12) );
+        }
+    }
+}
+
+
+SCENARIO ("Easing a block of numbers") {
+    using namespace c74::min::lib::easing;
+
+    c74::min::sample_vector input(100);
+    for (auto i = 0; i < input.size(); ++i)
+        input[i] = i / double(input.size() - 1);
+
+    for (auto name : { function::in_out_back, function::out_bounce, function::in_elastic }) {
+        GIVEN ("The block version of " + std::string(function_info[static_cast<int>(name)])) {
+            c74::min::sample_vector exact(input.size());
+            c74::min::sample_vector tabled(input.size());
+
+            apply(name, input.data(), exact.data(), input.size());
+
+            table t { name };
+            t(input.data(), tabled.data(), input.size());
+
+            THEN("The output is the same as one number at a time") {
+                for (auto i = 0; i < input.size(); ++i) {
+                    REQUIRE( exact[i] == apply(name, input[i]) );
+                    REQUIRE( tabled[i] == t(input[i]) );
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/// @file
+///	@brief 		Unit test for the adsr class
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+namespace {
+
+    template<class envelope_type>
+    void configure(envelope_type& envelope, double curve) {
+        envelope.initial(0.0);
+        envelope.peak(1.0);
+        envelope.sustain(0.5);
+        envelope.end(0.0);
+        envelope.attack(10.0, 10000.0);
+        envelope.attack_curve(curve);
+        envelope.decay(20.0, 10000.0);
+        envelope.decay_curve(-curve);
+        envelope.release(30.0, 10000.0);
+        envelope.release_curve(curve);
+        envelope.retrigger(5.0, 10000.0);
+    }
+
+    // Triggers at these samples of the 1000 rendered: a release from the sustain, an early release and a retrigger.
+    const std::vector<std::pair<int, bool>> k_triggers { {10, true}, {400, false}, {600, true}, {650, false}, {800, true}, {850, true} };
+
+    c74::min::sample_vector render_by_sample(c74::min::lib::adsr& envelope) {
+        c74::min::sample_vector output(1000);
+        auto                    trigger = k_triggers.begin();
+
+        for (auto i = 0; i < output.size(); ++i) {
+            if (trigger != k_triggers.end() && trigger->first == i) {
+                envelope.trigger(trigger->second);
+                ++trigger;
+            }
+            output[i] = envelope();
+        }
+        return output;
+    }
+
+    c74::min::sample_vector render_by_block(c74::min::lib::adsr& envelope) {
+        c74::min::sample_vector output(1000);
+        auto                    i = 0;
+
+        for (auto& trigger : k_triggers) {
+            envelope.process(output.data() + i, trigger.first - i);
+            envelope.trigger(trigger.second);
+            i = trigger.first;
+        }
+        envelope.process(output.data() + i, static_cast<int>(output.size()) - i);
+        return output;
+    }
+
+}
+
+
+TEST_CASE ("Rendering blocks of an envelope with linear slopes is the same as one sample at a time") {
+    c74::min::lib::adsr by_sample;
+    c74::min::lib::adsr by_block;
+    configure(by_sample, 0.0);
+    configure(by_block, 0.0);
+
+    auto expected = render_by_sample(by_sample);
+    auto output   = render_by_block(by_block);
+
+    REQUIRE( output == expected );
+}
+
+
+TEST_CASE ("Rendering blocks of an envelope with curved slopes matches one sample at a time within 1e-5") {
+    for (auto curve : { 80.0, -35.0 }) {
+        c74::min::lib::adsr by_sample;
+        c74::min::lib::adsr by_block;
+        configure(by_sample, curve);
+        configure(by_block, curve);
+
+        auto expected = render_by_sample(by_sample);
+        auto output   = render_by_block(by_block);
+
+        for (auto i = 0; i < output.size(); ++i) {
+            INFO( "when i == " << i );
+            REQUIRE( output[i] == Approx(expected[i]).margin(1e-5) );
+        }
+    }
+}
+
+
+TEST_CASE ("The voices of an adsr_bank are independent envelopes with the same settings") {
+    const auto          frame_count = 300;
+    c74::min::lib::adsr_bank bank { 3 };
+    c74::min::lib::adsr      single;
+    configure(bank, 50.0);
+    configure(single, 50.0);
+
+    bank.trigger(1, true);
+    single.trigger(true);
+
+    std::vector<c74::min::sample_vector> outputs(3, c74::min::sample_vector(frame_count));
+    c74::min::sample*                    buffers[] { outputs[0].data(), outputs[1].data(), outputs[2].data() };
+    bank.process(buffers, frame_count);
+
+    c74::min::sample_vector expected(frame_count);
+    single.process(expected.data(), frame_count);
+
+    REQUIRE( outputs[1] == expected );
+    REQUIRE( outputs[0] == c74::min::sample_vector(frame_count, 0.0) );
+    REQUIRE( outputs[2] == c74::min::sample_vector(frame_count, 0.0) );
+    REQUIRE( bank.stage(1) == c74::min::lib::adsr::adsr_stage::sustain );
+    REQUIRE( !bank.active(0) );
+}
@@ -250,6 +250,15 @@ TEST_CASE ("Using other non-default settings") {
     f.delay(2);
     REQUIRE( f.delay() == 2 );     // check the new value
 
+    INFO("Increasing the delay time beyond the capacity...");
+    f.delay(10000);
+    REQUIRE( f.capacity() == 4800 );
+    REQUIRE( f.delay() == 4800 );     // clamped to the capacity
+
+    INFO("Changing the delay time with a crossfade...");
+    f.delay(300, 64);
+    REQUIRE( f.delay() == 300 );
+
 
 }
 
@@ -1067,7 +1076,7 @@ TEST_CASE ("Parameters are set properly with different constructors") {
 TEST_CASE ("Setting delay time in milliseconds") {
     using namespace c74::min;
     using namespace c74::min::lib;
-    allpass my_allpass;
+    allpass my_allpass { 44100.0 * 4 };    // enough capacity for the longest of the times below
 
     number sampling_rate = 44100.0;
     number test_time_1 = 500.0;
@@ -0,0 +1,120 @@
+/// @file
+///	@brief 		Benchmarks of the min-lib unit generators
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "c74_min_catch.h"
+
+#include <random>
+#include <sstream>
+
+// The benchmarks are hidden test cases, so running this test as part of the unit tests measures nothing.
+// To measure, select them by their tag and write the results in a format that can be compared across builds, e.g.
+//
+//     benchmark_test "[benchmark]" --reporter xml --out benchmark.xml
+//
+// Every benchmark processes one vector of the given size and returns a sample of the output,
+// so that the compiler can not remove the processing.
+
+using namespace c74::min;
+using namespace c74::min::lib;
+
+namespace {
+
+    sample_vector white_noise(const size_t size) {
+        sample_vector v(size);
+        std::mt19937 generator {0};
+        std::uniform_real_distribution<sample> distribution {-1.0, 1.0};
+
+        for (auto& x : v)
+            x = distribution(generator);
+        return v;
+    }
+
+
+    const char* interpolation_name(const interpolator::type t) {
+        switch (t) {
+            case interpolator::type::none:      return "none";
+            case interpolator::type::nearest:   return "nearest";
+            case interpolator::type::linear:    return "linear";
+            case interpolator::type::allpass:   return "allpass";
+            case interpolator::type::cosine:    return "cosine";
+            case interpolator::type::cubic:     return "cubic";
+            case interpolator::type::spline:    return "spline";
+            case interpolator::type::hermite:   return "hermite";
+            default:                            return "?";
+        }
+    }
+
+    const std::array<size_t, 3> k_vector_sizes {{ 16, 64, 512 }};
+}
+
+
+TEST_CASE ("lib::delay", "[.][benchmark]") {
+    for (const auto vector_size : k_vector_sizes) {
+        for (const auto delay_time : { 100.0, 4410.5, 44100.25 }) {
+            for (const auto type : { interpolator::type::none, interpolator::type::linear, interpolator::type::hermite }) {
+                delay d {{ 48000, delay_time }};
+                d.change_interpolation(type);
+
+                const auto input { white_noise(vector_size) };
+                sample_vector output(vector_size);
+
+                std::ostringstream name;
+                name << "delay " << delay_time << " " << interpolation_name(type) << " vs " << vector_size;
+
+                BENCHMARK (name.str()) {
+                    d(input.data(), output.data(), vector_size);
+                    return output[0];
+                };
+            }
+        }
+    }
+}
+
+
+TEST_CASE ("interpolator::proxy", "[.][benchmark]") {
+    for (const auto vector_size : k_vector_sizes) {
+        for (auto t = 0u; t < static_cast<unsigned int>(interpolator::type::type_count); ++t) {
+            const auto type { static_cast<interpolator::type>(t) };
+            interpolator::proxy<> interpolate { type };
+
+            const auto input { white_noise(vector_size + 3) };
+            sample_vector output(vector_size);
+
+            BENCHMARK ("proxy " + std::string(interpolation_name(type)) + " vs " + std::to_string(vector_size)) {
+                interpolate(input.data(), 0.3, output.data(), vector_size);
+                return output[0];
+            };
+        }
+    }
+}
+
+
+TEST_CASE ("lib::limiter", "[.][benchmark]") {
+    for (const auto vector_size : k_vector_sizes) {
+        for (const auto channel_count : { 1, 2, 8 }) {
+            limiter l { channel_count, 512, 48000.0 };
+            l.threshold(-12.0);
+
+            vector<sample_vector> inputs(channel_count, white_noise(vector_size));
+            vector<sample_vector> outputs(channel_count, sample_vector(vector_size));
+            vector<sample*>       in;
+            vector<sample*>       out;
+
+            for (auto c = 0; c < channel_count; ++c) {
+                in.push_back(inputs[c].data());
+                out.push_back(outputs[c].data());
+            }
+
+            BENCHMARK ("limiter " + std::to_string(channel_count) + " channels vs " + std::to_string(vector_size)) {
+                l(audio_bundle { in.data(), channel_count, static_cast<long>(vector_size) },
+                  audio_bundle { out.data(), channel_count, static_cast<long>(vector_size) });
+                return outputs[0][0];
+            };
+        }
+    }
+}
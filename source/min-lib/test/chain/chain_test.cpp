@@ -0,0 +1,107 @@
+/// @file
+///	@brief 		Unit test for the chain class
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+namespace {
+
+    // a unit with only a per-sample operator and no history
+
+    class gain {
+    public:
+        c74::min::sample operator()(c74::min::sample x) {
+            return x * amount;
+        }
+
+        c74::min::number amount { 0.5 };
+    };
+
+
+    c74::min::sample_vector noise(const int size) {
+        c74::min::sample_vector x(size);
+
+        for (auto i = 0; i < size; ++i)
+            x[i] = sin(0.37 * i) + 0.3 * sin(1.9 * i) + 0.2;
+        return x;
+    }
+
+}
+
+
+SCENARIO ("a chain produces the same output as its units one after the other") {
+    using namespace c74::min;
+
+    GIVEN ("a chain of filters, which is processed in a single loop") {
+        lib::chain<lib::dcblocker, lib::onepole, gain> c;
+        lib::dcblocker                                 d;
+        lib::onepole                                   o;
+        gain                                           g;
+
+        c.unit<lib::onepole>().coefficient(0.3);
+        o.coefficient(0.3);
+        c.unit<2>().amount = 0.8;
+        g.amount = 0.8;
+
+        REQUIRE( decltype(c)::fused );
+
+        WHEN ("a sample is processed") {
+            THEN ("it passes through each unit") {
+                for (auto x : { 0.5, -0.25, 1.0, 0.0 })
+                    REQUIRE( c(x) == Approx(g(o(d(x)))) );
+            }
+        }
+        AND_WHEN ("blocks are processed") {
+            const auto    input { noise(1000) };
+            sample_vector output(input.size());
+            sample_vector expected(input.size());
+
+            c(input.data(), output.data(), 300);
+            c(input.data() + 300, output.data() + 300, 700);
+            for (auto i = 0u; i < input.size(); ++i)
+                expected[i] = g(o(d(input[i])));
+
+            THEN ("the output matches and the state carries over from block to block") {
+                for (auto i = 0u; i < input.size(); ++i)
+                    REQUIRE( output[i] == Approx(expected[i]) );
+            }
+            AND_THEN ("clearing the chain clears each unit") {
+                c.clear();
+                d.clear();
+                o.clear();
+                REQUIRE( c(0.5) == Approx(g(o(d(0.5)))) );
+            }
+        }
+    }
+
+    GIVEN ("a chain with an oversampled saturation, which is processed in chunks") {
+        lib::chain<lib::dcblocker, lib::saturation> c;
+        lib::dcblocker                              d;
+        lib::saturation                             s;
+
+        c.unit<1>().drive(80.0);
+        c.unit<1>().oversampling(2);
+        s.drive(80.0);
+        s.oversampling(2);
+
+        REQUIRE( !decltype(c)::fused );
+
+        WHEN ("a block longer than a chunk is processed in place") {
+            auto          buffer { noise(500) };
+            sample_vector expected(buffer);
+
+            d(expected.data(), expected.data(), expected.size());
+            s(expected.data(), expected.data(), static_cast<int>(expected.size()));
+            c(buffer.data(), buffer.data(), buffer.size());
+
+            THEN ("each unit processed the block with its block operator") {
+                for (auto i = 0u; i < buffer.size(); ++i)
+                    REQUIRE( buffer[i] == Approx(expected[i]).margin(1e-9) );
+            }
+        }
+    }
+}
@@ -363,3 +363,99 @@ TEST_CASE ("Comparing outputs from two versions of tail() function to ensure the
     samples = {29,30,31,32};
     circ.write(samples);
 }
+
+
+TEST_CASE ("Block writes and reads match writing and reading one item at a time") {
+    using namespace c74::min;
+
+    for (auto size : {16, 13}) {
+        INFO("Using a circular buffer of " << size << " samples, so that wrapping is done with " << (size == 16 ? "a bit mask" : "a division"));
+
+        lib::circular_storage<sample>	block_circ(size);
+        lib::circular_storage<sample>	sample_circ(size);
+        sample_vector					samples(5);
+        sample_vector					block_output(7);
+
+        for (auto vector = 0; vector < 10; ++vector) {
+            for (auto i = 0u; i < samples.size(); ++i)
+                samples[i] = vector * 10.0 + i + 1;
+
+            block_circ.write(samples.data(), samples.size());
+            for (auto& s : samples)
+                sample_circ.write(s);
+
+            for (auto offset : {0, 3, 9}) {
+                block_circ.read_tail(block_output.data(), block_output.size(), offset);
+                for (auto i = 0u; i < block_output.size(); ++i)
+                    REQUIRE( block_output[i] == sample_circ.tail(offset + i) );
+            }
+        }
+    }
+}
+
+
+TEST_CASE ("next_power_of_two() rounds up to a power of two") {
+    using storage = c74::min::lib::circular_storage<c74::min::sample>;
+
+    REQUIRE( storage::next_power_of_two(0) == 1 );
+    REQUIRE( storage::next_power_of_two(1) == 1 );
+    REQUIRE( storage::next_power_of_two(5) == 8 );
+    REQUIRE( storage::next_power_of_two(64) == 64 );
+    REQUIRE( storage::next_power_of_two(65) == 128 );
+}
+
+
+TEST_CASE ("Windows of a Circular Storage with a guard region are contiguous across the wrap") {
+    using namespace c74::min;
+
+    INFO("Using a 10-sample circular buffer that mirrors its first 3 samples");
+    lib::circular_storage<sample>	circ(10, 3);
+    sample_vector					samples = {1,2,3,4,5,6,7};
+
+    REQUIRE( circ.capacity() == 10 );
+    REQUIRE( circ.guard() == 3 );
+
+    for (auto vector = 0; vector < 5; ++vector) {
+        circ.write(samples.data(), 3);
+        circ.write(samples[vector]);
+        circ.write(samples);
+
+        for (auto offset = 0u; offset < circ.size(); ++offset) {
+            auto window = circ.window(offset);
+            for (auto i = 0u; i <= circ.guard(); ++i)
+                REQUIRE( window[i] == circ.tail(offset + i) );
+        }
+    }
+}
+
+
+TEST_CASE ("Thread check policies of Circular Storage") {
+    using namespace c74::min::lib;
+
+    INFO("The checked policy detects access from a second thread on the first call");
+    thread_check::checked checked;
+    REQUIRE( checked() );
+    bool checked_result {true};
+    std::thread([&]{ checked_result = checked(); }).join();
+    REQUIRE( !checked_result );
+
+    INFO("The sampled policy detects it on the next check");
+    thread_check::sampled<3> sampled;
+    REQUIRE( sampled() );
+    std::vector<bool> sampled_results;
+    std::thread([&]{
+        for (auto i = 0; i < 3; ++i)
+            sampled_results.push_back(sampled());
+    }).join();
+    REQUIRE( sampled_results == std::vector<bool> {true, true, false} );
+
+    INFO("The unchecked policy never fails, and the storage works the same with it");
+    circular_storage<c74::min::sample, thread_check::unchecked> circ(4);
+    bool unchecked_result {false};
+    std::thread([&]{ unchecked_result = thread_check::unchecked{}(); }).join();
+    REQUIRE( unchecked_result );
+
+    c74::min::sample_vector samples = {1,2,3};
+    circ.write(samples);
+    REQUIRE( circ.tail(1) == 1 );
+}
@@ -39,3 +39,52 @@ SCENARIO ("produce the correct impulse response") {
         }
     }
 }
+
+
+TEST_CASE ("The block and multichannel versions produce the same output as the per-sample filter") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    const auto            frame_count   = 200;
+    const auto            channel_count = 3;
+    vector<sample_vector> inputs(channel_count, sample_vector(frame_count));
+
+    for (auto channel = 0; channel < channel_count; ++channel) {
+        for (auto i = 0; i < frame_count; ++i)
+            inputs[channel][i] = sin(0.1 * (channel + 1) * i) + 0.25;
+    }
+
+    INFO ("Filtering a block is the same as filtering one sample at a time");
+    dcblocker single;
+    dcblocker block;
+    sample_vector output(frame_count);
+
+    block(inputs[0].data(), output.data(), frame_count);
+    for (auto i = 0; i < frame_count; ++i)
+        REQUIRE( output[i] == single(inputs[0][i]) );
+
+    INFO ("Each channel of a bank is the same as a separate filter, with planar and interleaved buffers");
+    vector<dcblocker>     filters(channel_count);
+    dcblocker_bank        bank { channel_count };
+    dcblocker_bank        interleaved_bank { channel_count };
+
+    vector<sample_vector> outputs(channel_count, sample_vector(frame_count));
+    const sample*         input_buffers[] { inputs[0].data(), inputs[1].data(), inputs[2].data() };
+    sample*               output_buffers[] { outputs[0].data(), outputs[1].data(), outputs[2].data() };
+    bank(input_buffers, output_buffers, frame_count);
+
+    sample_vector interleaved(frame_count * channel_count);
+    for (auto i = 0; i < frame_count; ++i) {
+        for (auto channel = 0; channel < channel_count; ++channel)
+            interleaved[i * channel_count + channel] = inputs[channel][i];
+    }
+    interleaved_bank.process_interleaved(interleaved.data(), interleaved.data(), frame_count);
+
+    for (auto channel = 0; channel < channel_count; ++channel) {
+        for (auto i = 0; i < frame_count; ++i) {
+            auto expected = filters[channel](inputs[channel][i]);
+            REQUIRE( outputs[channel][i] == expected );
+            REQUIRE( interleaved[i * channel_count + channel] == expected );
+        }
+    }
+}
@@ -210,7 +210,7 @@ TEST_CASE ("Setting an interpolating delay") {
 TEST_CASE ("Setting delay time in milliseconds") {
     using namespace c74::min;
     using namespace c74::min::lib;
-    delay my_delay;
+    delay my_delay { 44100.0 * 4 };    // enough capacity for the longest of the times below
 
     number sampling_rate = 44100.0;
     number test_time_1 = 500.0;
@@ -672,3 +672,89 @@ TEST_CASE ("Using tail() and write() functions") {
 
 }
 
+
+
+TEST_CASE ("Block processing matches processing one sample at a time") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    sample_vector input(64);
+    for (auto i = 0u; i < input.size(); ++i)
+        input[i] = math::random(-1.0, 1.0);
+
+    for (auto t : { interpolator::type::none, interpolator::type::linear, interpolator::type::cubic, interpolator::type::hermite }) {
+        delay block_delay(16);
+        delay sample_delay(16);
+        block_delay.size(5.3);
+        sample_delay.size(5.3);
+        block_delay.change_interpolation(t);
+        sample_delay.change_interpolation(t);
+
+        sample_vector output(input.size());
+        block_delay(input.data(), output.data(), input.size());
+
+        sample_vector reference;
+        for (auto& s : input)
+            reference.push_back( sample_delay(s) );
+
+        REQUIRE_VECTOR_APPROX( output, reference );
+    }
+}
+
+
+TEST_CASE ("Delay times are clamped to the capacity") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    delay my_delay { std::make_pair(100, 10.0) };
+    REQUIRE( my_delay.capacity() == 100 );
+
+    my_delay.size(250.5);
+    REQUIRE( my_delay.size() == 100 );
+    REQUIRE( my_delay.integral_size() == 100 );
+
+    my_delay.size(-3.0);
+    REQUIRE( my_delay.size() == 0 );
+
+    my_delay.size(42);
+    REQUIRE( my_delay.size() == 42 );
+    REQUIRE( my_delay.integral_size() == 42 );
+    REQUIRE( my_delay.fractional_size() == 0 );
+}
+
+
+TEST_CASE ("Changing the delay time with a crossfade") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    delay my_delay { std::make_pair(64, 4.0) };
+    my_delay.change_interpolation(interpolator::type::none);
+
+    // a ramp makes the delay time visible in the output
+    number ramp {};
+    for (auto i = 0; i < 32; ++i)
+        my_delay(++ramp);
+
+    INFO ("Changing from 4 to 12 samples over 8 samples");
+    my_delay.size(12.0, 8);
+    REQUIRE( my_delay.size() == 12 );
+
+    sample_vector output;
+    for (auto i = 0; i < 12; ++i)
+        output.push_back( my_delay(++ramp) );
+
+    INFO ("The output moves from the old to the new delay time in equal steps, and then stays there");
+    for (auto i = 0; i < 8; ++i) {
+        auto fade = (7.0 - i) / 8.0;
+        auto now  = 33.0 + i;
+        REQUIRE( output[i] == Approx((now - 4.0) * fade + (now - 12.0) * (1.0 - fade)) );
+    }
+    for (auto i = 8; i < 12; ++i)
+        REQUIRE( output[i] == Approx(33.0 + i - 12.0) );
+
+    INFO ("Setting the delay time without a crossfade jumps right away");
+    my_delay.size(4.0, 8);
+    my_delay.size(20.0);
+    auto y = my_delay(++ramp);
+    REQUIRE( y == Approx(ramp - 20.0) );
+}
@@ -6,6 +6,7 @@
 
 #define CATCH_CONFIG_MAIN
 #include "c74_min_catch.h"
+#include <complex>
 
 
 SCENARIO ("Generate a Ramp") {
@@ -3326,3 +3327,76 @@ SCENARIO ("Generate a Unipolar Triangle with 0.25 cycles") {
         }
     }
 }
+
+
+namespace {
+
+    // The ratio of the energy of the aliases to the energy of the harmonics in a signal with 5 cycles in 512 samples.
+    // The harmonics fall on the bins that are multiples of 5, and the aliases on the other bins.
+
+    double aliasing(const c74::min::sample_vector& v) {
+        const auto size = static_cast<int>(v.size());
+        double     aliases {};
+        double     harmonics {};
+
+        for (auto k = 1; k < size / 2; ++k) {
+            std::complex<double> bin {};
+            for (auto n = 0; n < size; ++n)
+                bin += v[n] * std::polar(1.0, -2.0 * M_PI * k * n / size);
+            (k % 5 ? aliases : harmonics) += std::norm(bin);
+        }
+        return aliases / harmonics;
+    }
+
+}
+
+
+SCENARIO ("Generate band-limited waveforms at audio rate") {
+    using namespace c74::min;
+    using namespace c74::min::lib::generator;
+
+    GIVEN ("Band-limited and naive generators at a frequency with 5 cycles in 512 samples") {
+        sample_vector naive(512);
+        sample_vector bandlimited(512);
+
+        WHEN ("generating a sawtooth") {
+            std::generate(naive.begin(), naive.end(), sawtooth<>(naive.size(), 5.0));
+            sawtooth_polyblep<> g;
+            g.frequency(5.0, 512.0);
+            g(bandlimited.data(), bandlimited.size());
+
+            THEN("PolyBLEP reduces the aliasing by more than 20 times")
+            REQUIRE( aliasing(bandlimited) < aliasing(naive) / 20.0 );
+        }
+        AND_WHEN ("generating a square") {
+            for (auto i = 0; i < naive.size(); ++i)
+                naive[i] = fmod(i * 5.0 / naive.size(), 1.0) < 0.5 ? 1.0 : -1.0;
+            square_polyblep<> g;
+            g.frequency(5.0, 512.0);
+            g(bandlimited.data(), bandlimited.size());
+
+            THEN("PolyBLEP reduces the aliasing by more than 20 times")
+            REQUIRE( aliasing(bandlimited) < aliasing(naive) / 20.0 );
+        }
+        AND_WHEN ("generating a triangle") {
+            std::generate(naive.begin(), naive.end(), triangle<>(naive.size(), 5.0));
+            triangle_polyblamp<> g;
+            g.frequency(5.0, 512.0);
+            g(bandlimited.data(), bandlimited.size());
+
+            THEN("PolyBLAMP reduces the aliasing, which is much lower for a triangle to begin with")
+            REQUIRE( aliasing(bandlimited) < aliasing(naive) / 1.5 );
+        }
+    }
+
+    GIVEN ("A band-limited generator used with std::generate to fill a wavetable") {
+        sample_vector v(64);
+        std::generate(v.begin(), v.end(), sawtooth_polyblep<>(v.size()));
+
+        THEN("Only the sample at the discontinuity differs from the naive sawtooth: it is halfway") {
+            REQUIRE( v[0] == Approx(0.0) );
+            for (auto i = 1; i < 64; ++i)
+                REQUIRE( v[i] == Approx(2.0 * i / 64.0 - 1.0) );
+        }
+    }
+}
@@ -768,3 +768,28 @@ TEST_CASE("Produce correct values when changing between types using interpolator
 
 }
 
+
+
+TEST_CASE("Block output of interpolator::proxy matches the output per sample") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+    using namespace c74::min::lib::interpolator;
+
+    sample_vector   input   { -1.0, 2.0, 1.0, 4.0, 0.5, -3.0, 2.5, 1.0, 0.0 };
+    auto            delta   = 0.37;
+    auto            count   = input.size() - 3;
+
+    for (auto t : { type::none, type::nearest, type::linear, type::cosine, type::cubic, type::spline, type::hermite }) {
+        interpolator::proxy<> block_proxy { t };
+        interpolator::proxy<> sample_proxy { t };
+
+        sample_vector output(count);
+        block_proxy(input.data(), delta, output.data(), count);
+
+        sample_vector reference;
+        for (auto i = 0u; i < count; ++i)
+            reference.push_back( sample_proxy(input[i], input[i + 1], input[i + 2], input[i + 3], delta) );
+
+        REQUIRE_VECTOR_APPROX( output, reference );
+    }
+}
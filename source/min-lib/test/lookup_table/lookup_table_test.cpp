@@ -0,0 +1,55 @@
+/// @file
+///	@brief 		Unit test for the lookup_table class
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+TEST_CASE ("lookup_table interpolates between its points") {
+    using namespace c74::min::lib;
+
+    lookup_table<4> table { [](double x) { return 4.0 * x; } };
+
+    REQUIRE( table[0] == 0.0 );
+    REQUIRE( table[4] == 4.0 );
+    REQUIRE( table(0.0) == 0.0 );
+    REQUIRE( table(0.125) == Approx(0.5) );
+    REQUIRE( table(0.6) == Approx(2.4) );
+
+    INFO ("The end of the range is interpolated using the guard point, and inputs beyond the range are clamped");
+    REQUIRE( table(1.0) == 4.0 );
+    REQUIRE( table(1.5) == 4.0 );
+    REQUIRE( table(-0.5) == 0.0 );
+}
+
+
+TEST_CASE ("lookup_table of a constexpr function is generated at compile time") {
+    using namespace c74::min::lib;
+
+    static constexpr lookup_table<16> table { [](double x) { return x * x; } };
+    static_assert(table[16] == 1.0, "the table is a constant expression");
+
+    REQUIRE( table[8] == 0.25 );
+    REQUIRE( table(0.3) == Approx(0.09).margin(2.0 / (16 * 16 * 8)) );
+}
+
+
+TEST_CASE ("lookup_table of a sine is accurate within the bound of linear interpolation") {
+    using namespace c74::min::lib;
+
+    const lookup_table<> table { [](double x) { return std::sin(x * M_PI_2); } };
+
+    std::vector<double> input(1000);
+    std::vector<double> output(input.size());
+    for (auto i = 0u; i < input.size(); ++i)
+        input[i] = i / 999.0;
+    table(input.data(), output.data(), input.size());
+
+    for (auto i = 0u; i < input.size(); ++i) {
+        REQUIRE( output[i] == Approx(table(input[i])) );
+        REQUIRE( output[i] == Approx(std::sin(input[i] * M_PI_2)).margin(2e-8) );
+    }
+}
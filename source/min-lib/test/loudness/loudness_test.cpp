@@ -0,0 +1,92 @@
+/// @file
+///	@brief 		Unit test for the loudness meter
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+SCENARIO ("the K-weighting filters match the coefficients of ITU-R BS.1770 at 48 kHz") {
+
+    GIVEN ("The coefficients computed for 48 kHz") {
+        const auto shelf    = c74::min::lib::biquad_coefficients::k_weighting_shelf(48000.0);
+        const auto highpass = c74::min::lib::biquad_coefficients::k_weighting_highpass(48000.0);
+
+        THEN ("they are the ones tabulated in the recommendation") {
+            REQUIRE( shelf.b0 == Approx(1.53512485958697) );
+            REQUIRE( shelf.b1 == Approx(-2.69169618940638) );
+            REQUIRE( shelf.b2 == Approx(1.19839281085285) );
+            REQUIRE( shelf.a1 == Approx(-1.69065929318241) );
+            REQUIRE( shelf.a2 == Approx(0.73248077421585) );
+            REQUIRE( highpass.a1 == Approx(-1.99004745483398) );
+            REQUIRE( highpass.a2 == Approx(0.99007225036621) );
+        }
+    }
+}
+
+
+SCENARIO ("a stereo sine of 1 kHz at -20 dBFS measures -20 LUFS") {
+
+    GIVEN ("A stereo meter at 48 kHz") {
+        c74::min::lib::loudness_meter meter { 2, 48000.0, 480 };
+
+        REQUIRE( meter.momentary() == -std::numeric_limits<double>::infinity() );
+
+        WHEN ("processing 5 seconds of the sine in blocks of 480 samples") {
+            // a full-scale sine in one channel reads -3.01 LUFS, so -20 dBFS in each of two channels reads -20 LUFS
+            const auto                amplitude = std::pow(10.0, -20.0 / 20.0);
+            c74::min::sample_vector   block(480);
+            const c74::min::sample*   channels[] = { block.data(), block.data() };
+
+            for (auto n = 0; n < 500; ++n) {
+                for (auto i = 0; i < 480; ++i)
+                    block[i] = amplitude * std::sin(2.0 * M_PI * 1000.0 * (n * 480 + i) / 48000.0);
+                meter.process(channels, 480);
+            }
+
+            THEN ("momentary, short-term and integrated loudness are -20 LUFS") {
+                REQUIRE( meter.momentary() == Approx(-20.0).margin(0.05) );
+                REQUIRE( meter.short_term() == Approx(-20.0).margin(0.05) );
+                REQUIRE( meter.integrated() == Approx(-20.0).margin(0.1) );
+            }
+            AND_THEN ("the true-peak is the amplitude of the sine") {
+                REQUIRE( meter.true_peak_db() == Approx(-20.0).margin(0.1) );
+            }
+            AND_WHEN ("the meter is cleared") {
+                meter.clear();
+                THEN ("nothing has been measured")
+                REQUIRE( meter.integrated() == -std::numeric_limits<double>::infinity() );
+            }
+        }
+    }
+}
+
+
+SCENARIO ("quiet passages are gated out of the integrated loudness") {
+
+    GIVEN ("A mono meter") {
+        c74::min::lib::loudness_meter meter { 1, 48000.0, 480 };
+        c74::min::sample_vector       block(480);
+        const c74::min::sample*       channels[] = { block.data() };
+
+        auto play = [&](double amplitude, int blocks) {
+            for (auto n = 0; n < blocks; ++n) {
+                for (auto i = 0; i < 480; ++i)
+                    block[i] = amplitude * std::sin(2.0 * M_PI * 1000.0 * i / 48.0 / 1000.0);
+                meter.process(channels, 480);
+            }
+        };
+
+        WHEN ("10 seconds at -23 dBFS are followed by 10 seconds at -50 dBFS and 10 seconds of silence") {
+            play(std::pow(10.0, -23.0 / 20.0), 1000);
+            play(std::pow(10.0, -50.0 / 20.0), 1000);
+            play(0.0, 1000);
+
+            THEN ("the integrated loudness is the one of the loud part") {
+                REQUIRE( meter.integrated() == Approx(-26.01).margin(0.1) );
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/// @file
+///	@brief 		Unit test for the statistics in the math namespace
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+TEST_CASE ("mean and standard deviation of a vector") {
+    using namespace c74::min::lib;
+
+    std::vector<double> v { 2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0 };
+    auto stats = math::mean(v);
+
+    REQUIRE( stats.first == Approx(5.0) );
+    REQUIRE( stats.second == Approx(2.0) );
+
+    INFO ("Any range of items that convert to double may be used");
+    std::vector<int> integers { 2, 4, 4, 4, 5, 5, 7, 9 };
+    REQUIRE( math::mean(integers) == stats );
+    REQUIRE( math::mean(v.data(), v.data() + v.size()) == stats );
+}
+
+
+TEST_CASE ("running_statistics does not lose precision on a large offset") {
+    using namespace c74::min::lib;
+
+    math::running_statistics stats;
+    REQUIRE( stats.count() == 0 );
+    REQUIRE( stats.variance() == 0.0 );
+
+    // subtracting the squared mean from the mean of the squares would leave nothing of the variance here
+    for (auto x : { 4.0, 7.0, 13.0, 16.0 })
+        stats.add(1e9 + x);
+
+    REQUIRE( stats.count() == 4 );
+    REQUIRE( stats.mean() == Approx(1e9 + 10.0) );
+    REQUIRE( stats.variance() == Approx(22.5) );
+
+    stats.clear();
+    stats.add(3.0);
+    REQUIRE( stats.mean() == 3.0 );
+    REQUIRE( stats.standard_deviation() == 0.0 );
+}
+
+
+TEST_CASE ("running_statistics keeps the minimum and maximum") {
+    using namespace c74::min::lib;
+
+    math::running_statistics stats;
+    REQUIRE( stats.minimum() == 0.0 );
+    REQUIRE( stats.maximum() == 0.0 );
+
+    for (auto x : { 3.0, -2.0, 8.0, 5.0 })
+        stats.add(x);
+    REQUIRE( stats.minimum() == -2.0 );
+    REQUIRE( stats.maximum() == 8.0 );
+
+    INFO ("After clearing, the first number is both the minimum and the maximum");
+    stats.clear();
+    stats.add(10.0);
+    REQUIRE( stats.minimum() == 10.0 );
+    REQUIRE( stats.maximum() == 10.0 );
+}
+
+
+TEST_CASE ("moving_statistics matches the statistics of the most recent numbers") {
+    using namespace c74::min::lib;
+
+    math::moving_statistics moving { 5 };
+    std::vector<double>     all;
+    math::random_generator  generator { 77 };
+
+    for (auto i = 0; i < 1000; ++i) {
+        auto x = 1e6 + generator.uniform(-10.0, 10.0);
+        moving.add(x);
+        all.push_back(x);
+
+        auto first    = all.size() > 5 ? all.end() - 5 : all.begin();
+        auto expected = math::mean(first, all.end());
+
+        INFO( "after " << all.size() << " numbers" );
+        REQUIRE( moving.count() == std::min<size_t>(all.size(), 5) );
+        REQUIRE( moving.mean() == Approx(expected.first) );
+        REQUIRE( moving.standard_deviation() == Approx(expected.second).margin(1e-6) );
+    }
+
+    INFO ("After clearing, the window fills up again");
+    moving.clear();
+    moving.add(2.0);
+    moving.add(4.0);
+    REQUIRE( moving.count() == 2 );
+    REQUIRE( moving.mean() == Approx(3.0) );
+    REQUIRE( moving.variance() == Approx(1.0) );
+}
+
+
+TEST_CASE ("fast_sin is accurate over the range of -pi to pi") {
+    using namespace c74::min::lib;
+
+    for (auto i = -1000; i <= 1000; ++i) {
+        auto x = M_PI * i / 1000.0;
+        INFO( "when x == " << x );
+        REQUIRE( math::fast_sin(x) == Approx(std::sin(x)).margin(2e-9) );
+    }
+}
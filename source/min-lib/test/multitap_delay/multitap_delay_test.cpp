@@ -0,0 +1,84 @@
+/// @file
+///	@brief 		Unit test for the multitap_delay class
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+TEST_CASE ("Each tap produces the output of a separate delay of the same size") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    INFO ("Using a multitap_delay with 3 taps and 3 separate delays with the same sizes");
+    multitap_delay          taps(3, 64);
+    std::vector<number>     sizes { 0.0, 7.0, 21.6 };
+    std::vector<delay>      delays;
+
+    for (auto tap = 0; tap < 3; ++tap) {
+        taps.size(tap, sizes[tap]);
+        delays.emplace_back(64.0);
+        delays.back().size(sizes[tap]);
+    }
+    REQUIRE( taps.tap_count() == 3 );
+    REQUIRE( taps.size(2) == Approx(21.6) );
+
+    sample_vector   input(100);
+    for (auto& s : input)
+        s = math::random(-1.0, 1.0);
+
+    INFO ("Processing one sample at a time...");
+    for (auto& s : input) {
+        sample outputs[3];
+        taps(s, outputs);
+        for (auto tap = 0; tap < 3; ++tap)
+            REQUIRE( outputs[tap] == Approx(delays[tap](s)) );
+    }
+
+    INFO ("Processing a block...");
+    sample_vector   block_outputs[3] { sample_vector(100), sample_vector(100), sample_vector(100) };
+    sample*         output_pointers[3] { block_outputs[0].data(), block_outputs[1].data(), block_outputs[2].data() };
+
+    taps(input.data(), output_pointers, input.size());
+    for (auto i = 0u; i < input.size(); ++i) {
+        for (auto tap = 0; tap < 3; ++tap)
+            REQUIRE( block_outputs[tap][i] == Approx(delays[tap](input[i])) );
+    }
+}
+
+
+TEST_CASE ("Modulated delay times are applied per sample") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    multitap_delay  taps(2, 32);
+    delay           reference(32.0);
+    taps.change_interpolation(interpolator::type::linear);
+    reference.change_interpolation(interpolator::type::linear);
+
+    const auto      frame_count = 64;
+    sample_vector   input(frame_count);
+    sample_vector   modulation(frame_count);
+    sample_vector   constant(frame_count, 3.0);
+    sample_vector   outputs[2] { sample_vector(frame_count), sample_vector(frame_count) };
+
+    for (auto i = 0; i < frame_count; ++i) {
+        input[i]      = math::random(-1.0, 1.0);
+        modulation[i] = 10.0 + 5.0 * sin(i * 0.1);
+    }
+
+    const sample*   size_pointers[2] { modulation.data(), constant.data() };
+    sample*         output_pointers[2] { outputs[0].data(), outputs[1].data() };
+    taps(input.data(), size_pointers, output_pointers, frame_count);
+
+    for (auto i = 0; i < frame_count; ++i) {
+        reference.size(modulation[i]);
+        REQUIRE( outputs[0][i] == Approx(reference(input[i])) );
+    }
+
+    INFO ("The last delay time of the block remains set");
+    REQUIRE( taps.size(0) == Approx(modulation[frame_count - 1]) );
+    REQUIRE( taps.size(1) == Approx(3.0) );
+}
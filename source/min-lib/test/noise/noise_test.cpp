@@ -0,0 +1,79 @@
+/// @file
+///	@brief 		Unit test for the noise class and the random_generator it is built on
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+TEST_CASE ("random_generator produces the reference sequence of xoshiro256+") {
+    using namespace c74::min::lib;
+
+    INFO ("With the state expanded from a seed of 0 by splitmix64, the first outputs are known");
+    math::random_generator g { 0 };
+
+    // the splitmix64 outputs for the seed 0 form the state, and the first output is the sum of the first and the last of them
+    REQUIRE( g() == 0xe220a8397b1dcdafull + 0xf88bb8a8724c81ecull );
+}
+
+
+TEST_CASE ("random_generator is reproducible and stays in range") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    math::random_generator a { 1234 };
+    math::random_generator b { 1234 };
+    math::random_generator c { 4321 };
+
+    sample_vector va(1000), vb(1000), vc(1000);
+    a.fill_uniform(va.data(), va.size(), -2.0, 3.0);
+    b.fill_uniform(vb.data(), vb.size(), -2.0, 3.0);
+    c.fill_uniform(vc.data(), vc.size(), -2.0, 3.0);
+
+    REQUIRE( va == vb );
+    REQUIRE( va != vc );
+    for (auto x : va) {
+        REQUIRE( x >= -2.0 );
+        REQUIRE( x < 3.0 );
+    }
+
+    INFO ("Restarting from the seed repeats the sequence");
+    a.seed(1234);
+    REQUIRE( a.uniform(-2.0, 3.0) == va[0] );
+}
+
+
+TEST_CASE ("Noise has the expected statistics") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    const auto      frame_count = 100000;
+    sample_vector   output(frame_count);
+
+    noise n { 42 };
+    n(output.data(), output.size());
+
+    auto stats = math::mean(output);
+    REQUIRE( stats.first == Approx(0.0).margin(0.01) );
+    REQUIRE( stats.second == Approx(1.0 / std::sqrt(3.0)).margin(0.01) );    // of the uniform distribution on [-1, 1]
+
+    n.mode(noise::distribution::gaussian);
+    n(output.data(), output.size());
+
+    stats = math::mean(output);
+    REQUIRE( stats.first == Approx(0.0).margin(0.01) );
+    REQUIRE( stats.second == Approx(1.0 / 3.0).margin(0.01) );
+
+    INFO ("The block output matches the output one sample at a time");
+    noise block { 7 };
+    noise single { 7 };
+    block.mode(noise::distribution::gaussian);
+    single.mode(noise::distribution::gaussian);
+
+    sample_vector block_output(9);
+    block(block_output.data(), block_output.size());
+    for (auto x : block_output)
+        REQUIRE( x == Approx(single()) );
+}
@@ -255,3 +255,58 @@ TEST_CASE ("Parameters are set properly with different constructors") {
     REQUIRE( o5.coefficient() == Approx(1.0) );	// check the initialized value
 
 }
+
+
+TEST_CASE ("The block and multichannel versions produce the same output as the per-sample filter") {
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    const auto            frame_count   = 200;
+    const auto            channel_count = 3;
+    vector<sample_vector> inputs(channel_count, sample_vector(frame_count));
+
+    for (auto channel = 0; channel < channel_count; ++channel) {
+        for (auto i = 0; i < frame_count; ++i)
+            inputs[channel][i] = sin(0.1 * (channel + 1) * i) + 0.25;
+    }
+
+    INFO ("Filtering a block is the same as filtering one sample at a time");
+    onepole single { 0.3 };
+    onepole block { 0.3 };
+    sample_vector output(frame_count);
+
+    block(inputs[0].data(), output.data(), frame_count);
+    for (auto i = 0; i < frame_count; ++i)
+        REQUIRE( output[i] == single(inputs[0][i]) );
+
+    INFO ("Each channel of a bank is the same as a separate filter, with planar and interleaved buffers");
+    vector<onepole>       filters(channel_count);
+    onepole_bank          bank { channel_count };
+    onepole_bank          interleaved_bank { channel_count };
+
+    for (auto channel = 0; channel < channel_count; ++channel) {
+        filters[channel].frequency(1000.0 * (channel + 1), 44100.0);
+        bank.frequency(channel, 1000.0 * (channel + 1), 44100.0);
+        interleaved_bank.frequency(channel, 1000.0 * (channel + 1), 44100.0);
+    }
+
+    vector<sample_vector> outputs(channel_count, sample_vector(frame_count));
+    const sample*         input_buffers[] { inputs[0].data(), inputs[1].data(), inputs[2].data() };
+    sample*               output_buffers[] { outputs[0].data(), outputs[1].data(), outputs[2].data() };
+    bank(input_buffers, output_buffers, frame_count);
+
+    sample_vector interleaved(frame_count * channel_count);
+    for (auto i = 0; i < frame_count; ++i) {
+        for (auto channel = 0; channel < channel_count; ++channel)
+            interleaved[i * channel_count + channel] = inputs[channel][i];
+    }
+    interleaved_bank.process_interleaved(interleaved.data(), interleaved.data(), frame_count);
+
+    for (auto channel = 0; channel < channel_count; ++channel) {
+        for (auto i = 0; i < frame_count; ++i) {
+            auto expected = filters[channel](inputs[channel][i]);
+            REQUIRE( outputs[channel][i] == expected );
+            REQUIRE( interleaved[i * channel_count + channel] == expected );
+        }
+    }
+}
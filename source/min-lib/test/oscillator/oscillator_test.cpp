@@ -1282,3 +1282,73 @@ TEST_CASE ("Interpolate values between samples in cosine waveform") {
 
 
 }
+
+
+TEST_CASE ("Oscillators may share one wavetable") {
+
+    using namespace c74::min;
+    using namespace c74::min::lib;
+    INFO ("Two oscillators reading one wavetable produce the same output as two with their own");
+
+    auto wavetable = make_wavetable<generator::triangle<>>(64);
+
+    oscillator<> shared_a { wavetable };
+    oscillator<> shared_b { wavetable };
+    oscillator<> own { 64 };
+    own.change_waveform<generator::triangle<>>();
+
+    REQUIRE( shared_a.size() == 64 );
+    REQUIRE( shared_a.wavetable() == shared_b.wavetable() );
+
+    shared_a.frequency(1.0, 100.0);
+    shared_b.frequency(1.0, 100.0);
+    own.frequency(1.0, 100.0);
+    shared_b.phase(0.25);
+
+    for (auto i = 0; i < 200; ++i) {
+        auto expected = own();
+        REQUIRE( shared_a() == expected );
+        shared_b();
+    }
+
+    INFO ("Changing the waveform of one of them leaves the shared wavetable alone");
+    shared_b.change_waveform<generator::sawtooth<>>();
+    REQUIRE( shared_a.wavetable() == wavetable );
+    REQUIRE( shared_b.wavetable() != wavetable );
+}
+
+
+TEST_CASE ("An oscillator_bank produces the same output as separate oscillators") {
+
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    const auto              frame_count = 1000;
+    const number            frequencies[] { 110.0, 441.0, 7000.0 };
+    oscillator_bank<>       bank { 3, 512 };
+    vector<oscillator<>>    oscillators(3, oscillator<>(512));
+
+    for (auto voice = 0; voice < 3; ++voice) {
+        bank.frequency(voice, frequencies[voice], 44100.0);
+        oscillators[voice].frequency(frequencies[voice], 44100.0);
+    }
+    bank.phase(2, 0.5);
+    oscillators[2].phase(0.5);
+
+    vector<sample_vector> outputs(3, sample_vector(frame_count));
+    sample*               buffers[] { outputs[0].data(), outputs[1].data(), outputs[2].data() };
+
+    // in two blocks, to carry the phase from one block to the next
+    bank.process(buffers, 300);
+    for (auto& buffer : buffers)
+        buffer += 300;
+    bank.process(buffers, frame_count - 300);
+
+    for (auto voice = 0; voice < 3; ++voice) {
+        for (auto i = 0; i < frame_count; ++i) {
+            INFO( "voice " << voice << " at i == " << i );
+            REQUIRE( outputs[voice][i] == Approx(oscillators[voice]()).margin(1e-9) );
+        }
+        REQUIRE( bank.frequency(voice) == frequencies[voice] );
+    }
+}
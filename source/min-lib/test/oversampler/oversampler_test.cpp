@@ -0,0 +1,85 @@
+/// @file
+///	@brief 		Unit test for the oversampler class
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+SCENARIO ("the oversampling factor is one of 1, 2, 4 and 8") {
+
+    GIVEN ("An instance of the oversampler class") {
+        c74::min::lib::oversampler o;
+
+        REQUIRE( o.factor() == 2 );
+
+        WHEN ("a factor that is not a power of two is set") {
+            o.factor(6);
+            THEN("it is rounded down")
+            REQUIRE( o.factor() == 4 );
+        }
+        AND_WHEN ("a factor above 8 is set") {
+            o.factor(32);
+            THEN("it is clamped")
+            REQUIRE( o.factor() == 8 );
+        }
+        AND_WHEN ("a factor of 1 is set") {
+            o.factor(1);
+            THEN("there is no latency")
+            REQUIRE( o.latency() == 0.0 );
+        }
+    }
+}
+
+
+SCENARIO ("a signal below the original nyquist frequency passes unchanged apart from the latency") {
+
+    for (auto factor : {1, 2, 4, 8}) {
+        GIVEN ("An oversampler with a factor of " + std::to_string(factor)) {
+            c74::min::lib::oversampler o { factor, 64 };
+
+            WHEN ("processing a sine with a kernel that does nothing, in blocks larger than the maximum frame count") {
+                const int               buffersize = 1000;
+                const auto              frequency  = 0.05;
+                c74::min::sample_vector input(buffersize);
+                c74::min::sample_vector output(buffersize);
+
+                for (auto i = 0; i < buffersize; ++i)
+                    input[i] = sin(2.0 * M_PI * frequency * i);
+
+                o(input.data(), output.data(), buffersize, [](c74::min::sample x) {
+                    return x;
+                });
+
+                THEN("the output is the delayed sine once the filters are filled") {
+                    auto latency = o.latency();
+                    for (auto i = 100; i < buffersize; ++i)
+                        REQUIRE( output[i] == Approx(sin(2.0 * M_PI * frequency * (i - latency))).margin(0.001) );
+                }
+            }
+        }
+    }
+}
+
+
+SCENARIO ("a block kernel runs at the oversampled rate") {
+
+    GIVEN ("An oversampler with a factor of 4") {
+        c74::min::lib::oversampler o { 4, 16 };
+
+        WHEN ("processing a block of 40 samples") {
+            c74::min::sample_vector input(40, 0.0);
+            c74::min::sample_vector output(40);
+            int                     total_frame_count {};
+
+            o(input.data(), output.data(), 40, [&total_frame_count](c74::min::sample*, int frame_count) {
+                total_frame_count += frame_count;
+            });
+
+            THEN("the kernel is called for four times as many samples")
+            REQUIRE( total_frame_count == 160 );
+        }
+    }
+}
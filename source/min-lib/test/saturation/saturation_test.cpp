@@ -0,0 +1,63 @@
+/// @file
+///	@brief 		Unit test for the saturation class
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+TEST_CASE ("Saturation follows the scaled sine of the input") {
+    using namespace c74::min;
+
+    for (auto drive : { 10.0, 50.0, 75.0, 99.0 }) {
+        lib::saturation s;
+        s.drive(drive);
+
+        auto f     = drive / 100.0;
+        auto scale = f > 0.5 ? sin(M_PI * f) : 1.0;
+
+        for (auto x = -2.0; x <= 2.0; x += 0.01) {
+            auto clipped  = std::min(std::max(x, -1.0), 1.0);
+            auto expected = sin(M_PI * f * clipped) / sin(M_PI * f) * scale;
+
+            INFO( "drive " << drive << " and x == " << x );
+            REQUIRE( s(x) == Approx(expected).margin(1e-6) );
+        }
+    }
+}
+
+
+TEST_CASE ("The block operator of saturation") {
+    using namespace c74::min;
+
+    const auto    frame_count = 1000;
+    sample_vector input(frame_count);
+    sample_vector output(frame_count);
+
+    for (auto i = 0; i < frame_count; ++i)
+        input[i] = 1.5 * sin(2.0 * M_PI * 0.01 * i);
+
+    INFO ("Without oversampling, a block is the same as one sample at a time");
+    lib::saturation s;
+    s.drive(80.0);
+    s(input.data(), output.data(), frame_count);
+
+    for (auto i = 0; i < frame_count; ++i)
+        REQUIRE( output[i] == s(input[i]) );
+
+    INFO ("With oversampling and almost no drive, the output is the input delayed by the latency");
+    lib::saturation clean;
+    clean.drive(0.0);
+    clean.oversampling(4);
+    REQUIRE( clean.oversampling() == 4 );
+
+    for (auto& x : input)
+        x /= 1.5;
+    clean(input.data(), output.data(), frame_count);
+
+    auto latency = clean.latency();
+    for (auto i = 100; i < frame_count; ++i)
+        REQUIRE( output[i] == Approx(sin(2.0 * M_PI * 0.01 * (i - latency))).margin(0.001) );
+}
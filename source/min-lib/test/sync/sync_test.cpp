@@ -103,3 +103,41 @@ TEST_CASE ("Confirm sample operator changes the phase") {
 
 }
 
+
+
+TEST_CASE ("Block output matches the sample operator") {
+
+    using namespace c74::min;
+    using namespace c74::min::lib;
+
+    c74::min::lib::sync	by_sample;
+    c74::min::lib::sync	by_block;
+
+    by_sample.frequency(1000.0, 44100.0);
+    by_block.frequency(1000.0, 44100.0);
+    by_sample.phase(0.9);
+    by_block.phase(0.9);
+
+    sample_vector expected(300);
+    sample_vector output(300);
+
+    for (auto& y : expected)
+        y = by_sample();
+    by_block(output.data(), 100);
+    by_block(output.data() + 100, 200);
+
+    for (auto i = 0; i < 300; ++i)
+        REQUIRE( output[i] == Approx(expected[i]).margin(1e-12) );
+    REQUIRE( by_block.phase() == Approx(by_sample.phase()) );
+
+    INFO ("A constant frequency for each sample produces the same ramp");
+    sample_vector frequencies(300, 1000.0);
+    c74::min::lib::sync	by_signal;
+
+    by_signal.frequency(0.0, 44100.0);
+    by_signal.phase(0.9);
+    by_signal(frequencies.data(), frequencies.data(), 300);
+
+    for (auto i = 0; i < 300; ++i)
+        REQUIRE( frequencies[i] == Approx(expected[i]).margin(1e-12) );
+}
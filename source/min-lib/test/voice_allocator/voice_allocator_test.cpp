@@ -0,0 +1,151 @@
+/// @file
+///	@brief 		Unit test for the voice_allocator and voice_bank_operator classes
+///	@ingroup 	minlib
+///	@copyright	Copyright 2018 The Min-Lib Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#define CATCH_CONFIG_MAIN
+#include "c74_min_catch.h"
+
+
+namespace {
+
+    // an instrument whose voices output 1.0, and finish a number of samples after their note stops
+
+    class poly : public c74::min::lib::voice_bank_operator {
+    public:
+        poly()
+        : voice_bank_operator { 4 } {}
+
+        void operator()(c74::min::audio_bundle input, c74::min::audio_bundle output) {
+            process_voices(output,
+                [this](int voice, int, int velocity) {
+                    remaining[voice] = velocity > 0 ? 1000000 : 100;
+                },
+                [this](int voice, c74::min::sample* out, long frame_count) {
+                    std::fill_n(out, frame_count, 1.0);
+                    remaining[voice] -= frame_count;
+                    return remaining[voice] > 0;
+                });
+        }
+
+        long remaining[4] {};
+    };
+
+}
+
+
+SCENARIO ("notes are assigned voices") {
+    using namespace c74::min;
+    using policy = lib::voice_allocator::steal_policy;
+
+    GIVEN ("an allocator with three voices") {
+        lib::voice_allocator voices { 3 };
+
+        REQUIRE( voices.voice_count() == 3 );
+        REQUIRE( voices.active_count() == 0 );
+
+        WHEN ("three notes are started") {
+            const auto a { voices.note_on(60, 100) };
+            const auto b { voices.note_on(64, 90) };
+            const auto c { voices.note_on(67, 80) };
+
+            THEN ("each has a voice of its own") {
+                REQUIRE( a == 0 );
+                REQUIRE( b == 1 );
+                REQUIRE( c == 2 );
+                REQUIRE( voices.pitch(b) == 64 );
+                REQUIRE( voices.velocity(b) == 90 );
+                REQUIRE( voices.active_voices() == vector<int> { 0, 1, 2 } );
+            }
+            AND_THEN ("a pitch that is already playing keeps its voice") {
+                REQUIRE( voices.note_on(64, 50) == 1 );
+                REQUIRE( voices.velocity(1) == 50 );
+                REQUIRE( voices.active_voices() == vector<int> { 0, 2, 1 } );
+            }
+            AND_THEN ("a fourth note steals the oldest") {
+                REQUIRE( voices.note_on(72, 100) == 0 );
+                REQUIRE( voices.pitch(0) == 72 );
+                REQUIRE( voices.active_count() == 3 );
+            }
+            AND_THEN ("or the lowest or the highest") {
+                voices.policy(policy::lowest);
+                REQUIRE( voices.note_on(72, 100) == 0 );
+                voices.policy(policy::highest);
+                REQUIRE( voices.note_on(48, 100) == 0 );
+                REQUIRE( voices.pitch(0) == 48 );
+            }
+            AND_THEN ("or is dropped") {
+                voices.policy(policy::none);
+                REQUIRE( voices.note_on(72, 100) == lib::voice_allocator::k_no_voice );
+            }
+            AND_THEN ("a released voice is taken before a held one is stolen") {
+                REQUIRE( voices.note_on(64, 0) == 1 );
+                REQUIRE( voices.state(1) == lib::voice_allocator::voice_state::released );
+                REQUIRE( voices.active(1) );
+                REQUIRE( voices.note_on(72, 100) == 1 );
+            }
+            AND_THEN ("a finished voice is free again") {
+                voices.note_off(64);
+                voices.finished(1);
+                REQUIRE( !voices.active(1) );
+                REQUIRE( voices.active_voices() == vector<int> { 0, 2 } );
+                voices.policy(policy::none);
+                REQUIRE( voices.note_on(72, 100) == 1 );
+            }
+            AND_THEN ("stopping a note that is not playing does nothing") {
+                REQUIRE( voices.note_off(61) == lib::voice_allocator::k_no_voice );
+            }
+            AND_THEN ("all voices can be released and reset") {
+                voices.release_all();
+                REQUIRE( voices.state(2) == lib::voice_allocator::voice_state::released );
+                voices.reset();
+                REQUIRE( voices.active_count() == 0 );
+                REQUIRE( voices.note_on(72, 100) == 0 );
+            }
+        }
+    }
+}
+
+
+SCENARIO ("a voice bank only renders the sounding voices") {
+    using namespace c74::min;
+
+    GIVEN ("a bank of four voices") {
+        poly                my_object;
+        sample_vector       storage(4 * 64, 0.5);
+        double*             channels[4] { &storage[0], &storage[64], &storage[128], &storage[192] };
+        audio_bundle        input { nullptr, 0, 64 };
+        audio_bundle        output { channels, 4, 64 };
+
+        REQUIRE( my_object.voice_count() == 4 );
+
+        WHEN ("a note is played") {
+            my_object.note(60, 100);
+            my_object(input, output);
+
+            THEN ("only its voice is rendered, and the channels of the others are disabled") {
+                REQUIRE( storage[0] == 1.0 );
+                REQUIRE( storage[63] == 1.0 );
+                REQUIRE( storage[64] == 0.5 );
+                REQUIRE( my_object.enabled_channels().enabled(0) );
+                REQUIRE( !my_object.enabled_channels().enabled(1) );
+                REQUIRE( !my_object.enabled_channels().enabled(3) );
+            }
+            AND_THEN ("its voice is freed when it finishes after the note stops") {
+                my_object.note(60, 0);
+                my_object(input, output);
+                REQUIRE( my_object.enabled_channels().enabled(0) );
+                my_object(input, output);
+                REQUIRE( my_object.remaining[0] <= 0 );
+                my_object(input, output);
+                REQUIRE( !my_object.enabled_channels().enabled(0) );
+            }
+            AND_THEN ("stopping all notes releases it") {
+                my_object.stop_all();
+                my_object(input, output);
+                REQUIRE( my_object.remaining[0] == 100 - 64 );
+            }
+        }
+    }
+}
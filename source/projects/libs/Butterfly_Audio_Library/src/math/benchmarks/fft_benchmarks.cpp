@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <complex>
+#include <random>
+#include <string>
+#include <vector>
+#include "fft.h"
+
+using namespace Butterfly;
+
+
+namespace {
+
+template<int N>
+void benchmarkFFTCalculator() {
+	static const FFTCalculator<double, N> calculator;
+
+	std::mt19937 generator{ 0 };
+	std::uniform_real_distribution<double> distribution{ -1.0, 1.0 };
+
+	std::vector<double> realInput(N);
+	std::vector<std::complex<double>> input(N), output(N);
+	for (int i = 0; i < N; ++i) {
+		realInput[i] = distribution(generator);
+		input[i] = { realInput[i], distribution(generator) };
+	}
+
+	BENCHMARK("fft " + std::to_string(N)) {
+		calculator.fft(input.begin(), output.begin());
+		return output[1];
+	};
+
+	BENCHMARK("ifft " + std::to_string(N)) {
+		calculator.ifft(input.begin(), output.begin());
+		return output[1];
+	};
+
+	BENCHMARK("rfft " + std::to_string(N)) {
+		calculator.rfft(realInput.begin(), output.begin());
+		return output[1];
+	};
+}
+
+}
+
+
+TEST_CASE("FFTCalculator", "[benchmark]") {
+	benchmarkFFTCalculator<64>();
+	benchmarkFFTCalculator<256>();
+	benchmarkFFTCalculator<1024>();
+	benchmarkFFTCalculator<4096>();
+}
@@ -0,0 +1,39 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+#include "resampler.h"
+
+using namespace Butterfly;
+
+
+namespace {
+
+void benchmarkPolyphaseResampler(double ratio, size_t taps) {
+	PolyphaseResampler<float> resampler(ratio, taps);
+
+	std::mt19937 generator{ 0 };
+	std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+
+	std::vector<float> input(512);
+	for (auto& x : input) x = distribution(generator);
+	std::vector<float> output(resampler.maxOutputLength(input.size()));
+
+	BENCHMARK("512 samples, ratio " + std::to_string(ratio) + ", " + std::to_string(taps) + " taps") {
+		return resampler.process(input, output);
+	};
+}
+
+}
+
+
+TEST_CASE("PolyphaseResampler", "[benchmark]") {
+	for (size_t taps : { 16, 32, 64 }) {
+		benchmarkPolyphaseResampler(44100.0 / 48000.0, taps);
+		benchmarkPolyphaseResampler(48000.0 / 44100.0, taps);
+	}
+	benchmarkPolyphaseResampler(0.5, 32);
+	benchmarkPolyphaseResampler(2.0, 32);
+}
@@ -3,6 +3,9 @@
 
 #pragma once
 #include <cmath>
+#include <cassert>
+#include <span>
+#include "optimized_math.h"
 
 
 namespace Butterfly {
@@ -27,4 +30,32 @@ T normalizedTodB(T volume) {
 	return static_cast<T>(20.0 * std::log10(static_cast<double>(volume)));
 }
 
+
+/// @brief Convert a block of decibels to normalized volume, e.g. for gain automation.
+///        Uses fastExp2(), so the relative error is below 3e-7 instead of exact rounding.
+///        Input and output may be the same span.
+/// @tparam T Sample type
+/// @param dB decibel values
+/// @param volume normalized values, at least as many as dB
+template<std::floating_point T>
+void dBToNormalized(std::span<const T> dB, std::span<T> volume) {
+	assert(volume.size() >= dB.size());
+	constexpr T log2Of10Over20 = T(0.16609640474436811739); // 10^(x/20) = 2^(x * log2(10)/20)
+	for (size_t i = 0; i < dB.size(); ++i) volume[i] = fastExp2(dB[i] * log2Of10Over20);
+}
+
+/// @brief Convert a block of normalized volumes to decibels, e.g. for metering.
+///        Uses fastLog2(), so the absolute error is below 1e-6 dB. Volumes need to be positive
+///        and normal; zero yields about -765 dB (-6160 dB for double) instead of -inf.
+///        Input and output may be the same span.
+/// @tparam T Sample type
+/// @param volume normalized values
+/// @param dB decibel values, at least as many as volume
+template<std::floating_point T>
+void normalizedTodB(std::span<const T> volume, std::span<T> dB) {
+	assert(dB.size() >= volume.size());
+	constexpr T twentyOverLog2Of10 = T(6.02059991327962390427); // 20 log10(x) = log2(x) * 20/log2(10)
+	for (size_t i = 0; i < volume.size(); ++i) dB[i] = fastLog2(volume[i]) * twentyOverLog2Of10;
+}
+
 }
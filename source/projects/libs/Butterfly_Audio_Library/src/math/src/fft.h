@@ -87,6 +87,75 @@ void fft2(InIt in_first, InIt in_last, OutIt out, FFTDirection dir) {
 	}
 }
 
+
+// Complex multiplication without the checks for infinite and NaN operands that
+// std::complex performs, so that it compiles to a few (vectorizable) multiply-adds.
+template<class T>
+constexpr std::complex<T> multiply(const std::complex<T>& a, const std::complex<T>& b) {
+	return { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+}
+
+
+// View of every stride-th twiddle, i.e. the twiddles of a transform that is stride times smaller
+template<class Twiddles>
+struct StridedTwiddles {
+	const Twiddles& twiddles;
+	int stride;
+
+	constexpr auto operator[](int k) const { return twiddles[k * stride]; }
+};
+
+
+// Butterfly stages of a decimation in time FFT on data that is already in bit-reversed order.
+// Pairs of radix-2 stages are fused into radix-4 stages, which need three instead of four
+// complex multiplications per four values. A single radix-2 stage (without twiddles) comes first if log2(size) is odd.
+// The twiddles need to hold exp(2*pi*i*k/size) for 0 <= k < 3*size/4.
+template<bool inverse, std::random_access_iterator It, class Twiddles>
+constexpr void fft_stages(It x, const int size, const Twiddles& twiddles) {
+	using complex = typename std::iterator_traits<It>::value_type;
+
+	const auto twiddle = [&twiddles](int k) {
+		const complex w = twiddles[k];
+		return inverse ? complex{ w.real(), -w.imag() } : w;
+	};
+
+	int h = 1;
+	if (log2OfPowerOf2(size) % 2 == 1) {
+		for (int k = 0; k < size; k += 2) {
+			const complex u = x[k];
+			const complex t = x[k + 1];
+			x[k] = u + t;
+			x[k + 1] = u - t;
+		}
+		h = 2;
+	}
+
+	for (; h < size; h *= 4) {
+		const int stride = size / (4 * h);
+		for (int j = 0; j < h; ++j) {
+			const complex w1 = twiddle(j * stride);
+			const complex w2 = twiddle(2 * j * stride);
+			const complex w3 = twiddle(3 * j * stride);
+
+			for (int k = j; k < size; k += 4 * h) {
+				const complex a = x[k];
+				const complex b = multiply(w2, complex(x[k + h]));
+				const complex c = multiply(w1, complex(x[k + 2 * h]));
+				const complex d = multiply(w3, complex(x[k + 3 * h]));
+				const complex ab0 = a + b, ab1 = a - b;
+				const complex cd0 = c + d, cd1 = c - d;
+				// multiplication of c - d with +i (forward) or -i (inverse)
+				const complex rotated = inverse ? complex{ cd1.imag(), -cd1.real() } : complex{ -cd1.imag(), cd1.real() };
+
+				x[k] = ab0 + cd0;
+				x[k + h] = ab1 + rotated;
+				x[k + 2 * h] = ab0 - cd0;
+				x[k + 3 * h] = ab1 - rotated;
+			}
+		}
+	}
+}
+
 }
 
 
@@ -182,11 +251,13 @@ public:
 	constexpr FFTCalculator() {
 		for (int i = 0; i < N; ++i)
 			butterfly_indices[i] = bitReverse(i, log_n);
-
-		for (int s = 0; s < log_n; ++s) {
-			const int m2 = 1 << s; // 2^(s-1)
-			z[s] = std::polar(T(1), std::numbers::pi_v<T> / m2);
+		if constexpr (N >= 4) {
+			for (int i = 0; i < n_half; ++i)
+				half_butterfly_indices[i] = bitReverse(i, log_n - 1);
 		}
+
+		for (int k = 0; k < twiddle_count; ++k)
+			twiddles[k] = std::polar(T(1), T(2) * std::numbers::pi_v<T> * T(k) / T(N));
 	}
 
 
@@ -203,22 +274,7 @@ public:
 		for (int i = 0; i < N; ++i) {
 			out[i] = nrm * in[butterfly_indices[i]];
 		}
-		for (int s = 0; s < log_n; ++s) {
-			const int m2 = 1 << s;
-			const int m = m2 << 1;
-			const auto wm = z[s];
-			complex w(1, 0);
-
-			for (int j = 0; j < m2; ++j) {
-				for (int k = j; k < N; k += m) {
-					const complex t = w * out[k + m2];
-					const complex u = out[k];
-					out[k] = u + t;
-					out[k + m2] = u - t;
-				}
-				w *= wm;
-			}
-		}
+		detail::fft_stages<false>(out, N, twiddles);
 	}
 
 
@@ -235,23 +291,7 @@ public:
 		for (int i = 0; i < N; ++i) {
 			out[i] = nrm * in[butterfly_indices[i]];
 		}
-		for (int s = 0; s < log_n; ++s) {
-			const int m2 = 1 << s;
-			const int m = m2 << 1;
-			const auto tmp = z[s];
-			const auto wm = complex{ tmp.real(), -tmp.imag() };
-			complex w(1, 0);
-
-			for (int j = 0; j < m2; ++j) {
-				for (int k = j; k < N; k += m) {
-					const complex t = w * out[k + m2];
-					const complex u = out[k];
-					out[k] = u + t;
-					out[k + m2] = u - t;
-				}
-				w *= wm;
-			}
-		}
+		detail::fft_stages<true>(out, N, twiddles);
 	}
 
 
@@ -270,37 +310,183 @@ public:
 	template<std::random_access_iterator InIt, std::random_access_iterator OutIt>
 	constexpr void ifft_real(InIt in, OutIt out) const {
 		std::vector<complex> ifft(N);
-		for (int i = 0; i < N; ++i) {
-			ifft[i] = nrm * in[butterfly_indices[i]];
-		}
-		for (int s = 0; s < log_n; ++s) {
-			const int m2 = 1 << s;
-			const int m = m2 << 1;
-			const auto tmp = z[s];
-			const auto wm = complex{ tmp.real(), -tmp.imag() };
-			complex w(1, 0);
-
-			for (int j = 0; j < m2; ++j) {
-				for (int k = j; k < N; k += m) {
-					const complex t = w * ifft[k + m2];
-					const complex u = ifft[k];
-					ifft[k] = u + t;
-					ifft[k + m2] = u - t;
-				}
-				w *= wm;
-			}
-		}
+		this->ifft(in, ifft.begin());
 		for (int i = 0; i < N; i++) {
 			out[i] = ifft[i].real();
 		}
 	}
 
+
+	/// @brief
+	///  Fourier transform of N real values. Only the N/2 + 1 frequencies from zero up to nyquist are output,
+	///  as the others are the complex conjugates of these. The real values are packed into N/2 complex values
+	///  which are transformed at half the size, so this takes about half the time of fft().
+	///  The memory that input and output point to must not overlap.
+	///
+	/// @tparam InIt   Input iterator to real values. Must meet the requirements of LegacyRandomAccessIterator
+	/// @tparam OutIt  Output iterator to complex values. Must meet the requirements of LegacyRandomAccessIterator.
+	/// @param  in     iterator to N input values
+	/// @param  out    iterator to N/2 + 1 output values
+	template<std::random_access_iterator InIt, std::random_access_iterator OutIt>
+	constexpr void rfft(InIt in, OutIt out) const requires (N >= 4) {
+		for (int i = 0; i < n_half; ++i) {
+			const int j = 2 * half_butterfly_indices[i];
+			out[i] = nrm * complex(in[j], in[j + 1]);
+		}
+		detail::fft_stages<false>(out, n_half, detail::StridedTwiddles<decltype(twiddles)>{ twiddles, 2 });
+
+		// Separate the transforms of the even and odd values and combine them
+		const complex z0 = out[0];
+		out[0] = { z0.real() + z0.imag(), T(0) };
+		out[n_half] = { z0.real() - z0.imag(), T(0) };
+		for (int k = 1; k <= n_half / 2; ++k) {
+			const int j = n_half - k;
+			const complex zk = out[k];
+			const complex zj = out[j];
+			out[k] = real_spectrum(zk, zj, k);
+			if (j != k) out[j] = real_spectrum(zj, zk, j);
+		}
+	}
+
+
+	/// @brief
+	///  Inverse fourier transform of the N/2 + 1 frequencies from zero up to nyquist of a real signal,
+	///  as computed by rfft(), at about half the cost of ifft(). The imaginary parts of the first and the
+	///  last frequency are ignored.
+	///
+	///  Note: The input is used as working memory and is overwritten.
+	///
+	/// @tparam InOutIt  Iterator to complex values. Must meet the requirements of LegacyRandomAccessIterator
+	/// @tparam OutIt    Output iterator to real values. Must meet the requirements of LegacyRandomAccessIterator.
+	/// @param  in       iterator to N/2 + 1 input values
+	/// @param  out      iterator to N output values
+	template<std::random_access_iterator InOutIt, std::random_access_iterator OutIt>
+	constexpr void irfft(InOutIt in, OutIt out) const requires (N >= 4) {
+		// Pack the transforms of the even and odd values into one complex transform of half the size
+		const T x0 = complex(in[0]).real();
+		const T xn = complex(in[n_half]).real();
+		in[0] = nrm * complex(x0 + xn, x0 - xn);
+		for (int k = 1; k <= n_half / 2; ++k) {
+			const int j = n_half - k;
+			const complex xk = in[k];
+			const complex xj = in[j];
+			in[k] = packed_spectrum(xk, xj, k);
+			if (j != k) in[j] = packed_spectrum(xj, xk, j);
+		}
+
+		for (int i = 0; i < n_half; ++i) {
+			const int j = half_butterfly_indices[i];
+			if (i < j) std::swap(in[i], in[j]);
+		}
+		detail::fft_stages<true>(in, n_half, detail::StridedTwiddles<decltype(twiddles)>{ twiddles, 2 });
+
+		for (int i = 0; i < n_half; ++i) {
+			const complex z = in[i];
+			out[2 * i] = z.real();
+			out[2 * i + 1] = z.imag();
+		}
+	}
+
 private:
 	static constexpr int log_n{ log2OfPowerOf2(N) };
+	static constexpr int n_half{ N / 2 };
+	static constexpr int twiddle_count{ N < 4 ? 1 : 3 * N / 4 };
 	T nrm{ T(1) / std::sqrt(T(N)) };
 
 	std::array<int, N> butterfly_indices;
-	std::array<complex, log_n> z;
+	std::array<int, n_half> half_butterfly_indices{};
+	std::array<complex, twiddle_count> twiddles;
+
+
+	// Frequency k of a real signal from frequencies k and N/2 - k of the transform of its packed values
+	constexpr complex real_spectrum(const complex& zk, const complex& zj, int k) const {
+		const complex zj_conj{ zj.real(), -zj.imag() };
+		const complex even = T(0.5) * (zk + zj_conj);
+		const complex diff = zk - zj_conj;
+		const complex odd{ T(0.5) * diff.imag(), T(-0.5) * diff.real() }; // diff / 2i
+		return even + detail::multiply(twiddles[k], odd);
+	}
+
+	// Frequency k of the packed transform from frequencies k and N/2 - k of the spectrum of a real signal, including the normalization
+	constexpr complex packed_spectrum(const complex& xk, const complex& xj, int k) const {
+		const complex xj_conj{ xj.real(), -xj.imag() };
+		const complex w_conj{ twiddles[k].real(), -twiddles[k].imag() };
+		const complex odd = detail::multiply(xk - xj_conj, w_conj);
+		return nrm * (xk + xj_conj + complex{ -odd.imag(), odd.real() }); // even + i * odd
+	}
+};
+
+
+
+/// @brief FFT calculator for a size (which needs to be a power of two) that is only known at runtime.
+///
+/// Like `FFTCalculator`, the twiddle factors and the bit-reversal permutation are calculated once
+/// during construction (which allocates memory) so that the transforms themselves do not allocate.
+///
+/// @tparam T Data type
+template<std::floating_point T>
+class FFTPlan
+{
+public:
+	using complex = std::complex<T>;
+
+	/// @brief       Prepare the transforms for one size.
+	///
+	/// @param size  Size of data, needs to be a power of 2
+	explicit FFTPlan(int size)
+		: size_(size), nrm(T(1) / std::sqrt(T(size))), butterfly_indices(size), twiddles(size < 4 ? 1 : 3 * size / 4) {
+		assert(isPowerOf2(size) && "Size has to be a power of 2");
+
+		const int log_n = log2OfPowerOf2(size);
+		for (int i = 0; i < size; ++i)
+			butterfly_indices[i] = bitReverse(i, log_n);
+
+		for (int k = 0; k < static_cast<int>(twiddles.size()); ++k)
+			twiddles[k] = std::polar(T(1), T(2) * std::numbers::pi_v<T> * T(k) / T(size));
+	}
+
+	int size() const { return size_; }
+
+
+	/// @brief
+	///  Fourier transform for range based input of size() values. The memory that input and output point to
+	///  must not overlap.
+	///
+	/// @tparam InIt   Input iterator to real or complex values. Must meet the requirements of LegacyRandomAccessIterator
+	/// @tparam OutIt  Output iterator to complex values. Must meet the requirements of LegacyRandomAccessIterator.
+	/// @param  in     iterator to input data
+	/// @param  out    iterator to output data
+	template<std::random_access_iterator InIt, std::random_access_iterator OutIt>
+	void fft(InIt in, OutIt out) const {
+		for (int i = 0; i < size_; ++i) {
+			out[i] = nrm * in[butterfly_indices[i]];
+		}
+		detail::fft_stages<false>(out, size_, twiddles);
+	}
+
+
+	/// @brief
+	///  Inverse fourier transform for range based input of size() values. The memory that input and output point to
+	///  must not overlap.
+	///
+	/// @tparam InIt   Input iterator to complex values. Must meet the requirements of LegacyRandomAccessIterator
+	/// @tparam OutIt  Output iterator to complex values. Must meet the requirements of LegacyRandomAccessIterator.
+	/// @param  in     iterator to input data
+	/// @param  out    iterator to output data
+	template<std::random_access_iterator InIt, std::random_access_iterator OutIt>
+	void ifft(InIt in, OutIt out) const {
+		for (int i = 0; i < size_; ++i) {
+			out[i] = nrm * in[butterfly_indices[i]];
+		}
+		detail::fft_stages<true>(out, size_, twiddles);
+	}
+
+private:
+	int size_;
+	T nrm;
+
+	std::vector<int> butterfly_indices;
+	std::vector<complex> twiddles;
 };
 
 
@@ -7,7 +7,12 @@
 
 #pragma once
 
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 
 
 namespace Butterfly {
@@ -61,6 +66,10 @@ public:
 	template<class FP>
 	constexpr FP to() const { return static_cast<FP>(value * fixedPointMultiplicatorInv); }
 
+	/// @brief The underlying integer, e.g. to load it into a FixedLanes.
+	constexpr int_type raw() const { return value; }
+	static constexpr Fixed fromRaw(int_type value) { return Fixed{ value }; }
+
 	constexpr int_type integer() const { return value >> fixedPointFractionalBits; }
 	constexpr double fractional() const { return (value & fractionalMask) * fixedPointMultiplicatorInv; }
 
@@ -107,6 +116,136 @@ private:
 };
 
 
+template<int size>
+struct FixedPointProductType
+{
+};
+template<>
+struct FixedPointProductType<8>
+{
+	using type = uint16_t;
+};
+template<>
+struct FixedPointProductType<16>
+{
+	using type = uint32_t;
+};
+template<>
+struct FixedPointProductType<32>
+{
+	using type = uint64_t;
+};
+
+
+/// @brief A number of Fixed values that are processed together, e.g. the phases of many oscillators
+///        or LFOs. The values are kept in a plain array of unsigned integers and every operation is a
+///        loop over all lanes without branches, so the compiler turns it into integer SIMD
+///        instructions. As elsewhere in the library, no intrinsics are used.
+///
+///        Additions wrap around like those of the unsigned integer, so a phase accumulator with
+///        integerBits = log2(table size) wraps at the end of the table by itself:
+/// \code
+///     using Phases = FixedLanes<32, 8, 16>; // 16 phases into tables of 256 samples
+///     Phases phase, increment;
+///     // set increments per lane
+///     phase += increment;
+///     phase.integers(indices);         // table index per lane
+///     phase.fractionals(fractionals);  // interpolation parameter per lane
+/// \endcode
+///
+/// @tparam size        size of underlying unsigned integer type (needs to be a power of 2)
+/// @tparam integerBits number of bits to assign to the integer part
+/// @tparam lanes       number of values
+template<int size, int integerBits, size_t lanes>
+struct FixedLanes
+{
+	static_assert(integerBits < size, "At least one fractional bit is needed");
+
+	using fixed_type = Fixed<size, integerBits>;
+	using int_type = typename fixed_type::int_type;
+
+	static constexpr int fractionalBits = size - integerBits;
+	static constexpr int_type fractionalMask = fractionalBits == size ? std::numeric_limits<int_type>::max() : (int_type(1) << fractionalBits) - 1;
+	static constexpr double multiplicator = double(int_type(1) << (fractionalBits - 1)) * 2.;
+	static constexpr double multiplicatorInv = 1.0 / multiplicator;
+
+	std::array<int_type, lanes> values{};
+
+	constexpr FixedLanes() = default;
+
+	static constexpr FixedLanes broadcast(fixed_type value) {
+		FixedLanes result;
+		result.values.fill(value.raw());
+		return result;
+	}
+
+	constexpr void set(size_t lane, fixed_type value) { values[lane] = value.raw(); }
+	constexpr fixed_type get(size_t lane) const { return fixed_type::fromRaw(values[lane]); }
+	static constexpr size_t laneCount() { return lanes; }
+
+	constexpr FixedLanes& operator+=(const FixedLanes& a) {
+		for (size_t i = 0; i < lanes; ++i) values[i] += a.values[i];
+		return *this;
+	}
+	constexpr FixedLanes& operator-=(const FixedLanes& a) {
+		for (size_t i = 0; i < lanes; ++i) values[i] -= a.values[i];
+		return *this;
+	}
+	constexpr FixedLanes& operator<<=(int bits) {
+		for (size_t i = 0; i < lanes; ++i) values[i] <<= bits;
+		return *this;
+	}
+	constexpr FixedLanes& operator>>=(int bits) {
+		for (size_t i = 0; i < lanes; ++i) values[i] >>= bits;
+		return *this;
+	}
+	constexpr FixedLanes operator+(const FixedLanes& a) const { auto tmp = *this; return tmp += a; }
+	constexpr FixedLanes operator-(const FixedLanes& a) const { auto tmp = *this; return tmp -= a; }
+	constexpr FixedLanes operator<<(int bits) const { auto tmp = *this; return tmp <<= bits; }
+	constexpr FixedLanes operator>>(int bits) const { auto tmp = *this; return tmp >>= bits; }
+
+	/// @brief Fixed point product of each pair of lanes, computed in the integer type of twice the
+	///        size, so it is only available up to 32 bits.
+	constexpr FixedLanes operator*(const FixedLanes& a) const requires(size <= 32) {
+		using product_type = typename FixedPointProductType<size>::type;
+		FixedLanes result;
+		for (size_t i = 0; i < lanes; ++i) {
+			result.values[i] = static_cast<int_type>((product_type(values[i]) * a.values[i]) >> fractionalBits);
+		}
+		return result;
+	}
+
+	/// @brief Integer part of each lane, e.g. table indices of phases.
+	template<std::integral Int>
+	constexpr void integers(Int* out) const {
+		if constexpr (integerBits == 0) {
+			for (size_t i = 0; i < lanes; ++i) out[i] = Int{};
+		} else {
+			for (size_t i = 0; i < lanes; ++i) out[i] = static_cast<Int>(values[i] >> fractionalBits);
+		}
+	}
+
+	/// @brief Fractional part of each lane in [0, 1), e.g. the interpolation parameters of phases.
+	template<std::floating_point T>
+	constexpr void fractionals(T* out) const {
+		for (size_t i = 0; i < lanes; ++i) out[i] = static_cast<T>(values[i] & fractionalMask) * static_cast<T>(multiplicatorInv);
+	}
+};
+
+
+/// @brief Upper half of the full product of each pair of lanes, i.e. the product of two purely
+///        fractional values (integerBits = 0), e.g. a phase scaled by a gain in [0, 1).
+template<int size, int integerBits, size_t lanes>
+requires(size <= 32) constexpr FixedLanes<size, integerBits, lanes> mulhi(const FixedLanes<size, integerBits, lanes>& a, const FixedLanes<size, integerBits, lanes>& b) {
+	using product_type = typename FixedPointProductType<size>::type;
+	FixedLanes<size, integerBits, lanes> result;
+	for (size_t i = 0; i < lanes; ++i) {
+		result.values[i] = static_cast<typename FixedLanes<size, integerBits, lanes>::int_type>((product_type(a.values[i]) * b.values[i]) >> size);
+	}
+	return result;
+}
+
+
 // Wrapper for real numbers (fixed point) with modular arithmetic.
 // An interval [0,max] or [0,max) is defined which maps the range of
 // an unsigned
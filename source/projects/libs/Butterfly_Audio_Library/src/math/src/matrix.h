@@ -128,20 +128,20 @@ public:
 	using pointer = U*;
 	using reference = U&;
 
-	constexpr Matrix_block_iterator() noexcept : ptr(), row_length(1), jump(1), row_index(0) {};
-	constexpr explicit Matrix_block_iterator(pointer ptr, size_type row_length = 1, size_type jump = 1, size_type row_index = 0) noexcept
-		: ptr(ptr), row_length(row_length), jump(jump), row_index(row_index) {}
+	constexpr Matrix_block_iterator() noexcept : ptr(), row_length(1), jump(1), stride(1), row_index(0) {};
+	constexpr explicit Matrix_block_iterator(pointer ptr, size_type row_length = 1, size_type jump = 1, size_type row_index = 0, size_type stride = 1) noexcept
+		: ptr(ptr), row_length(row_length), jump(jump), stride(stride), row_index(row_index) {}
 
 	constexpr reference operator*() const noexcept { return *ptr; }
 	constexpr pointer operator->() const noexcept { return ptr; }
 	constexpr Matrix_block_iterator& operator++() noexcept {
 		if (++row_index >= row_length) { ptr += jump; row_index = 0; }
-		++ptr; return *this;
+		ptr += stride; return *this;
 	}
 	constexpr Matrix_block_iterator operator++(int) noexcept { Matrix_block_iterator tmp = *this; (*this)++; return tmp; }
 	constexpr Matrix_block_iterator& operator--() noexcept {
 		if (row_index-- == 0) { ptr -= jump; row_index = row_length - 1; }
-		ptr--; return *this;
+		ptr -= stride; return *this;
 	}
 	constexpr Matrix_block_iterator operator--(int) noexcept { Matrix_block_iterator tmp = *this; (*this)--; return tmp; }
 	constexpr std::strong_ordering operator<=>(const Matrix_block_iterator& right) const noexcept { return ptr <=> right.ptr; }
@@ -151,8 +151,9 @@ public:
 private:
 	pointer ptr;
 	size_type row_length;
+	size_type jump; // distance from the end of one row to the start of the next
+	size_type stride; // distance between neighbouring elements of a row
 	size_type row_index;
-	size_type jump;
 };
 
 
@@ -171,9 +172,12 @@ public:
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 
-	constexpr Matrix_view() noexcept : ptr(), m(0), n(0), rows_(0), cols_(0) {}
-	constexpr Matrix_view(T* ptr, size_type m, size_type n, size_type rows, size_type cols) noexcept
-		: ptr(ptr), m(m), n(n), rows_(rows), cols_(cols) {
+	constexpr Matrix_view() noexcept : ptr(), m(0), n(0), rows_(0), cols_(0), stride(1) {}
+
+	// Rows are n elements apart and the elements within a row are stride elements apart,
+	// so a view can also describe memory that is not owned by a Matrix, such as one plane of interleaved data.
+	constexpr Matrix_view(T* ptr, size_type m, size_type n, size_type rows, size_type cols, size_type stride = 1) noexcept
+		: ptr(ptr), m(m), n(n), rows_(rows), cols_(cols), stride(stride) {
 	}
 
 	constexpr Matrix_view& operator=(const Matrix_view& mat) requires (!std::is_const_v<T>) {
@@ -182,6 +186,13 @@ public:
 		return *this;
 	}
 
+	template<class U> requires (std::is_same_v<U, const T> && !std::is_const_v<T>)
+	constexpr Matrix_view& operator=(const Matrix_view<U>& mat) {
+		MATRIX_VERIFY(rows() == mat.rows() && cols() == mat.cols(), "Matrix view mismatch at Matrix_view::operator=(const Matrix_view<const T>&). Dimensions of target and destination need to match", Matrix_view_mismatch);
+		std::copy(mat.begin(), mat.end(), begin());
+		return *this;
+	}
+
 	template<size_type m, size_type n>
 	constexpr Matrix_view& operator=(const Matrix<T, m, n>& mat) requires (!std::is_const_v<T>) {
 		MATRIX_VERIFY(rows() == mat.rows() && cols() == mat.cols(), "Matrix view mismatch at Matrix_view::operator=(const Matrix&). Dimensions of target and destination need to match", Matrix_view_mismatch);
@@ -189,10 +200,10 @@ public:
 		return *this;
 	}
 
-	constexpr iterator begin() noexcept requires (!std::is_const_v<T>) { return iterator(ptr, cols(), n - cols()); }
-	constexpr iterator end() noexcept requires (!std::is_const_v<T>) { return iterator(ptr + rows() * n, cols(), n - cols()); }
-	constexpr const_iterator begin() const noexcept { return const_iterator(ptr, cols(), n - cols()); }
-	constexpr const_iterator end() const noexcept { return const_iterator(ptr + rows() * n, cols(), n - cols()); }
+	constexpr iterator begin() noexcept requires (!std::is_const_v<T>) { return iterator(ptr, cols(), jump(), 0, stride); }
+	constexpr iterator end() noexcept requires (!std::is_const_v<T>) { return iterator(ptr + rows() * n, cols(), jump(), 0, stride); }
+	constexpr const_iterator begin() const noexcept { return const_iterator(ptr, cols(), jump(), 0, stride); }
+	constexpr const_iterator end() const noexcept { return const_iterator(ptr + rows() * n, cols(), jump(), 0, stride); }
 
 	constexpr reverse_iterator rbegin() noexcept requires (!std::is_const_v<T>) { return reverse_iterator(end()); }
 	constexpr reverse_iterator rend()  requires (!std::is_const_v<T>) { return reverse_iterator(begin()); }
@@ -203,10 +214,15 @@ public:
 	constexpr size_type rows() const noexcept { return rows_; }
 	constexpr size_type cols() const noexcept { return cols_; }
 
+	constexpr reference operator()(size_type row, size_type col) const noexcept { return ptr[row * n + col * stride]; }
+
 private:
 	T* ptr; // first element of this matrix view block
 	size_type m, n; // dimensions of matrix that this view is pointing to 
 	size_type rows_, cols_; // dimensions of this matrix view block
+	size_type stride; // distance between neighbouring elements of a row
+
+	constexpr size_type jump() const noexcept { return n - cols() * stride; }
 
 };
 
@@ -249,6 +265,10 @@ public:
 		MATRIX_VERIFY(mat_view.rows() == rows() && mat_view.cols() == cols(), "Dimensions of block and matrix do not match in Matrix::operator=(const Matrix_view&)", Matrix_block_domain_error);
 		std::copy(mat_view.begin(), mat_view.end(), begin());
 	}
+	constexpr Matrix(const Matrix_view<const T>& mat_view) {
+		MATRIX_VERIFY(mat_view.rows() == rows() && mat_view.cols() == cols(), "Dimensions of block and matrix do not match in Matrix::Matrix(const Matrix_view<const T>&)", Matrix_block_domain_error);
+		std::copy(mat_view.begin(), mat_view.end(), begin());
+	}
 	constexpr Matrix(const Matrix<T, m, 1>(&vecs)[n]) requires(m > 1) {
 		for (Index j = 0; j < cols(); j++) col(j) = vecs[j];
 	}
@@ -314,15 +334,22 @@ public:
 		return result;
 	}
 
+	// The innermost loop runs along the contiguous rows of a and of the result, so that it can be vectorized,
+	// and as all sizes are known at compile time, small products like 4x4 or 8x8 are unrolled completely. 
+	// For large matrices, the rows of a are used in blocks which stay in the cache while they are reused for every row of the result. 
 	template<size_type p>
 	constexpr Matrix<T, m, p> operator*(const Matrix<T, n, p>& a) const {
 		Matrix<T, m, p> result;
-		for (size_type i = 0; i < m; ++i) {
-			for (size_type j = 0; j < p; ++j) {
-				T value{};
-				for (size_type k = 0; k < n; ++k)
-					value += (*this)(i, k) * a(k, j);
-				result(i, j) = value;
+		for (size_type k0 = 0; k0 < n; k0 += block_size) {
+			const size_type k1 = std::min(k0 + block_size, n);
+			for (size_type i = 0; i < m; ++i) {
+				T* out = result.data() + i * p;
+				for (size_type k = k0; k < k1; ++k) {
+					const T c = (*this)(i, k);
+					const T* row = a.data() + k * p;
+					for (size_type j = 0; j < p; ++j)
+						out[j] += c * row[j];
+				}
 			}
 		}
 		return result;
@@ -461,6 +488,8 @@ private:
 	constexpr Matrix(Unspecified) {}
 	storage_type data_;
 
+	static constexpr size_type block_size = 64; // rows of the right-hand side used at a time in operator*
+
 	template<class U> struct divides { constexpr U operator()(const U& l, const U& r) const { return l / r; } };
 	template<class U> struct modulus { constexpr U operator()(const U& l, const U& r) const { return l % r; } };
 };
@@ -497,6 +526,53 @@ template<class T, Index m, Index n>
 constexpr Matrix<T, m, n> hadamard(const Matrix<T, m, n>& a, const Matrix<T, m, n>& b) { return Matrix<T, m, n>(a).apply(std::multiplies<T>(), b); }
 
 
+// Compute transpose(a) * b without forming the transpose
+template<class T, Index m, Index n, Index p>
+constexpr Matrix<T, n, p> transpose_multiply(const Matrix<T, m, n>& a, const Matrix<T, m, p>& b) {
+	Matrix<T, n, p> result;
+	for (Index k = 0; k < m; ++k) {
+		const T* row = b.data() + k * p;
+		for (Index i = 0; i < n; ++i) {
+			const T c = a(k, i);
+			T* out = result.data() + i * p;
+			for (Index j = 0; j < p; ++j)
+				out[j] += c * row[j];
+		}
+	}
+	return result;
+}
+
+
+// Apply one matrix to many vectors, e.g. to all frames of an audio block
+template<class T, Index m, Index n>
+constexpr void multiply(const Matrix<T, m, n>& a, const Vector<T, n>* vecs, Vector<T, m>* results, Index count) {
+	for (Index v = 0; v < count; ++v)
+		results[v] = a * vecs[v];
+}
+
+
+// Apply one matrix to vectors stored as separate channels of frames, like the signals of an audio block: 
+// outputs[i][f] is the sum of a(i, k) * inputs[k][f] over all k. The outputs must not overlap the inputs. 
+// The frames are processed in chunks, so that the outputs stay in the cache while the inputs are accumulated. 
+template<class T, Index m, Index n>
+constexpr void multiply_channels(const Matrix<T, m, n>& a, const T* const* inputs, T* const* outputs, Index frames) {
+	constexpr Index chunk_size = 256;
+	for (Index f0 = 0; f0 < frames; f0 += chunk_size) {
+		const Index length = std::min(chunk_size, frames - f0);
+		for (Index i = 0; i < m; ++i) {
+			T* out = outputs[i] + f0;
+			std::fill(out, out + length, T{});
+			for (Index k = 0; k < n; ++k) {
+				const T c = a(i, k);
+				const T* in = inputs[k] + f0;
+				for (Index f = 0; f < length; ++f)
+					out[f] += c * in[f];
+			}
+		}
+	}
+}
+
+
 template<class T, Index n>
 constexpr Matrix<T, n, n> diag(const T(&values)[n]) {
 	Matrix<T, n, n> result;
@@ -3,6 +3,11 @@
 
 #pragma once
 #include <concepts>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <bit>
+#include <span>
 
 
 namespace Butterfly {
@@ -59,4 +64,173 @@ requires(sizeof(T) == 4) constexpr T bitReverse(T x, int nb) {
 }
 
 
+/// @brief Smallest integer n with 2^n >= x for positive x. Reads the exponent through
+///        std::frexp instead of evaluating a logarithm.
+template<std::floating_point T>
+inline int ceilLog2(T x) {
+	assert(x > 0 && "The argument needs to be positive");
+	int exponent;
+	const T mantissa = std::frexp(x, &exponent); // x = mantissa * 2^exponent, mantissa in [0.5, 1)
+	return exponent - static_cast<int>(mantissa == T(0.5));
+}
+
+/// @brief Polynomial approximation of std::sin for x in [-pi, pi], with an absolute error
+///        below 1e-6. Meant for coefficient updates that happen too often for std::sin.
+template<std::floating_point T>
+constexpr T fastSin(T x) {
+	constexpr T pi = T(3.14159265358979323846);
+	constexpr T halfPi = pi / 2;
+	assert(x >= -pi - T(1e-6) && x <= pi + T(1e-6) && "The argument needs to be in [-pi, pi]");
+	// reflect into [-pi/2, pi/2] where the polynomial is fitted
+	if (x > halfPi) x = pi - x;
+	else if (x < -halfPi) x = -pi - x;
+	const T x2 = x * x;
+	return x * (T(0.9999966) + x2 * (T(-0.16664824) + x2 * (T(0.00830629) + x2 * T(-0.00018363))));
+}
+
+
+/// @brief Cosine for x in [-pi, pi] through fastSin(), with the same absolute error below 1e-6.
+template<std::floating_point T>
+constexpr T fastCos(T x) {
+	constexpr T halfPi = T(1.57079632679489661923);
+	return fastSin(halfPi - (x < 0 ? -x : x));
+}
+
+
+/// @brief Tangent for x in [-1.4, 1.4] (about 0.45 pi), e.g. for the prewarping of bilinear
+///        filter designs, as the 7/6 rational approximation from Lambert's continued fraction.
+///        The relative error is below 1e-7 up to pi/4 and below 2e-5 up to 1.4.
+template<std::floating_point T>
+constexpr T fastTan(T x) {
+	const T x2 = x * x;
+	return x * (T(135135) + x2 * (T(-17325) + x2 * (T(378) - x2))) / (T(135135) + x2 * (T(-62370) + x2 * (T(3150) - T(28) * x2)));
+}
+
+
+/// @brief Hyperbolic tangent as the 7/6 rational approximation from Lambert's continued fraction,
+///        for saturation. The argument is clamped to [-4.97, 4.97], where the approximation reaches
+///        1, and the absolute error is below 2e-7 within [-1, 1] and below 1e-4 elsewhere.
+template<std::floating_point T>
+constexpr T fastTanh(T x) {
+	x = x < T(-4.97) ? T(-4.97) : (x > T(4.97) ? T(4.97) : x);
+	const T x2 = x * x;
+	const T y = x * (T(135135) + x2 * (T(17325) + x2 * (T(378) + x2))) / (T(135135) + x2 * (T(62370) + x2 * (T(3150) + T(28) * x2)));
+	return y < T(-1) ? T(-1) : (y > T(1) ? T(1) : y);
+}
+
+
+namespace detail {
+
+// The bit layout of the IEEE 754 formats that the exponential and logarithm work on directly.
+template<std::floating_point T>
+struct ieee754;
+
+template<>
+struct ieee754<float>
+{
+	using bits = uint32_t;
+	static constexpr int mantissaBits = 23;
+	static constexpr int bias = 127;
+	static constexpr float maxExponent = 126.f;
+};
+
+template<>
+struct ieee754<double>
+{
+	using bits = uint64_t;
+	static constexpr int mantissaBits = 52;
+	static constexpr int bias = 1023;
+	static constexpr double maxExponent = 1022.;
+};
+
+}
+
+
+/// @brief 2^x, from the integer part of x written into the exponent bits and a polynomial for
+///        the remainder in [-0.5, 0.5]. The relative error is below 3e-7. x is clamped to the range of
+///        normal numbers, so the result never overflows to infinity or underflows to a denormal.
+template<std::floating_point T>
+constexpr T fastExp2(T x) {
+	using format = detail::ieee754<T>;
+	x = x < -format::maxExponent ? -format::maxExponent : (x > format::maxExponent ? format::maxExponent : x);
+
+	int i = static_cast<int>(x + T(0.5));
+	i -= x + T(0.5) < T(i); // round to nearest, also for negative x
+	const T f = x - T(i);    // in [-0.5, 0.5]
+	const T p = T(1) + f * (T(0.69314718055994531) + f * (T(0.24022650695910071) + f * (T(0.05550410866482158) + f * (T(0.00961812910762848) + f * (T(0.00133335581464284) + f * T(0.00015403530393381))))));
+
+	const auto exponent = static_cast<typename format::bits>(i + format::bias) << format::mantissaBits;
+	return p * std::bit_cast<T>(exponent);
+}
+
+
+/// @brief log2(x) for positive, normal x, from the exponent bits and a series for the mantissa,
+///        which is first scaled into [sqrt(1/2), sqrt(2)). The absolute error is below 1e-7.
+template<std::floating_point T>
+constexpr T fastLog2(T x) {
+	using format = detail::ieee754<T>;
+	using bits = typename format::bits;
+	constexpr bits mantissaMask = (bits(1) << format::mantissaBits) - 1;
+	constexpr bits one = bits(format::bias) << format::mantissaBits;
+	constexpr T sqrt2 = T(1.41421356237309504880);
+
+	const bits b = std::bit_cast<bits>(x);
+	int exponent = static_cast<int>(b >> format::mantissaBits) - format::bias;
+	T m = std::bit_cast<T>((b & mantissaMask) | one); // in [1, 2)
+	const bool high = m > sqrt2;
+	m = high ? m * T(0.5) : m;
+	exponent += high;
+
+	// log2(m) = 2 / ln(2) * atanh(t) with t = (m - 1) / (m + 1), |t| < 0.172
+	const T t = (m - T(1)) / (m + T(1));
+	const T t2 = t * t;
+	const T series = t * (T(2.88539008177792681) + t2 * (T(0.96179669392597560) + t2 * (T(0.57707801635558536) + t2 * T(0.41219858311113240))));
+	return T(exponent) + series;
+}
+
+
+/// @brief e^x through fastExp2(), with its relative error below 3e-7.
+template<std::floating_point T>
+constexpr T fastExp(T x) {
+	return fastExp2(x * T(1.44269504088896340736));
+}
+
+
+/// @brief log10(x) for positive, normal x through fastLog2(), with an absolute error below 5e-8,
+///        e.g. for conversions to decibels.
+template<std::floating_point T>
+constexpr T fastLog10(T x) {
+	return fastLog2(x) * T(0.30102999566398119521);
+}
+
+
+/// @brief x^y for positive, normal x as 2^(y * log2(x)). The relative error is about
+///        3e-7 + 7e-8 * |y * log2(x)|, e.g. below 1e-6 for the ratios of musical pitches and levels.
+template<std::floating_point T>
+constexpr T fastPow(T x, T y) {
+	return fastExp2(y * fastLog2(x));
+}
+
+
+/// @brief Block versions of the approximations above, for buffers of parameters or samples.
+///        The loops have no branches, so the compiler can vectorize them; input and output may
+///        be the same span.
+#define BUTTERFLY_FAST_MATH_BLOCK(name)                                         \
+	template<std::floating_point T>                                           \
+	void name(std::span<const T> input, std::span<T> output) {                \
+		assert(output.size() >= input.size());                                \
+		for (size_t i = 0; i < input.size(); ++i) output[i] = name(input[i]); \
+	}
+
+BUTTERFLY_FAST_MATH_BLOCK(fastSin)
+BUTTERFLY_FAST_MATH_BLOCK(fastCos)
+BUTTERFLY_FAST_MATH_BLOCK(fastTan)
+BUTTERFLY_FAST_MATH_BLOCK(fastTanh)
+BUTTERFLY_FAST_MATH_BLOCK(fastExp2)
+BUTTERFLY_FAST_MATH_BLOCK(fastLog2)
+BUTTERFLY_FAST_MATH_BLOCK(fastExp)
+BUTTERFLY_FAST_MATH_BLOCK(fastLog10)
+
+#undef BUTTERFLY_FAST_MATH_BLOCK
+
 }
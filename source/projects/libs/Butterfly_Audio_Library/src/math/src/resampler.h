@@ -0,0 +1,204 @@
+// Sample-rate conversion with a windowed-sinc polyphase filter bank.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace Butterfly {
+
+
+/// @brief Zeroth-order modified Bessel function of the first kind, evaluated with its power series.
+inline double besselI0(double x) {
+	double sum = 1;
+	double term = 1;
+	const double q = x * x / 4;
+	for (int k = 1; k < 50 && term > sum * 1e-17; ++k) {
+		term *= q / (double(k) * k);
+		sum += term;
+	}
+	return sum;
+}
+
+
+/// @brief Dot product of two arrays. The four partial sums are independent, so the loop can be
+///        vectorized without reordering the additions of a single sum.
+template<std::floating_point T>
+inline T dotProduct(const T* a, const T* b, size_t length) {
+	T s0{}, s1{}, s2{}, s3{};
+	size_t i = 0;
+	for (; i + 4 <= length; i += 4) {
+		s0 += a[i] * b[i];
+		s1 += a[i + 1] * b[i + 1];
+		s2 += a[i + 2] * b[i + 2];
+		s3 += a[i + 3] * b[i + 3];
+	}
+	for (; i < length; ++i) s0 += a[i] * b[i];
+	return (s0 + s1) + (s2 + s3);
+}
+
+
+/// @brief Kaiser-windowed sinc lowpass, sampled at Phases + 1 fractional delays between 0 and 1.
+///
+///        Row p holds the taps that produce the output at a fraction p / phases past the center of
+///        the taps; the extra last row (a delay of 1) lets the resampler interpolate between the two
+///        rows nearest to any fraction. Each row is normalized to unity gain at DC.
+template<std::floating_point T>
+class PolyphaseFilterBank
+{
+public:
+	/// @param taps   Taps per phase, a multiple of 4 to suit dotProduct()
+	/// @param phases Number of fractional delays; more phases reduce the error of interpolating between them
+	/// @param cutoff Cutoff frequency relative to the Nyquist frequency of the input, in (0, 1]
+	/// @param beta   Kaiser window parameter; 8.6 gives about 90 dB of stopband attenuation
+	PolyphaseFilterBank(size_t taps, size_t phases, double cutoff, double beta = 8.6)
+		: tapCount(taps), phaseCount(phases), h(taps * (phases + 1)) {
+		assert(taps >= 4 && taps % 4 == 0 && phases > 0 && cutoff > 0 && cutoff <= 1);
+
+		const double center = double(taps) / 2 - 1;
+		const double halfWidth = double(taps) / 2;
+		const double windowNorm = 1 / besselI0(beta);
+
+		for (size_t p = 0; p <= phases; ++p) {
+			const double fraction = double(p) / phases;
+			T* row = h.data() + p * taps;
+			double sum = 0;
+			for (size_t k = 0; k < taps; ++k) {
+				const double d = double(k) - center - fraction; // distance of the tap from the output position
+				const double x = std::numbers::pi * cutoff * d;
+				const double sinc = d == 0 ? 1.0 : std::sin(x) / x;
+				const double r = std::min(std::abs(d) / halfWidth, 1.0);
+				const double window = besselI0(beta * std::sqrt(1 - r * r)) * windowNorm;
+				row[k] = static_cast<T>(sinc * window);
+				sum += sinc * window;
+			}
+			for (size_t k = 0; k < taps; ++k) row[k] = static_cast<T>(row[k] / sum);
+		}
+	}
+
+	size_t taps() const { return tapCount; }
+	size_t phases() const { return phaseCount; }
+
+	/// @brief Taps for a fractional delay of p / phases(), with p in [0, phases()].
+	const T* phase(size_t p) const { return h.data() + p * tapCount; }
+
+private:
+	size_t tapCount;
+	size_t phaseCount;
+	std::vector<T> h;
+};
+
+
+/// @brief Streaming sample-rate converter with a windowed-sinc polyphase filter bank.
+///
+///        Every output sample is the dot product of the input history with the two filter phases
+///        nearest to its fractional position, interpolated linearly. The ratio may be changed
+///        between blocks for varispeed playback; the cutoff of the filter is fixed when the
+///        resampler is created, so create it for the lowest ratio that will be used.
+///
+/// @tparam T Sample type
+template<std::floating_point T>
+class PolyphaseResampler
+{
+public:
+	/// @param ratio   Output rate divided by input rate
+	/// @param taps    Taps per phase; 32 taps and 256 phases keep THD+N below -90 dB up to 0.8 times
+	///                the lower of the two Nyquist frequencies
+	/// @param phases  Number of precomputed fractional delays
+	/// @param rolloff Cutoff relative to the lower of the two Nyquist frequencies
+	explicit PolyphaseResampler(double ratio, size_t taps = 32, size_t phases = 256, double rolloff = 0.95)
+		: bank(taps, phases, std::min(1.0, ratio) * rolloff), history(taps - 1, T(0)) {
+		setRatio(ratio);
+	}
+
+	/// Delay of the output in samples of the input rate.
+	double latency() const { return double(bank.taps()) / 2; }
+
+	/// @brief Skip a duration of the input, e.g. the latency() when converting a whole signal.
+	void advance(double inputSamples) { position += inputSamples; }
+
+	void setRatio(double ratio) {
+		assert(ratio > 0);
+		step = 1 / ratio;
+	}
+
+	/// @brief Upper bound of the number of samples that process() writes for a given input length.
+	size_t maxOutputLength(size_t inputLength) const { return static_cast<size_t>(std::ceil((inputLength + 1) / step)) + 1; }
+
+	/// @brief Convert a block. All of the input is consumed.
+	///
+	/// @param input  Input samples
+	/// @param output Storage for at least maxOutputLength(input.size()) samples
+	/// @return number of samples written to output
+	size_t process(std::span<const T> input, std::span<T> output) {
+		assert(output.size() >= maxOutputLength(input.size()));
+
+		const size_t taps = bank.taps();
+		const size_t phases = bank.phases();
+
+		// the history and the block are kept in a row so that the taps of every output are contiguous
+		buffer.resize(history.size() + input.size());
+		std::copy(history.begin(), history.end(), buffer.begin());
+		std::copy(input.begin(), input.end(), buffer.begin() + history.size());
+
+		size_t written = 0;
+		while (position + taps <= double(buffer.size()) && written < output.size()) {
+			const size_t index = static_cast<size_t>(position);
+			const double phase = (position - index) * phases;
+			const size_t p = std::min(static_cast<size_t>(phase), phases - 1);
+			const T a = static_cast<T>(phase - p);
+			const T* x = buffer.data() + index;
+			const T y0 = dotProduct(bank.phase(p), x, taps);
+			const T y1 = dotProduct(bank.phase(p + 1), x, taps);
+			output[written++] = y0 + a * (y1 - y0);
+			position += step;
+		}
+
+		// the samples from the next output on, at least taps - 1 of them, are kept for the next block
+		const size_t consumed = std::min(static_cast<size_t>(position), buffer.size() - (taps - 1));
+		history.assign(buffer.begin() + consumed, buffer.end());
+		position -= consumed;
+		return written;
+	}
+
+	void reset() {
+		history.assign(bank.taps() - 1, T(0));
+		position = 0;
+	}
+
+private:
+	PolyphaseFilterBank<T> bank;
+	std::vector<T> history;
+	std::vector<T> buffer;
+	double step{ 1 };
+	double position{}; // of the next output, in samples from the start of the history
+};
+
+
+/// @brief Convert a whole signal, e.g. an audio file, to another sample rate. The latency of the
+///        filter is compensated, so the output starts at the same time as the input and has
+///        round(input.size() * ratio) samples.
+template<std::floating_point T>
+std::vector<T> resample(std::span<const T> input, double ratio, size_t taps = 32, size_t phases = 256) {
+	PolyphaseResampler<T> resampler(ratio, taps, phases);
+	const size_t length = static_cast<size_t>(std::round(input.size() * ratio));
+
+	std::vector<T> padded(input.begin(), input.end());
+	padded.resize(input.size() + taps, T(0)); // flushes the filter
+
+	std::vector<T> output(resampler.maxOutputLength(padded.size()));
+	resampler.advance(resampler.latency());
+	output.resize(resampler.process(padded, output));
+	output.resize(length, T(0));
+	return output;
+}
+
+
+}
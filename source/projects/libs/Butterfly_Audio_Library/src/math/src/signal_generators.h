@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <memory>
 #include "constants.h"
 
 namespace Butterfly {
@@ -61,4 +64,88 @@ void generate_rectangle(It first, It last, double offset = 0.0, double cycles =
 		a = (a > T(0)) - (a < T(0));
 	}
 }
+
+
+/// @brief Fill given contiguous range with a sine curve, like the overload for forward iterators
+///        but without calling std::sin for every sample. Groups of lanes are rotated by a complex
+///        phasor, which the compiler can vectorize, and every resync samples the phasors are
+///        recomputed exactly, so the error stays below 1e-14 for double.
+/// @tparam It Data iterator, must meet the requirements of ContiguousIterator
+/// @param first start of range
+/// @param last end of range
+/// @param offset offset sine by a number of data points
+/// @param cycles number of sine cycles to fill data with
+template<std::contiguous_iterator It>
+void generate_sine(It first, It last, double offset = 0.0, double cycles = 1.0) {
+	using T = typename std::iterator_traits<It>::value_type;
+	constexpr size_t lanes = 8;
+	constexpr size_t resync = 32 * lanes;
+
+	const auto size = static_cast<size_t>(std::distance(first, last));
+	const double f = 2.0 * cycles * pi<double>() / static_cast<double>(size);
+	const double stepRe = std::cos(lanes * f), stepIm = std::sin(lanes * f);
+	T* data = std::to_address(first);
+
+	for (size_t start = 0; start < size; start += resync) {
+		const size_t end = std::min(size, start + resync);
+		double re[lanes], im[lanes];
+		for (size_t k = 0; k < lanes; ++k) {
+			const double x = (static_cast<double>(start + k) + offset) * f;
+			re[k] = std::cos(x);
+			im[k] = std::sin(x);
+		}
+		size_t i = start;
+		for (; i + lanes <= end; i += lanes) {
+			for (size_t k = 0; k < lanes; ++k) {
+				data[i + k] = static_cast<T>(im[k]);
+				const double r = re[k] * stepRe - im[k] * stepIm;
+				im[k] = re[k] * stepIm + im[k] * stepRe;
+				re[k] = r;
+			}
+		}
+		for (size_t k = 0; k < lanes && i + k < end; ++k) data[i + k] = static_cast<T>(im[k]);
+	}
+}
+
+/// @brief Fill given contiguous range with a triangle function, like the overload for forward
+///        iterators but as a branch-free loop over indices that the compiler can vectorize.
+/// @tparam It Data iterator, must meet the requirements of ContiguousIterator
+/// @param first start of range
+/// @param last end of range
+/// @param offset offset sine by a number of data points
+/// @param cycles number of cycles to fill data with
+template<std::contiguous_iterator It>
+void generate_triangle(It first, It last, double offset = 0.0, double cycles = 1.0) {
+	using T = typename std::iterator_traits<It>::value_type;
+	const auto size = static_cast<size_t>(std::distance(first, last));
+	const double f = cycles / static_cast<double>(size);
+	const double x0 = offset + static_cast<double>(size) / (4.0 * cycles);
+	T* data = std::to_address(first);
+	for (size_t i = 0; i < size; ++i) {
+		const double arg = (static_cast<double>(i) + x0) * f;
+		data[i] = static_cast<T>(4.0 * std::abs(arg - std::floor(arg + 0.5)) - 1.0); // floor(x + 0.5) vectorizes, std::round does not
+	}
+}
+
+/// @brief Fill given contiguous range with a rectangle signal, computed in the same pass as the
+///        triangle it is derived from.
+/// @tparam It Data iterator, must meet the requirements of ContiguousIterator
+/// @param first start of range
+/// @param last end of range
+/// @param offset offset sine by a number of data points
+/// @param cycles number of cycles to fill data with
+template<std::contiguous_iterator It>
+void generate_rectangle(It first, It last, double offset = 0.0, double cycles = 1.0) {
+	using T = typename std::iterator_traits<It>::value_type;
+	const auto size = static_cast<size_t>(std::distance(first, last));
+	const double f = cycles / static_cast<double>(size);
+	const double x0 = offset + static_cast<double>(size) / (4.0 * cycles);
+	T* data = std::to_address(first);
+	for (size_t i = 0; i < size; ++i) {
+		const double arg = (static_cast<double>(i) + x0) * f;
+		const auto a = static_cast<T>(4.0 * std::abs(arg - std::floor(arg + 0.5)) - 1.0);
+		data[i] = static_cast<T>((a > T(0)) - (a < T(0)));
+	}
+}
+
 }
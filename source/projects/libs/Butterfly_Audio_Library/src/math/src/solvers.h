@@ -1,17 +1,187 @@
 #pragma once
 
-// Compute determinant and inverse of 2x2 as well as 3x3 matrices.
+// Compute determinant and inverse of 2x2 as well as 3x3 matrices in closed form,
+// and solve larger linear systems with LU and Cholesky decompositions.
+//
+// All solvers work in place on fixed-size matrices and never allocate memory,
+// so they can be used on the audio thread, and they can be evaluated at compile time.
 
+#include <type_traits>
 #include "matrix.h"
 
 
 namespace Butterfly {
 
+namespace detail {
+
+template<class T>
+constexpr T constexpr_abs(const T& x) { return x < T{} ? -x : x; }
+
+template<class T>
+constexpr T constexpr_sqrt(const T& x) {
+	if (!std::is_constant_evaluated()) return std::sqrt(x);
+	if (!(x > T{})) return T{};
+	// Newton's iteration, starting above the root so that it decreases monotonically until it has converged
+	T y = x < T(1) ? T(1) : x;
+	for (T next = (y + x / y) / T(2); next < y; next = (y + x / y) / T(2)) y = next;
+	return y;
+}
+
+}
+
+
+//
+// LU decomposition with partial pivoting
+//
+
+// P * a = L * U where L is lower triangular with a unit diagonal and U is upper triangular.
+// Both are stored in lu, with the diagonal of L omitted. Row i of P * a is row permutation[i] of a.
+template<class T, Index n>
+struct LU_decomposition {
+	Matrix<T, n, n> lu;
+	std::array<Index, n> permutation{};
+	T sign{ 1 }; // determinant of P
+	bool singular{ false };
+};
+
+template<class T, Index n>
+constexpr LU_decomposition<T, n> lu_decompose(const Matrix<T, n, n>& a) {
+	LU_decomposition<T, n> d{ a };
+	auto& lu = d.lu;
+	for (Index i = 0; i < n; ++i) d.permutation[i] = i;
+
+	for (Index k = 0; k < n; ++k) {
+		Index pivot = k;
+		for (Index i = k + 1; i < n; ++i)
+			if (detail::constexpr_abs(lu(i, k)) > detail::constexpr_abs(lu(pivot, k))) pivot = i;
+
+		if (lu(pivot, k) == T{}) { d.singular = true; continue; }
+		if (pivot != k) {
+			for (Index j = 0; j < n; ++j) std::swap(lu(k, j), lu(pivot, j));
+			std::swap(d.permutation[k], d.permutation[pivot]);
+			d.sign = -d.sign;
+		}
+
+		const T inv_pivot = T(1) / lu(k, k);
+		for (Index i = k + 1; i < n; ++i) {
+			const T factor = lu(i, k) *= inv_pivot;
+			for (Index j = k + 1; j < n; ++j) lu(i, j) -= factor * lu(k, j);
+		}
+	}
+	return d;
+}
+
+// Solve a * x = b for x, where the columns of b are separate right-hand sides.
+// The result is not finite if the decomposition is singular.
+template<class T, Index n, Index p>
+constexpr Matrix<T, n, p> solve(const LU_decomposition<T, n>& d, const Matrix<T, n, p>& b) {
+	Matrix<T, n, p> x;
+	for (Index i = 0; i < n; ++i)
+		for (Index j = 0; j < p; ++j) x(i, j) = b(d.permutation[i], j);
+
+	for (Index i = 0; i < n; ++i) {
+		for (Index k = 0; k < i; ++k) {
+			const T l = d.lu(i, k);
+			for (Index j = 0; j < p; ++j) x(i, j) -= l * x(k, j);
+		}
+	}
+	for (Index i = n; i-- > 0;) {
+		for (Index k = i + 1; k < n; ++k) {
+			const T u = d.lu(i, k);
+			for (Index j = 0; j < p; ++j) x(i, j) -= u * x(k, j);
+		}
+		const T inv_diagonal = T(1) / d.lu(i, i);
+		for (Index j = 0; j < p; ++j) x(i, j) *= inv_diagonal;
+	}
+	return x;
+}
+
+template<class T, Index n>
+constexpr T det(const LU_decomposition<T, n>& d) {
+	if (d.singular) return T{};
+	T result = d.sign;
+	for (Index i = 0; i < n; ++i) result *= d.lu(i, i);
+	return result;
+}
+
+
+//
+// Cholesky decomposition
+//
+
+// a = L * transpose(L) for a symmetric positive definite matrix a, where L is lower triangular.
+// Only the lower triangle of a is read. This takes about half the work of an LU decomposition.
+template<class T, Index n>
+struct Cholesky_decomposition {
+	Matrix<T, n, n> l;
+	bool positive_definite{ true };
+};
+
+template<class T, Index n>
+constexpr Cholesky_decomposition<T, n> cholesky_decompose(const Matrix<T, n, n>& a) {
+	Cholesky_decomposition<T, n> d;
+	auto& l = d.l;
+	for (Index j = 0; j < n; ++j) {
+		T sum = a(j, j);
+		for (Index k = 0; k < j; ++k) sum -= l(j, k) * l(j, k);
+		if (!(sum > T{})) { d.positive_definite = false; return d; }
+
+		l(j, j) = detail::constexpr_sqrt(sum);
+		const T inv_diagonal = T(1) / l(j, j);
+		for (Index i = j + 1; i < n; ++i) {
+			T value = a(i, j);
+			for (Index k = 0; k < j; ++k) value -= l(i, k) * l(j, k);
+			l(i, j) = value * inv_diagonal;
+		}
+	}
+	return d;
+}
+
+// Solve a * x = b for x, where the columns of b are separate right-hand sides.
+// The result is meaningless if a is not positive definite.
+template<class T, Index n, Index p>
+constexpr Matrix<T, n, p> solve(const Cholesky_decomposition<T, n>& d, const Matrix<T, n, p>& b) {
+	Matrix<T, n, p> x(b);
+	for (Index i = 0; i < n; ++i) {
+		for (Index k = 0; k < i; ++k) {
+			const T l = d.l(i, k);
+			for (Index j = 0; j < p; ++j) x(i, j) -= l * x(k, j);
+		}
+		const T inv_diagonal = T(1) / d.l(i, i);
+		for (Index j = 0; j < p; ++j) x(i, j) *= inv_diagonal;
+	}
+	for (Index i = n; i-- > 0;) {
+		for (Index k = i + 1; k < n; ++k) {
+			const T l = d.l(k, i);
+			for (Index j = 0; j < p; ++j) x(i, j) -= l * x(k, j);
+		}
+		const T inv_diagonal = T(1) / d.l(i, i);
+		for (Index j = 0; j < p; ++j) x(i, j) *= inv_diagonal;
+	}
+	return x;
+}
+
+// Least-squares solution x minimizing |a * x - b| for an overdetermined system, via the normal equations.
+// Returns false (leaving x unchanged) if the columns of a are linearly dependent.
+template<class T, Index m, Index n, Index p>
+constexpr bool least_squares(const Matrix<T, m, n>& a, const Matrix<T, m, p>& b, Matrix<T, n, p>& x) {
+	const auto d = cholesky_decompose(transpose_multiply(a, a));
+	if (!d.positive_definite) return false;
+	x = solve(d, transpose_multiply(a, b));
+	return true;
+}
+
+
+//
+// Determinant and inverse
+//
+
 template<class T, Index n>
-T det(const Matrix<T, n, n>& a);
+constexpr T det(const Matrix<T, n, n>& a) { return det(lu_decompose(a)); }
 
+// The result is not finite if a is singular.
 template<class T, Index n>
-Matrix<T, n, n> inv(const Matrix<T, n, n>& a);
+constexpr Matrix<T, n, n> inv(const Matrix<T, n, n>& a) { return solve(lu_decompose(a), Matrix<T, n, n>::identity()); }
 
 template<class T>
 T det(const Matrix<T, 2, 2>& a) {
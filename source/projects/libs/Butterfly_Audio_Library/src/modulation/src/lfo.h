@@ -3,20 +3,61 @@
 
 #pragma once
 
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <numbers>
+#include <span>
+#include <type_traits>
 #include "modulation_routing_utilities.h"
 #include "optimized_math.h"
 
 
 namespace Butterfly {
 
+namespace detail {
 
+// std::sin and std::exp are not constexpr, so the tables are computed with their Taylor series at compile time.
+
+template<class T>
+constexpr T constexpr_sin(T x) {
+	if (!std::is_constant_evaluated()) return std::sin(x);
+	constexpr T two_pi = 2 * std::numbers::pi_v<T>;
+	x -= two_pi * static_cast<long long>(x / two_pi);
+	if (x > std::numbers::pi_v<T>) x -= two_pi;
+	else if (x < -std::numbers::pi_v<T>) x += two_pi;
+
+	T term = x, sum = x;
+	for (int k = 1; sum + term != sum; ++k) {
+		term *= -x * x / T((2 * k) * (2 * k + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+// Only meant for small arguments, e.g. |x| <= 1, for which the series converges quickly.
+template<class T>
+constexpr T constexpr_exp(T x) {
+	if (!std::is_constant_evaluated()) return std::exp(x);
+	T term = 1, sum = 1;
+	for (int k = 1; sum + term != sum; ++k) {
+		term *= x / T(k);
+		sum += term;
+	}
+	return sum;
+}
+
+}
+
+
+/// @brief Table of one period of an LFO shape, with the first value repeated at the end for interpolation.
+///        The table is aligned to a cache line.
 template<class T, int size>
 struct LFOTable
 {
-	const double* get() const { return &table[0]; }
-	T table[size + 1]{};
+	constexpr const T* get() const { return &table[0]; }
+	alignas(64) T table[size + 1]{};
 };
 
 template<class T, int size>
@@ -24,7 +65,7 @@ struct SinLFOTable : public LFOTable<T, size>
 {
 	constexpr SinLFOTable() {
 		for (int i = 0; i < size + 1; i++)
-			this->table[i] = std::sin(2.0 * 3.141592653589793 * i / size);
+			this->table[i] = detail::constexpr_sin(2.0 * std::numbers::pi * i / size);
 	}
 };
 
@@ -72,16 +113,49 @@ struct ExpLFOTable : public LFOTable<T, size>
 {
 	constexpr ExpLFOTable() {
 		const T size_halfs = size / T(2);
-		const T e = exp(1.0);
+		const T e = detail::constexpr_exp(1.0);
 		for (int i = 0; i < size / 2; i++) {
-			this->table[i] = 2.0 * ((std::exp(i / size_halfs) - 1.0) / (e - 1.0)) - 1.0;
-			this->table[i + size / 2] = 2.0 * ((std::exp((size_halfs - i) / size_halfs) - 1.0) / (e - 1.0)) - 1.0;
+			this->table[i] = 2.0 * ((detail::constexpr_exp(i / size_halfs) - 1.0) / (e - 1.0)) - 1.0;
+			this->table[i + size / 2] = 2.0 * ((detail::constexpr_exp((size_halfs - i) / size_halfs) - 1.0) / (e - 1.0)) - 1.0;
 		}
 		this->table[size] = -1.0f;
 	}
 };
 
 
+enum class LFOShape {
+	Sine,
+	Triangle,
+	Sawtooth,
+	Square,
+	Exp
+};
+
+// One read-only instance of each table per value type and size, computed at compile time,
+// so that all LFOs share the same tables and no LFO needs to own (or initialize) one.
+template<class T, int size> inline constexpr SinLFOTable<T, size> sinLFOTable{};
+template<class T, int size> inline constexpr TriangleLFOTable<T, size> triangleLFOTable{};
+template<class T, int size> inline constexpr SawtoothLFOTable<T, size> sawtoothLFOTable{};
+template<class T, int size> inline constexpr SquareLFOTable<T, size> squareLFOTable{};
+template<class T, int size> inline constexpr ExpLFOTable<T, size> expLFOTable{};
+
+/// @brief Get the shared table of a shape.
+///
+/// @tparam T Value type of the table.
+/// @tparam size Size of the table (excluding the repeated first value).
+/// @return Pointer to the size + 1 values of the table.
+template<class T, int size>
+constexpr const T* lfoTable(LFOShape shape) {
+	switch (shape) {
+	case LFOShape::Triangle: return triangleLFOTable<T, size>.get();
+	case LFOShape::Sawtooth: return sawtoothLFOTable<T, size>.get();
+	case LFOShape::Square: return squareLFOTable<T, size>.get();
+	case LFOShape::Exp: return expLFOTable<T, size>.get();
+	default: return sinLFOTable<T, size>.get();
+	}
+}
+
+
 struct ClampedAdditionLFOFreq
 {
 	static constexpr double chain_modulation(double a, double b) { return a + b; }
@@ -96,6 +170,53 @@ public:
 };
 
 
+namespace detail {
+
+// Fixed point phase of a lookup LFO. The integer bits index the table, and the phase wraps around
+// at the end of the table by the overflow of the unsigned integer.
+template<int tableSize>
+struct LFOPhase
+{
+	using int_type = uint32_t; // may also be uint64_t
+	using fixed_float = int_type;
+	static constexpr int_type fixedPointIntegerBits = log2OfPowerOf2(tableSize); // each increase by one doubles the table size
+	static constexpr int_type fixedPointFractionalBits = 8 * sizeof(fixed_float) - fixedPointIntegerBits;
+	static constexpr double fixedPointMax = int_type(1) << fixedPointIntegerBits;
+	static constexpr double fixedPointMultiplicator = int_type(1) << fixedPointFractionalBits;
+	static constexpr double fixedPointMultiplicatorInv = 1.0 / fixedPointMultiplicator;
+	static constexpr int_type fractionalMask = (int_type(1) << fixedPointFractionalBits) - 1;
+
+	static constexpr int_type tablesize = int_type(1) << fixedPointIntegerBits;
+
+	static constexpr fixed_float increment(double frequency, double samplerate_inv) {
+		return static_cast<fixed_float>(fixedPointMax * frequency * samplerate_inv * fixedPointMultiplicator);
+	}
+
+	static constexpr fixed_float fromNormalized(double normalizedPhase) {
+		return static_cast<fixed_float>(normalizedPhase * tablesize * fixedPointMultiplicator);
+	}
+
+	static constexpr double toNormalized(fixed_float phase) {
+		return phase / (tablesize * fixedPointMultiplicator);
+	}
+
+	// Linearly interpolated table value at a phase. The table needs tableSize + 1 values.
+	template<class T>
+	static constexpr T lookup(const T* table, fixed_float phase) {
+		const auto index = phase >> fixedPointFractionalBits;
+		const T fractional = static_cast<T>((phase & fractionalMask) * fixedPointMultiplicatorInv);
+		return table[index] * (T{ 1 } - fractional) + table[index + 1] * fractional;
+	}
+};
+
+template<class T>
+T smoothingCoefficient(double seconds, double samplerate) {
+	return static_cast<T>(1.0 - std::exp(-std::numbers::pi_v<double> * 2.0 / (seconds * samplerate)));
+}
+
+}
+
+
 template<class T, class ParamType = double, int tableSize = 256>
 class LookupLFOBase : public IModulationSource
 {
@@ -126,12 +247,11 @@ public:
 
 	constexpr void setSmoothingTime(ParamType seconds) {
 		smoothingTime = seconds;
-		const auto exponent = -std::numbers::pi_v<double> * 2.0 / (smoothingTime * samplerate);
-		smoothingParameter = static_cast<T>(1.0 - std::exp(exponent));
+		smoothingParameter = detail::smoothingCoefficient<T>(smoothingTime, samplerate);
 	}
 
 	constexpr void setStartPhase(ParamType normalizedStartPhase) {
-		startPhase = static_cast<fixed_float>(normalizedStartPhase * tablesize * fixedPointMultiplicator);
+		startPhase = Phase::fromNormalized(normalizedStartPhase);
 	}
 
 
@@ -139,17 +259,35 @@ public:
 	constexpr ParamType getFrequency() const { return static_cast<ParamType>(frequency.getParamValue()); }
 	constexpr ParamType getWidth() const { return static_cast<ParamType>(width.getParamValue()); }
 	constexpr ParamType getSmoothingTime() const { return smoothingTime; }
-	constexpr ParamType getStartPhase() const { return static_cast<ParamType>(startPhase / (tablesize * fixedPointMultiplicator)); }
+	constexpr ParamType getStartPhase() const { return static_cast<ParamType>(Phase::toNormalized(startPhase)); }
 
 	constexpr T operator+=(int samples) {
-		const auto index = phase >> fixedPointFractionalBits;
-		const T fractional = (phase & fractionalMask) * fixedPointMultiplicatorInv;
+		const T current = Phase::lookup(table, phase);
 		phase += phaseInc * samples;
-
-		const T current = table[index] * (T{ 1 } - fractional) + table[index + 1] * fractional;
 		return value += (current * static_cast<T>(width.getModulatedValue()) - value) * smoothingParameter;
 	}
 
+	/// @brief Render one value per sample for a whole block, the same values as calling operator++(int) for each sample.
+	///        The table lookups of all samples are computed first, in a loop without dependencies between the samples
+	///        that the compiler can vectorize, and the smoothing is then applied in a second pass.
+	///
+	/// @param out  Storage for the values of the block, one per sample.
+	constexpr void process(std::span<T> out) {
+		const T w = static_cast<T>(width.getModulatedValue());
+		const auto count = static_cast<fixed_float>(out.size());
+
+		for (fixed_float i = 0; i < count; ++i) {
+			out[i] = Phase::lookup(table, phase + phaseInc * i) * w;
+		}
+		phase += phaseInc * count;
+
+		T v = value;
+		for (auto& x : out) {
+			x = v += (x - v) * smoothingParameter;
+		}
+		value = v;
+	}
+
 	constexpr T operator++() {
 		const auto tmp = value;
 		this->operator+=(1);
@@ -174,8 +312,12 @@ public:
 	constexpr IModulationDestination& getWidthInput() { return width; }
 
 
-	constexpr void setTable(double* table) { this->table = table; }
-	constexpr double* getTable() const { return table; }
+	/// @brief Use a custom table, which needs to hold tableSize + 1 values and outlive the LFO.
+	constexpr void setTable(const T* table) { this->table = table; }
+	constexpr const T* getTable() const { return table; }
+
+	/// @brief Use the shared table of a shape.
+	constexpr void setShape(LFOShape shape) { table = lfoTable<T, tableSize>(shape); }
 
 private:
 	constexpr void setSamplerate(double samplerate) {
@@ -186,20 +328,11 @@ private:
 	}
 
 	constexpr void updatePhaseInc() {
-		const auto inc = fixedPointMax * frequency.getModulatedValue() * samplerate_inv * fixedPointMultiplicator;
-		phaseInc = static_cast<fixed_float>(inc);
+		phaseInc = Phase::increment(frequency.getModulatedValue(), samplerate_inv);
 	}
 
-	using int_type = uint32_t; // may also be uint64_t
-	using fixed_float = int_type;
-	static constexpr int_type fixedPointIntegerBits = log2OfPowerOf2(tableSize); // each increase by one doubles the table size
-	static constexpr int_type fixedPointFractionalBits = 8 * sizeof(fixed_float) - fixedPointIntegerBits;
-	static constexpr double fixedPointMax = int_type(1) << fixedPointIntegerBits;
-	static constexpr double fixedPointMultiplicator = int_type(1) << fixedPointFractionalBits;
-	static constexpr double fixedPointMultiplicatorInv = 1.0 / fixedPointMultiplicator;
-	static constexpr int_type fractionalMask = (int_type(1) << fixedPointFractionalBits) - 1;
-
-	static constexpr int_type tablesize = int_type(1) << fixedPointIntegerBits;
+	using Phase = detail::LFOPhase<tableSize>;
+	using fixed_float = typename Phase::fixed_float;
 
 
 	double samplerate{ 1. };
@@ -214,7 +347,123 @@ private:
 	ParamType smoothingTime{ 0 };
 	T smoothingParameter{ 1 };
 
-	const T* table{}; // currently used table
+	const T* table{ lfoTable<T, tableSize>(LFOShape::Sine) }; // currently used table
+};
+
+
+/// @brief Bank of lookup-based LFOs that are advanced in lockstep, for running many LFOs at once.
+///         The state of the LFOs is stored as a structure of arrays, so that the loops over the LFOs
+///         (phase accumulation, interpolation and smoothing) can be vectorized by the compiler.
+///         Unlike LookupLFOBase, the parameters are plain values and not modulation destinations.
+///         LFO i of the bank produces the same values as a LookupLFOBase with the same parameters.
+///
+/// @tparam T Value type.
+/// @tparam count Number of LFOs.
+/// @tparam tableSize Size of the tables, which need to hold tableSize + 1 values.
+template<class T, int count, int tableSize = 256>
+class LFOBank
+{
+public:
+	static_assert(isPowerOf2(tableSize), "size needs to be a power of 2");
+
+	using value_type = T;
+
+	constexpr LFOBank() {
+		frequencies.fill(1.0);
+		widths.fill(T{ 1 });
+		smoothingParameters.fill(T{ 1 });
+		tables.fill(lfoTable<T, tableSize>(LFOShape::Sine));
+	}
+
+	constexpr explicit LFOBank(double samplerate) : LFOBank() {
+		setSamplerate(samplerate);
+	}
+
+	constexpr void setSamplerate(double samplerate) {
+		this->samplerate = samplerate;
+		samplerate_inv = 1.0 / samplerate;
+		for (int i = 0; i < count; ++i) {
+			setFrequency(i, frequencies[i]);
+			setSmoothingTime(i, smoothingTimes[i]);
+		}
+	}
+
+	constexpr void setFrequency(int lfo, double frequency) {
+		frequencies[lfo] = frequency;
+		phaseIncs[lfo] = Phase::increment(frequency, samplerate_inv);
+	}
+
+	constexpr void setWidth(int lfo, T width) { widths[lfo] = width; }
+
+	constexpr void setSmoothingTime(int lfo, double seconds) {
+		smoothingTimes[lfo] = seconds;
+		smoothingParameters[lfo] = detail::smoothingCoefficient<T>(seconds, samplerate);
+	}
+
+	constexpr void setStartPhase(int lfo, double normalizedStartPhase) {
+		startPhases[lfo] = Phase::fromNormalized(normalizedStartPhase);
+	}
+
+	/// @brief Use a custom table for one LFO, which needs to hold tableSize + 1 values and outlive the bank.
+	constexpr void setTable(int lfo, const T* table) { tables[lfo] = table; }
+
+	/// @brief Use the shared table of a shape for one LFO.
+	constexpr void setShape(int lfo, LFOShape shape) { tables[lfo] = lfoTable<T, tableSize>(shape); }
+
+	constexpr double getSamplerate() const { return samplerate; }
+	constexpr double getFrequency(int lfo) const { return frequencies[lfo]; }
+	constexpr T getWidth(int lfo) const { return widths[lfo]; }
+	constexpr double getSmoothingTime(int lfo) const { return smoothingTimes[lfo]; }
+	constexpr double getStartPhase(int lfo) const { return Phase::toNormalized(startPhases[lfo]); }
+	constexpr const T* getTable(int lfo) const { return tables[lfo]; }
+
+	static constexpr int size() { return count; }
+
+	/// @brief Advance all LFOs by a number of samples and update their values once, like LookupLFOBase::operator+=().
+	constexpr void advance(int samples) {
+		for (int i = 0; i < count; ++i) {
+			const T current = Phase::lookup(tables[i], phases[i]);
+			phases[i] += phaseIncs[i] * static_cast<fixed_float>(samples);
+			values[i] += (current * widths[i] - values[i]) * smoothingParameters[i];
+		}
+	}
+
+	/// @brief Render one value per sample and LFO for a block. The values are stored frame by frame,
+	///        i.e. the value of LFO i at sample n of the block is out[n * count + i].
+	///
+	/// @param out  Storage for the values of the block; its size needs to be a multiple of count.
+	constexpr void process(std::span<T> out) {
+		assert(out.size() % count == 0);
+		for (auto frame = out.begin(); frame != out.end(); frame += count) {
+			for (int i = 0; i < count; ++i) {
+				const T current = Phase::lookup(tables[i], phases[i]);
+				phases[i] += phaseIncs[i];
+				frame[i] = values[i] += (current * widths[i] - values[i]) * smoothingParameters[i];
+			}
+		}
+	}
+
+	constexpr T operator[](int lfo) const { return values[lfo]; }
+	constexpr std::span<const T, count> getValues() const { return values; }
+
+	constexpr void retrigger() { phases = startPhases; }
+
+	constexpr void reset() {
+		retrigger();
+		values.fill(T{});
+	}
+
+private:
+	using Phase = detail::LFOPhase<tableSize>;
+	using fixed_float = typename Phase::fixed_float;
+
+	double samplerate{ 1. };
+	double samplerate_inv{ 1. };
+
+	std::array<fixed_float, count> phases{}, phaseIncs{}, startPhases{};
+	std::array<T, count> values{}, widths{}, smoothingParameters{};
+	std::array<double, count> frequencies{}, smoothingTimes{};
+	std::array<const T*, count> tables{};
 };
 
 /// @brief Lookup-based LFO class that supports multiple lfo shapes.
@@ -230,14 +479,7 @@ class MultiLookupLFO : public IModulationSource
 {
 public:
 	using value_type = T;
-
-	enum class Shape {
-		Sine,
-		Triangle,
-		Sawtooth,
-		Square,
-		Exp
-	};
+	using Shape = LFOShape;
 
 	MultiLookupLFO(double samplerate, double frequency)
 		: frequency([this](double) { this->updatePhaseInc(); }, 1.0),
@@ -266,13 +508,7 @@ public:
 	}
 
 	void setShape(Shape shape) {
-		switch (shape) {
-		case Shape::Sine: table = sinTable.get(); break;
-		case Shape::Triangle: table = triTable.get(); break;
-		case Shape::Sawtooth: table = sawTable.get(); break;
-		case Shape::Square: table = sqTable.get(); break;
-		case Shape::Exp: table = expTable.get(); break;
-		}
+		table = lfoTable<double, tablesize>(shape);
 		this->shape = shape;
 	}
 
@@ -353,14 +589,9 @@ private:
 	double smoothingTime{ 0 };
 	double smoothingParameter{ 1 };
 
-	const double* table = sinTable.get(); // currently used table
+	const double* table = lfoTable<double, tablesize>(Shape::Sine); // currently used table
 
 	Shape shape{ Shape::Sine };
-	inline static SinLFOTable<double, tablesize> sinTable{};
-	inline static TriangleLFOTable<double, tablesize> triTable{};
-	inline static SawtoothLFOTable<double, tablesize> sawTable{};
-	inline static SquareLFOTable<double, tablesize> sqTable{};
-	inline static ExpLFOTable<double, tablesize> expTable{};
 };
 
 }
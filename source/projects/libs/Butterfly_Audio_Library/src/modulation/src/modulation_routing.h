@@ -11,6 +11,8 @@
 //   The source also provides additional information about it's polarity
 //   (Unipolar: output is in [0,1], Bipolar: output is in [-1,1]) and
 //   it's update rate which can be per sample or per processing block.
+//   Per-sample sources may also provide all values of the current block
+//   through getBlock(), so they can modulate at audio rate.
 
 // A MODULATION DESTINATION is an object where one or multiple modulations
 //   can be injected to change some internal value like a frequency or level.
@@ -19,10 +21,14 @@
 //   on the destination. Then the completely modulated value may be used.
 //   Before the next modulation cycle, the destination needs to be reset using
 //   startNewModulationCycle().
+//   Destinations that accept blocks can additionally be modulated with one
+//   value per sample through modulateBlock(), e.g. for frequency modulation.
 
 
 #pragma once
 
+#include <cstddef>
+
 
 namespace Butterfly {
 
@@ -42,6 +48,7 @@ struct IModulationSource
 	virtual double getValue() const = 0;
 	virtual Polarity getPolarity() const = 0;
 	virtual UpdateRate getUpdateRate() const = 0;
+	virtual const double* getBlock() const { return nullptr; } // values of the current block for per-sample sources, or nullptr if only getValue() is available
 };
 
 
@@ -58,6 +65,15 @@ struct IModulationDestination
 
 	virtual ~IModulationDestination() = default;
 	virtual void modulate(double) = 0;		  // perform a modulation on this destination with given value
+	virtual void modulateAll(const double* values, size_t count) { // perform a modulation for each of the given values
+		for (size_t i = 0; i < count; ++i)
+			modulate(values[i]);
+	}
+	virtual void modulateBlock(const double* values, size_t count) { // perform a modulation with one value per sample (only used if acceptsBlocks())
+		if (count > 0)
+			modulate(values[0]);
+	}
+	virtual bool acceptsBlocks() const { return false; }
 	virtual void startNewModulationCycle() {} // reset modulation value to the param value (done before each modulation, so multiple sources can be applied to stack up to a total modulation value)
 	virtual Type getType() const = 0;
 };
@@ -9,24 +9,40 @@
 // ValueRefOutput: Basic implementatino of IModulationSource which takes a reference to a
 //   double and outputs its current values when IModulationSource::getValue() is called.
 //
+// BlockRefOutput: Per-sample IModulationSource that refers to a block of values which is
+//   rendered by its owner, so that it can be used for audio-rate modulation.
+//
 // ModulatableValue: Generic implementation of IModulationDestination that features a value
 //   that can be set traditionally and also modulated. A callback is invoked whenever the
 //   modulated value changes.
 //
+// AudioRateModulatableValue: ModulatableValue that can also be modulated with a block of
+//   values, so that its modulated value may change with every sample.
+//
 // ConnectionManager: A class that handles a preallocated number of ModulationConnection's
 //   by calling update on all active connections and startNewModulationCycle() on all
-//   modulation sources.
+//   modulation sources. Sources can declare destinations as their inputs (e.g. the
+//   frequency of an LFO), and the connections are then updated in dependency order.
+//
+// CompiledModulationMatrix: Like ConnectionManager2, but the connections are flattened into
+//   arrays that are grouped by destination and conversion function, so that an update
+//   evaluates them in tight loops with one virtual call per source and destination.
+//   Connections from per-sample sources to destinations accepting blocks are evaluated
+//   per sample, all others once per block.
 //
 
 
 #pragma once
 
+#include <array>
+#include <cassert>
 #include <functional>
 #include <vector>
 #include <algorithm>
 #include "modulation_routing.h"
 #include "stable_id_array.h"
 #include "stable_id_vector.h"
+#include "dense_id_array.h"
 
 
 namespace Butterfly {
@@ -98,6 +114,27 @@ using LFOOutput = ValueRefOutput<IModulationSource::Polarity::Bipolar, IModulati
 using EnvelopeOutput = ValueRefOutput<IModulationSource::Polarity::Unipolar, IModulationSource::UpdateRate::PerSample>;
 
 
+// Per-sample output that reads from the given location of a block of (double) values (which may not change),
+// e.g. the output of an oscillator that is rendered before the modulation is updated.
+// When used as a single value, the first value of the block is output.
+template<IModulationSource::Polarity mode>
+class BlockRefOutput : public IModulationSource
+{
+public:
+	constexpr BlockRefOutput(const double* block) : block(block) {}
+	constexpr BlockRefOutput(const BlockRefOutput&) = delete;
+	constexpr BlockRefOutput& operator=(const BlockRefOutput&) = delete;
+
+	constexpr double getValue() const override { return block[0]; }
+	constexpr const double* getBlock() const override { return block; }
+	constexpr Polarity getPolarity() const override { return mode; }
+	constexpr UpdateRate getUpdateRate() const override { return UpdateRate::PerSample; }
+
+private:
+	const double* block;
+};
+
+
 
 /*
  * IModulationDestination implementations
@@ -144,6 +181,15 @@ public:
 			callback(modulationValue);
 	}
 
+	// Chains all values before the modulated value is updated and the callback is invoked, once.
+	constexpr void modulateAll(const double* values, size_t count) override {
+		for (size_t i = 0; i < count; ++i)
+			modulationValue = Operation::chain_modulation(modulationValue, values[i]);
+		updateModulatedValue();
+		if constexpr (supplyCallback)
+			callback(modulationValue);
+	}
+
 	constexpr void startNewModulationCycle() override {
 		modulationValue = Operation::neutral_element();
 		updateModulatedValue();
@@ -221,26 +267,122 @@ using FrequencyValue = AdditivelyClampedModulatableValue<IModulationDestination:
 using FilterResonanceValue = AdditivelyClampedModulatableValue<IModulationDestination::Type::Resonance>;
 
 
+// ModulatableValue that also accepts blocks of up to maxBlockSize values, which are chained
+// sample by sample with the modulation of the whole block. Without a block modulation in the
+// current cycle, getModulatedValue(i) is the same for all samples.
+// The callback is not invoked for block modulations.
+template</*ModulationOperation*/ class Operation, IModulationDestination::Type mode, size_t maxBlockSize>
+class AudioRateModulatableValue : public ModulatableValue<Operation, mode, false>
+{
+	using Base = ModulatableValue<Operation, mode, false>;
+
+public:
+	using Base::Base;
+	using Base::getModulatedValue;
+
+	constexpr void modulateBlock(const double* values, size_t count) override {
+		assert(count <= maxBlockSize);
+		if (!hasBlock) {
+			std::copy(values, values + count, blockModulation.begin());
+			blockSize = count;
+			hasBlock = true;
+			return;
+		}
+		blockSize = std::min(blockSize, count);
+		for (size_t i = 0; i < blockSize; ++i)
+			blockModulation[i] = Operation::chain_modulation(blockModulation[i], values[i]);
+	}
+
+	constexpr bool acceptsBlocks() const override { return true; }
+
+	constexpr void startNewModulationCycle() override {
+		Base::startNewModulationCycle();
+		hasBlock = false;
+	}
+
+	// Modulated value at the given sample of the current block.
+	constexpr double getModulatedValue(size_t i) const {
+		if (!hasBlock || i >= blockSize) return this->modulatedValue;
+		return Operation::apply_modulation(this->paramValue, Operation::chain_modulation(this->modulationValue, blockModulation[i]));
+	}
+
+	// Write the modulated values of the first count samples of the current block.
+	constexpr void getModulatedBlock(double* out, size_t count) const {
+		for (size_t i = 0; i < count; ++i)
+			out[i] = getModulatedValue(i);
+	}
+
+	constexpr bool isModulatedPerSample() const { return hasBlock; }
+
+private:
+	std::array<double, maxBlockSize> blockModulation{};
+	size_t blockSize{};
+	bool hasBlock{ false };
+};
+
+template<size_t maxBlockSize>
+using AudioRateFrequencyValue = AudioRateModulatableValue<ClampedAddition, IModulationDestination::Type::Frequency, maxBlockSize>;
+template<size_t maxBlockSize>
+using AudioRateDetuneValue = AudioRateModulatableValue<Addition, IModulationDestination::Type::Detune, maxBlockSize>;
+template<size_t maxBlockSize>
+using AudioRateVolumeValue = AudioRateModulatableValue<Multiplication, IModulationDestination::Type::Volume, maxBlockSize>;
+
+
+// Connections need to be changed through addConnection(), removeConnection() and setState(),
+// which update the order in which the connections are evaluated.
 class ConnectionManager : public StableIDVector<ModulationConnection>
 {
 public:
+	explicit ConnectionManager(size_t capacity) : StableIDVector(capacity) {}
+
 	void setModulationParam(size_t id, double value) {
 		(*this)[id].setParam(value);
 	}
 
 	void updateAllConnections() {
+		updateAllConnections([](IModulationSource&) {});
+	}
+
+	// Update all connections in dependency order. processSource is called for each source with
+	// declared inputs once all connections to its inputs have been updated and before any connection
+	// from it is updated, so that it can compute its output from the modulated inputs in the same pass.
+	template<class F>
+	void updateAllConnections(F&& processSource) {
 		resetAllModulationValues();
-		for (auto& el : *this) {
-			el.update();
+		for (const auto& step : schedule) {
+			if (step.source != nullptr) processSource(*step.source);
+			else (*this)[step.connection].update();
 		}
 	}
 
 	ConnectionID addConnection(const ModulationConnection& c) {
 		const auto id = add(c);
 		if (id == invalid_id) return ConnectionID::createInvalidID();
+		updateSchedule();
 		return ConnectionID{ id };
 	}
 
+	bool removeConnection(ConnectionID id) {
+		const bool removed = remove(id());
+		if (removed) updateSchedule();
+		return removed;
+	}
+
+	// Declare that a destination is an input of a source, so connections to the input are updated first.
+	void addSourceInput(IModulationSource& source, IModulationDestination& input) {
+		sourceInputs.push_back({ &source, &input });
+		updateSchedule();
+	}
+
+	void removeSourceInputs(const IModulationSource& source) {
+		std::erase_if(sourceInputs, [&source](const auto& p) { return p.first == &source; });
+		updateSchedule();
+	}
+
+	// Whether some connections depend on themselves through the inputs of sources. These connections
+	// are updated after all others, with the values of their sources from the previous update.
+	bool hasCycle() const { return cyclic; }
+
 	auto getState() const {
 		std::vector<std::pair<ModulationConnection, ConnectionID>> pairs;
 		for (size_t i = 0; i < size(); i++) {
@@ -255,6 +397,7 @@ public:
 		for (const auto& p : connections) {
 			insert(p.first, p.second());
 		}
+		updateSchedule();
 		return true;
 	}
 
@@ -265,7 +408,80 @@ private:
 		for (auto& el : *this) {
 			el.getDestination()->startNewModulationCycle();
 		}
+		for (const auto& p : sourceInputs) { // also inputs that are no longer connected
+			p.second->startNewModulationCycle();
+		}
+	}
+
+	bool isInputOf(const IModulationDestination* destination, const IModulationSource* source) const {
+		return std::any_of(sourceInputs.begin(), sourceInputs.end(), [=](const auto& p) { return p.first == source && p.second == destination; });
+	}
+
+	// Topological sort (Kahn's algorithm) of a graph with a node for each connection and each source with inputs,
+	// that has edges from connections to the sources they modulate an input of and from sources to their connections.
+	// Nodes are taken in the order of the connections where the order is not determined by dependencies.
+	// Nodes on or after a cycle are appended in that order as well.
+	void updateSchedule() {
+		std::vector<IModulationSource*> sources;
+		for (const auto& p : sourceInputs) {
+			if (std::find(sources.begin(), sources.end(), p.first) == sources.end()) sources.push_back(p.first);
+		}
+		const size_t numConnections = size();
+		const size_t numNodes = numConnections + sources.size();
+
+		const auto hasEdge = [&](size_t from, size_t to) {
+			if (from < numConnections && to >= numConnections)
+				return isInputOf(get_by_index(from).getDestination(), sources[to - numConnections]);
+			if (from >= numConnections && to < numConnections)
+				return get_by_index(to).getSource() == sources[from - numConnections];
+			return false;
+		};
+
+		std::vector<size_t> inDegree(numNodes);
+		for (size_t from = 0; from < numNodes; ++from) {
+			for (size_t to = 0; to < numNodes; ++to) {
+				if (hasEdge(from, to)) ++inDegree[to];
+			}
+		}
+
+		std::vector<bool> scheduled(numNodes);
+		const auto addStep = [&](size_t node) {
+			scheduled[node] = true;
+			if (node < numConnections) schedule.push_back({ nullptr, get_id(node) });
+			else schedule.push_back({ sources[node - numConnections], 0 });
+		};
+
+		schedule.clear();
+		bool progress = true;
+		while (progress) {
+			progress = false;
+			for (size_t node = 0; node < numNodes; ++node) {
+				if (scheduled[node] || inDegree[node] != 0) continue;
+				addStep(node);
+				for (size_t to = 0; to < numNodes; ++to) {
+					if (hasEdge(node, to)) --inDegree[to];
+				}
+				progress = true;
+				break;
+			}
+		}
+
+		cyclic = schedule.size() < numNodes;
+		for (size_t node = 0; node < numNodes; ++node) {
+			if (!scheduled[node]) addStep(node);
+		}
 	}
+
+	// Either a connection to update or a source to process
+	struct Step
+	{
+		IModulationSource* source{};
+		id_type connection{};
+	};
+
+	std::vector<std::pair<IModulationSource*, IModulationDestination*>> sourceInputs;
+	std::vector<Step> schedule;
+	bool cyclic{ false };
 };
 
 
@@ -284,7 +500,7 @@ public:
 
 
 template<int numSources, int numDestinations, int maxNumConnections>
-class ConnectionManager2 : public StableIDArray<ConnectionInfo, maxNumConnections>
+class ConnectionManager2 : public DenseIDArray<ConnectionInfo, maxNumConnections>
 {
 public:
 	using ModulationSourceMap = std::array<IModulationSource*, numSources>;
@@ -303,7 +519,7 @@ public:
 	}
 
 	void setParam(ConnectionID id, double param) {
-		this->operator[](id).param = param;
+		this->operator[](id()).param = param;
 	}
 
 private:
@@ -316,4 +532,215 @@ private:
 	}
 };
 
+
+
+/*
+ * Modulation matrix for many connections. The connections are kept with stable IDs like in ConnectionManager2,
+ * and compiled into a structure of arrays, sorted by destination and then by conversion function:
+ * - each source is read once per update (rather than once per connection),
+ * - each run of connections with the same destination and conversion function is evaluated in a tight loop
+ *   over contiguous source indices and params,
+ * - the values for a destination are passed with a single call to IModulationDestination::modulateAll().
+ *
+ * Connections from a per-sample source that provides a block (IModulationSource::getBlock()) to a destination
+ * that accepts blocks (IModulationDestination::acceptsBlocks()) are evaluated at audio rate: the conversion
+ * function is applied to each of the blockSize values and the result is passed with modulateBlock().
+ * All other connections are evaluated once per block, so audio-rate cost is only paid where both ends support it.
+ *
+ * Adding and removing connections recompiles the arrays on the next update, which sorts but never allocates.
+ * Changing a param only updates the compiled arrays.
+ */
+template<int numSources, int numDestinations, int maxNumConnections, size_t maxBlockSize = 512>
+class CompiledModulationMatrix : private StableIDArray<ConnectionInfo, maxNumConnections>
+{
+	using Connections = StableIDArray<ConnectionInfo, maxNumConnections>;
+
+public:
+	using ConversionFunc = ConnectionInfo::ConversionFunc;
+	using ModulationSourceMap = std::array<IModulationSource*, numSources>;
+	using ModulationDestinationMap = std::array<IModulationDestination*, numDestinations>;
+
+	ConnectionID addConnection(const ConnectionInfo& connection) {
+		const auto id = this->add(connection);
+		if (id == Connections::invalid_id) return ConnectionID::createInvalidID();
+		dirty = true;
+		return ConnectionID{ id };
+	}
+
+	// Add a connection with a given ID, e.g. when restoring a state.
+	void insertConnection(const ConnectionInfo& connection, ConnectionID id) {
+		this->insert(connection, id());
+		dirty = true;
+	}
+
+	bool removeConnection(ConnectionID id) {
+		const bool removed = this->remove(id());
+		dirty = dirty || removed;
+		return removed;
+	}
+
+	void setParam(ConnectionID id, double param) {
+		(*this)[id()].param = param;
+		if (!dirty) params[slots[id()]] = param;
+	}
+
+	const ConnectionInfo& getConnection(ConnectionID id) const { return (*this)[id()]; }
+	using Connections::size;
+
+	std::vector<ConnectionSpecification> getConnectionSpecifications() const {
+		std::vector<ConnectionSpecification> specifications;
+		for (size_t i = 0; i < size(); i++) {
+			const auto& c = this->get_by_index(i);
+			specifications.push_back({ c.sourceID, c.destinationID, ConnectionID{ this->get_id(i) } });
+		}
+		return specifications;
+	}
+
+	// Number of connections that are evaluated at audio rate, as of the last compilation.
+	int getNumAudioRateConnections() const { return numAudioRateConnections; }
+
+
+	// Flatten the connections into the arrays evaluated by updateAllConnections().
+	// This is done automatically on the next update after connections have been added or removed.
+	// Whether a connection is evaluated at audio rate is decided here from the update rate of its source
+	// and whether its destination accepts blocks, which therefore must not change while connected.
+	void compile(const ModulationSourceMap& sources, const ModulationDestinationMap& destinations) {
+		count = static_cast<int>(size());
+		for (int i = 0; i < count; i++) {
+			const int id = static_cast<int>(this->get_id(i));
+			const auto& c = (*this)[id];
+			order[i] = id;
+			audioRate[id] = sources[c.sourceID()]->getUpdateRate() == IModulationSource::UpdateRate::PerSample
+							&& destinations[c.destinationID()]->acceptsBlocks();
+		}
+		std::sort(order.begin(), order.begin() + count, [this](int a, int b) {
+			const auto& ca = (*this)[a];
+			const auto& cb = (*this)[b];
+			if (ca.destinationID() != cb.destinationID()) return ca.destinationID() < cb.destinationID();
+			if (audioRate[a] != audioRate[b]) return audioRate[b];
+			return std::less<ConversionFunc>{}(ca.conversionFunc, cb.conversionFunc);
+		});
+
+		numRuns = 0;
+		numDestinationRanges = 0;
+		numAudioRateConnections = 0;
+		std::array<bool, numSources> used{};
+		numUsedSources = 0;
+
+		for (int i = 0; i < count; ++i) {
+			const auto& c = (*this)[order[i]];
+			const int destination = static_cast<int>(c.destinationID());
+			const int source = static_cast<int>(c.sourceID());
+			const bool isAudioRate = audioRate[order[i]];
+
+			sourceIndices[i] = source;
+			conversionFuncs[i] = c.conversionFunc;
+			params[i] = c.param;
+			slots[order[i]] = i;
+
+			if (!used[source]) {
+				used[source] = true;
+				usedSources[numUsedSources++] = source;
+			}
+
+			if (numDestinationRanges == 0 || destinationRanges[numDestinationRanges - 1].destination != destination) {
+				destinationRanges[numDestinationRanges++] = { destination, i, i, i };
+				if (!isAudioRate) runs[numRuns++] = { c.conversionFunc, i, i };
+			}
+			else if (!isAudioRate && runs[numRuns - 1].conversionFunc != c.conversionFunc) {
+				runs[numRuns++] = { c.conversionFunc, i, i };
+			}
+
+			auto& range = destinationRanges[numDestinationRanges - 1];
+			++range.end;
+			if (isAudioRate) {
+				++numAudioRateConnections;
+			}
+			else {
+				++range.audioRateBegin;
+				++runs[numRuns - 1].end;
+			}
+		}
+		dirty = false;
+	}
+
+
+	// Update all destinations. Audio-rate connections pass blockSize values per connection,
+	// or a single value if blockSize is 0 or the source does not provide a block at the moment.
+	void updateAllConnections(const ModulationSourceMap& sources, const ModulationDestinationMap& destinations, size_t blockSize = 0) {
+		assert(blockSize <= maxBlockSize);
+		if (dirty) compile(sources, destinations);
+
+		for (int i = 0; i < numUsedSources; ++i) {
+			const auto source = usedSources[i];
+			sourceValues[source] = sources[source]->getValue();
+		}
+
+		for (int r = 0; r < numRuns; ++r) {
+			const auto& run = runs[r];
+			const auto f = run.conversionFunc;
+			for (int i = run.begin; i < run.end; ++i) {
+				values[i] = f(sourceValues[sourceIndices[i]], params[i]);
+			}
+		}
+
+		for (int d = 0; d < numDestinationRanges; ++d) {
+			const auto& range = destinationRanges[d];
+			auto destination = destinations[range.destination];
+			destination->startNewModulationCycle();
+			destination->modulateAll(values.data() + range.begin, static_cast<size_t>(range.audioRateBegin - range.begin));
+
+			for (int i = range.audioRateBegin; i < range.end; ++i) {
+				const auto source = sourceIndices[i];
+				const auto f = conversionFuncs[i];
+				const auto block = blockSize > 0 ? sources[source]->getBlock() : nullptr;
+				if (block == nullptr) {
+					destination->modulate(f(sourceValues[source], params[i]));
+					continue;
+				}
+				for (size_t j = 0; j < blockSize; ++j) {
+					blockValues[j] = f(block[j], params[i]);
+				}
+				destination->modulateBlock(blockValues.data(), blockSize);
+			}
+		}
+	}
+
+private:
+	struct Run
+	{
+		ConversionFunc conversionFunc{};
+		int begin{}, end{};
+	};
+
+	// The connections of a destination, evaluated per block in [begin, audioRateBegin) and per sample in [audioRateBegin, end)
+	struct DestinationRange
+	{
+		int destination{};
+		int begin{}, audioRateBegin{}, end{};
+	};
+
+	bool dirty{ false };
+	std::array<bool, maxNumConnections> audioRate{};	// for each connection ID
+
+	// The compiled connections, in the order of their destinations and conversion functions
+	int count{};
+	int numAudioRateConnections{};
+	std::array<int, maxNumConnections> order{};			// connection ID of each compiled connection
+	std::array<int, maxNumConnections> slots{};			// compiled connection of each connection ID
+	std::array<int, maxNumConnections> sourceIndices{};
+	std::array<ConversionFunc, maxNumConnections> conversionFuncs{};
+	std::array<double, maxNumConnections> params{};
+	std::array<double, maxNumConnections> values{};
+	std::array<double, maxBlockSize> blockValues{};
+
+	int numRuns{};
+	std::array<Run, maxNumConnections> runs{};
+	int numDestinationRanges{};
+	std::array<DestinationRange, (numDestinations < maxNumConnections ? numDestinations : maxNumConnections)> destinationRanges{};
+	int numUsedSources{};
+	std::array<int, numSources> usedSources{};
+	std::array<double, numSources> sourceValues{};
+};
+
 }
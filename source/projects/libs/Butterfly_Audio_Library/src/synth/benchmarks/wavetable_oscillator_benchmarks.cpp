@@ -0,0 +1,46 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <vector>
+#include "wavetable_oscillator.h"
+
+using namespace Butterfly;
+
+
+namespace {
+
+constexpr double sampleRate = 44100.;
+
+// One sine table for each octave from 20 Hz, which is enough to measure the oscillator.
+std::vector<Wavetable<double>> octaveTables(size_t tableSize) {
+	std::vector<double> sine(tableSize);
+	for (size_t i = 0; i < tableSize; ++i)
+		sine[i] = std::sin(2. * std::numbers::pi * i / tableSize);
+
+	std::vector<Wavetable<double>> tables;
+	for (double maximumFrequency = 40.; maximumFrequency < sampleRate; maximumFrequency *= 2.)
+		tables.emplace_back(sine, maximumFrequency);
+	return tables;
+}
+
+}
+
+
+TEST_CASE("WavetableOscillator", "[benchmark]") {
+	for (size_t tableSize : { 256, 2048 }) {
+		auto tables = octaveTables(tableSize);
+
+		for (size_t size : { 16, 64, 512 }) {
+			std::vector<double> output(size);
+			WavetableOscillator<Wavetable<double>> oscillator{ &tables, sampleRate, 440. };
+
+			BENCHMARK("WavetableOscillator table " + std::to_string(tableSize) + " " + std::to_string(size)) {
+				for (auto& y : output) y = ++oscillator;
+				return output[0];
+			};
+		}
+	}
+}
@@ -0,0 +1,360 @@
+// Band-limited wavetables whose levels are generated on demand on a background thread.
+
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "wavetable.h"
+#include "antialiase.h"
+
+namespace Butterfly {
+
+
+/// @brief Interface of tables whose levels are built by a MipmapWorker.
+class IMipmapSource
+{
+public:
+	virtual ~IMipmapSource() = default;
+
+	/// @brief Build all levels that have been requested since the last call. Called on the thread of the worker.
+	virtual void buildRequestedLevels() = 0;
+};
+
+
+/// @brief Background thread that builds the requested levels of any number of LazyMultiWavetable's.
+///        One worker is meant to be shared by all tables of a bank, so that loading a bank does not start a thread per table.
+///
+///        Requests are made from the audio thread without locks: they only set a flag that the worker checks every millisecond.
+///        Adding and removing tables takes a lock and waits for the levels that are being built at the time.
+class MipmapWorker
+{
+public:
+	MipmapWorker() : thread(&MipmapWorker::run, this) {}
+
+	~MipmapWorker() {
+		{
+			std::lock_guard lock{ mutex };
+			quit = true;
+		}
+		condition.notify_one();
+		thread.join();
+	}
+
+	MipmapWorker(const MipmapWorker&) = delete;
+	MipmapWorker& operator=(const MipmapWorker&) = delete;
+
+	void add(IMipmapSource* source) {
+		std::lock_guard lock{ mutex };
+		sources.push_back(source);
+	}
+
+	void remove(IMipmapSource* source) {
+		std::lock_guard lock{ mutex };
+		std::erase(sources, source);
+	}
+
+	/// @brief Signal that levels have been requested. Wait-free, so this can be called on the audio thread.
+	void notify() noexcept { pending.store(true, std::memory_order_release); }
+
+	/// @brief Like notify(), but also wakes the worker right away. Not for the audio thread.
+	void wake() {
+		notify();
+		condition.notify_one();
+	}
+
+private:
+	void run() {
+		std::unique_lock lock{ mutex };
+		while (true) {
+			condition.wait_for(lock, std::chrono::milliseconds(1), [this] { return quit || pending.load(std::memory_order_acquire); });
+			if (quit) return;
+			if (pending.exchange(false, std::memory_order_acq_rel)) {
+				for (auto source : sources) source->buildRequestedLevels();
+			}
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::vector<IMipmapSource*> sources;
+	std::atomic<bool> pending{ false };
+	bool quit{ false };
+	std::thread thread;
+};
+
+
+/// @brief Cache of band-limited tables on disk, so that tables only need to be computed once
+///        (across sessions). Each table is stored in its own file in the given directory, named after the key
+///        of the table, which is a hash of the source signal, the samplerate and the maximum playback frequency.
+///
+///        Files are written to a temporary name and then renamed, so that a file is never read partially written.
+///        Invalid or unreadable files are treated as missing.
+class WavetableCache
+{
+public:
+	explicit WavetableCache(std::filesystem::path directory) : directory(std::move(directory)) {
+		std::error_code error;
+		std::filesystem::create_directories(this->directory, error);
+	}
+
+	template<std::floating_point T>
+	bool load(uint64_t key, T* data, size_t size) const {
+		std::ifstream file{ path(key), std::ios::binary };
+		if (!file) return false;
+		Header header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file || header != makeHeader<T>(key, size)) return false;
+		file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size * sizeof(T)));
+		return static_cast<bool>(file);
+	}
+
+	template<std::floating_point T>
+	void store(uint64_t key, const T* data, size_t size) const {
+		const auto target = path(key);
+		auto temporary = target;
+		temporary += ".tmp";
+		{
+			std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+			if (!file) return;
+			const auto header = makeHeader<T>(key, size);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size * sizeof(T)));
+			if (!file) return;
+		}
+		std::error_code error;
+		std::filesystem::rename(temporary, target, error);
+	}
+
+	const std::filesystem::path& getDirectory() const { return directory; }
+
+private:
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t sampleSize;
+		uint32_t reserved;
+		uint64_t size;
+		uint64_t key;
+
+		bool operator==(const Header&) const = default;
+	};
+
+	template<class T>
+	static Header makeHeader(uint64_t key, size_t size) {
+		return { { 'B', 'F', 'W', 'T' }, 1, static_cast<uint32_t>(sizeof(T)), 0, static_cast<uint64_t>(size), key };
+	}
+
+	std::filesystem::path path(uint64_t key) const {
+		static constexpr char digits[] = "0123456789abcdef";
+		std::string name(16, '0');
+		for (int i = 15; i >= 0; --i, key >>= 4) name[i] = digits[key & 0xf];
+		return directory / (name + ".bfwt");
+	}
+
+	std::filesystem::path directory;
+};
+
+
+namespace detail {
+
+// 64-bit FNV-1a
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+	const auto bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+template<class T>
+uint64_t hashValue(const T& value, uint64_t hash) {
+	unsigned char bytes[sizeof(T)];
+	std::memcpy(bytes, &value, sizeof(T));
+	return hashBytes(bytes, sizeof(T), hash);
+}
+
+} // namespace detail
+
+
+/// @brief Multiple band-limited versions of one signal for a WavetableOscillator, like the tables that
+///        antialiase() produces, but all except the one for the highest frequency are only generated when they
+///        are first played. The spectrum of the signal is computed once at construction and each level then only
+///        takes an inverse FFT, which runs on the thread of the given MipmapWorker. Until a level is ready,
+///        the nearest ready level for a higher frequency is played, which has fewer harmonics and so does not
+///        aliase either. The level for the highest frequency is always ready.
+///
+///        With a WavetableCache, levels are read from and written to disk in the background as well.
+///
+///        The levels are used with a WavetableOscillator like a multi-table of Wavetable's:
+/// \code
+///     MipmapWorker worker;
+///     LazyMultiWavetable<double, 2048> table{ signal.begin(), freqs.begin(), freqs.end(), 44100., fftCalculator, worker };
+///     using Table = LazyMultiWavetable<double, 2048>;
+///     WavetableOscillator<Table::Level, Table::storage_type> osc{ &table.getLevels(), 44100., 200. };
+/// \endcode
+///
+///        The table registers itself with the worker, so it cannot be copied or moved, and the worker and the
+///        FFT calculator need to outlive it.
+///
+/// @tparam T            Sample type
+/// @tparam tableSize    Size of the signal (needs to be a power of 2)
+/// @tparam Interpolator Interpolator type, e.g. HermiteInterpolator or LinearInterpolator
+template<std::floating_point T, int tableSize, class Interpolator = HermiteInterpolator>
+class LazyMultiWavetable : public IMipmapSource
+{
+public:
+	using value_type = T;
+	using table_type = Wavetable<T, Interpolator>;
+
+	/// @brief One band-limited level, with the interface of a Wavetable.
+	class Level
+	{
+	public:
+		using value_type = T;
+		using interpolator_type = Interpolator;
+
+		// Parameter needs to be in [0, size)
+		T operator()(T position) {
+			if (state.load(std::memory_order_acquire) == ready) return table(position);
+			owner->request(index);
+			return owner->fallback(index)(position);
+		}
+
+		constexpr size_t size() const { return static_cast<size_t>(tableSize); }
+		constexpr T getMaximumPlaybackFrequency() const { return maximumPlaybackFrequency; }
+		bool isReady() const { return state.load(std::memory_order_acquire) == ready; }
+
+	private:
+		friend class LazyMultiWavetable;
+
+		table_type table;
+		T maximumPlaybackFrequency{};
+		std::atomic<int> state{ idle };
+		LazyMultiWavetable* owner{};
+		size_t index{};
+	};
+
+	using storage_type = std::vector<Level>;
+
+
+	/// @param signal_first        Iterator to the first of tableSize samples of the signal
+	/// @param freq_first          Iterator to the first maximum playback frequency, in ascending order
+	/// @param freq_last           Iterator to the last maximum playback frequency
+	/// @param samplerate          Sampling rate
+	/// @param fft_calculator      FFT calculator
+	/// @param worker              Worker that the levels are built on
+	/// @param cache               Optional cache on disk, which needs to outlive the table
+	template<std::forward_iterator SignalIt, std::forward_iterator FrequencyIt>
+	LazyMultiWavetable(SignalIt signal_first,
+		FrequencyIt freq_first, FrequencyIt freq_last,
+		T samplerate,
+		const FFTCalculator<T, tableSize>& fft_calculator,
+		MipmapWorker& worker,
+		const WavetableCache* cache = nullptr)
+		: levels(static_cast<size_t>(std::distance(freq_first, freq_last))),
+		  spectrum(tableSize / 2 + 1),
+		  samplerate(samplerate),
+		  fftCalculator(fft_calculator),
+		  worker(worker),
+		  cache(cache) {
+
+		assert(!levels.empty());
+		std::vector<T> signal(signal_first, std::next(signal_first, tableSize));
+
+		tableHash = detail::hashValue(sizeof(T), detail::hashValue(tableSize, detail::hashValue(samplerate, detail::hashBytes(signal.data(), signal.size() * sizeof(T)))));
+
+		fftCalculator.rfft(signal.begin(), spectrum.begin());
+
+		auto freq_it = freq_first;
+		for (size_t i = 0; i < levels.size(); ++i, ++freq_it) {
+			levels[i].maximumPlaybackFrequency = *freq_it;
+			levels[i].owner = this;
+			levels[i].index = i;
+		}
+
+		// the level for the highest frequency serves as the fallback for all others
+		build(levels.size() - 1);
+
+		worker.add(this);
+	}
+
+	~LazyMultiWavetable() override { worker.remove(this); }
+
+	LazyMultiWavetable(const LazyMultiWavetable&) = delete;
+	LazyMultiWavetable& operator=(const LazyMultiWavetable&) = delete;
+
+	storage_type& getLevels() { return levels; }
+	const storage_type& getLevels() const { return levels; }
+
+	/// @brief Request all levels to be built in the background, e.g. when a table is selected for playback.
+	void prepare() {
+		for (size_t i = 0; i < levels.size(); ++i) request(i);
+		worker.wake();
+	}
+
+	bool isReady() const {
+		return std::all_of(levels.begin(), levels.end(), [](const Level& level) { return level.isReady(); });
+	}
+
+	/// @brief Key of the given level in a WavetableCache.
+	uint64_t getCacheKey(size_t level) const { return detail::hashValue(levels[level].maximumPlaybackFrequency, tableHash); }
+
+	void buildRequestedLevels() override {
+		for (size_t i = 0; i < levels.size(); ++i) {
+			if (levels[i].state.load(std::memory_order_acquire) == requested) build(i);
+		}
+	}
+
+private:
+	static constexpr int idle = 0, requested = 1, ready = 2;
+
+	// Wait-free, called on the audio thread
+	void request(size_t level) {
+		int expected = idle;
+		if (levels[level].state.compare_exchange_strong(expected, requested, std::memory_order_acq_rel)) worker.notify();
+	}
+
+	table_type& fallback(size_t level) {
+		for (size_t i = level + 1; i < levels.size(); ++i) {
+			if (levels[i].isReady()) return levels[i].table;
+		}
+		return levels.back().table;
+	}
+
+	void build(size_t level) {
+		auto& l = levels[level];
+		std::vector<T> data(tableSize);
+		const auto key = getCacheKey(level);
+		if (!cache || !cache->load(key, data.data(), data.size())) {
+			std::vector<std::complex<T>> copy(spectrum);
+			antialiase_rdft(copy.begin(), copy.end(), samplerate, l.maximumPlaybackFrequency);
+			fftCalculator.irfft(copy.begin(), data.begin());
+			if (cache) cache->store(key, data.data(), data.size());
+		}
+		l.table.setData(data.begin(), data.end(), l.maximumPlaybackFrequency);
+		l.state.store(ready, std::memory_order_release);
+	}
+
+	storage_type levels;
+	std::vector<std::complex<T>> spectrum;
+	T samplerate;
+	const FFTCalculator<T, tableSize>& fftCalculator;
+	MipmapWorker& worker;
+	const WavetableCache* cache;
+	uint64_t tableHash{};
+};
+
+
+}
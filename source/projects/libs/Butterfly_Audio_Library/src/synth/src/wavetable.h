@@ -4,20 +4,49 @@
 
 #pragma once
 #include <cmath>
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <vector>
 #include <cassert>
+#include <span>
+#include <type_traits>
 #include "interpolation.h"
+#include "aligned_allocator.h"
 
 namespace Butterfly {
 
 
+namespace detail {
+
+// Interpolate the padded samples data[0, size) around index. The samples may be stored with less
+// precision than the positions (e.g. float samples and double phase); they are then converted through
+// a few values on the stack, so that the interpolators only ever see one type.
+template<class Interpolator, class T, class Storage>
+constexpr T interpolateStored(const Storage* data, size_t size, size_t index, T offset) {
+	if constexpr (std::is_same_v<T, Storage>) {
+		return Interpolator::interpolate(std::span<const T>{ data, size }, index, offset);
+	} else {
+		constexpr auto pre = Interpolator::getLookbehindLength();
+		constexpr auto post = Interpolator::getLookaheadLength();
+		std::array<T, pre + 1 + post> points;
+		for (size_t i = 0; i < points.size(); ++i) points[i] = static_cast<T>(data[index - pre + i]);
+		return Interpolator::interpolate(points, pre, offset);
+	}
+}
+
+}
+
+
 /// @brief Wavetable class with
 ///         - dynamic length
 ///         - access function for arbitrary (floating point) positions
 ///         - hermite interpolation
 ///         - improved performance with avoided internal wrapping
 ///         - a maximum recommended frequency for playback can be specified (defaults to 1Hz) for use in antialiased oscillators
+///         - storage aligned to a cache line, optionally in a narrower type than the positions
+///           (e.g. Wavetable<double, HermiteInterpolator, float> halves the memory of a double table
+///           while the phase keeps double precision)
 /// Usage example:
 /// 
 /// 	\code
@@ -29,12 +58,14 @@ namespace Butterfly {
 /// 
 /// @tparam T Value type
 /// @tparam Interpolator Interpolator type, e.g. HermiteInterpolator or LinearInterpolator
-template<class T, class Interpolator = HermiteInterpolator>
+/// @tparam Storage Type the samples are stored as
+template<class T, class Interpolator = HermiteInterpolator, class Storage = T>
 class Wavetable
 {
 public:
 	using value_type = T;
 	using interpolator_type = Interpolator;
+	using storage_type = Storage;
 
 	constexpr Wavetable() = default;
 
@@ -71,7 +102,7 @@ public:
 		const T pos = static_cast<T>(std::floor(position));
 		const size_t index = static_cast<size_t>(pos) + Interpolator::getLookbehindLength();
 		const T offset = position - pos;
-		return Interpolator::interpolate(data, index, offset);
+		return detail::interpolateStored<Interpolator>(data.data(), data.size(), index, offset);
 	}
 
 
@@ -79,8 +110,125 @@ public:
 	constexpr T getMaximumPlaybackFrequency() const { return maximumPlaybackFrequency; }
 
 private:
-	std::vector<T> data;
+	std::vector<Storage, AlignedAllocator<Storage>> data;
 	T maximumPlaybackFrequency{};
 };
 
+
+/// @brief All levels of a band-limited table (like the tables that antialiase() produces) packed
+///        into one cache-aligned buffer, in ascending order of frequency. Switching to another level
+///        when the frequency changes then stays within one allocation instead of jumping across the
+///        heap, and every level starts on a cache line. The samples may be stored as float while the
+///        oscillator keeps a double phase.
+///
+///        The levels are used with a WavetableOscillator like a multi-table of Wavetable's:
+/// \code
+///     using Table = PackedMultiWavetable<double, HermiteInterpolator, float>;
+///     Table table{ data.begin(), data.end(), freqs.begin() }; // data holds one range of samples per level
+///     WavetableOscillator<Table::Level, Table::storage_type> osc{ &table.getLevels(), 44100., 200. };
+/// \endcode
+///
+///        The levels point into the buffer, so the table can be moved but not copied.
+///
+/// @tparam T            Value type of positions and results
+/// @tparam Interpolator Interpolator type, e.g. HermiteInterpolator or LinearInterpolator
+/// @tparam Storage      Type the samples are stored as
+template<class T, class Interpolator = HermiteInterpolator, class Storage = T>
+class PackedMultiWavetable
+{
+public:
+	using value_type = T;
+
+	/// @brief One band-limited level, with the interface of a Wavetable.
+	class Level
+	{
+	public:
+		using value_type = T;
+		using interpolator_type = Interpolator;
+		using storage_type = Storage;
+
+		// Parameter needs to be in [0, size)
+		constexpr T operator()(T position) const {
+			const T pos = static_cast<T>(std::floor(position));
+			const size_t index = static_cast<size_t>(pos) + Interpolator::getLookbehindLength();
+			return detail::interpolateStored<Interpolator>(data, paddedSize, index, position - pos);
+		}
+
+		constexpr size_t size() const { return paddedSize - Interpolator::getLookbehindLength() - Interpolator::getLookaheadLength(); }
+		constexpr T getMaximumPlaybackFrequency() const { return maximumPlaybackFrequency; }
+
+	private:
+		friend class PackedMultiWavetable;
+
+		const Storage* data{};
+		size_t paddedSize{};
+		T maximumPlaybackFrequency{};
+	};
+
+	using storage_type = std::vector<Level>;
+
+	PackedMultiWavetable() = default;
+
+	/// @param data_first Iterator to the range of samples of the first level
+	/// @param data_last  Iterator past the range of samples of the last level
+	/// @param freq_first Iterator to the maximum playback frequency of the first level
+	template<std::forward_iterator DataIt, std::forward_iterator FrequencyIt>
+	PackedMultiWavetable(DataIt data_first, DataIt data_last, FrequencyIt freq_first) {
+		setData(data_first, data_last, freq_first);
+	}
+
+	PackedMultiWavetable(const PackedMultiWavetable&) = delete;
+	PackedMultiWavetable& operator=(const PackedMultiWavetable&) = delete;
+	PackedMultiWavetable(PackedMultiWavetable&&) = default;
+	PackedMultiWavetable& operator=(PackedMultiWavetable&&) = default;
+
+	/// @brief Copy the samples of all levels into the buffer, which is allocated once for all of them.
+	template<std::forward_iterator DataIt, std::forward_iterator FrequencyIt>
+	void setData(DataIt data_first, DataIt data_last, FrequencyIt freq_first) {
+		constexpr auto pre = Interpolator::getLookbehindLength();
+		constexpr auto post = Interpolator::getLookaheadLength();
+		constexpr size_t lineSamples = std::max<size_t>(1, cacheLineSize / sizeof(Storage));
+
+		// lay out the levels first so that the buffer is only allocated once
+		std::vector<size_t> offsets;
+		size_t total = 0;
+		for (auto it = data_first; it != data_last; ++it) {
+			const auto size = static_cast<size_t>(std::distance(std::begin(*it), std::end(*it)));
+			assert(size >= pre && size >= post && size > 0);
+			offsets.push_back(total);
+			total += (size + pre + post + lineSamples - 1) / lineSamples * lineSamples;
+		}
+		assert(!offsets.empty());
+
+		samples.assign(total, Storage{});
+		levels.resize(offsets.size());
+
+		auto freq_it = freq_first;
+		size_t i = 0;
+		for (auto it = data_first; it != data_last; ++it, ++freq_it, ++i) {
+			const auto first = std::begin(*it);
+			const auto last = std::end(*it);
+			const auto size = static_cast<size_t>(std::distance(first, last));
+			Storage* level = samples.data() + offsets[i];
+			std::copy(std::prev(last, pre), last, level);
+			std::copy(first, last, level + pre);
+			std::copy(first, std::next(first, post), level + pre + size);
+
+			levels[i].data = level;
+			levels[i].paddedSize = size + pre + post;
+			levels[i].maximumPlaybackFrequency = static_cast<T>(*freq_it);
+		}
+	}
+
+	storage_type& getLevels() { return levels; }
+	const storage_type& getLevels() const { return levels; }
+
+	/// @brief Memory of the samples of all levels in bytes.
+	size_t memorySize() const { return samples.size() * sizeof(Storage); }
+
+private:
+	std::vector<Storage, AlignedAllocator<Storage>> samples;
+	storage_type levels;
+};
+
 }
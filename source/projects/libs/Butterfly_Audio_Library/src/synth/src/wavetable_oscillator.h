@@ -4,11 +4,15 @@
 
 
 #pragma once
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <span>
+#include <vector>
 #include "wavetable.h"
 #include "antialiase.h"
 #include "fixed_point.h"
+#include "optimized_math.h"
 
 namespace Butterfly {
 
@@ -31,6 +35,58 @@ struct ForwardSearchTableSelector
 };
 
 
+/// @brief Table selector for tables whose maximum playback frequencies are spaced by
+///        octaves, i.e. table i may be played up to 2^i times the maximum frequency of
+///        the first table. The index is computed from the exponent of the frequency ratio
+///        in constant time instead of searching through the tables.
+///
+///        Requires random access iterators. For tables that are not octave-spaced, use
+///        ForwardSearchTableSelector.
+struct OctaveTableSelector
+{
+	template<std::random_access_iterator Iterator, class T>
+	static Iterator selectTable(Iterator begin, Iterator end, T frequency) {
+		const auto count = static_cast<int>(end - begin);
+		const auto ratio = static_cast<double>(frequency) / static_cast<double>(begin->getMaximumPlaybackFrequency());
+		if (!(ratio > 0.0)) return begin;
+		return begin + std::clamp(ceilLog2(ratio), 0, count);
+	}
+};
+
+
+/// @brief Pair of adjacent tables and the amount of the second one to blend in, as
+///        returned by CrossfadingOctaveTableSelector::selectTables().
+template<class Iterator, class T>
+struct TableBlend
+{
+	Iterator lower, upper;
+	T blend{}; // 0 plays only lower, 1 only upper
+};
+
+
+/// @brief Table selector for octave-spaced tables (like OctaveTableSelector) that selects
+///        the table for the given frequency along with the next one. Across the octave below
+///        the maximum frequency of the selected table, the blend rises linearly in frequency
+///        from 0 to 1, so the harmonics fade out gradually instead of dropping out at once
+///        when the oscillator switches tables. Both tables are played within their range,
+///        so the blend never aliases.
+struct CrossfadingOctaveTableSelector
+{
+	template<std::random_access_iterator Iterator, class T>
+	static TableBlend<Iterator, T> selectTables(Iterator begin, Iterator end, T frequency) {
+		const auto last = static_cast<int>(end - begin) - 1;
+		const auto f0 = static_cast<double>(begin->getMaximumPlaybackFrequency());
+		const auto ratio = static_cast<double>(frequency) / f0;
+		if (!(ratio > 0.0)) return { begin, begin + std::min(1, last), T(0) };
+
+		const int index = std::clamp(ceilLog2(ratio), 0, last);
+		const double octaveStart = std::ldexp(f0, index - 1);
+		const double blend = std::clamp(static_cast<double>(frequency) / octaveStart - 1.0, 0.0, 1.0);
+		return { begin + index, begin + std::min(index + 1, last), static_cast<T>(blend) };
+	}
+};
+
+
 /// @brief Wavetable oscillator wrapping access to multiple wavetables depending on the
 ///        frequency used (i.e. in order to prevent aliasing).
 ///
@@ -196,6 +252,126 @@ private:
 
 	double topFreq{}, bottomFreq{}; // Frequency interval of current table
 };
+/// @brief Wavetable oscillator for octave-spaced tables that crossfades between the two
+///        tables selected by a CrossfadingOctaveTableSelector instead of switching between
+///        them. This removes the audible step in brightness when sweeping across table
+///        boundaries, at the cost of two table reads per sample.
+///
+///        The phase is kept normalized to [0, 1) so that the tables may differ in size.
+///        It offers the same interface as WavetableOscillator and can thus also be used
+///        with MorpingWavetableOscillator.
+///
+/// @tparam Wavetable Wavetable class (needs to feature size_t size(), T get(T) and getMaximumPlaybackFrequency()).
+/// @tparam StorageType Random access storage for the tables, sorted ascending by frequency.
+template<class Wavetable, class StorageType = std::vector<Wavetable>, class TableSelector = CrossfadingOctaveTableSelector, class ParamType = double>
+class CrossfadingWavetableOscillator
+{
+public:
+	using wavetable_type = Wavetable;
+	using multiwavetable_type = StorageType;
+	using value_type = typename Wavetable::value_type;
+	using param_type = ParamType;
+	using T = value_type;
+
+	constexpr CrossfadingWavetableOscillator() = default;
+	constexpr CrossfadingWavetableOscillator(ParamType sampleRate) : sampleRateInv(ParamType{ 1 } / sampleRate) {}
+
+	constexpr CrossfadingWavetableOscillator(StorageType* wavetables, ParamType sampleRate, ParamType frequency)
+		: sampleRateInv(1.0 / sampleRate),
+		  frequency(frequency) {
+		setTable(wavetables);
+	}
+
+	constexpr void setTable(StorageType* wavetables) {
+		this->wavetables = wavetables;
+		setFrequency(frequency);
+	}
+
+	constexpr void setSampleRate(ParamType sampleRate) {
+		this->sampleRateInv = 1.0 / sampleRate;
+		setFrequency(frequency);
+	}
+
+	constexpr void setFrequency(ParamType frequency) {
+		this->frequency = frequency;
+		assert(frequency * sampleRateInv < 1.0 && "The frequency needs to be lower that the sample rate");
+		assert(wavetables);
+		assert(wavetables->size() > 0);
+
+		const auto selection = TableSelector::selectTables(wavetables->begin(), wavetables->end(), static_cast<T>(frequency));
+		lowerTable = &(*selection.lower);
+		upperTable = &(*selection.upper);
+		lowerTableSize = static_cast<double>(lowerTable->size());
+		upperTableSize = static_cast<double>(upperTable->size());
+		assert(lowerTableSize > 0 && upperTableSize > 0 && "Size of wavetables may not be zero");
+		blend = selection.blend;
+		phaseIncrement = static_cast<double>(frequency * sampleRateInv);
+		value = read();
+	}
+
+	/// @brief Increment the oscillator by one step and get the current value.
+	/// @return current value
+	constexpr T operator++() {
+		advance();
+		value = read();
+		return value;
+	}
+
+	/// @brief Increment the oscillator by one step and get the former current value.
+	/// @return former value
+	constexpr T operator++(int) {
+		const auto tmp = value;
+		advance();
+		value = read();
+		return tmp;
+	}
+
+	/// @brief Get current value of the oscillator without changing its state.
+	/// @return current value
+	constexpr T operator()() const { return value; }
+
+	/// @brief Reset the phase to 0. Also updates the current value.
+	constexpr void retrigger() {
+		phase = 0;
+		value = read();
+	}
+
+	constexpr void reset() { retrigger(); }
+	constexpr Wavetable* getSelectedTable() const { return blend < T(0.5) ? lowerTable : upperTable; }
+	constexpr T getBlend() const { return blend; }
+	constexpr ParamType getFrequency() const { return frequency; }
+	constexpr ParamType getSampleRate() const { return ParamType{ 1 } / sampleRateInv; }
+
+private:
+	constexpr void advance() {
+		phase += phaseIncrement;
+		if (phase >= 1.0) {
+			phase -= 1.0;
+		}
+	}
+
+	constexpr T read() const {
+		const T a = (*lowerTable)(static_cast<T>(phase * lowerTableSize));
+		const T b = (*upperTable)(static_cast<T>(phase * upperTableSize));
+		return a + blend * (b - a);
+	}
+
+
+	ParamType sampleRateInv{};
+	ParamType frequency{};
+	double phaseIncrement{};
+	double phase{};
+
+	T value{};
+	T blend{};
+
+	StorageType* wavetables{};
+	Wavetable* lowerTable{};
+	Wavetable* upperTable{};
+	double lowerTableSize{}, upperTableSize{};
+};
+
+
 //
 // Oscillator with phase in [0,1)
 //
@@ -449,6 +625,9 @@ private:
 /// @brief Wavetable oscillator for morphing between two wavetables. A parameter in the interval
 ///        [0, 1] is used to blend between the first and the second table.
 ///
+///        Both oscillators advance and select their tables separately. For tables with the
+///        same layout, MorphingWavetableStackOscillator shares the phase and the selection.
+///
 /// @tparam WavetableOscillator Wavetable oscillator class
 template<class WavetableOscillator>
 class MorpingWavetableOscillator
@@ -521,6 +700,198 @@ private:
 };
 
 
+/// @brief Wavetable oscillator that morphs across a stack of multiwavetables with a single
+///        phase accumulator. Unlike MorpingWavetableOscillator, which advances and selects the
+///        tables of two complete oscillators, the table is selected once on the first set and
+///        the same level is read from the neighboring sets at the same position. With a stack
+///        of two sets, this is a cheaper replacement for MorpingWavetableOscillator.
+///
+///        All sets in the stack need the same layout: the same number of tables, and at each
+///        level the same size and maximum playback frequency (e.g. antialiased with the same
+///        frequencies). The morph parameter runs from 0 (first set) to count - 1 (last set);
+///        per sample, only the two sets around it are interpolated.
+///
+///        setTables() allocates; everything else may be called on the audio thread.
+///
+/// Usage example:
+/// \code
+///     std::vector<Wavetable<double>> saw(10), square(10), sine(10);
+///     // fill tables with the same frequencies
+///     std::array stack{ &saw, &square, &sine };
+///     MorphingWavetableStackOscillator<Wavetable<double>> osc{ stack, 44100., 200. };
+///     osc.setMorph(1.5); // halfway between square and sine
+///     auto sample = ++osc;
+/// \endcode
+///
+/// @tparam Wavetable Wavetable class (needs to feature size_t size(), T get(T) and getMaximumPlaybackFrequency()).
+/// @tparam StorageType Random access storage for the tables of one set, sorted ascending by frequency.
+/// @tparam TableSelector Functor which is used to select the ideal table for the current playback frequency.
+template<class Wavetable, class StorageType = std::vector<Wavetable>, class TableSelector = ForwardSearchTableSelector, class ParamType = double>
+class MorphingWavetableStackOscillator
+{
+public:
+	using wavetable_type = Wavetable;
+	using multiwavetable_type = StorageType;
+	using value_type = typename Wavetable::value_type;
+	using param_type = ParamType;
+	using T = value_type;
+
+	constexpr MorphingWavetableStackOscillator() = default;
+	constexpr MorphingWavetableStackOscillator(ParamType sampleRate) : sampleRateInv(ParamType{ 1 } / sampleRate) {}
+
+	MorphingWavetableStackOscillator(std::span<StorageType* const> stack, ParamType sampleRate, ParamType frequency)
+		: sampleRateInv(1.0 / sampleRate),
+		  frequency(frequency) {
+		setTables(stack);
+	}
+
+	/// @brief Set the stack of multiwavetables to morph across. The pointers are copied,
+	///        the tables themselves need to outlive the oscillator.
+	void setTables(std::span<StorageType* const> stack) {
+		assert(stack.size() > 0);
+		this->stack.assign(stack.begin(), stack.end());
+		for ([[maybe_unused]] const auto* set : this->stack) {
+			assert(set->size() == this->stack[0]->size() && "All sets in the stack need the same number of tables");
+		}
+		topFreq = bottomFreq = 0.0;
+		currentTableSize = 0;
+		setMorph(std::min(morph, static_cast<ParamType>(this->stack.size() - 1)));
+		setFrequency(frequency);
+	}
+
+	constexpr void setSampleRate(ParamType sampleRate) {
+		this->sampleRateInv = 1.0 / sampleRate;
+		setFrequency(frequency);
+	}
+
+	constexpr void setFrequency(ParamType frequency) {
+		this->frequency = frequency;
+		assert(frequency * sampleRateInv < 1.0 && "The frequency needs to be lower that the sample rate");
+		selectTable();
+		delta = static_cast<double>(frequency * currentTableSize * sampleRateInv);
+	}
+
+	/// @brief Set the position in the stack, from 0 (first set) to count - 1 (last set).
+	constexpr void setMorph(ParamType morph) {
+		assert(!stack.empty());
+		const auto last = stack.size() - 1;
+		this->morph = std::clamp(morph, ParamType{ 0 }, static_cast<ParamType>(last));
+		lowerSet = std::min(static_cast<size_t>(this->morph), last);
+		upperSet = std::min(lowerSet + 1, last);
+		blend = static_cast<T>(this->morph - static_cast<ParamType>(lowerSet));
+		if (currentTableSize != 0) {
+			updateTables();
+			value = read();
+		}
+	}
+
+	/// @brief Increment the oscillator by one step and get the current value.
+	/// @return current value
+	constexpr T operator++() {
+		advance();
+		value = read();
+		return value;
+	}
+
+	/// @brief Increment the oscillator by one step and get the former current value.
+	/// @return former value
+	constexpr T operator++(int) {
+		const auto tmp = value;
+		advance();
+		value = read();
+		return tmp;
+	}
+
+	/// @brief Get current value of the oscillator without changing its state.
+	/// @return current value
+	constexpr T operator()() const { return value; }
+
+	/// @brief Reset the position/phase to 0. Also updates the current value.
+	constexpr void retrigger() {
+		currentSamplePosition = 0;
+		value = read();
+	}
+
+	constexpr void reset() { retrigger(); }
+	constexpr size_t getTableIndex() const { return tableIndex; }
+	constexpr size_t getStackSize() const { return stack.size(); }
+	constexpr ParamType getMorph() const { return morph; }
+	constexpr ParamType getFrequency() const { return frequency; }
+	constexpr ParamType getSampleRate() const { return ParamType{ 1 } / sampleRateInv; }
+
+private:
+	constexpr void advance() {
+		currentSamplePosition += delta;
+		if (currentSamplePosition >= currentTableSize) {
+			currentSamplePosition -= currentTableSize;
+		}
+	}
+
+	constexpr T read() const {
+		const auto position = static_cast<T>(currentSamplePosition);
+		const T a = (*lowerTable)(position);
+		if (lowerTable == upperTable) return a;
+		const T b = (*upperTable)(position);
+		return a + blend * (b - a);
+	}
+
+	constexpr void updateTables() {
+		lowerTable = &(*stack[lowerSet])[tableIndex];
+		upperTable = &(*stack[upperSet])[tableIndex];
+	}
+
+	constexpr void selectTable() {
+		// same reasoning as in WavetableOscillator: usually the frequency only changes a little
+		if (frequency <= topFreq && frequency > bottomFreq) return;
+
+		assert(!stack.empty());
+		auto& first = *stack[0];
+		assert(first.size() > 0);
+		auto it = TableSelector::selectTable(first.begin(), first.end(), frequency);
+		if (it == first.end()) { // No table can be selected without aliasing -> then we just get aliasing
+			it--;
+		}
+		tableIndex = static_cast<size_t>(it - first.begin());
+
+		const auto newTableSize = it->size();
+		if (currentTableSize != 0) {
+			currentSamplePosition = currentSamplePosition * static_cast<double>(newTableSize) / static_cast<double>(currentTableSize);
+			currentSamplePosition = std::max(0., std::min((newTableSize - 1.e-7), currentSamplePosition));
+		}
+		currentTableSize = newTableSize;
+		assert(currentTableSize > 0 && "Size of wavetables may not be zero");
+		for ([[maybe_unused]] const auto* set : stack) {
+			assert((*set)[tableIndex].size() == currentTableSize && "All sets in the stack need the same table sizes");
+		}
+
+		updateTables();
+		value = read();
+
+		topFreq = it->getMaximumPlaybackFrequency();
+		bottomFreq = it == first.begin() ? 0.0 : (it - 1)->getMaximumPlaybackFrequency();
+	}
+
+
+	ParamType sampleRateInv{};
+	ParamType frequency{};
+	ParamType morph{};
+	double delta{};
+	double currentSamplePosition{};
+
+	T value{};
+	T blend{}; // amount of the upper set
+
+	std::vector<StorageType*> stack;
+	size_t lowerSet{}, upperSet{};
+	size_t tableIndex{};
+	Wavetable* lowerTable{};
+	Wavetable* upperTable{};
+	size_t currentTableSize{};
+
+	double topFreq{}, bottomFreq{}; // Frequency interval of current table
+};
+
+
 
 
 
@@ -0,0 +1,311 @@
+// Bank of wavetable oscillators that are processed together, e.g. for unison stacks.
+
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <vector>
+#include "interpolation.h"
+
+namespace Butterfly {
+
+
+/// @brief Bank of wavetable oscillators that play the same set of band-limited tables (and
+///        optionally morph towards a second set like MorpingWavetableOscillator), each at its
+///        own ratio of a common frequency, e.g. the detuned voices of a unison stack.
+///
+///        Instead of one WavetableOscillator per voice, the state of all voices is held in
+///        separate arrays (phase, increment, selected table) and every sample is computed for
+///        all voices in one loop. The levels of all tables are copied into a single padded
+///        buffer, so the four points of the Hermite interpolation of every voice are read
+///        relative to one base pointer. This lets the compiler turn the loop over the voices
+///        into SIMD phase increments and gathers. As in waveform_processing.h, no intrinsics
+///        are used; the loops are shaped for auto-vectorization.
+///
+///        The tables are selected like ForwardSearchTableSelector does: the first level whose
+///        maximum playback frequency is not below the frequency of the voice. The selection is
+///        made once per block of blockSize samples, for the highest frequency in the block, so
+///        that frequency modulation within a block cannot alias. The phase is normalized to
+///        [0, 1), so the levels may differ in size and switching them does not cause jumps.
+///
+///        setTables() and setVoiceCount() allocate; everything else may be called on the
+///        audio thread.
+///
+/// Usage example:
+/// \code
+///     std::vector<Wavetable<float>> tables(10);
+///     // fill tables
+///     WavetableOscillatorBank<float> bank{ 7, 48000.f };
+///     bank.setTables(tables);
+///     bank.setRatio(1, 1.003f); // detune voices ...
+///     bank.process(frequency, outputs, frames); // outputs holds one pointer per voice
+/// \endcode
+///
+/// @tparam T Sample type
+template<std::floating_point T>
+class WavetableOscillatorBank
+{
+public:
+	using value_type = T;
+
+	/// Number of samples the tables are selected for at once.
+	static constexpr size_t blockSize = 32;
+
+	WavetableOscillatorBank() = default;
+
+	WavetableOscillatorBank(size_t voices, T sampleRate) : sampleRateInv(T(1) / sampleRate) {
+		setVoiceCount(voices);
+	}
+
+	/// @brief Set the tables of all voices. The storage needs to be sorted ascending by maximum
+	///        playback frequency, like for WavetableOscillator. Its samples are copied, so it does
+	///        not need to outlive the bank. Removes the tables to morph to.
+	template<class StorageType>
+	void setTables(StorageType& tables) {
+		samples.clear();
+		first = addTableSet(tables);
+		second = {};
+		morph = T(0);
+		selectAll();
+	}
+
+	/// @brief Set the tables of all voices and the tables to morph to (see setMorph()).
+	template<class StorageType1, class StorageType2>
+	void setTables(StorageType1& firstTables, StorageType2& secondTables) {
+		samples.clear();
+		first = addTableSet(firstTables);
+		second = addTableSet(secondTables);
+		selectAll();
+	}
+
+	/// @brief Set the number of voices. Voices that are added have a ratio of 1 and a phase of 0.
+	void setVoiceCount(size_t voices) {
+		// the arrays are padded to whole groups of lanes with voices that are computed but not output
+		const size_t padded = (voices + lanes - 1) / lanes * lanes;
+		ratio.resize(padded);
+		phase.resize(padded);
+		std::fill(ratio.begin() + std::min(voices_, padded), ratio.end(), T(1));
+		std::fill(phase.begin() + std::min(voices_, padded), phase.end(), T(0));
+		firstVoices.resize(padded);
+		secondVoices.resize(padded);
+		scratch.resize(padded * (blockSize + 1));
+		voices_ = voices;
+		selectAll();
+	}
+
+	void setSampleRate(T sampleRate) { sampleRateInv = T(1) / sampleRate; }
+
+	/// @brief Set the frequency of a voice relative to the frequency passed to process().
+	void setRatio(size_t voice, T ratio) {
+		assert(voice < voiceCount());
+		this->ratio[voice] = ratio;
+	}
+
+	/// @brief Set the phase of a voice, in [0, 1).
+	void setPhase(size_t voice, T phase) {
+		assert(voice < voiceCount());
+		const T p = phase - std::floor(phase);
+		this->phase[voice] = p < T(1) ? p : T(0);
+	}
+
+	/// @brief Blend between the first (0) and the second (1) set of tables.
+	void setMorph(T morph) { this->morph = std::clamp(morph, T(0), T(1)); }
+
+	/// @brief Reset the phases of all voices to 0.
+	void retrigger() { std::fill(phase.begin(), phase.end(), T(0)); }
+
+	/// @brief Compute frames samples of every voice at a constant frequency.
+	/// @param frequency Frequency that the ratios of the voices refer to
+	/// @param outputs   Pointers to one output buffer per voice
+	void process(T frequency, T* const* outputs, size_t frames) {
+		processBlocks(outputs, frames, [frequency](size_t, size_t) { return frequency; }, [frequency](size_t) { return frequency; });
+	}
+
+	/// @brief Compute frames samples of every voice, following a frequency per sample.
+	/// @param frequency Frequency that the ratios of the voices refer to, one per frame
+	/// @param outputs   Pointers to one output buffer per voice
+	void process(const T* frequency, T* const* outputs, size_t frames) {
+		processBlocks(
+			outputs, frames,
+			[frequency](size_t begin, size_t end) {
+				T highest = std::abs(frequency[begin]);
+				for (size_t i = begin + 1; i < end; ++i) highest = std::max(highest, std::abs(frequency[i]));
+				return highest;
+			},
+			[frequency](size_t i) { return frequency[i]; });
+	}
+
+	size_t voiceCount() const { return voices_; }
+	T getRatio(size_t voice) const { return ratio[voice]; }
+	T getPhase(size_t voice) const { return phase[voice]; }
+	T getMorph() const { return morph; }
+	T getSampleRate() const { return T(1) / sampleRateInv; }
+
+private:
+	// Number of voices that are interpolated together, see readVoices().
+	static constexpr size_t lanes = 8;
+
+	// Hermite interpolation reads one sample before and two after the position.
+	static constexpr size_t lookbehind = 1;
+	static constexpr size_t lookahead = 2;
+
+	struct TableSet
+	{
+		std::vector<int32_t> offsets; // of the first sample of each level in samples
+		std::vector<T> sizes;
+		std::vector<T> maxFrequencies;
+
+		bool empty() const { return offsets.empty(); }
+	};
+
+	// The level that each voice currently reads, as arrays over the voices
+	struct VoiceTables
+	{
+		std::vector<int32_t> offsets;
+		std::vector<T> sizes;
+
+		void resize(size_t voices) {
+			offsets.resize(voices, 0);
+			sizes.resize(voices, T(0));
+		}
+	};
+
+	template<class StorageType>
+	TableSet addTableSet(StorageType& tables) {
+		assert(tables.size() > 0);
+		TableSet set;
+		for (auto& table : tables) {
+			const auto size = table.size();
+			assert(size > 0 && "Size of wavetables may not be zero");
+			const auto offset = samples.size() + lookbehind;
+			samples.resize(offset + size + lookahead);
+			// any interpolator reproduces the samples themselves at integer positions
+			for (size_t i = 0; i < size; ++i) samples[offset + i] = table(static_cast<typename std::decay_t<decltype(table)>::value_type>(i));
+			for (size_t i = 0; i < lookbehind; ++i) samples[offset - lookbehind + i] = samples[offset + size - lookbehind + i];
+			for (size_t i = 0; i < lookahead; ++i) samples[offset + size + i] = samples[offset + i];
+
+			set.offsets.push_back(static_cast<int32_t>(offset));
+			set.sizes.push_back(static_cast<T>(size));
+			set.maxFrequencies.push_back(static_cast<T>(table.getMaximumPlaybackFrequency()));
+		}
+		assert(samples.size() <= static_cast<size_t>(INT32_MAX));
+		return set;
+	}
+
+	static void select(const TableSet& set, VoiceTables& voices, size_t voice, T frequency) {
+		auto it = std::lower_bound(set.maxFrequencies.begin(), set.maxFrequencies.end(), frequency);
+		if (it == set.maxFrequencies.end()) { // No table can be selected without aliasing -> then we just get aliasing
+			--it;
+		}
+		const auto level = static_cast<size_t>(it - set.maxFrequencies.begin());
+		voices.offsets[voice] = set.offsets[level];
+		voices.sizes[voice] = set.sizes[level];
+	}
+
+	void selectTables(T frequency) {
+		for (size_t v = 0; v < paddedVoiceCount(); ++v) {
+			const auto voiceFrequency = std::abs(frequency * ratio[v]);
+			select(first, firstVoices, v, voiceFrequency);
+			if (!second.empty()) select(second, secondVoices, v, voiceFrequency);
+		}
+	}
+
+	void selectAll() {
+		if (!first.empty()) selectTables(T(0));
+	}
+
+	template<class HighestFrequency, class Frequency>
+	void processBlocks(T* const* outputs, size_t frames, HighestFrequency&& highestFrequency, Frequency&& frequencyAt) {
+		assert(!first.empty() && "The tables need to be set before processing");
+		const size_t voices = paddedVoiceCount();
+
+		for (size_t begin = 0; begin < frames; begin += blockSize) {
+			const size_t end = std::min(begin + blockSize, frames);
+			const T highest = highestFrequency(begin, end);
+			assert(highest * sampleRateInv < T(1) && "The frequency needs to be lower that the sample rate");
+			selectTables(highest);
+
+			for (size_t i = begin; i < end; ++i) {
+				const T delta = frequencyAt(i) * sampleRateInv;
+				T* out = scratch.data() + (i - begin) * voices;
+				advanceVoices(delta);
+				readVoices(firstVoices, out);
+				if (!second.empty() && morph > T(0)) {
+					T* other = scratch.data() + voices * blockSize;
+					readVoices(secondVoices, other);
+					for (size_t v = 0; v < voices; ++v) {
+						out[v] += morph * (other[v] - out[v]);
+					}
+				}
+			}
+
+			// transpose the block from frame-major to one buffer per voice
+			for (size_t v = 0; v < voiceCount(); ++v) {
+				T* out = outputs[v] + begin;
+				for (size_t i = 0; i < end - begin; ++i) out[i] = scratch[i * voices + v];
+			}
+		}
+	}
+
+	size_t paddedVoiceCount() const { return phase.size(); }
+
+	// The loops over the voices below read the state through local pointers so that the
+	// compiler does not need to assume that the output aliases it, which prevents vectorization.
+
+	void advanceVoices(T delta) {
+		const T* ratios = ratio.data();
+		T* phases = phase.data();
+		const size_t voices = paddedVoiceCount();
+		for (size_t v = 0; v < voices; ++v) {
+			T p = phases[v] + delta * ratios[v];
+			// wrap into [0, 1); std::floor() would keep GCC from vectorizing unless -fno-trapping-math is set
+			p -= static_cast<T>(static_cast<int32_t>(p));
+			p += p < T(0) ? T(1) : T(0);
+			phases[v] = p < T(1) ? p : T(0); // p + 1 rounds to 1 for tiny negative p
+		}
+	}
+
+	// The voices are interpolated in groups of lanes into a local array. As it cannot alias the
+	// table, the compiler may read the samples with gather instructions (where the target tuning
+	// allows them) without having to check for overlap at runtime, which it cannot do for gathers.
+	void readVoices(const VoiceTables& tables, T* out) const {
+		const T* phases = phase.data();
+		const T* sizes = tables.sizes.data();
+		const int32_t* offsets = tables.offsets.data();
+		const T* data = samples.data();
+		const size_t voices = paddedVoiceCount();
+		for (size_t first = 0; first < voices; first += lanes) {
+			std::array<T, lanes> y;
+			for (size_t lane = 0; lane < lanes; ++lane) {
+				const size_t v = first + lane;
+				const T position = phases[v] * sizes[v];
+				const auto index = static_cast<int32_t>(position); // position is not negative, so this truncation is floor()
+				const T t = position - static_cast<T>(index);
+				const int32_t j = offsets[v] + index;
+				y[lane] = hermite_interpolation(t, data[j - 1], data[j], data[j + 1], data[j + 2]);
+			}
+			std::copy(y.begin(), y.end(), out + first);
+		}
+	}
+
+
+	T sampleRateInv{};
+	T morph{};
+	size_t voices_{};
+
+	// per voice
+	std::vector<T> ratio, phase;
+	VoiceTables firstVoices, secondVoices;
+
+	// the levels of both table sets, each padded for the interpolation
+	std::vector<T> samples;
+	TableSet first, second;
+
+	std::vector<T> scratch; // blockSize frames of all voices, and the voices of the morph target
+};
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+
+#include <cstddef>
+#include <new>
+
+namespace Butterfly {
+
+
+/// @brief Size of a cache line on the targeted platforms, used as the default alignment of
+///        AlignedAllocator.
+inline constexpr size_t cacheLineSize = 64;
+
+
+/// @brief Allocator for standard containers that aligns the storage to the given boundary, e.g. so
+///        that a table starts on a cache line and SIMD loads of its beginning do not straddle two lines.
+///        Memory comes from the aligned forms of operator new, so it is not suited for the audio thread.
+///
+/// @tparam T         Value type.
+/// @tparam alignment Alignment in bytes, a power of 2 not less than alignof(T).
+template<class T, size_t alignment = cacheLineSize>
+class AlignedAllocator
+{
+	static_assert((alignment & (alignment - 1)) == 0 && alignment >= alignof(T), "Invalid alignment");
+
+public:
+	using value_type = T;
+
+	template<class U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, alignment>;
+	};
+
+	constexpr AlignedAllocator() noexcept = default;
+
+	template<class U>
+	constexpr AlignedAllocator(const AlignedAllocator<U, alignment>&) noexcept {}
+
+	T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ alignment })); }
+	void deallocate(T* p, size_t) noexcept { ::operator delete(p, std::align_val_t{ alignment }); }
+
+	template<class U>
+	constexpr bool operator==(const AlignedAllocator<U, alignment>&) const noexcept { return true; }
+};
+
+}
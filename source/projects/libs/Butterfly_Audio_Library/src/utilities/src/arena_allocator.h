@@ -0,0 +1,79 @@
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace Butterfly {
+
+
+/// @brief Monotonic arena that hands out memory from a buffer which is allocated once at construction
+///        (e.g. when DSP is started). Deallocation does nothing, and all memory is released at once
+///        with reset(), so allocations and deallocations never touch the system heap and take constant time.
+///        This suits temporaries of a single task, like the scratch buffers of an analysis: reset() the arena,
+///        run the task and discard its results before the next reset().
+///
+///        When the arena is exhausted, std::bad_alloc is thrown, like for any other allocator.
+///        The arena is not thread-safe.
+class MonotonicArena
+{
+public:
+	/// @param capacity Size of the buffer in bytes
+	explicit MonotonicArena(size_t capacity) : buffer(new std::byte[capacity]), capacity_(capacity) {}
+
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+	void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+		const auto address = reinterpret_cast<std::uintptr_t>(buffer.get());
+		const auto aligned = (address + used_ + alignment - 1) / alignment * alignment;
+		const auto offset = static_cast<size_t>(aligned - address);
+		if (offset > capacity_ || bytes > capacity_ - offset) throw std::bad_alloc{};
+		used_ = offset + bytes;
+		return buffer.get() + offset;
+	}
+
+	void deallocate(void*, size_t) noexcept {}
+
+	/// @brief Release all memory that has been allocated from the arena.
+	void reset() noexcept { used_ = 0; }
+
+	size_t capacity() const { return capacity_; }
+	size_t used() const { return used_; }
+
+private:
+	std::unique_ptr<std::byte[]> buffer;
+	size_t capacity_{};
+	size_t used_{};
+};
+
+
+/// @brief Allocator for standard containers that allocates from a MonotonicArena, which needs to outlive the allocator.
+///
+/// @tparam T Value type.
+template<class T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+
+	ArenaAllocator(MonotonicArena& arena) noexcept : arena(&arena) {}
+
+	template<class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.getArena()) {}
+
+	T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T* p, size_t n) noexcept { arena->deallocate(p, n * sizeof(T)); }
+
+	MonotonicArena* getArena() const noexcept { return arena; }
+
+	template<class U>
+	bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.getArena(); }
+
+private:
+	MonotonicArena* arena;
+};
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Butterfly {
+
+
+
+/// @brief Variant of StableIDVector that keeps the added items packed at the front of its storage,
+///        so that iterating over them walks contiguous memory (which is cache-friendly and allows
+///        loops over the items to be vectorized). The ids still do not change when other items are
+///        added or removed, and no allocation or deallocation is performed except during construction.
+///        The capacity is fixed and set at construction.
+///
+///        Let m be the size (number of added elements).
+///        Then the runtime cost for these operations is:
+///        - add: O(1) (no allocation, may fail when capacity is exceeded)
+///        - insert with a given id: O(1)
+///        - remove: O(1) (the last item is moved into the place of the removed one)
+///        - access by id: O(1) (one additional lookup in the map from ids to slots)
+///        - iterating over all added elements: O(m), contiguous
+///
+///        Unlike in StableIDVector, items move when other items are removed, so pointers and
+///        references to them are only valid until the next removal. The order of iteration
+///        changes on removal as well.
+///
+///        Requirements on data type T:
+///         - default-constructable
+///         - move-assignable
+///
+///
+/// @tparam T Value type.
+/// @tparam Alloc Allocator for the internal std::vector's (e.g. a PoolAllocator or ArenaAllocator
+///               to keep the storage out of the system heap)
+template<class T, class Alloc = std::allocator<T>>
+class DenseIDVector
+{
+public:
+	using value_type = T;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using reference = T&;
+	using const_reference = const T&;
+	using id_type = size_t;
+	using size_type = size_t;
+	using difference_type = ptrdiff_t;
+	using allocator_type = Alloc;
+
+	using value_container = std::vector<value_type, Alloc>;
+	using index_container = std::vector<size_type, typename std::allocator_traits<Alloc>::template rebind_alloc<size_type>>;
+
+	using iterator = pointer;
+	using const_iterator = const_pointer;
+
+
+	constexpr DenseIDVector(size_t capacity, const Alloc& alloc = Alloc())
+		: values(capacity, alloc), ids(capacity, alloc), slots(capacity, alloc) { initialize_indices(); }
+
+	constexpr const_iterator begin() const { return values.data(); }
+	constexpr iterator begin() { return values.data(); }
+	constexpr const_iterator end() const { return values.data() + size_; }
+	constexpr iterator end() { return values.data() + size_; }
+	constexpr const_pointer data() const { return values.data(); }
+	constexpr pointer data() { return values.data(); }
+
+	constexpr T& operator[](id_type id) { return values[slots[id]]; }
+	constexpr const T& operator[](id_type id) const { return values[slots[id]]; }
+
+	constexpr size_type size() const { return size_; }
+	constexpr size_type capacity() const { return values.size(); }
+	constexpr bool contains(id_type id) const { return id < values.size() && slots[id] < size_; }
+
+	constexpr id_type get_next_id() const { return size_ >= values.size() ? invalid_id : ids[size_]; }
+
+	// returns id of the added item
+	constexpr id_type add(const T& value) {
+		if (size_ >= values.size()) return invalid_id;
+		const auto new_id = ids[size_];
+		values[size_] = value;
+		size_++;
+		return new_id;
+	}
+
+	// Add an item with a given id (e.g. when restoring a state), or replace the item with that id.
+	constexpr void insert(const T& value, id_type id) {
+		const auto slot = slots[id];
+		if (slot < size_) {
+			values[slot] = value;
+			return;
+		}
+		swap_slots(slot, size_);
+		values[size_] = value;
+		size_++;
+	}
+
+	constexpr bool remove(id_type id) {
+		if (!contains(id)) return false;
+		const auto slot = slots[id];
+		const auto last = size_ - 1;
+		if (slot != last) {
+			values[slot] = std::move(values[last]);
+			swap_slots(slot, last);
+		}
+		size_--;
+		return true;
+	}
+
+	// Access in the order of iteration, with 0 <= index < size()
+	constexpr T& get_by_index(size_type index) { return values[index]; }
+	constexpr const T& get_by_index(size_type index) const { return values[index]; }
+	constexpr id_type get_id(size_type index) const { return ids[index]; }
+
+	static constexpr id_type invalid_id = static_cast<id_type>(-1);
+
+private:
+	constexpr void initialize_indices() {
+		for (size_t i = 0; i < values.size(); i++) {
+			ids[i] = i;
+			slots[i] = i;
+		}
+	}
+
+	constexpr void swap_slots(size_type a, size_type b) {
+		std::swap(ids[a], ids[b]);
+		slots[ids[a]] = a;
+		slots[ids[b]] = b;
+	}
+
+	// Added items in [0, size), followed by unused storage
+	value_container values{};
+	// Id of the item in each slot, followed by the unused ids
+	index_container ids{};
+	// Slot of the item with each id (the inverse of ids)
+	index_container slots{};
+	size_t size_{};
+};
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace Butterfly {
+
+
+/// @brief Pool of blocks of a fixed size that are allocated once at construction (e.g. when DSP is started).
+///        Allocating and deallocating a block takes constant time and never touches the system heap,
+///        as the free blocks are kept in a list that is stored in the blocks themselves.
+///        Each block can hold one allocation of up to blockSize() bytes with an alignment of up to
+///        alignof(std::max_align_t), e.g. a node of a container or the storage of a std::vector whose
+///        capacity is fixed.
+///
+///        When no block is free or a request does not fit into a block, std::bad_alloc is thrown,
+///        like for any other allocator. The pool is not thread-safe.
+class FixedBlockPool
+{
+public:
+	/// @param blockSize  Size of each block in bytes
+	/// @param blockCount Number of blocks
+	FixedBlockPool(size_t blockSize, size_t blockCount)
+		: blockSize_(roundUp(std::max(blockSize, sizeof(FreeBlock)))),
+		  blockCount_(blockCount),
+		  storage(new Block[blockSize_ / sizeof(Block) * blockCount]) {
+		for (size_t i = blockCount; i > 0; --i) {
+			push(storage.get() + (i - 1) * (blockSize_ / sizeof(Block)));
+		}
+	}
+
+	FixedBlockPool(const FixedBlockPool&) = delete;
+	FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+	void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+		if (bytes > blockSize_ || alignment > alignof(std::max_align_t) || freeList == nullptr) throw std::bad_alloc{};
+		auto block = freeList;
+		freeList = freeList->next;
+		--freeCount;
+		return block;
+	}
+
+	void deallocate(void* p, size_t) noexcept {
+		if (p != nullptr) push(p);
+	}
+
+	size_t blockSize() const { return blockSize_; }
+	size_t blockCount() const { return blockCount_; }
+	size_t freeBlockCount() const { return freeCount; }
+
+private:
+	struct alignas(std::max_align_t) Block
+	{
+		std::byte data[alignof(std::max_align_t)];
+	};
+
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	static constexpr size_t roundUp(size_t bytes) { return (bytes + sizeof(Block) - 1) / sizeof(Block) * sizeof(Block); }
+
+	void push(void* p) noexcept {
+		freeList = ::new (p) FreeBlock{ freeList };
+		++freeCount;
+	}
+
+	size_t blockSize_;
+	size_t blockCount_;
+	std::unique_ptr<Block[]> storage;
+	FreeBlock* freeList{};
+	size_t freeCount{};
+};
+
+
+/// @brief Allocator for standard containers that allocates from a FixedBlockPool, which needs to outlive the allocator.
+///
+/// @tparam T Value type.
+template<class T>
+class PoolAllocator
+{
+public:
+	using value_type = T;
+
+	PoolAllocator(FixedBlockPool& pool) noexcept : pool(&pool) {}
+
+	template<class U>
+	PoolAllocator(const PoolAllocator<U>& other) noexcept : pool(other.getPool()) {}
+
+	T* allocate(size_t n) { return static_cast<T*>(pool->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T* p, size_t n) noexcept { pool->deallocate(p, n * sizeof(T)); }
+
+	FixedBlockPool* getPool() const noexcept { return pool; }
+
+	template<class U>
+	bool operator==(const PoolAllocator<U>& other) const noexcept { return pool == other.getPool(); }
+
+private:
+	FixedBlockPool* pool;
+};
+
+}
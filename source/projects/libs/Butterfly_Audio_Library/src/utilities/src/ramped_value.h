@@ -3,6 +3,8 @@
 
 #include <cmath>
 #include <cassert>
+#include <span>
+#include <algorithm>
 
 
 namespace Butterfly {
@@ -45,6 +47,35 @@ public:
 		return tmp;
 	}
 
+	/// @brief Fill a block with the values that successive calls of operator++ would return.
+	///        The ramp is written in closed form (value + i * inc, or repeated multiplication for
+	///        exponential ramping) and the point where the target is reached is handled once.
+	/// @param out Block to fill
+	/// @return Whether the block is constant, i.e. holds only the target value. Callers can
+	///         then use operator()() as a scalar instead of reading the block.
+	constexpr bool render(std::span<T> out) {
+		if (countDown <= 0) {
+			std::fill(out.begin(), out.end(), value = target);
+			return true;
+		}
+		const auto size = static_cast<int>(out.size());
+		const auto n = std::min(countDown, size);
+		if (n == 0) return false;
+		if constexpr (rampingType == RampingType::Linear) {
+			const T base = value;
+			for (int i = 0; i < n; ++i) out[i] = base + static_cast<T>(i + 1) * inc;
+		} else {
+			T v = value;
+			for (int i = 0; i < n; ++i) out[i] = v *= inc;
+		}
+		countDown -= n;
+		value = out[n - 1];
+		if (n < size) {
+			std::fill(out.begin() + n, out.end(), value = target);
+		}
+		return false;
+	}
+
 	/// @brief Set the new target value.
 	/// @param v New value
 	/// @return Whether ramping is needed.
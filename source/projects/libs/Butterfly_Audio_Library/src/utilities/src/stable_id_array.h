@@ -14,7 +14,8 @@ namespace Butterfly {
 ///        Let n be the capacity (internal size) and m the size (number of added elements).
 ///        Then the runtime cost for these operations is:
 ///        - add: O(1) (no allocation, may fail when capacity is exceeded)
-///        - remove: O(m) (only for searching the correct id, at most 1 id swap is performed, no destruction)
+///        - remove: O(1) (at most 1 id swap is performed, no destruction)
+///        - insert with a given id: O(1)
 ///        - iterating over all added elements: O(m)
 ///
 ///        A std::vector which holds objects that carry a flag that indicates if they are active
@@ -30,8 +31,8 @@ namespace Butterfly {
 ///         - default-constructable
 ///
 /// @tparam T Value type.
-/// @tparam capacity Final capacity of container.
-template<class T, size_t capacity>
+/// @tparam maxSize Final capacity of container.
+template<class T, size_t maxSize>
 class StableIDArray
 {
 public:
@@ -44,8 +45,8 @@ public:
 	using id_type = size_t;
 	using difference_type = ptrdiff_t;
 
-	using value_container = std::array<value_type, capacity>;
-	using index_container = std::array<size_type, capacity>;
+	using value_container = std::array<value_type, maxSize>;
+	using index_container = std::array<size_type, maxSize>;
 
 	template<class U>
 	class redirecting_iterator
@@ -154,7 +155,7 @@ public:
 		const auto index = find_index(id);
 		if (index >= size_) { // not in "active" range
 			if (index != size_) {
-				std::swap(value_indices[index], value_indices[size_]);
+				swap_indices(index, size_);
 			}
 			size_++;
 		}
@@ -166,7 +167,7 @@ public:
 			const auto index = find_index(id);
 			if (index == invalid_id || index > last_id) return false;
 			if (last_id > index) {
-				std::swap(value_indices[index], value_indices[last_id]);
+				swap_indices(index, last_id);
 			}
 			size_--;
 			return true;
@@ -182,24 +183,29 @@ protected:
 	constexpr id_type get_id(size_type index) const { return value_indices[index]; }
 
 	constexpr size_type find_index(id_type id) const {
-		size_type i{ 0 };
-		for (const auto c : value_indices) {
-			if (c == id) return i;
-			i++;
-		}
-		return invalid_id;
+		return id < id_indices.size() ? id_indices[id] : invalid_id;
 	}
 
 private:
 	constexpr void initialize_indices() {
-		for (size_t i = 0; i < values.size(); i++)
+		for (size_t i = 0; i < values.size(); i++) {
 			value_indices[i] = i;
+			id_indices[i] = i;
+		}
+	}
+
+	constexpr void swap_indices(size_type a, size_type b) {
+		std::swap(value_indices[a], value_indices[b]);
+		id_indices[value_indices[a]] = a;
+		id_indices[value_indices[b]] = b;
 	}
 
 	// Preallocated buffer of values. These are not moved around and need to keep their addresses
 	value_container values{};
 	// Pointers to the items of values (see above). These can be moved around and swapped.
 	index_container value_indices{};
+	// Index of each id in value_indices (the inverse of value_indices), so that ids can be found in O(1).
+	index_container id_indices{};
 	size_t size_{};
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include <memory>
 #include <vector>
 
 namespace Butterfly {
@@ -15,7 +16,8 @@ namespace Butterfly {
 ///        Let n be the capacity (internal size) and m the size (number of added elements).
 ///        Then the runtime cost for these operations is:
 ///        - add: O(1) (no allocation, may fail when capacity is exceeded)
-///        - remove: O(m) (only for searching the correct id, at most 1 id swap is performed, no destruction)
+///        - remove: O(1) (at most 1 id swap is performed, no destruction)
+///        - insert with a given id: O(1)
 ///        - iterating over all added elements: O(m)
 ///
 ///        A std::vector which holds objects that carry a flag that indicates if they are active
@@ -32,7 +34,8 @@ namespace Butterfly {
 ///
 ///
 /// @tparam T Value type.
-/// @tparam Alloc Allocator for the internal std::vector
+/// @tparam Alloc Allocator for the internal std::vector's (e.g. a PoolAllocator or ArenaAllocator
+///               to keep the storage out of the system heap)
 template<class T, class Alloc = std::allocator<T>>
 class StableIDVector
 {
@@ -48,7 +51,7 @@ public:
 	using allocator_type = Alloc;
 
 	using value_container = std::vector<value_type, Alloc>;
-	using index_container = std::vector<size_type>;
+	using index_container = std::vector<size_type, typename std::allocator_traits<Alloc>::template rebind_alloc<size_type>>;
 
 	template<class U>
 	class redirecting_iterator
@@ -125,8 +128,10 @@ public:
 
 
 
-	constexpr StableIDVector(size_t capacity) : values(capacity), value_indices(capacity) { initialize_indices(); }
-	constexpr StableIDVector(size_t capacity, const T& val) : values(capacity, val), value_indices(capacity) { initialize_indices(); }
+	constexpr StableIDVector(size_t capacity, const Alloc& alloc = Alloc())
+		: values(capacity, alloc), value_indices(capacity, alloc), id_indices(capacity, alloc) { initialize_indices(); }
+	constexpr StableIDVector(size_t capacity, const T& val, const Alloc& alloc = Alloc())
+		: values(capacity, val, alloc), value_indices(capacity, alloc), id_indices(capacity, alloc) { initialize_indices(); }
 
 	constexpr const_iterator begin() const { return const_iterator{ values, value_indices, 0 }; }
 	constexpr iterator begin() { return iterator{ values, value_indices, 0 }; }
@@ -154,7 +159,7 @@ public:
 		const auto index = find_index(id);
 		if (index >= size_) { // not in "active" range
 			if (index != size_) {
-				std::swap(value_indices[index], value_indices[size_]);
+				swap_indices(index, size_);
 			}
 			size_++;
 		}
@@ -166,7 +171,7 @@ public:
 			const auto index = find_index(id);
 			if (index == invalid_id || index > last_id) return false;
 			if (last_id > index) {
-				std::swap(value_indices[index], value_indices[last_id]);
+				swap_indices(index, last_id);
 			}
 			size_--;
 			return true;
@@ -182,18 +187,21 @@ protected:
 	constexpr id_type get_id(size_type index) const { return value_indices[index]; }
 
 	constexpr size_type find_index(id_type id) const {
-		size_type i{ 0 };
-		for (const auto c : value_indices) {
-			if (c == id) return i;
-			i++;
-		}
-		return invalid_id;
+		return id < id_indices.size() ? id_indices[id] : invalid_id;
 	}
 
 private:
 	constexpr void initialize_indices() {
-		for (size_t i = 0; i < values.size(); i++)
+		for (size_t i = 0; i < values.size(); i++) {
 			value_indices[i] = i;
+			id_indices[i] = i;
+		}
+	}
+
+	constexpr void swap_indices(size_type a, size_type b) {
+		std::swap(value_indices[a], value_indices[b]);
+		id_indices[value_indices[a]] = a;
+		id_indices[value_indices[b]] = b;
 	}
 
 
@@ -201,6 +209,8 @@ private:
 	value_container values{};
 	// Pointers to the items of values (see above). These can be moved around and swapped.
 	index_container value_indices{};
+	// Index of each id in value_indices (the inverse of value_indices), so that ids can be found in O(1).
+	index_container id_indices{};
 	size_t size_{};
 };
 
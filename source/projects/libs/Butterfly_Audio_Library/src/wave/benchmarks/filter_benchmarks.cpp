@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+#include "biquad_filter.h"
+#include "moog_filter.h"
+
+using namespace Butterfly;
+
+
+namespace {
+
+constexpr double sampleRate = 44100.;
+
+std::vector<double> whiteNoise(size_t size) {
+	std::mt19937 generator{ 0 };
+	std::uniform_real_distribution<double> distribution{ -1.0, 1.0 };
+	std::vector<double> noise(size);
+	for (auto& x : noise) x = distribution(generator);
+	return noise;
+}
+
+}
+
+
+TEST_CASE("BiquadFilter", "[benchmark]") {
+	for (size_t size : { 16, 64, 512 }) {
+		const auto input = whiteNoise(size);
+		std::vector<double> output(size);
+
+		BiquadFilter<double> filter{ sampleRate, 1000. };
+		filter.setType(BiquadFilter<double>::Type::Lowpass);
+		filter.setQ(0.707);
+
+		BENCHMARK("BiquadFilter per sample " + std::to_string(size)) {
+			for (size_t i = 0; i < size; ++i) output[i] = filter(input[i]);
+			return output[0];
+		};
+
+		BENCHMARK("BiquadFilter block " + std::to_string(size)) {
+			filter.process(input, output);
+			return output[0];
+		};
+	}
+}
+
+
+TEST_CASE("BiquadFilter coefficients", "[benchmark]") {
+	// one EQ band set on the channels of a mixer: the first filter computes the coefficients and
+	// the others find them in the cache, unless the cache is cleared before each filter
+	std::vector<BiquadFilter<double>> filters(256, BiquadFilter<double>{ sampleRate, 1000. });
+	for (auto& filter : filters) filter.setType(BiquadFilter<double>::Type::Peak);
+	double gain = 0;
+
+	BENCHMARK("BiquadFilter set gain of 256 filters") {
+		gain += 0.5;
+		for (auto& filter : filters) filter.setGain(gain);
+		return filters[0].getGain();
+	};
+
+	BENCHMARK("BiquadFilter set gain of 256 filters, uncached") {
+		gain += 0.5;
+		for (auto& filter : filters) {
+			BiquadFilter<double>::cache().clear();
+			filter.setGain(gain);
+		}
+		return filters[0].getGain();
+	};
+}
+
+
+TEST_CASE("MoogFilter", "[benchmark]") {
+	for (size_t size : { 16, 64, 512 }) {
+		for (bool saturation : { false, true }) {
+			const auto input = whiteNoise(size);
+			std::vector<double> output(size);
+
+			MoogFilter<double> filter{ sampleRate };
+			filter.setFrequency(1000.);
+			filter.setResonance(0.5);
+			filter.setSaturation(saturation);
+
+			BENCHMARK("MoogFilter " + std::string(saturation ? "saturated " : "") + std::to_string(size)) {
+				for (size_t i = 0; i < size; ++i) output[i] = filter(input[i]);
+				return output[0];
+			};
+		}
+	}
+}
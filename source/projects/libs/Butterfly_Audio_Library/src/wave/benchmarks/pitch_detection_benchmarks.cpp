@@ -0,0 +1,28 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <vector>
+#include "pitch_detection.h"
+
+using namespace Butterfly;
+
+
+TEST_CASE("getPitch", "[benchmark]") {
+	for (size_t size : { 512, 1024, 2048, 4096 }) {
+		// a saw wave at 220 Hz with a sample rate of 44100 Hz
+		std::vector<double> signal(size);
+		for (size_t i = 0; i < size; ++i) {
+			const auto phase = i * 220. / 44100.;
+			signal[i] = 2. * (phase - std::floor(phase)) - 1.;
+		}
+
+		PitchDetectorWorkspace<double> workspace{ size };
+
+		BENCHMARK("getPitch " + std::to_string(size)) {
+			return getPitch(signal.begin(), signal.end(), workspace);
+		};
+	}
+}
@@ -1,6 +1,11 @@
 #pragma once
 
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "fft.h"
 
 namespace Butterfly {
@@ -37,6 +42,81 @@ void antialiase_dft(
 }
 
 
+/// @brief Remove spectral components like `antialiase_dft()`, for the frequencies from zero up to nyquist of a real signal
+/// as computed by `FFTCalculator::rfft()`.
+///
+/// @tparam It                     Input/output iterator, must meet the requirements of LegacyRandomAccessIterator
+/// @param  first                  Spectrum range start
+/// @param  last                   Spectrum range end, the size of the range is half the signal length plus one
+/// @param  samplerate             Sampling rate
+/// @param  max_playback_frequency Maximum frequency at which the buffer may be played back periodically without aliasing at given samplerate
+template<std::random_access_iterator It, std::floating_point T>
+void antialiase_rdft(
+	It first, It last,
+	T samplerate,
+	T max_playback_frequency) {
+
+	const auto size = 2 * (static_cast<size_t>(std::distance(first, last)) - 1);
+
+	const auto nyquist = samplerate * 0.5;
+	const auto nyquist_index = nyquist / max_playback_frequency;
+	const auto cutoff_index = static_cast<size_t>(std::floor(nyquist_index)) + 1;
+
+	if (cutoff_index > size / 2) return;
+
+	(*first).imag(0);
+
+	for (auto it = first + cutoff_index; it != last; ++it) {
+		*it = {};
+	}
+}
+
+
+namespace detail {
+
+// Write the band-limited version of the spectrum [first, last) of a real signal to out, like copying
+// it and applying antialiase_rdft(), but only the retained bins are copied and the rest is cleared.
+template<std::random_access_iterator InIt, std::random_access_iterator OutIt, std::floating_point T>
+void bandlimit_rdft(InIt first, InIt last, OutIt out, T samplerate, T max_playback_frequency) {
+	const auto bins = static_cast<size_t>(std::distance(first, last));
+	const auto size = 2 * (bins - 1);
+
+	const auto nyquist = samplerate * 0.5;
+	const auto nyquist_index = nyquist / max_playback_frequency;
+	const auto cutoff_index = static_cast<size_t>(std::floor(nyquist_index)) + 1;
+
+	if (cutoff_index > size / 2) {
+		std::copy(first, last, out);
+		return;
+	}
+
+	std::copy(first, first + cutoff_index, out);
+	std::fill(out + cutoff_index, out + bins, typename std::iterator_traits<OutIt>::value_type{});
+	(*out).imag(0);
+}
+
+}
+
+
+/// @brief Buffers for antialiase(), which can be kept and reused across calls, e.g. while a bank of
+/// tables is loaded, so that the spectra are only allocated once.
+///
+/// @tparam T     Sample type (i.e. float or double)
+/// @tparam size  Size of signal (needs to be a power of 2)
+/// @tparam Alloc Allocator for the spectra, e.g. an ArenaAllocator to avoid the system heap
+template<std::floating_point T, int size, class Alloc = std::allocator<std::complex<T>>>
+struct AntialiaseWorkspace
+{
+	using spectrum_type = std::vector<std::complex<T>, typename std::allocator_traits<Alloc>::template rebind_alloc<std::complex<T>>>;
+
+	explicit AntialiaseWorkspace(const Alloc& alloc = Alloc()) : spectrum(size / 2 + 1, alloc), scratch(size / 2 + 1, alloc) {}
+
+	// The spectrum of a real signal is symmetric, so only the frequencies up to nyquist are computed.
+	spectrum_type spectrum;
+	spectrum_type scratch; // overwritten by the inverse transform of every table
+};
+
+
 /// @brief Antialiase given signal for a number of maximum frequencies in [freq_first, freq_last) using fourier bandlimiting.
 /// The signal length needs to be a power of 2 and must match the size of the `FFTCalculator`. The latter defines type and size of the signal.
 /// In order to write the antialiased signals in `std::distance(freq_first, freq_last)` outputs, the iterator
@@ -54,30 +134,91 @@ void antialiase_dft(
 /// @param  out_table_first        Iterator to first range
 /// @param  samplerate             Sampling rate
 /// @param  fft_calculator         FFT calculator
-template<std::floating_point T, int size, std::forward_iterator SignalIt, std::forward_iterator FrequencyIt, std::forward_iterator OutputIterator>
+/// @param  workspace              Buffers for the spectra, which are reused for all tables
+template<std::floating_point T, int size, std::forward_iterator SignalIt, std::forward_iterator FrequencyIt, std::forward_iterator OutputIterator, class Alloc>
 requires requires(OutputIterator it) { requires std::forward_iterator<decltype(std::begin(*it))>; }
 void antialiase(
 	SignalIt signal_first,
 	FrequencyIt freq_first, FrequencyIt freq_last,
 	OutputIterator out_table_first,
 	T samplerate,
-	const Butterfly::FFTCalculator<T, size>& fft_calculator) {
+	const Butterfly::FFTCalculator<T, size>& fft_calculator,
+	AntialiaseWorkspace<T, size, Alloc>& workspace) {
 
-	std::vector<T> data(size);
-	std::vector<std::complex<T>> fft(size);
-	std::copy(signal_first, signal_first + size, data.begin());
-
-	fft_calculator.fft(signal_first, fft.begin());
+	auto& spectrum = workspace.spectrum;
+	auto& scratch = workspace.scratch;
+	fft_calculator.rfft(signal_first, spectrum.begin());
 
 	auto freq_it = freq_first;
 	auto table_it = out_table_first;
 	for (; freq_it != freq_last; ++freq_it, ++table_it) {
-		auto copy = fft;
-		antialiase_dft(copy.begin(), copy.end(), samplerate, *freq_it);
-		const auto iter = std::begin(*table_it);
-		fft_calculator.ifft_real(copy.begin(), iter);
+		detail::bandlimit_rdft(spectrum.begin(), spectrum.end(), scratch.begin(), samplerate, static_cast<T>(*freq_it));
+		fft_calculator.irfft(scratch.begin(), std::begin(*table_it));
 	}
 }
 
 
-}
\ No newline at end of file
+/// @brief Antialiase given signal like above, with buffers that are allocated for this call only.
+///
+/// @param  alloc                  Allocator for the temporary spectra, e.g. an ArenaAllocator to avoid the system heap
+template<std::floating_point T, int size, std::forward_iterator SignalIt, std::forward_iterator FrequencyIt, std::forward_iterator OutputIterator, class Alloc = std::allocator<std::complex<T>>>
+requires requires(OutputIterator it) { requires std::forward_iterator<decltype(std::begin(*it))>; }
+void antialiase(
+	SignalIt signal_first,
+	FrequencyIt freq_first, FrequencyIt freq_last,
+	OutputIterator out_table_first,
+	T samplerate,
+	const Butterfly::FFTCalculator<T, size>& fft_calculator,
+	const Alloc& alloc = Alloc()) {
+
+	AntialiaseWorkspace<T, size, Alloc> workspace{ alloc };
+	antialiase(signal_first, freq_first, freq_last, out_table_first, samplerate, fft_calculator, workspace);
+}
+
+
+/// @brief Antialiase given signal like antialiase(), but spread the tables across worker threads, e.g.
+/// when a large bank is loaded. The spectrum of the signal is computed once and shared; every thread has
+/// its own scratch buffer. The FFT calculator is only read, so it can be shared as well.
+///
+/// @param  threads                Number of threads to use, including the calling one; 0 uses one per hardware thread
+template<std::floating_point T, int size, std::forward_iterator SignalIt, std::random_access_iterator FrequencyIt, std::random_access_iterator OutputIterator>
+requires requires(OutputIterator it) { requires std::forward_iterator<decltype(std::begin(*it))>; }
+void antialiase_parallel(
+	SignalIt signal_first,
+	FrequencyIt freq_first, FrequencyIt freq_last,
+	OutputIterator out_table_first,
+	T samplerate,
+	const Butterfly::FFTCalculator<T, size>& fft_calculator,
+	unsigned threads = 0) {
+
+	using spectrum_type = std::vector<std::complex<T>>;
+
+	const auto tables = static_cast<size_t>(std::distance(freq_first, freq_last));
+	if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+	const auto workers = static_cast<size_t>(std::min<size_t>(threads, tables));
+	if (workers <= 1) {
+		antialiase(signal_first, freq_first, freq_last, out_table_first, samplerate, fft_calculator);
+		return;
+	}
+
+	spectrum_type spectrum(size / 2 + 1);
+	fft_calculator.rfft(signal_first, spectrum.begin());
+
+	// every worker takes every workers-th table, so the cost is balanced also if it varies with the frequency
+	auto work = [&](size_t first) {
+		spectrum_type scratch(size / 2 + 1);
+		for (size_t i = first; i < tables; i += workers) {
+			detail::bandlimit_rdft(spectrum.begin(), spectrum.end(), scratch.begin(), samplerate, static_cast<T>(freq_first[i]));
+			fft_calculator.irfft(scratch.begin(), std::begin(out_table_first[i]));
+		}
+	};
+
+	std::vector<std::thread> pool;
+	pool.reserve(workers - 1);
+	for (size_t w = 1; w < workers; ++w) pool.emplace_back(work, w);
+	work(0);
+	for (auto& thread : pool) thread.join();
+}
+
+
+}
@@ -1,7 +1,14 @@
 #pragma once
 
-#include <numbers>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
 #include <concepts>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include "coefficient_cache.h"
 
 namespace Butterfly {
 
@@ -25,6 +32,50 @@ public:
 		return y;
 	}
 
+	/// @brief Filter a block of samples in place. Produces the same output as calling
+	///        operator() on every sample, and the state is continued across calls to either.
+	void process(std::span<T> block) { process(block, block); }
+
+	/// @brief Filter a block of samples into a block of the same size (which may be the input).
+	///
+	///        The block is computed in transposed direct form II, which only keeps two state
+	///        variables in registers instead of the four of the input and output history. The
+	///        state is converted from and to the history that operator() uses at the ends of
+	///        the block.
+	void process(std::span<const T> input, std::span<T> output) {
+		assert(input.size() == output.size());
+		const size_t n = input.size();
+		if (n == 0) return;
+
+		// the last two inputs are needed for the history but may be overwritten if in place
+		const T lastX1 = input[n - 1];
+		const T lastX2 = n > 1 ? input[n - 2] : x1;
+
+		T s1 = b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+		T s2 = b2 * x1 - a2 * y1;
+		for (size_t i = 0; i < n; ++i) {
+			const T x = input[i];
+			const T y = b0 * x + s1;
+			s1 = b1 * x - a1 * y + s2;
+			s2 = b2 * x - a2 * y;
+			output[i] = y;
+		}
+
+		y2 = n > 1 ? output[n - 2] : y1;
+		y1 = output[n - 1];
+		x2 = lastX2;
+		x1 = lastX1;
+	}
+
+	/// @brief Set the coefficients of the transfer function, normalized so that a0 = 1.
+	constexpr void setCoefficients(T b0, T b1, T b2, T a1, T a2) {
+		this->b0 = b0;
+		this->b1 = b1;
+		this->b2 = b2;
+		this->a1 = a1;
+		this->a2 = a2;
+	}
+
 	void reset() {
 		x1 = x2 = y1 = y2 = T(0);
 		a1 = a2 = b1 = b2 = T(0);
@@ -38,8 +89,185 @@ protected:
 };
 
 
+/// @brief Biquad filters for a fixed number of channels, which are computed together so that
+///        the compiler can process the channels in SIMD lanes. Every channel has its own
+///        coefficients, which may also all be the same (e.g. for one EQ band on all channels
+///        of a multichannel signal).
+///
+///        Coefficients and state are held as arrays over the channels, and every sample is
+///        computed in transposed direct form II. As in waveform_processing.h, no intrinsics are
+///        used; the loops over the channels are shaped for auto-vectorization, so Channels is
+///        best a multiple of the SIMD width.
+///
+/// @tparam T        Sample type
+/// @tparam Channels Number of channels
+template<std::floating_point T, size_t Channels>
+class BiquadBank
+{
+public:
+	using value_type = T;
+	using frame_type = std::array<T, Channels>;
+
+	static constexpr size_t channels() { return Channels; }
+
+	constexpr BiquadBank() { reset(); }
+
+	/// @brief Set the coefficients of one channel, normalized so that a0 = 1.
+	constexpr void setCoefficients(size_t channel, T b0, T b1, T b2, T a1, T a2) {
+		assert(channel < Channels);
+		this->b0[channel] = b0;
+		this->b1[channel] = b1;
+		this->b2[channel] = b2;
+		this->a1[channel] = a1;
+		this->a2[channel] = a2;
+	}
+
+	/// @brief Set the same coefficients for all channels.
+	constexpr void setCoefficients(T b0, T b1, T b2, T a1, T a2) {
+		for (size_t c = 0; c < Channels; ++c) setCoefficients(c, b0, b1, b2, a1, a2);
+	}
+
+	/// @brief Filter one sample of every channel in place.
+	constexpr void tick(frame_type& x) {
+		for (size_t c = 0; c < Channels; ++c) {
+			const T y = b0[c] * x[c] + s1[c];
+			s1[c] = b1[c] * x[c] - a1[c] * y + s2[c];
+			s2[c] = b2[c] * x[c] - a2[c] * y;
+			x[c] = y;
+		}
+	}
+
+	constexpr frame_type operator()(frame_type x) {
+		tick(x);
+		return x;
+	}
+
+	/// @brief Filter frames of interleaved samples (Channels samples per frame) in place.
+	void processInterleaved(T* data, size_t frames) {
+		for (size_t i = 0; i < frames; ++i, data += Channels) {
+			frame_type x;
+			std::copy(data, data + Channels, x.begin());
+			tick(x);
+			std::copy(x.begin(), x.end(), data);
+		}
+	}
+
+	/// @brief Filter one buffer per channel in place.
+	void process(T* const* channels, size_t frames) {
+		for (size_t i = 0; i < frames; ++i) {
+			frame_type x;
+			for (size_t c = 0; c < Channels; ++c) x[c] = channels[c][i];
+			tick(x);
+			for (size_t c = 0; c < Channels; ++c) channels[c][i] = x[c];
+		}
+	}
+
+	/// @brief Clear the state and make all channels pass their input unchanged.
+	constexpr void reset() {
+		clear();
+		b0.fill(T(1));
+		b1.fill(T(0));
+		b2.fill(T(0));
+		a1.fill(T(0));
+		a2.fill(T(0));
+	}
+
+	/// @brief Clear the state but keep the coefficients.
+	constexpr void clear() {
+		s1.fill(T(0));
+		s2.fill(T(0));
+	}
+
+private:
+	frame_type s1{}, s2{};
+	frame_type a1{}, a2{};		// poles
+	frame_type b0{}, b1{}, b2{}; // zeros
+};
+
+
+/// @brief Series of biquad sections, e.g. the bands of an equalizer, for a fixed number of
+///        channels. Instead of filtering the whole block with one section after the other,
+///        every frame passes through all sections before the next frame is read, so the
+///        intermediate results stay in registers and the buffers are only read and written once.
+///
+///        Each section is a BiquadBank, so the channels are computed in SIMD lanes as there.
+///
+/// @tparam T        Sample type
+/// @tparam Sections Number of biquad sections
+/// @tparam Channels Number of channels
+template<std::floating_point T, size_t Sections, size_t Channels = 1>
+class BiquadCascade
+{
+public:
+	using value_type = T;
+	using section_type = BiquadBank<T, Channels>;
+	using frame_type = typename section_type::frame_type;
+
+	static constexpr size_t sections() { return Sections; }
+	static constexpr size_t channels() { return Channels; }
+
+	constexpr section_type& operator[](size_t section) { return sections_[section]; }
+	constexpr const section_type& operator[](size_t section) const { return sections_[section]; }
+
+	/// @brief Set the coefficients of one section for all channels, normalized so that a0 = 1.
+	constexpr void setCoefficients(size_t section, T b0, T b1, T b2, T a1, T a2) {
+		assert(section < Sections);
+		sections_[section].setCoefficients(b0, b1, b2, a1, a2);
+	}
+
+	constexpr void tick(frame_type& x) {
+		for (auto& section : sections_) section.tick(x);
+	}
+
+	constexpr frame_type operator()(frame_type x) {
+		tick(x);
+		return x;
+	}
+
+	/// @brief Filter a block of a single channel in place.
+	void process(std::span<T> block) requires(Channels == 1) {
+		for (auto& sample : block) {
+			frame_type x{ sample };
+			tick(x);
+			sample = x[0];
+		}
+	}
+
+	/// @brief Filter frames of interleaved samples (Channels samples per frame) in place.
+	void processInterleaved(T* data, size_t frames) {
+		for (size_t i = 0; i < frames; ++i, data += Channels) {
+			frame_type x;
+			std::copy(data, data + Channels, x.begin());
+			tick(x);
+			std::copy(x.begin(), x.end(), data);
+		}
+	}
+
+	/// @brief Filter one buffer per channel in place.
+	void process(T* const* channels, size_t frames) {
+		for (size_t i = 0; i < frames; ++i) {
+			frame_type x;
+			for (size_t c = 0; c < Channels; ++c) x[c] = channels[c][i];
+			tick(x);
+			for (size_t c = 0; c < Channels; ++c) channels[c][i] = x[c];
+		}
+	}
+
+	constexpr void reset() {
+		for (auto& section : sections_) section.reset();
+	}
+
+	constexpr void clear() {
+		for (auto& section : sections_) section.clear();
+	}
+
+private:
+	std::array<section_type, Sections> sections_;
+};
+
+
 template<std::floating_point T>
-class BiquadFilter : BiquadBase<T>
+class BiquadFilter : public BiquadBase<T>
 {
 public:
 	enum class Type {
@@ -83,14 +311,39 @@ public:
 		update();
 	}
 
-	void getSamplerate() const { return samplerate; }
-	void getFrequency() const { return frequency; }
-	void getGain() const { return gain; }
-	void getQ() const { return q; }
+	T getSamplerate() const { return samplerate; }
+	T getFrequency() const { return frequency; }
+	T getGain() const { return gain; }
+	T getQ() const { return q; }
 	Type getType() const { return type; }
 
+	/// @brief Coefficients of the transfer function, normalized so that a0 = 1.
+	struct Coefficients
+	{
+		T b0, b1, b2, a1, a2;
+	};
+
+	/// @brief Coefficients shared by all filters of this sample type, keyed by type, frequency,
+	///        Q, gain and samplerate, so that filters with the same settings (e.g. one EQ band on
+	///        many channels) compute them once.
+	using Cache = CoefficientCache<5, Coefficients>;
+
+	static Cache& cache() { return sharedCache; }
+
 protected:
 	void update() {
+		const typename Cache::key_type key{ double(type), double(frequency), double(q), double(gain), double(samplerate) };
+
+		Coefficients c;
+		if (sharedCache.find(key, c)) {
+			this->setCoefficients(c.b0, c.b1, c.b2, c.a1, c.a2);
+			return;
+		}
+		compute();
+		sharedCache.insert(key, { this->b0, this->b1, this->b2, this->a1, this->a2 });
+	}
+
+	void compute() {
 		switch (type) {
 		case Type::Lowpass: updateLowpass(); return;
 		case Type::Highpass: updateHighpass(); return;
@@ -113,10 +366,9 @@ protected:
 		const auto a = std::sin(w0) / (2 * q);
 		const auto a0_inv = 1. / (1. + a);
 
-		this->b0 = b2 = 1. * a0_inv;
-		b1 = a1 = -2. * std::cos(w0) * a0_inv;
-		a0 = (1. + a) * a0_inv;
-		a2 = (1. - a) * a0_inv;
+		this->b0 = this->b2 = 1. * a0_inv;
+		this->b1 = this->a1 = -2. * std::cos(w0) * a0_inv;
+		this->a2 = (1. - a) * a0_inv;
 	}
 
 	void updateBPF_constantSkirtGainQ() {
@@ -125,10 +377,10 @@ protected:
 		const auto a0_inv = 1. / (1. + a);
 
 		this->b0 = (a * q) * a0_inv;
-		b1 = 0;
-		b2 = -this->b0;
-		a1 = -2 * std::cos(w0) * a0_inv;
-		a2 = (1 - a) * a0_inv;
+		this->b1 = 0;
+		this->b2 = -this->b0;
+		this->a1 = -2 * std::cos(w0) * a0_inv;
+		this->a2 = (1 - a) * a0_inv;
 	}
 
 	void updateBPF_constantPeakGain0() {
@@ -137,10 +389,10 @@ protected:
 		const auto a0_inv = 1. / (1. + a);
 
 		this->b0 = a * a0_inv;
-		b1 = 0;
-		b2 = -this->b0;
-		a1 = -2 * std::cos(w0) * a0_inv;
-		a2 = (1 - a) * a0_inv;
+		this->b1 = 0;
+		this->b2 = -this->b0;
+		this->a1 = -2 * std::cos(w0) * a0_inv;
+		this->a2 = (1 - a) * a0_inv;
 	}
 
 	void updateAllpass() {
@@ -148,16 +400,15 @@ protected:
 		const auto a = std::sin(w0) / (2 * q);
 		const auto a0_inv = 1. / (1. + a);
 
-		b1 = a1 = -2. * std::cos(w0) * a0_inv;
-		b2 = a0 = (1. + a) * a0_inv;
-		this->b0 = a2 = (1. - a) * a0_inv;
+		this->b1 = this->a1 = -2. * std::cos(w0) * a0_inv;
+		this->b2 = (1. + a) * a0_inv;
+		this->b0 = this->a2 = (1. - a) * a0_inv;
 	}
 	void updateLow_or_HighShelf(T lowOrHigh) { // low: 1, high: -1
 		const auto A = std::pow(10, gain * 0.025);
 		const auto w0 = T(2) * std::numbers::pi_v<T> * frequency * invSamplerate;
 		const auto cosw = std::cos(w0);
 		const auto a = std::sin(w0) / (2 * q);
-		const auto a0_inv = 1. / (1. + a);
 
 		const auto Ap1 = A + 1.;
 		const auto Am1 = A - 1.;
@@ -169,11 +420,11 @@ protected:
 		const auto a0_inv = 1. / (f + sqAa2);
 
 		this->b0 = A * (e + sqAa2) * a0_inv;
-		b1 = lowOrHigh * 2 * A * (Am1 - Ap1 * cosw) * a0_inv;
-		b2 = A * (e - sqAa2) * a0_inv;
+		this->b1 = lowOrHigh * 2 * A * (Am1 - lowOrHigh * Ap1 * cosw) * a0_inv;
+		this->b2 = A * (e - sqAa2) * a0_inv;
 
-		a1 = lowOrHigh * -2. * (Am1 + Ap1 * cosw) * a0_inv;
-		a2 = (f - sqAa2) * a0_inv;
+		this->a1 = lowOrHigh * -2. * (Am1 + lowOrHigh * Ap1 * cosw) * a0_inv;
+		this->a2 = (f - sqAa2) * a0_inv;
 	}
 
 	void updatePeak() {
@@ -184,10 +435,10 @@ protected:
 		const auto a0_inv = 1. / (1. + a / A);
 
 		this->b0 = (1 + a * A) * a0_inv;
-		b2 = (1 - a * A) * a0_inv;
-		b1 = -2 * cosw * a0_inv;
-		a1 = b1;
-		a2 = (1 - a / A) * a0_inv;
+		this->b2 = (1 - a * A) * a0_inv;
+		this->b1 = -2 * cosw * a0_inv;
+		this->a1 = this->b1;
+		this->a2 = (1 - a / A) * a0_inv;
 	}
 
 	void updateHPF_or_LPF(T hpf_lpf) { // hpf: 1, lpf: -1
@@ -195,10 +446,10 @@ protected:
 		const auto a = std::sin(w0) / (2 * q);
 		const auto cosw = std::cos(w0);
 		const auto a0_inv = 1. / (1. + a);
-		b1 = (1. + hpf_lpf * cosw) * a0_inv;
-		this->b0 = b2 = -hpf_lpf * 0.5 * b1;
-		a1 = -2 * cosw * a0_inv;
-		a2 = (1. - a) * a0_inv;
+		this->b1 = -hpf_lpf * (1. + hpf_lpf * cosw) * a0_inv;
+		this->b0 = this->b2 = -hpf_lpf * 0.5 * this->b1;
+		this->a1 = -2 * cosw * a0_inv;
+		this->a2 = (1. - a) * a0_inv;
 	}
 
 	T samplerate{}, invSamplerate{};
@@ -207,6 +458,9 @@ protected:
 	T gain{};
 
 	Type type{ Type::Lowpass };
+
+private:
+	static inline Cache sharedCache;
 };
 
 
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Butterfly {
+
+
+/// @brief Cache of filter coefficients shared by all filters of a kind, so that filters with the
+///        same settings (e.g. one EQ band on the channels of a mixer, or the voices of a synth)
+///        compute the coefficients only once.
+///
+///        The key is an array of the settings the coefficients are computed from. Entries are
+///        kept in a fixed table where each key has Probes possible slots, and a new entry
+///        replaces the oldest of those when all are taken, so the cache never allocates.
+///
+///        Lookups and insertions are lock-free and may be made from any number of threads,
+///        including audio threads. Every slot has a sequence number that is odd while the slot
+///        is written: a reader that sees it change while reading treats the slot as a miss, and
+///        a writer that finds the slot being written by another thread does not store its entry.
+///
+/// @tparam KeySize Number of settings in the key
+/// @tparam Value   Coefficients, trivially copyable
+/// @tparam Slots   Number of entries, a power of two
+/// @tparam Probes  Number of slots a key may be stored in
+template<size_t KeySize, class Value, size_t Slots = 512, size_t Probes = 4>
+	requires(std::is_trivially_copyable_v<Value> && std::has_single_bit(Slots) && Probes <= Slots)
+class CoefficientCache
+{
+public:
+	using key_type = std::array<double, KeySize>;
+	using value_type = Value;
+
+	/// @brief Look up the coefficients of a key.
+	/// @return True if they were found and copied to value.
+	bool find(const key_type& key, Value& value) const noexcept {
+		const auto keyWords = toWords<keyWordCount>(key);
+		const auto hash = hashOf(keyWords);
+
+		for (size_t i = 0; i < Probes; ++i) {
+			if (read(slots[(hash + i) & (Slots - 1)], keyWords, value)) return true;
+		}
+		return false;
+	}
+
+	/// @brief Store the coefficients of a key, unless the slot is being written by another thread.
+	void insert(const key_type& key, const Value& value) noexcept {
+		const auto keyWords = toWords<keyWordCount>(key);
+		const auto hash = hashOf(keyWords);
+
+		// the slot that has the key already or is empty, else the one written longest ago
+		Slot* target = &slots[hash & (Slots - 1)];
+		for (size_t i = 0; i < Probes; ++i) {
+			auto& slot = slots[(hash + i) & (Slots - 1)];
+			const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+			if (sequence == 0 || matches(slot, keyWords)) {
+				target = &slot;
+				break;
+			}
+			if (slot.stamp.load(std::memory_order_relaxed) < target->stamp.load(std::memory_order_relaxed)) target = &slot;
+		}
+		write(*target, keyWords, toWords<valueWordCount>(value));
+	}
+
+	/// @brief Get the coefficients of a key, calling compute() and storing the result if they are not cached.
+	template<class Compute>
+	Value get(const key_type& key, Compute&& compute) {
+		Value value;
+		if (find(key, value)) return value;
+		value = compute();
+		insert(key, value);
+		return value;
+	}
+
+	/// @brief Remove all entries. Not to be called while other threads use the cache.
+	void clear() noexcept {
+		for (auto& slot : slots) {
+			slot.sequence.store(0, std::memory_order_relaxed);
+			slot.stamp.store(0, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	static constexpr size_t keyWordCount = KeySize;
+	static constexpr size_t valueWordCount = (sizeof(Value) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	// the words are atomic so that reading a slot while it is written is not a data race;
+	// relaxed loads and stores of them compile to plain moves
+	struct Slot
+	{
+		std::atomic<uint32_t> sequence{}; // 0 while empty, odd while written
+		std::atomic<uint32_t> stamp{};	  // when the slot was written, to choose the one to replace
+		std::array<std::atomic<uint64_t>, keyWordCount> key{};
+		std::array<std::atomic<uint64_t>, valueWordCount> value{};
+	};
+
+	template<size_t Count, class T>
+	static std::array<uint64_t, Count> toWords(const T& object) noexcept {
+		std::array<uint64_t, Count> words{};
+		std::memcpy(words.data(), &object, sizeof(T));
+		return words;
+	}
+
+	static size_t hashOf(const std::array<uint64_t, keyWordCount>& words) noexcept {
+		uint64_t hash = 0x9e3779b97f4a7c15ull;
+		for (const auto word : words) {
+			hash ^= word + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+			hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+		}
+		return static_cast<size_t>(hash ^ (hash >> 31));
+	}
+
+	static bool matches(const Slot& slot, const std::array<uint64_t, keyWordCount>& keyWords) noexcept {
+		for (size_t w = 0; w < keyWordCount; ++w) {
+			if (slot.key[w].load(std::memory_order_relaxed) != keyWords[w]) return false;
+		}
+		return true;
+	}
+
+	static bool read(const Slot& slot, const std::array<uint64_t, keyWordCount>& keyWords, Value& value) noexcept {
+		const auto before = slot.sequence.load(std::memory_order_acquire);
+		if (before == 0 || (before & 1) != 0 || !matches(slot, keyWords)) return false;
+
+		std::array<uint64_t, valueWordCount> words;
+		for (size_t w = 0; w < valueWordCount; ++w) words[w] = slot.value[w].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != before) return false;
+
+		std::memcpy(&value, words.data(), sizeof(Value));
+		return true;
+	}
+
+	void write(Slot& slot, const std::array<uint64_t, keyWordCount>& keyWords,
+			   const std::array<uint64_t, valueWordCount>& valueWords) noexcept {
+		auto sequence = slot.sequence.load(std::memory_order_relaxed);
+		if ((sequence & 1) != 0 || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire))
+			return;
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (size_t w = 0; w < keyWordCount; ++w) slot.key[w].store(keyWords[w], std::memory_order_relaxed);
+		for (size_t w = 0; w < valueWordCount; ++w) slot.value[w].store(valueWords[w], std::memory_order_relaxed);
+		slot.stamp.store(clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		slot.sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	std::array<Slot, Slots> slots{};
+	std::atomic<uint32_t> clock{};
+};
+
+
+}
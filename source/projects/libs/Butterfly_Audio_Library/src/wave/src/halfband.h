@@ -0,0 +1,138 @@
+// Polyphase halfband filters for oversampling by a factor of 2.
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <numbers>
+
+namespace Butterfly {
+
+
+/// @brief Coefficients of a windowed-sinc halfband lowpass with 4 * Pairs - 1 taps.
+///
+///        Apart from the center tap of 0.5, every other tap of a halfband filter is zero. Only the
+///        2 * Pairs taps at odd distances from the center are returned, in order; they are
+///        normalized to a sum of 0.5 so that the filter has unity gain at DC. A Blackman window
+///        gives about 80 dB of stopband attenuation.
+template<std::floating_point T, size_t Pairs>
+std::array<T, 2 * Pairs> halfbandCoefficients() {
+	std::array<T, 2 * Pairs> h{};
+	const double width = 2.0 * Pairs; // the window reaches zero one tap beyond the outermost taps
+	double sum = 0;
+	for (size_t q = 0; q < 2 * Pairs; ++q) {
+		const double m = 2.0 * q - (2.0 * Pairs - 1.0); // odd distance from the center
+		const double sinc = std::sin(std::numbers::pi * m / 2) / (std::numbers::pi * m);
+		const double window = 0.42 + 0.5 * std::cos(std::numbers::pi * m / width) + 0.08 * std::cos(2 * std::numbers::pi * m / width);
+		h[q] = static_cast<T>(sinc * window);
+		sum += sinc * window;
+	}
+	for (auto& c : h) c = static_cast<T>(c * (0.5 / sum));
+	return h;
+}
+
+
+/// @brief Upsampler by a factor of 2 with a halfband lowpass, in polyphase form: of the two
+///        output samples per input sample, one is a delayed copy of the input (the center tap)
+///        and the other is computed from the 2 * Pairs non-zero side taps, so no multiplications
+///        with the zero taps of the interpolated signal are made.
+///
+/// @tparam T     Sample type
+/// @tparam Pairs Half the number of non-zero side taps; the filter has 4 * Pairs - 1 taps
+template<std::floating_point T, size_t Pairs = 12>
+class HalfbandUpsampler
+{
+public:
+	/// Delay of the output in samples of the input rate.
+	static constexpr T latency = T(Pairs) - T(0.5);
+
+	HalfbandUpsampler() : h(halfbandCoefficients<T, Pairs>()) {}
+
+	/// @brief Take one sample and return the two samples at twice the rate.
+	std::array<T, 2> operator()(T x) {
+		push(x);
+		const T* history = data.data() + position; // history[length - 1] is x, history[0] the oldest sample
+		T even{};
+		for (size_t q = 0; q < length; ++q) even += h[q] * history[length - 1 - q];
+		return { T(2) * even, history[length - Pairs] };
+	}
+
+	void reset() { data.fill(T(0)); }
+
+private:
+	static constexpr size_t length = 2 * Pairs;
+
+	// The history is kept twice in a row so that the last length samples are always contiguous.
+	void push(T x) {
+		position = position + 1 == length ? 0 : position + 1;
+		data[position + length - 1] = x;
+		data[position == 0 ? 2 * length - 1 : position - 1] = x;
+	}
+
+	std::array<T, length> h;
+	std::array<T, 2 * length> data{};
+	size_t position{};
+};
+
+
+/// @brief Downsampler by a factor of 2 with a halfband lowpass, in polyphase form: the first
+///        sample of each pair only meets the center tap and the second one the 2 * Pairs
+///        non-zero side taps, so the filter is computed at the lower rate.
+///
+/// @tparam T     Sample type
+/// @tparam Pairs Half the number of non-zero side taps; the filter has 4 * Pairs - 1 taps
+template<std::floating_point T, size_t Pairs = 12>
+class HalfbandDownsampler
+{
+public:
+	/// Delay of the output in samples of the output rate, relative to the first sample of each pair.
+	static constexpr T latency = T(Pairs) - T(1);
+
+	HalfbandDownsampler() : h(halfbandCoefficients<T, Pairs>()) {}
+
+	/// @brief Take two consecutive samples and return one sample at half the rate.
+	T operator()(T first, T second) {
+		push(second);
+		const T* history = data.data() + position;
+		T y{};
+		for (size_t q = 0; q < length; ++q) y += h[q] * history[length - 1 - q];
+		if constexpr (centerDelayLength == 0) {
+			return y + T(0.5) * first;
+		}
+		else {
+			// the first samples meet the center tap Pairs - 1 pairs later, when they are overwritten
+			const T center = centerDelay[centerPosition];
+			centerDelay[centerPosition] = first;
+			centerPosition = centerPosition + 1 == centerDelayLength ? 0 : centerPosition + 1;
+			return y + T(0.5) * center;
+		}
+	}
+
+	void reset() {
+		data.fill(T(0));
+		centerDelay.fill(T(0));
+	}
+
+private:
+	static constexpr size_t length = 2 * Pairs;
+	static constexpr size_t centerDelayLength = Pairs - 1;
+
+	// The history is kept twice in a row so that the last length samples are always contiguous.
+	void push(T second) {
+		position = position + 1 == length ? 0 : position + 1;
+		data[position + length - 1] = second;
+		data[position == 0 ? 2 * length - 1 : position - 1] = second;
+	}
+
+	std::array<T, length> h;
+	std::array<T, 2 * length> data{};
+	std::array<T, centerDelayLength> centerDelay{};
+	size_t position{};
+	size_t centerPosition{};
+};
+
+}
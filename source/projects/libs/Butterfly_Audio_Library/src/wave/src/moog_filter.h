@@ -1,6 +1,12 @@
 #pragma once
 
+#include <array>
+#include <cassert>
+#include <cstddef>
 #include <numbers>
+#include <span>
+#include "halfband.h"
+#include "optimized_math.h"
 
 
 //findCrossings(begin, end, value=0) -> vector<double>
@@ -52,6 +58,11 @@ public:
 		calc();
 	}
 
+	/// @brief Enable the cubic soft clipper on the output of the last stage, which is fed back.
+	///        It adds harmonics, so run the filter oversampled (see OversampledMoogFilter) when
+	///        it is enabled.
+	void setSaturation(bool enabled) { saturation = enabled; }
+
 	constexpr T operator()(T input) {
 		// process input
 		x = input - r * y4;
@@ -63,8 +74,10 @@ public:
 		y4 = y3 * p + oldy3 * p - k * y4;
 
 		// clipper band limited sigmoid
-		//constexpr T inv_6 = T(1.0 / 6.0);
-		//	y4 -= (y4 * y4 * y4) * inv_6;
+		if (saturation) {
+			constexpr T inv_6 = T(1.0 / 6.0);
+			y4 -= (y4 * y4 * y4) * inv_6;
+		}
 
 		oldx = x;
 		oldy1 = y1;
@@ -92,6 +105,7 @@ public:
 	constexpr T getResonance() const { return resonance; }
 	constexpr T getCutoff() const { return cutoff; }
 	constexpr T getCutoffHz() const { return cutoff * sampleRate * 0.5; }
+	constexpr bool getSaturation() const { return saturation; }
 
 protected:
 	void init() {
@@ -104,7 +118,7 @@ protected:
 		p = cutoff * (T(1.8) - T(0.8) * cutoff);
 		// k = p + p - T(1.0);
 		// A much better tuning seems to be:
-		k = T(2.0) * std::sin(cutoff * std::numbers::pi_v<T> * T(0.5)) - T(1.0);
+		k = T(2.0) * fastSin(cutoff * std::numbers::pi_v<T> * T(0.5)) - T(1.0);
 
 		T t1 = (T(1.0) - p) * T(1.386249);
 		T t2 = T(12.0) + t1 * t1;
@@ -121,11 +135,206 @@ private:
 	T oldx{};
 	T oldy1{}, oldy2{}, oldy3{};
 	T x{}, r{}, p{}, k{};
+	bool saturation{};
+};
+
+
+/// @brief MoogFilter that runs at 2 or 4 times the sample rate, so that the harmonics of the
+///        saturation (which is enabled by default here) and the warping of the cutoff near
+///        the Nyquist frequency stay below the audible band.
+///
+///        The signal is upsampled and downsampled again with polyphase halfband filters
+///        (HalfbandUpsampler, HalfbandDownsampler), one pair per octave. The stage next to the
+///        sample rate has the steeper filter; the second stage of 4x oversampling only needs to
+///        reject images far above the audible band and is shorter.
+///
+/// @tparam T      Sample type
+/// @tparam Factor Oversampling factor, 2 or 4
+template<class T, size_t Factor = 2, class ParamType = double>
+	requires(Factor == 2 || Factor == 4)
+class OversampledMoogFilter
+{
+public:
+	static constexpr size_t factor = Factor;
+
+	/// Delay in samples that the resampling adds to the filter.
+	static constexpr T latency = HalfbandUpsampler<T, 12>::latency + HalfbandDownsampler<T, 12>::latency +
+								 (Factor == 4 ? (HalfbandUpsampler<T, 6>::latency + HalfbandDownsampler<T, 6>::latency) / 2 : T(0));
+
+	OversampledMoogFilter(ParamType sampleRate) : filter(sampleRate * Factor) {
+		filter.setSaturation(true);
+	}
+
+	void setSampleRate(ParamType fs) { filter.setSampleRate(fs * Factor); }
+	void setResonance(ParamType filterRezo) { filter.setResonance(filterRezo); }
+	void setFrequency(ParamType filterCutoff) { filter.setFrequency(filterCutoff); }
+	void setSaturation(bool enabled) { filter.setSaturation(enabled); }
+
+	T operator()(T input) {
+		const auto [a, b] = up1(input);
+		if constexpr (Factor == 2) {
+			return down1(filter(a), filter(b));
+		}
+		else {
+			const auto [a1, a2] = up2(a);
+			const auto [b1, b2] = up2(b);
+			const T c = down2(filter(a1), filter(a2));
+			const T d = down2(filter(b1), filter(b2));
+			return down1(c, d);
+		}
+	}
+
+	/// @brief Filter a block of samples in place.
+	void process(std::span<T> block) {
+		for (auto& x : block) x = (*this)(x);
+	}
+
+	void reset() {
+		filter.reset();
+		up1.reset();
+		down1.reset();
+		up2.reset();
+		down2.reset();
+	}
+
+	constexpr T getSampleRate() const { return filter.getSampleRate() / Factor; }
+	constexpr T getResonance() const { return filter.getResonance(); }
+	constexpr T getCutoffHz() const { return filter.getCutoffHz(); }
+	constexpr bool getSaturation() const { return filter.getSaturation(); }
+
+private:
+	MoogFilter<T, ParamType> filter;
+	HalfbandUpsampler<T, 12> up1;
+	HalfbandDownsampler<T, 12> down1;
+	HalfbandUpsampler<T, 6> up2; // only used for 4x oversampling
+	HalfbandDownsampler<T, 6> down2;
 };
 
 
+/// @brief MoogFilter for a fixed number of voices, e.g. of a polyphonic synth, with the
+///        cutoff and the resonance set per voice.
+///
+///        The state and the coefficients are held in one array per variable (structure of
+///        arrays) and every sample is computed for all voices in one loop, which the compiler
+///        turns into SIMD instructions like for BiquadBank. For that, the saturation is applied
+///        without a branch and is the same for all voices.
+///
+/// @tparam T      Sample type
+/// @tparam Voices Number of voices
+template<std::floating_point T, size_t Voices>
+class MoogFilterBank
+{
+public:
+	using value_type = T;
+	using frame_type = std::array<T, Voices>;
+
+	static constexpr size_t voices() { return Voices; }
+
+	MoogFilterBank(T sampleRate) : sampleRateInv(T(1) / sampleRate) {
+		cutoff.fill(T(1));
+		for (size_t v = 0; v < Voices; ++v) calc(v);
+	}
+
+	void setSampleRate(T fs) {
+		const T previous = sampleRateInv;
+		sampleRateInv = T(1) / fs;
+		for (size_t v = 0; v < Voices; ++v) {
+			cutoff[v] *= sampleRateInv / previous;
+			calc(v);
+		}
+	}
+
+	/// @brief Set the cutoff frequency of one voice in Hz. This is cheap enough for control
+	///        rate modulation, as the sine of the tuning is approximated.
+	void setFrequency(size_t voice, T filterCutoff) {
+		assert(voice < Voices);
+		cutoff[voice] = T(2) * filterCutoff * sampleRateInv;
+		calc(voice);
+	}
+
+	void setResonance(size_t voice, T filterRezo) {
+		assert(voice < Voices);
+		resonance[voice] = filterRezo;
+		calc(voice);
+	}
+
+	/// @brief Enable the cubic soft clipper of all voices, see MoogFilter::setSaturation().
+	void setSaturation(bool enabled) { saturation = enabled ? T(1.0 / 6.0) : T(0); }
+
+	/// @brief Filter one sample of every voice in place.
+	constexpr void tick(frame_type& input) {
+		for (size_t v = 0; v < Voices; ++v) {
+			const T x = input[v] - r[v] * y4[v];
+			const T s1 = (x + oldx[v]) * p[v] - k[v] * y1[v];
+			const T s2 = (s1 + y1[v]) * p[v] - k[v] * y2[v];
+			const T s3 = (s2 + y2[v]) * p[v] - k[v] * y3[v];
+			T s4 = (s3 + y3[v]) * p[v] - k[v] * y4[v];
+			s4 -= (s4 * s4 * s4) * saturation;
+			oldx[v] = x;
+			y1[v] = s1;
+			y2[v] = s2;
+			y3[v] = s3;
+			y4[v] = s4;
+			input[v] = s4;
+		}
+	}
+
+	constexpr frame_type operator()(frame_type x) {
+		tick(x);
+		return x;
+	}
+
+	/// @brief Filter frames of interleaved samples (one sample per voice and frame) in place.
+	void processInterleaved(T* data, size_t frames) {
+		for (size_t i = 0; i < frames; ++i, data += Voices) {
+			frame_type x;
+			std::copy(data, data + Voices, x.begin());
+			tick(x);
+			std::copy(x.begin(), x.end(), data);
+		}
+	}
+
+	/// @brief Filter one buffer per voice in place.
+	void process(T* const* channels, size_t frames) {
+		for (size_t i = 0; i < frames; ++i) {
+			frame_type x;
+			for (size_t v = 0; v < Voices; ++v) x[v] = channels[v][i];
+			tick(x);
+			for (size_t v = 0; v < Voices; ++v) channels[v][i] = x[v];
+		}
+	}
+
+	/// @brief Clear the state of all voices but keep the settings.
+	constexpr void reset() {
+		y1.fill(T(0));
+		y2.fill(T(0));
+		y3.fill(T(0));
+		y4.fill(T(0));
+		oldx.fill(T(0));
+	}
 
+	T getResonance(size_t voice) const { return resonance[voice]; }
+	T getCutoffHz(size_t voice) const { return cutoff[voice] * T(0.5) / sampleRateInv; }
+	bool getSaturation() const { return saturation != T(0); }
 
+private:
+	// same tuning as MoogFilter::calc()
+	void calc(size_t v) {
+		p[v] = cutoff[v] * (T(1.8) - T(0.8) * cutoff[v]);
+		k[v] = T(2.0) * fastSin(cutoff[v] * std::numbers::pi_v<T> * T(0.5)) - T(1.0);
+
+		T t1 = (T(1.0) - p[v]) * T(1.386249);
+		T t2 = T(12.0) + t1 * t1;
+		r[v] = resonance[v] * (t2 + T(6.0) * t1) / (t2 - T(6.0) * t1);
+	}
+
+	T sampleRateInv{};
+	T saturation{};
 
+	frame_type cutoff{}, resonance{};
+	frame_type p{}, k{}, r{};
+	frame_type y1{}, y2{}, y3{}, y4{}; // outputs of the stages, which are also their inputs of the previous sample
+	frame_type oldx{};
+};
 
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "waveform_processing.h"
+#include "fft.h"
 //#include <coroutine>
 #include <numeric>
 #include <iostream>
@@ -59,43 +60,160 @@ struct PitchFindingParameters
 	// When a long sample is analyzed, the pitch might vary. This parameter constrains
 	// the search to the first n periods.
 	size_t maxPeriodsToAverage = std::numeric_limits<size_t>::max();
+
+	// Function that compares the signal with delayed copies of itself to find the periods.
+	// - AMDF: average magnitude difference function, computed directly in O(N^2).
+	// - SquaredDifference: squared difference function (as used by YIN), computed through an
+	//   FFT-based autocorrelation in O(N log N).
+	// - Automatic: AMDF for signals of up to automaticAMDFMaxSize samples, SquaredDifference otherwise.
+	enum class DifferenceFunction {
+		AMDF,
+		SquaredDifference,
+		Automatic
+	};
+	DifferenceFunction differenceFunction{ DifferenceFunction::AMDF };
+	size_t automaticAMDFMaxSize{ 256 };
+
+	bool usesAMDF(size_t size) const {
+		return differenceFunction == DifferenceFunction::AMDF
+			   || (differenceFunction == DifferenceFunction::Automatic && size <= automaticAMDFMaxSize);
+	}
 };
 
-template<std::random_access_iterator InIt>
-std::optional<PitchInfo> getPitch(InIt first, InIt last, const PitchFindingParameters& parameters = {}) {
-	using data_type = typename std::iterator_traits<InIt>::value_type;
-	const auto size = std::distance(first, last);
+/// @brief Scratch buffers of getPitch(). When the workspace is sized for the longest signal that is analyzed,
+///        repeated pitch detection does not allocate and takes a time that only depends on the signal length.
+///
+/// @tparam T     Sample type
+/// @tparam Alloc Allocator of the buffers
+template<std::floating_point T, class Alloc = std::allocator<T>>
+struct PitchDetectorWorkspace
+{
+	using vector_type = std::vector<T, Alloc>;
+
+	using complex_vector_type = std::vector<std::complex<T>, typename std::allocator_traits<Alloc>::template rebind_alloc<std::complex<T>>>;
+
+	explicit PitchDetectorWorkspace(size_t maxSize = 0, const Alloc& alloc = Alloc())
+		: data(alloc), amdf(alloc), diff(alloc), crossings(alloc), filteredCrossings(alloc), values(alloc),
+		  energies(alloc), signalSpectrum(alloc), correlation(alloc) {
+		reserve(maxSize);
+	}
+
+	/// @brief Prepare for signals of up to maxSize samples, including the FFT for the squared difference function.
+	void reserve(size_t maxSize) {
+		reserveBuffers(maxSize);
+		if (maxSize > 0) prepareFFT(maxSize);
+	}
+
+	/// @brief Prepare the buffers for signals of up to maxSize samples, but not the FFT.
+	void reserveBuffers(size_t maxSize) {
+		// there is at most one crossing per sample of the difference of the amdf
+		for (auto* v : { &data, &amdf, &diff, &crossings, &filteredCrossings, &values })
+			v->reserve(maxSize);
+		energies.reserve(maxSize + 1);
+	}
+
+	/// @brief Make sure that the FFT is large enough for the autocorrelation of a signal of the given size.
+	///        This only allocates if the size exceeds the size the workspace has been prepared for.
+	void prepareFFT(size_t size) {
+		// the signal is padded with zeros to at least twice its length so that the correlation does not wrap around
+		int fftSize = 4;
+		while (static_cast<size_t>(fftSize) < 2 * size) fftSize *= 2;
+		if (plan && plan->size() >= fftSize) return;
+		plan.emplace(fftSize);
+		signalSpectrum.resize(fftSize);
+		correlation.resize(fftSize);
+	}
+
+	vector_type data, amdf, diff, crossings, filteredCrossings, values;
+
+	// for the squared difference function
+	vector_type energies;
+	std::optional<FFTPlan<T>> plan;
+	complex_vector_type signalSpectrum, correlation;
+};
+
+
+namespace detail {
+
+// Squared difference function d[i] = sum_{j=i}^{N-1} (x[j-i] - x[j])^2, expanded into the energies of the two
+// overlapping parts (from prefix sums of x^2) minus twice the autocorrelation, which is computed through an FFT.
+// The output is sqrt((N-i) * d[i]), which has the same scale as the AMDF (and equals it where all differences
+// have the same magnitude), so that the tolerances of the PitchFindingParameters apply to both alike.
+template<std::floating_point T, class Alloc>
+void squaredDifference(PitchDetectorWorkspace<T, Alloc>& workspace) {
+	const auto& x = workspace.data;
+	auto& out = workspace.amdf;
+	const size_t size = x.size();
+
+	workspace.prepareFFT(size);
+	const auto& plan = *workspace.plan;
+	const auto fftSize = static_cast<size_t>(plan.size());
+	auto& spectrum = workspace.signalSpectrum;
+	auto& correlation = workspace.correlation;
+
+	std::copy(x.begin(), x.end(), correlation.begin());
+	std::fill(correlation.begin() + size, correlation.begin() + fftSize, std::complex<T>{});
+	plan.fft(correlation.begin(), spectrum.begin());
+	for (size_t k = 0; k < fftSize; ++k) {
+		spectrum[k] = std::norm(spectrum[k]);
+	}
+	plan.ifft(spectrum.begin(), correlation.begin());
+	// both transforms are normalized by 1/sqrt(fftSize)
+	const T scale = std::sqrt(static_cast<T>(fftSize));
+
+	auto& energies = workspace.energies;
+	energies.resize(size + 1);
+	energies[0] = 0;
+	for (size_t j = 0; j < size; ++j) {
+		energies[j + 1] = energies[j] + x[j] * x[j];
+	}
+
+	for (size_t i = 0; i < size; ++i) {
+		const T delayedEnergy = energies[size - i];
+		const T energy = energies[size] - energies[i];
+		const T difference = std::max(T(0), delayedEnergy + energy - T(2) * scale * correlation[i].real());
+		out[i] = std::sqrt(static_cast<T>(size - i) * difference);
+	}
+}
+
+
+// Find the pitch from the difference function in workspace.amdf (which is normalized in place)
+// by measuring the distances between its minima.
+template<std::floating_point T, class Alloc>
+std::optional<PitchInfo> findPitch(PitchDetectorWorkspace<T, Alloc>& workspace, const PitchFindingParameters& parameters) {
+	using data_type = T;
 	const auto devFilter = parameters.deviationFilter;
 	const auto tol = parameters.tolerance;
 
+	auto& amdf = workspace.amdf;
+	const auto size = amdf.size();
 	if (size < 10) return std::nullopt;
 
-	std::vector<data_type> data(first, last);
-
-	std::vector<data_type> amdf(size);
-	Butterfly::amdf(data.begin(), data.end(), amdf.begin());
 	peak_normalize(amdf.begin(), amdf.end());
 
 	// get extrema of amdf by getting zero crossings of diff(amdf)
-	std::vector<data_type> diff(size - 1);
+	auto& diff = workspace.diff;
+	diff.resize(size - 1);
 	differentiate(amdf.begin(), amdf.end(), diff.begin());
 	peak_normalize(diff.begin(), diff.end());
 
-	const auto crossings = getCrossings(diff.begin(), diff.end(), data_type{ 0 });
+	auto& crossings = workspace.crossings;
+	getCrossings(diff.begin(), diff.end(), crossings, data_type{ 0 });
 
 	// only get extrema that are close to 0 (determined by tolerance)
-	std::vector<data_type> filteredCrossings;
+	auto& filteredCrossings = workspace.filteredCrossings;
+	filteredCrossings.clear();
 	std::copy_if(crossings.begin(), crossings.end(), std::back_inserter(filteredCrossings),
 		[&amdf, tol](auto crossing) {
 			crossing += 0.5;
-			auto z = std::abs(amdf[static_cast<int>(crossing)]);
 			const auto corrected_tolerance = (1 - crossing / amdf.size()) * tol;
 			return std::abs(amdf[static_cast<int>(crossing)]) < corrected_tolerance && crossing > 3.;
 		});
 	if (filteredCrossings.size() < 2) return std::nullopt;
 
 	// get period lengths as differences between periods
-	std::vector<data_type> values(filteredCrossings.size() - 1);
+	auto& values = workspace.values;
+	values.resize(filteredCrossings.size() - 1);
 	differentiate(filteredCrossings.begin(), filteredCrossings.end(), values.begin());
 	// transform to frequency
 	std::for_each(values.begin(), values.end(), [](auto& a) { a = 1 / a; });
@@ -116,4 +234,37 @@ std::optional<PitchInfo> getPitch(InIt first, InIt last, const PitchFindingParam
 	return PitchInfo{ f1, sdv1, maxDeviation };
 }
 
+} // namespace detail
+
+
+/// @brief Find the pitch of a signal, using the buffers of a workspace. No allocation takes place
+///        if the workspace has been reserved for at least the size of the signal.
+template<std::random_access_iterator InIt, std::floating_point T, class Alloc>
+std::optional<PitchInfo> getPitch(InIt first, InIt last, PitchDetectorWorkspace<T, Alloc>& workspace, const PitchFindingParameters& parameters = {}) {
+	const auto size = std::distance(first, last);
+	if (size < 10) return std::nullopt;
+
+	auto& data = workspace.data;
+	data.assign(first, last);
+
+	auto& amdf = workspace.amdf;
+	amdf.resize(size);
+	if (parameters.usesAMDF(static_cast<size_t>(size))) Butterfly::amdf(data.begin(), data.end(), amdf.begin());
+	else detail::squaredDifference(workspace);
+	return detail::findPitch(workspace, parameters);
+}
+
+
+/// @brief Find the pitch of a signal.
+///        The scratch buffers are allocated with the given allocator, so e.g. an ArenaAllocator
+///        can be used to run the analysis without allocating from the system heap.
+///        To analyze signals repeatedly, prefer the overload that takes a PitchDetectorWorkspace.
+template<std::random_access_iterator InIt, class Alloc = std::allocator<typename std::iterator_traits<InIt>::value_type>>
+std::optional<PitchInfo> getPitch(InIt first, InIt last, const PitchFindingParameters& parameters = {}, const Alloc& alloc = Alloc()) {
+	using data_type = typename std::iterator_traits<InIt>::value_type;
+	PitchDetectorWorkspace<data_type, typename std::allocator_traits<Alloc>::template rebind_alloc<data_type>> workspace(0, alloc);
+	workspace.reserveBuffers(static_cast<size_t>(std::distance(first, last)));
+	return getPitch(first, last, workspace, parameters);
+}
+
 }
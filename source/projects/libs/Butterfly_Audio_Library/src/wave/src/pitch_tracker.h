@@ -0,0 +1,188 @@
+// Continuous pitch tracking
+
+
+#pragma once
+
+#include "pitch_detection.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+
+namespace Butterfly {
+
+
+/// @brief Tracks the pitch of a stream of samples. Every hopSize samples, the pitch of the last windowSize
+///        samples is found like getPitch() does, but the difference function of the window (the AMDF or the
+///        squared difference, see PitchFindingParameters) is not computed from scratch. Instead, the terms of
+///        the samples that left the window are subtracted and the terms of the samples that entered it are added,
+///        which takes O(windowSize * hopSize) rather than O(windowSize^2) operations per hop.
+///
+///        The updates are accumulated in double precision, and to keep rounding errors from building up (so that,
+///        for instance, a window of silence is recognized as such) the difference function is computed from scratch
+///        once per window.
+///
+///        All memory is allocated at construction, so process() can be called on the audio thread.
+///
+/// @tparam T     Sample type
+/// @tparam Alloc Allocator of the buffers
+template<std::floating_point T, class Alloc = std::allocator<T>>
+class StreamingPitchTracker
+{
+public:
+	using accumulator_type = std::common_type_t<T, double>;
+
+	/// @param windowSize Number of samples that are analyzed for each estimate (at least 10)
+	/// @param hopSize    Number of samples between two estimates, in [1, windowSize]
+	/// @param parameters Parameters of the pitch detection
+	StreamingPitchTracker(size_t windowSize, size_t hopSize, const PitchFindingParameters& parameters = {}, const Alloc& alloc = Alloc())
+		: windowSize_(std::max<size_t>(windowSize, 10)),
+		  hopSize_(std::clamp<size_t>(hopSize, 1, windowSize_)),
+		  parameters(parameters),
+		  useAMDF(parameters.usesAMDF(windowSize_)),
+		  refreshInterval((windowSize_ + hopSize_ - 1) / hopSize_),
+		  history(windowSize_ + hopSize_, alloc),
+		  difference(windowSize_, alloc),
+		  workspace(0, alloc) {
+		workspace.reserveBuffers(windowSize_);
+		workspace.amdf.resize(windowSize_);
+	}
+
+	/// @brief Add samples to the stream. Whenever a hop is complete, the pitch is estimated and
+	///        passed to onEstimate as a const std::optional<PitchInfo>&.
+	template<class F>
+	void process(const T* input, size_t count, F&& onEstimate) {
+		while (count > 0) {
+			const auto n = std::min(count, hopSize_ - pending);
+			std::copy(input, input + n, history.begin() + windowSize_ + pending);
+			pending += n;
+			input += n;
+			count -= n;
+			if (pending == hopSize_) {
+				advance();
+				onEstimate(pitch);
+			}
+		}
+	}
+
+	/// @brief Add samples to the stream and only keep the latest estimate.
+	void process(const T* input, size_t count) {
+		process(input, count, [](const auto&) {});
+	}
+
+	/// @brief Latest estimate (std::nullopt if no pitch has been found in the last window).
+	const std::optional<PitchInfo>& getPitch() const { return pitch; }
+
+	/// @brief Confidence of the latest estimate in [0, 1], which is 0 if no pitch has been found and
+	///        1 if all periods in the window have the same length.
+	double getConfidence() const { return pitch ? confidence(*pitch, parameters) : 0.0; }
+
+	/// @brief Confidence of an estimate in [0, 1] from the spread of the period lengths, relative to the
+	///        spread that the deviation filter of the parameters allows.
+	static double confidence(const PitchInfo& info, const PitchFindingParameters& parameters) {
+		const auto allowedDeviation = info.frequency * parameters.deviationFilter;
+		if (!(allowedDeviation > 0)) return 0.0;
+		return std::clamp(1.0 - info.standardDeviation / allowedDeviation, 0.0, 1.0);
+	}
+
+	/// @brief Forget the stream, as if only silence had been received.
+	void reset() {
+		std::fill(history.begin(), history.end(), T{});
+		std::fill(difference.begin(), difference.end(), accumulator_type{});
+		pending = 0;
+		hopsSinceRefresh = 0;
+		pitch.reset();
+	}
+
+	size_t windowSize() const { return windowSize_; }
+	size_t hopSize() const { return hopSize_; }
+	const PitchFindingParameters& getParameters() const { return parameters; }
+
+private:
+	using accumulator_vector = std::vector<accumulator_type, typename std::allocator_traits<Alloc>::template rebind_alloc<accumulator_type>>;
+
+	// The history holds the current window followed by the samples of the next hop.
+	void advance() {
+		if (++hopsSinceRefresh >= refreshInterval) {
+			hopsSinceRefresh = 0;
+			if (useAMDF) recompute<false>();
+			else recompute<true>();
+		}
+		else {
+			if (useAMDF) update<false>();
+			else update<true>();
+		}
+		std::copy(history.begin() + hopSize_, history.end(), history.begin());
+		pending = 0;
+		analyze();
+	}
+
+	template<bool squared>
+	static accumulator_type term(T a, T b) {
+		const auto d = static_cast<accumulator_type>(a) - static_cast<accumulator_type>(b);
+		if constexpr (squared) return d * d;
+		else return std::abs(d);
+	}
+
+	template<bool squared>
+	static accumulator_type sum(const T* x, size_t lag, size_t first, size_t last) {
+		accumulator_type s{};
+		for (size_t m = first; m < last; ++m) {
+			s += term<squared>(x[m - lag], x[m]);
+		}
+		return s;
+	}
+
+	// Difference function of the next window, history[hopSize, windowSize + hopSize)
+	template<bool squared>
+	void recompute() {
+		const auto* y = history.data() + hopSize_;
+		for (size_t lag = 0; lag < windowSize_; ++lag) {
+			difference[lag] = sum<squared>(y, lag, lag, windowSize_);
+		}
+	}
+
+	// d'[lag] = d[lag] - sum_{m=lag}^{lag+H-1} f(x[m-lag], x[m]) + sum_{m=N}^{N+H-1} f(x[m-lag], x[m])
+	// For large lags, where the window holds fewer terms than the update touches, the sum is computed directly.
+	template<bool squared>
+	void update() {
+		const auto* x = history.data();
+		const auto N = windowSize_, H = hopSize_;
+		for (size_t lag = 0; lag < N; ++lag) {
+			if (N - lag <= 2 * H) difference[lag] = sum<squared>(x + H, lag, lag, N);
+			else difference[lag] += sum<squared>(x, lag, N, N + H) - sum<squared>(x, lag, lag, lag + H);
+		}
+	}
+
+	void analyze() {
+		auto& out = workspace.amdf;
+		bool silent = true;
+		for (size_t lag = 0; lag < windowSize_; ++lag) {
+			const auto d = std::max(accumulator_type{}, difference[lag]);
+			// the squared difference is brought to the scale of the AMDF, like in getPitch()
+			out[lag] = static_cast<T>(useAMDF ? d : std::sqrt(static_cast<accumulator_type>(windowSize_ - lag) * d));
+			silent = silent && out[lag] == T{};
+		}
+		if (silent) pitch.reset();
+		else pitch = detail::findPitch(workspace, parameters);
+	}
+
+	size_t windowSize_;
+	size_t hopSize_;
+	PitchFindingParameters parameters;
+	bool useAMDF;
+	size_t refreshInterval;
+
+	std::vector<T, Alloc> history;
+	accumulator_vector difference;
+	PitchDetectorWorkspace<T, Alloc> workspace;
+
+	size_t pending{};
+	size_t hopsSinceRefresh{};
+	std::optional<PitchInfo> pitch;
+};
+
+}
@@ -0,0 +1,206 @@
+// State variable filter for audio-rate modulation of the cutoff frequency.
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <numbers>
+#include <span>
+#include "biquad_filter.h"
+
+namespace Butterfly {
+
+
+/// @brief Table of the frequency prewarping tan(pi * f / samplerate) of the bilinear transform,
+///        over normalized frequencies f / samplerate in [0, maxFrequency], to be interpolated
+///        linearly.
+///
+///        The grid is uniform rather than logarithmic, so that looking up a frequency needs no
+///        logarithm. This suffices because tan(pi * x) is almost linear for low frequencies,
+///        where a logarithmic grid would be needed for other functions: the relative error of
+///        the interpolation stays below 1e-4 over the whole range.
+///
+///        There is one table per sample type, which is computed on first use.
+template<std::floating_point T>
+class PrewarpTable
+{
+public:
+	static constexpr size_t size = 4096;
+	static constexpr T maxFrequency = T(0.49);
+
+	static const PrewarpTable& instance() {
+		static const PrewarpTable table;
+		return table;
+	}
+
+	/// @brief Prewarped frequency for a frequency normalized to the samplerate, which is
+	///        clamped to [0, maxFrequency].
+	T operator()(T normalizedFrequency) const {
+		const T position = std::clamp(normalizedFrequency, T(0), maxFrequency) * scale;
+		const auto index = static_cast<size_t>(position);
+		const T t = position - static_cast<T>(index);
+		return values[index] + t * (values[index + 1] - values[index]);
+	}
+
+private:
+	PrewarpTable() {
+		for (size_t i = 0; i <= size; ++i) {
+			values[i] = static_cast<T>(std::tan(std::numbers::pi * static_cast<double>(maxFrequency) * static_cast<double>(i) / size));
+		}
+		values[size + 1] = values[size]; // read (with a weight of 0) at maxFrequency
+	}
+
+	static constexpr T scale = T(size) / maxFrequency;
+	std::array<T, size + 2> values{};
+};
+
+
+/// @brief Filter with the responses of BiquadFilter (which are those of the RBJ cookbook), in the
+///        topology-preserving (trapezoidal) state variable form. Unlike a direct form biquad, its
+///        state stays valid when the coefficients change, so the cutoff frequency may be changed
+///        every sample without clicks or instability.
+///
+///        Changing the frequency does not evaluate any trigonometric function: the prewarped
+///        frequency is interpolated from a PrewarpTable and the coefficients then follow with one
+///        division. Changes of the gain or the type are more expensive (std::pow) and meant for
+///        control rate.
+///
+/// Usage example:
+/// \code
+///     SvfFilter<float> filter{ 48000., 1000. };
+///     filter.setType(SvfFilter<float>::Type::Lowpass);
+///     filter.process(block, cutoff); // one cutoff frequency per sample
+/// \endcode
+///
+/// @tparam T Sample type
+template<std::floating_point T>
+class SvfFilter
+{
+public:
+	using value_type = T;
+	using Type = typename BiquadFilter<T>::Type;
+
+	constexpr SvfFilter() = default;
+
+	SvfFilter(double samplerate, double frequency, T q = std::numbers::sqrt2_v<T> / T(2))
+		: invSamplerate(T(1) / static_cast<T>(samplerate)),
+		  frequency(static_cast<T>(frequency)),
+		  q(q) {
+		updateShape();
+	}
+
+	void setSamplerate(double samplerate) {
+		invSamplerate = T(1) / static_cast<T>(samplerate);
+		setFrequency(frequency);
+	}
+
+	/// @brief Set the cutoff (or center) frequency. This is cheap enough to be called every sample.
+	void setFrequency(T frequency) {
+		this->frequency = frequency;
+		updateCoefficients(prewarp(frequency) * gScale);
+	}
+
+	void setQ(T q) {
+		this->q = q;
+		updateShape();
+	}
+
+	/// @brief Set the gain in dB of the peak and shelf types.
+	void setGain(T gain) {
+		this->gain = gain;
+		updateShape();
+	}
+
+	void setType(Type type) {
+		this->type = type;
+		updateShape();
+	}
+
+	constexpr T operator()(T x) {
+		const T v3 = x - ic2;
+		const T v1 = a1 * ic1 + a2 * v3;
+		const T v2 = ic2 + a2 * ic1 + a3 * v3;
+		ic1 = T(2) * v1 - ic1;
+		ic2 = T(2) * v2 - ic2;
+		return m0 * x + m1 * v1 + m2 * v2;
+	}
+
+	/// @brief Filter a block of samples in place at the current frequency.
+	void process(std::span<T> block) {
+		for (auto& x : block) x = (*this)(x);
+	}
+
+	/// @brief Filter a block of samples in place, changing the frequency every sample.
+	/// @param frequency Frequency for each sample of the block
+	void process(std::span<T> block, const T* frequency) {
+		const auto& table = PrewarpTable<T>::instance();
+		for (size_t i = 0; i < block.size(); ++i) {
+			updateCoefficients(table(frequency[i] * invSamplerate) * gScale);
+			block[i] = (*this)(block[i]);
+		}
+		this->frequency = block.empty() ? this->frequency : frequency[block.size() - 1];
+	}
+
+	/// @brief Clear the state.
+	constexpr void reset() { ic1 = ic2 = T(0); }
+
+	T getSamplerate() const { return T(1) / invSamplerate; }
+	T getFrequency() const { return frequency; }
+	T getGain() const { return gain; }
+	T getQ() const { return q; }
+	Type getType() const { return type; }
+
+private:
+	T prewarp(T frequency) const { return PrewarpTable<T>::instance()(frequency * invSamplerate); }
+
+	constexpr void updateCoefficients(T g) {
+		a1 = T(1) / (T(1) + g * (g + k));
+		a2 = g * a1;
+		a3 = g * a2;
+	}
+
+	// Damping, output mix and frequency scale for the type, gain and q
+	void updateShape() {
+		const T A = static_cast<T>(std::pow(T(10), gain * T(0.025)));
+		k = T(1) / q;
+		gScale = T(1);
+
+		switch (type) {
+		case Type::Lowpass: m0 = 0, m1 = 0, m2 = 1; break;
+		case Type::Highpass: m0 = 1, m1 = -k, m2 = -1; break;
+		case Type::Bandpass: m0 = 0, m1 = k, m2 = 0; break; // constant 0 dB peak gain
+		case Type::Notch: m0 = 1, m1 = -k, m2 = 0; break;
+		case Type::Allpass: m0 = 1, m1 = -2 * k, m2 = 0; break;
+		case Type::Peak:
+			k = T(1) / (q * A);
+			m0 = 1, m1 = k * (A * A - 1), m2 = 0;
+			break;
+		case Type::Lowshelf:
+			gScale = T(1) / std::sqrt(A);
+			m0 = 1, m1 = k * (A - 1), m2 = A * A - 1;
+			break;
+		case Type::Highshelf:
+			gScale = std::sqrt(A);
+			m0 = A * A, m1 = k * (1 - A) * A, m2 = 1 - A * A;
+			break;
+		}
+		setFrequency(frequency);
+	}
+
+
+	T invSamplerate{};
+	T frequency{};
+	T q{ std::numbers::sqrt2_v<T> / T(2) };
+	T gain{};
+	Type type{ Type::Lowpass };
+
+	T k{}, gScale{ 1 };
+	T a1{}, a2{}, a3{};
+	T m0{}, m1{}, m2{};
+	T ic1{}, ic2{}; // integrator states
+};
+
+}
@@ -1,12 +1,114 @@
 #pragma once
 #include <algorithm>
+#include <concepts>
 #include <iterator>
+#include <memory>
 #include <vector>
 #include <cmath>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 
 namespace Butterfly {
 
+namespace detail {
+
+// Fast paths for contiguous ranges of float or double (e.g. pointers, std::vector or std::span iterators).
+// The reductions are split into independent partial results so that the compiler can keep them in the lanes
+// of SIMD registers without having to reorder floating-point operations itself, which it may not do for sums
+// (as it changes the rounding) unless asked to with flags like -ffast-math.
+
+template<class It>
+concept contiguous_floating_point_iterator = std::contiguous_iterator<It> && std::floating_point<std::iter_value_t<It>>;
+
+namespace contiguous {
+
+inline constexpr size_t reductionLanes = 8;
+
+template<std::floating_point T>
+T peak(const T* x, size_t size) {
+	T lanes[reductionLanes]{};
+	size_t i = 0;
+	for (; i + reductionLanes <= size; i += reductionLanes) {
+		for (size_t k = 0; k < reductionLanes; ++k) {
+			lanes[k] = std::max(lanes[k], std::abs(x[i + k]));
+		}
+	}
+	for (; i < size; ++i) {
+		lanes[0] = std::max(lanes[0], std::abs(x[i]));
+	}
+	return *std::max_element(lanes, lanes + reductionLanes);
+}
+
+template<std::floating_point T>
+T sumOfSquares(const T* x, size_t size) {
+	T lanes[reductionLanes]{};
+	size_t i = 0;
+	for (; i + reductionLanes <= size; i += reductionLanes) {
+		for (size_t k = 0; k < reductionLanes; ++k) {
+			lanes[k] += x[i + k] * x[i + k];
+		}
+	}
+	for (; i < size; ++i) {
+		lanes[0] += x[i] * x[i];
+	}
+	T sum{};
+	for (size_t k = 0; k < reductionLanes; ++k) sum += lanes[k];
+	return sum;
+}
+
+// Peak and sum of squares in one pass over the data
+template<std::floating_point T>
+std::pair<T, T> peakAndSumOfSquares(const T* x, size_t size) {
+	T peaks[reductionLanes]{};
+	T sums[reductionLanes]{};
+	size_t i = 0;
+	for (; i + reductionLanes <= size; i += reductionLanes) {
+		for (size_t k = 0; k < reductionLanes; ++k) {
+			peaks[k] = std::max(peaks[k], std::abs(x[i + k]));
+			sums[k] += x[i + k] * x[i + k];
+		}
+	}
+	for (; i < size; ++i) {
+		peaks[0] = std::max(peaks[0], std::abs(x[i]));
+		sums[0] += x[i] * x[i];
+	}
+	T sum{};
+	for (size_t k = 0; k < reductionLanes; ++k) sum += sums[k];
+	return { *std::max_element(peaks, peaks + reductionLanes), sum };
+}
+
+template<std::floating_point T>
+void scale(T* x, size_t size, T factor) {
+	for (size_t i = 0; i < size; ++i) {
+		x[i] *= factor;
+	}
+}
+
+// out[i] = in[i+1] - in[i], where out may be equal to in
+template<std::floating_point T>
+void differentiate(const T* in, size_t size, T* out) {
+	for (size_t i = 0; i + 1 < size; ++i) {
+		out[i] = in[i + 1] - in[i];
+	}
+}
+
+// Number of indices i in [1, size) where x[i-1] and x[i] lie on different sides of the value
+template<std::floating_point T, class V>
+size_t countCrossings(const T* x, size_t size, V value) {
+	size_t count{};
+	for (size_t i = 1; i < size; ++i) {
+		count += (x[i - 1] > value) != (x[i] > value);
+	}
+	return count;
+}
+
+} // namespace contiguous
+
+} // namespace detail
+
+
 /// @brief  Get absolute maximum of signal (peak value).
 /// @tparam It    Input iterator, must meet the requirements of LegacyForwardIterator
 /// @param  first Signal range start
@@ -14,6 +116,10 @@ namespace Butterfly {
 /// @return Peak value
 template<std::forward_iterator It>
 typename std::iterator_traits<It>::value_type peak(It first, It last) {
+	if constexpr (detail::contiguous_floating_point_iterator<It>) {
+		if (first == last) return {};
+		return detail::contiguous::peak(std::to_address(first), static_cast<size_t>(last - first));
+	}
 	typename std::iterator_traits<It>::value_type abs_max{};
 	std::for_each(first, last, [&abs_max](const auto& v) { abs_max = std::max(abs_max, std::abs(v)); });
 	return abs_max;
@@ -28,11 +134,40 @@ typename std::iterator_traits<It>::value_type peak(It first, It last) {
 template<std::forward_iterator It>
 typename std::iterator_traits<It>::value_type rms(It first, It last) {
 	typename std::iterator_traits<It>::value_type rms{};
-	std::for_each(first, last, [&rms](const auto& v) { rms += v * v; });
+	if constexpr (detail::contiguous_floating_point_iterator<It>) {
+		if (first != last) rms = detail::contiguous::sumOfSquares(std::to_address(first), static_cast<size_t>(last - first));
+	}
+	else {
+		std::for_each(first, last, [&rms](const auto& v) { rms += v * v; });
+	}
 	return static_cast<typename std::iterator_traits<It>::value_type>(std::sqrt(rms / static_cast<double>(std::distance(first, last))));
 }
 
 
+/// @brief  Get peak value and RMS of signal in a single pass.
+/// @tparam It    Input iterator, must meet the requirements of LegacyForwardIterator
+/// @param  first Signal range start
+/// @param  last  Signal range end
+/// @return Pair of peak value and RMS
+template<std::forward_iterator It>
+std::pair<typename std::iterator_traits<It>::value_type, typename std::iterator_traits<It>::value_type> peak_and_rms(It first, It last) {
+	using value_type = typename std::iterator_traits<It>::value_type;
+	value_type abs_max{}, sum{};
+	size_t size{};
+	if constexpr (detail::contiguous_floating_point_iterator<It>) {
+		size = static_cast<size_t>(last - first);
+		if (size != 0) std::tie(abs_max, sum) = detail::contiguous::peakAndSumOfSquares(std::to_address(first), size);
+	}
+	else {
+		for (auto it = first; it != last; ++it, ++size) {
+			abs_max = std::max(abs_max, std::abs(*it));
+			sum += *it * *it;
+		}
+	}
+	return { abs_max, static_cast<value_type>(std::sqrt(sum / static_cast<double>(size))) };
+}
+
+
 /// @brief  Normalize signal by peak to range [-\value,\value].
 /// @tparam It    Input-output iterator, must meet the requirements of LegacyForwardIterator
 /// @param  first start of range
@@ -41,6 +176,10 @@ typename std::iterator_traits<It>::value_type rms(It first, It last) {
 template<std::forward_iterator It>
 void peak_normalize(It first, It last, typename std::iterator_traits<It>::value_type value = 1.0) {
 	const auto inv = value / peak(first, last);
+	if constexpr (detail::contiguous_floating_point_iterator<It>) {
+		if (first != last) detail::contiguous::scale(std::to_address(first), static_cast<size_t>(last - first), inv);
+		return;
+	}
 	for (auto it = first; it != last; ++it)
 		*it *= inv;
 }
@@ -54,26 +193,50 @@ void peak_normalize(It first, It last, typename std::iterator_traits<It>::value_
 template<std::forward_iterator It>
 void rms_normalize(It first, It last, typename std::iterator_traits<It>::value_type value = 1.0) {
 	const auto inv = value / rms(first, last);
+	if constexpr (detail::contiguous_floating_point_iterator<It>) {
+		if (first != last) detail::contiguous::scale(std::to_address(first), static_cast<size_t>(last - first), inv);
+		return;
+	}
 	for (auto it = first; it != last; ++it)
 		*it *= inv;
 }
 
 
 
-/// @brief Get points where given data crosses the given value. 
-/// 
+/// @brief Get points where given data crosses the given value and write them into an existing vector
+///        (which is cleared first), so no allocation takes place as long as its capacity suffices.
+///
 /// @tparam InIt           Input iterator
-/// @tparam T              output data type (defaults to double)
+/// @tparam T              output data type
+/// @tparam Alloc          allocator of the output vector
 /// @param first           start of range
 /// @param last            end of range
+/// @param crossings       output vector of zero crossings
 /// @param value           crossing value
 /// @param maxNumberToFind stop searching once this number of crossings have been found
-/// @return vector of zero crossings
-template<std::forward_iterator InIt, std::floating_point T = double>
-std::vector<T> getCrossings(InIt first, InIt last, T value = 0, size_t maxNumberToFind = std::numeric_limits<size_t>::max()) {
-	if (first == last) return {};
+template<std::forward_iterator InIt, std::floating_point T, class Alloc>
+void getCrossings(InIt first, InIt last, std::vector<T, Alloc>& crossings, T value = 0, size_t maxNumberToFind = std::numeric_limits<size_t>::max()) {
+	crossings.clear();
+	if (first == last) return;
 
-	std::vector<T> crossings;
+	if constexpr (detail::contiguous_floating_point_iterator<InIt>) {
+		// scan blocks for crossings with a loop that can be vectorized (as crossings are usually rare)
+		// and only find the positions in the blocks that have some
+		constexpr size_t blockSize = 64;
+		const auto* x = std::to_address(first);
+		const auto size = static_cast<size_t>(last - first);
+		for (size_t start = 1; start < size && crossings.size() < maxNumberToFind; start += blockSize) {
+			const auto end = std::min(start + blockSize, size);
+			if (detail::contiguous::countCrossings(x + start - 1, end - start + 1, value) == 0) continue;
+			for (size_t i = start; i < end && crossings.size() < maxNumberToFind; ++i) {
+				if ((x[i] > value) != (x[i - 1] > value)) {
+					const T dy = x[i] - x[i - 1];
+					crossings.push_back(-(x[i] - dy * static_cast<T>(i) - value) / dy);
+				}
+			}
+		}
+		return;
+	}
 
 	auto previousValue = *first;
 	bool isAbove = previousValue > value;
@@ -92,6 +255,24 @@ std::vector<T> getCrossings(InIt first, InIt last, T value = 0, size_t maxNumber
 		++it;
 		++count;
 	}
+}
+
+
+/// @brief Get points where given data crosses the given value. 
+/// 
+/// @tparam InIt           Input iterator
+/// @tparam T              output data type (defaults to double)
+/// @tparam Alloc          allocator of the output vector
+/// @param first           start of range
+/// @param last            end of range
+/// @param value           crossing value
+/// @param maxNumberToFind stop searching once this number of crossings have been found
+/// @param alloc           allocator of the output vector
+/// @return vector of zero crossings
+template<std::forward_iterator InIt, std::floating_point T = double, class Alloc = std::allocator<T>>
+std::vector<T, Alloc> getCrossings(InIt first, InIt last, T value = 0, size_t maxNumberToFind = std::numeric_limits<size_t>::max(), const Alloc& alloc = Alloc()) {
+	std::vector<T, Alloc> crossings(alloc);
+	getCrossings(first, last, crossings, value, maxNumberToFind);
 	return crossings;
 }
 
@@ -103,6 +284,11 @@ std::vector<T> getCrossings(InIt first, InIt last, T value = 0, size_t maxNumber
 /// @param firstOut Iterator to first output element. This must point to some storage that is at least as big as the input range minus 1.
 template<std::forward_iterator InIt, std::forward_iterator OutIt>
 void differentiate(InIt firstIn, InIt lastIn, OutIt firstOut) {
+	if constexpr (detail::contiguous_floating_point_iterator<InIt> && std::contiguous_iterator<OutIt>
+				  && std::is_same_v<std::iter_value_t<InIt>, std::iter_value_t<OutIt>>) {
+		if (firstIn != lastIn) detail::contiguous::differentiate(std::to_address(firstIn), static_cast<size_t>(lastIn - firstIn), std::to_address(firstOut));
+		return;
+	}
 	auto inIt = firstIn;
 	auto previousValue = *inIt;
 	++inIt;
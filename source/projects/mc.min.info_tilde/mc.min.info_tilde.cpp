@@ -24,40 +24,59 @@ public:
     outlet<> m_outlet_low		{ this, "(signal) lowest value among the signals", "signal" };
     outlet<> m_outlet_high		{ this, "(signal) highest value among the signals", "signal" };
 
-    void operator()(audio_bundle input, audio_bundle output) {
-        auto	out_channels	{ output.samples(0) };
-        auto	out_low_n		{ output.samples(1) };
-        auto	out_high_n		{ output.samples(2) };
-        auto	out_low			{ output.samples(3) };
-        auto	out_high		{ output.samples(4) };
-
-        for (auto i = 0; i < input.frame_count(); ++i) {
-            sample	low_n	{ -1 };
-            sample	high_n	{ -1 };
-            sample	low		{ std::numeric_limits<sample>::max() };
-            sample	high	{ -std::numeric_limits<sample>::max() };
-
-            for (auto channel = 0; channel < input.channel_count(); ++channel) {
-                auto in { input.samples(channel)[i] };
-
-                if (in > high) {
-                    high = in;
-                    high_n = channel;
-                }
-                if (in < low) {
-                    low = in;
-                    low_n = channel;
-                }
-            }
-
-            out_channels[i] = input.channel_count();
-            out_low_n[i] = low_n;
-            out_high_n[i] = high_n;
-            out_low[i] = low;
-            out_high[i] = high;
+    attribute<int> m_groupsize { this, "groupsize", 0,
+        title { "Channel Group Size" },
+        description { "Number of channels analyzed together by one worker thread. "
+                      "0 analyzes all channels serially on the audio thread." },
+        setter { MIN_FUNCTION {
+            int size = args[0];
+            if (size < 0)
+                size = 0;
+            channel_group_size(size);
+            return { size };
+        }}
+    };
+
+    message<> dspsetup { this, "dspsetup",
+        MIN_FUNCTION {
+            long vector_size = args[1];
+            for (auto& group : m_groups)
+                group.resize(vector_size);
+            return {};
         }
+    };
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        const auto	channel_count	{ input.channel_count() };
+        const auto	frame_count		{ input.frame_count() };
+        const auto	group_count		{ channel_group_count(channel_count, frame_count) };
+
+        // only grows (and allocates) when the number of channel groups increases
+        if (m_groups.size() < group_count)
+            m_groups.resize(group_count);
+
+        for_each_channel_group(channel_count, frame_count, [&](const long first, const long end, const size_t group) {
+            m_groups[group].reset(frame_count);
+            m_groups[group].accumulate(input, first, end);
+        });
+
+        auto& result { m_groups[0] };
+        for (auto group = 1u; group < group_count; ++group)
+            result.merge(m_groups[group]);
+
+        const auto	bytes			{ static_cast<size_t>(frame_count) * sizeof(sample) };
+        auto		out_channels	{ output.samples(0) };
+
+        for (auto i = 0; i < frame_count; ++i)
+            out_channels[i] = channel_count;
+        std::memcpy(output.samples(1), result.low_channel(), bytes);
+        std::memcpy(output.samples(2), result.high_channel(), bytes);
+        std::memcpy(output.samples(3), result.low(), bytes);
+        std::memcpy(output.samples(4), result.high(), bytes);
     }
 
+private:
+    vector<channel_extrema<>> m_groups { 1 };
 };
 
 MIN_EXTERNAL(mc_info_tilde);
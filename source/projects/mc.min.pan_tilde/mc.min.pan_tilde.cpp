@@ -0,0 +1,205 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "../shared/signal_routing_objects.h"
+
+// The mc.min.pan~ object inherits its attributes and messages from the signal_routing_base class, just as min.pan~ does.
+// The position moves around a ring of speakers rather than from left to right.
+
+
+class mc_panner : public signal_routing_base<mc_panner>, public mc_operator<> {
+public:
+	MIN_DESCRIPTION {"Pan an input around a ring of speakers, with one output channel per speaker. "
+					 "As in vector-base amplitude panning (VBAP), only the two speakers adjacent to the direction of the input play it. "
+					 "Their share of the input follows the tangent law of VBAP, and is then weighted using the shape."};
+	MIN_TAGS {"audio, routing, spatialization"};
+	MIN_AUTHOR {"Cycling '74"};
+	MIN_RELATED {"min.pan~, mc.min.xfade~, mc.pan~"};
+
+	inlet<>  m_inlet {this, "(signal) Input, only its first channel is panned"};
+	outlet<> m_outlet {this, "(multichannelsignal) One channel per speaker", "multichannelsignal"};
+
+private:
+	// declared before the attributes, whose setters request a new layout
+
+	struct speaker {
+		double azimuth;    // radians, clockwise from the front
+		size_t channel;
+	};
+
+	using layout = vector<speaker>;    // sorted by azimuth
+
+	mutex                   m_mutex;
+	std::unique_ptr<layout> m_layout;
+
+	queue<> m_rebuild { this,
+		MIN_FUNCTION {
+			rebuild();
+			return {};
+		}
+	};
+
+public:
+	attribute<int> m_channels {this, "channels", 4,
+		description {"Number of speakers, which are spread evenly around the ring starting at the front, "
+					 "unless their directions are set with the 'speakers' attribute. "
+					 "A change of the number of channels takes effect when the audio is turned on again."},
+		setter { MIN_FUNCTION {
+			m_rebuild.set();
+			return { MIN_CLAMP(static_cast<int>(args[0]), 1, 64) };
+		}}
+	};
+
+
+	attribute<numbers> m_speakers {this, "speakers", {},
+		description {"Directions of the speakers in degrees, clockwise from the front, one for each output channel. "
+					 "When set, this overrides the 'channels' attribute. "
+					 "The position 0..1 moves the input once around the ring, from 0 to 360 degrees."},
+		setter { MIN_FUNCTION {
+			m_rebuild.set();
+			return args;
+		}}
+	};
+
+
+	message<> multichanneloutputs { this, "multichanneloutputs",
+		MIN_FUNCTION {
+			return { speaker_count() };
+		}
+	};
+
+
+	message<> dspsetup {this, "dspsetup",
+		MIN_FUNCTION {
+			rebuild();
+			return {};
+		}
+	};
+
+
+	/// Process one vector of audio.
+	/// The weights are calculated once for each sample while the position ramps, and once for the rest of the vector.
+	/// Only the two channels with a weight other than zero are written, all others are silent.
+
+	void operator()(audio_bundle input, audio_bundle output) {
+		const auto channel_count = static_cast<size_t>(output.channel_count());
+		const auto n             = static_cast<size_t>(output.frame_count());
+		const auto in            = input.samples(0);
+
+		output.clear();
+
+		lock lock {m_mutex, std::try_to_lock};
+		if (!lock.owns_lock() || !m_layout || m_layout->empty())
+			return;
+
+		const auto& speakers = *m_layout;
+		size_t      i        = 0;
+		double      p        = position;
+
+		for (; i < n; ++i) {
+			p = position.smoothed();
+			if (!position.is_ramping())
+				break;
+
+			const auto w = ring_weights(speakers, p);
+			if (w.first < channel_count)
+				output.samples(w.first)[i] += in[i] * w.weight1;
+			if (w.second < channel_count)
+				output.samples(w.second)[i] += in[i] * w.weight2;
+		}
+
+		if (i == n)
+			return;
+
+		const auto w = ring_weights(speakers, p);
+		if (w.first == w.second) {
+			if (w.first < channel_count)
+				std::copy(in + i, in + n, output.samples(w.first) + i);
+			return;
+		}
+		if (w.first < channel_count) {
+			auto out = output.samples(w.first);
+			for (auto j = i; j < n; ++j)
+				out[j] = in[j] * w.weight1;
+		}
+		if (w.second < channel_count) {
+			auto out = output.samples(w.second);
+			for (auto j = i; j < n; ++j)
+				out[j] = in[j] * w.weight2;
+		}
+	}
+
+private:
+	int speaker_count() {
+		const auto& directions = m_speakers.get();
+		return directions.empty() ? static_cast<int>(m_channels) : static_cast<int>(directions.size());
+	}
+
+
+	// The layout is prepared (which allocates) before taking the lock, so the audio thread is only ever blocked for the swap.
+
+	void rebuild() {
+		const auto& directions = m_speakers.get();
+		const auto  count      = static_cast<size_t>(speaker_count());
+		auto        speakers   = std::make_unique<layout>(count);
+
+		for (size_t channel = 0; channel < count; ++channel) {
+			const auto degrees = directions.empty() ? 360.0 * channel / count : static_cast<double>(directions[channel]);
+			const auto wrapped = std::fmod(std::fmod(degrees, 360.0) + 360.0, 360.0);
+
+			(*speakers)[channel] = { wrapped * M_PI / 180.0, channel };
+		}
+		std::sort(speakers->begin(), speakers->end(), [](const speaker& a, const speaker& b) {
+			return a.azimuth < b.azimuth;
+		});
+
+		lock lock {m_mutex};
+		std::swap(m_layout, speakers);
+	}
+
+
+	// The speakers to either side of the direction of the position are panned between, like a stereo pair.
+	// The gains of 2-D VBAP for a direction at angle d from the first of two speakers that are a apart are
+	// proportional to sin(a - d) and sin(d), so the share of the second speaker is sin(d) / (sin(a - d) + sin(d)).
+	// Two speakers that are 180 degrees or more apart do not form a base, so the share then follows the angle.
+
+	channel_pair ring_weights(const layout& speakers, const double position) {
+		if (speakers.size() == 1)
+			return {speakers[0].channel, speakers[0].channel, 1.0, 0.0};
+
+		const auto two_pi    = 2.0 * M_PI;
+		const auto direction = MIN_CLAMP(position, 0.0, 1.0) * two_pi;
+
+		auto next = std::upper_bound(speakers.begin(), speakers.end(), direction, [](const double d, const speaker& s) {
+			return d < s.azimuth;
+		});
+		if (next == speakers.end())
+			next = speakers.begin();
+		const auto& second = *next;
+		const auto& first  = next == speakers.begin() ? speakers.back() : *(next - 1);
+
+		auto aperture = second.azimuth - first.azimuth;
+		auto offset   = direction - first.azimuth;
+		if (aperture <= 0.0)
+			aperture += two_pi;
+		if (offset < 0.0)
+			offset += two_pi;
+
+		double share;
+		if (aperture < M_PI) {
+			const auto s1 = std::sin(aperture - offset);
+			const auto s2 = std::sin(offset);
+			share         = s2 / (s1 + s2);
+		}
+		else
+			share = offset / aperture;
+
+		const auto w = calculate_weights(MIN_CLAMP(share, 0.0, 1.0));
+		return {first.channel, second.channel, w.first, w.second};
+	}
+};
+
+MIN_EXTERNAL(mc_panner);
@@ -0,0 +1,100 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "../shared/shared_memory_ring.h"
+
+using namespace c74::min;
+
+
+class mc_shm_send : public object<mc_shm_send>, public mc_operator<> {
+public:
+    MIN_DESCRIPTION	{ "Stream a multi-channel signal to another process through shared memory. "
+                      "The other process reads the audio in place with the reader of shared_memory_ring.h, "
+                      "which documents the layout of the memory." };
+    MIN_TAGS		{ "audio, routing" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "min.shm.send, send~, mc.send~" };
+
+    inlet<> input { this, "(multichannelsignal) input to be streamed" };
+
+
+    argument<symbol> name_arg { this, "name", "The name of the shared memory.",
+        MIN_ARGUMENT_FUNCTION {
+            name = arg;
+        }
+    };
+
+
+    attribute<symbol> name { this, "name", "",
+        description {"The name of the shared memory, e.g. /analysis on macOS and Linux or Local\\analysis on Windows. "
+                     "A change takes effect when the audio is turned on again."}
+    };
+
+
+    attribute<int> channels { this, "channels", 2,
+        description {"Number of channels in each frame of the shared memory. Channels of the input beyond it are not streamed, "
+                     "and missing ones are streamed as silence. A change takes effect when the audio is turned on again."},
+        setter { MIN_FUNCTION {
+            return { std::max(static_cast<int>(args[0]), 1) };
+        }}
+    };
+
+
+    attribute<number> size { this, "size", 500.0,
+        description {"Milliseconds of audio that can wait for the other process to read them. "
+                     "Vectors that do not fit are dropped and counted. A change takes effect when the audio is turned on again."},
+        setter { MIN_FUNCTION {
+            return { std::max(static_cast<double>(args[0]), 10.0) };
+        }}
+    };
+
+
+    attribute<int> dropped { this, "dropped", 0,
+        description {"Number of frames dropped because the other process fell behind, since the audio was last turned on."},
+        readonly {true},
+        getter { MIN_GETTER_FUNCTION {
+            return { m_ring.valid() ? static_cast<int>(m_ring.header().dropped.load() / m_ring.frame_size()) : 0 };
+        }}
+    };
+
+
+    // The memory is created when the audio is turned on, when the samplerate is known,
+    // and stays until the audio is turned on again or the object is freed, so the other process can read the last of it.
+
+    message<> dspsetup { this, "dspsetup",
+        MIN_FUNCTION {
+            const double samplerate     = args[0];
+            const auto   channel_count  = static_cast<uint32_t>(static_cast<int>(channels));
+            const auto   frame_size     = channel_count * sizeof(float);
+            const auto   capacity       = static_cast<uint64_t>(samplerate * size / 1000.0) * frame_size;
+            const symbol shm_name       = name;
+
+            m_ring = {};
+            m_memory.close();
+            if (shm_name.empty())
+                return {};
+
+            if (!m_memory.create(shm_name.c_str(), shared_memory_ring::memory_size(capacity))) {
+                cerr << "could not create the shared memory " << shm_name << endl;
+                return {};
+            }
+            m_ring.create(m_memory.data(), shared_ring_header::kind::audio, channel_count, samplerate, capacity);
+            return {};
+        }
+    };
+
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        if (m_ring.valid())
+            m_ring.write_audio(input.samples(), input.channel_count(), input.frame_count());
+    }
+
+private:
+    shared_memory       m_memory;
+    shared_memory_ring  m_ring;
+};
+
+MIN_EXTERNAL(mc_shm_send);
@@ -0,0 +1,216 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "antialiase.h"
+#include "signal_generators.h"
+#include "wavetable.h"
+#include "wavetable_oscillator_bank.h"
+
+using namespace c74::min;
+
+
+class unison : public object<unison>, public mc_operator<> {
+public:
+    MIN_DESCRIPTION	{ "A stack of detuned, band-limited wavetable oscillators. "
+                      "Every voice plays the same waveform at a ratio of the frequency that is spread evenly across the detune range, "
+                      "and is output on a channel of its own. All voices are computed together in one oscillator bank." };
+    MIN_TAGS		{ "audio, oscillator" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "mc.cycle~, mc.saw~, cycle~, min.phasor~" };
+
+    inlet<>  m_inlet	{ this, "(signal/number) frequency" };
+    outlet<> m_outlet	{ this, "(multichannelsignal) one channel per voice", "multichannelsignal" };
+
+private:
+    // declared before the attributes, whose setters request a new bank
+
+    using bank_type = Butterfly::WavetableOscillatorBank<sample>;
+
+    static constexpr int k_table_size { 2048 };
+    static constexpr int k_level_count { 11 };    // octaves from 20 Hz up to 20480 Hz
+
+    mutex                       m_mutex;
+    std::unique_ptr<bank_type>  m_bank;
+    double                      m_applied_detune { -1.0 };    // detune that the ratios of m_bank were computed for
+
+    queue<> m_rebuild { this,
+        MIN_FUNCTION {
+            rebuild();
+            return {};
+        }
+    };
+
+public:
+    argument<number> frequency_arg { this, "frequency", "Initial frequency in hertz.",
+        MIN_ARGUMENT_FUNCTION {
+            frequency = arg;
+        }
+    };
+
+    message<> m_number { this, "number", "Set the frequency in Hz.",
+        MIN_FUNCTION {
+            frequency = args;
+            return {};
+        }
+    };
+
+    attribute<number> frequency { this, "frequency", 220.0,
+        description {"Frequency in Hz. It is used while no signal is connected to the inlet."}
+    };
+
+
+    attribute<int> m_voices {this, "voices", 7,
+        description {"Number of voices, each on an output channel of its own. "
+                     "Up to the number of channels reserved by 'maxvoices' a change takes effect right away and the channels of the missing voices are silent. "
+                     "Beyond it a change takes effect when the audio is turned on again, until then the output is silent."},
+        setter { MIN_FUNCTION {
+            const auto voices { MIN_CLAMP(static_cast<int>(args[0]), 1, 64) };
+
+            enabled_channels().enable_first(voices);
+            m_rebuild.set();
+            return { voices };
+        }}
+    };
+
+
+    attribute<int> m_max_voices {this, "maxvoices", 0,
+        description {"Number of output channels reserved when the audio is turned on, so that voices can be added and removed "
+                     "without turning the audio off and on again. With 0 only the channels of the current voices are reserved."},
+        setter { MIN_FUNCTION {
+            return { MIN_CLAMP(static_cast<int>(args[0]), 0, 64) };
+        }}
+    };
+
+
+    attribute<number> m_detune {this, "detune", 20.0,
+        description {"Distance in cents between the lowest and the highest voice, which are tuned symmetrically around the frequency."},
+        setter { MIN_FUNCTION {
+            return { std::max(static_cast<double>(args[0]), 0.0) };
+        }}
+    };
+
+
+    attribute<symbol> m_shape {this, "shape", "saw",
+        description {"Waveform of the voices."},
+        setter { MIN_FUNCTION {
+            m_rebuild.set();
+            return args;
+        }},
+        range {"sine", "triangle", "square", "saw"}
+    };
+
+
+    message<> reset { this, "reset", "Spread the phases of the voices evenly across one period.",
+        MIN_FUNCTION {
+            lock lock {m_mutex};
+            if (m_bank)
+                spread_phases(*m_bank);
+            return {};
+        }
+    };
+
+
+    message<> multichanneloutputs { this, "multichanneloutputs",
+        MIN_FUNCTION {
+            return { std::max(static_cast<int>(m_voices), static_cast<int>(m_max_voices)) };
+        }
+    };
+
+
+    message<> dspsetup {this, "dspsetup",
+        MIN_FUNCTION {
+            rebuild();
+            return {};
+        }
+    };
+
+
+    /// Process one vector of audio.
+    /// If the bank is being replaced at the same time, this vector is output as silence rather than waiting for the change.
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        const auto frame_count { static_cast<size_t>(output.frame_count()) };
+        const auto channel_count { static_cast<size_t>(output.channel_count()) };
+
+        lock lock {m_mutex, std::try_to_lock};
+        if (!lock.owns_lock() || !m_bank || m_bank->voiceCount() > channel_count) {
+            output.clear();
+            return;
+        }
+
+        const double detune = m_detune;
+        if (detune != m_applied_detune) {
+            apply_detune(*m_bank, detune);
+            m_applied_detune = detune;
+        }
+
+        if (m_inlet.has_signal_connection())
+            m_bank->process(input.samples(0), output.samples(), frame_count);
+        else
+            m_bank->process(static_cast<double>(frequency), output.samples(), frame_count);
+
+        for (auto channel = m_bank->voiceCount(); channel < channel_count; ++channel)
+            std::fill_n(output.samples(channel), frame_count, 0.0);
+    }
+
+private:
+    // The tables and the bank are prepared (which allocates) before taking the lock, so the audio thread is only ever blocked for the swap.
+    // The old bank is then disposed of here rather than in the audio thread.
+
+    void rebuild() {
+        const auto sr { samplerate() };
+
+        std::vector<sample> signal(k_table_size);
+        if (m_shape == "sine")
+            Butterfly::generate_sine(signal.begin(), signal.end());
+        else if (m_shape == "triangle")
+            Butterfly::generate_triangle(signal.begin(), signal.end());
+        else if (m_shape == "square")
+            Butterfly::generate_rectangle(signal.begin(), signal.end());
+        else {
+            for (auto i = 0; i < k_table_size; ++i)
+                signal[i] = 1.0 - 2.0 * i / k_table_size;
+        }
+
+        std::array<sample, k_level_count> frequencies;
+        for (auto i = 0; i < k_level_count; ++i)
+            frequencies[i] = 20.0 * (1 << i);
+
+        static const Butterfly::FFTCalculator<sample, k_table_size> fft;
+        std::vector<std::array<sample, k_table_size>> levels(k_level_count);
+        Butterfly::antialiase(signal.begin(), frequencies.begin(), frequencies.end(), levels.begin(), sr, fft);
+
+        std::vector<Butterfly::Wavetable<sample>> tables(k_level_count);
+        for (auto i = 0; i < k_level_count; ++i)
+            tables[i].setData(levels[i].begin(), levels[i].end(), frequencies[i]);
+
+        auto bank = std::make_unique<bank_type>(static_cast<size_t>(static_cast<int>(m_voices)), sr);
+        bank->setTables(tables);
+        apply_detune(*bank, m_detune);
+        spread_phases(*bank);
+        {
+            lock lock {m_mutex};
+            std::swap(m_bank, bank);
+            m_applied_detune = m_detune;
+        }
+    }
+
+    static void apply_detune(bank_type& bank, const double detune) {
+        const auto voices { bank.voiceCount() };
+        for (auto v = 0u; v < voices; ++v) {
+            const auto position { voices > 1 ? static_cast<double>(v) / (voices - 1) - 0.5 : 0.0 };
+            bank.setRatio(v, std::exp2(detune * position / 1200.0));
+        }
+    }
+
+    static void spread_phases(bank_type& bank) {
+        const auto voices { bank.voiceCount() };
+        for (auto v = 0u; v < voices; ++v)
+            bank.setPhase(v, static_cast<double>(v) / voices);
+    }
+};
+
+MIN_EXTERNAL(unison);
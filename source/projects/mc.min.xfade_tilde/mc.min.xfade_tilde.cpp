@@ -0,0 +1,63 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "../shared/signal_routing_objects.h"
+
+// The mc.min.xfade~ object inherits its attributes and messages from the signal_routing_base class, just as min.xfade~ does.
+// The position moves across all channels of the input rather than between two inputs.
+
+class mc_xfade : public signal_routing_base<mc_xfade>, public mc_operator<> {
+public:
+	MIN_DESCRIPTION {"Crossfade across the channels of a multichannel signal. "
+					 "The position 0 outputs the first channel and the position 1 the last one. "
+					 "In between, the two channels adjacent to the position are mixed using the shape."};
+	MIN_TAGS {"audio, routing"};
+	MIN_AUTHOR {"Cycling '74"};
+	MIN_RELATED {"min.xfade~, mc.min.pan~, mc.mixdown~"};
+
+	inlet<>  m_inlet {this, "(multichannelsignal) Inputs to crossfade across"};
+	outlet<> m_outlet {this, "(signal) Output", "signal"};
+
+
+	/// Process one vector of audio.
+	/// The weights are calculated once for each sample while the position ramps, and once for the rest of the vector.
+	/// Only the two channels with a weight other than zero are read.
+
+	void operator()(audio_bundle input, audio_bundle output) {
+		const auto channel_count = static_cast<size_t>(input.channel_count());
+		const auto n             = static_cast<size_t>(output.frame_count());
+		auto       out           = output.samples(0);
+
+		if (channel_count == 0) {
+			output.clear();
+			return;
+		}
+
+		size_t i = 0;
+		double p = position;
+
+		for (; i < n; ++i) {
+			p = position.smoothed();
+			if (!position.is_ramping())
+				break;
+
+			const auto w = line_weights(p, channel_count);
+			out[i]       = input.samples(w.first)[i] * w.weight1 + input.samples(w.second)[i] * w.weight2;
+		}
+
+		if (i == n)
+			return;
+
+		const auto w   = line_weights(p, channel_count);
+		const auto in1 = input.samples(w.first);
+		const auto in2 = input.samples(w.second);
+
+		for (; i < n; ++i)
+			out[i] = in1[i] * w.weight1 + in2[i] * w.weight2;
+	}
+};
+
+MIN_EXTERNAL(mc_xfade);
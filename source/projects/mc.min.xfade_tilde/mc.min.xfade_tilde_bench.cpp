@@ -0,0 +1,17 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min_benchmark.h"       // required benchmark header
+#include "mc.min.xfade_tilde.cpp"    // need the source of our object so that we can measure it
+
+int main(int argc, char* argv[]) {
+    ext_main(nullptr);    // every benchmark must call ext_main() once to configure the class
+
+    benchmark_settings settings(argc, argv);
+
+    if (argc < 2)
+        settings.channel_counts = { 2, 8, 32 };    // by default measure how the cost grows with the number of channels
+    return benchmark<mc_xfade>("mc.min.xfade~", settings);
+}
@@ -0,0 +1,103 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "../shared/onset_detector.h"
+
+using namespace c74::min;
+
+
+class beat_detect : public object<beat_detect>, public vector_operator<> {
+public:
+    MIN_DESCRIPTION	{ "Detect the onsets of notes and hits in a signal and estimate its tempo. Output at high priority." };
+    MIN_TAGS		{ "audio, analysis" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "min.edge~, min.beat.random, bonk~" };
+
+    inlet<>                                              input			{ this, "(signal) input" };
+    outlet<thread_check::scheduler, thread_action::fifo> output_onset	{ this, "(float) spectral flux of each onset, at the time it was detected" };
+    outlet<thread_check::scheduler, thread_action::fifo> output_tempo	{ this, "(float) estimated tempo in BPM, when it changes" };
+
+
+    attribute<number, threadsafe::snapshot, limit::clamp> threshold { this, "threshold", 1.5,
+        range {1.0, 100.0},
+        description {"How far the spectral flux must rise above its recent mean for an onset, as a multiple of the mean."}
+    };
+
+
+    attribute<number, threadsafe::snapshot> floor { this, "floor", 1.0,
+        description {"The smallest spectral flux of an onset, so that noise in quiet passages is not detected."}
+    };
+
+
+    attribute<number, threadsafe::snapshot> interval { this, "interval", 50.0,
+        description {"The shortest time between onsets in milliseconds."}
+    };
+
+
+    attribute<number> mintempo { this, "mintempo", 60.0,
+        description {"The lowest tempo in BPM that is considered. Takes effect when audio is turned on."}
+    };
+
+
+    attribute<number> maxtempo { this, "maxtempo", 200.0,
+        description {"The highest tempo in BPM that is considered. Takes effect when audio is turned on."}
+    };
+
+
+    message<threadsafe::yes> clear { this, "clear", "Forget the audio analyzed so far, e.g. when the music changes.",
+        MIN_FUNCTION {
+            m_clear_requested = true;
+            return {};
+        }
+    };
+
+
+    message<> dspsetup { this, "dspsetup",
+        MIN_FUNCTION {
+            m_detector.tempo_range(mintempo, maxtempo);
+            m_detector.samplerate(args[0]);
+            m_tempo = 0.0;
+            return {};
+        }
+    };
+
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        // sending with the time of the sample keeps the output sample-accurate rather than quantized to the vector size
+
+        const auto start { sample_time() };
+        const auto ms_per_sample { 1000.0 / samplerate() };
+
+        if (m_clear_requested.exchange(false)) {
+            m_detector.clear();
+            m_tempo = 0.0;
+        }
+
+        m_detector.threshold(*threshold.snapshot());
+        m_detector.floor(*floor.snapshot());
+        m_detector.minimum_interval(*interval.snapshot());
+
+        m_detector(input.samples(0), input.frame_count(), [&](const long offset, const double flux) {
+            output_onset.send_at(start + offset * ms_per_sample, flux);
+        });
+
+        const auto tempo { m_detector.tempo() };
+
+        if (std::abs(tempo - m_tempo) >= k_tempo_resolution) {
+            m_tempo = tempo;
+            output_tempo.send_at(start, tempo);
+        }
+    }
+
+private:
+    static constexpr double k_tempo_resolution { 0.1 };    // the change of tempo in BPM that is output
+
+    onset_detector      m_detector;
+    double              m_tempo {};    // the tempo last output
+    std::atomic<bool>   m_clear_requested { false };
+};
+
+MIN_EXTERNAL(beat_detect);
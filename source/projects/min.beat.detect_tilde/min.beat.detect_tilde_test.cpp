@@ -0,0 +1,69 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min_unittest.h"          // required unit test header
+#include "min.beat.detect_tilde.cpp"    // need the source of our object so that we can access it
+
+// Unit tests are written using the Catch framework as described at
+// https://github.com/philsquared/Catch/blob/master/docs/tutorial.md
+
+SCENARIO("onsets and tempo are detected in a click train") {
+
+    GIVEN("12 seconds of clicks at 120 BPM, over a little noise") {
+        const auto sr     = 44100.0;
+        const auto period = static_cast<long>(sr * 60.0 / 120.0);
+
+        std::vector<double> x(static_cast<size_t>(sr * 12.0), 0.0);
+        lib::noise          noise { 1 };
+
+        for (auto& s : x)
+            s = 0.001 * noise();
+        for (size_t i = 0; i < x.size(); i += period)
+            x[i] += 1.0;
+
+        onset_detector detector { sr };
+        int            onsets {};
+        long           latest {};    // the largest delay between a click and its detection
+
+        for (size_t i = 0; i < x.size(); i += 64) {
+            detector(x.data() + i, 64, [&](const long offset, const double flux) {
+                const auto at = static_cast<long>(i) + offset;
+
+                ++onsets;
+                latest = std::max(latest, at % period);
+            });
+        }
+
+        THEN("each click is an onset, detected within a hop") {
+            REQUIRE(onsets == 24);
+            REQUIRE(latest <= static_cast<long>(onset_detector::k_hop_size + 64));
+        }
+        AND_THEN("the tempo is estimated") {
+            REQUIRE(detector.tempo() == Approx(120.0).epsilon(0.01));
+        }
+
+        WHEN("the detector is cleared") {
+            detector.clear();
+
+            THEN("the tempo is forgotten") {
+                REQUIRE(detector.tempo() == 0.0);
+            }
+        }
+    }
+
+    GIVEN("silence") {
+        onset_detector      detector;
+        std::vector<double> x(44100, 0.0);
+        int                 onsets {};
+
+        for (size_t i = 0; i < x.size(); i += 64)
+            detector(x.data() + i, 64, [&](long, double) { ++onsets; });
+
+        THEN("there are no onsets and no tempo") {
+            REQUIRE(onsets == 0);
+            REQUIRE(detector.tempo() == 0.0);
+        }
+    }
+}
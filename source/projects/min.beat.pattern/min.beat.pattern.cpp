@@ -8,6 +8,52 @@
 using namespace c74::min;
 
 
+// A pattern is compiled when it is loaded, so that the scheduler thread only reads numbers rather than atoms.
+
+struct compiled_pattern {
+    struct step {
+        double interval;       // milliseconds until the next step
+        double probability;    // chance that the step bangs, from 0 to 1
+    };
+
+    vector<step> steps;
+
+
+    // intervals:		the length of each step in milliseconds
+    // subdivisions:	optional, the number of equal parts each step is divided into
+    // probabilities:	optional, the chance of each step to bang, which also applies to its parts
+    // swing:			from 0 to 1, lengthens the first step of every pair by this part of the shorter step and shortens the second
+
+    compiled_pattern(const vector<double>& intervals, const vector<int>& subdivisions = {}, const vector<double>& probabilities = {},
+                     const double swing = 0.0) {
+        steps.reserve(intervals.size());
+        for (auto i = 0u; i < intervals.size(); ++i) {
+            const auto parts { i < subdivisions.size() ? std::max(subdivisions[i], 1) : 1 };
+            const auto probability { i < probabilities.size() ? MIN_CLAMP(probabilities[i], 0.0, 1.0) : 1.0 };
+            const auto interval { std::max(intervals[i], 0.0) / parts };
+
+            for (auto part = 0; part < parts; ++part)
+                steps.push_back({ interval, probability });
+        }
+
+        const auto amount { MIN_CLAMP(swing, 0.0, 1.0) };
+        for (auto i = 0u; i + 1 < steps.size(); i += 2) {
+            const auto shift { amount * std::min(steps[i].interval, steps[i + 1].interval) };
+            steps[i].interval += shift;
+            steps[i + 1].interval -= shift;
+        }
+    }
+};
+
+
+// the keys of the dictionary are looked up in the symbol table once rather than with every dictionary
+
+static const symbol k_sym_pattern		{ "pattern" };
+static const symbol k_sym_subdivide		{ "subdivide" };
+static const symbol k_sym_probability	{ "probability" };
+static const symbol k_sym_swing			{ "swing" };
+
+
 class beat_pattern : public object<beat_pattern> {
 public:
     MIN_DESCRIPTION	{ "Bang at intervals in a repeating pattern." };
@@ -19,19 +65,26 @@ public:
     outlet<> bang_out		{ this, "(bang) triggers at according to specified pattern" };
     outlet<> interval_out	{ this, "(float) the interval for the current bang" };
 
+    // In absolute timing the onset of every step is the onset of the previous step plus its interval,
+    // counted from the time the pattern was turned on, rather than the time the timer happened to fire.
+    // So the delays of the scheduler do not add up, and a long-running pattern stays in time.
+
     timer<> metro { this,
         MIN_FUNCTION {
-            double interval = m_sequence[m_index];
+            if (m_timing == "relative") {
+                metro.delay(step());
+                return {};
+            }
 
-            interval_out.send(interval);
-            bang_out.send("bang");
+            // every step that is due within the lookahead is output now, so fast patterns need fewer clock resets
+            const auto now { scheduler_time() };
+            const double lookahead = m_lookahead;
 
-            metro.delay(interval);
+            do
+                m_next_onset += step();
+            while (m_next_onset <= now + lookahead);
 
-            m_index += 1;
-
-            if (m_index == m_sequence.size())
-              m_index = 0;
+            metro.delay(m_next_onset - now);
             return {};
         }
     };
@@ -39,14 +92,30 @@ public:
     attribute<bool> on {this, "on", false,
         description {"Turn on/off the internal timer."},
         setter { MIN_FUNCTION {
-            if (args[0] == true)
+            if (args[0] == true) {
+                m_next_onset = scheduler_time();
                 metro.delay(0.0);    // fire the first one straight-away
+            }
             else
                 metro.stop();
             return args;
         }}
     };
 
+    attribute<symbol> m_timing {this, "timing", "absolute",
+        description {"How the time of the next bang is found: 'absolute' adds the interval to the time the current bang was due, "
+                     "so that the pattern does not drift; 'relative' waits for the interval from the time the current bang was output."},
+        range {"absolute", "relative"}
+    };
+
+    attribute<number> m_lookahead {this, "lookahead", 0.0,
+        description {"Time in milliseconds to look ahead in absolute timing: all bangs due within it are output together, "
+                     "which trades their timing for fewer wake-ups of the scheduler in very fast patterns."},
+        setter { MIN_FUNCTION {
+            return { std::max(static_cast<double>(args[0]), 0.0) };
+        }}
+    };
+
     message<> toggle { this, "int", "Turn on/off the internal timer.",
         MIN_FUNCTION {
             on = args[0];
@@ -55,18 +124,71 @@ public:
     };
 
 
-    message<> dictionary { this, "dictionary", "Use a dictionary to define the pattern of bangs produced.",
+    message<> dictionary { this, "dictionary", "Use a dictionary to define the pattern of bangs produced: "
+                                               "'pattern' holds the interval of each step in milliseconds, "
+                                               "optional 'subdivide' the number of equal parts of each step, "
+                                               "optional 'probability' the chance of each step to bang (0 to 1), "
+                                               "and optional 'swing' how much the first of every two steps is lengthened (0 to 1).",
         MIN_FUNCTION {
             dict d {args[0]};
 
-            m_sequence = d["pattern"];
+            // the entries are copied straight into the vectors, which keep their memory from one dictionary to the next
+            d.get(k_sym_pattern, m_intervals);
+            d.get(k_sym_subdivide, m_subdivisions);
+            d.get(k_sym_probability, m_probabilities);
+
+            auto pattern = std::make_shared<const compiled_pattern>(
+                m_intervals, m_subdivisions, m_probabilities, d.get(k_sym_swing, 0.0));
+
+            // the scheduler thread keeps using the previous pattern until it next loads the new one
+            std::atomic_store(&m_pattern, pattern);
             return {};
         }
     };
 
 private:
-    int   m_index		{ 0 };
-    atoms m_sequence	{ 250.0, 250.0, 250.0, 250.0, 500.0, 500.0, 500.0, 500.0 };
+    vector<double>	m_intervals;
+    vector<int>		m_subdivisions;
+    vector<double>	m_probabilities;
+
+    size_t m_index		{ 0 };
+    double m_next_onset	{ 0.0 };    // scheduler time at which the next bang is due in absolute timing
+
+    lib::math::random_generator m_random;    // decides whether steps with a probability bang
+
+    std::shared_ptr<const compiled_pattern> m_pattern { std::make_shared<const compiled_pattern>(
+        vector<double> { 250.0, 250.0, 250.0, 250.0, 500.0, 500.0, 500.0, 500.0 }) };
+
+    // output the current step, move on to the next, and return the interval until it
+
+    double step() {
+        const auto pattern { std::atomic_load(&m_pattern) };
+        const auto& steps { pattern->steps };
+
+        if (steps.empty())
+            return 250.0;    // nothing to play, so check again in a while
+        if (m_index >= steps.size())
+            m_index = 0;
+
+        const auto& current { steps[m_index] };
+
+        if (current.probability >= 1.0 || m_random.uniform(0.0, 1.0) < current.probability) {
+            interval_out.send(current.interval);
+            bang_out.send("bang");
+        }
+
+        m_index += 1;
+
+        if (m_index == steps.size())
+          m_index = 0;
+        return std::max(current.interval, 1.0);    // a zero interval would never let time move on
+    }
+
+    static double scheduler_time() {
+        double time;
+        c74::max::clock_getftime(&time);
+        return time;
+    }
 };
 
 MIN_EXTERNAL(beat_pattern);
@@ -31,9 +31,11 @@ public:
         }
     };
 
+    lib::math::random_generator m_random;
+
     timer<> metro { this,
         MIN_FUNCTION {
-            auto interval = lib::math::random(min, max);
+            auto interval = m_random.uniform(min, max);
 
             interval_out.send(interval);
             bang_out.send("bang");
@@ -84,6 +86,14 @@ public:
     };
 
 
+    message<> seed { this, "seed", "Restart the sequence of intervals from a seed, so that it can be reproduced.",
+        MIN_FUNCTION {
+            m_random.seed(static_cast<int>(args[0]));
+            return {};
+        }
+    };
+
+
     message<> toggle { this, "int", "Toggle the state of the timer.",
         MIN_FUNCTION {
             on = args[0];
@@ -8,21 +8,12 @@
 
 // Unit tests are written using the Catch framework as described at
 // https://github.com/philsquared/Catch/blob/master/docs/tutorial.md
+//
+// Time does not pass by itself in the mock kernel: mock_clock_advance() runs the timers that become due without waiting.
 
 SCENARIO("object produces correct output") {
     ext_main(nullptr);    // every unit test must call ext_main() once to configure the class
 
-    using namespace std::chrono_literals;
-    using std::cout;
-    using std::endl;
-
-    //	std::cout << "Hello waiter" << std::endl;
-    //	auto start = std::chrono::high_resolution_clock::now();
-    //	std::this_thread::sleep_for(2s);
-    //	auto end = std::chrono::high_resolution_clock::now();
-    //	std::chrono::duration<double, std::milli> elapsed = end-start;
-    //	std::cout << "Waited " << elapsed.count() << " ms\n";
-
     GIVEN("An instance of our object") {
 
         test_wrapper<beat_random> an_instance;
@@ -35,29 +26,68 @@ SCENARIO("object produces correct output") {
 
         // now proceed to testing various sequences of events
 
-        INFO("When the defaults are used nothing is produced by the object after waiting 5 seconds")
+        auto& output = *c74::max::object_getoutput(my_object, 0);
+        auto& intervals = *c74::max::object_getoutput(my_object, 1);
+
+        WHEN("the defaults are used") {
+            c74::max::mock_clock_advance(5000.0);
+
+            THEN("nothing is produced by the object after 5 seconds") {
+                REQUIRE(output.size() == 0);
+            }
+        }
+
+        AND_WHEN("it is turned on") {
+            my_object.on = true;
+            c74::max::mock_clock_advance(5000.0);
+
+            THEN("a bang is produced at once and then after every interval within the 5 seconds") {
+                REQUIRE(output.size() > 0);
+                REQUIRE(output.size() == intervals.size());
+
+                double elapsed {};
+                for (size_t i = 0; i + 1 < intervals.size(); ++i) {
+                    const double interval = intervals[i][1];
+                    REQUIRE(interval >= 250.0);
+                    REQUIRE(interval <= 1500.0);
+                    elapsed += interval;
+                }
+                REQUIRE(elapsed <= 5000.0);
+                REQUIRE(elapsed + static_cast<double>(intervals.back()[1]) > 5000.0);
+            }
+
+            AND_THEN("turning it off stops the output") {
+                const auto produced { output.size() };
+                my_object.on = false;
+                c74::max::mock_clock_advance(5000.0);
+                REQUIRE(output.size() == produced);
+            }
+        }
+    }
+}
 
-        // 1. Wait for 5 seconds
-        cout << "About to wait for 5 seconds..." << endl;
-        std::this_thread::sleep_for(5s);
-        cout << "done!" << endl;
 
-        // 2. See if there was any output
-        auto& output = *c74::max::object_getoutput(my_object, 0);
-        REQUIRE(output.size() == 0);
+// The events per second that the scheduler path of the object sustains in the mock kernel:
+// the timer, its callback and the outlets, without the latency of a real clock.
+
+SCENARIO("scheduler throughput", "[benchmark]") {
+    ext_main(nullptr);
 
+    GIVEN("An instance of our object with the shortest interval") {
+        test_wrapper<beat_random> an_instance;
+        beat_random&              my_object = an_instance;
 
-        INFO("turning it on does produce output after waiting 5 seconds")
+        my_object.min = 1.0;
+        my_object.max = 1.0;
+        my_object.on  = true;
 
-        my_object.on = true;
+        const auto start { std::chrono::steady_clock::now() };
+        const auto events { c74::max::mock_clock_advance(100000.0) };
+        const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
 
-        // 1. Wait for 5 seconds
-        cout << "About to wait for 5 seconds..." << endl;
-        std::this_thread::sleep_for(5s);
-        cout << "done!" << endl;
+        my_object.on = false;
 
-        // 2. See if there was any output
-        output = *c74::max::object_getoutput(my_object, 0);
-        REQUIRE(output.size() > 0);
+        REQUIRE(events == 100001);    // including the first bang, at once
+        std::cout << "min.beat.random: " << static_cast<long>(events / elapsed.count()) << " timer events per second" << std::endl;
     }
 }
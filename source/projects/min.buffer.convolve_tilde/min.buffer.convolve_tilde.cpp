@@ -0,0 +1,281 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "../shared/convolution_engine.h"
+
+using namespace c74::min;
+
+
+/// Convolves a signal with a long impulse response without latency, using partitions of two sizes.
+///
+/// The head of the impulse response is convolved on the audio thread by a convolution_engine,
+/// with a direct part and small FFT partitions, so the cost per vector is small and bounded.
+/// The tail is convolved with large FFT partitions on a background thread.
+/// The tail starts two of its partitions into the impulse response, so the background thread has the time
+/// of a whole partition to convolve a block of input before its output is needed.
+///
+/// The audio thread and the background thread only share a pair of wait-free ring buffers.
+/// If the background thread does not keep up, the audio thread continues without the missing output of the tail
+/// rather than waiting for it, and the tail stays aligned with the head once the background thread has caught up.
+
+class reverb_convolver {
+public:
+    static constexpr int    k_tail_partition_size { 2048 };
+    static constexpr size_t k_head_size { 2 * k_tail_partition_size };      ///< Length of the part convolved on the audio thread.
+
+    using tail_convolution = uniform_partitioned_convolution<double, k_tail_partition_size>;
+
+
+    /// Prepare the convolution, which allocates memory and starts a thread when the impulse response has a tail.
+    /// @param	impulse_response	The impulse response.
+
+    explicit reverb_convolver(const vector<double>& impulse_response)
+    : m_head { vector<double>(impulse_response.begin(), impulse_response.begin() + std::min(impulse_response.size(), k_head_size)) }
+    {
+        if (impulse_response.size() <= k_head_size)
+            return;
+
+        m_tail.set_kernel(impulse_response.data() + k_head_size, impulse_response.size() - k_head_size);
+
+        // the output of the tail starts with silence for the length of the head
+        std::fill_n(m_chunk.begin(), k_chunk_size, 0.0);
+        for (size_t written = 0; written < k_head_size; written += k_chunk_size)
+            m_tail_output.write(m_chunk.data(), k_chunk_size);
+
+        m_worker = std::thread { &reverb_convolver::convolve_tail, this };
+    }
+
+
+    ~reverb_convolver() {
+        if (m_worker.joinable()) {
+            {
+                lock lock {m_quit_mutex};
+                m_quit = true;
+            }
+            m_quit_condition.notify_one();
+            m_worker.join();
+        }
+    }
+
+
+    reverb_convolver(const reverb_convolver& other) = delete;
+    reverb_convolver& operator=(const reverb_convolver& other) = delete;
+
+
+    /// Audio thread only: convolve a vector of samples.
+    /// @param	input	The input samples.
+    /// @param	output	Storage for the output samples, which may be the same as the input.
+    /// @param	count	The number of samples.
+
+    void operator()(const double* input, double* output, size_t count) {
+        if (!m_worker.joinable()) {
+            m_head(input, output, count);
+            return;
+        }
+
+        while (count > 0) {
+            const auto n { std::min(count, k_chunk_size) };
+
+            // the input is handed to the tail before output is written, as the two may be the same
+            send_to_tail(input, n);
+            m_head(input, output, n);
+            add_from_tail(output, n);
+
+            input += n;
+            output += n;
+            count -= n;
+        }
+    }
+
+private:
+    static constexpr size_t k_chunk_size { 256 };
+    static constexpr size_t k_ring_size { 16 * k_tail_partition_size };
+
+    convolution_engine<double>  m_head;
+    tail_convolution            m_tail;
+
+    ring_buffer<double>         m_tail_input { k_ring_size };     // audio thread to background thread
+    ring_buffer<double>         m_tail_output { k_ring_size };    // background thread to audio thread
+    std::array<double, k_chunk_size>    m_chunk {};               // audio thread only
+    size_t                      m_input_deficit { 0 };            // samples of input the ring buffer had no space for
+    size_t                      m_output_deficit { 0 };           // samples of output of the tail that were missing
+
+    std::mutex                  m_quit_mutex;
+    std::condition_variable     m_quit_condition;
+    bool                        m_quit { false };
+    std::thread                 m_worker;
+
+
+    // Input that does not fit into the ring buffer is replaced by silence once there is space again,
+    // so that the background thread keeps receiving input at the right time.
+
+    void send_to_tail(const double* input, const size_t count) {
+        std::fill_n(m_chunk.begin(), k_chunk_size, 0.0);
+        while (m_input_deficit > 0) {
+            const auto written { m_tail_input.write(m_chunk.data(), std::min(m_input_deficit, k_chunk_size)) };
+            if (written == 0)
+                break;
+            m_input_deficit -= written;
+        }
+
+        if (m_input_deficit > 0)
+            m_input_deficit += count;
+        else
+            m_input_deficit += count - m_tail_input.write(input, count);
+    }
+
+
+    // Output of the tail that was missing when it was needed is discarded once it arrives,
+    // so that the tail stays aligned with the head.
+
+    void add_from_tail(double* output, const size_t count) {
+        while (m_output_deficit > 0) {
+            const auto read { m_tail_output.read(m_chunk.data(), std::min(m_output_deficit, k_chunk_size)) };
+            if (read == 0)
+                break;
+            m_output_deficit -= read;
+        }
+
+        size_t read { 0 };
+        if (m_output_deficit == 0)
+            read = m_tail_output.read(m_chunk.data(), count);
+        m_output_deficit += count - read;
+
+        for (size_t i = 0; i < read; ++i)
+            output[i] += m_chunk[i];
+    }
+
+
+    // The background thread convolves each block of input as soon as it is complete.
+
+    void convolve_tail() {
+        vector<double> block(k_tail_partition_size);
+
+        while (true) {
+            while (m_tail_input.available() >= k_tail_partition_size) {
+                m_tail_input.read(block.data(), k_tail_partition_size);
+                m_tail(block.data(), block.data());
+                m_tail_output.write(block.data(), k_tail_partition_size);
+            }
+
+            // wake often enough to finish a block well within the time of a partition, even at high samplerates
+            lock lock {m_quit_mutex};
+            if (m_quit_condition.wait_for(lock, std::chrono::milliseconds(1), [this] { return m_quit; }))
+                return;
+        }
+    }
+};
+
+
+class buffer_convolve : public object<buffer_convolve>, public vector_operator<> {
+public:
+    MIN_DESCRIPTION	{ "Convolve a signal with an impulse response from a buffer~, without latency. "
+                      "The start of the impulse response is convolved on the audio thread and the rest on a background thread, "
+                      "so impulse responses of several seconds can be used for reverberation. "
+                      "The impulse response is used at the samplerate of Max, without conversion." };
+    MIN_TAGS		{ "audio, filters" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "min.convolve~, buffir~, buffer~" };
+
+    inlet<>  m_inlet	{ this, "(signal) Input to convolve" };
+    outlet<> m_outlet	{ this, "(signal) Result of the convolution", "signal" };
+
+private:
+    // declared before the buffer and the attributes, which load the impulse response into the convolver
+
+    mutex                               m_mutex;
+    std::unique_ptr<reverb_convolver>   m_convolver;
+
+public:
+    buffer_reference m_buffer { this,
+        MIN_FUNCTION {    // will receive a symbol arg indicating 'binding', 'unbinding', or 'modified'
+            m_reload.set();
+            return {};
+        }
+    };
+
+    argument<symbol> m_name_arg {this, "buffer-name", "The buffer~ that holds the impulse response.",
+        MIN_ARGUMENT_FUNCTION {
+            m_buffer.set(arg);
+        }
+    };
+
+
+    attribute<int> m_channel {this, "channel", 1,
+        description {"Channel of the buffer~ that holds the impulse response. The channel number uses 1-based counting."},
+        setter { MIN_FUNCTION {
+            int n = args[0];
+            if (n < 1)
+                n = 1;
+            load(n);
+            return {n};
+        }}
+    };
+
+
+    attribute<number, threadsafe::snapshot> m_gain {this, "gain", 1.0,
+        description {"Gain applied to the result of the convolution."}
+    };
+
+
+    /// Process one vector of audio.
+    /// If the impulse response is being changed at the same time, this vector is silent rather than waiting for the change.
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        auto in   = input.samples(0);
+        auto out  = output.samples(0);
+        auto n    = static_cast<size_t>(output.frame_count());
+        auto gain = *m_gain.snapshot();
+
+        lock lock {m_mutex, std::try_to_lock};
+        if (lock.owns_lock() && m_convolver) {
+            (*m_convolver)(in, out, n);
+            for (size_t i = 0; i < n; ++i)
+                out[i] *= gain;
+        }
+        else
+            std::fill_n(out, n, 0.0);
+    }
+
+private:
+    // buffer~ notifications are not guaranteed to arrive on the main thread, so the impulse response is reloaded from a queue
+
+    queue<> m_reload { this,
+        MIN_FUNCTION {
+            load(m_channel);
+            return {};
+        }
+    };
+
+
+    // The new convolver is prepared (which allocates and starts a thread) before taking the lock,
+    // so the audio thread is only ever blocked for the swap.
+    // The old convolver, and its thread, are then disposed of here rather than in the audio thread.
+
+    void load(const int channel) {
+        vector<double> impulse_response;
+
+        {
+            buffer_lock<false> b {m_buffer};
+
+            if (b.valid() && b.channel_count() > 0) {
+                const auto chan { std::min<size_t>(channel - 1, b.channel_count() - 1) };
+
+                impulse_response.resize(b.frame_count());
+                for (size_t i = 0; i < impulse_response.size(); ++i)
+                    impulse_response[i] = b.lookup(i, chan);
+            }
+        }
+
+        auto convolver = std::make_unique<reverb_convolver>(impulse_response);
+        {
+            lock lock {m_mutex};
+            std::swap(m_convolver, convolver);
+        }
+    }
+};
+
+MIN_EXTERNAL(buffer_convolve);
@@ -0,0 +1,319 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+
+using namespace c74::min;
+
+
+// Every grain is a short read from the buffer~ shaped by a Hann window.
+// The grains are taken from a preallocated pool, and the indices of those that sound are kept in a compact list,
+// so that each vector only visits the grains that sound.
+// All grains share one lock of the buffer~ per vector, and each grain is rendered as a block:
+// its read positions and window are calculated in loops the compiler can vectorize,
+// the samples are read with a single interpolated read, and the result is mixed into the output.
+// The cost is therefore proportional to the number of samples of sounding grains.
+
+class buffer_granulate : public object<buffer_granulate>, public vector_operator<> {
+private:
+    // these types must be complete before the messages below are defined
+
+    struct request {
+        double  position { -1.0 };    // ms, negative for the position attribute
+        double  duration { -1.0 };    // ms, negative for the duration attribute
+        double  speed { 0.0 };        // zero for the pitch attribute
+        double  gain { -1.0 };        // negative for the gain attribute
+    };
+
+    struct grain {
+        long    delay { 0 };          // samples of the current vector before the grain starts
+        long    remaining { 0 };      // samples until the grain ends
+        double  position { 0.0 };     // frames
+        double  step { 0.0 };         // frames per sample
+        double  phase { 0.0 };        // of the window, from 0 to 1
+        double  phase_step { 0.0 };
+        double  gain { 0.0 };
+    };
+
+public:
+    MIN_DESCRIPTION	{ "Granulate a buffer~ with clouds of short windowed grains." };
+    MIN_TAGS		{ "audio, sampling" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "min.buffer.poly~, min.buffer.loop~, buffer~" };
+
+    static constexpr int k_max_grains { 512 };
+
+    inlet<>  m_inlet			{ this, "(list) Play a grain with a position and duration in milliseconds, a speed, and a gain" };
+    outlet<> m_outlet_main		{ this, "(signal) Mix of all grains", "signal" };
+    outlet<> m_outlet_changed	{ this, "(symbol) Notification that the content of the buffer~ changed." };
+
+    buffer_reference m_buffer { this,
+        MIN_FUNCTION {    // will receive a symbol arg indicating 'binding', 'unbinding', or 'modified'
+            m_outlet_changed.send(args);
+            return {};
+        }
+    };
+
+    argument<symbol> m_name_arg {this, "buffer-name", "Initial buffer~ from which to play.",
+        MIN_ARGUMENT_FUNCTION {
+            m_buffer.set(arg);
+        }
+    };
+
+
+    attribute<number, threadsafe::snapshot, limit::clamp> m_density {this, "density", 20.0,
+        range {0.0, 2000.0},
+        description {"Number of grains started per second. With 0 grains are only started by messages."}
+    };
+
+
+    attribute<number, threadsafe::snapshot, limit::clamp> m_duration {this, "duration", 100.0,
+        range {1.0, 2000.0},
+        description {"Duration of each grain in milliseconds."}
+    };
+
+
+    attribute<number, threadsafe::snapshot> m_position {this, "position", 0.0,
+        description {"Position in the buffer~ in milliseconds at which grains start reading. "
+                     "Positions beyond the end of the buffer~ wrap around to its start."}
+    };
+
+
+    attribute<number, threadsafe::snapshot, limit::clamp> m_spray {this, "spray", 0.0,
+        range {0.0, 10000.0},
+        description {"Range in milliseconds around the position across which the start of each grain of the cloud is randomly spread."}
+    };
+
+
+    attribute<number, threadsafe::snapshot> m_pitch {this, "pitch", 1.0,
+        description {"Speed at which grains read the buffer~. Negative speeds read backwards."}
+    };
+
+
+    attribute<number, threadsafe::snapshot> m_gain {this, "gain", 0.5,
+        description {"Gain of each grain."}
+    };
+
+
+    attribute<int, threadsafe::snapshot, limit::clamp> m_grains {this, "grains", 256,
+        range {1, k_max_grains},
+        description {"Maximum number of grains sounding at once. Grains started while all of them sound are dropped."}
+    };
+
+
+    attribute<int, threadsafe::snapshot> m_channel {this, "channel", 1,
+        description {"Channel to play from the buffer~. The channel number uses 1-based counting."},
+        setter { MIN_FUNCTION {
+            int n = args[0];
+            if (n < 1)
+                n = 1;
+            return {n};
+        }}
+    };
+
+
+    // Grains started by messages take effect in the audio thread at the sample that corresponds to the time of the message.
+
+    c74::min::function play = MIN_FUNCTION {
+        request r;
+
+        if (args.size() > 0)
+            r.position = args[0];
+        if (args.size() > 1)
+            r.duration = args[1];
+        if (args.size() > 2)
+            r.speed = args[2];
+        if (args.size() > 3)
+            r.gain = args[3];
+        m_requests.post(r);
+        return {};
+    };
+
+    message<threadsafe::yes> m_grain {this, "grain",
+        "Play a grain. Optional arguments are the position and duration in milliseconds, the speed, and the gain, "
+        "which otherwise are those of the attributes.",
+        play
+    };
+
+    message<threadsafe::yes> m_list {this, "list", "Play a grain with the position, duration, speed, and gain given.", play};
+
+    message<threadsafe::yes> m_bang {this, "bang", "Play a grain with the settings of the attributes.",
+        MIN_FUNCTION {
+            m_requests.post({});
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> m_stop {this, "stop", "Stop all grains.",
+        MIN_FUNCTION {
+            m_stop_requested = true;
+            return {};
+        }
+    };
+
+
+    message<> dspsetup {this, "dspsetup",
+        MIN_FUNCTION {
+            m_positions.resize(static_cast<size_t>(vector_size()));
+            m_samples.resize(static_cast<size_t>(vector_size()));
+            m_window.resize(static_cast<size_t>(vector_size()));
+            m_countdown = 0.0;
+            return {};
+        }
+    };
+
+
+    buffer_granulate(const atoms& args = {}) {
+        for (auto i = 0; i <= k_window_size; ++i)
+            m_window_table[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / k_window_size);
+        m_window_table[k_window_size + 1] = m_window_table[k_window_size];
+
+        for (auto i = 0; i < k_max_grains; ++i)
+            m_free[i] = k_max_grains - 1 - i;
+        m_free_count = k_max_grains;
+    }
+
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        auto          out = output.samples(0);
+        auto          n   = output.frame_count();
+        buffer_lock<> b(m_buffer);    // a single lock and cached buffer~ info is shared by all of the grains
+
+        std::fill_n(out, n, 0.0);
+
+        if (m_stop_requested.exchange(false)) {
+            while (m_active_count > 0)
+                free_grain(0);
+        }
+
+        const auto& requests = m_requests.due(n);
+
+        if (!b.valid())
+            return;
+
+        for (const auto& r : requests)
+            start_grain(b, r.value, r.offset);
+        start_cloud(b, n);
+
+        const auto chan = static_cast<size_t>(*m_channel.snapshot() - 1);
+
+        for (auto i = 0; i < m_active_count;) {
+            if (render_grain(b, m_grain[m_active[i]], out, n, chan))
+                ++i;
+            else
+                free_grain(i);
+        }
+    }
+
+private:
+    static constexpr int k_window_size { 1024 };    // intervals of the window from 0 to 1
+
+    timed_events<request>                       m_requests;
+    std::atomic<bool>                           m_stop_requested { false };
+    std::array<grain, k_max_grains>             m_grain;
+    std::array<int, k_max_grains>               m_active;              // the pool indices of the sounding grains
+    std::array<int, k_max_grains>               m_free;                // the pool indices of the others, taken from the end
+    int                                         m_active_count { 0 };
+    int                                         m_free_count { 0 };
+    double                                      m_countdown { 0.0 };   // samples until the next grain of the cloud
+    std::array<double, k_window_size + 2>       m_window_table;        // the Hann window at k_window_size + 1 points, and the last once more
+    vector<double>                              m_positions;           // read position of each sample of a grain in the vector, in frames
+    vector<double>                              m_samples;             // the samples read for a grain
+    vector<double>                              m_window;              // the window of each sample of a grain
+    lib::interpolator::linear<>                 m_interpolator;
+    lib::noise                                  m_noise;
+
+
+    // start the grains of the cloud that fall within this vector, at their sample
+
+    void start_cloud(buffer_lock<>& b, const long n) {
+        const auto density = *m_density.snapshot();
+
+        if (density <= 0.0) {
+            m_countdown = 0.0;
+            return;
+        }
+
+        const auto interval = samplerate() / density;
+
+        while (m_countdown < n) {
+            start_grain(b, {}, static_cast<long>(m_countdown));
+            m_countdown += interval;
+        }
+        m_countdown -= n;
+    }
+
+
+    void start_grain(buffer_lock<>& b, const request& r, const long offset) {
+        if (m_active_count >= *m_grains.snapshot() || m_free_count == 0)
+            return;
+
+        const auto sr                = samplerate();
+        const auto buffer_samplerate = b.samplerate() > 0.0 ? b.samplerate() : sr;
+        const auto random_position   = r.position < 0.0;
+        auto       position          = random_position ? *m_position.snapshot() : r.position;
+        const auto duration          = r.duration < 0.0 ? *m_duration.snapshot() : std::max(r.duration, 1.0);
+        const auto speed             = r.speed == 0.0 ? *m_pitch.snapshot() : r.speed;
+        const auto length            = std::max(static_cast<long>(duration * 0.001 * sr), 1L);
+
+        if (random_position)
+            position += m_noise() * 0.5 * *m_spray.snapshot();
+
+        const auto index = m_free[--m_free_count];
+        auto&      g     = m_grain[index];
+
+        g.delay      = offset;
+        g.remaining  = length;
+        g.position   = position * 0.001 * buffer_samplerate;
+        g.step       = speed * buffer_samplerate / sr;
+        g.phase      = 0.0;
+        g.phase_step = 1.0 / length;
+        g.gain       = r.gain < 0.0 ? *m_gain.snapshot() : r.gain;
+
+        m_active[m_active_count++] = index;
+    }
+
+
+    void free_grain(const int active_index) {
+        m_free[m_free_count++]       = m_active[active_index];
+        m_active[active_index]       = m_active[--m_active_count];    // the order of the sounding grains does not matter
+    }
+
+
+    // render the part of a grain that falls within this vector and mix it into the output
+    // returns false when the grain has ended
+
+    bool render_grain(buffer_lock<>& b, grain& g, sample* out, const long n, const size_t chan) {
+        const auto start = g.delay;
+        const auto count = static_cast<size_t>(std::min(n - start, g.remaining));
+
+        for (size_t i = 0; i < count; ++i) {
+            m_positions[i] = g.position + g.step * i;
+
+            const auto p     = std::min(g.phase + g.phase_step * i, 1.0) * k_window_size;
+            const auto index = static_cast<int>(p);
+            const auto delta = p - index;
+
+            m_window[i] = m_window_table[index] + delta * (m_window_table[index + 1] - m_window_table[index]);
+        }
+
+        b.read(m_positions.data(), m_samples.data(), count, m_interpolator, chan, buffer_edge::wrap);
+
+        const auto gain = g.gain;
+        auto       mix  = out + start;
+
+        for (size_t i = 0; i < count; ++i)
+            mix[i] += m_samples[i] * m_window[i] * gain;
+
+        g.position += g.step * count;
+        g.phase += g.phase_step * count;
+        g.remaining -= static_cast<long>(count);
+        g.delay = 0;
+        return g.remaining > 0;
+    }
+};
+
+
+MIN_EXTERNAL(buffer_granulate);
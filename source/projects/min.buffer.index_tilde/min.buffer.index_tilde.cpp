@@ -9,6 +9,11 @@ using namespace c74::min;
 
 
 class buffer_index : public object<buffer_index>, public vector_operator<> {
+private:
+    enum class interpolation { none, nearest, linear, cubic, hermite };
+
+    interpolation m_kernel { interpolation::nearest };    // note: must be created prior to the interp attribute, which sets it
+
 public:
     MIN_DESCRIPTION	{ "Read from a buffer~." };
     MIN_TAGS		{ "audio, sampling" };
@@ -17,7 +22,7 @@ public:
 
     inlet<>  m_inlet_index	    { this, "(signal) Sample index" };
     inlet<>  m_inlet_channel	{ this, "(float) Audio channel to use from buffer~" };
-    outlet<> m_outlet_main		{ this, "(signal) Sample value at index", "signal" };
+    outlet<> m_outlet_main		{ this, "(multichannelsignal) Sample value at index, one channel for each channel read", "multichannelsignal" };
     outlet<> m_outlet_changed	{ this, "(symbol) Notification that the content of the buffer~ changed." };
 
     buffer_reference m_buffer { this,
@@ -52,22 +57,82 @@ public:
         range {1, buffer_reference::k_max_channels}
     };
 
+    attribute<int> m_channels {this, "channels", 1,
+        description {"Number of channels to read from the buffer~, starting at the 'channel' attribute, "
+                     "each of which is output as one channel of a multichannel signal. "
+                     "A change of the number of channels takes effect when the audio is turned on again."},
+        setter { MIN_FUNCTION {
+            return { MIN_CLAMP(static_cast<int>(args[0]), 1, buffer_reference::k_max_channels) };
+        }}
+    };
+
+    message<> multichanneloutputs { this, "multichanneloutputs",
+        MIN_FUNCTION {
+            return { static_cast<int>(m_channels) };
+        }
+    };
+
+    attribute<symbol> m_interpolation {this, "interp", "nearest",
+        description {"Interpolation used when the sample index falls between two frames of the buffer~. "
+                     "none truncates the index to the frame before it and nearest rounds it to the closest frame."},
+        range {"none", "nearest", "linear", "cubic", "hermite"},
+        setter { MIN_FUNCTION {
+            // resolved here rather than compared as a symbol for every vector
+            const symbol name = args[0];
+
+            if (name == "none")
+                m_kernel = interpolation::none;
+            else if (name == "linear")
+                m_kernel = interpolation::linear;
+            else if (name == "cubic")
+                m_kernel = interpolation::cubic;
+            else if (name == "hermite")
+                m_kernel = interpolation::hermite;
+            else
+                m_kernel = interpolation::nearest;
+            return args;
+        }}
+    };
+
     void operator()(audio_bundle input, audio_bundle output) {
-        auto          in  = input.samples(0);                                     // get vector for channel 0 (first channel)
-        auto          out = output.samples(0);                                    // get vector for channel 0 (first channel)
-        buffer_lock<> b(m_buffer);                                                  // gain access to the buffer~ content
-        auto          chan = std::min<size_t>(m_channel - 1, b.channel_count());    // convert from 1-based indexing to 0-based
+        auto          in   = input.samples(0);                  // get vector for channel 0 (first channel)
+        auto          out  = output.samples();                  // get vectors for all channels, one for each channel read
+        auto          outs = static_cast<size_t>(output.channel_count());
+        auto          n    = static_cast<size_t>(input.frame_count());
+        buffer_lock<> b(m_buffer);                              // gain access to the buffer~ content
+        auto          chan = static_cast<size_t>(m_channel - 1);   // convert from 1-based indexing to 0-based
 
         if (b.valid()) {
-            for (auto i = 0; i < input.frame_count(); ++i) {
-                auto frame = size_t(in[i] + 0.5);
-                out[i]     = b.lookup(frame, chan);
+            // read the whole vector of all channels at once, choosing the interpolator once rather than for every sample
+            switch (m_kernel) {
+                case interpolation::none:
+                    b.read(in, out, outs, n, m_none, chan);
+                    break;
+                case interpolation::linear:
+                    b.read(in, out, outs, n, m_linear, chan);
+                    break;
+                case interpolation::cubic:
+                    b.read(in, out, outs, n, m_cubic, chan);
+                    break;
+                case interpolation::hermite:
+                    b.read(in, out, outs, n, m_hermite, chan);
+                    break;
+                default:
+                    b.read(in, out, outs, n, m_nearest, chan);
+                    break;
             }
         }
         else {
             output.clear();
         }
     }
+
+private:
+    lib::interpolator::none<>       m_none;
+    lib::interpolator::nearest<>    m_nearest;
+    lib::interpolator::linear<>     m_linear;
+    lib::interpolator::cubic<>      m_cubic;
+    lib::interpolator::hermite<>    m_hermite;
 };
 
 
@@ -16,7 +16,7 @@ public:
 
     inlet<>		index_inlet		{ this, "(signal) Sample index" };
     inlet<>		channel_inlet	{ this, "(float) Audio channel to use from buffer~" };
-    outlet<>	output			{ this, "(signal) Sample value at index", "signal" };
+    outlet<>	output			{ this, "(multichannelsignal) Sample value at index, one channel for each channel read", "multichannelsignal" };
     outlet<>	sync			{ this, "(signal) Sync", "signal" };
 
     buffer_reference buffer { this,
@@ -39,7 +39,7 @@ public:
     };
 
 
-    attribute<int> channel {this, "channel", 1, description {"Channel to read from the buffer~."},
+    attribute<int, threadsafe::snapshot> channel {this, "channel", 1, description {"Channel to read from the buffer~."},
         setter { MIN_FUNCTION {
             int n = args[0];
             if (n < 1)
@@ -49,14 +49,27 @@ public:
     };
 
 
+    attribute<int> channels {this, "channels", 1,
+        description {"Number of channels to read from the buffer~, starting at the 'channel' attribute, "
+                     "each of which is output as one channel of a multichannel signal. "
+                     "A change of the number of channels takes effect when the audio is turned on again."},
+        setter { MIN_FUNCTION {
+            return { MIN_CLAMP(static_cast<int>(args[0]), 1, buffer_reference::k_max_channels) };
+        }}
+    };
+
+
     attribute<number> length {this, "length", 1000.0, title {"Length (ms)"}, description {"Length of the buffer~ in milliseconds."},
         setter { MIN_FUNCTION {
             number new_length = args[0];
             if (new_length <= 0.0)
                 new_length = 1.0;
 
-            buffer_lock<false> b {buffer};
-            b.resize(new_length);
+            if (initialized()) {    // the default value does not resize the buffer~
+                m_requested_length      = new_length;
+                m_requested_in_samples  = false;
+                attributes_changed();
+            }
 
             return {new_length};
         }},
@@ -73,8 +86,11 @@ public:
             if (new_length < 1)
                 new_length = 1;
 
-            buffer_lock<false> b {buffer};
-            b.resize_in_samples(new_length);
+            if (initialized()) {
+                m_requested_length      = new_length;
+                m_requested_in_samples  = true;
+                attributes_changed();
+            }
 
             return {new_length};
         }},
@@ -85,12 +101,48 @@ public:
     };
 
 
-    attribute<number> speed {this, "speed", 1.0, description {"Playback speed of the loop"}};
+    attribute<number, threadsafe::snapshot> speed {this, "speed", 1.0, description {"Playback speed of the loop"}};
+
+
+    attribute<symbol, threadsafe::snapshot> interp {this, "interp", "linear",
+        description {"Interpolation used when playing the loop at speeds other than 1."},
+        range {"nearest", "linear", "cubic", "hermite"}
+    };
+
+
+    attribute<number, threadsafe::snapshot> crossfade {this, "crossfade", 0.0, title {"Crossfade (ms)"},
+        description {"Length of the crossfade at the loop boundary in milliseconds. "
+                     "The end of the loop is faded into its start, which shortens the loop by the length of the crossfade."},
+        setter { MIN_FUNCTION {
+            return { std::max(double(args[0]), 0.0) };
+        }}
+    };
 
 
     attribute<bool> record {this, "record", false, description {"Record into the loop"}};
 
 
+    attribute<number, threadsafe::snapshot, limit::clamp> feedback {this, "feedback", 0.0, range {0.0, 1.0},
+        description {"Gain applied to the existing content of the loop while recording. Use 0 to replace the content or 1 to overdub."}
+    };
+
+
+    message<> attributes_complete {this, "attributes_complete",
+        MIN_FUNCTION {
+            if (m_requested_length > 0.0) {
+                buffer_lock<false> b {buffer};
+
+                if (m_requested_in_samples)
+                    b.resize_in_samples(static_cast<int>(m_requested_length));
+                else
+                    b.resize(m_requested_length);
+                m_requested_length = 0.0;
+            }
+            return {};
+        }
+    };
+
+
     message<> number_message {this, "number", "Toggle the recording attribute.",
         MIN_FUNCTION {
             record = args[0];
@@ -99,9 +151,25 @@ public:
     };
 
 
+    message<> multichanneloutputs {this, "multichanneloutputs",
+        MIN_FUNCTION {
+            const int outlet_index = args[0];
+            return { outlet_index == 0 ? static_cast<int>(channels) : 1 };    // the sync outlet has one channel
+        }
+    };
+
+
     message<> dspsetup {this, "dspsetup",
         MIN_FUNCTION {
+           const auto n             = static_cast<size_t>(vector_size());
+           const auto channel_count = static_cast<size_t>(static_cast<int>(channels));
+
            m_one_over_samplerate = 1.0 / samplerate();
+           m_frames.resize(n);
+           m_tail.resize(n * channel_count);
+           m_tail_channels.resize(channel_count);
+           for (size_t c = 0; c < channel_count; ++c)
+               m_tail_channels[c] = m_tail.data() + c * n;
            return {};
        }
     };
@@ -109,42 +177,67 @@ public:
 
     void operator()(audio_bundle input, audio_bundle output) {
         auto          in   = input.samples(0);
-        auto          out  = output.samples(0);
-        auto          sync = output.samples(1);
+        auto          outs = std::min<size_t>(output.channel_count() - 1, m_tail_channels.size());    // the sync is the last channel
+        auto          out  = output.samples();
+        auto          sync = output.samples(output.channel_count() - 1);
         buffer_lock<> b(buffer);
-        auto          chan = std::min<size_t>(channel - 1, b.channel_count());
+        auto          chan = std::min<size_t>(*channel.snapshot() - 1, b.channel_count());
 
         if (b.valid()) {
-            number speed             = this->speed;
-            auto   position          = m_playback_position;
-            auto   frames            = b.frame_count();
-            auto   length_in_seconds = b.length_in_seconds();
-            auto   frequency         = (1.0 / length_in_seconds) * speed;
-            auto   stepsize          = frequency * m_one_over_samplerate;
-
-            for (auto i = 0; i < input.frame_count(); ++i) {
-                // phasor
-                position += stepsize;
-                position = std::fmod(position, 1.0);
-                sync[i]  = position;
-
-                // buffer playback
-                auto frame = position * frames;
-                out[i]     = b.lookup(static_cast<size_t>(frame), chan);
+            const auto n                    = static_cast<size_t>(input.frame_count());
+            const auto frames               = static_cast<double>(b.frame_count());
+            const auto fade                 = std::floor(std::min(*crossfade.snapshot() * 0.001 * b.samplerate(), frames * 0.5));
+            const auto loop_length          = frames - fade;
+            const auto one_over_loop_length = 1.0 / loop_length;
+            const auto stepsize             = std::fmod(*this->speed.snapshot() * b.samplerate() * m_one_over_samplerate, loop_length);
+            auto       phase                = m_phase;
+
+            // the buffer~ may have been shortened since the last vector
+            if (phase >= loop_length)
+                phase = std::fmod(phase, loop_length);
+
+            // phasor, in frames, wrapping without a division for each sample
+            for (size_t i = 0; i < n; ++i) {
+                phase += stepsize;
+                if (phase >= loop_length)
+                    phase -= loop_length;
+                else if (phase < 0.0)
+                    phase += loop_length;
+                sync[i]     = phase * one_over_loop_length;
+                m_frames[i] = phase;
             }
-            m_playback_position = position;
+            m_phase = phase;
 
-            if (bool(record)) {
-                auto record_position = m_record_position;
+            // buffer playback, interpolating across the loop point
+            symbol interpolation = *interp.snapshot();
+
+            read(b, interpolation, m_frames.data(), out, outs, n, chan);
+
+            // through the start of the loop, fade in from the material that follows the end of the loop,
+            // so that there is no discontinuity when the phasor wraps
+            if (fade > 0.0) {
+                auto tail_positions = m_tail.data();
+
+                for (size_t i = 0; i < n; ++i)
+                    tail_positions[i] = m_frames[i] + loop_length;
+                read(b, interpolation, tail_positions, m_tail_channels.data(), outs, n, chan);
 
-                for (auto i = 0; i < input.frame_count(); ++i) {
-                    if (record_position >= frames)
-                        record_position = 0;
-                    b.lookup(record_position, chan) = static_cast<float>(in[i]);
-                    ++record_position;
+                for (size_t c = 0; c < outs; ++c) {
+                    auto out_c  = out[c];
+                    auto tail_c = m_tail_channels[c];
+
+                    for (size_t i = 0; i < n; ++i) {
+                        if (m_frames[i] < fade) {
+                            const auto gain = m_frames[i] / fade;
+                            out_c[i]        = out_c[i] * gain + tail_c[i] * (1.0 - gain);
+                        }
+                    }
                 }
-                m_record_position = record_position;
-                b.dirty();
+            }
+
+            if (bool(record)) {
+                m_record_position = b.write(m_record_position, in, input.frame_count(), chan, *feedback.snapshot());
+                b.dirty_if_modified();
             }
         }
         else {
@@ -153,9 +246,34 @@ public:
     }
 
 private:
-    double m_playback_position		{ 0.0 };	// normalized range
+    double m_phase					{ 0.0 };	// playback position in frames
     size_t m_record_position		{ 0 };		// native range
     double m_one_over_samplerate	{ 1.0 };
+    vector<double> m_frames;					// playback position of each sample in the vector, in frames
+    vector<double> m_tail;						// the crossfaded material following the end of the loop, for each channel
+    vector<double*> m_tail_channels;			// the start of each channel in m_tail
+    number m_requested_length		{ 0.0 };	// requested by 'length' or 'frames', applied once the attributes are complete
+    bool m_requested_in_samples		{ false };
+
+    lib::interpolator::nearest<>	m_nearest;
+    lib::interpolator::linear<>		m_linear;
+    lib::interpolator::cubic<>		m_cubic;
+    lib::interpolator::hermite<>	m_hermite;
+
+
+    // read all channels from the buffer~ with the interpolator chosen for the whole vector
+
+    void read(buffer_lock<>& b, const symbol interpolation, const double* positions, double* const* outputs, const size_t output_count,
+        const size_t count, const size_t chan) {
+        if (interpolation == "nearest")
+            b.read(positions, outputs, output_count, count, m_nearest, chan, buffer_edge::wrap);
+        else if (interpolation == "cubic")
+            b.read(positions, outputs, output_count, count, m_cubic, chan, buffer_edge::wrap);
+        else if (interpolation == "hermite")
+            b.read(positions, outputs, output_count, count, m_hermite, chan, buffer_edge::wrap);
+        else
+            b.read(positions, outputs, output_count, count, m_linear, chan, buffer_edge::wrap);
+    }
 };
 
 
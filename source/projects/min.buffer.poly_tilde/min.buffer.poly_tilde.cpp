@@ -0,0 +1,234 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+
+using namespace c74::min;
+
+
+class buffer_poly : public object<buffer_poly>, public vector_operator<> {
+private:
+    // these types must be complete before the messages below are defined
+
+    enum class command_type { play, stop };
+
+    struct command {
+        command_type    type;
+        double          speed { 1.0 };
+        double          gain { 1.0 };
+        double          start { 0.0 };    // ms
+    };
+
+    struct voice {
+        bool        active { false };
+        double      position { 0.0 };    // frames
+        double      step { 0.0 };        // frames per sample
+        double      gain { 0.0 };
+        uint64_t    started { 0 };       // for finding the oldest voice to steal
+    };
+
+public:
+    MIN_DESCRIPTION	{ "Play overlapping voices from a buffer~." };
+    MIN_TAGS		{ "audio, sampling" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "min.buffer.loop~, play~, groove~, buffer~" };
+
+    static constexpr int k_max_voices { 64 };
+
+    inlet<>  m_inlet			{ this, "(list) Play a voice with a speed, gain, and start position in milliseconds" };
+    outlet<> m_outlet_main		{ this, "(signal) Mix of all voices", "signal" };
+    outlet<> m_outlet_changed	{ this, "(symbol) Notification that the content of the buffer~ changed." };
+
+    buffer_reference m_buffer { this,
+        MIN_FUNCTION {    // will receive a symbol arg indicating 'binding', 'unbinding', or 'modified'
+            m_outlet_changed.send(args);
+            return {};
+        }
+    };
+
+    argument<symbol> m_name_arg {this, "buffer-name", "Initial buffer~ from which to play.",
+        MIN_ARGUMENT_FUNCTION {
+            m_buffer.set(arg);
+        }
+    };
+
+    argument<int> m_voices_arg {this, "voices", "Initial maximum number of voices.",
+        MIN_ARGUMENT_FUNCTION {
+            m_voices = arg;
+        }
+    };
+
+
+    attribute<int, threadsafe::snapshot, limit::clamp> m_voices {this, "voices", 8,
+        range {1, k_max_voices},
+        description {"Maximum number of voices playing at once. When all of them are playing, the oldest voice is stolen."}
+    };
+
+
+    attribute<int, threadsafe::snapshot> m_channel {this, "channel", 1,
+        description {"Channel to play from the buffer~. The channel number uses 1-based counting."},
+        setter { MIN_FUNCTION {
+            int n = args[0];
+            if (n < 1)
+                n = 1;
+            return {n};
+        }}
+    };
+
+
+    // Voices are started and stopped in the audio thread.
+    // Messages may arrive from both the main thread and the scheduler thread,
+    // so the producers share a mutex while the audio thread consumes without locking.
+
+    c74::min::function play = MIN_FUNCTION {
+        command c { command_type::play };
+
+        if (args.size() > 0)
+            c.speed = args[0];
+        if (args.size() > 1)
+            c.gain = args[1];
+        if (args.size() > 2)
+            c.start = args[2];
+        enqueue(c);
+        return {};
+    };
+
+    message<threadsafe::yes> m_play {this, "play",
+        "Play a voice. Optional arguments are the speed (default 1), the gain (default 1), and the start position in milliseconds. "
+        "Negative speeds play backwards, by default from the end of the buffer~.",
+        play
+    };
+
+    message<threadsafe::yes> m_list {this, "list", "Play a voice with the speed, gain, and start position given.", play};
+
+    message<threadsafe::yes> m_bang {this, "bang", "Play a voice at the original speed from the start of the buffer~.",
+        MIN_FUNCTION {
+            enqueue({ command_type::play });
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> m_stop {this, "stop", "Stop all voices.",
+        MIN_FUNCTION {
+            enqueue({ command_type::stop });
+            return {};
+        }
+    };
+
+
+    message<> dspsetup {this, "dspsetup",
+        MIN_FUNCTION {
+            m_one_over_samplerate = 1.0 / samplerate();
+            m_positions.resize(static_cast<size_t>(vector_size()));
+            m_samples.resize(static_cast<size_t>(vector_size()));
+            return {};
+        }
+    };
+
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        auto          out = output.samples(0);
+        auto          n   = static_cast<size_t>(output.frame_count());
+        buffer_lock<> b(m_buffer);    // a single lock and cached buffer~ info is shared by all of the voices
+
+        start_and_stop_voices(b);
+        std::fill_n(out, n, 0.0);
+
+        if (!b.valid())
+            return;
+
+        const auto frames = static_cast<double>(b.frame_count());
+        const auto chan   = static_cast<size_t>(*m_channel.snapshot() - 1);
+
+        // render one voice at a time so that each reads a run of neighbouring frames
+
+        for (auto& v : m_voice) {
+            if (!v.active)
+                continue;
+
+            auto   position = v.position;
+            size_t count    = 0;
+
+            while (count < n && position >= 0.0 && position < frames) {
+                m_positions[count] = position;
+                position += v.step;
+                ++count;
+            }
+            v.position = position;
+
+            b.read(m_positions.data(), m_samples.data(), count, m_interpolator, chan);
+            for (size_t i = 0; i < count; ++i)
+                out[i] += m_samples[i] * v.gain;
+
+            if (count < n)
+                v.active = false;    // reached the end of the buffer~
+        }
+    }
+
+private:
+    std::mutex                      m_producer_mutex;
+    fifo<command>                   m_commands { k_max_voices * 2 };
+    std::array<voice, k_max_voices> m_voice;
+    uint64_t                        m_voice_counter { 0 };
+    double                          m_one_over_samplerate { 1.0 };
+    vector<double>                  m_positions;    // playback position of each sample of a voice in the vector, in frames
+    vector<double>                  m_samples;      // the samples read for a voice
+    lib::interpolator::linear<>     m_interpolator;
+
+
+    void enqueue(const command& c) {
+        lock lock {m_producer_mutex};
+        m_commands.try_enqueue(c);
+    }
+
+
+    // called in the audio thread before rendering
+
+    void start_and_stop_voices(buffer_lock<>& b) {
+        command c { command_type::stop };
+
+        while (m_commands.try_dequeue(c)) {
+            if (c.type == command_type::stop) {
+                for (auto& v : m_voice)
+                    v.active = false;
+                continue;
+            }
+            if (!b.valid())
+                continue;
+
+            const auto buffer_samplerate = b.samplerate() > 0.0 ? b.samplerate() : samplerate();
+            auto&      v                 = allocate_voice(*m_voices.snapshot());
+
+            v.active   = true;
+            v.step     = c.speed * buffer_samplerate * m_one_over_samplerate;
+            v.gain     = c.gain;
+            v.position = c.start * 0.001 * buffer_samplerate;
+            v.started  = ++m_voice_counter;
+
+            if (v.step < 0.0 && c.start == 0.0)
+                v.position = static_cast<double>(b.frame_count()) - 1.0;
+        }
+    }
+
+
+    // find a free voice, or steal the one that has been playing the longest
+
+    voice& allocate_voice(const int voice_count) {
+        auto oldest = &m_voice[0];
+
+        for (auto i = 0; i < voice_count; ++i) {
+            auto& v = m_voice[i];
+
+            if (!v.active)
+                return v;
+            if (v.started < oldest->started)
+                oldest = &v;
+        }
+        return *oldest;
+    }
+};
+
+
+MIN_EXTERNAL(buffer_poly);
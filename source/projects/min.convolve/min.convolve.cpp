@@ -4,6 +4,7 @@
 ///	@license	Use of this source code is governed by the MIT License found in the License.md file.
 
 #include "c74_min.h"
+#include "../shared/convolution_engine.h"
 
 using namespace c74::min;
 
@@ -16,50 +17,92 @@ public:
     MIN_RELATED		{ "buffir~, jit.convolve" };
 
     inlet<>  input {this, "(list) values to convolve" };
-    outlet<> output {this, "(list) result of convolution" };
+    outlet<> output {this, "(list) result of convolution, as a float_array to objects that receive one" };
 
 
     using fvec = vector<double>;
-    attribute<fvec> kernel { this, "kernel", {1.0, 0.0}, description {"The convolution kernel."} };
-
-
-    message<> list { this, "list", "Input to the convolution function.",
-        MIN_FUNCTION {    // here we make a local *copy* of the kernel
-                                                                                                // for thread-safety
-            // it looks great because we do one operation and then require locks on the shared data
-            // but this is *wrong*
-            // std::vector is not trivially copyable...
-            // this copy assignment involved multiple operation internally, both memory allocation and copying
-            // thus the following is not thread-safe!
-            // as such, we have not marked this message as being thread-safe, and thus it will always execute in the
-            // main thread.
-            //
-            // const vector<double>	kernel = this->kernel;
-
-            const fvec& kernel = this->kernel;
-            atoms       result(args.size());
-
-            for (auto i = 0; i < args.size(); ++i) {
-                double y = 0.0;
-
-                for (auto k = 0; k < kernel.size(); ++k) {
-                    auto   index = i - k;
-                    double x;
-
-                    if (index < 0)
-                        x = 0.0;
-                    else
-                        x = args[index];
-
-                    y += x * kernel[k];    // convolve: multiply and accumulate
-                }
-                result[i] = y;
-            }
-
-            output.send(result);
+    using prepared_kernel = std::shared_ptr<const convolution_kernel<double>>;
+
+    // declared before the kernel attribute, whose setter publishes the prepared kernel to it
+    attribute_snapshot<prepared_kernel> m_prepared_kernel;
+
+    attribute<fvec> kernel { this, "kernel", {1.0, 0.0},
+        description {"The convolution kernel. "
+                     "Kernels longer than 128 values are convolved using the FFT, so long kernels remain efficient."},
+        setter { MIN_FUNCTION {
+            // the kernel is prepared (transformed) once here, on the main thread, and never changes afterwards
+            m_prepared_kernel.write(std::make_shared<const convolution_kernel<double>>(from_atoms<fvec>(args)));
+            return args;
+        }}
+    };
+
+
+    // declared before the stream attribute, whose setter restarts the stream
+    mutex                       m_stream_mutex;
+    convolution_engine<double>  m_stream_engine;
+
+    attribute<bool, threadsafe::snapshot> stream { this, "stream", false,
+        description {"Continue the convolution from the end of the previous list, rather than convolving each list from silence. "
+                     "Long streams can then be sent in chunks of any size. "
+                     "Changing the kernel starts the stream from silence again."},
+        setter { MIN_FUNCTION {
+            guard g {m_stream_mutex};
+            m_stream_engine.reset();
+            return args;
+        }}
+    };
+
+
+    // the input is only read, so it is received as a span of the incoming atoms rather than as a copy of them.
+
+    message<threadsafe::yes> list { this, "list", "Input to the convolution function.",
+        MIN_SPAN_FUNCTION {
+            convolve_values(args);
+            return {};
+        }
+    };
+
+
+    // an array from another Min object is convolved without converting its numbers to or from atoms.
+
+    message<threadsafe::yes> array { this, "float_array", "Input to the convolution function, as an array sent by another Min object.",
+        MIN_FUNCTION {
+            convolve_values(float_array::from(args));
             return {};
         }
     };
+
+private:
+    // the prepared kernel is immutable and shared rather than copied, so a new kernel may be published
+    // from the main thread while this executes, e.g. in the scheduler thread.
+
+    template<class input_type>
+    void convolve_values(const input_type& input) {
+        const prepared_kernel kernel { *m_prepared_kernel.read() };
+        float_array           result(input.size());
+
+        if (*stream.snapshot()) {
+            // the history of the stream is kept by the object's engine, so lists from several threads take turns.
+            guard g {m_stream_mutex};
+
+            if (m_stream_engine.kernel() != kernel)
+                m_stream_engine.set_kernel(kernel);
+            convolve_list(m_stream_engine, input, result);
+        }
+        else {
+            // each list is convolved from silence by an engine of its own, so that earlier lists do not affect the result.
+            convolution_engine<double> engine { kernel };
+            convolve_list(engine, input, result);
+        }
+
+        output.send(result);
+    }
+
+    template<class input_type>
+    static void convolve_list(convolution_engine<double>& engine, const input_type& input, float_array& result) {
+        for (size_t i = 0; i < input.size(); ++i)
+            result[i] = engine(static_cast<double>(input[i]));
+    }
 };
 
 MIN_EXTERNAL(convolve);
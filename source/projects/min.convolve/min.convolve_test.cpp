@@ -39,5 +39,64 @@ SCENARIO("object produces correct output") {
                 }
             }
         }
+
+        WHEN("a kernel longer than one partition is used") {
+            atoms kernel;
+            for (auto k = 0; k < 300; ++k)
+                kernel.push_back(std::sin(k * 0.1) / (k + 1));
+            my_object.kernel.set(kernel);
+
+            atoms input;
+            for (auto i = 0; i < 1000; ++i)
+                input.push_back(std::cos(i * 0.37));
+
+            my_object.list(input);
+            my_object.list(input);    // a second list gives the same result, as each list starts from silence
+
+            THEN("the output matches a direct convolution") {
+                auto& output = *c74::max::object_getoutput(my_object, 0);
+                REQUIRE((output.size() == 2));
+                REQUIRE((output[1].size() == input.size()));
+                for (auto i = 0; i < input.size(); ++i) {
+                    double y = 0.0;
+                    for (auto k = 0; k < kernel.size() && k <= i; ++k)
+                        y += static_cast<double>(kernel[k]) * static_cast<double>(input[i - k]);
+                    REQUIRE((output[1][i] == Approx(y).margin(1e-9)));
+                }
+            }
+        }
+
+        WHEN("an array is received from another Min object") {
+            float_array_publisher publisher;
+            float_array           values { vector<double> {1.0, 2.0, 3.0} };
+
+            my_object.array({ publisher.publish(values) });
+
+            THEN("it is convolved like a list, and the result is sent as a list to an object that does not receive arrays") {
+                auto& output = *c74::max::object_getoutput(my_object, 0);
+                REQUIRE((output.size() == 1));
+                REQUIRE((output[0].size() == values.size()));
+                for (auto i = 0; i < values.size(); ++i) {
+                    REQUIRE((output[0][i] == Approx(values[i])));
+                }
+            }
+        }
+
+        WHEN("streaming is enabled") {
+            my_object.kernel.set({1.0, 0.5});
+            my_object.stream.set({true});
+
+            my_object.list({1.0, 2.0});
+            my_object.list({3.0, 4.0});
+
+            THEN("the end of the previous list carries over into the next one") {
+                auto& output = *c74::max::object_getoutput(my_object, 0);
+                REQUIRE((output.size() == 2));
+                REQUIRE((output[0][0] == Approx(1.0)));
+                REQUIRE((output[0][1] == Approx(2.5)));
+                REQUIRE((output[1][0] == Approx(4.0)));
+                REQUIRE((output[1][1] == Approx(5.5)));
+            }
+        }
     }
 }
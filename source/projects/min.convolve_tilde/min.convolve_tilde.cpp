@@ -0,0 +1,74 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "../shared/convolution_engine.h"
+
+using namespace c74::min;
+
+
+class convolve_tilde : public object<convolve_tilde>, public vector_operator<> {
+public:
+    MIN_DESCRIPTION	{ "Convolve a signal with a kernel of any length, without latency." };
+    MIN_TAGS		{ "audio, filters" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "min.convolve, buffir~" };
+
+    inlet<>  m_inlet  { this, "(signal) Input to convolve" };
+    outlet<> m_outlet { this, "(signal) Result of the convolution", "signal" };
+
+
+    using fvec = vector<double>;
+
+private:
+    // declared before the kernel attribute, whose setter prepares the engine
+
+    mutex                                       m_mutex;
+    std::unique_ptr<convolution_engine<double>> m_engine { std::make_unique<convolution_engine<double>>() };
+
+public:
+    attribute<fvec> kernel { this, "kernel", {1.0},
+        description {"The convolution kernel. "
+                     "Kernels longer than 128 values are convolved using the FFT, so long kernels remain efficient."},
+        setter { MIN_FUNCTION {
+            // the new engine is prepared (which allocates) before taking the lock,
+            // so the audio thread is only ever blocked for the swap.
+            // the old engine is then destroyed here rather than in the audio thread.
+            auto engine = std::make_unique<convolution_engine<double>>(from_atoms<fvec>(args));
+            {
+                lock lock {m_mutex};
+                std::swap(m_engine, engine);
+            }
+            return args;
+        }}
+    };
+
+
+    message<> clear { this, "clear", "Clear the history of the input, as if only silence had been received so far.",
+        MIN_FUNCTION {
+            lock lock {m_mutex};
+            m_engine->reset();
+            return {};
+        }
+    };
+
+
+    /// Process one vector of audio.
+    /// If the kernel is being changed at the same time, this vector is silent rather than waiting for the change.
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        auto in  = input.samples(0);
+        auto out = output.samples(0);
+        auto n   = static_cast<size_t>(output.frame_count());
+
+        lock lock {m_mutex, std::try_to_lock};
+        if (lock.owns_lock())
+            (*m_engine)(in, out, n);
+        else
+            std::fill_n(out, n, 0.0);
+    }
+};
+
+MIN_EXTERNAL(convolve_tilde);
@@ -32,6 +32,21 @@ public:
     }
 
 
+private:
+    bool m_rebuild { true };    // declared before the attribute, whose setter sets it
+
+public:
+    attribute<bool> incremental { this, "incremental", true,
+        description {"Update the combined dictionary with only the entries that changed since the previous dictionary, "
+                     "rather than copying the dictionary at the right inlet and merging the whole dictionary into it every time. "
+                     "The result is the same."},
+        setter { MIN_FUNCTION {
+            m_rebuild = true;
+            return args;
+        }}
+    };
+
+
     message<> bang { this, "bang", "Resend the most recently combined dictionary",
         MIN_FUNCTION {
             output.send("dictionary", dict_merged.name());
@@ -47,13 +62,21 @@ public:
                 dict d = {args[0]};
 
                 if (inlet == 0) {
-                    dict_merged = dict_right;     // start with our stored dict contents
-                    dict_merged.copyunique(d);    // now merge in any keys that are not duplicated in the incoming dict
+                    if (incremental && !m_rebuild)
+                        merge_changes(d);
+                    else {
+                        dict_merged = dict_right;     // start with our stored dict contents
+                        dict_merged.copyunique(d);    // now merge in any keys that are not duplicated in the incoming dict
+                        remember_left_keys(d);
+                        m_rebuild = false;
+                    }
+                    m_left = std::make_unique<dict>(args[0]);
                     bang();                       // send the dictionary name out the outlet
                     dict_merged.touch();          // notify anything listening remotely (e.g. dict.view objects) that we changed
                 }
                 else {
                     dict_right = d;
+                    m_rebuild  = true;            // the entries from the right need to be copied again
                 }
             }
             catch (std::exception& e) {
@@ -63,9 +86,73 @@ public:
         }
     };
 
+    message<> get { this, "get",
+        "Send the value of a key as it would be in the combined dictionary, which is looked up in the dictionary at the right inlet "
+        "and then in the most recent dictionary at the left inlet, without combining them.",
+        MIN_FUNCTION {
+            if (args.empty())
+                return {};
+
+            symbol     key = args[0];
+            dict_overlay view { {&dict_right} };
+            if (m_left)
+                view.push_back(*m_left);
+
+            if (view.contains(key)) {
+                atoms value { key };
+                for (const auto& a : view.at(key))
+                    value.push_back(a);
+                output.send(value);
+            }
+            else
+                cerr << "no entry for " << key << endl;
+            return {};
+        }
+    };
+
 private:
-    dict dict_right		{ symbol(true) };
-    dict dict_merged	{ symbol(true) };
+    // Only the entries of the left dictionary that are not in the right one are merged, so those are all that can change
+    // from one left dictionary to the next: entries whose atoms differ are copied again, and entries that are gone are removed.
+
+    void merge_changes(dict& left) {
+        std::vector<symbol> changed;
+        std::vector<symbol> left_keys;
+
+        for (const auto& key : left.keys()) {
+            if (dict_right.contains(key))
+                continue;
+            left_keys.push_back(key);
+            if (!dict_merged.same_entry(key, left))
+                changed.push_back(key);
+        }
+
+        // symbols are unique, so they are ordered by their address to look up the keys that are gone in logarithmic time
+        const auto by_address = [](const symbol& a, const symbol& b) {
+            return static_cast<c74::max::t_symbol*>(a) < static_cast<c74::max::t_symbol*>(b);
+        };
+        auto sorted_keys { left_keys };
+        std::sort(sorted_keys.begin(), sorted_keys.end(), by_address);
+        for (const auto& key : m_left_keys) {
+            if (!std::binary_search(sorted_keys.begin(), sorted_keys.end(), key, by_address))
+                dict_merged.erase(key);
+        }
+
+        dict_merged.copy_entries(left, changed);
+        m_left_keys = std::move(left_keys);
+    }
+
+    void remember_left_keys(dict& left) {
+        m_left_keys.clear();
+        for (const auto& key : left.keys()) {
+            if (!dict_right.contains(key))
+                m_left_keys.push_back(key);
+        }
+    }
+
+    dict                    dict_right		{ symbol(true) };
+    dict                    dict_merged		{ symbol(true) };
+    std::unique_ptr<dict>   m_left;                     ///< the most recent dictionary at the left inlet, for get
+    std::vector<symbol>     m_left_keys;                ///< the entries of dict_merged that came from the left
 };
 
 MIN_EXTERNAL(dict_join);
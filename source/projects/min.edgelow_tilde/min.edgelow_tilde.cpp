@@ -4,6 +4,7 @@
 ///	@license	Use of this source code is governed by the MIT License found in the License.md file.
 
 #include "c74_min.h"
+#include "../shared/transition_detector.h"
 
 using namespace c74::min;
 
@@ -16,19 +17,51 @@ public:
     MIN_RELATED		{ "min.edge~, min.sift~, edge~" };
 
     inlet<>                                         input			{ this, "(signal) input" };
-    outlet<thread_check::main, thread_action::fifo>	output_true		{ this, "(bang) input is non-zero" };
-    outlet<thread_check::main, thread_action::fifo>	output_false	{ this, "(bang) input is zero" };
-
-    void operator()(sample x) {
-        if (x != 0.0 && prev == 0.0)
-            output_true.send(k_sym_bang);    // change from zero to non-zero
-        else if (x == 0.0 && prev != 0.0)
-            output_false.send(k_sym_bang);    // change from non-zero to zero
-        prev = x;
+    outlet<thread_check::main, thread_action::fifo>	output_true		{ this, "(bang) input is non-zero, or (list) offsets of the changes to non-zero" };
+    outlet<thread_check::main, thread_action::fifo>	output_false	{ this, "(bang) input is zero, or (list) offsets of the changes to zero" };
+
+    attribute<bool> offsets { this, "offsets", false,
+        description {"Output one list per vector with the sample offsets of the transitions within the vector, "
+                     "rather than one bang per transition."}
+    };
+
+
+    message<> dspsetup { this, "dspsetup",
+        MIN_FUNCTION {
+            long vector_size = args[1];
+            m_rising.reserve(vector_size);
+            m_falling.reserve(vector_size);
+            return {};
+        }
+    };
+
+
+    void operator()(const sample_block<1>& input, sample_block<0>&) {
+        if (!offsets) {
+            m_detector(input[0], input.frame_count(), [this](const size_t, const bool rising) {
+                if (rising)
+                    output_true.send(k_sym_bang);    // change from zero to non-zero
+                else
+                    output_false.send(k_sym_bang);    // change from non-zero to zero
+            });
+            return;
+        }
+
+        m_rising.clear();
+        m_falling.clear();
+        m_detector(input[0], input.frame_count(), [this](const size_t offset, const bool rising) {
+            (rising ? m_rising : m_falling).push_back(static_cast<int>(offset));
+        });
+        if (!m_rising.empty())
+            output_true.send(m_rising);
+        if (!m_falling.empty())
+            output_false.send(m_falling);
     }
 
 private:
-    sample prev { 0.0 };
+    transition_detector m_detector;
+    atoms               m_rising;     // offsets of the transitions in the current vector, reserved in dspsetup
+    atoms               m_falling;
 };
 
 MIN_EXTERNAL(edgelow);
@@ -4,6 +4,8 @@
 ///	@license	Use of this source code is governed by the MIT License found in the License.md file.
 
 #include "c74_min.h"
+#include <condition_variable>
+#include <thread>
 
 const char* min_environment_osversionstring();
 const char* min_environment_macaddr();
@@ -12,6 +14,24 @@ std::string min_environment_uniqueid();
 using namespace c74::min;
 
 
+// The platform functions query the operating system, which can take a while,
+// and return static buffers, so only one thread calls them at a time.
+
+struct environment_snapshot {
+    string id;
+    string macaddr;
+    string os;
+};
+
+
+static environment_snapshot probe_environment() {
+    static std::mutex   s_mutex;
+    lock                lock {s_mutex};
+
+    return { min_environment_uniqueid(), min_environment_macaddr(), min_environment_osversionstring() };
+}
+
+
 class environment : public object<environment> {
 public:
     MIN_DESCRIPTION	{ "Get info about the current max environment." };
@@ -26,27 +46,123 @@ public:
     outlet<>	out_macaddr		{ this, "(symbol) primary MAC address" };
     outlet<>	out_id			{ this, "(symbol) unique identifier" };
 
+
+    ~environment() {
+        if (m_worker.joinable()) {
+            {
+                lock lock {m_mutex};
+                m_quit = true;
+            }
+            m_condition.notify_one();
+            m_worker.join();
+        }
+    }
+
+
+    // The environment is probed on a worker thread, so that a slow query of the operating system does not hold up the main thread.
+    // The info is sent out when the probe has finished.
+
     message<> bang {this, "bang", "Get info about the current max environment.",
         MIN_FUNCTION {
-            out_id.send( min_environment_uniqueid() );
-            out_macaddr.send( min_environment_macaddr() );
-            out_os.send( min_environment_osversionstring() );
-
-            #ifdef C74_X64
-                out_arch.send("x86_64");
-            #else    // 32-bit
-                out_arch.send("i386");
-            #endif
-
-            #ifdef MAC_VERSION
-                out_platform.send("mac");
-            #else    // WIN_VERSION
-                out_platform.send("win");
-            #endif
+            {
+                lock lock {m_mutex};
+                m_requested = true;
+                if (!m_worker.joinable())
+                    m_worker = std::thread { &environment::probe, this };
+            }
+            m_condition.notify_one();
+            return {};
+        }
+    };
 
+
+    message<> cached {this, "cached",
+        "Send out the info of the most recent probe of any instance straight away, "
+        "e.g. for patches that poll the environment. Probes the environment first if it has not been probed yet.",
+        MIN_FUNCTION {
+            std::optional<environment_snapshot> snapshot;
+            {
+                lock lock {s_cache_mutex};
+                snapshot = s_cache;
+            }
+
+            if (snapshot)
+                send(*snapshot);
+            else
+                bang();
             return {};
         }
     };
+
+private:
+    // the latest info of all instances, which is the same for all of them
+
+    static inline std::mutex                            s_cache_mutex;
+    static inline std::optional<environment_snapshot>   s_cache;
+
+    std::mutex                  m_mutex;
+    std::condition_variable     m_condition;
+    bool                        m_requested { false };
+    bool                        m_quit { false };
+    std::thread                 m_worker;
+
+
+    // requests that arrive while probing are answered by one more probe
+
+    void probe() {
+        while (true) {
+            {
+                lock lock {m_mutex};
+                m_condition.wait(lock, [this] {
+                    return m_quit || m_requested;
+                });
+                if (m_quit)
+                    return;
+                m_requested = false;
+            }
+
+            auto snapshot { probe_environment() };
+            {
+                lock lock {s_cache_mutex};
+                s_cache = std::move(snapshot);
+            }
+            m_deliver.set();
+        }
+    }
+
+
+    queue<> m_deliver { this,
+        MIN_FUNCTION {
+            std::optional<environment_snapshot> snapshot;
+            {
+                lock lock {s_cache_mutex};
+                snapshot = s_cache;
+            }
+
+            if (snapshot)
+                send(*snapshot);
+            return {};
+        }
+    };
+
+
+    void send(const environment_snapshot& snapshot) {
+        out_id.send(snapshot.id);
+        out_macaddr.send(snapshot.macaddr);
+        out_os.send(snapshot.os);
+
+        #ifdef C74_X64
+            out_arch.send("x86_64");
+        #else    // 32-bit
+            out_arch.send("i386");
+        #endif
+
+        #ifdef MAC_VERSION
+            out_platform.send("mac");
+        #else    // WIN_VERSION
+            out_platform.send("win");
+        #endif
+    }
 };
 
 MIN_EXTERNAL(environment);
@@ -0,0 +1,157 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "../shared/feedback_delay_network.h"
+
+using namespace c74::min;
+
+
+class fdn : public object<fdn>, public vector_operator<> {
+public:
+    MIN_DESCRIPTION	{ "A stereo reverb made of a feedback delay network. "
+                      "Eight delay lines are mixed by a unitary matrix and fed back into each other, "
+                      "which builds up a dense reverb at a fraction of the cost of a chain of allpass filters." };
+    MIN_TAGS		{ "audio, effects" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "min.convolve~, allpass~, comb~" };
+
+    inlet<>  m_inlet		{ this, "(signal) Input to reverberate" };
+    outlet<> m_left_outlet	{ this, "(signal) Left output", "signal" };
+    outlet<> m_right_outlet	{ this, "(signal) Right output", "signal" };
+
+private:
+    // declared before the attributes, whose setters request the new settings to be applied
+
+    using network_type = feedback_delay_network<double>;
+
+    static constexpr double k_max_size { 250.0 };    // milliseconds
+
+    mutex                           m_mutex;
+    std::unique_ptr<network_type>   m_network;
+    std::atomic<bool>               m_changed { true };
+
+public:
+    attribute<number> m_size {this, "size", 80.0,
+        description {"Delay of the longest line in milliseconds. The other lines are spread down to half of it, "
+                     "so a larger size sounds like a larger room."},
+        setter { MIN_FUNCTION {
+            m_changed = true;
+            return { MIN_CLAMP(static_cast<double>(args[0]), 10.0, k_max_size) };
+        }}
+    };
+
+
+    attribute<number> m_decay {this, "decay", 2.0,
+        description {"Time in seconds that the reverb takes to decay by 60 dB."},
+        setter { MIN_FUNCTION {
+            m_changed = true;
+            return { std::max(static_cast<double>(args[0]), 0.01) };
+        }}
+    };
+
+
+    attribute<number> m_damping {this, "damping", 0.3,
+        description {"Damping of high frequencies, which then decay faster than low frequencies, from 0 (none) to 1 (most)."},
+        setter { MIN_FUNCTION {
+            m_changed = true;
+            return { MIN_CLAMP(static_cast<double>(args[0]), 0.0, 0.99) };
+        }}
+    };
+
+
+    attribute<symbol> m_matrix {this, "matrix", "householder",
+        description {"Feedback matrix that mixes the lines: 'householder' feeds every line into all others equally, "
+                     "'hadamard' mixes them with all combinations of signs, which diffuses the echoes a little faster."},
+        setter { MIN_FUNCTION {
+            m_changed = true;
+            return args;
+        }},
+        range {"householder", "hadamard"}
+    };
+
+
+    attribute<number> m_mix {this, "mix", 0.3,
+        description {"Balance between the dry input (0) and the reverb (1)."},
+        setter { MIN_FUNCTION {
+            m_changed = true;
+            return { MIN_CLAMP(static_cast<double>(args[0]), 0.0, 1.0) };
+        }}
+    };
+
+
+    message<> clear { this, "clear", "Clear the reverb, as if only silence had been received so far.",
+        MIN_FUNCTION {
+            lock lock {m_mutex};
+            if (m_network)
+                m_network->reset();
+            return {};
+        }
+    };
+
+
+    // the length of the lines depends on the samplerate, so the network is rebuilt (which allocates) before the audio starts
+
+    message<> dspsetup {this, "dspsetup",
+        MIN_FUNCTION {
+            auto network = std::make_unique<network_type>(static_cast<size_t>(k_max_size * 0.001 * samplerate()) + 1);
+            {
+                lock lock {m_mutex};
+                std::swap(m_network, network);
+                m_changed = true;
+            }
+            return {};
+        }
+    };
+
+
+    /// The reverb falls below -120 dB within two decay times after the input fell silent.
+    /// After that the wrapper skips the processing until the input sounds again.
+
+    size_t silence_tail() {
+        const double size = m_size;
+        const double decay = m_decay;
+
+        return static_cast<size_t>((2.0 * decay + size * 0.001) * samplerate());
+    }
+
+
+    /// Process one vector of audio.
+    /// If the network is being replaced at the same time, this vector is silent rather than waiting for the change.
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        auto in    = input.samples(0);
+        auto left  = output.samples(0);
+        auto right = output.samples(1);
+        auto n     = static_cast<size_t>(output.frame_count());
+
+        lock lock {m_mutex, std::try_to_lock};
+        if (!lock.owns_lock() || !m_network) {
+            output.clear();
+            return;
+        }
+
+        if (m_changed.exchange(false))
+            apply(*m_network);
+
+        (*m_network)(in, left, right, n);
+    }
+
+private:
+    void apply(network_type& network) {
+        const auto   sr { samplerate() };
+        const double size = m_size;
+        const double decay = m_decay;
+        const auto   longest { size * 0.001 * sr };
+
+        network.lengths(longest / 2.0, longest);
+        network.decay(decay * sr);
+        network.damping(m_damping);
+        network.matrix(m_matrix == "hadamard" ? network_type::mixing::hadamard : network_type::mixing::householder);
+        network.mix(m_mix);
+    }
+};
+
+MIN_EXTERNAL(fdn);
@@ -12,7 +12,8 @@ public:
     MIN_DESCRIPTION	{ "Limit matrix values to a range. The range is specified the object's min and max attributes." };
     MIN_TAGS		{ "math" };
     MIN_AUTHOR		{ "Cycling '74" };
-    MIN_RELATED		{ "jit.clip" };
+    MIN_RELATED		{ "jit.clip, jit.gl.slab" };
+    MIN_POINTWISE	{ true };    // each cell is clamped on its own, so the matrix may be calculated in place
 
     inlet<>  input	{ this, "(matrix) Input", "matrix" };
     outlet<> output	{ this, "(matrix) Output", "matrix" };
@@ -42,34 +43,53 @@ public:
     };
 
 
-    // This object process each cell independently
-    // So we define "calc_cell" instead of "calc_matrix"
+    attribute<int> threads { this, "threads", 0,
+        title { "Thread Count" },
+        description { "Number of threads among which the rows of the matrix are divided. "
+                      "0 uses Jitter's parallel processing and 1 processes the matrix serially." },
+        setter { MIN_FUNCTION {
+            int count = args[0];
+            if (count < 0)
+                count = 0;
+            thread_count(count);
+            return { count };
+        }}
+    };
+
+    // This object processes each cell independently
+    // So we define "calc_row", which lets the loop over a row run without a call for each cell
 
-    template<typename matrix_type>
-    matrix_type calc_cell(matrix_type input, const matrix_info& info, matrix_coord& position) {
-        matrix_type output;
-        double      fmin = min;
-        double      fmax = max;
+    template<typename T>
+    void calc_row(matrix_span<const T> input, matrix_span<T> output, const matrix_info& info, long row) {
+        double fmin = min;
+        double fmax = max;
+        const T low  = static_cast<T>(fmin);
+        const T high = static_cast<T>(fmax);
 
-        for (auto plane = 0; plane < info.plane_count(); ++plane) {
-            auto dummy    = input[plane];
-            output[plane] = clamp<decltype(dummy)>(input[plane], static_cast<decltype(dummy)>(fmin), static_cast<decltype(dummy)>(fmax));
+        if (input.contiguous() && output.contiguous() && input.plane_count() == output.plane_count()) {
+            clamp(input.data(), output.data(), output.size() * output.plane_count(), low, high);
         }
-        return output;
-    }
+        else {
+            const auto plane_count = std::min(input.plane_count(), output.plane_count());
 
+            for (auto i = 0; i < output.size(); ++i) {
+                for (auto plane = 0; plane < plane_count; ++plane)
+                    output(i, plane) = clamp(input(i, plane), low, high);
+            }
+        }
+    }
 
-    // We override the case for the char type to use the cached attribute values in the 0-255 range
+    // Clamping a char is the same for every cell and plane, so we also define "calc_char"
+    // This is turned into a lookup table using the cached attribute values in the 0-255 range
 
-    pixel calc_cell(pixel input, const matrix_info& info, matrix_coord& position) {
-        pixel output;
+    uchar calc_char(const uchar value) {
+        return clamp(value, cmin, cmax);
+    }
 
-        output[alpha] = clamp(input[alpha], cmin, cmax);
-        output[red]   = clamp(input[red], cmin, cmax);
-        output[green] = clamp(input[green], cmin, cmax);
-        output[blue]  = clamp(input[blue], cmin, cmax);
+    // With the full range a char matrix is unchanged, so it is not calculated at all
 
-        return output;
+    bool passthrough(const matrix_info& info) const {
+        return info.type() == "char" && cmin == 0 && cmax == 255;
     }
 
 private:
@@ -0,0 +1,49 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+
+using namespace c74::min;
+
+class jit_difference : public object<jit_difference>, public matrix_operator<> {
+public:
+    MIN_DESCRIPTION	{ "Output the absolute difference between each matrix and an earlier one, e.g. to detect motion in video. "
+                      "The earlier matrices are kept by the object, so no jit.matrix is needed to delay them." };
+    MIN_TAGS		{ "video, analysis" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "jit.op, jit.slide, jit.matrix" };
+
+    inlet<>  input	{ this, "(matrix) Input", "matrix" };
+    outlet<> output	{ this, "(matrix) Output", "matrix" };
+
+    attribute<int> delay { this, "delay", 1,
+        description {"The number of matrices between each matrix and the one it is compared with. "
+                     "Until that many matrices have been received the output is zero. A change restarts the comparison."},
+        setter { MIN_FUNCTION {
+            const auto frames { MIN_CLAMP(static_cast<int>(args[0]), 1, 64) };
+            history_size(frames);
+            return { frames };
+        }}
+    };
+
+
+    // The earlier matrix is read from the history kept by the matrix_operator, a row at a time
+
+    template<typename T>
+    void calc_row(matrix_span<const T> input, matrix_span<T> output, const matrix_info& info, long row) {
+        const auto earlier { previous_row(info, input, static_cast<size_t>(static_cast<int>(delay))) };
+        const auto plane_count { std::min(input.plane_count(), output.plane_count()) };
+
+        for (auto i = 0; i < output.size(); ++i) {
+            for (auto plane = 0; plane < plane_count; ++plane) {
+                const auto a { input(i, plane) };
+                const auto b { earlier(i, plane) };
+                output(i, plane) = a > b ? a - b : b - a;
+            }
+        }
+    }
+};
+
+MIN_EXTERNAL(jit_difference);
@@ -12,13 +12,11 @@ public:
     MIN_DESCRIPTION	{ "Apply a 5-point stencil operation to a matrix. See https://en.wikipedia.org/wiki/Five-point_stencil for more information." };
     MIN_TAGS		{ "video, blur/sharpen" };
     MIN_AUTHOR		{ "Cycling '74" };
-    MIN_RELATED		{ "jit.avg4" };
+    MIN_RELATED		{ "jit.avg4, jit.gl.slab" };
 
     inlet<>  input	{ this, "(matrix) Input", "matrix" };
     outlet<> output	{ this, "(matrix) Output", "matrix" };
 
-    // TODO: mode attr for how to handle the edges
-
     attribute<int> x {this, "x", 0,
         description {"The horizontal distance from each incoming cell to the source cells used for averaging."},
         setter { MIN_FUNCTION {
@@ -41,28 +39,61 @@ public:
         }}
     };
 
-    template<class matrix_type, size_t plane_count>
-    cell<matrix_type, plane_count> calc_cell(cell<matrix_type, plane_count> input, const matrix_info& info, matrix_coord& position) {
-        cell<matrix_type, plane_count> output;
+    attribute<int> threads { this, "threads", 0,
+        title { "Thread Count" },
+        description { "Number of threads among which the rows of the matrix are divided. "
+                      "0 and 1 process the matrix serially." },
+        setter { MIN_FUNCTION {
+            int count = args[0];
+            if (count < 0)
+                count = 0;
+            thread_count(count);
+            return { count };
+        }}
+    };
+
+    attribute<symbol> edge { this, "edge", "clamp",
+        description {"How the cells beyond the edges of the matrix are read. "
+                     "clamp repeats the edge, wrap reads from the opposite edge, fold reflects back into the matrix, and zero reads zero."},
+        range {"clamp", "wrap", "fold", "zero"}
+    };
 
-        auto c1 = get_cell<matrix_type, plane_count>(info, position.x() + 0, position.y() - y);
-        auto c2 = get_cell<matrix_type, plane_count>(info, position.x() + x, position.y() + 0);
-        auto c3 = get_cell<matrix_type, plane_count>(info, position.x() + 0, position.y() + y);
-        auto c4 = get_cell<matrix_type, plane_count>(info, position.x() - x, position.y() + 0);
 
-        for (auto plane = 0; plane < info.plane_count(); ++plane)
-            output[plane] = static_cast<matrix_type>((input[plane] + c1[plane] + c2[plane] + c3[plane] + c4[plane]) / 5.0);
+    // Stencils read the neighbouring rows of the whole matrix,
+    // which Jitter's parallel breakup would divide into separate portions
 
-        return output;
+    jit_stencil()
+    : matrix_operator<> { false }
+    {}
+
+
+    template<typename T>
+    void calc_row(matrix_span<const T> input, matrix_span<T> output, const matrix_info& info, long row) {
+        const long dx = x;
+        const long dy = y;
+
+        const std::array<stencil_tap, 5> taps {{
+            { 0, 0, 0.2 },
+            { 0, -dy, 0.2 },
+            { dx, 0, 0.2 },
+            { 0, dy, 0.2 },
+            { -dx, 0, 0.2 }
+        }};
+
+        stencil_row(matrix_view<T> { info }, output, row, taps, edge_mode());
     }
 
 private:
-    template<class matrix_type, size_t plane_count>
-    cell<matrix_type, plane_count> get_cell(const matrix_info& info, int x, int y) {
-        auto x1 = clamp<decltype(x)>(x, 0, info.width() - 1);
-        auto y1 = clamp<decltype(y)>(y, 0, info.height() - 1);
-        auto c  = info.in_cell<matrix_type, plane_count>(x1, y1);
-        return c;
+    matrix_edge edge_mode() {
+        symbol mode = edge;
+
+        if (mode == "wrap")
+            return matrix_edge::wrap;
+        else if (mode == "fold")
+            return matrix_edge::fold;
+        else if (mode == "zero")
+            return matrix_edge::zero;
+        return matrix_edge::clamp;
     }
 };
 
@@ -24,22 +24,51 @@ public:
     outlet<> out2	{ this, "(list) result" };
 
 
+    // the names identify the mutexes in the 'mutexstats' of builds with C74_MIN_MUTEX_STATISTICS
+
+    list_process() {
+        set_mutex_name(m_mutex, "list.process statistics");
+        set_mutex_name(m_take_mutex, "list.process take");
+    }
+
+
     // For enum attributes you first define your enum class.
     // The indices must start at zero and increase sequentially.
 
-    enum class operations : int { collect, average, product, enum_count };
+    enum class operations : int { collect, average, product, moving_average, moving_deviation, minimum, maximum, enum_count };
 
     // You then define the symbols to associate with your enum values.
     // These will be indexed starting at zero.
     // You must have one for each item in the actual enum.
 
-    enum_map operations_range = {"collect", "average", "product"};
+    enum_map operations_range = {"collect", "average", "product", "moving_average", "moving_deviation", "minimum", "maximum"};
 
     // Finally, you create the attribute...
     // specialized with the type of the enum and with the range passed as one of the optional args.
 
     attribute<operations> operation { this, "operation", operations::collect, operations_range,
-        description {"Choose the operation to perform with the input. Collect items into a list or calculate the mean from a list."}
+        description {"Choose the operation to perform with the input. Collect items into a list or calculate the mean from a list. "
+                     "The moving and running operations work across messages: every number received updates them, "
+                     "and the result is sent after each message."}
+    };
+
+private:
+    // declared before the window attribute, whose setter replaces the moving statistics
+
+    mutex                       m_mutex;
+    math::moving_statistics     m_moving;
+    math::running_statistics    m_running;
+
+public:
+    attribute<int> window { this, "window", 16,
+        description {"The number of most recent numbers that the moving average and the moving deviation are calculated from."},
+        setter { MIN_FUNCTION {
+            auto size = std::max(static_cast<int>(args[0]), 1);
+            math::moving_statistics moving { static_cast<size_t>(size) };
+            lock lock {m_mutex};
+            std::swap(m_moving, moving);
+            return { size };
+        }}
     };
 
 
@@ -47,16 +76,12 @@ public:
 
     c74::min::function process = MIN_FUNCTION {
         switch (operation) {
-            case operations::collect: {
-                lock lock {m_mutex};
-                m_data.reserve(m_data.size() + args.size());
-                m_data.insert(m_data.end(), args.begin(), args.end());
+            case operations::collect:
+                m_data.append(args.data(), args.size());
                 break;
-            }
             case operations::average: {
                 lock lock {m_mutex};
-                auto x = from_atoms<std::vector<double>>(args);
-                auto y = math::mean<double>(x);
+                auto y = math::mean(args.begin(), args.end());
                 lock.unlock();
                 out1.send(y.first, y.second);
                 break;
@@ -69,6 +94,26 @@ public:
                 out1.send(y);
                 break;
             }
+            case operations::moving_average:
+            case operations::moving_deviation:
+            case operations::minimum:
+            case operations::maximum: {
+                // each number updates the statistics in constant time, however much history they cover
+                lock lock {m_mutex};
+                for (const auto& a : args) {
+                    if (a.type() == message_type::int_argument || a.type() == message_type::float_argument) {
+                        const auto x = static_cast<double>(a);
+                        m_moving.add(x);
+                        m_running.add(x);
+                    }
+                }
+                if (m_running.count() == 0)
+                    break;
+                auto y = stream_result(operation);
+                lock.unlock();
+                out1.send(y);
+                break;
+            }
             case operations::enum_count:
                 break;
         }
@@ -81,20 +126,46 @@ public:
 
     message<threadsafe::yes> bang { this, "bang", "Send out the collected list. Only applicable if using the 'collect' operation.",
         MIN_FUNCTION {
-            lock  lock {m_mutex};
-            atoms data_copy = m_data;
-
-            m_data.clear();
+            // only one bang at a time takes out the collection, but collecting never waits for a bang.
+            // the collected atoms are moved rather than copied, and sent without the lock in case the output leads back to a bang
+            atoms data;
+            lock  lock {m_take_mutex};
+
+            m_data.take([&data](atoms& collected) {
+                data.swap(collected);
+            });
             lock.unlock();
 
-            out1.send(data_copy);
+            out1.send(data);
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> clear { this, "clear", "Forget the numbers that the moving and running operations were calculated from.",
+        MIN_FUNCTION {
+            lock lock {m_mutex};
+            m_moving.clear();
+            m_running.clear();
             return {};
         }
     };
 
 private:
-    atoms m_data;
-    mutex m_mutex;
+    double stream_result(operations op) const {
+        switch (op) {
+            case operations::moving_average:
+                return m_moving.mean();
+            case operations::moving_deviation:
+                return m_moving.standard_deviation();
+            case operations::minimum:
+                return m_running.minimum();
+            default:
+                return m_running.maximum();
+        }
+    }
+
+    collector<atom> m_data;
+    mutex           m_take_mutex;
 };
 
 MIN_EXTERNAL(list_process);
@@ -6,11 +6,58 @@
 #include "c74_min.h"
 #include "hoedown/src/document.h"
 #include "hoedown/src/html.h"
-#include <regex>
+#include <cctype>
+#include <condition_variable>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 
 using namespace c74::min;
 
 
+// The html is shown in a jweb-like display that wants paragraphs as line breaks and attributes in single quotes.
+// Paragraphs are rendered as line breaks directly, in place of the html renderer's own paragraph callback,
+// and the quotes are replaced while the html is copied out of the buffer, so the html is only passed over once.
+
+static void render_paragraph(hoedown_buffer* ob, const hoedown_buffer* content, const hoedown_renderer_data*) {
+    if (ob->size)
+        hoedown_buffer_putc(ob, '\n');
+    if (!content || !content->size)
+        return;
+
+    size_t i {};
+    while (i < content->size && std::isspace(content->data[i]))
+        ++i;
+    if (i == content->size)
+        return;
+
+    HOEDOWN_BUFPUTSL(ob, "<br/>");
+    hoedown_buffer_put(ob, content->data + i, content->size - i);
+    HOEDOWN_BUFPUTSL(ob, "<br/>\n");
+}
+
+
+static string render_markdown(const string& markdown) {
+    static const std::size_t nesting_depth = 16;
+
+    auto renderer { hoedown_html_renderer_new(static_cast<hoedown_html_flags>(0), nesting_depth) };
+    renderer->paragraph = render_paragraph;
+
+    auto document { hoedown_document_new(renderer, HOEDOWN_EXT_FENCED_CODE, nesting_depth) };
+    auto buffer { hoedown_buffer_new(markdown.size() + markdown.size() / 2 + 64) };
+
+    hoedown_document_render(document, buffer, reinterpret_cast<const uint8_t*>(markdown.data()), markdown.size());
+
+    string html(buffer->size, '\0');
+    std::replace_copy(buffer->data, buffer->data + buffer->size, html.begin(), '"', '\'');
+
+    hoedown_buffer_free(buffer);
+    hoedown_document_free(document);
+    hoedown_html_renderer_free(renderer);
+    return html;
+}
+
+
 class markdown : public object<markdown> {
 public:
     MIN_DESCRIPTION	{ "Get the approximate value of pi." };
@@ -21,49 +68,143 @@ public:
     inlet<>  input	{ this, "(bang) get the approximate value of pi" };
     outlet<> output	{ this, "(number) approximate value of pi" };
 
+
+    ~markdown() {
+        if (m_worker.joinable()) {
+            {
+                lock lock {m_mutex};
+                m_quit = true;
+            }
+            m_condition.notify_one();
+            m_worker.join();
+        }
+    }
+
+
+    // The file is found on the main thread, where the search path may be used,
+    // but reading and rendering happens on a worker thread, so that a large document does not hold up the user interface.
+    // A file that has not been modified since it was last rendered is not rendered again.
+
     message<> read { this, "read", "Markdown file to read",
         MIN_FUNCTION {
             try {
-                path              p {args};
-                std::ifstream     in {p};
-                std::string       s {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
-                hoedown_renderer* renderer {hoedown_html_renderer_new(static_cast<hoedown_html_flags>(0), 16)};
-                hoedown_buffer*   buffer {hoedown_buffer_new(100)};
-
-                static const std::size_t nesting_depth = 16;
-                int                      extensions    = HOEDOWN_EXT_FENCED_CODE;
-                auto document = hoedown_document_new(renderer, static_cast<hoedown_extensions>(extensions), nesting_depth);
+                path p {args};
+                const string            filename = p;
+                const path::filedate    modified { p.date_modified() };
+
+                const auto cached { m_cache.find(filename) };
+                if (cached != m_cache.end() && cached->second.modified == modified) {
+                    ++m_latest_request;    // a rendering that is still pending is outdated now
+                    send(cached->second.html);
+                    return {};
+                }
+
+                {
+                    lock lock {m_mutex};
+                    m_request = { filename, modified, ++m_latest_request };
+                    m_requested = true;
+
+                    if (!m_worker.joinable())
+                        m_worker = std::thread { &markdown::render, this };
+                }
+                m_condition.notify_one();
+            }
+            catch (...) {
+                cerr << "Could not read file" << endl;
+            }
 
-                hoedown_document_render(document, buffer, reinterpret_cast<const uint8_t*>(&s[0]), s.size());
+            return {};
+        }
+    };
 
-                string     out {hoedown_buffer_cstr(buffer)};
-                std::regex rex {"\\\""};
-                string     out2 {std::regex_replace(out, rex, "'")};
-                std::regex rex2 {"src=\""};
-                string     out3 {std::regex_replace(out2, rex2, "src='")};
+private:
+    struct request {
+        string              filename;
+        path::filedate      modified {};
+        uint64_t            number {};
+    };
 
-                std::regex rexp {"<p>"};
-                string     out4 {std::regex_replace(out3, rexp, "<br/>")};
-                std::regex rexp2 {"</p>"};
-                string     out5 {std::regex_replace(out4, rexp2, "<br/>")};
+    struct rendering {
+        string              html;
+        path::filedate      modified {};
+    };
 
-                auto maxstring {c74::max::string_new(out5.c_str())};
-                atom a {maxstring};
+    // requests from the main thread to the worker thread, and results back
+
+    std::mutex                  m_mutex;
+    std::condition_variable     m_condition;
+    request                     m_request;
+    bool                        m_requested { false };
+    bool                        m_quit { false };
+    vector<std::pair<request, std::optional<string>>>    m_results;    // no html if the file could not be read
+    std::thread                 m_worker;
+
+    uint64_t                                m_latest_request {};
+    std::unordered_map<string, rendering>   m_cache;    // main thread only
+
+
+    // only the most recent request is rendered, as any before it would be replaced by it straight away
+
+    void render() {
+        while (true) {
+            request r;
+            {
+                lock lock {m_mutex};
+                m_condition.wait(lock, [this] {
+                    return m_quit || m_requested;
+                });
+                if (m_quit)
+                    return;
+                r           = m_request;
+                m_requested = false;
+            }
 
-                output.send("set", a);
+            std::ifstream         in {r.filename, std::ios::binary};
+            std::optional<string> html;
+            if (in) {
+                string s {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+                html = render_markdown(s);
+            }
 
-                object_free(maxstring);
-                hoedown_buffer_free(buffer);
-                hoedown_html_renderer_free(renderer);
+            {
+                lock lock {m_mutex};
+                m_results.emplace_back(std::move(r), std::move(html));
             }
-            catch (...) {
-                cerr << "Could not read file" << endl;
+            m_deliver.set();
+        }
+    }
+
+
+    queue<> m_deliver { this,
+        MIN_FUNCTION {
+            vector<std::pair<request, std::optional<string>>> results;
+            {
+                lock lock {m_mutex};
+                std::swap(results, m_results);
             }
 
+            for (auto& [r, html] : results) {
+                if (!html) {
+                    if (r.number == m_latest_request)
+                        cerr << "Could not read file" << endl;
+                    continue;
+                }
+                if (r.number == m_latest_request)
+                    send(*html);
+                m_cache[r.filename] = { std::move(*html), r.modified };
+            }
             return {};
         }
     };
 
+
+    void send(const string& html) {
+        auto maxstring {c74::max::string_new(html.c_str())};
+        atom a {maxstring};
+
+        output.send("set", a);
+        object_free(maxstring);
+    }
 };
 
 MIN_EXTERNAL(markdown);
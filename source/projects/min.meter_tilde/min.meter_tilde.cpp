@@ -8,7 +8,7 @@
 using namespace c74::min;
 using namespace c74::min::ui;
 
-class min_meter : public object<min_meter>, public ui_operator<140, 24>, public sample_operator<1, 0> {
+class min_meter : public object<min_meter>, public ui_operator<140, 24>, public vector_operator<float> {
 public:
     MIN_DESCRIPTION	{ "Show audio gain levels" };
     MIN_TAGS		{ "ui" };
@@ -20,7 +20,7 @@ public:
 
     min_meter(const atoms& args = {})
     : ui_operator::ui_operator {this, args} {
-        m_timer.delay(40);
+        m_refresher.start();
     }
 
     attribute<numbers> m_range			{ this, "range", { {0.0, 1.0}} };
@@ -32,11 +32,36 @@ public:
 	attribute<color>   m_elementcolor {this, "elementcolor", color::predefined::white};
 	attribute<color>   m_knobcolor {this, "knobcolor", color::predefined::gray, title {"Knob Color"}};
 
-    message<> paint { this, "paint",
+    attribute<symbol>  m_measure {this, "measure", "peak",
+        description {"What is shown and sent out. Of the samples since the previous refresh: "
+                     "'peak' is the largest absolute sample, 'rms' the root mean square. "
+                     "After EBU R128, in LUFS: 'momentary' is the loudness of the last 400 ms, 'shortterm' of the last 3 s "
+                     "and 'integrated' the gated loudness since the last reset. "
+                     "'truepeak' is the largest absolute sample after 4x oversampling since the last reset."},
+        range {"peak", "rms", "momentary", "shortterm", "integrated", "truepeak"}
+    };
+
+
+    message<> reset { this, "reset", "Start a new loudness and true-peak measurement.",
+        MIN_FUNCTION {
+            m_reset.store(true, std::memory_order_release);
+            return {};
+        }
+    };
+
+
+    message<> dspsetup { this, "dspsetup",
+        MIN_FUNCTION {
+            m_loudness.reset(1, samplerate(), static_cast<int>(vector_size()));
+            return {};
+        }
+    };
+
+    // the background, the frame and the label only change with the attributes, so they are cached in layers
+
+    layer m_background { this, "background",
         MIN_FUNCTION {
             target t {args};
-            auto   value = (m_value - m_range[0]) / (m_range[1] - m_range[0]);
-            auto   pos   = ((t.width() - 3) * value) + 1;    // one pixel for each border and -1 for counting to N-1
 
             rect<fill> {// background
                 t,
@@ -47,6 +72,33 @@ public:
                 color {{0.3, 0.3, 0.3, 1.0}},
                 line_width {3.0}
             };
+            return {};
+        }
+    };
+
+    layer m_text { this, "text",
+        MIN_FUNCTION {
+            target t {args};
+
+            text {// text display
+                t, color {color::predefined::white},
+                position {m_offset[0], m_offset[1] + m_fontsize * 0.5},
+                fontface {m_fontname},
+                fontsize {m_fontsize},
+                content {static_cast<symbol&>(m_label)}
+            };
+            return {};
+        }
+    };
+
+    message<> paint { this, "paint",
+        MIN_FUNCTION {
+            target t {args};
+            m_width = t.width();
+            m_drawn_position = pixel_position();
+            auto pos = static_cast<double>(m_drawn_position);
+
+            m_background.paint(t);
             rect<fill> {// active part of the slider
                 t,
                 color {m_elementcolor},
@@ -59,34 +111,133 @@ public:
                 position {pos, 1.0},
                 size {4.0, -2.0}
             };
-            text {// text display
-                t, color {color::predefined::white},
-                position {m_offset[0], m_offset[1] + m_fontsize * 0.5},
-                fontface {m_fontname},
-                fontsize {m_fontsize},
-                content {static_cast<symbol&>(m_label)}
-            };
+            m_text.paint(t);
             return {};
         }
     };
 
-    timer<timer_options::defer_delivery> m_timer { this,
+    // With many meters on screen the cost is in waking the main thread and redrawing,
+    // so the meters are refreshed together once per frame, and a meter is only sent out and redrawn if its value or its position changed.
+
+    refresher m_refresher { this,
         MIN_FUNCTION {
-            m_value = MIN_CLAMP(m_unclipped_value, m_range[0], m_range[1]);
-            redraw();
-            output.send(m_unclipped_value);
-            m_timer.delay(40);
+            refresh();
             return {};
         }
     };
 
-    void operator()(sample input) {
-        m_unclipped_value = input;
+
+    // the levels of each vector are accumulated until the refresh takes them, and published together with one atomic store
+
+    void operator()(basic_audio_bundle<float> input, basic_audio_bundle<float>) {
+        const auto frames { static_cast<size_t>(input.frame_count()) };
+        if (frames == 0)
+            return;
+
+        if (m_taken.exchange(false, std::memory_order_acquire)) {
+            m_peak           = 0.0f;
+            m_sum_of_squares = 0.0;
+            m_frame_count    = 0;
+        }
+
+        const auto samples { input.samples(0) };
+        auto       peak { m_peak };
+        double     sum {};
+
+        for (size_t i = 0; i < frames; ++i) {
+            peak = std::max(peak, std::abs(samples[i]));
+            sum += samples[i] * samples[i];
+        }
+
+        m_peak = peak;
+        m_sum_of_squares += sum;
+        m_frame_count += frames;
+        m_levels.store({ peak, static_cast<float>(std::sqrt(m_sum_of_squares / m_frame_count)) }, std::memory_order_release);
+
+        if (m_reset.exchange(false, std::memory_order_acquire))
+            m_loudness.clear();
+
+        const float* channels[] { samples };
+        m_loudness.process(channels, static_cast<int>(frames));
+        m_momentary.store(static_cast<float>(m_loudness.momentary()), std::memory_order_relaxed);
+        m_short_term.store(static_cast<float>(m_loudness.short_term()), std::memory_order_relaxed);
+        m_integrated.store(static_cast<float>(m_loudness.integrated()), std::memory_order_relaxed);
+        m_true_peak.store(static_cast<float>(m_loudness.true_peak()), std::memory_order_relaxed);
     }
 
 private:
-    number m_unclipped_value {0.0};
-    number m_value;
+    struct levels {
+        float peak;
+        float rms;
+    };
+
+    // written by the audio thread and read by the refresh
+
+    std::atomic<levels> m_levels { levels {} };
+    std::atomic<bool>   m_taken { false };
+    std::atomic<bool>   m_reset { false };
+
+    // the loudness is updated every 100 ms, so each value is published on its own
+
+    std::atomic<float>  m_momentary { -std::numeric_limits<float>::infinity() };
+    std::atomic<float>  m_short_term { -std::numeric_limits<float>::infinity() };
+    std::atomic<float>  m_integrated { -std::numeric_limits<float>::infinity() };
+    std::atomic<float>  m_true_peak {};
+
+    // audio thread only, apart from the allocation in dspsetup
+
+    float               m_peak {};
+    double              m_sum_of_squares {};
+    size_t              m_frame_count {};
+    lib::loudness_meter m_loudness { 1 };
+
+    // main thread only
+
+    number  m_sent_value { std::numeric_limits<number>::quiet_NaN() };    // compares unequal to any level, so the first refresh always sends
+    number  m_value {};
+    number  m_width {};
+    int     m_drawn_position { -1 };
+
+
+    int pixel_position() {
+        const auto& range { m_range.value() };
+        auto        value = (m_value - range[0]) / (range[1] - range[0]);
+        return static_cast<int>(std::lround(((m_width - 3) * value) + 1));    // one pixel for each border and -1 for counting to N-1
+    }
+
+
+    number measure(const levels& current) const {
+        if (m_measure == "rms")
+            return current.rms;
+        else if (m_measure == "momentary")
+            return m_momentary.load(std::memory_order_relaxed);
+        else if (m_measure == "shortterm")
+            return m_short_term.load(std::memory_order_relaxed);
+        else if (m_measure == "integrated")
+            return m_integrated.load(std::memory_order_relaxed);
+        else if (m_measure == "truepeak")
+            return m_true_peak.load(std::memory_order_relaxed);
+        else
+            return current.peak;
+    }
+
+
+    void refresh() {
+        const auto current { m_levels.load(std::memory_order_acquire) };
+        m_taken.store(true, std::memory_order_release);
+
+        const number measured { measure(current) };
+        if (measured == m_sent_value)
+            return;
+
+        m_sent_value = measured;
+        output.send(measured);
+
+        const auto& range { m_range.value() };
+        m_value = MIN_CLAMP(measured, range[0], range[1]);
+        if (pixel_position() != m_drawn_position)
+            redraw();
+    }
 };
 
 MIN_EXTERNAL(min_meter);
@@ -8,6 +8,8 @@
 
 // Unit tests are written using the Catch framework as described at
 // https://github.com/philsquared/Catch/blob/master/docs/tutorial.md
+//
+// Time does not pass by itself in the mock kernel: mock_clock_advance() runs the timers that become due without waiting.
 
 SCENARIO("object produces correct output") {
     ext_main(nullptr);    // every unit test must call ext_main() once to configure the class
@@ -16,7 +18,61 @@ SCENARIO("object produces correct output") {
 
         test_wrapper<note_make> an_instance;
         note_make&              my_object = an_instance;
-        
-        UNUSED(my_object);
+
+        auto& pitches    = *c74::max::object_getoutput(my_object, 0);
+        auto& velocities = *c74::max::object_getoutput(my_object, 1);
+
+        WHEN("notes with different durations are played") {
+            my_object.m_ints(100, 1);
+            my_object.m_ints(300, 2);
+            my_object.m_ints(60, 0);
+            my_object.m_ints(100, 2);
+            my_object.m_ints(62, 0);
+
+            THEN("the note-ons are sent at once") {
+                REQUIRE(pitches.size() == 2);
+                REQUIRE((velocities[0][1] == 100));
+            }
+
+            AND_THEN("each note-off is sent when its note is due, in the order they are due") {
+                c74::max::mock_clock_advance(99.0);
+                REQUIRE(pitches.size() == 2);
+
+                c74::max::mock_clock_advance(1.0);
+                REQUIRE(pitches.size() == 3);
+                REQUIRE((pitches[2][1] == 62));
+                REQUIRE((velocities[2][1] == 0));
+
+                c74::max::mock_clock_advance(200.0);
+                REQUIRE(pitches.size() == 4);
+                REQUIRE((pitches[3][1] == 60));
+            }
+        }
+    }
+}
+
+
+// The note-offs per second that the scheduler path of the object sustains in the mock kernel:
+// the multi_timer, its timer and the outlets, without the latency of a real clock.
+
+SCENARIO("scheduler throughput", "[benchmark]") {
+    ext_main(nullptr);
+
+    GIVEN("An instance of our object with many pending notes") {
+        test_wrapper<note_make> an_instance;
+        note_make&              my_object = an_instance;
+
+        constexpr auto k_note_count { 100000 };
+        for (auto i = 0; i < k_note_count; ++i) {
+            my_object.m_ints((i * 37) % 1000 + 1, 2);
+            my_object.m_ints(i % 128, 0);
+        }
+
+        const auto start { std::chrono::steady_clock::now() };
+        c74::max::mock_clock_advance(1000.0);
+        const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+
+        REQUIRE(c74::max::object_getoutput(my_object, 0)->size() == 2 * k_note_count);
+        std::cout << "min.note.make: " << static_cast<long>(k_note_count / elapsed.count()) << " note-offs per second" << std::endl;
     }
 }
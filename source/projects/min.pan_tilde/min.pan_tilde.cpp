@@ -9,12 +9,13 @@
 // The xfade~ object inherits all of it's attributes and messages from the signal_routing_base class.
 // The panner~ object does exactly the same, allowing us to share the code between the two similar but opposite classes.
 
-class panner : public signal_routing_base<panner>, public sample_operator<2, 2> {
+class panner : public signal_routing_base<panner>, public vector_operator<> {
 public:
 	MIN_DESCRIPTION {"Pan an input to two outputs."};
 	MIN_TAGS {"audio, routing"};
 	MIN_AUTHOR {"Cycling '74"};
 	MIN_RELATED {"xfade~, matrix~"};
+	MIN_INPLACE {true};
 
 	inlet<>  in1 {this, "(signal) Input 1"};
 	inlet<>  in_pos {this, "(signal) Position between them (0..1)"};
@@ -22,14 +23,91 @@ public:
 	outlet<> out2 {this, "(signal) Right Output", "signal"};
 
 
+	/// Process one vector of audio.
+	/// The wrapper calls the kernel chosen by select_kernel() directly, this is for calls from elsewhere (e.g. the unit test).
+
+	void operator()(audio_bundle input, audio_bundle output) {
+		(this->*select_kernel())(input, output);
+	}
+
+
+	/// Choose the kernel for the signal connections when the dsp chain is compiled,
+	/// so that the connection of the position is not tested in every vector.
+
+	auto select_kernel() {
+		return in_pos.has_signal_connection() ? &panner::modulated : &panner::constant;
+	}
+
+
+	/// Kernel for a position connected to a signal: the weights are calculated for a block of positions at a time.
+
+	void modulated(audio_bundle input, audio_bundle output) {
+		auto in       = input.samples(0);
+		auto position = input.samples(1);
+		auto left     = output.samples(0);
+		auto right    = output.samples(1);
+		auto n        = static_cast<size_t>(output.frame_count());
+
+		double weights1[block_size];
+		double weights2[block_size];
+
+		for (size_t start = 0; start < n; start += block_size) {
+			const auto count = std::min(block_size, n - start);
+
+			calculate_weights(position + start, weights1, weights2, count);
+			for (size_t i = 0; i < count; ++i) {
+				const auto x     = in[start + i];
+				left[start + i]  = x * weights1[i];
+				right[start + i] = x * weights2[i];
+			}
+		}
+	}
+
+
+	/// Kernel for a position set by the attribute: the weights are calculated for each sample only while the position ramps,
+	/// and the rest of the vector is scaled by constant weights.
+	/// A new position takes effect at the start of the next vector.
+
+	void constant(audio_bundle input, audio_bundle output) {
+		auto   in    = input.samples(0);
+		auto   left  = output.samples(0);
+		auto   right = output.samples(1);
+		auto   n     = static_cast<size_t>(output.frame_count());
+		size_t i     = 0;
+
+		while (i < n) {
+			const auto [weight1, weight2] = smoothed_weights();
+			const auto x                  = in[i];
+
+			left[i]  = x * weight1;
+			right[i] = x * weight2;
+			++i;
+			if (!position.is_ramping())
+				break;
+		}
+
+		const auto w1 = weight1;
+		const auto w2 = weight2;
+
+		for (; i < n; ++i) {
+			const auto x = in[i];
+
+			left[i]  = x * w1;
+			right[i] = x * w2;
+		}
+	}
+
+
 	/// Process one sample
 
 	samples<2> operator()(sample input, sample position = 0.5) {
-		auto weight1 = this->weight1;
-		auto weight2 = this->weight2;
+		double weight1;
+		double weight2;
 
 		if (in_pos.has_signal_connection())
-			std::tie(weight1, weight2) = calculate_weights(mode, position);
+			std::tie(weight1, weight2) = calculate_weights(position);
+		else
+			std::tie(weight1, weight2) = smoothed_weights();
 
 		return { {input * weight1, input * weight2}};
 	}
@@ -32,13 +32,12 @@ SCENARIO("object produces correct output") {
 
 				auto result = my_object(1.0);
 
-				// the default mode is 'fast', which means a 512-point lookup table is used
-				// thus we have 9-bits of resolution and the quantization error for that is -56 dB
-				// which calculates out to approx 0.00195 -- so we use that as epsilon
-				// to determine the amount of acceptable deviation in our check below
+				// the default mode is 'fast', which means a 4096-interval lookup table is interpolated
+				// the error of the interpolation is below 2e-8 for the equal-power shape
+				// so we use 1e-6 as epsilon to determine the amount of acceptable deviation in our check below
 
-				REQUIRE(result[0] == Approx(std::sqrt(2.0) / 2.0).epsilon(0.00195));
-				REQUIRE(result[1] == Approx(std::sqrt(2.0) / 2.0).epsilon(0.00195));
+				REQUIRE(result[0] == Approx(std::sqrt(2.0) / 2.0).epsilon(1e-6));
+				REQUIRE(result[1] == Approx(std::sqrt(2.0) / 2.0).epsilon(1e-6));
 			}
 		}
 
@@ -56,10 +55,10 @@ SCENARIO("object produces correct output") {
 				REQUIRE(result[0] == Approx(std::sqrt(2.0) / 2.0));
 				REQUIRE(result[1] == Approx(std::sqrt(2.0) / 2.0));
 			}
-			AND_THEN("due to quantization of the lookup table 'precision' won't be the same as 'fast'") {
+			AND_THEN("due to the interpolation of the lookup table 'fast' is as accurate as 'precision'") {
 
-				// this is a way we can check that the object is actually doing something different
-				// internally when we change the attribute value
+				// the lookup table used by 'fast' is interpolated,
+				// so it only differs from calculating the shape on-the-fly by the error of the interpolation
 
 				my_object.mode        = "precision";
 				auto result_precision = my_object(1.0)[0];
@@ -67,7 +66,7 @@ SCENARIO("object produces correct output") {
 				my_object.mode   = "fast";
 				auto result_fast = my_object(1.0)[0];
 
-				REQUIRE(result_precision != Approx(result_fast));
+				REQUIRE(result_fast == Approx(result_precision).epsilon(1e-6));
 			}
 		}
 
@@ -21,21 +21,16 @@ public:
 
     message<> m_box_count { this, "box_count", "Return the total number of boxes in this patcher.",
         MIN_FUNCTION {
-            auto p = patcher();
-            auto boxes = p.boxes();
-            
-            m_out.send(boxes.size());
+            m_out.send(m_boxes.all(patcher()).size());
             return {};
         }
     };
     
     message<> m_classnames { this, "classnames", "Return the classnames of all boxes in this patcher.",
         MIN_FUNCTION {
-            auto p = patcher();
-            auto boxes = p.boxes();
             atoms as {};
-            
-            for (const auto& b : boxes)
+
+            for (const auto& b : m_boxes.all(patcher()))
                 as.push_back(b.classname());
             m_out.send(as);
             return {};
@@ -44,11 +39,9 @@ public:
    
     message<> m_boxpaths { this, "boxpaths", "Return the paths of all boxes in this patcher.",
         MIN_FUNCTION {
-            auto p = patcher();
-            auto boxes = p.boxes();
             atoms as {};
-            
-            for (const auto& b : boxes)
+
+            for (const auto& b : m_boxes.all(patcher()))
                 as.push_back(b.path());
             m_out.send(as);
             return {};
@@ -56,9 +49,100 @@ public:
     };
 
 
+    message<> m_class_count { this, "class_count", "Return the number of boxes of a class in this patcher, e.g. 'newobj' or 'message'.",
+        MIN_FUNCTION {
+            symbol classname = args[0];
+
+            m_out.send(classname, m_boxes.of_class(patcher(), classname).size());
+            return {};
+        }
+    };
+
+
+    message<> m_boxpath { this, "boxpath", "Return the path of the box with a scripting name in this patcher.",
+        MIN_FUNCTION {
+            symbol name = args[0];
+
+            if (auto b = m_boxes.find(patcher(), name))
+                m_out.send(name, b->path());
+            return {};
+        }
+    };
+
+
+    message<> m_query { this, "query",
+        "Return several properties of every box in this patcher, one list for each box, read in a single walk of the patcher. "
+        "Arguments are 'classname', 'path', 'name' or the names of box attributes such as 'patching_rect'.",
+        MIN_FUNCTION {
+            vector<symbol> fields;
+            for (const auto& a : args)
+                fields.push_back(a);
+
+            for (const auto& b : m_boxes.all(patcher()))
+                m_out.send(b.properties(fields));
+            return {};
+        }
+    };
+
+
+    // Scripting edits between 'begin' and 'end' are collected and applied together,
+    // so the patcher is only marked as modified once rather than for every edit.
+
+    message<> m_begin { this, "begin", "Begin collecting 'set' messages, which are applied together with 'end'.",
+        MIN_FUNCTION {
+            if (!m_transaction)
+                m_transaction = std::make_unique<min::patcher::transaction>(patcher());
+            return {};
+        }
+    };
+
+
+    message<> m_set { this, "set",
+        "Set an attribute of the box with a scripting name: the name, the attribute and its value. "
+        "Between 'begin' and 'end' the edit is applied with 'end', otherwise straight away.",
+        MIN_FUNCTION {
+            if (args.size() < 3)
+                return {};
+
+            symbol name = args[0];
+            auto   b { m_boxes.find(patcher(), name) };
+            if (!b) {
+                cerr << "no box named " << name << endl;
+                return {};
+            }
+
+            const atoms value(args.begin() + 2, args.end());
+            if (m_transaction)
+                m_transaction->set(*b, args[1], value);
+            else
+                min::patcher::transaction(patcher()).set(*b, args[1], value);
+            return {};
+        }
+    };
+
+
+    message<> m_end { this, "end", "Apply the 'set' messages since 'begin'.",
+        MIN_FUNCTION {
+            m_transaction.reset();    // commits the edits
+            return {};
+        }
+    };
+
+
+    // the boxes are kept in an index until the patcher changes, rather than walking the patcher for every query
+
+    message<> notify { this, "notify",
+        MIN_FUNCTION {
+            m_boxes.notify(args);
+            return {};
+        }
+    };
+
+
     
 private:
-    
+    box_index                                       m_boxes { maxobj() };
+    std::unique_ptr<min::patcher::transaction>      m_transaction;
 };
 
 MIN_EXTERNAL(patcher_control);
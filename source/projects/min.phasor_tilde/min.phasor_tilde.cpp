@@ -8,7 +8,7 @@
 using namespace c74::min;
 
 
-class phasor : public object<phasor>, public sample_operator<0, 1> {
+class phasor : public object<phasor>, public sample_operator<1, 1> {
 private:
     lib::sync m_oscillator;    // note: must be created prior to any attributes that might set parameters below
 
@@ -21,7 +21,7 @@ public:
     MIN_AUTHOR		{ "Cycling '74" };
     MIN_RELATED		{ "phasor~, saw~" };
 
-    inlet<>  in1 {this, "(number) frequency"};
+    inlet<>  in1 {this, "(signal/number) frequency"};
     outlet<> out1 {this, "(signal) ramp wave", "signal"};
 
     argument<number> frequency_arg { this, "frequency", "Initial frequency in hertz.",
@@ -45,6 +45,17 @@ public:
         }}
     };
 
+
+    // a signal connected to the inlet sets the frequency of each sample, otherwise the frequency attribute is used
+
+    void operator()(const sample_block<1>& input, sample_block<1>& output) {
+        if (in1.has_signal_connection())
+            m_oscillator(input[0], output[0], output.frame_count());
+        else
+            m_oscillator(output[0], output.frame_count());
+    }
+
+
     sample operator()() {
         return m_oscillator();
     }
@@ -0,0 +1,15 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min_benchmark.h"     // required benchmark header
+#include "min.phasor_tilde.cpp"    // need the source of our object so that we can measure it
+
+// Run with e.g. --samplerates 44100 96000 --vectorsizes 16 64 512 to measure other configurations.
+
+int main(int argc, char* argv[]) {
+    ext_main(nullptr);    // every benchmark must call ext_main() once to configure the class
+
+    return benchmark<phasor>("min.phasor~", benchmark_settings(argc, argv));
+}
@@ -0,0 +1,132 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "pitch_tracker.h"
+
+using namespace c74::min;
+
+
+class pitch : public object<pitch>, public vector_operator<> {
+public:
+    MIN_DESCRIPTION	{ "Track the pitch of a signal. "
+                      "Every hop of samples, the pitch of the last window of samples is estimated from the distances between the minima "
+                      "of its difference function, which is updated with the samples of the hop rather than computed anew. "
+                      "The estimates of all hops since the last output are sent together as a list of pairs of pitch and confidence." };
+    MIN_TAGS		{ "audio, analysis" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "sigmund~, fzero~, min.edge~" };
+
+    inlet<>  m_inlet	{ this, "(signal) Input to analyze" };
+    outlet<thread_check::scheduler, thread_action::batch> m_outlet	{ this,
+        "(list) Pitch in Hz and confidence (0 to 1) of each hop since the last output. The pitch is 0 when none has been found." };
+
+private:
+    // declared before the attributes, whose setters request a new tracker
+
+    using tracker_type = Butterfly::StreamingPitchTracker<double>;
+
+    mutex                           m_mutex;
+    std::unique_ptr<tracker_type>   m_tracker;
+
+    // changes to the attributes may arrive on any thread, so the tracker is rebuilt from a queue
+
+    queue<> m_rebuild { this,
+        MIN_FUNCTION {
+            rebuild();
+            return {};
+        }
+    };
+
+public:
+    attribute<int> m_window {this, "window", 2048,
+        description {"Number of samples that each estimate is made from. "
+                     "The window needs to hold at least two periods of the lowest pitch to be tracked."},
+        setter { MIN_FUNCTION {
+            m_rebuild.set();
+            return { std::max(static_cast<int>(args[0]), 10) };
+        }}
+    };
+
+
+    attribute<int> m_hop {this, "hop", 256,
+        description {"Number of samples between two estimates. It is limited to the size of the window."},
+        setter { MIN_FUNCTION {
+            m_rebuild.set();
+            return { std::max(static_cast<int>(args[0]), 1) };
+        }}
+    };
+
+
+    attribute<number> m_tolerance {this, "tolerance", 0.3,
+        description {"Tolerance of the search for periods. A higher tolerance finds the pitch of noisier signals, "
+                     "but can lead to wrong estimates."},
+        setter { MIN_FUNCTION {
+            m_rebuild.set();
+            return { MIN_CLAMP(static_cast<double>(args[0]), 0.0, 1.0) };
+        }}
+    };
+
+
+    attribute<symbol> m_function {this, "function", "amdf",
+        description {"Difference function that the periods are found in: the average magnitude difference ('amdf') "
+                     "or the squared difference ('squared'), which favours the strongest periodicity."},
+        setter { MIN_FUNCTION {
+            m_rebuild.set();
+            return args;
+        }},
+        range {"amdf", "squared"}
+    };
+
+
+    message<> dspsetup {this, "dspsetup",
+        MIN_FUNCTION {
+            rebuild();
+            return {};
+        }
+    };
+
+
+    /// Process one vector of audio.
+    /// If the tracker is being replaced at the same time, this vector is skipped rather than waiting for the change.
+
+    void operator()(audio_bundle input, audio_bundle) {
+        auto in = input.samples(0);
+        auto n  = static_cast<size_t>(input.frame_count());
+        auto sr = samplerate();
+
+        lock lock {m_mutex, std::try_to_lock};
+        if (!lock.owns_lock() || !m_tracker)
+            return;
+
+        const auto& parameters = m_tracker->getParameters();
+        m_tracker->process(in, n, [this, &parameters, sr](const std::optional<Butterfly::PitchInfo>& estimate) {
+            if (estimate)
+                m_outlet.send(estimate->frequency * sr, tracker_type::confidence(*estimate, parameters));
+            else
+                m_outlet.send(0.0, 0.0);
+        });
+    }
+
+private:
+    // The new tracker is prepared (which allocates) before taking the lock, so the audio thread is only ever blocked for the swap.
+    // The old tracker is then disposed of here rather than in the audio thread.
+
+    void rebuild() {
+        Butterfly::PitchFindingParameters parameters;
+        parameters.tolerance          = m_tolerance;
+        parameters.differenceFunction = m_function == "squared"
+                                            ? Butterfly::PitchFindingParameters::DifferenceFunction::SquaredDifference
+                                            : Butterfly::PitchFindingParameters::DifferenceFunction::AMDF;
+
+        auto tracker = std::make_unique<tracker_type>(m_window, m_hop, parameters);
+        {
+            lock lock {m_mutex};
+            std::swap(m_tracker, tracker);
+        }
+    }
+};
+
+MIN_EXTERNAL(pitch);
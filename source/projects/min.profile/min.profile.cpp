@@ -0,0 +1,84 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+
+using namespace c74::min;
+
+
+class profile : public object<profile> {
+public:
+    MIN_DESCRIPTION	{ "Report the time that the audio processing of each Min-based object takes. "
+                      "While profiling is on, every call of the perform routine of every audio object made with Min is timed." };
+    MIN_TAGS		{ "developer" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "min.stress~, min.threadcheck, dspstress~" };
+
+    inlet<>  input	{ this, "(bang) report, (start/stop) turn profiling on or off" };
+    outlet<> output	{ this, "(list) class, mean, p99 and maximum time in microseconds, vector count, thread hops" };
+
+
+    ~profile() {
+        if (m_started)
+            perform_profile::enabled(false);
+    }
+
+
+    message<> start { this, "start", "Start timing the audio processing of all Min-based objects.",
+        MIN_FUNCTION {
+            perform_profile::enabled(true);
+            m_started = true;
+            return {};
+        }
+    };
+
+
+    message<> stop { this, "stop", "Stop timing. The times measured so far are kept until they are reset.",
+        MIN_FUNCTION {
+            perform_profile::enabled(false);
+            m_started = false;
+            return {};
+        }
+    };
+
+
+    message<> reset { this, "reset", "Clear the times measured so far.",
+        MIN_FUNCTION {
+            perform_profile::for_each([](perform_profile& p) {
+                p.reset();
+            });
+            return {};
+        }
+    };
+
+
+    // The summaries are taken while the registry of profiles is locked, but output after it is released,
+    // so that the patcher connected to the outlet may create or free audio objects.
+
+    message<> bang { this, "bang", "Output one list for each object that has been timed, the slowest first.",
+        MIN_FUNCTION {
+            vector<std::pair<symbol, perform_profile::summary>> summaries;
+
+            perform_profile::for_each([&summaries](const perform_profile& p) {
+                const auto s { p.summarize() };
+                if (s.count)
+                    summaries.emplace_back(c74::max::object_classname(p.owner()), s);
+            });
+
+            std::sort(summaries.begin(), summaries.end(), [](const auto& a, const auto& b) {
+                return a.second.mean > b.second.mean;
+            });
+
+            for (const auto& [name, s] : summaries)
+                output.send(name, s.mean, s.p99, s.maximum, static_cast<c74::max::t_atom_long>(s.count), static_cast<c74::max::t_atom_long>(s.thread_hops));
+            return {};
+        }
+    };
+
+private:
+    bool m_started { false };
+};
+
+MIN_EXTERNAL(profile);
@@ -10,7 +10,7 @@ using namespace c74::min;
 class progress : public object<progress> {
 private:
     number m_current_progress {};
-    number m_stepsize {};
+    double m_start_time {};
 
 public:
     MIN_DESCRIPTION	{ "Demonstrate display of a progress bar." };
@@ -27,25 +27,29 @@ public:
     message<> m_bang { this, "bang", "Start process.",
         MIN_FUNCTION {
             m_current_progress = 0.0;
-            m_stepsize = 1.0 / m_duration;
+            c74::max::clock_getftime(&m_start_time);
 
             auto b = box();
             b("startprogress", &m_current_progress);
 
-            m_timer.delay(1.0);
+            m_refresher.start();
             return {};
         }
     };
 
 
-    timer<timer_options::defer_delivery> m_timer { this, MIN_FUNCTION {
+    // the box only shows the progress when it is drawn, so it is advanced once per frame, by the time that has passed
+
+    refresher m_refresher { this, MIN_FUNCTION {
         if (m_current_progress >= 1.0) {
+            m_refresher.stop();
             auto b = box();
             b("stopprogress");
         }
         else {
-            m_current_progress += m_stepsize;
-            m_timer.delay(1.0);
+            double now {};
+            c74::max::clock_getftime(&now);
+            m_current_progress = std::min((now - m_start_time) / m_duration, 1.0);
         }
         return {};
     }};
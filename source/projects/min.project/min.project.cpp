@@ -7,7 +7,10 @@
 #include <windows.h>
 #endif
 #include "c74_min.h"
+#include <condition_variable>
 #include <regex>
+#include <thread>
+#include <sys/stat.h>
 #ifdef MAC_VERSION
 #include <Carbon/Carbon.h>
 #endif    // MAC_VERSION
@@ -15,6 +18,19 @@
 using namespace c74::min;
 
 
+// the time a file or folder was last modified, or 0 if it does not exist
+
+static std::time_t modification_time(const std::string& file) {
+#ifdef WIN_VERSION
+    struct _stat s;
+    return _stat(file.c_str(), &s) == 0 ? s.st_mtime : 0;
+#else
+    struct stat s;
+    return stat(file.c_str(), &s) == 0 ? s.st_mtime : 0;
+#endif
+}
+
+
 std::string min_devkit_path() {
 #ifdef WIN_VERSION
     char    pathstr[4096];
@@ -200,6 +216,12 @@ public:
     };
 
 
+    // CMake generates the projects of all objects of a package in one run, which can take minutes,
+    // so the run happens on a worker thread and the progress is shown in the box meanwhile.
+    // Opening the project afterwards uses Max and the operating system's user interface, so it happens on the main thread.
+    // If only one object's project is asked for and neither its CMakeLists.txt nor its source changed since its project
+    // was generated, CMake is not run again.
+
     message<> generate { this, "generate", "Generate IDE projects and then open the specified project only.",
         MIN_FUNCTION {
             try {
@@ -239,9 +261,11 @@ char   separator {'\\'};
                 string build_path {"/build"};
                 string log_path {"/tmp/min-cmake-log.txt"};
 
+                job j;
+
                 std::stringstream mkdir_command;
                 mkdir_command << "mkdir \"" << project_path_str << separator << "tmp\"";
-                std::system(mkdir_command.str().c_str());
+                j.mkdir_command = mkdir_command.str();
 
                 std::stringstream cmake_command;
                 cmake_command << "cd \"" << project_path_str << build_path << "\" && \"" << cmake_path;
@@ -250,18 +274,28 @@ char   separator {'\\'};
 #else    // WIN_VERSION
                 cmake_command << "\" -G \"Visual Studio 16 2019\" .. > \"" << project_path_str << log_path << "\" 2>&1";
 #endif
+                j.cmake_command = cmake_command.str();
 
-                std::cout << cmake_command.str() << std::endl;
+                if (args.size() == 1) {
+                    path   project_path {args};
+                    string object_path_str {project_path_str + "/source/projects/" + project_path.name()};
 
-                auto result = std::system(cmake_command.str().c_str());
-                if (result == 0) {
+                    j.inputs = { object_path_str + "/CMakeLists.txt", object_path_str + "/" + project_path.name() + ".cpp" };
+#ifdef MAC_VERSION
+                    j.generated = project_path_str + build_path + "/source/projects/" + project_path.name() + "/" + project_path.name() + ".xcodeproj";
+#else    // WIN_VERSION
+                    j.generated = project_path_str + build_path + "/source/projects/" + project_path.name() + "/" + project_path.name() + ".sln";
+#endif
+                }
+
+                j.open = [=]() -> int {
 #ifdef MAC_VERSION
                     if (args.size() > 1) {
                         std::stringstream open_command;
                         open_command << "cd \"" << project_path_str << build_path << "\" && "
                                      << "open \"" << project_path_str << build_path << strrchr(project_path_str.c_str(), '/')
                                      << ".xcodeproj\"";
-                        result = std::system(open_command.str().c_str());
+                        return std::system(open_command.str().c_str());
                     }
                     else {
                         path              project_path {args};
@@ -269,7 +303,7 @@ char   separator {'\\'};
                         open_command << "cd \"" << project_path_str << build_path << "\" && "
                                      << "open \"" << project_path_str << build_path << "/source/projects/" << project_path.name()
                                      << separator << project_path.name() << ".xcodeproj\"";
-                        result = std::system(open_command.str().c_str());
+                        return std::system(open_command.str().c_str());
                     }
 #else    // WIN_VERSION
     if (args.size() > 1) {
@@ -296,9 +330,12 @@ char   separator {'\\'};
 
 		ShellExecute(NULL, "open", vs_sln_path_esc.c_str(), NULL, NULL, SW_SHOWNORMAL);
     }
+    return 0;
 #endif
-                }
-                output.send(result);
+                };
+
+                std::cout << j.cmake_command << std::endl;
+                submit(std::move(j));
             }
             catch (...) {
                 cerr << "Could not generate project(s) with that specification." << endl;
@@ -399,6 +436,143 @@ char   separator {'\\'};
         }
     };
 
+
+    ~project() {
+        if (m_worker.joinable()) {
+            {
+                lock lock {m_mutex};
+                m_quit = true;
+            }
+            m_condition.notify_one();
+            m_worker.join();
+        }
+    }
+
+private:
+    struct job {
+        string                  mkdir_command;
+        string                  cmake_command;
+        vector<string>          inputs;        ///< the files of the object whose project is opened, if only one is
+        string                  generated;     ///< the project of that object
+        std::function<int()>    open;          ///< called on the main thread after a successful run
+        int                     result {};
+    };
+
+    // jobs from the main thread to the worker thread, and back
+
+    std::mutex                  m_mutex;
+    std::condition_variable     m_condition;
+    std::deque<job>             m_jobs;
+    vector<job>                 m_finished;
+    bool                        m_quit { false };
+    std::thread                 m_worker;
+
+    // progress shown in the box: the jobs finished, and halfway through a job once its folders exist
+
+    std::atomic<double>         m_completed {};
+    number                      m_progress {};    // main thread only, read by the box
+    size_t                      m_submitted {};   // main thread only: jobs since the box started showing progress
+    size_t                      m_pending {};     // main thread only: jobs that have not been delivered yet
+
+
+    void submit(job&& j) {
+        if (m_pending == 0) {
+            m_completed = 0.0;
+            m_progress  = 0.0;
+            m_submitted = 0;
+            box()("startprogress", &m_progress);
+            m_refresher.start();
+        }
+        ++m_submitted;
+        ++m_pending;
+
+        {
+            lock lock {m_mutex};
+            m_jobs.push_back(std::move(j));
+            if (!m_worker.joinable())
+                m_worker = std::thread { &project::run, this };
+        }
+        m_condition.notify_one();
+    }
+
+
+    void run() {
+        while (true) {
+            job j;
+            {
+                lock lock {m_mutex};
+                m_condition.wait(lock, [this] {
+                    return m_quit || !m_jobs.empty();
+                });
+                if (m_quit)
+                    return;
+                j = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            if (!up_to_date(j)) {
+                std::system(j.mkdir_command.c_str());
+                m_completed = m_completed + 0.5;
+                j.result = std::system(j.cmake_command.c_str());
+                m_completed = m_completed + 0.5;
+            }
+            else
+                m_completed = m_completed + 1.0;
+
+            {
+                lock lock {m_mutex};
+                m_finished.push_back(std::move(j));
+            }
+            m_deliver.set();
+        }
+    }
+
+
+    // the project of a single object is up to date if it is newer than the object's files
+
+    static bool up_to_date(const job& j) {
+        if (j.generated.empty())
+            return false;
+
+        const auto generated { modification_time(j.generated) };
+        if (generated == 0)
+            return false;
+        return std::all_of(j.inputs.begin(), j.inputs.end(), [generated](const string& input) {
+            return modification_time(input) < generated;
+        });
+    }
+
+
+    queue<> m_deliver { this,
+        MIN_FUNCTION {
+            vector<job> finished;
+            {
+                lock lock {m_mutex};
+                std::swap(finished, m_finished);
+            }
+
+            for (auto& j : finished) {
+                if (j.result == 0)
+                    j.result = j.open();
+                output.send(j.result);
+
+                if (--m_pending == 0) {
+                    m_refresher.stop();
+                    m_progress = 1.0;
+                    box()("stopprogress");
+                }
+            }
+            return {};
+        }
+    };
+
+
+    refresher m_refresher { this,
+        MIN_FUNCTION {
+            m_progress = m_completed / std::max<size_t>(m_submitted, 1);
+            return {};
+        }
+    };
 };
 
 MIN_EXTERNAL(project);
@@ -4,44 +4,243 @@
 /// @license        Use of this source code is governed by the MIT License found in the License.md file.
 
 #include "c74_min.h"
+#include "../shared/remote_packet.h"
+#include "../shared/udp_socket.h"
 
 using namespace c74::min;
 
 
 class remote : public object<remote> {
 public:
-    MIN_DESCRIPTION { "Address an object remotely" };
+    MIN_DESCRIPTION { "Address an object remotely, in this patcher or in the patcher of a [min.remote] in another Max. "
+                      "Messages to another Max are sent over UDP, many to a packet." };
     MIN_TAGS        { "developer" };
     MIN_AUTHOR      { "Cycling '74" };
-    MIN_RELATED     { "thispatcher, send, forward, pattr" };
+    MIN_RELATED     { "thispatcher, send, forward, pattr, udpsend" };
 
     inlet<>  m_in    { this, "(anything) send messages to an object" };
     outlet<> m_out    { this, "(anything) query responses" };
 
 
+    // The boxes are indexed by their scripting names, and the boxes and methods that messages were sent to are kept,
+    // so a message to a known target is a direct call. Both are dropped when the patcher or the scripting names change.
+
+    message<> notify { this, "notify",
+        MIN_FUNCTION {
+            if (m_boxes.notify(args))
+                m_targets.clear();
+            return {};
+        }
+    };
+
+
+    message<> m_bind { this, "bind",
+        "Look up a named object, and optionally the names of messages to it, ahead of sending messages to it. "
+        "First argument is the scripting name of the object. Any additional arguments are names of messages.",
+
+        MIN_FUNCTION {
+            if (args.empty())
+                return {};
+
+            auto t { resolve(args[0]) };
+            if (!t) {
+                cerr << "no object named " << args[0] << endl;
+                return {};
+            }
+            for (auto i = 1u; i < args.size(); ++i)
+                resolve(*t, args[i]);
+            return {};
+        }
+    };
+
+
+private:
+    // declared before the attributes, whose setters open the sockets
+
+    symbol                  m_host_name;
+    int                     m_port_number { 7400 };
+    udp_socket              m_sender;
+    udp_socket              m_receiver;
+    remote_packet_writer    m_packet;
+    remote_packet_reader    m_reader;
+    unsigned char           m_received[remote_packet_writer::k_max_size];
+
+
+    // Messages and packets are handled on the main thread, to which the messages of the object are deferred,
+    // so the packet and the targets are only used by one thread.
+
+    timer<timer_options::defer_delivery> m_flush { this,
+        MIN_FUNCTION {
+            flush();
+            return {};
+        }
+    };
+
+
+    timer<timer_options::defer_delivery> m_poll { this,
+        MIN_FUNCTION {
+            size_t size;
+            while ((size = m_receiver.receive(m_received, sizeof(m_received))) > 0)
+                m_reader.read(m_received, size, [this](const atoms& message) { dispatch(message); });
+
+            if (m_receiver.is_open())
+                m_poll.delay(k_poll_interval);
+            return {};
+        }
+    };
+
+public:
+    attribute<symbol> m_host { this, "host", "",
+        description {"The host of another Max to which messages are sent, by name or IPv4 address. "
+                     "When it is empty, messages are sent to the boxes of this patcher."},
+        setter { MIN_FUNCTION {
+            m_host_name = args[0];
+            connect();
+            return args;
+        }}
+    };
+
+
+    attribute<int> m_port { this, "port", 7400,
+        description {"The UDP port on which the [min.remote] in the other Max listens."},
+        setter { MIN_FUNCTION {
+            m_port_number = MIN_CLAMP(static_cast<int>(args[0]), 1, 65535);
+            connect();
+            return { m_port_number };
+        }}
+    };
+
+
+    attribute<int> m_listen { this, "listen", 0,
+        description {"The UDP port on which messages from other instances of Max are received and sent to the boxes of this patcher, "
+                     "or 0 to receive none."},
+        setter { MIN_FUNCTION {
+            const auto port { MIN_CLAMP(static_cast<int>(args[0]), 0, 65535) };
+            listen(port);
+            return { port };
+        }}
+    };
+
+
     message<> m_classnames { this, "anything",
         "Send a message to a named object. "
         "First argument is the scripting name of the object. "
         "Second argument is the name of the message to send. "
-        "Any additional arguments are passed as arguments to the named object. ",
+        "Any additional arguments are passed as arguments to the named object. "
+        "When the host attribute is set, the message is sent to the object of that name in the other Max instead, "
+        "in one packet with the other messages sent in the same scheduler tick.",
 
         MIN_FUNCTION {
-            auto p = patcher();
-            auto boxes = p.boxes();
-            atoms as {};
+            if (args.size() < 2)
+                return {};
 
-            for (auto& b : boxes) {
-                if (b.name() == args[0])
-                    b(args[1], args[2]);
-            }
-            //m_out.send(as);
+            if (m_sender.is_open())
+                enqueue(args);
+            else
+                dispatch(args);
             return {};
         }
     };
 
 
 private:
+    static constexpr double k_poll_interval { 1.0 };    // milliseconds between polls of the receiving socket
+
+    struct target {
+        box                                                                 b;
+        std::unordered_map<const max::t_symbol*, instance::messinfo>        methods;
+    };
+
+    box_index                                               m_boxes { maxobj() };
+    std::unordered_map<const max::t_symbol*, target>        m_targets;    // by scripting name
+
+
+    target* resolve(const symbol name) {
+        const auto found { m_targets.find(name) };
+        if (found != m_targets.end())
+            return &found->second;
+
+        auto b { m_boxes.find(patcher(), name) };
+        if (!b)
+            return nullptr;
+        return &m_targets.emplace(name, target { *b, {} }).first->second;
+    }
+
+
+    const instance::messinfo& resolve(target& t, const symbol method_name) {
+        const auto found { t.methods.find(method_name) };
+        if (found != t.methods.end())
+            return found->second;
+        return t.methods.emplace(method_name, t.b.resolve(method_name)).first->second;
+    }
+
+
+    void dispatch(const atoms& args) {
+        if (args.size() < 2)
+            return;
 
+        auto t { resolve(args[0]) };
+        if (!t)
+            return;
+
+        const symbol method_name = args[1];
+        const auto&  m { resolve(*t, method_name) };
+
+        if (args.size() > 2)
+            t->b.call(m, method_name, args[2]);
+        else
+            t->b.call(m, method_name);
+    }
+
+
+    // the first message of a packet schedules the packet to be sent in the next scheduler tick
+
+    void enqueue(const atoms& args) {
+        if (!m_packet.add(args)) {
+            flush();
+            if (!m_packet.add(args)) {
+                cerr << "message to " << args[0] << " is too long to be sent" << endl;
+                return;
+            }
+        }
+        if (m_packet.count() == 1)
+            m_flush.delay(0);
+    }
+
+
+    void flush() {
+        if (m_packet.empty())
+            return;
+        m_sender.send(m_packet.data(), m_packet.size());
+        m_packet.clear();
+    }
+
+
+    void connect() {
+        m_packet.clear();
+        m_sender.close();
+        if (m_host_name.empty())
+            return;
+
+        if (!m_sender.open() || !m_sender.destination(m_host_name.c_str(), static_cast<uint16_t>(m_port_number))) {
+            cerr << "could not send to " << m_host_name << " on port " << m_port_number << endl;
+            m_sender.close();
+        }
+    }
+
+
+    void listen(const int port) {
+        m_poll.stop();
+        m_receiver.close();
+        if (!port)
+            return;
+
+        if (!m_receiver.open(static_cast<uint16_t>(port))) {
+            cerr << "could not listen on port " << port << endl;
+            return;
+        }
+        m_poll.delay(k_poll_interval);
+    }
 };
 
 MIN_EXTERNAL(remote);
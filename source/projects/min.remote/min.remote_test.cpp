@@ -0,0 +1,62 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2020 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min_unittest.h"    // required unit test header
+#include "min.remote.cpp"        // need the source of our object so that we can access it
+
+// Unit tests are written using the Catch framework as described at
+// https://github.com/philsquared/Catch/blob/master/docs/tutorial.md
+
+SCENARIO("messages to another Max are batched into packets") {
+
+    GIVEN("a packet of three messages") {
+        remote_packet_writer writer;
+
+        REQUIRE(writer.add({ "osc", "frequency", 440.5 }));
+        REQUIRE(writer.add({ "gain", "set", -3, "dB" }));
+        REQUIRE(writer.add({ "go", "bang" }));
+
+        remote_packet_reader reader;
+        vector<atoms>        messages;
+        const auto           receive = [&](const atoms& message) {
+            messages.push_back(message);
+        };
+
+        WHEN("the packet is read") {
+            REQUIRE(reader.read(writer.data(), writer.size(), receive) == 3);
+
+            THEN("the messages are those that were added") {
+                REQUIRE(messages[0].size() == 3);
+                REQUIRE(messages[0][0] == symbol("osc"));
+                REQUIRE(messages[0][1] == symbol("frequency"));
+                REQUIRE(static_cast<double>(messages[0][2]) == 440.5);
+                REQUIRE(messages[1].size() == 4);
+                REQUIRE(static_cast<int>(messages[1][2]) == -3);
+                REQUIRE(messages[1][2].type() == message_type::int_argument);
+                REQUIRE(messages[1][3] == symbol("dB"));
+                REQUIRE(messages[2].size() == 2);
+            }
+        }
+
+        WHEN("the end of the packet is lost") {
+            THEN("only the complete messages are read") {
+                REQUIRE(reader.read(writer.data(), writer.size() - 3, receive) == 2);
+            }
+        }
+    }
+
+    GIVEN("a packet that is filled") {
+        remote_packet_writer writer;
+        size_t               count {};
+
+        while (writer.add({ "osc", "frequency", 440.0 }))
+            ++count;
+
+        THEN("it still fits in one Ethernet frame") {
+            REQUIRE(count > 50);
+            REQUIRE(writer.size() <= remote_packet_writer::k_max_size);
+        }
+    }
+}
@@ -0,0 +1,401 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+
+using namespace c74::min;
+
+
+/// Reads frames from an uncompressed WAV file as interleaved stereo.
+/// Mono files are copied to both channels and files with more than two channels provide their first two.
+
+class wav_reader {
+public:
+    /// Open a file.
+    /// @param	filename	The absolute path of the file.
+    /// @return				True if the file is a WAV file in a supported format.
+
+    bool open(const string& filename) {
+        close();
+        m_file.open(filename, std::ios::binary);
+        if (!m_file || !parse_header()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        m_file.close();
+        m_file.clear();
+        m_frames     = 0;
+        m_position   = 0;
+        m_samplerate = 0.0;
+    }
+
+    bool is_open() const {
+        return m_file.is_open();
+    }
+
+    double samplerate() const {
+        return m_samplerate;
+    }
+
+    size_t frame_count() const {
+        return m_frames;
+    }
+
+
+    /// Move to a frame of the file.
+    /// @param	frame	The frame from which the next read() will start.
+
+    void seek(const size_t frame) {
+        m_position = std::min(frame, m_frames);
+        m_file.clear();
+        m_file.seekg(static_cast<std::streamoff>(m_data_start + m_position * m_block_align));
+    }
+
+
+    /// Read and convert frames.
+    /// @param	output	Storage for at least twice as many samples as frames.
+    /// @param	frames	The number of frames to read.
+    /// @return			The number of frames read, which is less than requested at the end of the file.
+
+    size_t read(float* output, size_t frames) {
+        frames = std::min(frames, m_frames - m_position);
+        m_raw.resize(frames * m_block_align);
+        m_file.read(m_raw.data(), static_cast<std::streamsize>(m_raw.size()));
+        frames = static_cast<size_t>(m_file.gcount()) / m_block_align;
+
+        const auto right_offset { m_channels > 1 ? m_bytes_per_sample : 0 };
+
+        for (size_t i = 0; i < frames; ++i) {
+            const auto frame { m_raw.data() + i * m_block_align };
+
+            output[i * 2]     = decode(frame);
+            output[i * 2 + 1] = decode(frame + right_offset);
+        }
+        m_position += frames;
+        return frames;
+    }
+
+private:
+    static constexpr uint16_t k_format_pcm { 1 };
+    static constexpr uint16_t k_format_float { 3 };
+    static constexpr uint16_t k_format_extensible { 0xFFFE };
+
+    std::ifstream   m_file;
+    vector<char>    m_raw;
+    uint16_t        m_format {};
+    size_t          m_channels {};
+    size_t          m_bytes_per_sample {};
+    size_t          m_block_align {};
+    size_t          m_data_start {};
+    size_t          m_frames {};
+    size_t          m_position {};
+    double          m_samplerate {};
+
+
+    // WAV files are little-endian
+
+    static uint32_t le(const unsigned char* bytes, const int count) {
+        uint32_t value {};
+
+        for (auto i = count - 1; i >= 0; --i)
+            value = (value << 8) | bytes[i];
+        return value;
+    }
+
+
+    bool parse_header() {
+        unsigned char riff[12];
+
+        if (!m_file.read(reinterpret_cast<char*>(riff), 12) || std::memcmp(riff, "RIFF", 4) || std::memcmp(riff + 8, "WAVE", 4))
+            return false;
+
+        bool          found_format { false };
+        unsigned char chunk[8];
+
+        while (m_file.read(reinterpret_cast<char*>(chunk), 8)) {
+            const auto size { le(chunk + 4, 4) };
+
+            if (!std::memcmp(chunk, "fmt ", 4)) {
+                unsigned char fmt[40] {};
+
+                m_file.read(reinterpret_cast<char*>(fmt), std::min<uint32_t>(size, sizeof(fmt)));
+                m_file.seekg(size - std::min<uint32_t>(size, sizeof(fmt)) + (size & 1), std::ios::cur);
+
+                m_format           = static_cast<uint16_t>(le(fmt, 2));
+                m_channels         = le(fmt + 2, 2);
+                m_samplerate       = le(fmt + 4, 4);
+                m_block_align      = le(fmt + 12, 2);
+                m_bytes_per_sample = le(fmt + 14, 2) / 8;
+                if (m_format == k_format_extensible && size >= 26)
+                    m_format = static_cast<uint16_t>(le(fmt + 24, 2));    // the first two bytes of the subformat guid
+                found_format = true;
+            }
+            else if (!std::memcmp(chunk, "data", 4)) {
+                if (!found_format || !supported())
+                    return false;
+                m_data_start = static_cast<size_t>(m_file.tellg());
+                m_frames     = size / m_block_align;
+                m_position   = 0;
+                return true;
+            }
+            else
+                m_file.seekg(size + (size & 1), std::ios::cur);    // chunks are padded to an even size
+        }
+        return false;
+    }
+
+
+    bool supported() const {
+        if (m_channels == 0 || m_block_align < m_channels * m_bytes_per_sample)
+            return false;
+        if (m_format == k_format_pcm)
+            return m_bytes_per_sample >= 2 && m_bytes_per_sample <= 4;
+        if (m_format == k_format_float)
+            return m_bytes_per_sample == 4 || m_bytes_per_sample == 8;
+        return false;
+    }
+
+
+    float decode(const char* sample) const {
+        const auto bytes { reinterpret_cast<const unsigned char*>(sample) };
+
+        if (m_format == k_format_float) {
+            if (m_bytes_per_sample == 4) {
+                float f;
+                std::memcpy(&f, bytes, 4);
+                return f;
+            }
+            double d;
+            std::memcpy(&d, bytes, 8);
+            return static_cast<float>(d);
+        }
+
+        // shift the most significant byte into the sign bit, whatever the sample size
+        const auto bits { static_cast<int>(m_bytes_per_sample * 8) };
+        const auto value { static_cast<int32_t>(le(bytes, static_cast<int>(m_bytes_per_sample)) << (32 - bits)) };
+
+        return static_cast<float>(value / 2147483648.0);
+    }
+};
+
+
+class sfstream : public object<sfstream>, public vector_operator<> {
+public:
+    MIN_DESCRIPTION	{ "Stream a WAV file from disk. "
+                      "The file is read on a background thread ahead of the playback position, "
+                      "so files of any length can be played without loading them into memory. "
+                      "Playback is at the samplerate of Max, without conversion." };
+    MIN_TAGS		{ "audio, sampling" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "sfplay~, min.buffer.loop~, buffer~" };
+
+    inlet<>  m_inlet		{ this, "(anything) Messages to open, start, stop, and seek" };
+    outlet<> m_out_left		{ this, "(signal) Left output", "signal" };
+    outlet<> m_out_right	{ this, "(signal) Right output", "signal" };
+
+
+    attribute<bool, threadsafe::snapshot> m_loop {this, "loop", false,
+        description {"Loop the file. Otherwise playback stops at the end of the file."}
+    };
+
+
+    message<> open {this, "open", "Open a WAV file to stream. Without an argument a dialog is shown to choose the file.",
+        MIN_FUNCTION {
+            try {
+                path p { args, path::filetype::audio };
+                request({ static_cast<string>(p) }, 0.0);
+            }
+            catch (...) {
+                cerr << "could not find the file" << endl;
+            }
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> start {this, "start", "Start playing from the beginning of the file.",
+        MIN_FUNCTION {
+            request({}, 0.0);
+            m_playing = true;
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> stop {this, "stop", "Stop playing.",
+        MIN_FUNCTION {
+            m_playing = false;
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> seek {this, "seek", "Move to a position in the file, in milliseconds.",
+        MIN_FUNCTION {
+            request({}, args[0]);
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> number {this, "number", "Start (non-zero) or stop (zero) playing.",
+        MIN_FUNCTION {
+            if (static_cast<double>(args[0]) != 0.0) {
+                request({}, 0.0);
+                m_playing = true;
+            }
+            else
+                m_playing = false;
+            return {};
+        }
+    };
+
+
+    message<> dspsetup {this, "dspsetup",
+        MIN_FUNCTION {
+            m_interleaved.resize(static_cast<size_t>(vector_size()) * 2);
+            return {};
+        }
+    };
+
+
+    ~sfstream() {
+        if (m_reader.joinable()) {
+            {
+                lock lock {m_request_mutex};
+                m_quit = true;
+            }
+            m_request_condition.notify_one();
+            m_reader.join();
+        }
+    }
+
+
+    void operator()(audio_bundle input, audio_bundle output) {
+        auto left  = output.samples(0);
+        auto right = output.samples(1);
+        auto n     = static_cast<size_t>(output.frame_count());
+
+        // discard what was prefetched before the file was opened or a seek was requested
+        const auto epoch { m_epoch.load(std::memory_order_acquire) };
+
+        if (epoch != m_consumer_epoch) {
+            m_consumer_epoch = epoch;
+            m_ring.skip_to(m_epoch_start.load(std::memory_order_acquire));
+        }
+
+        size_t frames { 0 };
+
+        if (m_playing)
+            frames = m_ring.read(m_interleaved.data(), n * 2) / 2;
+
+        for (size_t i = 0; i < frames; ++i) {
+            left[i]  = m_interleaved[i * 2];
+            right[i] = m_interleaved[i * 2 + 1];
+        }
+        std::fill(left + frames, left + n, 0.0);
+        std::fill(right + frames, right + n, 0.0);
+    }
+
+private:
+    static constexpr size_t k_chunk_frames { 4096 };            // frames read from disk at a time
+    static constexpr size_t k_ring_frames { k_chunk_frames * 32 };
+
+    ring_buffer<float>          m_ring { k_ring_frames * 2 };    // interleaved stereo frames
+    vector<float>               m_interleaved;
+    std::atomic<bool>           m_playing { false };
+    std::atomic<uint64_t>       m_epoch { 0 };
+    std::atomic<uint64_t>       m_epoch_start { 0 };            // ring position at which the current epoch begins
+    uint64_t                    m_consumer_epoch { 0 };          // audio thread only
+
+    // requests from the main and scheduler threads to the reader thread
+
+    std::mutex                  m_request_mutex;
+    std::condition_variable     m_request_condition;
+    string                      m_requested_file;
+    double                      m_requested_position { 0.0 };
+    bool                        m_open_requested { false };
+    bool                        m_seek_requested { false };
+    bool                        m_quit { false };
+    std::thread                 m_reader;
+
+
+    // ask the reader thread to open a file (if a filename is given) and to seek to a position in milliseconds
+
+    void request(const string& filename, const double position) {
+        {
+            lock lock {m_request_mutex};
+
+            if (!filename.empty()) {
+                m_requested_file = filename;
+                m_open_requested = true;
+            }
+            m_requested_position = position;
+            m_seek_requested     = true;
+
+            if (!m_reader.joinable())
+                m_reader = std::thread { &sfstream::read_ahead, this };
+        }
+        m_request_condition.notify_one();
+    }
+
+
+    // the reader thread keeps the ring buffer filled ahead of the playback position
+
+    void read_ahead() {
+        wav_reader    file;
+        vector<float> chunk(k_chunk_frames * 2);
+        bool          at_end { false };
+
+        while (true) {
+            string filename;
+            double position { 0.0 };
+            bool   open_requested { false };
+            bool   seek_requested { false };
+
+            {
+                lock lock {m_request_mutex};
+
+                // wake periodically to top up the ring buffer as the audio thread consumes it
+                m_request_condition.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                    return m_quit || m_open_requested || m_seek_requested;
+                });
+                if (m_quit)
+                    return;
+
+                std::swap(filename, m_requested_file);
+                position       = m_requested_position;
+                open_requested = std::exchange(m_open_requested, false);
+                seek_requested = std::exchange(m_seek_requested, false);
+            }
+
+            if (open_requested && !file.open(filename))
+                cerr << "could not open " << filename << " as a WAV file" << endl;
+
+            if (seek_requested && file.is_open()) {
+                file.seek(static_cast<size_t>(std::max(position, 0.0) * 0.001 * file.samplerate()));
+                at_end = false;
+
+                m_epoch_start.store(m_ring.write_position(), std::memory_order_release);
+                m_epoch.fetch_add(1, std::memory_order_release);
+            }
+
+            while (file.is_open() && !at_end && m_ring.space() >= chunk.size()) {
+                const auto frames { file.read(chunk.data(), k_chunk_frames) };
+
+                m_ring.write(chunk.data(), frames * 2);
+                if (frames < k_chunk_frames) {
+                    if (*m_loop.snapshot() && file.frame_count() > 0)
+                        file.seek(0);
+                    else
+                        at_end = true;
+                }
+            }
+        }
+    }
+};
+
+
+MIN_EXTERNAL(sfstream);
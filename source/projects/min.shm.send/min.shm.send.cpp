@@ -0,0 +1,123 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min.h"
+#include "../shared/shared_memory_ring.h"
+
+using namespace c74::min;
+
+
+class shm_send : public object<shm_send> {
+public:
+    MIN_DESCRIPTION	{ "Stream numbers and lists to another process through shared memory, each stamped with the time of the scheduler. "
+                      "The other process reads them in place with the reader of shared_memory_ring.h, "
+                      "which documents the layout of the memory." };
+    MIN_TAGS		{ "routing" };
+    MIN_AUTHOR		{ "Cycling '74" };
+    MIN_RELATED		{ "mc.min.shm.send~, send, udpsend" };
+
+    inlet<> input { this, "(list) numbers to be streamed" };
+
+private:
+    // declared before the attributes, whose setters open the shared memory
+
+    mutex               m_mutex;    // numbers may arrive on the main thread and the scheduler at once
+    shared_memory       m_memory;
+    shared_memory_ring  m_ring;
+    vector<double>      m_values;
+    std::atomic<long>   m_dropped {};
+
+public:
+    argument<symbol> name_arg { this, "name", "The name of the shared memory.",
+        MIN_ARGUMENT_FUNCTION {
+            name = arg;
+        }
+    };
+
+
+    attribute<int> size { this, "size", 65536,
+        description {"Number of bytes that can wait for the other process to read them. Each list takes 16 bytes and 8 for each number. "
+                     "Lists that do not fit are dropped and counted. A change takes effect when the name is set again."},
+        setter { MIN_FUNCTION {
+            return { std::max(static_cast<int>(args[0]), 1024) / 8 * 8 };
+        }}
+    };
+
+
+    attribute<symbol> name { this, "name", "",
+        description {"The name of the shared memory, e.g. /control on macOS and Linux or Local\\control on Windows."},
+        setter { MIN_FUNCTION {
+            const symbol shm_name = args[0];
+            open(shm_name);
+            return args;
+        }}
+    };
+
+
+    attribute<int> dropped { this, "dropped", 0,
+        description {"Number of lists dropped because the other process fell behind, since the name was last set."},
+        readonly {true},
+        getter { MIN_GETTER_FUNCTION {
+            return { static_cast<int>(m_dropped) };
+        }}
+    };
+
+
+    message<threadsafe::yes> number { this, "number", "Stream a number.",
+        MIN_FUNCTION {
+            write(args);
+            return {};
+        }
+    };
+
+
+    message<threadsafe::yes> list { this, "list", "Stream a list of numbers.",
+        MIN_FUNCTION {
+            write(args);
+            return {};
+        }
+    };
+
+private:
+    // called by the setter of the name, on the main thread
+
+    void open(const symbol shm_name) {
+        lock lock { m_mutex };
+
+        m_ring = {};
+        m_memory.close();
+        m_dropped = 0;
+        if (shm_name.empty())
+            return;
+
+        const auto capacity = static_cast<uint64_t>(static_cast<int>(size));
+
+        if (!m_memory.create(shm_name.c_str(), shared_memory_ring::memory_size(capacity))) {
+            cerr << "could not create the shared memory " << shm_name << endl;
+            return;
+        }
+        m_ring.create(m_memory.data(), shared_ring_header::kind::control, 0, 0.0, capacity);
+    }
+
+
+    void write(const atoms& args) {
+        double now {};
+        max::clock_getftime(&now);
+
+        lock lock { m_mutex };
+
+        if (!m_ring.valid())
+            return;
+
+        m_values.clear();    // keeps its memory, so lists no longer than the longest so far allocate nothing
+        for (const auto& a : args)
+            m_values.push_back(a);
+
+        if (!m_ring.write_record(now, m_values.data(), static_cast<uint32_t>(m_values.size())))
+            ++m_dropped;
+    }
+};
+
+MIN_EXTERNAL(shm_send);
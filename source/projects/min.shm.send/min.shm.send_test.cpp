@@ -0,0 +1,129 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#include "c74_min_unittest.h"    // required unit test header
+#include "min.shm.send.cpp"      // need the source of our object so that we can access it
+
+// Unit tests are written using the Catch framework as described at
+// https://github.com/philsquared/Catch/blob/master/docs/tutorial.md
+
+SCENARIO("audio passes through a ring in memory") {
+
+    GIVEN("a ring of 8 stereo frames") {
+        std::vector<uint64_t> memory((shared_memory_ring::memory_size(8 * 2 * sizeof(float)) + 7) / 8);
+        shared_memory_ring    producer;
+        shared_memory_ring    consumer;
+
+        producer.create(memory.data(), shared_ring_header::kind::audio, 2, 44100.0, 8 * 2 * sizeof(float));
+        REQUIRE(consumer.open(memory.data(), memory.size() * 8));
+
+        double        left[6] { 1, 2, 3, 4, 5, 6 };
+        double        right[6] { -1, -2, -3, -4, -5, -6 };
+        const double* channels[2] { left, right };
+        vector<float> read;
+        const auto    reader = [&](const float* frames, const size_t count) {
+            read.insert(read.end(), frames, frames + count * 2);
+        };
+
+        WHEN("vectors are written and read") {
+            REQUIRE(producer.write_audio(channels, 2, 6));
+            REQUIRE(consumer.read_audio(reader) == 6);
+            read.clear();
+
+            REQUIRE(producer.write_audio(channels, 2, 6));    // wraps around the end of the data area
+            REQUIRE(consumer.read_audio(reader) == 6);
+
+            THEN("the frames are interleaved and in order") {
+                REQUIRE(read == vector<float> { 1, -1, 2, -2, 3, -3, 4, -4, 5, -5, 6, -6 });
+                REQUIRE(producer.header().dropped == 0);
+            }
+        }
+
+        WHEN("the consumer falls behind") {
+            REQUIRE(producer.write_audio(channels, 2, 6));
+            REQUIRE(!producer.write_audio(channels, 2, 6));
+
+            THEN("the vector that does not fit is dropped and counted") {
+                REQUIRE(consumer.read_audio(reader) == 6);
+                REQUIRE(producer.header().dropped == 6 * 2 * sizeof(float));
+            }
+        }
+
+        WHEN("an input has fewer channels than the ring") {
+            REQUIRE(producer.write_audio(channels, 1, 2));
+            consumer.read_audio(reader);
+
+            THEN("the missing channel is silent") {
+                REQUIRE(read == vector<float> { 1, 0, 2, 0 });
+            }
+        }
+    }
+
+    GIVEN("memory that does not hold a ring") {
+        std::vector<uint64_t> memory(64);
+        shared_memory_ring    consumer;
+
+        THEN("it is not opened") {
+            REQUIRE(!consumer.open(memory.data(), memory.size() * 8));
+        }
+    }
+}
+
+
+SCENARIO("numbers are streamed to another process") {
+    ext_main(nullptr);    // every unit test must call ext_main() once to configure the class
+
+    GIVEN("an instance of our object, streaming to shared memory") {
+        test_wrapper<shm_send> an_instance;
+        shm_send&              my_object = an_instance;
+
+        my_object.size = 1024;
+        my_object.name = symbol("/min.shm.send.test");
+
+        shared_memory      memory;
+        shared_memory_ring consumer;
+
+        REQUIRE(memory.open("/min.shm.send.test"));
+        REQUIRE(consumer.open(memory.data(), memory.size()));
+
+        vector<vector<double>> records;
+        const auto             reader = [&](const double time, const double* values, const uint32_t count) {
+            records.emplace_back(values, values + count);
+        };
+
+        WHEN("a number and a list are sent") {
+            my_object.number({ 1.5 });
+            my_object.list({ 1, 2, 3 });
+
+            THEN("the other process reads them as records") {
+                REQUIRE(consumer.read_records(reader) == 2);
+                REQUIRE(records == vector<vector<double>> { { 1.5 }, { 1, 2, 3 } });
+            }
+        }
+
+        WHEN("lists are sent until the memory is full") {
+            atoms list(100, 0.5);    // 816 bytes
+
+            my_object.list(list);
+            my_object.list(list);
+
+            THEN("the list that does not fit is dropped") {
+                REQUIRE(static_cast<int>(my_object.dropped) == 1);
+                REQUIRE(consumer.read_records(reader) == 1);
+            }
+
+            AND_WHEN("the other process catches up") {
+                consumer.read_records(reader);
+                my_object.list(list);    // wraps around the end of the data area, after padding
+
+                THEN("the next list is written") {
+                    REQUIRE(consumer.read_records(reader) == 1);
+                    REQUIRE(records.size() == 2);
+                    REQUIRE(records.back().size() == 100);
+                }
+            }
+        }
+    }
+}
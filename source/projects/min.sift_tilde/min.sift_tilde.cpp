@@ -36,12 +36,105 @@ public:
         }
     };
 
-    void operator()(sample x) {
-        if (x != value && x != m_last) {
-            m_fifo.try_enqueue(x);
-            deliverer.delay(0);
+    attribute<bool, threadsafe::yes> batch { this, "batch", false,
+        description {"Deliver all of the values sifted since the last delivery as a single list "
+                     "instead of sending each value as a separate float."
         }
-        m_last = x;
+    };
+
+    attribute<int> capacity { this, "capacity", 1024,
+        description {"Number of values that can wait for delivery. Values sifted while the queue is full are dropped and counted. "
+                     "A change takes effect when the audio is turned on again."},
+        setter { MIN_FUNCTION {
+            return { std::max(static_cast<int>(args[0]), 16) };
+        }}
+    };
+
+    attribute<int> dropped { this, "dropped", 0,
+        description {"Number of values dropped because the queue was full, since the audio was last turned on."},
+        readonly {true},
+        getter { MIN_GETTER_FUNCTION {
+            return { static_cast<int>(m_health.overflows()) };
+        }}
+    };
+
+    attribute<int> queue_depth { this, "queue_depth", 0,
+        description {"Largest number of values that waited for delivery at once, since the audio was last turned on. "
+                     "If it approaches the capacity then values are likely to be dropped."},
+        readonly {true},
+        getter { MIN_GETTER_FUNCTION {
+            return { static_cast<int>(m_health.summarize().maximum_depth) };
+        }}
+    };
+
+    attribute<number> latency_p50 { this, "latency_p50", 0.0,
+        description {"Median time in milliseconds that the values waited from the audio thread to their delivery, "
+                     "measured for the oldest value of each delivery, since the audio was last turned on."},
+        readonly {true},
+        getter { MIN_GETTER_FUNCTION {
+            return { m_health.summarize().latency_p50 };
+        }}
+    };
+
+    attribute<number> latency_p99 { this, "latency_p99", 0.0,
+        description {"Time in milliseconds that 99% of the deliveries waited for at most, "
+                     "measured for the oldest value of each delivery, since the audio was last turned on."},
+        readonly {true},
+        getter { MIN_GETTER_FUNCTION {
+            return { m_health.summarize().latency_p99 };
+        }}
+    };
+
+    message<> dspsetup { this, "dspsetup",
+        MIN_FUNCTION {
+            long vector_size = args[1];
+            m_survivors.resize(vector_size);
+            m_health.clear();
+
+            // the capacity of a ring buffer is rounded up to a power of two
+            const auto requested { static_cast<size_t>(static_cast<int>(capacity)) };
+            if (m_ring->capacity() < requested || m_ring->capacity() >= 2 * requested) {
+                auto ring { std::make_unique<ring_buffer<number>>(requested) };
+                lock lock {m_mutex};
+                std::swap(m_ring, ring);
+            }
+            return {};
+        }
+    };
+
+    // The values that survive the sift are gathered without branches, so the compares are vectorized,
+    // and are written to the queue all at once. The deliverer is scheduled once per vector at most.
+
+    void operator()(const sample_block<1>& input, sample_block<0>&) {
+        const auto in { input[0] };
+        const auto n { static_cast<size_t>(input.frame_count()) };
+        const auto v { static_cast<double>(value) };
+        auto       last { m_last };
+        size_t     count {};
+
+        if (m_survivors.size() < n)
+            return;    // not prepared yet by dspsetup
+
+        for (size_t i = 0; i < n; ++i) {
+            const auto x { in[i] };
+            m_survivors[count] = x;
+            count += (x != v) & (x != last);
+            last = x;
+        }
+        m_last = last;
+
+        if (count == 0)
+            return;
+
+        const auto written { m_ring->write(m_survivors.data(), count) };
+        if (written < count)
+            m_health.record_overflow(count - written);
+        m_health.record_depth(m_ring->available());
+
+        // stamp the oldest value that has not been delivered yet
+        int64_t unstamped {};
+        m_oldest.compare_exchange_strong(unstamped, queue_health::now(), std::memory_order_relaxed);
+        deliverer.delay(0);
     }
 
     timer<> deliverer { this,
@@ -62,13 +155,40 @@ public:
     };
 
 private:
-    sample       m_last { 0.0 };    ///< last value output
-    fifo<number> m_fifo { 100 };    ///< queue with space for 100 items
+    sample                                  m_last { 0.0 };    ///< last value output
+    vector<number>                          m_survivors;       ///< values of the current vector that survived the sift
+    std::unique_ptr<ring_buffer<number>>    m_ring { std::make_unique<ring_buffer<number>>(1024) };    ///< only replaced in dspsetup
+    queue_health                            m_health;          ///< depth, dropped values and latency of the ring buffer
+    std::atomic<int64_t>                    m_oldest { 0 };    ///< when the oldest value that has not been delivered was written, or zero
+    mutex                                   m_mutex;           ///< held while reading from the ring buffer and while replacing it
+    vector<number>                          m_drained;         ///< values read from the ring buffer for delivery
+
+    atoms        m_batch;           ///< values collected for delivery as a list
 
     void drain_the_fifo() {
-        number x;
-        while (m_fifo.try_dequeue(x))
-            output.send(x);
+        // values written meanwhile stamp anew, so the next delivery may measure a little long but never too short
+        if (const auto oldest = m_oldest.exchange(0, std::memory_order_relaxed))
+            m_health.record_latency(oldest, queue_health::now());
+
+        {
+            lock lock {m_mutex};
+            m_drained.resize(m_ring->available());
+            m_drained.resize(m_ring->read(m_drained.data(), m_drained.size()));
+        }
+
+        if (batch) {
+            if (m_drained.empty())
+                return;
+            m_batch.clear();
+            m_batch.reserve(m_drained.size());
+            for (auto x : m_drained)
+                m_batch.push_back(x);
+            output.send(m_batch);
+        }
+        else {
+            for (auto x : m_drained)
+                output.send(x);
+        }
     }
 };
 
@@ -14,14 +14,14 @@ public:
     MIN_TAGS		{ "benchmarking" };
     MIN_AUTHOR		{ "Timothy Place, Rob Sussman" };
 
-    attribute<number, threadsafe::yes, limit::clamp> target { this, "target", 0.0,
+    attribute<number, threadsafe::snapshot, limit::clamp> target { this, "target", 0.0,
         range {0.0, 100.0},
         description {"Percentage of the CPU to burn."}
     };
 
     void operator()(audio_bundle input, audio_bundle output) {
         auto   svtime_ms {vector_size() / samplerate() * 1000.0};
-        auto   spintime {svtime_ms * target / 100.0};
+        auto   spintime {svtime_ms * *target.snapshot() / 100.0};
         auto   intime {c74::max::systimer_gettime()};
         auto   outtime {intime + spintime};
         size_t spincount {};
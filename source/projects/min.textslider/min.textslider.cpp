@@ -230,11 +230,11 @@ public:
         }
     };
 
-    message<> paint { this, "paint",
+    // the background and the frame only change with the attributes, and the text with the value shown, so they are cached in layers
+
+    layer m_background { this, "background",
         MIN_FUNCTION {
-            target t        { args };
-            auto   value    { (m_value - m_range[0]) / (m_range[1] - m_range[0]) };
-            auto   pos      { ((t.width() - 3) * value) + 1 };    // one pixel for each border and -1 for counting to N-1
+            target t { args };
 
             rect<fill> {	// background
                 t,
@@ -245,6 +245,32 @@ public:
                 color {{0.3, 0.3, 0.3, 1.0}},
                 line_width {3.0}
             };
+            return {};
+        }
+    };
+
+    layer m_text_layer { this, "text",
+        MIN_FUNCTION {
+            target t { args };
+
+            text {			// text display
+                t, color {color::predefined::white},
+                position {m_offset[0], m_offset[1] + m_fontsize * 0.5},
+                fontface {m_fontname},
+                fontsize {m_fontsize},
+                content {m_text}
+            };
+            return {};
+        }
+    };
+
+    message<> paint { this, "paint",
+        MIN_FUNCTION {
+            target t        { args };
+            auto   value    { (m_value - m_range[0]) / (m_range[1] - m_range[0]) };
+            auto   pos      { ((t.width() - 3) * value) + 1 };    // one pixel for each border and -1 for counting to N-1
+
+            m_background.paint(t);
             rect<fill> {	// active part of the slider
                 t,
                 color {m_elementcolor},
@@ -257,13 +283,7 @@ public:
                 position {pos, 1.0},
                 size {4.0, -2.0}
             };
-            text {			// text display
-                t, color {color::predefined::white},
-                position {m_offset[0], m_offset[1] + m_fontsize * 0.5},
-                fontface {m_fontname},
-                fontsize {m_fontsize},
-                content {m_text}
-            };
+            m_text_layer.paint(t);
             return {};
         }
     };
@@ -286,6 +306,7 @@ private:
             symbol label = m_label;
             m_text       = label.c_str();
         }
+        m_text_layer.invalidate();
         redraw();
     }
 };
@@ -21,7 +21,7 @@ public:
     outlet<> outlet_audio	{ this, "(bang) message received on audio thread" };
     outlet<> outlet_other	{ this, "(bang) message received on unknown thread" };
 
-    c74::min::function check = MIN_FUNCTION {
+    c74::min::span_function check = MIN_SPAN_FUNCTION {
         // check scheduler last because it might be running in main or audio threads depending on settings
         if (c74::max::systhread_ismainthread())
             outlet_main.send(k_sym_bang);
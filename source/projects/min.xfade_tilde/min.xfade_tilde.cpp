@@ -9,14 +9,15 @@
 // The xfade~ object inherits all of it's attributes and messages from the signal_routing_base class.
 // The panner~ object does exactly the same, allowing us to share the code between the two similar but opposite classes.
 
-class xfade : public signal_routing_base<xfade>, public sample_operator<3, 1> {
+class xfade : public signal_routing_base<xfade>, public vector_operator<> {
 public:
 	MIN_DESCRIPTION {"Crossfade between two signals."};
 	MIN_TAGS {"audio, routing"};
 	MIN_AUTHOR {"Cycling '74"};
 	MIN_RELATED {"panner~, matrix~"};
+	MIN_INPLACE {true};
 
-	// above we inherited from sample_operator<3,1> which means 3 inputs and 1 output for our calculate method
+	// above we inherited from vector_operator<> so that our call operator processes whole vectors of audio
 	// we still need to create the interface for the object though, which includes the assistance strings...
 
 	inlet<>  in1 {this, "(signal) Input 1"};
@@ -25,15 +26,82 @@ public:
 	outlet<> output {this, "(signal) Output", "signal"};
 
 
+	/// Call operator: process one vector of audio
+	/// The wrapper calls the kernel chosen by select_kernel() directly, this is for calls from elsewhere (e.g. the unit test).
+
+	void operator()(audio_bundle input, audio_bundle output) {
+		(this->*select_kernel())(input, output);
+	}
+
+
+	/// Choose the kernel for the signal connections when the dsp chain is compiled,
+	/// so that the connection of the position is not tested in every vector.
+
+	auto select_kernel() {
+		return in_pos.has_signal_connection() ? &xfade::modulated : &xfade::constant;
+	}
+
+
+	/// Kernel for a position connected to a signal: the weights are calculated for a block of positions at a time.
+
+	void modulated(audio_bundle input, audio_bundle output) {
+		auto in1      = input.samples(0);
+		auto in2      = input.samples(1);
+		auto position = input.samples(2);
+		auto out      = output.samples(0);
+		auto n        = static_cast<size_t>(output.frame_count());
+
+		double weights1[block_size];
+		double weights2[block_size];
+
+		for (size_t start = 0; start < n; start += block_size) {
+			const auto count = std::min(block_size, n - start);
+
+			calculate_weights(position + start, weights1, weights2, count);
+			for (size_t i = 0; i < count; ++i)
+				out[start + i] = in1[start + i] * weights1[i] + in2[start + i] * weights2[i];
+		}
+	}
+
+
+	/// Kernel for a position set by the attribute: the weights are calculated for each sample only while the position ramps,
+	/// and the rest of the vector is mixed with constant weights.
+	/// A new position takes effect at the start of the next vector.
+
+	void constant(audio_bundle input, audio_bundle output) {
+		auto   in1 = input.samples(0);
+		auto   in2 = input.samples(1);
+		auto   out = output.samples(0);
+		auto   n   = static_cast<size_t>(output.frame_count());
+		size_t i   = 0;
+
+		while (i < n) {
+			const auto [weight1, weight2] = smoothed_weights();
+			out[i]                        = in1[i] * weight1 + in2[i] * weight2;
+			++i;
+			if (!position.is_ramping())
+				break;
+		}
+
+		const auto w1 = weight1;
+		const auto w2 = weight2;
+
+		for (; i < n; ++i)
+			out[i] = in1[i] * w1 + in2[i] * w2;
+	}
+
+
 	/// Call operator: process a single sample
-	/// Note that it takes three samples as input because we defined this class to inherit from sample_operator<3,1>
+	/// Note that it takes three samples as input, one for each inlet, just as the vectors above
 
 	sample operator()(sample in1, sample in2, sample position = 0.5) {
-		auto weight1 = this->weight1;
-		auto weight2 = this->weight2;
+		double weight1;
+		double weight2;
 
 		if (in_pos.has_signal_connection())
-			std::tie(weight1, weight2) = calculate_weights(mode, position);
+			std::tie(weight1, weight2) = calculate_weights(position);
+		else
+			std::tie(weight1, weight2) = smoothed_weights();
 		return in1 * weight1 + in2 * weight2;
 	}
 };
@@ -32,12 +32,11 @@ SCENARIO("object produces correct output") {
 
 				auto result = my_object(0.0, 1.0);
 
-				// the default mode is 'fast', which means a 512-point lookup table is used
-				// thus we have 9-bits of resolution and the quantization error for that is -56 dB
-				// which calculates out to approx 0.00195 -- so we use that as epsilon
-				// to determine the amount of acceptable deviation in our check below
+				// the default mode is 'fast', which means a 4096-interval lookup table is interpolated
+				// the error of the interpolation is below 2e-8 for the equal-power shape
+				// so we use 1e-6 as epsilon to determine the amount of acceptable deviation in our check below
 
-				REQUIRE(result == Approx(std::sqrt(2.0) / 2.0).epsilon(0.00195));
+				REQUIRE(result == Approx(std::sqrt(2.0) / 2.0).epsilon(1e-6));
 			}
 			AND_THEN("verify the output is equal-power by swapping the inputs") {
 
@@ -45,7 +44,7 @@ SCENARIO("object produces correct output") {
 
 				auto result = my_object(1.0, 0.0);
 
-				REQUIRE(result == Approx(std::sqrt(2.0) / 2.0).epsilon(0.00195));
+				REQUIRE(result == Approx(std::sqrt(2.0) / 2.0).epsilon(1e-6));
 			}
 		}
 
@@ -64,10 +63,10 @@ SCENARIO("object produces correct output") {
 				REQUIRE(result1 == Approx(std::sqrt(2.0) / 2.0));
 				REQUIRE(result2 == Approx(std::sqrt(2.0) / 2.0));
 			}
-			AND_THEN("due to quantization of the lookup table 'precision' won't be the same as 'fast'") {
+			AND_THEN("due to the interpolation of the lookup table 'fast' is as accurate as 'precision'") {
 
-				// this is a way we can check that the object is actually doing something different
-				// internally when we change the attribute value
+				// the lookup table used by 'fast' is interpolated,
+				// so it only differs from calculating the shape on-the-fly by the error of the interpolation
 
 				my_object.mode        = "precision";
 				auto result_precision = my_object(1.0, 0.0);
@@ -75,7 +74,7 @@ SCENARIO("object produces correct output") {
 				my_object.mode   = "fast";
 				auto result_fast = my_object(1.0, 0.0);
 
-				REQUIRE(result_precision != Approx(result_fast));
+				REQUIRE(result_fast == Approx(result_precision).epsilon(1e-6));
 			}
 		}
 
@@ -132,5 +131,182 @@ SCENARIO("object produces correct output") {
 			REQUIRE(y0 == Approx(0.33));
 			REQUIRE(y1 == Approx(0.67));
 		}
+
+		AND_WHEN("The position is changed with a ramp time") {
+			xfade x;
+
+			x.mode     = "precision";
+			x.shape    = "linear";
+			x.ramp     = 10.0;
+			x.position = 0.0;
+
+			auto y0 = x(0.0, 1.0);
+			REQUIRE(y0 == Approx(0.0));
+
+			x.position = 1.0;
+
+			auto y1 = x(0.0, 1.0);
+			REQUIRE(y1 > 0.0);
+			REQUIRE(y1 < 1.0);
+
+			auto y2 = x(0.0, 1.0);
+			REQUIRE(y2 > y1);
+
+			for (auto i = 0; i < 10000; ++i)
+				x(0.0, 1.0);
+
+			auto y3 = x(0.0, 1.0);
+			REQUIRE(y3 == Approx(1.0));
+		}
+
+		AND_WHEN("A vector is processed while the position ramps") {
+			xfade vectors;
+			xfade samples;
+
+			for (xfade* x : {&vectors, &samples}) {
+				x->mode     = "precision";
+				x->shape    = "linear";
+				x->ramp     = 1.0;    // 44 samples, so the vector ramps first and then mixes with constant weights
+				x->position = 0.0;
+				(*x)(0.0, 1.0);
+				x->position = 1.0;
+			}
+
+			std::vector<double> zeros(256, 0.0);
+			std::vector<double> ones(256, 1.0);
+			std::vector<double> out(256, 0.0);
+			double*             ins[3] {zeros.data(), ones.data(), zeros.data()};
+			double*             outs[1] {out.data()};
+			audio_bundle        input {ins, 3, 256};
+			audio_bundle        output {outs, 1, 256};
+
+			vectors(input, output);
+
+			THEN("the output is the same as when processing one sample at a time") {
+				for (auto i = 0; i < 256; ++i)
+					REQUIRE(out[i] == Approx(samples(0.0, 1.0)));
+				REQUIRE(out[255] == Approx(1.0));
+			}
+		}
+
+		AND_WHEN("Several attributes are set in a batch") {
+			test_wrapper<xfade> another_instance;
+			xfade&              x = another_instance;
+
+			{
+				attribute_batch batch { x };
+
+				x.position = 0.25;    // the weights are calculated when the batch ends, with the shape and mode set below
+				x.shape    = "linear";
+				x.mode     = "precision";
+			}
+
+			auto y0 = x(0.0, 1.0);
+			auto y1 = x(1.0, 0.0);
+
+			REQUIRE(y0 == Approx(0.25));
+			REQUIRE(y1 == Approx(0.75));
+		}
+	}
+}
+
+
+SCENARIO("the position is morphed between presets") {
+	ext_main(nullptr);
+
+	GIVEN("An instance of xfade~ and a morph of its position") {
+		test_wrapper<xfade> an_instance;
+		xfade&              x = an_instance;
+
+		x.mode  = "precision";
+		x.shape = "linear";
+
+		preset_morph morph { &x, {"position"} };
+
+		x.position = 0.0;
+		const auto from = morph.capture();
+		x.position = 1.0;
+		const auto to = morph.capture();
+
+		morph.morph(from, to);
+
+		WHEN("the morph is applied at control rate") {
+			morph.setter_interval(60000.0);
+			morph.apply(0.25);    // the first call of apply() calls the setters
+			morph.apply(0.5);
+
+			THEN("the value is assigned at once but the setter only runs when flushed") {
+				REQUIRE(x.position == Approx(0.5));
+				REQUIRE(x(0.0, 1.0) == Approx(0.25));
+
+				morph.flush();
+				REQUIRE(x(0.0, 1.0) == Approx(0.5));
+			}
+		}
+
+		AND_WHEN("the morph is read at audio rate") {
+			THEN("the values are interpolated without being assigned") {
+				REQUIRE(morph.size() == 1);
+				REQUIRE(morph.value(morph.index("position"), 0.75) == Approx(0.75));
+				REQUIRE(x.position == Approx(1.0));
+			}
+		}
+	}
+}
+
+
+SCENARIO("audio is rendered offline with the DSP of the object") {
+	ext_main(nullptr);
+
+	GIVEN("two channels of audio: silence and ones") {
+		buffer_staging source;
+
+		source.channel_count = 2;
+		source.samplerate    = 44100.0;
+		source.samples.assign(2 * 1000, 0.0f);
+		for (auto i = 1u; i < source.samples.size(); i += 2)
+			source.samples[i] = 1.0f;
+
+		WHEN("they are rendered by one instance, with a tail") {
+			offline_render<xfade> renderer;
+			buffer_staging        target;
+
+			REQUIRE(renderer.render(source, target, {64, 0.0, 100}));
+
+			THEN("the channels are the inputs of the object, crossfaded at the default position") {
+				REQUIRE(target.channel_count == 1);
+				REQUIRE(target.frame_count() == 1100);
+				REQUIRE(target.samples[0] == Approx(std::sqrt(2.0) / 2.0).epsilon(1e-6));
+				REQUIRE(target.samples[999] == Approx(std::sqrt(2.0) / 2.0).epsilon(1e-6));
+				REQUIRE(target.samples[1099] == 0.0f);    // the tail is processed with silent inputs
+			}
+		}
+
+		AND_WHEN("each channel is rendered by an instance of its own, in parallel") {
+			offline_render<xfade> renderer {{}, 2};
+			worker_pool           pool {1};
+			buffer_staging        target;
+
+			REQUIRE(renderer.render(source, target, {64, 0.0, 0, &pool}));
+
+			THEN("each channel is crossfaded with silence") {
+				REQUIRE(target.channel_count == 2);
+				REQUIRE(target.frame_count() == 1000);
+				REQUIRE(target.samples[0] == 0.0f);
+				REQUIRE(target.samples[1] == Approx(std::sqrt(2.0) / 2.0).epsilon(1e-6));
+				REQUIRE(target.samples[1999] == Approx(std::sqrt(2.0) / 2.0).epsilon(1e-6));
+			}
+		}
+
+		AND_WHEN("there are more independent channels than instances") {
+			offline_render<xfade> renderer {{}, 2};
+			buffer_staging        target;
+
+			source.channel_count = 4;
+
+			THEN("nothing is rendered") {
+				REQUIRE(!renderer.render(source, target));
+			}
+		}
 	}
 }
@@ -0,0 +1,372 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+// Convolution of a stream of samples with a kernel of any length, without latency.
+//
+// Short kernels are convolved directly. For longer kernels only the first partition of the kernel
+// is convolved directly, and the rest is convolved with uniformly-partitioned FFT overlap-add:
+// each block of input is transformed once and multiplied with the spectra of all partitions,
+// so the cost per sample grows with the logarithm of the partition size rather than with the kernel length.
+// The direct part covers the delay of one block that the FFT part needs, so no latency is introduced.
+//
+// The FFTs are from the Butterfly library, which requires C++20, so a project including this header needs to add
+//
+//		include_directories("${CMAKE_CURRENT_SOURCE_DIR}/../libs/Butterfly_Audio_Library/src/math/src")
+//
+// to its CMakeLists.txt and, after including min-posttarget.cmake,
+//
+//		set_property(TARGET ${PROJECT_NAME} PROPERTY CXX_STANDARD 20)
+
+#pragma once
+
+#include <algorithm>
+#include <complex>
+#include <concepts>
+#include <memory>
+#include <vector>
+#include "fft.h"
+
+
+/// The spectra of the partitions of a kernel, for uniform_partitioned_convolution.
+/// It does not change once it has been constructed, so it can be shared by convolutions on any number of threads.
+/// @tparam	T				The type of the samples.
+/// @tparam	partition_size	The size of the partitions of the kernel, which needs to be a power of two.
+
+template<std::floating_point T, int partition_size>
+class uniform_partitioned_kernel {
+public:
+	static constexpr int k_fft_size { 2 * partition_size };
+	static constexpr int k_spectrum_size { k_fft_size / 2 + 1 };
+
+	using complex = std::complex<T>;
+	using fft_type = Butterfly::FFTCalculator<T, k_fft_size>;
+
+
+	/// Transform the partitions of a kernel, which allocates memory.
+	/// @param	kernel	The kernel.
+	/// @param	size	The length of the kernel, which may be zero.
+
+	uniform_partitioned_kernel(const T* kernel, const size_t size) {
+		const auto partitions { (size + partition_size - 1) / partition_size };
+
+		// The spectra are scaled so that the normalization of the forward and inverse transforms cancels out
+		const auto scale { std::sqrt(T(k_fft_size)) };
+		std::vector<T> padded(k_fft_size);
+
+		m_spectra.assign(partitions * k_spectrum_size, complex {});
+		for (size_t p = 0; p < partitions; ++p) {
+			const auto first { kernel + p * partition_size };
+			const auto last { first + std::min<size_t>(partition_size, kernel + size - first) };
+
+			std::fill(padded.begin(), padded.end(), T(0));
+			std::copy(first, last, padded.begin());
+
+			const auto spectrum { m_spectra.begin() + p * k_spectrum_size };
+			m_fft.rfft(padded.begin(), spectrum);
+			std::for_each(spectrum, spectrum + k_spectrum_size, [scale](complex& value) { value *= scale; });
+		}
+	}
+
+
+	size_t partitions() const {
+		return m_spectra.size() / k_spectrum_size;
+	}
+
+
+	/// The k_spectrum_size frequencies of a partition.
+
+	const complex* spectrum(const size_t partition) const {
+		return m_spectra.data() + partition * k_spectrum_size;
+	}
+
+
+	/// The transform used for the spectra, which also needs to be used for the input.
+
+	const fft_type& fft() const {
+		return m_fft;
+	}
+
+private:
+	fft_type				m_fft;
+	std::vector<complex>	m_spectra;
+};
+
+
+/// Uniformly-partitioned FFT convolution of consecutive blocks of input with a kernel.
+/// The output of a block is only complete once the whole block is known, so in real time the output
+/// is one block late. The caller needs to make up for this, e.g. by delaying the kernel by one block.
+/// @tparam	T				The type of the samples.
+/// @tparam	partition_size	The size of the blocks and of the partitions of the kernel, which needs to be a power of two.
+
+template<std::floating_point T, int partition_size>
+class uniform_partitioned_convolution {
+public:
+	using kernel_type = uniform_partitioned_kernel<T, partition_size>;
+	using complex = typename kernel_type::complex;
+
+	static constexpr int k_fft_size { kernel_type::k_fft_size };
+	static constexpr int k_spectrum_size { kernel_type::k_spectrum_size };
+
+
+	/// Change the kernel and clear the history of the input.
+	/// This allocates memory, so it must not be called from the audio thread.
+	/// @param	kernel	The kernel.
+	/// @param	size	The length of the kernel, which may be zero.
+
+	void set_kernel(const T* kernel, const size_t size) {
+		set_kernel(std::make_shared<const kernel_type>(kernel, size));
+	}
+
+
+	/// Change to a kernel that has already been transformed, and clear the history of the input.
+	/// This allocates memory, so it must not be called from the audio thread.
+	/// @param	kernel	The transformed kernel.
+
+	void set_kernel(std::shared_ptr<const kernel_type> kernel) {
+		m_kernel = std::move(kernel);
+		m_input_spectra.assign(m_kernel->partitions() * k_spectrum_size, complex {});
+		m_block.assign(k_fft_size, T(0));
+		m_result.assign(k_fft_size, T(0));
+		m_overlap.assign(partition_size, T(0));
+		m_sum.assign(k_spectrum_size, complex {});
+		reset();
+	}
+
+
+	/// Clear the history of the input, as if only zeros had been processed so far.
+
+	void reset() {
+		std::fill(m_input_spectra.begin(), m_input_spectra.end(), complex {});
+		std::fill(m_overlap.begin(), m_overlap.end(), T(0));
+		m_newest_spectrum = 0;
+	}
+
+
+	/// Is the kernel empty, so that the output is always zero?
+
+	bool empty() const {
+		return !m_kernel || m_kernel->partitions() == 0;
+	}
+
+
+	/// Convolve the next block of input.
+	/// Each block is transformed once and multiplied with the spectra of all partitions, and the products are
+	/// accumulated in the frequency domain so that a single inverse transform gives the output of the block.
+	/// @param	input	The partition_size samples of the block.
+	/// @param	output	Storage for the partition_size samples of output during the block, which may be the same as the input.
+
+	void operator()(const T* input, T* output) {
+		if (empty()) {
+			std::fill_n(output, partition_size, T(0));
+			return;
+		}
+
+		const auto  partitions { m_kernel->partitions() };
+		const auto& fft { m_kernel->fft() };
+
+		// the second half of the block stays zero, so that the circular convolution of the FFT is a linear one
+		std::copy_n(input, partition_size, m_block.begin());
+		m_newest_spectrum = m_newest_spectrum == 0 ? partitions - 1 : m_newest_spectrum - 1;
+		fft.rfft(m_block.begin(), m_input_spectra.begin() + m_newest_spectrum * k_spectrum_size);
+
+		std::fill(m_sum.begin(), m_sum.end(), complex {});
+		for (size_t p = 0; p < partitions; ++p) {
+			const auto block { m_input_spectra.data() + ((m_newest_spectrum + p) % partitions) * k_spectrum_size };
+			const auto kernel { m_kernel->spectrum(p) };
+
+			for (int k = 0; k < k_spectrum_size; ++k)
+				m_sum[k] += Butterfly::detail::multiply(block[k], kernel[k]);
+		}
+
+		fft.irfft(m_sum.begin(), m_result.begin());
+		for (int i = 0; i < partition_size; ++i) {
+			output[i] = m_result[i] + m_overlap[i];
+			m_overlap[i] = m_result[i + partition_size];
+		}
+	}
+
+private:
+	std::shared_ptr<const kernel_type>	m_kernel;
+
+	std::vector<complex>	m_input_spectra;		// the spectra of as many recent blocks of input, as a ring
+	size_t					m_newest_spectrum { 0 };
+	std::vector<T>			m_block;				// the current block of input, followed by zeros
+	std::vector<T>			m_result;				// the inverse transform of the current block
+	std::vector<T>			m_overlap;				// the second half of the previous transform
+	std::vector<complex>	m_sum;
+};
+
+
+/// A kernel prepared for convolution_engine: the first partition reversed for direct convolution and the others transformed.
+/// It does not change once it has been constructed, so it can be published to convolutions on other threads
+/// without copying it, e.g. through a std::shared_ptr.
+/// @tparam	T	The type of the samples.
+
+template<std::floating_point T>
+class convolution_kernel {
+public:
+	static constexpr int k_partition_size { 128 };						///< Kernels longer than this use the FFT.
+
+	using tail_type = uniform_partitioned_kernel<T, k_partition_size>;
+
+
+	/// Prepare a kernel, which allocates memory.
+	/// @param	kernel	The kernel, which may be empty.
+
+	explicit convolution_kernel(const std::vector<T>& kernel)
+	: m_head(kernel.rend() - std::min<size_t>(kernel.size(), k_partition_size), kernel.rend())	// reversed, so that it can be applied to the history in order
+	, m_tail { std::make_shared<const tail_type>(kernel.data() + m_head.size(), kernel.size() - m_head.size()) }
+	{}
+
+
+	/// The first partition of the kernel, reversed.
+
+	const std::vector<T>& head() const {
+		return m_head;
+	}
+
+
+	/// The spectra of the other partitions of the kernel.
+
+	const std::shared_ptr<const tail_type>& tail() const {
+		return m_tail;
+	}
+
+private:
+	std::vector<T>						m_head;
+	std::shared_ptr<const tail_type>	m_tail;
+};
+
+
+/// Convolution of a stream of samples with a kernel of any length, without latency.
+/// @tparam	T	The type of the samples.
+
+template<std::floating_point T>
+class convolution_engine {
+public:
+	using kernel_type = convolution_kernel<T>;
+
+	static constexpr int k_partition_size { kernel_type::k_partition_size };	///< Kernels longer than this use the FFT.
+
+
+	convolution_engine() {
+		set_kernel(std::vector<T> {});
+	}
+
+	explicit convolution_engine(const std::vector<T>& kernel) {
+		set_kernel(kernel);
+	}
+
+	explicit convolution_engine(std::shared_ptr<const kernel_type> kernel) {
+		set_kernel(std::move(kernel));
+	}
+
+
+	/// Change the kernel and clear the history of the input.
+	/// This allocates memory, so it must not be called from the audio thread.
+	/// @param	kernel	The kernel, which may be empty.
+
+	void set_kernel(const std::vector<T>& kernel) {
+		set_kernel(std::make_shared<const kernel_type>(kernel));
+	}
+
+
+	/// Change to a prepared kernel, which may be shared with other engines, and clear the history of the input.
+	/// This allocates memory, so it must not be called from the audio thread.
+	/// @param	kernel	The prepared kernel.
+
+	void set_kernel(std::shared_ptr<const kernel_type> kernel) {
+		m_kernel = std::move(kernel);
+		m_history.assign(std::max<size_t>(m_kernel->head().size(), 1) * 2, T(0));
+
+		m_tail.set_kernel(m_kernel->tail());
+		m_block.assign(k_partition_size, T(0));
+		m_output.assign(k_partition_size, T(0));
+		reset();
+	}
+
+
+	/// The prepared kernel that is being used.
+
+	const std::shared_ptr<const kernel_type>& kernel() const {
+		return m_kernel;
+	}
+
+
+	/// Clear the history of the input, as if only zeros had been processed so far.
+
+	void reset() {
+		std::fill(m_history.begin(), m_history.end(), T(0));
+		std::fill(m_block.begin(), m_block.end(), T(0));
+		std::fill(m_output.begin(), m_output.end(), T(0));
+		m_tail.reset();
+		m_history_position = 0;
+		m_block_position = 0;
+	}
+
+
+	/// Is part of the kernel convolved using the FFT?
+
+	bool partitioned() const {
+		return !m_tail.empty();
+	}
+
+
+	/// Convolve the next sample.
+	/// @param	x	The input.
+	/// @return		The output.
+
+	T operator()(const T x) {
+		const auto& head { m_kernel->head() };
+		const auto  head_size { head.size() };
+		T           y { m_output[m_block_position] };
+
+		// The history is stored twice so that the most recent head_size samples are always contiguous
+		if (head_size) {
+			m_history[m_history_position] = m_history[m_history_position + head_size] = x;
+			++m_history_position;
+
+			const auto window { m_history.data() + m_history_position };
+			for (size_t k = 0; k < head_size; ++k)
+				y += head[k] * window[k];
+
+			if (m_history_position == head_size)
+				m_history_position = 0;
+		}
+
+		// The tail starts one partition into the kernel, so the output of a block of input
+		// is needed during the next block, by when it has been calculated.
+		if (partitioned()) {
+			m_block[m_block_position] = x;
+			if (++m_block_position == k_partition_size) {
+				m_tail(m_block.data(), m_output.data());
+				m_block_position = 0;
+			}
+		}
+		return y;
+	}
+
+
+	/// Convolve a run of samples.
+	/// @param	input	The input samples.
+	/// @param	output	Storage for the output samples, which may be the same as the input.
+	/// @param	count	The number of samples.
+
+	void operator()(const T* input, T* output, const size_t count) {
+		for (size_t i = 0; i < count; ++i)
+			output[i] = (*this)(input[i]);
+	}
+
+private:
+	std::shared_ptr<const kernel_type>	m_kernel;
+
+	std::vector<T>			m_history;				// the most recent input, for the first partition
+	size_t					m_history_position { 0 };
+
+	uniform_partitioned_convolution<T, k_partition_size>	m_tail;	// the other partitions of the kernel
+	std::vector<T>			m_block;				// the current block of input
+	int						m_block_position { 0 };
+	std::vector<T>			m_output;				// the output of the tail during the current block
+};
@@ -0,0 +1,277 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+// A feedback delay network (FDN) reverb: a number of delay lines whose outputs are mixed by a unitary matrix
+// and fed back into their inputs. Every line feeds every other line, so the echo density grows much faster
+// than with a chain of allpass filters of the same cost.
+//
+// The lines share one history, laid out line after line. The feedback of a sample only reaches the output
+// after the shortest delay, so all lines are processed a chunk of up to that many samples at a time:
+// the outputs of the chunk are read at once, filtered, mixed by the feedback matrix with Butterfly::multiply_channels,
+// and written back at once. The loops run over the samples of a chunk rather than one sample of all lines,
+// so they vectorize.
+//
+// The matrix is from the Butterfly library, which requires C++20, so a project including this header needs to add
+//
+//		include_directories("${CMAKE_CURRENT_SOURCE_DIR}/../libs/Butterfly_Audio_Library/src/math/src")
+//
+// to its CMakeLists.txt and, after including min-posttarget.cmake,
+//
+//		set_property(TARGET ${PROJECT_NAME} PROPERTY CXX_STANDARD 20)
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <vector>
+#include "matrix.h"
+
+
+/// A stereo feedback delay network with a mono input.
+/// @tparam	T			The type of the samples.
+/// @tparam	line_count	The number of delay lines, which needs to be a power of two for the Hadamard matrix.
+
+template<std::floating_point T, int line_count = 8>
+class feedback_delay_network {
+	static_assert(line_count >= 2 && std::has_single_bit(static_cast<unsigned>(line_count)), "the number of lines needs to be a power of two");
+
+public:
+	using matrix_type = Butterfly::Matrix<T, line_count, line_count>;
+
+	static constexpr int k_chunk_size { 64 };	///< The largest number of samples processed at once.
+
+
+	/// The feedback matrices. Both are unitary, so the network neither gains nor loses energy apart from the decay.
+
+	enum class mixing {
+		householder,	///< I - 2/N: every line feeds all others equally, and itself with the opposite sign. Costs the least to mix.
+		hadamard		///< Sylvester's Hadamard matrix scaled by 1/sqrt(N): the lines are mixed with all combinations of signs.
+	};
+
+
+	/// Create a network, which allocates memory.
+	/// @param	max_length	The longest delay of any line in samples.
+
+	explicit feedback_delay_network(const size_t max_length)
+	: m_max_length { std::max<size_t>(max_length, 2) }
+	, m_line_size { std::bit_ceil(m_max_length + k_chunk_size) }
+	, m_history(line_count * m_line_size) {
+		matrix(mixing::householder);
+		lengths(T(m_max_length) / 2, T(m_max_length));
+	}
+
+	// the chunks are referenced by pointers to them
+	feedback_delay_network(const feedback_delay_network&) = delete;
+	feedback_delay_network& operator=(const feedback_delay_network&) = delete;
+
+
+	/// Change the feedback matrix.
+	/// @param	kind	The new matrix.
+
+	void matrix(const mixing kind) {
+		if (kind == mixing::householder)
+			m_matrix = matrix_type::identity() - matrix_type(T(2) / line_count);
+		else {
+			const auto scale { T(1) / std::sqrt(T(line_count)) };
+			for (int i = 0; i < line_count; ++i) {
+				for (int j = 0; j < line_count; ++j)
+					m_matrix(i, j) = std::popcount(static_cast<unsigned>(i & j)) % 2 ? -scale : scale;
+			}
+		}
+	}
+
+
+	/// Return the feedback matrix.
+
+	const matrix_type& matrix() const {
+		return m_matrix;
+	}
+
+
+	/// Spread the delays of the lines exponentially between two lengths.
+	/// Each delay is moved to the next prime number, so that the echoes of the lines rarely coincide.
+	/// @param	shortest	The delay of the first line in samples.
+	/// @param	longest		The delay of the last line in samples. Both are limited to the length given at creation.
+
+	void lengths(T shortest, T longest) {
+		longest  = std::clamp(longest, T(2), T(m_max_length));
+		shortest = std::clamp(shortest, T(2), longest);
+
+		size_t previous {};
+		for (int i = 0; i < line_count; ++i) {
+			const auto length { shortest * std::pow(longest / shortest, T(i) / (line_count - 1)) };
+			m_lengths[i] = next_prime(std::max(static_cast<size_t>(length), previous + 1));
+			previous     = m_lengths[i];
+		}
+
+		// the primes may step beyond the longest delay, so the lines are pushed back below it from the top
+		auto limit { m_max_length };
+		for (int i = line_count - 1; i >= 0 && m_lengths[i] > limit; --i) {
+			m_lengths[i] = limit;
+			--limit;
+		}
+		update_gains();
+	}
+
+
+	/// Return the delay of a line in samples.
+	/// @param	line	The index of the line.
+
+	size_t length(const int line) const {
+		return m_lengths[line];
+	}
+
+
+	/// Set the reverberation time.
+	/// @param	samples		The time in samples that the reverb takes to decay by 60 dB.
+
+	void decay(const T samples) {
+		m_decay = std::max(samples, T(1));
+		update_gains();
+	}
+
+
+	/// Set the damping of high frequencies in the feedback.
+	/// @param	coefficient		The coefficient of the lowpass filter of each line, 0 for no damping up to just below 1.
+
+	void damping(const T coefficient) {
+		m_damping = std::clamp(coefficient, T(0), T(0.999));
+	}
+
+
+	/// Set the balance between the input and the reverb in the output.
+	/// @param	wet		0 for only the input up to 1 for only the reverb.
+
+	void mix(const T wet) {
+		m_wet = std::clamp(wet, T(0), T(1));
+	}
+
+
+	/// Clear the history, as if only silence had been received so far.
+
+	void reset() {
+		std::fill(m_history.begin(), m_history.end(), T(0));
+		m_lowpass.fill(T(0));
+		m_position = 0;
+	}
+
+
+	/// Process a block of samples.
+	/// @param	input		frame_count samples.
+	/// @param	left		frame_count samples of output from the lines with even indices. May be the same as the input.
+	/// @param	right		frame_count samples of output from the lines with odd indices. May be the same as the input.
+	/// @param	frame_count	The number of samples.
+
+	void operator()(const T* input, T* left, T* right, const size_t frame_count) {
+		const auto chunk_size { std::min<size_t>(k_chunk_size, m_lengths[0]) };
+
+		for (size_t offset = 0; offset < frame_count; offset += chunk_size)
+			process_chunk(input + offset, left + offset, right + offset, std::min(chunk_size, frame_count - offset));
+	}
+
+private:
+	// A chunk must not be longer than the shortest line, so that all of its outputs have been written before.
+
+	void process_chunk(const T* input, T* left, T* right, const size_t count) {
+		const auto mask { m_line_size - 1 };
+
+		for (int i = 0; i < line_count; ++i) {
+			const auto line { m_history.data() + i * m_line_size };
+			const auto read { m_position - m_lengths[i] };
+			for (size_t f = 0; f < count; ++f)
+				m_taps[i][f] = line[(read + f) & mask];
+		}
+
+		// the input is read before the output is written, as they may be the same
+		std::copy_n(input, count, m_input.data());
+
+		const auto dry { T(1) - m_wet };
+		for (size_t f = 0; f < count; ++f) {
+			T l {}, r {};
+			for (int i = 0; i < line_count; i += 2) {
+				l += m_taps[i][f];
+				r += m_taps[i + 1][f];
+			}
+			left[f]  = dry * m_input[f] + m_wet * l;
+			right[f] = dry * m_input[f] + m_wet * r;
+		}
+
+		for (int i = 0; i < line_count; ++i) {
+			auto       y { m_lowpass[i] };
+			const auto g { m_gains[i] };
+			for (size_t f = 0; f < count; ++f) {
+				y            = m_taps[i][f] + m_damping * (y - m_taps[i][f]);
+				m_taps[i][f] = y * g;
+			}
+			m_lowpass[i] = y;
+		}
+
+		Butterfly::multiply_channels(m_matrix, m_tap_pointers.data(), m_feedback_pointers.data(), count);
+
+		for (int i = 0; i < line_count; ++i) {
+			const auto line { m_history.data() + i * m_line_size };
+			for (size_t f = 0; f < count; ++f)
+				line[(m_position + f) & mask] = m_feedback[i][f] + k_input_gain * m_input[f];
+		}
+		m_position = (m_position + count) & mask;
+	}
+
+	// the gain of each line decays by 60 dB in the reverberation time, so all lines decay alike whatever their length
+
+	void update_gains() {
+		for (int i = 0; i < line_count; ++i)
+			m_gains[i] = std::pow(T(10), T(-3) * m_lengths[i] / m_decay);
+	}
+
+	static size_t next_prime(size_t n) {
+		const auto is_prime = [](const size_t n) {
+			if (n < 2)
+				return false;
+			for (size_t d = 2; d * d <= n; ++d) {
+				if (n % d == 0)
+					return false;
+			}
+			return true;
+		};
+		while (!is_prime(n))
+			++n;
+		return n;
+	}
+
+	template<class U>
+	using per_line = std::array<U, line_count>;
+	using chunk = std::array<T, k_chunk_size>;
+
+	static constexpr T k_input_gain { T(1) / line_count };
+
+	size_t				m_max_length;
+	size_t				m_line_size;		///< power of two, so that the positions wrap with a mask
+	std::vector<T>		m_history;			///< m_line_size samples for each line
+	size_t				m_position {};		///< where the next sample of each line is written
+
+	matrix_type			m_matrix;
+	per_line<size_t>	m_lengths {};
+	per_line<T>			m_gains {};
+	per_line<T>			m_lowpass {};
+	T					m_decay { 44100 };
+	T					m_damping {};
+	T					m_wet { 1 };
+
+	chunk				m_input {};
+	per_line<chunk>		m_taps {};
+	per_line<chunk>		m_feedback {};
+	per_line<T*>		m_tap_pointers { pointers(m_taps) };
+	per_line<T*>		m_feedback_pointers { pointers(m_feedback) };
+
+	static per_line<T*> pointers(per_line<chunk>& chunks) {
+		per_line<T*> result;
+		for (int i = 0; i < line_count; ++i)
+			result[i] = chunks[i].data();
+		return result;
+	}
+};
@@ -0,0 +1,80 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+// Views of the planes of a Jitter matrix as Butterfly matrices, without copying the matrix.
+// The algorithms of the Butterfly matrix library can then be run directly on the matrices
+// passed to a matrix_operator, from its calc_row() or calc_cell() methods.
+//
+// The Butterfly library requires C++20, so a project including this header needs to add
+//
+//		include_directories("${CMAKE_CURRENT_SOURCE_DIR}/../libs/Butterfly_Audio_Library/src/math/src")
+//
+// to its CMakeLists.txt and, after including min-posttarget.cmake,
+//
+//		set_property(TARGET ${PROJECT_NAME} PROPERTY CXX_STANDARD 20)
+
+#pragma once
+
+#include "c74_min_api.h"
+#include "matrix.h"
+
+using namespace c74::min;
+
+
+// A plane of a Jitter matrix is a Matrix_view with one row per row of the Jitter matrix and one column per cell.
+// The planes of a cell are interleaved, so the elements of a row are a cell apart.
+// Only the first two dimensions of a matrix are viewed.
+// NOTE: No bounds checking is performed on the plane!
+
+template<class T>
+Butterfly::Matrix_view<T> matrix_plane_view(T* data, const c74::max::t_jit_matrix_info* info, const long plane) {
+	const auto rows      { static_cast<size_t>(info->dimcount > 1 ? info->dim[1] : 1) };
+	const auto cols      { static_cast<size_t>(info->dim[0]) };
+	const auto stride    { static_cast<size_t>(info->dimstride[0] / static_cast<long>(sizeof(T))) };
+	const auto row_pitch { info->dimcount > 1 ? static_cast<size_t>(info->dimstride[1] / static_cast<long>(sizeof(T))) : cols * stride };
+
+	return { data + plane, rows, row_pitch, rows, cols, stride };
+}
+
+
+/// View a plane of the input matrix described by the matrix_info passed to calc_row() or calc_cell().
+/// @tparam	T		The type of the elements of the matrix.
+/// @param	info	The matrix_info.
+/// @param	plane	The index of the plane.
+/// @return			A view of the whole plane, with the height of the matrix as the number of rows.
+
+template<class T>
+Butterfly::Matrix_view<const T> input_plane_view(const matrix_info& info, const long plane) {
+	return matrix_plane_view(reinterpret_cast<const T*>(info.m_bip), info.m_in_info, plane);
+}
+
+
+/// View a plane of the output matrix described by the matrix_info passed to calc_row() or calc_cell().
+/// @tparam	T		The type of the elements of the matrix.
+/// @param	info	The matrix_info.
+/// @param	plane	The index of the plane.
+/// @return			A view of the whole plane, with the height of the matrix as the number of rows.
+
+template<class T>
+Butterfly::Matrix_view<T> output_plane_view(const matrix_info& info, const long plane) {
+	return matrix_plane_view(reinterpret_cast<T*>(info.m_bop), info.m_out_info, plane);
+}
+
+
+/// View a plane of a row passed to calc_row() as a Matrix_view with a single row.
+/// The row must be valid(), so the input row of a generator cannot be viewed.
+/// @param	row		The row.
+/// @param	plane	The index of the plane.
+/// @return			A view with one column per cell of the row.
+
+template<class T>
+Butterfly::Matrix_view<T> row_plane_view(const matrix_span<T>& row, const long plane) {
+	const auto cols   { static_cast<size_t>(row.size()) };
+	const auto stride { static_cast<size_t>(row.cell_stride()) };
+
+	// a row extended from a matrix with a width of 1 has a cell stride of zero,
+	// and still needs a non-zero pitch to tell the end of the view from its beginning
+	return { row.data() + plane * row.plane_stride(), 1, std::max<size_t>(cols * stride, 1), 1, cols, stride };
+}
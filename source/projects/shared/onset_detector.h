@@ -0,0 +1,238 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+// Onset detection and tempo estimation from one short-time Fourier analysis.
+//
+// Each frame of the analysis is reduced to its spectral flux: the sum of the increases of the log magnitudes of all bins
+// since the previous frame, which jumps when a note or a hit starts. An onset is reported when the flux rises above
+// a multiple of its recent mean. The flux, less its mean, also feeds a leaky autocorrelation over the lags of the
+// tempo range, whose strongest lag (weighted towards 120 BPM, to prefer the beat over its multiples) is the tempo.
+// Onsets that are evenly spaced are as periodic at twice their period as at their period, so a tempo far from 120 BPM
+// may be reported an octave off: narrow the tempo range to the one expected to avoid it.
+//
+// The cost of a frame is one real FFT, a pass over the bins, and a pass over the lags, so the cost of a vector is bounded
+// by its number of frames. An onset is detected at the end of the frame in which it rises, i.e. up to a hop (512 samples) late.
+// All memory is allocated when the samplerate or the tempo range is set.
+
+#pragma once
+
+#include "c74_min_api.h"
+
+
+/// Detects the onsets in a signal and estimates its tempo, a vector at a time.
+
+class onset_detector {
+public:
+	static constexpr size_t k_fft_size { 1024 };
+	static constexpr size_t k_overlap { 2 };
+
+	using analyzer = c74::min::spectral_analyzer<k_fft_size, k_overlap>;
+
+	static constexpr size_t k_hop_size { analyzer::hop_size };
+
+
+	explicit onset_detector(const double samplerate = 44100.0)
+	: m_magnitudes(analyzer::bin_count, 0.0) {
+		this->samplerate(samplerate);
+	}
+
+
+	/// Set the samplerate, which allocates memory and restarts the analysis.
+	/// @param	samplerate	The samplerate in Hz.
+
+	void samplerate(const double samplerate) {
+		m_frames_per_second = samplerate / k_hop_size;
+		minimum_interval(m_min_interval_ms);
+		tempo_range(m_min_tempo, m_max_tempo);
+	}
+
+
+	/// Set the range of tempi that are considered, which allocates memory and restarts the tempo estimation.
+	/// @param	min_tempo	The lowest tempo in BPM.
+	/// @param	max_tempo	The highest tempo in BPM.
+
+	void tempo_range(const double min_tempo, const double max_tempo) {
+		m_min_tempo = std::max(min_tempo, 10.0);
+		m_max_tempo = std::max(max_tempo, m_min_tempo + 1.0);
+		m_min_lag   = std::max(static_cast<size_t>(60.0 * m_frames_per_second / m_max_tempo), size_t(1));
+		m_max_lag   = std::max(static_cast<size_t>(60.0 * m_frames_per_second / m_min_tempo) + 1, m_min_lag + 2);
+		m_decay     = std::exp(-1.0 / (k_tempo_memory * m_frames_per_second));
+
+		m_envelope.assign(m_max_lag + 2, 0.0);
+		m_correlation.assign(m_max_lag + 2, 0.0);
+		m_weights.assign(m_max_lag + 2, 0.0);
+		for (auto lag = m_min_lag; lag <= m_max_lag; ++lag) {
+			const auto octaves = std::log2(60.0 * m_frames_per_second / lag / 120.0);
+			m_weights[lag]     = std::exp(-0.5 * octaves * octaves);
+		}
+		clear();
+	}
+
+
+	/// Set how far the flux must rise above its recent mean for an onset.
+	/// @param	ratio	The multiple of the mean.
+
+	void threshold(const double ratio) {
+		m_threshold = std::max(ratio, 1.0);
+	}
+
+
+	/// Set the smallest flux of an onset, so that noise in quiet passages is not detected.
+	/// @param	flux	The smallest flux.
+
+	void floor(const double flux) {
+		m_floor = std::max(flux, 0.0);
+	}
+
+
+	/// Set the shortest time between onsets.
+	/// @param	milliseconds	The time.
+
+	void minimum_interval(const double milliseconds) {
+		m_min_interval_ms = std::max(milliseconds, 0.0);
+		m_min_interval    = static_cast<long>(m_min_interval_ms * 0.001 * m_frames_per_second + 0.5);
+	}
+
+
+	/// Forget the audio and the tempo analyzed so far.
+
+	void clear() {
+		m_analyzer.clear();
+		std::fill(m_magnitudes.begin(), m_magnitudes.end(), 0.0);
+		std::fill(m_envelope.begin(), m_envelope.end(), 0.0);
+		std::fill(m_correlation.begin(), m_correlation.end(), 0.0);
+		m_history.fill(0.0);
+		m_history_sum   = 0.0;
+		m_history_index = 0;
+		m_frame         = 0;
+		m_last_onset    = -m_min_interval;
+		m_above         = false;
+		m_tempo         = 0.0;
+	}
+
+
+	/// Analyze a vector of audio.
+	/// @param	input		The samples.
+	/// @param	count		The number of samples.
+	/// @param	on_onset	Called for each onset, prototyped as `void (long offset, double flux)`,
+	///						where offset is the index of the sample at which the onset was detected.
+
+	template<class function_type>
+	void operator()(const double* input, const long count, function_type&& on_onset) {
+		m_analyzer.process(input, count, [&](const analyzer::complex* bins, const long offset) {
+			const auto flux = spectral_flux(bins);
+			const auto mean = m_history_sum / k_history_size;
+
+			if (detect(flux, mean))
+				on_onset(offset, flux);
+			estimate_tempo(std::max(flux - mean, 0.0));
+
+			m_history_sum += flux - m_history[m_history_index];
+			m_history[m_history_index] = flux;
+			m_history_index            = (m_history_index + 1) % k_history_size;
+			++m_frame;
+		});
+	}
+
+
+	/// Return the estimated tempo.
+	/// @return	The tempo in BPM, or 0 until there is enough periodicity in the onsets.
+
+	double tempo() const {
+		return m_tempo;
+	}
+
+private:
+	static constexpr size_t k_history_size { 16 };     // frames of flux averaged for the threshold, about 190 ms at 44.1 kHz
+	static constexpr double k_tempo_memory { 8.0 };    // seconds over which the autocorrelation decays by 1/e
+
+	analyzer                            m_analyzer;
+	std::vector<double>                 m_magnitudes;    // log magnitudes of the previous frame
+	std::array<double, k_history_size>  m_history {};
+	double                              m_history_sum {};
+	size_t                              m_history_index {};
+	double                              m_frames_per_second {};
+	double                              m_threshold { 1.5 };
+	double                              m_floor { 1.0 };
+	double                              m_min_interval_ms { 50.0 };
+	long                                m_min_interval {};    // in frames
+	long                                m_frame {};
+	long                                m_last_onset {};
+	bool                                m_above {};
+
+	double                              m_min_tempo { 60.0 };
+	double                              m_max_tempo { 200.0 };
+	size_t                              m_min_lag {};
+	size_t                              m_max_lag {};
+	double                              m_decay {};
+	std::vector<double>                 m_envelope;       // the mean-removed flux of the last m_max_lag + 2 frames, circular
+	std::vector<double>                 m_correlation;    // of the envelope with itself, for each lag up to m_max_lag + 1
+	std::vector<double>                 m_weights;        // of each lag, preferring tempi around 120 BPM
+	double                              m_tempo {};
+
+
+	double spectral_flux(const analyzer::complex* bins) {
+		double flux {};
+
+		for (size_t i = 0; i < analyzer::bin_count; ++i) {
+			const auto magnitude = std::log1p(std::abs(bins[i]));
+
+			flux += std::max(magnitude - m_magnitudes[i], 0.0);
+			m_magnitudes[i] = magnitude;
+		}
+		return flux;
+	}
+
+
+	// an onset is the frame at which the flux rises above the threshold, unless it follows another onset too closely
+
+	bool detect(const double flux, const double mean) {
+		const auto above = flux > std::max(mean * m_threshold, m_floor);
+		const auto onset = above && !m_above && m_frame - m_last_onset >= m_min_interval;
+
+		m_above = above;
+		if (onset)
+			m_last_onset = m_frame;
+		return onset;
+	}
+
+
+	void estimate_tempo(const double x) {
+		const auto size    = m_envelope.size();
+		const auto current = static_cast<size_t>(m_frame) % size;
+
+		m_envelope[current] = x;
+
+		for (auto lag = m_min_lag - 1; lag <= m_max_lag + 1; ++lag)
+			m_correlation[lag] = m_decay * m_correlation[lag] + x * m_envelope[(current + size - lag) % size];
+
+		// A beat whose period falls between two frames spreads over two lags, while its multiples may fall on one,
+		// so each lag is scored together with the stronger of its neighbours.
+
+		auto best       = m_min_lag;
+		auto best_score = 0.0;
+		for (auto lag = m_min_lag; lag <= m_max_lag; ++lag) {
+			const auto score = m_weights[lag] * (m_correlation[lag] + std::max(m_correlation[lag - 1], m_correlation[lag + 1]));
+
+			if (score > best_score) {
+				best       = lag;
+				best_score = score;
+			}
+		}
+
+		if (best_score <= 0.0 || best == m_min_lag || best == m_max_lag)
+			return;
+
+		// refine the lag between the frames by fitting a parabola through the strongest lag and its neighbours
+
+		const auto a     = m_correlation[best - 1];
+		const auto b     = m_correlation[best];
+		const auto c     = m_correlation[best + 1];
+		const auto denom = a - 2.0 * b + c;
+		const auto shift = denom < 0.0 ? std::clamp(0.5 * (a - c) / denom, -0.5, 0.5) : 0.0;
+
+		m_tempo = 60.0 * m_frames_per_second / (best + shift);
+	}
+};
@@ -0,0 +1,230 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+// The packets in which min.remote sends messages to the boxes of another Max, many messages to a packet.
+//
+// Every number is little-endian, whatever the byte order of the machines. A packet is:
+//
+//	size		field
+//	4			magic: 0x314d524d ("MRM1")
+//	2			the number of messages
+//	...			the messages, each of which is:
+//		s		the scripting name of the box
+//		s		the name of the message
+//		1		the number of arguments
+//		...		the arguments, each of which is a tag and a value:
+//			1	'l' followed by an 8-byte integer, 'f' followed by an 8-byte IEEE double, or 's' followed by a symbol
+//
+// where a symbol (s) is a byte with its length followed by its characters, so names are at most 255 characters long.
+// A packet is at most k_max_size bytes, which fits in one Ethernet frame so that it is not fragmented.
+
+#pragma once
+
+#include "c74_min_api.h"
+
+
+/// Encodes messages into a packet, until the packet is full.
+
+class remote_packet_writer {
+public:
+	static constexpr uint32_t	k_magic { 0x314d524d };
+	static constexpr size_t		k_max_size { 1400 };
+	static constexpr size_t		k_header_size { 6 };
+
+
+	remote_packet_writer() {
+		m_buffer.reserve(k_max_size);
+		clear();
+	}
+
+
+	/// Add a message to the packet.
+	/// @param	message	The scripting name of the box, the name of the message, and its arguments.
+	/// @return			False if the message does not fit in the packet, which is left as it was.
+	///					It does not fit in any packet if the packet is empty, or a name or an argument is too long.
+
+	bool add(const c74::min::atoms& message) {
+		using namespace c74::min;
+
+		if (message.size() < 2 || message.size() > 257 || m_count == 0xffff)
+			return false;
+
+		const auto size { m_buffer.size() };
+		auto       fits { put(static_cast<symbol>(message[0])) && put(static_cast<symbol>(message[1])) };
+
+		if (fits)
+			put_bytes(static_cast<uint64_t>(message.size() - 2), 1);
+		for (auto i = 2u; fits && i < message.size(); ++i) {
+			const auto& a { message[i] };
+
+			if (a.type() == message_type::int_argument) {
+				put_bytes('l', 1);
+				put_bytes(static_cast<uint64_t>(static_cast<int64_t>(a)), 8);
+			}
+			else if (a.type() == message_type::float_argument) {
+				const double value { a };
+				uint64_t     bits;
+
+				std::memcpy(&bits, &value, sizeof(bits));
+				put_bytes('f', 1);
+				put_bytes(bits, 8);
+			}
+			else {
+				put_bytes('s', 1);
+				fits = put(static_cast<symbol>(a));
+			}
+		}
+
+		if (!fits || m_buffer.size() > k_max_size) {
+			m_buffer.resize(size);
+			return false;
+		}
+
+		++m_count;
+		m_buffer[4] = static_cast<unsigned char>(m_count);
+		m_buffer[5] = static_cast<unsigned char>(m_count >> 8);
+		return true;
+	}
+
+
+	/// Remove all messages, e.g. after the packet was sent.
+
+	void clear() {
+		m_buffer.clear();
+		put_bytes(k_magic, 4);
+		put_bytes(0, 2);
+		m_count = 0;
+	}
+
+
+	const unsigned char* data() const {
+		return m_buffer.data();
+	}
+
+	size_t size() const {
+		return m_buffer.size();
+	}
+
+	size_t count() const {
+		return m_count;
+	}
+
+	bool empty() const {
+		return m_count == 0;
+	}
+
+private:
+	std::vector<unsigned char>	m_buffer;    // never grows beyond the memory reserved, as a message that does not fit is removed
+	size_t						m_count {};
+
+
+	void put_bytes(const uint64_t value, const int count) {
+		for (auto i = 0; i < count; ++i)
+			m_buffer.push_back(static_cast<unsigned char>(value >> (8 * i)));
+	}
+
+
+	bool put(const c74::min::symbol s) {
+		const auto length { std::strlen(s.c_str()) };
+
+		if (length > 255)
+			return false;
+		put_bytes(length, 1);
+		m_buffer.insert(m_buffer.end(), s.c_str(), s.c_str() + length);
+		return true;
+	}
+};
+
+
+/// Decodes the messages of a packet.
+
+class remote_packet_reader {
+public:
+
+	/// Decode a packet.
+	/// @param	data	The bytes of the packet.
+	/// @param	size	The number of bytes.
+	/// @param	f		Called with each message, prototyped as `void (const c74::min::atoms& message)`,
+	///					whose arguments are as they were added to the writer.
+	/// @return			The number of messages decoded, which stops at the first that is malformed.
+
+	template<class function_type>
+	size_t read(const unsigned char* data, const size_t size, function_type&& f) {
+		m_position	= data;
+		m_end		= data + size;
+
+		if (get_bytes(4) != remote_packet_writer::k_magic)
+			return 0;
+
+		const auto count { static_cast<size_t>(get_bytes(2)) };
+		size_t     read {};
+
+		for (; read < count; ++read) {
+			m_message.clear();    // keeps its memory, so only messages longer than any before allocate
+			m_message.push_back(get_symbol());
+			m_message.push_back(get_symbol());
+
+			const auto argument_count { get_bytes(1) };
+
+			for (uint64_t i = 0; i < argument_count && m_position; ++i) {
+				const auto tag { get_bytes(1) };
+
+				if (tag == 'l')
+					m_message.push_back(static_cast<int64_t>(get_bytes(8)));
+				else if (tag == 'f') {
+					const auto bits { get_bytes(8) };
+					double     value;
+
+					std::memcpy(&value, &bits, sizeof(value));
+					m_message.push_back(value);
+				}
+				else if (tag == 's')
+					m_message.push_back(get_symbol());
+				else
+					m_position = nullptr;
+			}
+
+			if (!m_position)
+				break;
+			f(m_message);
+		}
+		return read;
+	}
+
+private:
+	const unsigned char*	m_position {};    // nullptr once the packet turned out to be malformed
+	const unsigned char*	m_end {};
+	c74::min::atoms			m_message;
+
+
+	uint64_t get_bytes(const int count) {
+		if (!m_position || m_end - m_position < count) {
+			m_position = nullptr;
+			return 0;
+		}
+
+		uint64_t value {};
+
+		for (auto i = 0; i < count; ++i)
+			value |= static_cast<uint64_t>(m_position[i]) << (8 * i);
+		m_position += count;
+		return value;
+	}
+
+
+	c74::min::symbol get_symbol() {
+		const auto length { static_cast<size_t>(get_bytes(1)) };
+
+		if (!m_position || static_cast<size_t>(m_end - m_position) < length) {
+			m_position = nullptr;
+			return {};
+		}
+
+		const std::string s(reinterpret_cast<const char*>(m_position), length);
+
+		m_position += length;
+		return s;
+	}
+};
@@ -0,0 +1,441 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+// A ring buffer in named shared memory, through which a Max object streams audio or control data to another process.
+//
+// This header does not depend on Max or Min, so that the process reading the ring can include it too.
+// The producer creates the memory and writes, and exactly one consumer opens it and reads.
+// Neither side ever waits for the other: the producer drops data that does not fit, and counts it,
+// and the consumer reads what has been written in place, without copying it out of the shared memory.
+//
+// Layout of the shared memory, in the native byte order:
+//
+//	offset	size		field
+//	0		4			magic: 0x524e494d ("MINR")
+//	4		4			version: 1
+//	8		4			kind: 1 for audio, 2 for control
+//	12		4			channel count: the number of channels in a frame of audio, 0 for control
+//	16		8			samplerate of the audio as a double, 0 for control
+//	24		8			capacity: the number of bytes in the data area
+//	32		8			dropped: the number of bytes the producer could not write because the consumer fell behind
+//	64		8			write position: the number of bytes written so far, written by the producer only
+//	128		8			read position: the number of bytes read so far, written by the consumer only
+//	192		capacity	data area
+//
+// The positions count every byte ever written or read and never wrap around: the byte at position p is at p % capacity
+// in the data area, and the bytes that can be read are those from the read position up to the write position.
+// They are 64-bit atomics on cache lines of their own. The producer stores the write position with release semantics
+// after writing the data, so a consumer that loads it with acquire semantics sees the data.
+//
+// Audio is written as frames of interleaved 32-bit float samples, one for each channel.
+// The capacity is a multiple of the frame size, so a frame never wraps around the end of the data area.
+//
+// Control data is written as records of a multiple of 8 bytes, which never wrap around the end of the data area:
+//
+//	offset	size		field
+//	0		4			size: the number of bytes of the record, including this header
+//	4		4			count: the number of values, or 0xffffffff for padding up to the end of the data area
+//	8		8			time: the time of Max's scheduler in milliseconds when the record was written, as a double
+//	16		8 * count	values, as doubles
+//
+// A padding record only has its size and count, as it may be as short as 8 bytes.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+/// The header at the start of the shared memory, as documented above.
+
+struct shared_ring_header {
+	static constexpr uint32_t k_magic { 0x524e494d };
+	static constexpr uint32_t k_version { 1 };
+
+	enum class kind : uint32_t {
+		audio = 1,
+		control = 2
+	};
+
+	uint32_t				magic;
+	uint32_t				version;
+	kind					content;
+	uint32_t				channel_count;
+	double					samplerate;
+	uint64_t				capacity;
+	std::atomic<uint64_t>	dropped;
+	alignas(64) std::atomic<uint64_t>	write_position;
+	alignas(64) std::atomic<uint64_t>	read_position;
+	alignas(64) unsigned char			data[1];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the positions must be lock-free to be shared between processes");
+static_assert(offsetof(shared_ring_header, write_position) == 64 && offsetof(shared_ring_header, read_position) == 128
+	&& offsetof(shared_ring_header, data) == 192, "the layout of the header must match its documentation");
+
+
+/// A view of a ring in shared memory, used by the producer or the consumer.
+
+class shared_memory_ring {
+public:
+	static constexpr size_t		k_header_size { offsetof(shared_ring_header, data) };
+	static constexpr uint32_t	k_padding { 0xffffffff };
+
+
+	/// Return the number of bytes of shared memory needed for a ring.
+	/// @param	capacity	The number of bytes in the data area.
+
+	static size_t memory_size(const size_t capacity) {
+		return k_header_size + capacity;
+	}
+
+
+	/// Producer: format the memory for a new ring.
+	/// @param	memory			The shared memory, of at least memory_size(capacity) bytes.
+	/// @param	content			Whether the ring holds audio or control data.
+	/// @param	channel_count	The number of channels of audio, or 0.
+	/// @param	samplerate		The samplerate of the audio, or 0.
+	/// @param	capacity		The number of bytes in the data area, a multiple of the frame size for audio and of 8 for control data.
+
+	void create(void* memory, const shared_ring_header::kind content, const uint32_t channel_count, const double samplerate, const uint64_t capacity) {
+		m_header = static_cast<shared_ring_header*>(memory);
+		m_header->version		= shared_ring_header::k_version;
+		m_header->content		= content;
+		m_header->channel_count	= channel_count;
+		m_header->samplerate	= samplerate;
+		m_header->capacity		= capacity;
+		m_header->dropped.store(0);
+		m_header->write_position.store(0);
+		m_header->read_position.store(0);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_header->magic			= shared_ring_header::k_magic;    // last, so that a consumer never sees a ring that is half formatted
+	}
+
+
+	/// Consumer: use a ring formatted by a producer.
+	/// @param	memory	The shared memory.
+	/// @param	size	The size of the memory in bytes.
+	/// @return			False if the memory does not hold a ring of this version.
+
+	bool open(void* memory, const size_t size) {
+		const auto header { static_cast<shared_ring_header*>(memory) };
+
+		if (size < k_header_size || header->magic != shared_ring_header::k_magic || header->version != shared_ring_header::k_version
+			|| size < memory_size(header->capacity))
+			return false;
+		m_header = header;
+		return true;
+	}
+
+
+	bool valid() const {
+		return m_header != nullptr;
+	}
+
+	const shared_ring_header& header() const {
+		return *m_header;
+	}
+
+	size_t frame_size() const {
+		return m_header->channel_count * sizeof(float);
+	}
+
+
+	/// Producer: write a vector of audio as interleaved frames, converting the samples to float.
+	/// The vector is dropped if it does not fit.
+	/// @param	channels		The samples of each channel.
+	/// @param	channel_count	The number of channels, of which only those of the ring are written, and missing ones are written as zero.
+	/// @param	frame_count		The number of frames.
+	/// @return					True if the vector was written.
+
+	bool write_audio(const double* const* channels, const size_t channel_count, const size_t frame_count) {
+		const auto bytes { frame_count * frame_size() };
+		const auto position { reserve(bytes) };
+
+		if (position == k_no_space)
+			return false;
+
+		const auto ring_channels { static_cast<size_t>(m_header->channel_count) };
+		const auto capacity_frames { m_header->capacity / frame_size() };
+		auto       frame { (position % m_header->capacity) / frame_size() };
+		auto       out { reinterpret_cast<float*>(m_header->data) + frame * ring_channels };
+
+		for (size_t i = 0; i < frame_count; ++i) {
+			for (size_t channel = 0; channel < ring_channels; ++channel)
+				out[channel] = channel < channel_count ? static_cast<float>(channels[channel][i]) : 0.0f;
+
+			if (++frame == capacity_frames) {
+				frame = 0;
+				out   = reinterpret_cast<float*>(m_header->data);
+			}
+			else
+				out += ring_channels;
+		}
+
+		m_header->write_position.store(position + bytes, std::memory_order_release);
+		return true;
+	}
+
+
+	/// Producer: write a record of control data. The record is dropped if it does not fit.
+	/// @param	time	The time of the record in milliseconds.
+	/// @param	values	The values.
+	/// @param	count	The number of values.
+	/// @return			True if the record was written.
+
+	bool write_record(const double time, const double* values, const uint32_t count) {
+		const auto size { k_record_header_size + count * sizeof(double) };
+		auto       position { m_header->write_position.load(std::memory_order_relaxed) };
+		const auto offset { position % m_header->capacity };
+		const auto to_end { m_header->capacity - offset };
+		const auto padding { size > to_end ? to_end : 0 };    // a record that does not fit before the end starts at the beginning
+
+		if (size + padding > space()) {
+			m_header->dropped.fetch_add(size, std::memory_order_relaxed);
+			return false;
+		}
+
+		if (padding) {
+			write_at(position, static_cast<uint32_t>(padding), k_padding);
+			position += padding;
+		}
+
+		auto record { write_at(position, static_cast<uint32_t>(size), count) };
+
+		std::memcpy(record + 8, &time, sizeof(time));
+		std::memcpy(record + k_record_header_size, values, count * sizeof(double));
+		m_header->write_position.store(position + size, std::memory_order_release);
+		return true;
+	}
+
+
+	/// Producer: return the number of bytes that can be written.
+
+	uint64_t space() const {
+		return m_header->capacity - (m_header->write_position.load(std::memory_order_relaxed) - m_header->read_position.load(std::memory_order_acquire));
+	}
+
+
+	/// Consumer: visit the frames of audio that have been written, in at most two runs, and mark them as read.
+	/// @param	f	Called with each run, prototyped as `void (const float* frames, size_t frame_count)`.
+	///				The frames are in the shared memory and only valid during the call.
+	/// @return		The number of frames read.
+
+	template<class function_type>
+	size_t read_audio(function_type&& f) {
+		const auto read { m_header->read_position.load(std::memory_order_relaxed) };
+		const auto bytes { m_header->write_position.load(std::memory_order_acquire) - read };
+		const auto offset { read % m_header->capacity };
+		const auto first { std::min(bytes, m_header->capacity - offset) };
+		const auto frames { reinterpret_cast<const float*>(m_header->data) };
+
+		if (first)
+			f(frames + offset / sizeof(float), static_cast<size_t>(first / frame_size()));
+		if (bytes > first)
+			f(frames, static_cast<size_t>((bytes - first) / frame_size()));
+
+		m_header->read_position.store(read + bytes, std::memory_order_release);
+		return static_cast<size_t>(bytes / frame_size());
+	}
+
+
+	/// Consumer: visit the records of control data that have been written, and mark them as read.
+	/// @param	f	Called with each record, prototyped as `void (double time, const double* values, uint32_t count)`.
+	///				The values are in the shared memory and only valid during the call.
+	/// @return		The number of records read.
+
+	template<class function_type>
+	size_t read_records(function_type&& f) {
+		auto       read { m_header->read_position.load(std::memory_order_relaxed) };
+		const auto end { m_header->write_position.load(std::memory_order_acquire) };
+		size_t     records {};
+
+		while (read < end) {
+			const auto record { m_header->data + read % m_header->capacity };
+			uint32_t   size;
+			uint32_t   count;
+
+			std::memcpy(&size, record, sizeof(size));
+			std::memcpy(&count, record + 4, sizeof(count));
+			if (count != k_padding) {
+				double time;
+
+				std::memcpy(&time, record + 8, sizeof(time));
+				f(time, reinterpret_cast<const double*>(record + k_record_header_size), count);
+				++records;
+			}
+			read += size;
+		}
+
+		m_header->read_position.store(read, std::memory_order_release);
+		return records;
+	}
+
+private:
+	static constexpr size_t		k_record_header_size { 16 };
+	static constexpr uint64_t	k_no_space { ~uint64_t(0) };
+
+	shared_ring_header* m_header { nullptr };
+
+
+	// the position at which a number of bytes can be written, or k_no_space after counting them as dropped
+
+	uint64_t reserve(const uint64_t bytes) {
+		if (bytes > space()) {
+			m_header->dropped.fetch_add(bytes, std::memory_order_relaxed);
+			return k_no_space;
+		}
+		return m_header->write_position.load(std::memory_order_relaxed);
+	}
+
+
+	unsigned char* write_at(const uint64_t position, const uint32_t size, const uint32_t count) {
+		auto record { m_header->data + position % m_header->capacity };
+
+		std::memcpy(record, &size, sizeof(size));
+		std::memcpy(record + 4, &count, sizeof(count));
+		return record;
+	}
+};
+
+
+/// Named shared memory, created by the producer and opened by the consumer.
+/// On macOS and Linux the name is that of a POSIX shared memory object, e.g. "/analysis".
+/// On Windows it is the name of a file mapping, e.g. "Local\\analysis".
+
+class shared_memory {
+public:
+	shared_memory() = default;
+
+	shared_memory(const shared_memory&) = delete;
+	shared_memory& operator=(const shared_memory&) = delete;
+
+	~shared_memory() {
+		close();
+	}
+
+
+	/// Producer: create the memory, replacing any memory of the same name.
+	/// @param	name	The name.
+	/// @param	size	The size in bytes.
+	/// @return			False if the memory could not be created.
+
+	bool create(const std::string& name, const size_t size) {
+		close();
+#if defined(_WIN32)
+		m_handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(uint64_t(size) >> 32),
+			static_cast<DWORD>(size), name.c_str());
+		if (!m_handle)
+			return false;
+		m_memory = MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#else
+		shm_unlink(name.c_str());
+
+		const auto fd { shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600) };
+
+		if (fd < 0)
+			return false;
+		if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+			m_memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (m_memory == MAP_FAILED)
+				m_memory = nullptr;
+		}
+		::close(fd);
+		m_name = name;
+#endif
+		m_size = size;
+		if (!m_memory)
+			close();
+		return m_memory != nullptr;
+	}
+
+
+	/// Consumer: open memory created by a producer.
+	/// @param	name	The name.
+	/// @return			False if there is no memory of that name.
+
+	bool open(const std::string& name) {
+		close();
+#if defined(_WIN32)
+		m_handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+		if (!m_handle)
+			return false;
+		m_memory = MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+
+		MEMORY_BASIC_INFORMATION info {};
+		if (m_memory && VirtualQuery(m_memory, &info, sizeof(info)))
+			m_size = info.RegionSize;
+#else
+		const auto fd { shm_open(name.c_str(), O_RDWR, 0600) };
+
+		if (fd < 0)
+			return false;
+
+		struct stat status {};
+		if (fstat(fd, &status) == 0 && status.st_size > 0) {
+			m_size   = static_cast<size_t>(status.st_size);
+			m_memory = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (m_memory == MAP_FAILED)
+				m_memory = nullptr;
+		}
+		::close(fd);
+#endif
+		if (!m_memory)
+			close();
+		return m_memory != nullptr;
+	}
+
+
+	/// Unmap the memory. The producer also removes its name, while a consumer that has it open keeps it until it closes it too.
+
+	void close() {
+#if defined(_WIN32)
+		if (m_memory)
+			UnmapViewOfFile(m_memory);
+		if (m_handle)
+			CloseHandle(m_handle);
+		m_handle = nullptr;
+#else
+		if (m_memory)
+			munmap(m_memory, m_size);
+		if (!m_name.empty())
+			shm_unlink(m_name.c_str());
+		m_name.clear();
+#endif
+		m_memory = nullptr;
+		m_size   = 0;
+	}
+
+
+	void* data() const {
+		return m_memory;
+	}
+
+	size_t size() const {
+		return m_size;
+	}
+
+private:
+	void*		m_memory { nullptr };
+	size_t		m_size {};
+#if defined(_WIN32)
+	HANDLE		m_handle { nullptr };
+#else
+	std::string	m_name;    // of the memory created by this producer, removed when it is closed
+#endif
+};
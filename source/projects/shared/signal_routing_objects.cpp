@@ -9,22 +9,14 @@
 lookup_tables g_tables;
 
 
-lookup_tables::lookup_tables() {
-	linear.resize(size);
-	equal_power.resize(size);
-	sqrt.resize(size);
+lookup_tables::lookup_tables()
+: linear { [](double x) { return x; } }
+, equal_power { [](double x) { return std::sin(x * M_PI_2); } }
+, sqrt { [](double x) { return std::sqrt(x); } }
+{}
 
-	for (auto i = 0; i < size; ++i) {
-		double normalized_index = static_cast<double>(i) / (size - 1);
 
-		linear[i]      = normalized_index;
-		equal_power[i] = std::sin(normalized_index * M_PI_2);
-		sqrt[i]        = std::sqrt(normalized_index);
-	}
-}
-
-
-lookup_table* lookup_tables::get(const symbol& name) {
+const lookup_table* lookup_tables::get(const symbol& name) const {
 	if (name == shapes::equal_power)
 		return &equal_power;
 	else if (name == shapes::square_root)
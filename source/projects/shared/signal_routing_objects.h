@@ -11,6 +11,7 @@
 // and not the implementation using "c74_min_api.h"
 
 #include "c74_min_api.h"
+#include "../../min-lib/include/c74_lib_lookup_table.h"
 
 // Here we are using the "c74::min" namespace in a header file.
 // This is not a generally advisable practice in C++ but in limited cases such as this it makes sense.
@@ -39,16 +40,17 @@ namespace shapes {
 
 
 /// A lookup table in which we cache pre-calculated values for a function/shape.
+/// Values between the points of the table are interpolated linearly.
 
-using lookup_table = std::vector<double>;
+using lookup_table = c74::min::lib::lookup_table<4096>;
 
 
 /// Container for all available look-up tables of various shapes.
 
 class lookup_tables {
 public:
-	/// The count of values the contained lookup table(s)
-	static constexpr auto size = 512;
+	/// The count of intervals between the values of the contained lookup table(s)
+	static constexpr auto size = lookup_table::size;
 
 	/// Default constructor
 	/// initializes all lookup tables with thier functions.
@@ -57,7 +59,7 @@ public:
 	/// Get a pointer to a lookup table by name
 	/// @param	name	The name of the shape/function for which to fetch a lookup_table.
 	///	@return			The pointer to the associated lookup table.
-	lookup_table* get(const symbol& name);
+	const lookup_table* get(const symbol& name) const;
 
 private:
 	lookup_table linear;
@@ -81,28 +83,19 @@ extern lookup_tables g_tables;
 /// The signal_routing_base provides the basic facilities for mixing or distributing
 /// audio samples using a function (e.g. equal-power or linear) and potentially a lookup table for performance.
 /// Inheriting from this base class will provide your object with attributes for
-/// 'mode', 'shape', and 'position' as well as the 'number' message.
+/// 'mode', 'shape', 'position', and 'ramp' as well as the 'number' message.
 
 template<class derived_min_class_type>
 class signal_routing_base : public object<derived_min_class_type> {
-private:
-	bool attributes_initialized = false;    // must be initialized first, thus coming first in the class order (see below).
-
 public:
-	// attributes are initialized in the order in which they are defined
-	// in this case it is very important that shape be defined first so that the `table` member will be initialized
-	// prior to accessing the table in the following attribute definitions
-	//
-	// additionally, it is important to think through what this initialization means for members besides other
-	// attributes. for example, this attribute initialization will set the private `table` pointer which is declared at
-	// the end of this class. if that member were to be initialized at that point ( e.g. `lookup_table*	table =
-	// nullptr;` ) then that will override the work we do here because that comes later in the file.
+	// the table, the kernel and the weights depend on several attributes.
+	// rather than computing them in each setter, which would depend on the order in which the attributes are initialized,
+	// the setters notify the object and the "attributes_complete" message below computes them once all attributes are set,
+	// at instantiation as well as when a preset changes several attributes at once.
 
 	attribute<symbol> shape {this, "shape", shapes::equal_power,
 		setter { MIN_FUNCTION {
-			table = g_tables.get(args[0]);
-			if (attributes_initialized)
-				std::tie(weight1, weight2) = calculate_weights(mode, position);
+			this->attributes_changed();
 			return args;
 		}},
 		title {"Shape of Crossfade Function"},
@@ -111,11 +104,11 @@ public:
 		range {shapes::linear, shapes::equal_power, shapes::square_root}};
 
 
-	attribute<symbol> mode {this, "mode", "fast", setter { MIN_FUNCTION {
-							   if (attributes_initialized)
-								   std::tie(weight1, weight2) = calculate_weights(args[0], position);
-							   return args;
-						   }},
+	attribute<symbol> mode {this, "mode", "fast",
+		setter { MIN_FUNCTION {
+			this->attributes_changed();
+			return args;
+		}},
 		title {"Calculation Modality"},
 		description {"Calculation Modality. Choose whether to perform calculations on-the-fly for greater accuracy or "
 					"use a lookup table for greater speed."},
@@ -125,16 +118,38 @@ public:
 	attribute<number> position {this, "position", 0.5,
 		setter { MIN_FUNCTION {
 			auto n = MIN_CLAMP(double(args[0]), 0.0, 1.0);
-			// don't need to check that our class is initialized because the two dependencies this calls has
-			// come first in the initialization order (unlike the two attributes above)
-			std::tie(weight1, weight2) = calculate_weights(mode, n);
-			attributes_initialized     = true;    // this is the last attribute to be allocated and initialized
+			// the weights of a new position only depend on the kernel, so they are calculated right away
+			// unless the kernel is about to be resolved again anyway.
+			if (this->attributes_pending())
+				this->attributes_changed();
+			else
+				std::tie(weight1, weight2) = calculate_weights(n);
 			return {n};
 		}},
 		title {"Normalized Position"},
 		description {"Normalized position. This is the position within the function defined by the 'shape' attribute."}, range {0.0, 1.0}};
 
 
+	message<> attributes_complete {this, "attributes_complete",
+		MIN_FUNCTION {
+			table                      = g_tables.get(shape);
+			kernel                     = resolve_weighting(mode, shape);
+			std::tie(weight1, weight2) = calculate_weights(position);
+			return {};
+		}};
+
+
+	attribute<number> ramp {this, "ramp", 0.0,
+		setter { MIN_FUNCTION {
+			auto ms = std::max(double(args[0]), 0.0);
+			position.smoothing_time(ms);
+			return {ms};
+		}},
+		title {"Ramp Time"},
+		description {"Ramp time in milliseconds. Changes to the position are smoothed over this time "
+					"unless the position is connected to a signal."}};
+
+
 	message<threadsafe::yes> number {this, "number", "Set the normalized position in the function.",
 		MIN_FUNCTION {
 			position = args;
@@ -142,41 +157,142 @@ public:
 		}};
 
 protected:
-	lookup_table* table;
-	double        weight1;
-	double        weight2;
+	/// The ways of calculating the weights, resolved from the 'mode' and 'shape' attributes whenever one of them changes,
+	/// so that the audio thread chooses a kernel with a single switch rather than by comparing symbols.
+
+	enum class weighting {
+		table,          ///< look up the shape in a table (mode 'fast')
+		linear,         ///< calculate the shapes (mode 'precision')
+		equal_power,
+		square_root
+	};
+
+	/// The number of samples for which weights are calculated at once by the block version of calculate_weights().
+
+	static constexpr size_t block_size = 64;
 
-	std::pair<double, double> calculate_weights(symbol mode, double position) {
+	// resolved by "attributes_complete"
+	const lookup_table* table   { nullptr };
+	weighting           kernel  { weighting::linear };
+	double              weight1 { 0.0 };
+	double              weight2 { 0.0 };
+
+	// Called in the audio thread for each sample when the position is not connected to a signal.
+	// Returns the weights cached by the position setter unless the position is still ramping.
+
+	std::pair<double, double> smoothed_weights() {
+		const auto smoothed_position = position.smoothed();
+
+		if (position.is_ramping())
+			return calculate_weights(smoothed_position);
+		return std::make_pair(weight1, weight2);
+	}
+
+	std::pair<double, double> calculate_weights(double position) {
 		if (position < 0.0 || position > 1.0)    // if position is out of range then we must not have initialized position yet
 			return std::make_pair(0.0, 0.0);     // so we bail...
 
+		switch (kernel) {
+			case weighting::table:
+				return weights<weighting::table>(position);
+			case weighting::equal_power:
+				return weights<weighting::equal_power>(position);
+			case weighting::square_root:
+				return weights<weighting::square_root>(position);
+			default:
+				return weights<weighting::linear>(position);
+		}
+	}
+
+	/// Calculate the weights for a block of positions, e.g. a vector of a signal connected to the position inlet.
+	/// Positions outside of the range 0..1 get weights of zero.
+	/// @param	position	The positions.
+	/// @param	weights1	Filled with the weights of the first input or output.
+	/// @param	weights2	Filled with the weights of the second input or output.
+	/// @param	count		The number of positions, at most block_size.
+
+	void calculate_weights(const double* position, double* weights1, double* weights2, const size_t count) {
+		switch (kernel) {
+			case weighting::table:
+				weights<weighting::table>(position, weights1, weights2, count);
+				break;
+			case weighting::equal_power:
+				weights<weighting::equal_power>(position, weights1, weights2, count);
+				break;
+			case weighting::square_root:
+				weights<weighting::square_root>(position, weights1, weights2, count);
+				break;
+			default:
+				weights<weighting::linear>(position, weights1, weights2, count);
+				break;
+		}
+	}
+
+	/// Two adjacent channels of several and their weights, for crossfading between or panning across more than two channels.
+	/// All other channels have a weight of zero.
+
+	struct channel_pair {
+		size_t first;
+		size_t second;
 		double weight1;
 		double weight2;
+	};
+
+	/// Calculate the weights of the channels for a position that is spread across a line of channels,
+	/// with the first channel at position 0 and the last channel at position 1.
+	/// The pair of channels that the position falls between is weighted by the shape, as if they were the only two.
+	/// @param	position		The position in the range 0..1.
+	/// @param	channel_count	The number of channels, at least 1.
+	/// @return					The channels with a weight other than zero, and their weights.
 
-		if (mode == "fast") {
-			auto index1 = size_t((1.0 - position) * (lookup_tables::size - 1));
-			auto index2 = size_t(position * (lookup_tables::size - 1));
+	channel_pair line_weights(double position, const size_t channel_count) {
+		if (channel_count < 2)
+			return {0, 0, 1.0, 0.0};
 
-			weight1 = (*table)[index1];
-			weight2 = (*table)[index2];
+		const auto x     = MIN_CLAMP(position, 0.0, 1.0) * double(channel_count - 1);
+		const auto first = std::min(size_t(x), channel_count - 2);
+		const auto w     = calculate_weights(x - double(first));
+
+		return {first, first + 1, w.first, w.second};
+	}
+
+private:
+	static weighting resolve_weighting(symbol mode, symbol shape) {
+		if (mode == "fast")
+			return weighting::table;
+		if (shape == shapes::equal_power)
+			return weighting::equal_power;
+		if (shape == shapes::square_root)
+			return weighting::square_root;
+		return weighting::linear;
+	}
+
+	// The kernels. The loop of the block version has no branches, so that the compiler can vectorize it.
+
+	template<weighting kernel_type>
+	std::pair<double, double> weights(double position) const {
+		if constexpr (kernel_type == weighting::table) {
+			return std::make_pair((*table)(1.0 - position), (*table)(position));
 		}
-		else {
-			symbol shape = this->shape;
-
-			if (shape == shapes::equal_power) {
-				auto rad_position = position * M_PI_2;
-				weight1           = cos(rad_position);
-				weight2           = sin(rad_position);
-			}
-			else if (shape == shapes::square_root) {
-				weight1 = sqrt(1.0 - position);
-				weight2 = sqrt(position);
-			}
-			else {    // linear
-				weight1 = 1.0 - position;
-				weight2 = position;
-			}
+		else if constexpr (kernel_type == weighting::equal_power) {
+			auto rad_position = position * M_PI_2;
+			return std::make_pair(std::cos(rad_position), std::sin(rad_position));
+		}
+		else if constexpr (kernel_type == weighting::square_root)
+			return std::make_pair(std::sqrt(1.0 - position), std::sqrt(position));
+		else
+			return std::make_pair(1.0 - position, position);
+	}
+
+	template<weighting kernel_type>
+	void weights(const double* position, double* weights1, double* weights2, const size_t count) const {
+		for (size_t i = 0; i < count; ++i) {
+			const auto p      = position[i];
+			const auto inside = static_cast<double>(p >= 0.0 && p <= 1.0);
+			const auto w      = weights<kernel_type>(MIN_CLAMP(p, 0.0, 1.0));
+
+			weights1[i] = w.first * inside;
+			weights2[i] = w.second * inside;
 		}
-		return std::make_pair(weight1, weight2);
 	}
 };
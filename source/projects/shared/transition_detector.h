@@ -0,0 +1,81 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+/// Finds the transitions of a signal between zero and non-zero, a vector at a time.
+///
+/// The samples are compared in chunks of 64, and the result of each comparison is packed into one bit of a mask.
+/// The loops doing this have no branches, so the compiler turns them into SIMD compares.
+/// Comparing the mask with itself shifted by one sample leaves a bit set for each transition only,
+/// and only those bits are visited. A gate signal that rarely changes therefore costs little more than the compares,
+/// and one that changes often does not branch on every sample.
+
+class transition_detector {
+public:
+	/// Call a function for each transition in a vector, in the order of the samples.
+	/// @param	input	The samples.
+	/// @param	count	The number of samples.
+	/// @param	f		The function to call, prototyped as `void (size_t offset, bool rising)`,
+	///					where offset is the index of the first sample after the transition,
+	///					and rising is true for a change from zero to non-zero.
+
+	template<class function_type>
+	void operator()(const double* input, const size_t count, function_type&& f) {
+		for (size_t start = 0; start < count; start += k_chunk_size) {
+			const auto n = std::min(k_chunk_size, count - start);
+
+			uint8_t nonzero[k_chunk_size];
+			for (size_t i = 0; i < n; ++i)
+				nonzero[i] = input[start + i] != 0.0;
+
+			uint64_t mask {};
+			for (size_t i = 0; i < n; ++i)
+				mask |= uint64_t(nonzero[i]) << i;
+
+			auto transitions = mask ^ ((mask << 1) | m_previous);
+			if (n < k_chunk_size)
+				transitions &= (uint64_t(1) << n) - 1;
+
+			while (transitions) {
+				const auto i = lowest_bit(transitions);
+				f(start + i, ((mask >> i) & 1) != 0);
+				transitions &= transitions - 1;
+			}
+			m_previous = (mask >> (n - 1)) & 1;
+		}
+	}
+
+
+	/// Forget the last sample, so that the next vector starts as if it followed a zero.
+
+	void reset() {
+		m_previous = 0;
+	}
+
+private:
+	static constexpr size_t k_chunk_size = 64;
+
+	uint64_t m_previous {};    // 1 if the last sample seen was non-zero
+
+	static size_t lowest_bit(const uint64_t bits) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return index;
+#else
+		return static_cast<size_t>(__builtin_ctzll(bits));
+#endif
+	}
+};
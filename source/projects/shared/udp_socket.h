@@ -0,0 +1,166 @@
+/// @file
+///	@ingroup 	minexamples
+///	@copyright	Copyright 2018 The Min-DevKit Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+// A non-blocking UDP socket over IPv4, for sending datagrams to one destination and receiving them on a port.
+// Neither sending nor receiving ever waits: a datagram that cannot be sent is dropped, as UDP may drop it anyway,
+// and receive() returns 0 when there is nothing to read, so the socket can be polled from Max's scheduler.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "ws2_32.lib")
+#endif
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+
+class udp_socket {
+public:
+	udp_socket() {
+#if defined(_WIN32)
+		WSADATA data;
+		WSAStartup(MAKEWORD(2, 2), &data);    // counted, and matched by WSACleanup() in the destructor
+#endif
+	}
+
+	udp_socket(const udp_socket&) = delete;
+	udp_socket& operator=(const udp_socket&) = delete;
+
+	~udp_socket() {
+		close();
+#if defined(_WIN32)
+		WSACleanup();
+#endif
+	}
+
+
+	/// Open the socket for sending, and for receiving if a port is given.
+	/// @param	port	The port on which to receive datagrams from any address, or 0 to only send.
+	/// @return			False if the socket could not be opened, e.g. because the port is in use.
+
+	bool open(const uint16_t port = 0) {
+		close();
+		m_socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (m_socket == k_invalid)
+			return false;
+
+#if defined(_WIN32)
+		u_long non_blocking { 1 };
+		ioctlsocket(m_socket, FIONBIO, &non_blocking);
+#else
+		fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+		if (port) {
+			sockaddr_in address {};
+
+			address.sin_family		= AF_INET;
+			address.sin_addr.s_addr	= htonl(INADDR_ANY);
+			address.sin_port		= htons(port);
+			if (::bind(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+				close();
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	/// Set the destination of send().
+	/// @param	host	The name or the IPv4 address of the receiving host.
+	/// @param	port	The port on which the host receives.
+	/// @return			False if the host could not be resolved.
+
+	bool destination(const std::string& host, const uint16_t port) {
+		addrinfo hints {};
+		addrinfo* found {};
+
+		hints.ai_family		= AF_INET;
+		hints.ai_socktype	= SOCK_DGRAM;
+		m_has_destination	= false;
+		if (getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || !found)
+			return false;
+
+		std::memcpy(&m_destination, found->ai_addr, sizeof(m_destination));
+		m_destination.sin_port = htons(port);
+		m_has_destination = true;
+		freeaddrinfo(found);
+		return true;
+	}
+
+
+	/// Send a datagram to the destination.
+	/// @param	data	The bytes of the datagram.
+	/// @param	size	The number of bytes.
+	/// @return			False if the datagram was not sent.
+
+	bool send(const void* data, const size_t size) {
+		if (m_socket == k_invalid || !m_has_destination)
+			return false;
+
+		const auto sent { ::sendto(m_socket, static_cast<const char*>(data), static_cast<int>(size), 0,
+			reinterpret_cast<const sockaddr*>(&m_destination), sizeof(m_destination)) };
+
+		return sent == static_cast<decltype(sent)>(size);
+	}
+
+
+	/// Receive a datagram, if one has arrived.
+	/// @param	data	Where to write the datagram.
+	/// @param	size	The number of bytes that can be written, beyond which a datagram is truncated.
+	/// @return			The number of bytes received, or 0 if no datagram has arrived.
+
+	size_t receive(void* data, const size_t size) {
+		if (m_socket == k_invalid)
+			return 0;
+
+		const auto received { ::recvfrom(m_socket, static_cast<char*>(data), static_cast<int>(size), 0, nullptr, nullptr) };
+
+		return received > 0 ? static_cast<size_t>(received) : 0;
+	}
+
+
+	bool is_open() const {
+		return m_socket != k_invalid;
+	}
+
+
+	void close() {
+		if (m_socket == k_invalid)
+			return;
+#if defined(_WIN32)
+		closesocket(m_socket);
+#else
+		::close(m_socket);
+#endif
+		m_socket = k_invalid;
+	}
+
+private:
+#if defined(_WIN32)
+	using native_socket = SOCKET;
+	static constexpr native_socket k_invalid { INVALID_SOCKET };
+#else
+	using native_socket = int;
+	static constexpr native_socket k_invalid { -1 };
+#endif
+
+	native_socket	m_socket { k_invalid };
+	sockaddr_in		m_destination {};
+	bool			m_has_destination { false };
+};